@@ -82,6 +82,10 @@ if [ "$BUILD_32BIT" = "true" ]; then
     export PKG_CONFIG_LIBDIR="/usr/lib32/pkgconfig"
 fi
 
+if [ "$HASH_BUCKET_16" = "true" ]; then
+    OPTS="$OPTS -Dc_args=-DRTE_HASH_BUCKET_ENTRIES=16"
+fi
+
 if [ "$MINGW" = "true" ]; then
     OPTS="$OPTS -Dexamples=helloworld"
 elif [ "$DEF_LIB" = "static" ]; then
@@ -172,6 +176,10 @@ if [ "$RUN_TESTS" = "true" ]; then
     failed=
     configure_coredump
     sudo meson test -C build --suite fast-tests -t 3 || failed="true"
+    if [ "$HASH_BUCKET_16" = "true" ]; then
+        # users of the hash library outside of the fast tests
+        sudo meson test -C build ipsec_sad_autotest || failed="true"
+    fi
     catch_coredump
     [ "$failed" != "true" ]
 fi
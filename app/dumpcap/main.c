@@ -35,6 +35,7 @@
 #include <rte_malloc.h>
 #include <rte_mbuf.h>
 #include <rte_mempool.h>
+#include <rte_memzone.h>
 #include <rte_pcapng.h>
 #include <rte_pdump.h>
 #include <rte_ring.h>
@@ -66,6 +67,7 @@ static const char *lcore_arg;
 static bool dump_bpf;
 static bool show_interfaces;
 static bool print_stats;
+static bool zero_copy;
 
 /* capture limit options */
 static struct {
@@ -83,6 +85,9 @@ static size_t file_size;
 struct capture_options {
 	const char *filter;
 	uint32_t snap_len;
+	uint32_t sample_rate;
+	uint64_t max_pkt_rate;
+	uint64_t max_byte_rate;
 	bool promisc_mode;
 } capture = {
 	.snap_len = RTE_MBUF_DEFAULT_BUF_SIZE,
@@ -122,6 +127,9 @@ static void usage(void)
 	printf("  -s <snaplen>, --snapshot-length <snaplen>\n"
 	       "                           packet snapshot length (def: %u)\n",
 	       RTE_MBUF_DEFAULT_BUF_SIZE);
+	printf("  --sample-rate <N>        capture only 1 packet out of N\n"
+	       "  --max-packet-rate <N>    capture at most N packets per second per queue\n"
+	       "  --max-byte-rate <N>      capture at most N bytes per second per queue\n");
 	printf("  -p, --no-promiscuous-mode\n"
 	       "                           don't capture in promiscuous mode\n"
 	       "  -D, --list-interfaces    print list of interfaces and exit\n"
@@ -143,6 +151,8 @@ static void usage(void)
 	       "                           add a capture comment to the output file\n"
 	       "  --temp-dir <directory>   write temporary files to this directory\n"
 	       "                           (default: /tmp)\n"
+	       "  --zero-copy              format pcapng blocks directly in shared memory\n"
+	       "                           instead of copying packets to mbufs\n"
 	       "\n"
 	       "Miscellaneous:\n"
 	       "  --lcore=<core>           CPU core to run on (default: any)\n"
@@ -348,16 +358,21 @@ static void parse_opts(int argc, char **argv)
 		{ "interface",       required_argument, NULL, 'i' },
 		{ "lcore",           required_argument, NULL, 0 },
 		{ "list-interfaces", no_argument,       NULL, 'D' },
+		{ "max-byte-rate",   required_argument, NULL, 0 },
+		{ "max-packet-rate", required_argument, NULL, 0 },
 		{ "no-promiscuous-mode", no_argument,   NULL, 'p' },
 		{ "output-file",     required_argument, NULL, 'w' },
 		{ "ring-buffer",     required_argument, NULL, 'b' },
+		{ "sample-rate",     required_argument, NULL, 0 },
 		{ "snapshot-length", required_argument, NULL, 's' },
 		{ "temp-dir",        required_argument, NULL, 0 },
 		{ "version",         no_argument,       NULL, 'v' },
+		{ "zero-copy",       no_argument,       NULL, 0 },
 		{ NULL },
 	};
 	int option_index, c;
 	struct interface *last_intf = NULL;
+	struct capture_options *opts;
 	uint32_t len;
 
 	for (;;) {
@@ -379,6 +394,18 @@ static void parse_opts(int argc, char **argv)
 				file_prefix = optarg;
 			} else if (!strcmp(longopt, "temp-dir")) {
 				tmp_dir = optarg;
+			} else if (!strcmp(longopt, "zero-copy")) {
+				zero_copy = true;
+			} else if (!strcmp(longopt, "sample-rate")) {
+				opts = last_intf ? &last_intf->opts : &capture;
+				opts->sample_rate = get_uint(optarg, "sample_rate",
+							     UINT32_MAX);
+			} else if (!strcmp(longopt, "max-packet-rate")) {
+				opts = last_intf ? &last_intf->opts : &capture;
+				opts->max_pkt_rate = get_uint(optarg, "max_packet_rate", 0);
+			} else if (!strcmp(longopt, "max-byte-rate")) {
+				opts = last_intf ? &last_intf->opts : &capture;
+				opts->max_byte_rate = get_uint(optarg, "max_byte_rate", 0);
 			} else if (!strcmp(longopt, "ifdescr")) {
 				if (last_intf == NULL)
 					rte_exit(EXIT_FAILURE,
@@ -582,7 +609,8 @@ report_packet_stats(dumpcap_out_t out)
 			continue;
 
 		/* do what Wiretap does */
-		ifrecv = pdump_stats.accepted + pdump_stats.filtered;
+		ifrecv = pdump_stats.accepted + pdump_stats.filtered +
+			pdump_stats.skipped;
 		ifdrop = pdump_stats.nombuf + pdump_stats.ringfull;
 
 		if (use_pcapng)
@@ -699,6 +727,39 @@ static struct rte_ring *create_ring(void)
 	return ring;
 }
 
+/* Create ring of pcapng blocks shared between callbacks and process */
+static struct rte_pcapng_ring *create_pcapng_ring(void)
+{
+	const struct interface *intf;
+	struct rte_pcapng_ring *pr;
+	char ring_name[RTE_MEMZONE_NAMESIZE];
+	uint32_t block_size = 128;
+	uint64_t size;
+
+	/* Room for ring_size blocks of the biggest snap length */
+	TAILQ_FOREACH(intf, &interfaces, next) {
+		uint32_t len = rte_pcapng_mbuf_size(intf->opts.snap_len);
+
+		if (len > block_size)
+			block_size = len;
+	}
+
+	size = (uint64_t)ring_size * block_size;
+	if (size > RTE_BIT64(31)) {
+		fprintf(stderr, "Pcapng ring size limited to 2 GB\n");
+		size = RTE_BIT64(31);
+	}
+
+	snprintf(ring_name, sizeof(ring_name), "dumpcap-%d", getpid());
+
+	pr = rte_pcapng_ring_create(ring_name, size, rte_socket_id());
+	if (pr == NULL)
+		rte_exit(EXIT_FAILURE, "Could not create pcapng ring: %s\n",
+			 rte_strerror(rte_errno));
+
+	return pr;
+}
+
 static struct rte_mempool *create_mempool(void)
 {
 	const struct interface *intf;
@@ -823,7 +884,8 @@ static dumpcap_out_t create_output(void)
 	return ret;
 }
 
-static void enable_pdump(struct rte_ring *r, struct rte_mempool *mp)
+static void enable_pdump(struct rte_ring *r, struct rte_mempool *mp,
+			 struct rte_pcapng_ring *pr)
 {
 	struct interface *intf;
 	unsigned int count = 0;
@@ -835,9 +897,19 @@ static void enable_pdump(struct rte_ring *r, struct rte_mempool *mp)
 		flags |= RTE_PDUMP_FLAG_PCAPNG;
 
 	TAILQ_FOREACH(intf, &interfaces, next) {
-		ret = rte_pdump_enable_bpf(intf->port, RTE_PDUMP_ALL_QUEUES,
-					   flags, intf->opts.snap_len,
-					   r, mp, intf->bpf_prm);
+		struct rte_pdump_param param = {
+			.snaplen = intf->opts.snap_len,
+			.sample_rate = intf->opts.sample_rate,
+			.pkt_budget = intf->opts.max_pkt_rate,
+			.byte_budget = intf->opts.max_byte_rate,
+			.ring = r,
+			.mp = mp,
+			.pcapng_ring = pr,
+			.prm = intf->bpf_prm,
+		};
+
+		ret = rte_pdump_enable_ext(intf->port, RTE_PDUMP_ALL_QUEUES,
+					   flags, &param);
 		if (ret < 0) {
 			const struct interface *intf2;
 
@@ -969,10 +1041,40 @@ static int process_ring(dumpcap_out_t out, struct rte_ring *r)
 	return 0;
 }
 
+/* Write all blocks in pcapng ring to capture file */
+static int process_pcapng_ring(dumpcap_out_t out, struct rte_pcapng_ring *pr)
+{
+	static unsigned int empty_count;
+	ssize_t written;
+	uint32_t n;
+
+	written = rte_pcapng_write_ring(out.pcapng, pr, &n);
+	if (written < 0)
+		return -1;
+
+	if (written == 0) {
+		/* don't consume endless amounts of cpu if idle */
+		if (empty_count < SLEEP_THRESHOLD)
+			++empty_count;
+		else
+			usleep(10);
+		return 0;
+	}
+
+	empty_count = 0;
+	file_size += written;
+	packets_received += n;
+	if (!quiet)
+		show_count(packets_received);
+
+	return 0;
+}
+
 int main(int argc, char **argv)
 {
-	struct rte_ring *r;
-	struct rte_mempool *mp;
+	struct rte_ring *r = NULL;
+	struct rte_mempool *mp = NULL;
+	struct rte_pcapng_ring *pr = NULL;
 	struct sigaction action = {
 		.sa_flags = SA_RESTART,
 		.sa_handler = signal_handler,
@@ -1018,12 +1120,19 @@ int main(int argc, char **argv)
 		exit(0);
 	}
 
-	r = create_ring();
-	mp = create_mempool();
+	if (zero_copy && !use_pcapng)
+		rte_exit(EXIT_FAILURE, "--zero-copy requires pcapng format\n");
+
+	if (zero_copy) {
+		pr = create_pcapng_ring();
+	} else {
+		r = create_ring();
+		mp = create_mempool();
+	}
 	out = create_output();
 
 	start_time = time(NULL);
-	enable_pdump(r, mp);
+	enable_pdump(r, mp, pr);
 
 	if (!quiet) {
 		fprintf(stderr, "Packets captured: ");
@@ -1031,7 +1140,8 @@ int main(int argc, char **argv)
 	}
 
 	while (!rte_atomic_load_explicit(&quit_signal, rte_memory_order_relaxed)) {
-		if (process_ring(out, r) < 0) {
+		if ((pr != NULL ? process_pcapng_ring(out, pr) :
+		     process_ring(out, r)) < 0) {
 			fprintf(stderr, "pcapng file write failed; %s\n",
 				strerror(errno));
 			break;
@@ -1050,6 +1160,10 @@ int main(int argc, char **argv)
 
 	disable_primary_monitor();
 
+	/* flush the blocks already formatted */
+	if (pr != NULL)
+		process_pcapng_ring(out, pr);
+
 	if (rte_eal_primary_proc_alive(NULL))
 		report_packet_stats(out);
 
@@ -1062,6 +1176,7 @@ int main(int argc, char **argv)
 
 	rte_ring_free(r);
 	rte_mempool_free(mp);
+	rte_pcapng_ring_free(pr);
 
 	return rte_eal_cleanup() ? EXIT_FAILURE : 0;
 }
@@ -42,7 +42,9 @@
 #define FIB_RIB_TYPE		(1 << 3)
 #define FIB_V4_DIR_TYPE		(1 << 4)
 #define FIB_V6_TRIE_TYPE	(1 << 4)
-#define FIB_TYPE_MASK		(FIB_RIB_TYPE|FIB_V4_DIR_TYPE|FIB_V6_TRIE_TYPE)
+#define FIB_POPTRIE_TYPE	(1 << 5)
+#define FIB_TYPE_MASK		(FIB_RIB_TYPE|FIB_V4_DIR_TYPE|FIB_V6_TRIE_TYPE|\
+				FIB_POPTRIE_TYPE)
 #define SHUFFLE_FLAG		(1 << 7)
 #define DRY_RUN_FLAG		(1 << 8)
 
@@ -78,6 +80,7 @@ static struct {
 	uint32_t	nb_routes_per_depth[128 + 1];
 	uint32_t	flags;
 	uint32_t	tbl8;
+	uint32_t	batch_sz;
 	uint8_t		ent_sz;
 	uint8_t		rnd_lookup_ips_ratio;
 	uint8_t		print_fract;
@@ -91,6 +94,7 @@ static struct {
 	.nb_routes_per_depth = {0},
 	.flags = FIB_V4_DIR_TYPE,
 	.tbl8 = DEFAULT_LPM_TBL8,
+	.batch_sz = 0,
 	.ent_sz = 4,
 	.rnd_lookup_ips_ratio = 0,
 	.print_fract = 10,
@@ -138,6 +142,8 @@ get_fib_type(void)
 	if (config.flags & IPV6_FLAG) {
 		if ((config.flags & FIB_TYPE_MASK) == FIB_V6_TRIE_TYPE)
 			return RTE_FIB6_TRIE;
+		else if ((config.flags & FIB_TYPE_MASK) == FIB_POPTRIE_TYPE)
+			return RTE_FIB6_POPTRIE;
 		else
 			return RTE_FIB6_DUMMY;
 	} else {
@@ -145,6 +151,8 @@ get_fib_type(void)
 			return RTE_FIB_DIR24_8;
 		if ((config.flags & FIB_TYPE_MASK) == FIB_RIB_TYPE)
 			return RTE_FIB_DUMMY;
+		if ((config.flags & FIB_TYPE_MASK) == FIB_POPTRIE_TYPE)
+			return RTE_FIB_POPTRIE;
 	}
 	return -1;
 }
@@ -613,19 +621,24 @@ print_usage(void)
 		"[-b <fib algorithm>]\n\tavailable options for ipv4\n"
 		"\t\trib - RIB based FIB\n"
 		"\t\tdir - DIR24_8 based FIB\n"
+		"\t\tpop - Poptrie based FIB\n"
 		"\tavailable options for ipv6:\n"
 		"\t\trib - RIB based FIB\n"
 		"\t\ttrie - TRIE based FIB\n"
+		"\t\tpop - Poptrie based FIB\n"
 		"defaults are: dir for ipv4 and trie for ipv6\n"
 		"[-e <entry size (valid only for dir and trie fib types): "
 		"1/2/4/8 (default 4)>]\n"
 		"[-g <number of tbl8's for dir24_8 or trie FIBs>]\n"
+		"[-B <add and delete routes in batches of given size and "
+		"report the full table convergence time (only for ipv4)>]\n"
 		"[-w <path to the file to dump routing table>]\n"
 		"[-u <path to the file to dump ip's for lookup>]\n"
 		"[-v <type of lookup function:"
 		"\ts1, s2, s3 (3 types of scalar), v (vector) -"
 		" for DIR24_8 based FIB\n"
-		"\ts, v - for TRIE based ipv6 FIB>]\n",
+		"\ts, v - for TRIE based ipv6 FIB\n"
+		"\ts, v - for Poptrie based ipv4 FIB, s for ipv6>]\n",
 		config.prgname);
 }
 
@@ -659,6 +672,11 @@ check_config(void)
 		printf("-e 1 is valid only for ipv4\n");
 		return -1;
 	}
+
+	if ((config.batch_sz != 0) && (config.flags & IPV6_FLAG)) {
+		printf("-B option is valid only for ipv4\n");
+		return -1;
+	}
 	return 0;
 }
 
@@ -668,7 +686,7 @@ parse_opts(int argc, char **argv)
 	int opt;
 	char *endptr;
 
-	while ((opt = getopt(argc, argv, "f:t:n:d:l:r:c6ab:e:g:w:u:sv:")) !=
+	while ((opt = getopt(argc, argv, "f:t:n:d:l:r:c6ab:e:g:w:u:sv:B:")) !=
 			-1) {
 		switch (opt) {
 		case 'f':
@@ -741,6 +759,9 @@ parse_opts(int argc, char **argv)
 			} else if (strcmp(optarg, "trie") == 0) {
 				config.flags &= ~FIB_TYPE_MASK;
 				config.flags |= FIB_V6_TRIE_TYPE;
+			} else if (strcmp(optarg, "pop") == 0) {
+				config.flags &= ~FIB_TYPE_MASK;
+				config.flags |= FIB_POPTRIE_TYPE;
 			} else
 				rte_exit(-EINVAL, "Invalid option -b\n");
 			break;
@@ -760,6 +781,14 @@ parse_opts(int argc, char **argv)
 				rte_exit(-EINVAL, "Invalid option -g\n");
 			}
 			break;
+		case 'B':
+			errno = 0;
+			config.batch_sz = strtoul(optarg, &endptr, 10);
+			if ((errno != 0) || (config.batch_sz == 0)) {
+				print_usage();
+				rte_exit(-EINVAL, "Invalid option -B\n");
+			}
+			break;
 		case 'v':
 			if ((strcmp(optarg, "s1") == 0) ||
 					(strcmp(optarg, "s") == 0)) {
@@ -811,6 +840,64 @@ print_depth_err(void)
 		"-d 0:0 option or remove /0 prefix from routes file\n");
 }
 
+/*
+ * Add or delete all routes with rte_fib_modify_bulk() in batches
+ * and report the time it takes for the whole table to converge.
+ */
+static int
+modify_fib_batched(struct rte_fib *fib, struct rt_rule_4 *rt, uint8_t op)
+{
+	struct rte_fib_route_op *ops;
+	uint64_t start, cycles;
+	uint32_t i, j, n, done;
+	int ret = 0;
+
+	ops = rte_malloc(NULL, sizeof(*ops) * config.batch_sz, 0);
+	if (ops == NULL) {
+		printf("Can not alloc batch of routes\n");
+		return -ENOMEM;
+	}
+
+	start = rte_rdtsc_precise();
+	for (i = 0; i < config.nb_routes; i += n) {
+		n = RTE_MIN(config.batch_sz, config.nb_routes - i);
+		for (j = 0; j < n; j++) {
+			ops[j].ip = rt[i + j].addr;
+			ops[j].depth = rt[i + j].depth;
+			ops[j].op = op;
+			ops[j].next_hop = rt[i + j].nh;
+		}
+		for (done = 0; done < n; ) {
+			ret = rte_fib_modify_bulk(fib, ops + done, n - done);
+			if (ret < 0)
+				break;
+			done += ret;
+			/* generated routes may contain duplicates */
+			if ((done < n) && (op == RTE_FIB_DEL) &&
+					(rte_errno == ENOENT))
+				done++;
+			else if (done < n) {
+				ret = -rte_errno;
+				break;
+			}
+		}
+		if (unlikely(ret < 0)) {
+			printf("Can not %s routes in FIB, err %d\n",
+				(op == RTE_FIB_ADD) ? "add" : "delete", ret);
+			rte_free(ops);
+			return ret;
+		}
+	}
+	cycles = rte_rdtsc_precise() - start;
+	printf("FIB %s %u routes in batches of %u: %"PRIu64" cycles, "
+		"%.3f ms\n", (op == RTE_FIB_ADD) ? "add" : "delete",
+		config.nb_routes, config.batch_sz, cycles,
+		(double)cycles * 1000 / rte_get_tsc_hz());
+
+	rte_free(ops);
+	return 0;
+}
+
 static int
 run_v4(void)
 {
@@ -855,7 +942,20 @@ run_v4(void)
 		return -rte_errno;
 	}
 
-	if (config.lookup_fn != 0) {
+	if (config.lookup_fn != 0 && conf.type == RTE_FIB_POPTRIE) {
+		if (config.lookup_fn == 1)
+			ret = rte_fib_select_lookup(fib,
+				RTE_FIB_LOOKUP_POPTRIE_SCALAR);
+		else if (config.lookup_fn == 2)
+			ret = rte_fib_select_lookup(fib,
+				RTE_FIB_LOOKUP_POPTRIE_VECTOR_AVX512);
+		else
+			ret = -EINVAL;
+		if (ret != 0) {
+			printf("Can not init lookup function\n");
+			return ret;
+		}
+	} else if (config.lookup_fn != 0) {
 		if (config.lookup_fn == 1)
 			ret = rte_fib_select_lookup(fib,
 				RTE_FIB_LOOKUP_DIR24_8_SCALAR_MACRO);
@@ -876,20 +976,26 @@ run_v4(void)
 		}
 	}
 
-	for (k = config.print_fract, i = 0; k > 0; k--) {
-		start = rte_rdtsc_precise();
-		for (j = 0; j < (config.nb_routes - i) / k; j++) {
-			ret = rte_fib_add(fib, rt[i + j].addr, rt[i + j].depth,
-				rt[i + j].nh);
-			if (unlikely(ret != 0)) {
-				printf("Can not add a route to FIB, err %d\n",
-					ret);
-				return -ret;
+	if (config.batch_sz != 0) {
+		ret = modify_fib_batched(fib, rt, RTE_FIB_ADD);
+		if (ret != 0)
+			return -ret;
+	} else {
+		for (k = config.print_fract, i = 0; k > 0; k--) {
+			start = rte_rdtsc_precise();
+			for (j = 0; j < (config.nb_routes - i) / k; j++) {
+				ret = rte_fib_add(fib, rt[i + j].addr,
+					rt[i + j].depth, rt[i + j].nh);
+				if (unlikely(ret != 0)) {
+					printf("Can not add a route to FIB, "
+						"err %d\n", ret);
+					return -ret;
+				}
 			}
+			printf("AVG FIB add %"PRIu64"\n",
+				(rte_rdtsc_precise() - start) / j);
+			i += j;
 		}
-		printf("AVG FIB add %"PRIu64"\n",
-			(rte_rdtsc_precise() - start) / j);
-		i += j;
 	}
 
 	if (config.flags & CMP_FLAG) {
@@ -964,14 +1070,21 @@ run_v4(void)
 		printf("FIB and LPM lookup returns same values\n");
 	}
 
-	for (k = config.print_fract, i = 0; k > 0; k--) {
-		start = rte_rdtsc_precise();
-		for (j = 0; j < (config.nb_routes - i) / k; j++)
-			rte_fib_delete(fib, rt[i + j].addr, rt[i + j].depth);
+	if (config.batch_sz != 0) {
+		ret = modify_fib_batched(fib, rt, RTE_FIB_DEL);
+		if (ret != 0)
+			return -ret;
+	} else {
+		for (k = config.print_fract, i = 0; k > 0; k--) {
+			start = rte_rdtsc_precise();
+			for (j = 0; j < (config.nb_routes - i) / k; j++)
+				rte_fib_delete(fib, rt[i + j].addr,
+					rt[i + j].depth);
 
-		printf("AVG FIB delete %"PRIu64"\n",
-			(rte_rdtsc_precise() - start) / j);
-		i += j;
+			printf("AVG FIB delete %"PRIu64"\n",
+				(rte_rdtsc_precise() - start) / j);
+			i += j;
+		}
 	}
 
 	if (config.flags & CMP_FLAG) {
@@ -1057,7 +1170,10 @@ run_v6(void)
 	}
 
 	if (config.lookup_fn != 0) {
-		if (config.lookup_fn == 1)
+		if (config.lookup_fn == 1 && conf.type == RTE_FIB6_POPTRIE)
+			ret = rte_fib6_select_lookup(fib,
+				RTE_FIB6_LOOKUP_POPTRIE_SCALAR);
+		else if (config.lookup_fn == 1)
 			ret = rte_fib6_select_lookup(fib,
 				RTE_FIB6_LOOKUP_TRIE_SCALAR);
 		else if (config.lookup_fn == 2)
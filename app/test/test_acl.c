@@ -23,6 +23,7 @@ test_acl(void)
 #else
 #include <rte_acl.h>
 #include <rte_common.h>
+#include <rte_random.h>
 
 #include "test_acl.h"
 
@@ -1722,6 +1723,378 @@ test_u32_range(void)
 	return rc;
 }
 
+/*
+ * Classify test data against two contexts and compare the results.
+ * No reference context means that nothing should match.
+ */
+static int
+test_incr_cmp(struct rte_acl_ctx *acx, struct rte_acl_ctx *ref,
+	struct ipv4_7tuple test_data[], uint32_t dim)
+{
+	int32_t ret;
+	uint32_t i;
+	const uint8_t *data[dim];
+	uint32_t res[dim * RTE_ACL_MAX_CATEGORIES];
+	uint32_t res_ref[dim * RTE_ACL_MAX_CATEGORIES];
+
+	bswap_test_data(test_data, dim, 1);
+	for (i = 0; i != dim; i++)
+		data[i] = (uint8_t *)&test_data[i];
+
+	memset(res_ref, 0, sizeof(res_ref));
+	ret = rte_acl_classify(acx, data, res, dim, RTE_ACL_MAX_CATEGORIES);
+	if (ret == 0 && ref != NULL)
+		ret = rte_acl_classify(ref, data, res_ref, dim,
+			RTE_ACL_MAX_CATEGORIES);
+	bswap_test_data(test_data, dim, 0);
+	if (ret != 0) {
+		printf("Line %i: classify failed: %d\n", __LINE__, ret);
+		return ret;
+	}
+
+	for (i = 0; i != RTE_DIM(res); i++) {
+		if (res[i] != res_ref[i]) {
+			printf("Line %i: mismatch at %u/%u "
+				"(expected %"PRIu32" got %"PRIu32")!\n",
+				__LINE__, i / RTE_ACL_MAX_CATEGORIES,
+				i % RTE_ACL_MAX_CATEGORIES, res_ref[i], res[i]);
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Test incremental rule updates against full rebuilds.
+ */
+static int
+test_incr_update(void)
+{
+	int32_t ret;
+	uint32_t i, n;
+	struct rte_acl_ctx *acx, *ref;
+	struct rte_acl_config cfg;
+	struct rte_acl_param prm;
+	struct acl_ipv4vlan_rule rv;
+	struct rte_acl_incr_config icfg = {
+		.v = NULL,
+		.max_delta_rules = RTE_DIM(acl_test_rules) / 4,
+	};
+
+	n = RTE_DIM(acl_test_rules);
+
+	prm = acl_param;
+	prm.name = "acl_incr";
+	acx = rte_acl_create(&prm);
+	prm.name = "acl_incr_ref";
+	ref = rte_acl_create(&prm);
+	if (acx == NULL || ref == NULL) {
+		printf("Line %i: Error creating ACL context!\n", __LINE__);
+		ret = -1;
+		goto out;
+	}
+
+	memset(&cfg, 0, sizeof(cfg));
+	acl_ipv4vlan_config(&cfg, ipv4_7tuple_layout, RTE_ACL_MAX_CATEGORIES);
+
+	/* incremental mode on a context without rules */
+	ret = rte_acl_incr_enable(acx, &cfg, &icfg);
+	if (ret != 0) {
+		printf("Line %i: enabling incremental mode failed: %d\n",
+			__LINE__, ret);
+		goto out;
+	}
+	ret = test_incr_cmp(acx, NULL, acl_test_data, RTE_DIM(acl_test_data));
+	if (ret != 0)
+		goto out;
+
+	if (rte_acl_incr_enable(acx, &cfg, NULL) != -EEXIST) {
+		printf("Line %i: incremental mode enabled twice!\n", __LINE__);
+		ret = -1;
+		goto out;
+	}
+
+	/* add rules one by one, going through delta rebuilds and merges */
+	ret = rte_acl_ipv4vlan_add_rules(acx, acl_test_rules, n);
+	if (ret != 0) {
+		printf("Line %i: incremental add failed: %d\n", __LINE__, ret);
+		goto out;
+	}
+	ret = test_classify_run(acx, acl_test_data, RTE_DIM(acl_test_data));
+	if (ret != 0)
+		goto out;
+
+	/* delete every third rule, compare with a full build of the rest */
+	for (i = 0; i < n; i += 3) {
+		acl_ipv4vlan_convert_rule(acl_test_rules + i, &rv);
+		ret = rte_acl_incr_del_rules(acx,
+			(struct rte_acl_rule *)&rv, 1);
+		if (ret != 0) {
+			printf("Line %i: deleting rule %u failed: %d\n",
+				__LINE__, i, ret);
+			goto out;
+		}
+	}
+	for (i = 0; i != n; i++) {
+		if (i % 3 == 0)
+			continue;
+		ret = rte_acl_ipv4vlan_add_rules(ref, acl_test_rules + i, 1);
+		if (ret != 0)
+			goto out;
+	}
+	ret = rte_acl_build(ref, &cfg);
+	if (ret != 0) {
+		printf("Line %i: building reference failed: %d\n",
+			__LINE__, ret);
+		goto out;
+	}
+	ret = test_incr_cmp(acx, ref, acl_test_data, RTE_DIM(acl_test_data));
+	if (ret != 0)
+		goto out;
+
+	/* deleting a rule twice must fail */
+	acl_ipv4vlan_convert_rule(acl_test_rules, &rv);
+	if (rte_acl_incr_del_rules(acx, (struct rte_acl_rule *)&rv, 1) !=
+			-ENOENT) {
+		printf("Line %i: deleted a missing rule!\n", __LINE__);
+		ret = -1;
+		goto out;
+	}
+
+	ret = rte_acl_incr_merge(acx);
+	if (ret == 0)
+		ret = test_incr_cmp(acx, ref, acl_test_data,
+			RTE_DIM(acl_test_data));
+	if (ret != 0) {
+		printf("Line %i: merge failed: %d\n", __LINE__, ret);
+		goto out;
+	}
+
+	/* put the deleted rules back */
+	for (i = 0; i < n && ret == 0; i += 3)
+		ret = rte_acl_ipv4vlan_add_rules(acx, acl_test_rules + i, 1);
+	if (ret == 0)
+		ret = test_classify_run(acx, acl_test_data,
+			RTE_DIM(acl_test_data));
+	if (ret != 0) {
+		printf("Line %i: re-adding rules failed: %d\n", __LINE__, ret);
+		goto out;
+	}
+
+	/* leaving incremental mode */
+	rte_acl_reset(acx);
+	ret = test_classify_buid(acx, acl_test_rules, n);
+	if (ret == 0)
+		ret = test_classify_run(acx, acl_test_data,
+			RTE_DIM(acl_test_data));
+
+out:
+	rte_acl_free(acx);
+	rte_acl_free(ref);
+	return ret;
+}
+
+#define	TEST_BUILD_RULES	0x2000
+#define	TEST_BUILD_DATA	0x400
+
+/*
+ * Fill rules with random prefixes and port ranges,
+ * and data matching some of them.
+ */
+static void
+test_build_gen(struct rte_acl_ipv4vlan_rule rules[], uint32_t num_rules,
+	struct ipv4_7tuple data[], uint32_t num_data)
+{
+	uint32_t i;
+	uint16_t lo, hi;
+	const struct rte_acl_ipv4vlan_rule *r;
+
+	memset(rules, 0, num_rules * sizeof(rules[0]));
+	for (i = 0; i != num_rules; i++) {
+		rules[i].data.userdata = i + 1;
+		rules[i].data.priority = i + 1;
+		rules[i].data.category_mask = ACL_ALLOW_MASK;
+		rules[i].src_addr = rte_rand();
+		rules[i].src_mask_len = rte_rand_max(33);
+		rules[i].dst_addr = rte_rand();
+		rules[i].dst_mask_len = rte_rand_max(33);
+		lo = rte_rand();
+		hi = rte_rand();
+		rules[i].src_port_low = RTE_MIN(lo, hi);
+		rules[i].src_port_high = RTE_MAX(lo, hi);
+		rules[i].dst_port_low = 0;
+		rules[i].dst_port_high = UINT16_MAX;
+	}
+
+	memset(data, 0, num_data * sizeof(data[0]));
+	for (i = 0; i != num_data; i++) {
+		r = rules + rte_rand_max(num_rules);
+		data[i].ip_src = r->src_addr;
+		data[i].ip_dst = r->dst_addr;
+		data[i].port_src = r->src_port_low;
+		data[i].port_dst = rte_rand();
+	}
+}
+
+/*
+ * Build with worker threads and temporary memory limits below the peak,
+ * making the build fail in the calling thread or in one of the workers.
+ * The failed builds must leave no worker running,
+ * and the context must still build afterwards.
+ */
+static int
+test_build_workers_fail(struct rte_acl_ctx *acx, struct rte_acl_ctx *ref,
+	struct rte_acl_config *cfg, size_t peak, struct ipv4_7tuple data[],
+	uint32_t num_data)
+{
+	int32_t ret;
+	uint32_t i, num_fail;
+	struct rte_acl_build_param bprm;
+	struct rte_acl_build_stats st;
+
+	memset(&bprm, 0, sizeof(bprm));
+	bprm.num_workers = 4;
+
+	num_fail = 0;
+	for (i = 1; i != 16; i++) {
+		bprm.max_tmp_size = peak * i / 16;
+		ret = rte_acl_build_ext(acx, cfg, &bprm, &st);
+		if (ret == -ERANGE) {
+			if (st.num_tries != 0 || st.rt_size != 0) {
+				printf("Line %i: failed build with %zu bytes "
+					"reports %u tries\n",
+					__LINE__, bprm.max_tmp_size,
+					st.num_tries);
+				return -1;
+			}
+			num_fail++;
+		} else if (ret != 0) {
+			printf("Line %i: build with %u workers within %zu bytes "
+				"returned %d\n", __LINE__, bprm.num_workers,
+				bprm.max_tmp_size, ret);
+			return -1;
+		}
+	}
+
+	if (num_fail == 0) {
+		printf("Line %i: no build failed below the peak of %zu bytes\n",
+			__LINE__, peak);
+		return -1;
+	}
+
+	bprm.max_tmp_size = 0;
+	ret = rte_acl_build_ext(acx, cfg, &bprm, NULL);
+	if (ret != 0) {
+		printf("Line %i: build after failures returned %d\n",
+			__LINE__, ret);
+		return -1;
+	}
+
+	return test_incr_cmp(acx, ref, data, num_data);
+}
+
+/*
+ * Test build with worker threads and temporary memory limit.
+ */
+static int
+test_build_workers(void)
+{
+	int32_t ret;
+	struct rte_acl_ctx *acx, *ref;
+	struct rte_acl_config cfg;
+	struct rte_acl_param prm;
+	struct rte_acl_build_param bprm;
+	struct rte_acl_build_stats st, st_ref;
+	struct rte_acl_ipv4vlan_rule *rules;
+	struct ipv4_7tuple *data;
+
+	acx = NULL;
+	ref = NULL;
+	rules = calloc(TEST_BUILD_RULES, sizeof(rules[0]));
+	data = calloc(TEST_BUILD_DATA, sizeof(data[0]));
+	if (rules == NULL || data == NULL) {
+		ret = -ENOMEM;
+		goto out;
+	}
+	test_build_gen(rules, TEST_BUILD_RULES, data, TEST_BUILD_DATA);
+
+	prm = acl_param;
+	prm.name = "acl_bld";
+	acx = rte_acl_create(&prm);
+	prm.name = "acl_bld_ref";
+	ref = rte_acl_create(&prm);
+	if (acx == NULL || ref == NULL) {
+		printf("Line %i: Error creating ACL context!\n", __LINE__);
+		ret = -1;
+		goto out;
+	}
+
+	ret = rte_acl_ipv4vlan_add_rules(acx, rules, TEST_BUILD_RULES);
+	if (ret == 0)
+		ret = rte_acl_ipv4vlan_add_rules(ref, rules, TEST_BUILD_RULES);
+	if (ret != 0) {
+		printf("Line %i: Adding rules failed: %d\n", __LINE__, ret);
+		goto out;
+	}
+
+	memset(&cfg, 0, sizeof(cfg));
+	acl_ipv4vlan_config(&cfg, ipv4_7tuple_layout, RTE_ACL_MAX_CATEGORIES);
+
+	/* build hitting the temporary memory limit must fail */
+	memset(&bprm, 0, sizeof(bprm));
+	bprm.max_tmp_size = 0x1000;
+	ret = rte_acl_build_ext(acx, &cfg, &bprm, NULL);
+	if (ret != -ERANGE) {
+		printf("Line %i: build within %zu bytes returned %d\n",
+			__LINE__, bprm.max_tmp_size, ret);
+		ret = -1;
+		goto out;
+	}
+
+	ret = rte_acl_build_ext(ref, &cfg, NULL, &st_ref);
+	if (ret != 0) {
+		printf("Line %i: reference build failed: %d\n", __LINE__, ret);
+		goto out;
+	}
+
+	bprm.num_workers = 4;
+	bprm.max_tmp_size = 0;
+	ret = rte_acl_build_ext(acx, &cfg, &bprm, &st);
+	if (ret != 0) {
+		printf("Line %i: build with %u workers failed: %d\n",
+			__LINE__, bprm.num_workers, ret);
+		goto out;
+	}
+
+	printf("%s: %u tries, %u nodes, peak build memory: %zu/%zu bytes\n",
+		__func__, st.num_tries, st.num_nodes, st.peak_tmp_size,
+		st_ref.peak_tmp_size);
+
+	if (st.num_tries != st_ref.num_tries || st.rt_size != st_ref.rt_size ||
+			st.peak_tmp_size == 0) {
+		printf("Line %i: builds differ: tries %u/%u, size %zu/%zu\n",
+			__LINE__, st.num_tries, st_ref.num_tries,
+			st.rt_size, st_ref.rt_size);
+		ret = -1;
+		goto out;
+	}
+
+	ret = test_incr_cmp(acx, ref, data, TEST_BUILD_DATA);
+	if (ret != 0)
+		goto out;
+
+	ret = test_build_workers_fail(acx, ref, &cfg, st.peak_tmp_size,
+		data, TEST_BUILD_DATA);
+
+out:
+	rte_acl_free(acx);
+	rte_acl_free(ref);
+	free(rules);
+	free(data);
+	return ret;
+}
+
 static int
 test_acl(void)
 {
@@ -1743,6 +2116,10 @@ test_acl(void)
 		return -1;
 	if (test_u32_range() < 0)
 		return -1;
+	if (test_incr_update() < 0)
+		return -1;
+	if (test_build_workers() < 0)
+		return -1;
 
 	return 0;
 }
@@ -1306,25 +1306,39 @@ static int
 test_dma(void)
 {
 	const char *pmd = "dma_skeleton";
-	int i;
+	/* copies shared by several threads, most of them non-temporal */
+	const char *pmd_mt = "dma_skeleton_mt";
+	const char *pmd_mt_args = "threads=2,nt_threshold=64";
+	int i, ret = 0;
 
 	parse_dma_env_var();
 
 	/* attempt to create skeleton instance - ignore errors due to one being already present*/
 	rte_vdev_init(pmd, NULL);
+	rte_vdev_init(pmd_mt, pmd_mt_args);
 
 	if (rte_dma_count_avail() == 0)
 		return TEST_SKIPPED;
 
 	RTE_DMA_FOREACH_DEV(i) {
-		if (test_dma_api(i) < 0)
-			ERR_RETURN("Error performing API tests\n");
+		if (test_dma_api(i) < 0) {
+			print_err(__func__, __LINE__,
+				"Error performing API tests\n");
+			ret = -1;
+			break;
+		}
 
-		if (test_dmadev_instance(i) < 0)
-			ERR_RETURN("Error, test failure for device %d\n", i);
+		if (test_dmadev_instance(i) < 0) {
+			print_err(__func__, __LINE__,
+				"Error, test failure for device %d\n", i);
+			ret = -1;
+			break;
+		}
 	}
 
-	return 0;
+	rte_vdev_uninit(pmd_mt);
+
+	return ret;
 }
 
 REGISTER_DRIVER_TEST(dmadev_autotest, test_dma);
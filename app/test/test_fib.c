@@ -7,10 +7,12 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include <rte_errno.h>
 #include <rte_ip.h>
 #include <rte_log.h>
 #include <rte_fib.h>
 #include <rte_malloc.h>
+#include <rte_random.h>
 
 #include "test.h"
 
@@ -24,6 +26,10 @@ static int32_t test_get_invalid(void);
 static int32_t test_lookup(void);
 static int32_t test_invalid_rcu(void);
 static int32_t test_fib_rcu_sync_rw(void);
+static int32_t test_modify_bulk(void);
+static int32_t test_poptrie(void);
+static int32_t test_poptrie_churn(void);
+static int32_t test_vrf(void);
 
 #define MAX_ROUTES	(1 << 16)
 #define MAX_TBL8	(1 << 15)
@@ -65,7 +71,7 @@ test_create_invalid(void)
 		"Call succeeded with invalid parameters\n");
 	config.max_routes = MAX_ROUTES;
 
-	config.type = RTE_FIB_DIR24_8 + 1;
+	config.type = RTE_FIB_POPTRIE + 1;
 	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
 	RTE_TEST_ASSERT(fib == NULL,
 		"Call succeeded with invalid parameters\n");
@@ -376,6 +382,14 @@ test_lookup(void)
 		"Check_fib fails for DIR24_8_8B type\n");
 	rte_fib_free(fib);
 
+	config.type = RTE_FIB_POPTRIE;
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	ret = check_fib(fib);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+		"Check_fib fails for POPTRIE type\n");
+	rte_fib_free(fib);
+
 	return TEST_SUCCESS;
 }
 
@@ -463,6 +477,527 @@ test_invalid_rcu(void)
 	return TEST_SUCCESS;
 }
 
+#define BULK_ROUTES	4096
+#define BULK_LOOKUPS	(BULK_ROUTES * 2)
+
+static struct rte_fib_route_op bulk_routes[BULK_ROUTES];
+static struct rte_fib_route_op bulk_ops[BULK_ROUTES * 2];
+
+/*
+ * Compare lookup results of a FIB against the reference one
+ * for the routes addresses and for random addresses.
+ */
+static int
+compare_fib(struct rte_fib *fib, struct rte_fib *ref)
+{
+	static uint32_t ips[BULK_LOOKUPS];
+	static uint64_t nh[BULK_LOOKUPS];
+	static uint64_t ref_nh[BULK_LOOKUPS];
+	uint32_t i;
+
+	for (i = 0; i < BULK_ROUTES; i++) {
+		ips[i] = bulk_routes[i].ip;
+		ips[BULK_ROUTES + i] = rte_rand();
+	}
+
+	RTE_TEST_ASSERT(rte_fib_lookup_bulk(fib, ips, nh, BULK_LOOKUPS) == 0,
+		"Failed to lookup\n");
+	RTE_TEST_ASSERT(rte_fib_lookup_bulk(ref, ips, ref_nh,
+		BULK_LOOKUPS) == 0, "Failed to lookup\n");
+	for (i = 0; i < BULK_LOOKUPS; i++)
+		RTE_TEST_ASSERT(nh[i] == ref_nh[i],
+			"Wrong nexthop for %#x: %"PRIu64" instead of %"PRIu64"\n",
+			ips[i], nh[i], ref_nh[i]);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Apply the operations to the reference FIB one by one and keep
+ * only the successful ones in bulk_ops.
+ */
+static uint32_t
+apply_ref(struct rte_fib *ref, uint32_t n)
+{
+	uint32_t i, k;
+
+	for (i = 0, k = 0; i < n; i++) {
+		if (bulk_ops[i].op == RTE_FIB_ADD) {
+			if (rte_fib_add(ref, bulk_ops[i].ip, bulk_ops[i].depth,
+					bulk_ops[i].next_hop) != 0)
+				continue;
+		} else if (rte_fib_delete(ref, bulk_ops[i].ip,
+				bulk_ops[i].depth) != 0)
+			continue;
+		bulk_ops[k++] = bulk_ops[i];
+	}
+	return k;
+}
+
+static int
+check_fib_bulk(struct rte_fib *fib, struct rte_fib *ref)
+{
+	uint32_t i, n;
+	int ret;
+
+	/* full table load */
+	for (i = 0; i < BULK_ROUTES; i++) {
+		bulk_routes[i].ip = rte_rand();
+		bulk_routes[i].depth = 1 + rte_rand_max(RTE_FIB_MAXDEPTH);
+		bulk_routes[i].op = RTE_FIB_ADD;
+		bulk_routes[i].next_hop = rte_rand_max(1 << 16);
+		bulk_ops[i] = bulk_routes[i];
+	}
+	n = apply_ref(ref, BULK_ROUTES);
+	ret = rte_fib_modify_bulk(fib, bulk_ops, n);
+	RTE_TEST_ASSERT(ret == (int)n, "Failed to add routes in bulk\n");
+	RTE_TEST_ASSERT(compare_fib(fib, ref) == TEST_SUCCESS,
+		"Lookup mismatch after bulk add\n");
+
+	/* a failing operation stops the batch */
+	bulk_ops[0].ip = RTE_IPV4(198, 51, 100, 0);
+	bulk_ops[0].depth = 24;
+	bulk_ops[0].op = RTE_FIB_ADD;
+	bulk_ops[0].next_hop = 1;
+	bulk_ops[1].ip = RTE_IPV4(192, 0, 2, 1);
+	bulk_ops[1].depth = 32;
+	bulk_ops[1].op = RTE_FIB_DEL;
+	bulk_ops[2].ip = RTE_IPV4(203, 0, 113, 0);
+	bulk_ops[2].depth = 24;
+	bulk_ops[2].op = RTE_FIB_ADD;
+	bulk_ops[2].next_hop = 2;
+	rte_fib_delete(ref, bulk_ops[0].ip, bulk_ops[0].depth);
+	rte_fib_delete(fib, bulk_ops[0].ip, bulk_ops[0].depth);
+	rte_fib_delete(ref, bulk_ops[1].ip, bulk_ops[1].depth);
+	rte_fib_delete(fib, bulk_ops[1].ip, bulk_ops[1].depth);
+	rte_fib_delete(ref, bulk_ops[2].ip, bulk_ops[2].depth);
+	rte_fib_delete(fib, bulk_ops[2].ip, bulk_ops[2].depth);
+	ret = rte_fib_modify_bulk(fib, bulk_ops, 3);
+	RTE_TEST_ASSERT((ret == 1) && (rte_errno == ENOENT),
+		"Batch was not stopped at the failing operation\n");
+	rte_fib_add(ref, bulk_ops[0].ip, bulk_ops[0].depth,
+		bulk_ops[0].next_hop);
+	RTE_TEST_ASSERT(compare_fib(fib, ref) == TEST_SUCCESS,
+		"Lookup mismatch after partial batch\n");
+	rte_fib_delete(ref, bulk_ops[0].ip, bulk_ops[0].depth);
+	rte_fib_delete(fib, bulk_ops[0].ip, bulk_ops[0].depth);
+
+	/* churn: delete, update and add routes in one batch */
+	for (i = 0; i < BULK_ROUTES; i++) {
+		bulk_ops[2 * i] = bulk_routes[i];
+		bulk_ops[2 * i].op = (i & 1) ? RTE_FIB_DEL : RTE_FIB_ADD;
+		bulk_ops[2 * i].next_hop = rte_rand_max(1 << 16);
+		bulk_ops[2 * i + 1].ip = rte_rand();
+		bulk_ops[2 * i + 1].depth = 1 + rte_rand_max(RTE_FIB_MAXDEPTH);
+		bulk_ops[2 * i + 1].op = RTE_FIB_ADD;
+		bulk_ops[2 * i + 1].next_hop = rte_rand_max(1 << 16);
+	}
+	n = apply_ref(ref, BULK_ROUTES * 2);
+	ret = rte_fib_modify_bulk(fib, bulk_ops, n);
+	RTE_TEST_ASSERT(ret == (int)n, "Failed to update routes in bulk\n");
+	RTE_TEST_ASSERT(compare_fib(fib, ref) == TEST_SUCCESS,
+		"Lookup mismatch after bulk update\n");
+
+	/* withdraw everything */
+	for (i = 0; i < BULK_ROUTES * 2; i++)
+		bulk_ops[i].op = RTE_FIB_DEL;
+	n = apply_ref(ref, BULK_ROUTES * 2);
+	for (i = 0; i < BULK_ROUTES; i++) {
+		bulk_ops[n] = bulk_routes[i];
+		bulk_ops[n].op = RTE_FIB_DEL;
+		if (rte_fib_delete(ref, bulk_ops[n].ip, bulk_ops[n].depth) == 0)
+			n++;
+	}
+	ret = rte_fib_modify_bulk(fib, bulk_ops, n);
+	RTE_TEST_ASSERT(ret == (int)n, "Failed to delete routes in bulk\n");
+	RTE_TEST_ASSERT(compare_fib(fib, ref) == TEST_SUCCESS,
+		"Lookup mismatch after bulk delete\n");
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Check that a DIR24_8 FIB updated with rte_fib_modify_bulk() returns
+ * the same next hops as a RIB based FIB updated route by route,
+ * without RCU and with both RCU reclamation modes.
+ */
+int32_t
+test_modify_bulk(void)
+{
+	struct rte_fib *fib, *ref;
+	struct rte_fib_conf config = { 0 };
+	struct rte_fib_rcu_config rcu_cfg = { 0 };
+	struct rte_rcu_qsbr *qsv;
+	uint64_t def_nh = 100;
+	int i, ret;
+
+	config.max_routes = MAX_ROUTES;
+	config.rib_ext_sz = 0;
+	config.default_nh = def_nh;
+	config.type = RTE_FIB_DUMMY;
+
+	ref = rte_fib_create("bulk_ref", SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(ref != NULL, "Failed to create FIB\n");
+
+	RTE_TEST_ASSERT(rte_fib_modify_bulk(NULL, bulk_ops, 1) == -EINVAL,
+		"Call succeeded with invalid parameters\n");
+	RTE_TEST_ASSERT(rte_fib_modify_bulk(ref, NULL, 1) == -EINVAL,
+		"Call succeeded with invalid parameters\n");
+
+	qsv = rte_zmalloc(NULL, rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE),
+		RTE_CACHE_LINE_SIZE);
+	RTE_TEST_ASSERT(qsv != NULL, "Can not allocate memory for RCU\n");
+	RTE_TEST_ASSERT(rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE) == 0,
+		"Can not initialize RCU\n");
+	rcu_cfg.v = qsv;
+
+	config.type = RTE_FIB_DIR24_8;
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_4B;
+	config.dir24_8.num_tbl8 = MAX_TBL8;
+
+	/* no RCU, defer queue and blocking modes */
+	for (i = -1; i <= RTE_FIB_QSBR_MODE_SYNC; i++) {
+		fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+		RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+		if (i >= 0) {
+			rcu_cfg.mode = i;
+			RTE_TEST_ASSERT(rte_fib_rcu_qsbr_add(fib,
+				&rcu_cfg) == 0, "Can not attach RCU to FIB\n");
+		}
+		ret = check_fib_bulk(fib, ref);
+		rte_fib_free(fib);
+		RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+			"Bulk update check fails\n");
+	}
+
+	rte_fib_free(ref);
+	rte_free(qsv);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Check that a POPTRIE FIB returns the same next hops as a RIB based FIB
+ * with every lookup implementation, with and without RCU, and that
+ * running out of nodes leaves the FIB unchanged.
+ */
+int32_t
+test_poptrie(void)
+{
+	const enum rte_fib_lookup_type lookup[] = {
+		RTE_FIB_LOOKUP_POPTRIE_SCALAR,
+		RTE_FIB_LOOKUP_POPTRIE_VECTOR_AVX512,
+	};
+	struct rte_fib *fib, *ref;
+	struct rte_fib_conf config = { 0 };
+	struct rte_fib_rcu_config rcu_cfg = { 0 };
+	struct rte_rcu_qsbr *qsv;
+	uint64_t def_nh = 100;
+	uint32_t i, ip;
+	uint8_t depth;
+	int j, ret;
+
+	config.max_routes = MAX_ROUTES;
+	config.rib_ext_sz = 0;
+	config.default_nh = def_nh;
+	config.type = RTE_FIB_DUMMY;
+
+	ref = rte_fib_create("poptrie_ref", SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(ref != NULL, "Failed to create FIB\n");
+
+	qsv = rte_zmalloc(NULL, rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE),
+		RTE_CACHE_LINE_SIZE);
+	RTE_TEST_ASSERT(qsv != NULL, "Can not allocate memory for RCU\n");
+	RTE_TEST_ASSERT(rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE) == 0,
+		"Can not initialize RCU\n");
+	rcu_cfg.v = qsv;
+
+	config.type = RTE_FIB_POPTRIE;
+
+	for (i = 0; i < RTE_DIM(lookup); i++) {
+		/* no RCU, defer queue and blocking modes */
+		for (j = -1; j <= RTE_FIB_QSBR_MODE_SYNC; j++) {
+			fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+			RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+			if (rte_fib_select_lookup(fib, lookup[i]) != 0) {
+				printf("Lookup type %d is not supported\n",
+					lookup[i]);
+				rte_fib_free(fib);
+				break;
+			}
+			if (j >= 0) {
+				rcu_cfg.mode = j;
+				RTE_TEST_ASSERT(rte_fib_rcu_qsbr_add(fib,
+					&rcu_cfg) == 0,
+					"Can not attach RCU to FIB\n");
+			}
+			ret = check_fib_bulk(fib, ref);
+			rte_fib_free(fib);
+			RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+				"Poptrie check fails\n");
+		}
+	}
+
+	/* a failed update must not change the lookup results */
+	config.poptrie.num_nodes = 256;
+	config.poptrie.num_leaves = 1024;
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	for (i = 0, ret = 0; i < BULK_ROUTES && ret != -ENOSPC; i++) {
+		ip = rte_rand();
+		depth = 1 + rte_rand_max(RTE_FIB_MAXDEPTH);
+		ret = rte_fib_add(fib, ip, depth, i);
+		RTE_TEST_ASSERT(ret == 0 || ret == -ENOSPC,
+			"Unexpected error %d while adding a route\n", ret);
+		bulk_routes[i].ip = ip;
+		if (ret == 0)
+			rte_fib_add(ref, ip, depth, i);
+	}
+	RTE_TEST_ASSERT(ret == -ENOSPC, "Poptrie never ran out of nodes\n");
+	for (; i < BULK_ROUTES; i++)
+		bulk_routes[i].ip = rte_rand();
+	ret = compare_fib(fib, ref);
+	rte_fib_free(fib);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+		"Lookup mismatch after running out of nodes\n");
+
+	rte_fib_free(ref);
+	rte_free(qsv);
+
+	return TEST_SUCCESS;
+}
+
+#define CHURN_ROUNDS	32
+
+/* Add routes to a new poptrie until it runs out of memory. */
+static int
+fill_poptrie(struct rte_fib_conf *config, struct rte_fib_route_op *routes,
+	uint32_t max, uint32_t *nb)
+{
+	struct rte_fib *fib;
+	int ret = 0;
+
+	fib = rte_fib_create("poptrie_fill", SOCKET_ID_ANY, config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	for (*nb = 0; *nb < max; (*nb)++) {
+		ret = rte_fib_add(fib, routes[*nb].ip, routes[*nb].depth,
+			routes[*nb].next_hop);
+		if (ret != 0)
+			break;
+	}
+	rte_fib_free(fib);
+	RTE_TEST_ASSERT(ret == -ENOSPC,
+		"Poptrie did not run out of nodes: %d\n", ret);
+
+	return TEST_SUCCESS;
+}
+
+/* Add then delete the routes, all of them must succeed. */
+static int
+add_del_poptrie(struct rte_fib *fib, struct rte_fib_route_op *routes,
+	uint32_t nb)
+{
+	uint32_t i;
+	int ret;
+
+	for (i = 0; i < nb; i++) {
+		ret = rte_fib_add(fib, routes[i].ip, routes[i].depth,
+			routes[i].next_hop);
+		RTE_TEST_ASSERT(ret == 0, "Failed to add route %u of %u: %d\n",
+			i, nb, ret);
+	}
+	for (i = 0; i < nb; i++) {
+		ret = rte_fib_delete(fib, routes[i].ip, routes[i].depth);
+		/* duplicated routes are deleted once */
+		RTE_TEST_ASSERT(ret == 0 || ret == -ENOENT,
+			"Failed to delete route %u of %u: %d\n", i, nb, ret);
+	}
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Check that the memory freed by deleted routes is merged back:
+ * routes fitting in half of an empty poptrie must still fit after
+ * the poptrie was filled and emptied many times by other routes.
+ */
+int32_t
+test_poptrie_churn(void)
+{
+	static uint32_t ips[BULK_LOOKUPS];
+	static uint64_t nh[BULK_LOOKUPS];
+	struct rte_fib *fib;
+	struct rte_fib_conf config = { 0 };
+	uint32_t i, nb, nb_host, round;
+
+	config.max_routes = MAX_ROUTES;
+	config.default_nh = 100;
+	config.type = RTE_FIB_POPTRIE;
+	config.poptrie.num_nodes = 256;
+	config.poptrie.num_leaves = 1024;
+
+	/* routes of any length and host routes, sized on an empty poptrie */
+	for (i = 0; i < BULK_ROUTES; i++) {
+		bulk_routes[i].ip = rte_rand();
+		bulk_routes[i].depth = 1 + rte_rand_max(RTE_FIB_MAXDEPTH);
+		bulk_routes[i].next_hop = i;
+	}
+	for (i = 0; i < BULK_ROUTES * 2; i++) {
+		bulk_ops[i].ip = rte_rand();
+		bulk_ops[i].depth = RTE_FIB_MAXDEPTH;
+		bulk_ops[i].next_hop = i;
+	}
+	RTE_TEST_ASSERT(fill_poptrie(&config, bulk_routes, BULK_ROUTES,
+		&nb) == TEST_SUCCESS, "Failed to fill poptrie\n");
+	RTE_TEST_ASSERT(fill_poptrie(&config, bulk_ops, BULK_ROUTES * 2,
+		&nb_host) == TEST_SUCCESS, "Failed to fill poptrie\n");
+
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	for (round = 0; round < CHURN_ROUNDS; round++) {
+		/* fragment the memory with the host routes */
+		RTE_TEST_ASSERT(add_del_poptrie(fib, bulk_ops,
+			nb_host * 3 / 4) == TEST_SUCCESS,
+			"Round %u: host routes do not fit\n", round);
+		RTE_TEST_ASSERT(add_del_poptrie(fib, bulk_routes,
+			nb / 2) == TEST_SUCCESS,
+			"Round %u: routes do not fit\n", round);
+	}
+
+	/* nothing is left behind */
+	for (i = 0; i < BULK_LOOKUPS; i++)
+		ips[i] = rte_rand();
+	RTE_TEST_ASSERT(rte_fib_lookup_bulk(fib, ips, nh, BULK_LOOKUPS) == 0,
+		"Failed to lookup\n");
+	for (i = 0; i < BULK_LOOKUPS; i++)
+		RTE_TEST_ASSERT(nh[i] == config.default_nh,
+			"Route left behind for %#x\n", ips[i]);
+
+	rte_fib_free(fib);
+
+	return TEST_SUCCESS;
+}
+
+#define VRF_NUM		4
+
+/*
+ * Check that every address is looked up in the routes of its own VRF
+ * with every lookup implementation, using a RIB based FIB as reference.
+ */
+int32_t
+test_vrf(void)
+{
+	const enum rte_fib_lookup_type lookup[] = {
+		RTE_FIB_LOOKUP_DIR24_8_SCALAR_MACRO,
+		RTE_FIB_LOOKUP_DIR24_8_VECTOR_AVX512,
+	};
+	static uint16_t vrf_ids[BULK_LOOKUPS];
+	static uint32_t ips[BULK_LOOKUPS];
+	static uint64_t nh[BULK_LOOKUPS];
+	static uint64_t ref_nh[BULK_LOOKUPS];
+	struct rte_fib *fib, *ref;
+	struct rte_fib_conf config = { 0 };
+	uint32_t i, j;
+	uint16_t vrf;
+	int ret, ref_ret;
+
+	config.max_routes = BULK_ROUTES;
+	config.default_nh = 100;
+	config.type = RTE_FIB_POPTRIE;
+	fib = rte_fib_vrf_create(__func__, SOCKET_ID_ANY, &config, VRF_NUM);
+	RTE_TEST_ASSERT(fib == NULL,
+		"Created a multi VRF FIB of a type without VRF support\n");
+
+	config.type = RTE_FIB_DUMMY;
+	fib = rte_fib_vrf_create(__func__, SOCKET_ID_ANY, &config, 0);
+	RTE_TEST_ASSERT(fib == NULL, "Created a FIB without VRF\n");
+	fib = rte_fib_vrf_create(__func__, SOCKET_ID_ANY, &config,
+		RTE_FIB_MAX_VRFS + 1);
+	RTE_TEST_ASSERT(fib == NULL, "Created a FIB with too many VRFs\n");
+
+	ref = rte_fib_vrf_create("vrf_ref", SOCKET_ID_ANY, &config, VRF_NUM);
+	RTE_TEST_ASSERT(ref != NULL, "Failed to create FIB\n");
+
+	config.type = RTE_FIB_DIR24_8;
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_2B;
+	config.dir24_8.num_tbl8 = MAX_TBL8 / 2;
+	fib = rte_fib_vrf_create(__func__, SOCKET_ID_ANY, &config, VRF_NUM);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+	RTE_TEST_ASSERT(rte_fib_vrf_get_rib(fib, VRF_NUM) == NULL,
+		"Got the RIB of a missing VRF\n");
+	RTE_TEST_ASSERT(rte_fib_vrf_add(fib, VRF_NUM, RTE_IPV4(10, 0, 0, 0),
+		8, 1) == -EINVAL, "Added a route to a missing VRF\n");
+
+	/* the same prefix with a different next hop in every VRF */
+	for (vrf = 0; vrf < VRF_NUM; vrf++) {
+		RTE_TEST_ASSERT(rte_fib_vrf_add(fib, vrf,
+			RTE_IPV4(10, 0, 0, 0), 8, 1000 + vrf) == 0,
+			"Failed to add a route\n");
+		RTE_TEST_ASSERT(rte_fib_vrf_add(ref, vrf,
+			RTE_IPV4(10, 0, 0, 0), 8, 1000 + vrf) == 0,
+			"Failed to add a route\n");
+	}
+
+	for (i = 0; i < BULK_ROUTES; i++) {
+		bulk_routes[i].ip = rte_rand();
+		bulk_routes[i].depth = 1 + rte_rand_max(RTE_FIB_MAXDEPTH);
+		vrf = i % VRF_NUM;
+		ret = rte_fib_vrf_add(fib, vrf, bulk_routes[i].ip,
+			bulk_routes[i].depth, i);
+		ref_ret = rte_fib_vrf_add(ref, vrf, bulk_routes[i].ip,
+			bulk_routes[i].depth, i);
+		RTE_TEST_ASSERT(ret == ref_ret, "Failed to add a route\n");
+	}
+	for (i = 0; i < BULK_ROUTES; i += 3) {
+		vrf = i % VRF_NUM;
+		ret = rte_fib_vrf_delete(fib, vrf, bulk_routes[i].ip,
+			bulk_routes[i].depth);
+		ref_ret = rte_fib_vrf_delete(ref, vrf, bulk_routes[i].ip,
+			bulk_routes[i].depth);
+		RTE_TEST_ASSERT(ret == ref_ret, "Failed to delete a route\n");
+	}
+
+	for (i = 0; i < BULK_ROUTES; i++) {
+		ips[i] = bulk_routes[i].ip;
+		ips[BULK_ROUTES + i] = rte_rand();
+	}
+	for (i = 0; i < BULK_LOOKUPS; i++)
+		vrf_ids[i] = rte_rand_max(VRF_NUM);
+	RTE_TEST_ASSERT(rte_fib_vrf_lookup_bulk(ref, vrf_ids, ips, ref_nh,
+		BULK_LOOKUPS) == 0, "Failed to lookup\n");
+
+	for (j = 0; j < RTE_DIM(lookup); j++) {
+		if (rte_fib_select_lookup(fib, lookup[j]) != 0) {
+			printf("Lookup type %d is not supported\n", lookup[j]);
+			continue;
+		}
+		RTE_TEST_ASSERT(rte_fib_vrf_lookup_bulk(fib, vrf_ids, ips, nh,
+			BULK_LOOKUPS) == 0, "Failed to lookup\n");
+		for (i = 0; i < BULK_LOOKUPS; i++)
+			RTE_TEST_ASSERT(nh[i] == ref_nh[i],
+				"Wrong nexthop for %#x in VRF %u: %"PRIu64
+				" instead of %"PRIu64"\n",
+				ips[i], vrf_ids[i], nh[i], ref_nh[i]);
+	}
+
+	/* rte_fib_lookup_bulk() looks up in VRF 0 */
+	memset(vrf_ids, 0, sizeof(vrf_ids));
+	RTE_TEST_ASSERT(rte_fib_vrf_lookup_bulk(ref, vrf_ids, ips, ref_nh,
+		BULK_LOOKUPS) == 0, "Failed to lookup\n");
+	RTE_TEST_ASSERT(rte_fib_lookup_bulk(fib, ips, nh, BULK_LOOKUPS) == 0,
+		"Failed to lookup\n");
+	for (i = 0; i < BULK_LOOKUPS; i++)
+		RTE_TEST_ASSERT(nh[i] == ref_nh[i],
+			"Wrong nexthop for %#x: %"PRIu64" instead of %"PRIu64"\n",
+			ips[i], nh[i], ref_nh[i]);
+
+	rte_fib_free(fib);
+	rte_fib_free(ref);
+
+	return TEST_SUCCESS;
+}
+
 static struct rte_fib *g_fib;
 static struct rte_rcu_qsbr *g_v;
 static uint32_t g_ip = RTE_IPV4(192, 0, 2, 100);
@@ -600,6 +1135,10 @@ static struct unit_test_suite fib_fast_tests = {
 	TEST_CASE(test_lookup),
 	TEST_CASE(test_invalid_rcu),
 	TEST_CASE(test_fib_rcu_sync_rw),
+	TEST_CASE(test_modify_bulk),
+	TEST_CASE(test_poptrie),
+	TEST_CASE(test_poptrie_churn),
+	TEST_CASE(test_vrf),
 	TEST_CASES_END()
 	}
 };
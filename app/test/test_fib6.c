@@ -9,6 +9,7 @@
 
 #include <rte_memory.h>
 #include <rte_log.h>
+#include <rte_random.h>
 #include <rte_rib6.h>
 #include <rte_fib6.h>
 
@@ -22,6 +23,7 @@ static int32_t test_free_null(void);
 static int32_t test_add_del_invalid(void);
 static int32_t test_get_invalid(void);
 static int32_t test_lookup(void);
+static int32_t test_poptrie(void);
 
 #define MAX_ROUTES	(1 << 16)
 /** Maximum number of tbl8 for 2-byte entries */
@@ -64,7 +66,7 @@ test_create_invalid(void)
 		"Call succeeded with invalid parameters\n");
 	config.max_routes = MAX_ROUTES;
 
-	config.type = RTE_FIB6_TRIE + 1;
+	config.type = RTE_FIB6_POPTRIE + 1;
 	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
 	RTE_TEST_ASSERT(fib == NULL,
 		"Call succeeded with invalid parameters\n");
@@ -384,6 +386,138 @@ test_lookup(void)
 		"Check_fib fails for TRIE_8B type\n");
 	rte_fib6_free(fib);
 
+	config.type = RTE_FIB6_POPTRIE;
+	config.poptrie.num_nodes = 0;
+	config.poptrie.num_leaves = 0;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	ret = check_fib(fib);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+		"Check_fib fails for POPTRIE type\n");
+	rte_fib6_free(fib);
+
+	return TEST_SUCCESS;
+}
+
+#define POPTRIE_ROUTES	2048
+#define POPTRIE_LOOKUPS	(POPTRIE_ROUTES * 2)
+
+static struct rte_ipv6_addr poptrie_ips[POPTRIE_LOOKUPS];
+static uint8_t poptrie_depth[POPTRIE_ROUTES];
+
+/* Random address sharing its first bits with one of a few prefixes. */
+static void
+rand_ip6(struct rte_ipv6_addr *ip)
+{
+	static const struct rte_ipv6_addr base[] = {
+		RTE_IPV6(0x2001, 0xdb8, 0, 0, 0, 0, 0, 0),
+		RTE_IPV6(0x2001, 0xdb8, 0xffff, 0, 0, 0, 0, 0),
+		RTE_IPV6(0xfc00, 0, 0, 0, 0, 0, 0, 0),
+	};
+	uint8_t keep = rte_rand_max(RTE_IPV6_MAX_DEPTH);
+	unsigned int i;
+
+	*ip = base[rte_rand_max(RTE_DIM(base))];
+	rte_ipv6_addr_mask(ip, keep);
+	for (i = keep; i < RTE_IPV6_MAX_DEPTH; i++)
+		if (rte_rand() & 1)
+			ip->a[i / CHAR_BIT] |= 0x80 >> (i % CHAR_BIT);
+}
+
+static int
+compare_fib6(struct rte_fib6 *fib, struct rte_fib6 *ref)
+{
+	static uint64_t nh[POPTRIE_LOOKUPS];
+	static uint64_t ref_nh[POPTRIE_LOOKUPS];
+	uint32_t i;
+
+	for (i = POPTRIE_ROUTES; i < POPTRIE_LOOKUPS; i++)
+		rand_ip6(&poptrie_ips[i]);
+
+	RTE_TEST_ASSERT(rte_fib6_lookup_bulk(fib, poptrie_ips, nh,
+		POPTRIE_LOOKUPS) == 0, "Failed to lookup\n");
+	RTE_TEST_ASSERT(rte_fib6_lookup_bulk(ref, poptrie_ips, ref_nh,
+		POPTRIE_LOOKUPS) == 0, "Failed to lookup\n");
+	for (i = 0; i < POPTRIE_LOOKUPS; i++)
+		RTE_TEST_ASSERT(nh[i] == ref_nh[i],
+			"Wrong nexthop for " RTE_IPV6_ADDR_FMT ": %"PRIu64
+			" instead of %"PRIu64"\n",
+			RTE_IPV6_ADDR_SPLIT(&poptrie_ips[i]), nh[i], ref_nh[i]);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Check that a POPTRIE FIB returns the same next hops as a RIB based FIB
+ * while nested routes are added, updated and deleted.
+ */
+int32_t
+test_poptrie(void)
+{
+	struct rte_fib6 *fib, *ref;
+	struct rte_fib6_conf config = { 0 };
+	uint64_t nh;
+	uint32_t i;
+	int ret, ref_ret;
+
+	config.max_routes = MAX_ROUTES;
+	config.default_nh = 100;
+	config.type = RTE_FIB6_DUMMY;
+	ref = rte_fib6_create("poptrie6_ref", SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(ref != NULL, "Failed to create FIB\n");
+
+	config.type = RTE_FIB6_POPTRIE;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	RTE_TEST_ASSERT(rte_fib6_select_lookup(fib,
+		RTE_FIB6_LOOKUP_TRIE_SCALAR) == -EINVAL,
+		"Selected a lookup of another FIB type\n");
+	RTE_TEST_ASSERT(rte_fib6_select_lookup(fib,
+		RTE_FIB6_LOOKUP_POPTRIE_SCALAR) == 0,
+		"Failed to select poptrie lookup\n");
+
+	for (i = 0; i < POPTRIE_ROUTES; i++) {
+		rand_ip6(&poptrie_ips[i]);
+		poptrie_depth[i] = 1 + rte_rand_max(RTE_IPV6_MAX_DEPTH);
+		nh = rte_rand_max(1 << 16);
+		ret = rte_fib6_add(fib, &poptrie_ips[i], poptrie_depth[i], nh);
+		ref_ret = rte_fib6_add(ref, &poptrie_ips[i], poptrie_depth[i],
+			nh);
+		RTE_TEST_ASSERT(ret == ref_ret, "Failed to add a route\n");
+	}
+	ret = compare_fib6(fib, ref);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "Lookup mismatch after add\n");
+
+	for (i = 0; i < POPTRIE_ROUTES; i++) {
+		if (i & 1) {
+			ret = rte_fib6_delete(fib, &poptrie_ips[i],
+				poptrie_depth[i]);
+			ref_ret = rte_fib6_delete(ref, &poptrie_ips[i],
+				poptrie_depth[i]);
+		} else {
+			nh = rte_rand_max(1 << 16);
+			ret = rte_fib6_add(fib, &poptrie_ips[i],
+				poptrie_depth[i], nh);
+			ref_ret = rte_fib6_add(ref, &poptrie_ips[i],
+				poptrie_depth[i], nh);
+		}
+		RTE_TEST_ASSERT(ret == ref_ret, "Failed to update a route\n");
+	}
+	ret = compare_fib6(fib, ref);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "Lookup mismatch after update\n");
+
+	for (i = 0; i < POPTRIE_ROUTES; i++) {
+		ret = rte_fib6_delete(fib, &poptrie_ips[i], poptrie_depth[i]);
+		ref_ret = rte_fib6_delete(ref, &poptrie_ips[i],
+			poptrie_depth[i]);
+		RTE_TEST_ASSERT(ret == ref_ret, "Failed to delete a route\n");
+	}
+	ret = compare_fib6(fib, ref);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "Lookup mismatch after delete\n");
+
+	rte_fib6_free(fib);
+	rte_fib6_free(ref);
+
 	return TEST_SUCCESS;
 }
 
@@ -397,6 +531,7 @@ static struct unit_test_suite fib6_fast_tests = {
 	TEST_CASE(test_add_del_invalid),
 	TEST_CASE(test_get_invalid),
 	TEST_CASE(test_lookup),
+	TEST_CASE(test_poptrie),
 	TEST_CASES_END()
 	}
 };
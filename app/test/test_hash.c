@@ -1879,7 +1879,13 @@ test_hash_add_delete_jhash_3word(void)
 static struct rte_hash *g_handle;
 static struct rte_rcu_qsbr *g_qsv;
 static volatile uint8_t writer_done;
-struct flow_key g_rand_keys[9];
+/* Should match RTE_HASH_BUCKET_ENTRIES in rte_cuckoo_hash.h */
+#ifdef RTE_HASH_BUCKET_ENTRIES
+#define HASH_BUCKET_ENTRIES RTE_HASH_BUCKET_ENTRIES
+#else
+#define HASH_BUCKET_ENTRIES 8
+#endif
+struct flow_key g_rand_keys[HASH_BUCKET_ENTRIES + 1];
 
 /*
  * rte_hash_rcu_qsbr_add positive and negative tests.
@@ -1950,9 +1956,10 @@ test_hash_rcu_qsbr_add(void)
 /*
  * rte_hash_rcu_qsbr_add DQ mode functional test.
  * Reader and writer are in the same thread in this test.
- *  - Create hash which supports maximum 8 (9 if ext bkt is enabled) entries
+ *  - Create hash which supports maximum a bucket worth of entries
+ *    (one more if ext bkt is enabled)
  *  - Add RCU QSBR variable to hash
- *  - Add 8 hash entries and fill the bucket
+ *  - Add a bucket worth of hash entries and fill the bucket
  *  - If ext bkt is enabled, add 1 extra entry that is available in the ext bkt
  *  - Register a reader thread (not a real thread)
  *  - Reader lookup existing entry
@@ -1966,7 +1973,8 @@ test_hash_rcu_qsbr_add(void)
 static int
 test_hash_rcu_qsbr_dq_mode(uint8_t ext_bkt)
 {
-	uint32_t total_entries = (ext_bkt == 0) ? 8 : 9;
+	uint32_t total_entries = (ext_bkt == 0) ?
+		HASH_BUCKET_ENTRIES : HASH_BUCKET_ENTRIES + 1;
 
 	uint8_t hash_extra_flag = RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF;
 
@@ -2128,7 +2136,8 @@ test_hash_rcu_qsbr_reader(void *arg)
 /*
  * rte_hash_rcu_qsbr_add sync mode functional test.
  * 1 Reader and 1 writer. They cannot be in the same thread in this test.
- *  - Create hash which supports maximum 8 (9 if ext bkt is enabled) entries
+ *  - Create hash which supports maximum a bucket worth of entries
+ *    (one more if ext bkt is enabled)
  *  - Add RCU QSBR variable to hash
  *  - Register a reader thread. Reader keeps looking up a specific key.
  *  - Writer keeps adding and deleting a specific key.
@@ -2136,7 +2145,8 @@ test_hash_rcu_qsbr_reader(void *arg)
 static int
 test_hash_rcu_qsbr_sync_mode(uint8_t ext_bkt)
 {
-	uint32_t total_entries = (ext_bkt == 0) ? 8 : 9;
+	uint32_t total_entries = (ext_bkt == 0) ?
+		HASH_BUCKET_ENTRIES : HASH_BUCKET_ENTRIES + 1;
 
 	uint8_t hash_extra_flag = RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF;
 
@@ -2243,9 +2253,9 @@ test_hash_rcu_qsbr_dq_reclaim(void)
 {
 	size_t sz;
 	int32_t status;
-	unsigned int total_entries = 8;
+	unsigned int total_entries = HASH_BUCKET_ENTRIES;
 	unsigned int freed, pending, available;
-	uint32_t reclaim_keys[8] = {10, 11, 12, 13, 14, 15, 16, 17};
+	uint32_t reclaim_keys[HASH_BUCKET_ENTRIES / 2];
 	struct rte_hash_rcu_config rcu_cfg = {0};
 	struct rte_hash_parameters hash_params = {
 			.name = "test_hash_rcu_qsbr_dq_reclaim",
@@ -2263,6 +2273,9 @@ test_hash_rcu_qsbr_dq_reclaim(void)
 
 	printf("\n# Running RCU QSBR DQ mode, reclaim defer queue functional test\n");
 
+	for (size_t i = 0; i < RTE_DIM(reclaim_keys); i++)
+		reclaim_keys[i] = 10 + i;
+
 	g_handle = rte_hash_create(&hash_params);
 	RETURN_IF_ERROR_RCU_QSBR(g_handle == NULL, "Hash creation failed");
 
@@ -22,7 +22,11 @@
 #define ADD_PERCENT 0.75 /* 75% table utilization */
 #define NUM_LOOKUPS (KEYS_TO_ADD * 5) /* Loop among keys added, several times */
 /* BUCKET_SIZE should be same as RTE_HASH_BUCKET_ENTRIES in rte_hash library */
+#ifdef RTE_HASH_BUCKET_ENTRIES
+#define BUCKET_SIZE RTE_HASH_BUCKET_ENTRIES
+#else
 #define BUCKET_SIZE 8
+#endif
 #define NUM_BUCKETS (MAX_ENTRIES / BUCKET_SIZE)
 #define MAX_KEYSIZE 64
 #define NUM_KEYSIZES 10
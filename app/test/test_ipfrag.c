@@ -242,6 +242,54 @@ v6_allocate_packet_of(struct rte_mbuf *b, int fill, size_t s, uint8_t ttl,
 	memset(&hdr->dst_addr, 0x04, sizeof(hdr->src_addr));
 }
 
+/* Create the fragments of a packet, without using the library */
+static int32_t
+v6_allocate_fragments_of(struct rte_mbuf **pkts, uint32_t nb_pkts, int fill,
+			 size_t s, size_t mtu, uint32_t pktid)
+{
+	struct rte_ipv6_fragment_ext *fh;
+	struct rte_ipv6_hdr *hdr;
+	size_t frag_size, ofs, len;
+	uint32_t n;
+
+	frag_size = RTE_ALIGN_FLOOR(mtu - sizeof(*hdr) - sizeof(*fh),
+				    RTE_IPV6_EHDR_FO_ALIGN);
+
+	for (n = 0, ofs = 0; ofs < s; n++, ofs += len) {
+		if (n == nb_pkts)
+			return -ENOSPC;
+
+		pkts[n] = rte_pktmbuf_alloc(pkt_pool);
+		if (pkts[n] == NULL)
+			return -ENOMEM;
+
+		len = RTE_MIN(frag_size, s - ofs);
+		hdr = (struct rte_ipv6_hdr *)rte_pktmbuf_append(pkts[n],
+				sizeof(*hdr) + sizeof(*fh) + len);
+		if (hdr == NULL)
+			return -ENOSPC;
+
+		fh = (struct rte_ipv6_fragment_ext *)(hdr + 1);
+		memset(rte_pktmbuf_mtod_offset(pkts[n], char *,
+				sizeof(*hdr) + sizeof(*fh)), fill, len);
+
+		hdr->vtc_flow = rte_cpu_to_be_32(0x60 << 24);
+		hdr->payload_len = rte_cpu_to_be_16(sizeof(*fh) + len);
+		hdr->proto = IPPROTO_FRAGMENT;
+		hdr->hop_limits = 64;
+		memset(&hdr->src_addr, 0x08, sizeof(hdr->src_addr));
+		memset(&hdr->dst_addr, 0x04, sizeof(hdr->dst_addr));
+
+		fh->next_header = IPPROTO_ICMP;
+		fh->reserved = 0;
+		fh->frag_data = rte_cpu_to_be_16(RTE_IPV6_SET_FRAG_DATA(ofs,
+				ofs + len < s));
+		fh->id = rte_cpu_to_be_32(pktid);
+	}
+
+	return n;
+}
+
 static inline void
 test_free_fragments(struct rte_mbuf *mb[], uint32_t num)
 {
@@ -488,6 +536,116 @@ test_ip_frag(void)
 	return result;
 }
 
+static int
+test_ip_frag_reassemble_burst(void)
+{
+	static const size_t pkt_size = 1400;
+	static const size_t mtu_size = 144;
+	struct rte_ip_frag_tbl_param prm = {
+		.bucket_num = 16,
+		.bucket_entries = 4,
+		.max_entries = 64,
+		.max_frags = 16,
+		.max_cycles = UINT64_MAX / 2,
+		.socket_id = SOCKET_ID_ANY,
+		.flags = RTE_IP_FRAG_TBL_F_SHARED,
+	};
+	struct rte_ip_frag_death_row dr = { .cnt = 0 };
+	struct rte_mbuf *pkts[BURST], *b, *tmp;
+	struct rte_ip_frag_tbl *tbl;
+	int32_t ipv, len, i, j;
+	uint16_t n;
+
+	tbl = rte_ip_frag_table_create_ext(&prm);
+	RTE_TEST_ASSERT_NOT_NULL(tbl, "Failed to create shared table.");
+
+	for (ipv = 4; ipv <= 6; ipv += 2) {
+		b = rte_pktmbuf_alloc(pkt_pool);
+		RTE_TEST_ASSERT_NOT_NULL(b, "Failed to allocate pkt.");
+
+		if (ipv == 4) {
+			v4_allocate_packet_of(b, 0x41414141, pkt_size, 0, 0, 0,
+					      64, IPPROTO_ICMP, 0x1234, false,
+					      false, false);
+			len = rte_ipv4_fragment_copy_nonseg_packet(b, pkts,
+					BURST - 1, mtu_size, direct_pool);
+			rte_pktmbuf_free(b);
+		} else {
+			/* the IPv6 minimum MTU is too large for a single mbuf */
+			rte_pktmbuf_free(b);
+			len = v6_allocate_fragments_of(pkts, BURST - 1,
+					0x41414141, pkt_size, mtu_size,
+					0x1234);
+		}
+
+		/* more fragments than a default table can reassemble */
+		RTE_TEST_ASSERT(len > RTE_LIBRTE_IP_FRAG_MAX_FRAG &&
+				len <= (int32_t)prm.max_frags,
+				"Unexpected number of fragments %d.", len);
+
+		for (i = 0; i != len; i++) {
+			pkts[i]->l2_len = 0;
+			pkts[i]->l3_len = (ipv == 4) ?
+				sizeof(struct rte_ipv4_hdr) :
+				sizeof(struct rte_ipv6_hdr) +
+				sizeof(struct rte_ipv6_fragment_ext);
+		}
+
+		/* shuffle the fragments, and add an unfragmented packet */
+		for (i = len - 1; i > 0; i--) {
+			j = rte_rand_max(i + 1);
+			tmp = pkts[i];
+			pkts[i] = pkts[j];
+			pkts[j] = tmp;
+		}
+
+		b = rte_pktmbuf_alloc(pkt_pool);
+		RTE_TEST_ASSERT_NOT_NULL(b, "Failed to allocate pkt.");
+		if (ipv == 4)
+			v4_allocate_packet_of(b, 0x42424242, 64, 0, 0, 0, 64,
+					      IPPROTO_ICMP, 0, false, false,
+					      false);
+		else
+			v6_allocate_packet_of(b, 0x42424242, 64, 64,
+					      IPPROTO_ICMP, 0);
+		b->l2_len = 0;
+		b->l3_len = (ipv == 4) ? sizeof(struct rte_ipv4_hdr) :
+			sizeof(struct rte_ipv6_hdr);
+		pkts[len] = pkts[len / 2];
+		pkts[len / 2] = b;
+
+		if (ipv == 4)
+			n = rte_ipv4_frag_reassemble_burst(tbl, &dr, pkts,
+					len + 1, rte_rdtsc());
+		else
+			n = rte_ipv6_frag_reassemble_burst(tbl, &dr, pkts,
+					len + 1, rte_rdtsc());
+		rte_ip_frag_free_death_row(&dr, 0);
+
+		RTE_TEST_ASSERT_EQUAL(n, 2, "IPv%d: returned %u packets.",
+				      ipv, n);
+		b = (pkts[0]->nb_segs > 1) ? pkts[0] : pkts[1];
+		tmp = (b == pkts[0]) ? pkts[1] : pkts[0];
+		printf("[check reassembly] IPv%d: %u bytes in %u segments\n",
+		       ipv, b->pkt_len, b->nb_segs);
+		RTE_TEST_ASSERT_EQUAL(tmp->pkt_len, tmp->l3_len + 64u,
+				      "IPv%d: unexpected unfragmented packet.",
+				      ipv);
+		RTE_TEST_ASSERT_EQUAL(b->pkt_len,
+				      pkt_size + ((ipv == 4) ?
+				      sizeof(struct rte_ipv4_hdr) :
+				      sizeof(struct rte_ipv6_hdr)),
+				      "IPv%d: unexpected reassembled length.",
+				      ipv);
+		rte_pktmbuf_free(pkts[0]);
+		rte_pktmbuf_free(pkts[1]);
+	}
+
+	rte_ip_frag_table_destroy(tbl);
+
+	return TEST_SUCCESS;
+}
+
 static struct unit_test_suite ipfrag_testsuite  = {
 	.suite_name = "IP Frag Unit Test Suite",
 	.setup = testsuite_setup,
@@ -495,6 +653,8 @@ static struct unit_test_suite ipfrag_testsuite  = {
 	.unit_test_cases = {
 		TEST_CASE_ST(ut_setup, ut_teardown,
 			     test_ip_frag),
+		TEST_CASE_ST(ut_setup, ut_teardown,
+			     test_ip_frag_reassemble_burst),
 
 		TEST_CASES_END() /**< NULL terminate unit test array */
 	}
@@ -29,6 +29,7 @@ typedef int32_t (*rte_ipsec_sad_test)(void);
 static int32_t test_create_invalid(void);
 static int32_t test_find_existing(void);
 static int32_t test_multiple_create(void);
+static int32_t test_create_small(void);
 static int32_t test_add_invalid(void);
 static int32_t test_delete_invalid(void);
 static int32_t test_lookup_invalid(void);
@@ -149,6 +150,44 @@ test_multiple_create(void)
 	return TEST_SUCCESS;
 }
 
+/*
+ * Create a SAD with fewer SA than a hash table holds at minimum,
+ * whatever the number of entries per bucket of the hash library
+ */
+int32_t
+test_create_small(void)
+{
+	struct rte_ipsec_sadv4_key tuple = {SPI, DIP, SIP};
+	const union rte_ipsec_sad_key *key_arr[] = {
+		(union rte_ipsec_sad_key *)&tuple};
+	struct rte_ipsec_sad *sad;
+	struct rte_ipsec_sad_conf config;
+	uint64_t tmp;
+	void *sa[1];
+	int status;
+
+	config.max_sa[RTE_IPSEC_SAD_SPI_ONLY] = 1;
+	config.max_sa[RTE_IPSEC_SAD_SPI_DIP] = 1;
+	config.max_sa[RTE_IPSEC_SAD_SPI_DIP_SIP] = 1;
+	config.socket_id = SOCKET_ID_ANY;
+	config.flags = 0;
+
+	sad = rte_ipsec_sad_create(__func__, &config);
+	RTE_TEST_ASSERT_NOT_NULL(sad, "Failed to create SAD\n");
+
+	status = rte_ipsec_sad_add(sad, key_arr[0],
+		RTE_IPSEC_SAD_SPI_DIP_SIP, &tmp);
+	RTE_TEST_ASSERT(status == 0, "Failed to add a rule\n");
+
+	status = rte_ipsec_sad_lookup(sad, key_arr, sa, 1);
+	RTE_TEST_ASSERT((status == 1) && (sa[0] == &tmp),
+		"Lookup returns an unexpected result\n");
+
+	rte_ipsec_sad_destroy(sad);
+
+	return TEST_SUCCESS;
+}
+
 static int32_t
 __test_add_invalid(int ipv6, union rte_ipsec_sad_key *tuple)
 {
@@ -881,6 +920,7 @@ static struct unit_test_suite ipsec_sad_tests = {
 		TEST_CASE(test_create_invalid),
 		TEST_CASE(test_find_existing),
 		TEST_CASE(test_multiple_create),
+		TEST_CASE(test_create_small),
 		TEST_CASE(test_add_invalid),
 		TEST_CASE(test_delete_invalid),
 		TEST_CASE(test_lookup_invalid),
@@ -14,7 +14,7 @@
 #include "sample_packet_forward.h"
 #include "test.h"
 
-#define NUM_STATS 4
+#define NUM_STATS 7
 #define LATENCY_NUM_PACKETS 10
 #define QUEUE_ID 0
 
@@ -26,6 +26,9 @@ static struct rte_metric_name lat_stats_strings[] = {
 	{"avg_latency_ns"},
 	{"max_latency_ns"},
 	{"jitter_ns"},
+	{"p50_latency_ns"},
+	{"p99_latency_ns"},
+	{"p999_latency_ns"},
 };
 
 /* Test case for latency init with metrics init */
@@ -134,6 +137,32 @@ static int test_latencystats_get(void)
 	return TEST_SUCCESS;
 }
 
+/* Test case to get the latency stats of a single Tx queue */
+static int test_latencystats_queue_get(void)
+{
+	struct rte_latencystats_queue stats;
+	int ret;
+
+	ret = rte_latencystats_queue_get(portid, QUEUE_ID, &stats);
+	TEST_ASSERT(ret == 0, "Test Failed to get queue latency stats");
+	TEST_ASSERT(stats.min_ns <= stats.p50_ns &&
+		    stats.p50_ns <= stats.p99_ns &&
+		    stats.p99_ns <= stats.p999_ns &&
+		    stats.p999_ns <= stats.max_ns,
+		    "Test Failed: latency percentiles are not ordered");
+
+	/* Failure Test: Invalid stats pointer */
+	ret = rte_latencystats_queue_get(portid, QUEUE_ID, NULL);
+	TEST_ASSERT(ret == -EINVAL, "Test Failed: NULL stats accepted");
+
+	/* Failure Test: Queue without latency stats */
+	ret = rte_latencystats_queue_get(portid, RTE_MAX_QUEUES_PER_PORT - 1,
+			&stats);
+	TEST_ASSERT(ret == -ENOENT, "Test Failed: unregistered queue accepted");
+
+	return TEST_SUCCESS;
+}
+
 static int test_latency_ring_setup(void)
 {
 	test_ring_setup(&ring, &portid);
@@ -204,7 +233,12 @@ unit_test_suite latencystats_testsuite = {
 		 */
 		TEST_CASE_ST(NULL, NULL, test_latencystats_get),
 
-		/* Test Case 5: To check uninit of latency test */
+		/* Test Case 5: To check whether the latency stats
+		 * of a single Tx queue are retrieved
+		 */
+		TEST_CASE_ST(NULL, NULL, test_latencystats_queue_get),
+
+		/* Test Case 6: To check uninit of latency test */
 		TEST_CASE_ST(NULL, NULL, test_latency_uninit),
 
 		TEST_CASES_END()
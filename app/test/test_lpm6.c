@@ -52,6 +52,7 @@ static int32_t test25(void);
 static int32_t test26(void);
 static int32_t test27(void);
 static int32_t test28(void);
+static int32_t test29(void);
 
 rte_lpm6_test tests6[] = {
 /* Test Cases */
@@ -84,6 +85,7 @@ rte_lpm6_test tests6[] = {
 	test26,
 	test27,
 	test28,
+	test29,
 };
 
 #define MAX_DEPTH                                                    128
@@ -1745,6 +1747,66 @@ test28(void)
 	return PASS;
 }
 
+/*
+ * Add a set of random routes with random depths.
+ * Lookup bursts of IP addresses of different sizes through the lookup_bulk
+ * function, so that both the batched and the remaining lookups are used.
+ * Checks that the next hops are the ones returned by the single lookup.
+ */
+int32_t
+test29(void)
+{
+	struct rte_lpm6 *lpm = NULL;
+	struct rte_lpm6_config config;
+	struct rte_ipv6_addr ip_batch[67];
+	int32_t next_hop_return[67];
+	uint32_t i, j, n, next_hop;
+	int32_t status = 0;
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = NUMBER_TBL8S;
+	config.flags = 0;
+
+	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	for (i = 0; i < NUM_ROUTE_ENTRIES; i++) {
+		status = rte_lpm6_add(lpm, &large_route_table[i].ip,
+				large_route_table[i].depth,
+				large_route_table[i].next_hop);
+		TEST_LPM_ASSERT(status == 0);
+	}
+
+	generate_large_ips_table(0);
+
+	for (i = 0; i < NUM_IPS_ENTRIES; i += n) {
+		n = RTE_MIN(i % RTE_DIM(ip_batch) + 1, NUM_IPS_ENTRIES - i);
+		for (j = 0; j < n; j++) {
+			ip_batch[j] = large_ips_table[i + j].ip;
+			/* a quarter of the addresses are random, mostly misses */
+			if ((i + j) % 4 == 0)
+				ip_batch[j].a[j % 4] ^= 0x80;
+		}
+
+		status = rte_lpm6_lookup_bulk_func(lpm, ip_batch,
+				next_hop_return, n);
+		TEST_LPM_ASSERT(status == 0);
+
+		for (j = 0; j < n; j++) {
+			status = rte_lpm6_lookup(lpm, &ip_batch[j], &next_hop);
+			if (status == 0)
+				TEST_LPM_ASSERT(next_hop_return[j] ==
+						(int32_t)next_hop);
+			else
+				TEST_LPM_ASSERT(next_hop_return[j] == -1);
+		}
+	}
+
+	rte_lpm6_free(lpm);
+
+	return PASS;
+}
+
 /*
  * Do all unit tests.
  */
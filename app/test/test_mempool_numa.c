@@ -0,0 +1,131 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 The DPDK contributors
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <errno.h>
+
+#include <rte_common.h>
+#include <rte_lcore.h>
+#include <rte_mempool.h>
+#include <rte_pmd_numa_mempool.h>
+
+#include "test.h"
+
+#define NUMA_MEMPOOL_SIZE 4095U
+#define NUMA_MEMPOOL_ELT_SIZE 256
+#define NUMA_MEMPOOL_BURST 32U
+
+static int
+test_mempool_numa(void)
+{
+	struct rte_pmd_numa_mempool_stats stats;
+	void *objs[NUMA_MEMPOOL_SIZE];
+	struct rte_mempool *mp;
+	unsigned int i, n, nb_sockets;
+	int socket_id, ret = TEST_FAILED;
+
+	mp = rte_mempool_create_empty("test_numa", NUMA_MEMPOOL_SIZE,
+		NUMA_MEMPOOL_ELT_SIZE, 0, 0, SOCKET_ID_ANY, 0);
+	if (mp == NULL) {
+		printf("cannot allocate mempool\n");
+		return TEST_FAILED;
+	}
+	if (rte_mempool_set_ops_byname(mp, "numa", NULL) < 0) {
+		printf("cannot set numa handler\n");
+		goto err;
+	}
+
+	/* spread the objects on all the sockets */
+	nb_sockets = rte_socket_count();
+	for (i = 0; i < nb_sockets; i++) {
+		socket_id = rte_socket_id_by_idx(i);
+		n = NUMA_MEMPOOL_SIZE / nb_sockets;
+		if (i == nb_sockets - 1)
+			n = mp->size - mp->populated_size;
+		if (rte_mempool_populate_socket(mp, socket_id, n) < 0) {
+			printf("cannot populate mempool on socket %d\n",
+				socket_id);
+			goto err;
+		}
+	}
+	if (mp->populated_size != NUMA_MEMPOOL_SIZE) {
+		printf("mempool is not fully populated\n");
+		goto err;
+	}
+	if (rte_mempool_populate_socket(mp, SOCKET_ID_ANY, 1) != -ENOSPC) {
+		printf("populated a full mempool\n");
+		goto err;
+	}
+	if (rte_mempool_avail_count(mp) != NUMA_MEMPOOL_SIZE) {
+		printf("wrong number of free objects\n");
+		goto err;
+	}
+
+	rte_pmd_numa_mempool_stats_reset(mp);
+
+	/* local objects first, then the ones of the other sockets */
+	for (n = 0; n < NUMA_MEMPOOL_SIZE; n += i) {
+		i = RTE_MIN(NUMA_MEMPOOL_BURST, NUMA_MEMPOOL_SIZE - n);
+		if (rte_mempool_get_bulk(mp, &objs[n], i) < 0) {
+			printf("cannot get objects\n");
+			goto err;
+		}
+	}
+	if (rte_mempool_get(mp, &objs[0]) == 0) {
+		printf("got an object from an empty mempool\n");
+		rte_mempool_put(mp, objs[0]);
+		goto err;
+	}
+	rte_mempool_put_bulk(mp, objs, NUMA_MEMPOOL_SIZE);
+
+	if (rte_pmd_numa_mempool_stats_get(mp, SOCKET_ID_ANY, &stats) < 0) {
+		printf("cannot get statistics\n");
+		goto err;
+	}
+	printf("alloc local %"PRIu64" remote %"PRIu64
+		", free local %"PRIu64" remote %"PRIu64"\n",
+		stats.local_alloc, stats.remote_alloc,
+		stats.local_free, stats.remote_free);
+
+	if (stats.local_alloc + stats.remote_alloc != NUMA_MEMPOOL_SIZE ||
+			stats.local_free + stats.remote_free !=
+				NUMA_MEMPOOL_SIZE) {
+		printf("wrong allocation statistics\n");
+		goto err;
+	}
+	/* all the objects freed remotely wait in the return rings */
+	if (stats.return_count != stats.remote_free ||
+			stats.free_count + stats.return_count !=
+				NUMA_MEMPOOL_SIZE) {
+		printf("wrong ring statistics\n");
+		goto err;
+	}
+	if (nb_sockets == 1 && stats.remote_alloc != 0) {
+		printf("remote allocation with a single socket\n");
+		goto err;
+	}
+
+	/* the returned objects are taken back when the local ring is empty */
+	for (n = 0; n < NUMA_MEMPOOL_SIZE; n += i) {
+		i = RTE_MIN(NUMA_MEMPOOL_BURST, NUMA_MEMPOOL_SIZE - n);
+		if (rte_mempool_get_bulk(mp, &objs[n], i) < 0) {
+			printf("cannot get objects again\n");
+			goto err;
+		}
+	}
+	rte_mempool_put_bulk(mp, objs, NUMA_MEMPOOL_SIZE);
+	if (rte_mempool_avail_count(mp) != NUMA_MEMPOOL_SIZE) {
+		printf("objects were lost\n");
+		goto err;
+	}
+
+	ret = TEST_SUCCESS;
+err:
+	rte_mempool_free(mp);
+	return ret;
+}
+
+REGISTER_FAST_TEST(mempool_numa_autotest, false, true, test_mempool_numa);
@@ -2,6 +2,7 @@
  * Copyright (c) 2021 Microsoft Corporation
  */
 
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -29,6 +30,9 @@
 #define MAX_BURST	64
 #define MAX_GAP_US	100000
 #define DUMMY_MBUF_NUM	3
+#define RING_SIZE	8192
+#define RING_SNAPLEN	128
+#define DROP_BURST	16
 
 static struct rte_mempool *mp;
 static const uint32_t pkt_len = 200;
@@ -439,6 +443,145 @@ test_write_packets(void)
 	return -1;
 }
 
+/* Write packets through a small pcapng ring, so that blocks wrap around */
+static int
+fill_pcapng_ring(rte_pcapng_t *pcapng, struct rte_pcapng_ring *ring,
+		 unsigned int num_packets)
+{
+	struct dummy_mbuf mbfs;
+	struct rte_mbuf *pkts[MAX_BURST];
+	unsigned int burst_size, count, i;
+	uint32_t written = 0, n;
+	uint16_t copied;
+
+	mbuf1_prepare(&mbfs, pkt_len);
+	for (i = 0; i < MAX_BURST; i++)
+		pkts[i] = &mbfs.mb[0];
+
+	for (count = 0; count < num_packets; count += burst_size) {
+		burst_size = rte_rand_max(MAX_BURST) + 1;
+
+		/* the ring may not have room for the whole burst */
+		for (i = 0; i < burst_size; i += copied) {
+			copied = rte_pcapng_ring_copy(ring, port_id, 0, &pkts[i],
+						      burst_size - i, RING_SNAPLEN,
+						      RTE_PCAPNG_DIRECTION_IN);
+			if (rte_pcapng_write_ring(pcapng, ring, &n) < 0) {
+				fprintf(stderr, "Write of ring failed: %s\n",
+					rte_strerror(rte_errno));
+				return -1;
+			}
+			written += n;
+		}
+	}
+
+	if (written != count) {
+		fprintf(stderr, "Wrote %u packets, expected %u\n", written, count);
+		return -1;
+	}
+	return count;
+}
+
+/* Blocks of a port not added to the file are dropped, and do not stop the writer */
+static int
+drop_unknown_port(rte_pcapng_t *pcapng, struct rte_pcapng_ring *ring)
+{
+	struct dummy_mbuf mbfs;
+	struct rte_mbuf *pkts[DROP_BURST];
+	uint16_t copied = 0;
+	uint32_t n = 0;
+	unsigned int i;
+
+	mbuf1_prepare(&mbfs, pkt_len);
+	for (i = 0; i < DROP_BURST; i++)
+		pkts[i] = &mbfs.mb[0];
+
+	copied += rte_pcapng_ring_copy(ring, port_id + 1, 0, pkts, 2,
+				       RING_SNAPLEN, RTE_PCAPNG_DIRECTION_IN);
+	copied += rte_pcapng_ring_copy(ring, port_id, 0, pkts, DROP_BURST,
+				       RING_SNAPLEN, RTE_PCAPNG_DIRECTION_IN);
+	copied += rte_pcapng_ring_copy(ring, port_id + 1, 0, pkts, 1,
+				       RING_SNAPLEN, RTE_PCAPNG_DIRECTION_IN);
+	if (copied != DROP_BURST + 3) {
+		fprintf(stderr, "Copied %u packets, expected %u\n",
+			copied, DROP_BURST + 3);
+		return -1;
+	}
+
+	if (rte_pcapng_write_ring(pcapng, ring, &n) < 0) {
+		fprintf(stderr, "Write of ring failed: %s\n",
+			rte_strerror(rte_errno));
+		return -1;
+	}
+	if (n != DROP_BURST || rte_pcapng_ring_dropped(ring) != 3) {
+		fprintf(stderr, "Wrote %u packets and dropped %"PRIu64
+			", expected %u and 3\n",
+			n, rte_pcapng_ring_dropped(ring), DROP_BURST);
+		return -1;
+	}
+	return n;
+}
+
+static int
+test_write_ring(void)
+{
+	char file_name[] = "/tmp/pcapng_test_XXXXXX.pcapng";
+	static rte_pcapng_t *pcapng;
+	struct rte_pcapng_ring *ring;
+	int ret, tmp_fd, count;
+	uint64_t now = current_timestamp();
+
+	ring = rte_pcapng_ring_create("pcapng_test", RING_SIZE, SOCKET_ID_ANY);
+	if (ring == NULL) {
+		fprintf(stderr, "Cannot create pcapng ring\n");
+		return -1;
+	}
+
+	tmp_fd = mkstemps(file_name, strlen(".pcapng"));
+	if (tmp_fd == -1) {
+		perror("mkstemps() failure");
+		goto fail;
+	}
+	printf("pcapng: output file %s\n", file_name);
+
+	pcapng = rte_pcapng_fdopen(tmp_fd, NULL, NULL, "pcapng_ring", NULL);
+	if (pcapng == NULL) {
+		fprintf(stderr, "rte_pcapng_fdopen failed\n");
+		close(tmp_fd);
+		goto fail;
+	}
+
+	ret = rte_pcapng_add_interface(pcapng, port_id, NULL, NULL, NULL);
+	if (ret < 0) {
+		fprintf(stderr, "can not add port %u\n", port_id);
+		goto fail;
+	}
+
+	count = fill_pcapng_ring(pcapng, ring, TOTAL_PACKETS);
+	if (count < 0)
+		goto fail;
+
+	ret = drop_unknown_port(pcapng, ring);
+	if (ret < 0)
+		goto fail;
+	count += ret;
+
+	rte_pcapng_close(pcapng);
+	rte_pcapng_ring_free(ring);
+
+	ret = valid_pcapng_file(file_name, now, count);
+	/* if test fails want to investigate the file */
+	if (ret == 0)
+		unlink(file_name);
+
+	return ret;
+
+fail:
+	rte_pcapng_close(pcapng);
+	rte_pcapng_ring_free(ring);
+	return -1;
+}
+
 static void
 test_cleanup(void)
 {
@@ -454,6 +597,7 @@ unit_test_suite test_pcapng_suite  = {
 	.unit_test_cases = {
 		TEST_CASE(test_add_interface),
 		TEST_CASE(test_write_packets),
+		TEST_CASE(test_write_ring),
 		TEST_CASES_END()
 	}
 };
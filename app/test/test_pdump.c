@@ -5,6 +5,7 @@
 #include <unistd.h>
 #include <stdint.h>
 #include <limits.h>
+#include <inttypes.h>
 
 #include <ethdev_driver.h>
 #include <rte_pdump.h>
@@ -20,6 +21,9 @@
 
 #define launch_p(ARGV) process_dup(ARGV, RTE_DIM(ARGV), __func__)
 
+#define SAMPLE_RATE 4
+#define PKT_BUDGET 32
+
 struct rte_ring *ring_server;
 uint16_t portid;
 uint16_t flag_for_send_pkts = 1;
@@ -43,6 +47,111 @@ test_pdump_init(void)
 	return ret;
 }
 
+/* Free the packets captured in the ring, return how many there were. */
+static unsigned int
+drain_ring(struct rte_ring *ring)
+{
+	struct rte_mbuf *pkts[NUM_PACKETS];
+	unsigned int n, total = 0;
+
+	while ((n = rte_ring_dequeue_burst(ring, (void **)pkts,
+					   RTE_DIM(pkts), NULL)) != 0) {
+		rte_pktmbuf_free_bulk(pkts, n);
+		total += n;
+	}
+	return total;
+}
+
+/*
+ * Capture the Rx traffic forwarded by the primary with sampling and
+ * a packet budget, and check the captured and skipped counts.
+ */
+static int
+test_pdump_sampling(struct rte_ring *ring_client, struct rte_mempool *mp)
+{
+	struct rte_pdump_param param = { 0 };
+	struct rte_pdump_stats before, after;
+	uint64_t accepted, skipped, nombuf, ringfull, taken;
+	unsigned int captured;
+	int ret;
+
+	/* leftovers of the enable/disable tests */
+	drain_ring(ring_client);
+
+	ret = rte_pdump_stats(portid, &before);
+	if (ret < 0) {
+		printf("rte_pdump_stats failed\n");
+		return -1;
+	}
+
+	param.sample_rate = SAMPLE_RATE;
+	param.pkt_budget = PKT_BUDGET;
+	param.ring = ring_client;
+	param.mp = mp;
+
+	ret = rte_pdump_enable_ext(portid, QUEUE_ID, RTE_PDUMP_FLAG_RX, &param);
+	if (ret < 0) {
+		printf("rte_pdump_enable_ext failed\n");
+		return -1;
+	}
+
+	/* well within the one second budget period */
+	usleep(100 * 1000);
+
+	ret = rte_pdump_disable(portid, QUEUE_ID, RTE_PDUMP_FLAG_RX);
+	if (ret < 0) {
+		printf("rte_pdump_disable failed\n");
+		return -1;
+	}
+
+	captured = drain_ring(ring_client);
+
+	ret = rte_pdump_stats(portid, &after);
+	if (ret < 0) {
+		printf("rte_pdump_stats failed\n");
+		return -1;
+	}
+
+	accepted = after.accepted - before.accepted;
+	skipped = after.skipped - before.skipped;
+	nombuf = after.nombuf - before.nombuf;
+	ringfull = after.ringfull - before.ringfull;
+	taken = accepted + nombuf;
+
+	printf("sampling: accepted %"PRIu64" skipped %"PRIu64
+	       " captured %u\n", accepted, skipped, captured);
+
+	if (accepted == 0) {
+		printf("No packet captured\n");
+		return -1;
+	}
+	if (taken > PKT_BUDGET) {
+		printf("%"PRIu64" packets taken over a budget of %u\n",
+		       taken, PKT_BUDGET);
+		return -1;
+	}
+	/* at most one packet out of SAMPLE_RATE is kept */
+	if (skipped < (SAMPLE_RATE - 1) * taken) {
+		printf("%"PRIu64" packets skipped for %"PRIu64" taken\n",
+		       skipped, taken);
+		return -1;
+	}
+	/* once the budget is spent, the sampled packets are skipped too */
+	if (taken + skipped > SAMPLE_RATE * (PKT_BUDGET + 1) &&
+	    taken != PKT_BUDGET) {
+		printf("%"PRIu64" packets taken of %"PRIu64" seen, budget %u\n",
+		       taken, taken + skipped, PKT_BUDGET);
+		return -1;
+	}
+	if (captured != accepted - ringfull) {
+		printf("%u packets captured instead of %"PRIu64"\n",
+		       captured, accepted - ringfull);
+		return -1;
+	}
+	printf("pdump sampling success\n");
+	return 0;
+}
+
 int
 run_pdump_client_tests(void)
 {
@@ -50,6 +159,7 @@ run_pdump_client_tests(void)
 	char deviceid[] = "net_ring_net_ringa";
 	struct rte_ring *ring_client;
 	struct rte_mempool *mp = NULL;
+	struct rte_pdump_param param = { 0 };
 	struct rte_eth_dev *eth_dev = NULL;
 	char poolname[] = "mbuf_pool_client";
 
@@ -70,6 +180,12 @@ run_pdump_client_tests(void)
 	}
 	rte_eth_dev_probing_finish(eth_dev);
 
+	param.sample_rate = 4;
+	param.pkt_budget = 1000;
+	param.byte_budget = 64 * 1024;
+	param.ring = ring_client;
+	param.mp = mp;
+
 	printf("\n***** flags = RTE_PDUMP_FLAG_TX *****\n");
 
 	for (itr = 0; itr < NUM_ITR; itr++) {
@@ -103,6 +219,20 @@ run_pdump_client_tests(void)
 		}
 		printf("pdump_disable_by_deviceid success\n");
 
+		ret = rte_pdump_enable_ext(portid, QUEUE_ID, flags, &param);
+		if (ret < 0) {
+			printf("rte_pdump_enable_ext failed\n");
+			return -1;
+		}
+		printf("pdump_enable_ext success\n");
+
+		ret = rte_pdump_disable(portid, QUEUE_ID, flags);
+		if (ret < 0) {
+			printf("rte_pdump_disable failed\n");
+			return -1;
+		}
+		printf("pdump_disable success\n");
+
 		if (itr == 0) {
 			flags = RTE_PDUMP_FLAG_RX;
 			printf("\n***** flags = RTE_PDUMP_FLAG_RX *****\n");
@@ -111,6 +241,9 @@ run_pdump_client_tests(void)
 			printf("\n***** flags = RTE_PDUMP_FLAG_RXTX *****\n");
 		}
 	}
+
+	ret = test_pdump_sampling(ring_client, mp);
+
 	if (ring_client != NULL)
 		test_ring_free(ring_client);
 	if (mp != NULL)
@@ -0,0 +1,576 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 The DPDK contributors
+ */
+
+#include "test.h"
+
+#include <inttypes.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef RTE_EXEC_ENV_WINDOWS
+static int
+test_pmd_pcap(void)
+{
+	printf("pcap PMD mapped files not tested on Windows, skipping test\n");
+	return TEST_SKIPPED;
+}
+
+#else
+
+#include <unistd.h>
+
+#include <rte_bus_vdev.h>
+#include <rte_byteorder.h>
+#include <rte_cycles.h>
+#include <rte_ethdev.h>
+#include <rte_mbuf.h>
+#include <rte_mbuf_dyn.h>
+
+#define PCAP_VDEV_NAME "net_pcap_mmap"
+#define PCAP_NB_MBUFS 512
+#define PCAP_MAX_PKTS 16
+#define PCAP_FILE_SIZE 2048
+#define PCAP_TS_SEC UINT64_C(1700000000)
+
+/* Packet expected from a file */
+struct pcap_test_pkt {
+	uint32_t seq;   /* payload pattern */
+	uint32_t len;
+	uint64_t ts_us;
+};
+
+/* File built in memory, in the byte order of the host or swapped */
+struct pcap_test_file {
+	uint8_t data[PCAP_FILE_SIZE];
+	size_t len;
+	int swap;
+};
+
+static char file_name[] = "/tmp/pcap_mmap_XXXXXX.pcap";
+static struct rte_mempool *mp;
+static int ts_offset = -1;
+
+static void
+put(struct pcap_test_file *f, const void *p, size_t n)
+{
+	memcpy(&f->data[f->len], p, n);
+	f->len += n;
+}
+
+static void
+put16(struct pcap_test_file *f, uint16_t v)
+{
+	if (f->swap)
+		v = rte_bswap16(v);
+	put(f, &v, sizeof(v));
+}
+
+static void
+put32(struct pcap_test_file *f, uint32_t v)
+{
+	if (f->swap)
+		v = rte_bswap32(v);
+	put(f, &v, sizeof(v));
+}
+
+static uint8_t
+pkt_byte(uint32_t seq, uint32_t i)
+{
+	return (uint8_t)(seq * 31 + i);
+}
+
+/* Packet data, padded to 32 bits if needed */
+static void
+put_pkt(struct pcap_test_file *f, uint32_t seq, uint32_t len, int pad)
+{
+	uint32_t i;
+
+	for (i = 0; i < len; i++)
+		f->data[f->len++] = pkt_byte(seq, i);
+	if (pad)
+		while (f->len % 4 != 0)
+			f->data[f->len++] = 0;
+}
+
+static void
+pcap_hdr(struct pcap_test_file *f, uint32_t magic)
+{
+	put32(f, magic);
+	put16(f, 2);
+	put16(f, 4);
+	put32(f, 0);
+	put32(f, 0);
+	put32(f, 65535);
+	put32(f, 1); /* Ethernet */
+}
+
+static void
+pcap_rec(struct pcap_test_file *f, uint32_t seq, uint32_t len,
+	 uint32_t sec, uint32_t frac)
+{
+	put32(f, sec);
+	put32(f, frac);
+	put32(f, len);
+	put32(f, len);
+	put_pkt(f, seq, len, 0);
+}
+
+static void
+pcapng_shb(struct pcap_test_file *f)
+{
+	put32(f, 0x0a0d0d0a);
+	put32(f, 28);
+	put32(f, 0x1a2b3c4d);
+	put16(f, 1);
+	put16(f, 0);
+	put32(f, UINT32_MAX); /* unknown section length */
+	put32(f, UINT32_MAX);
+	put32(f, 28);
+}
+
+/* Interface with the default resolution of 1 us, or 10^-resol seconds */
+static void
+pcapng_idb(struct pcap_test_file *f, int resol)
+{
+	uint32_t blen = resol < 0 ? 20 : 32;
+
+	put32(f, 1);
+	put32(f, blen);
+	put16(f, 1); /* Ethernet */
+	put16(f, 0);
+	put32(f, 0); /* no snaplen */
+	if (resol >= 0) {
+		put16(f, 9); /* if_tsresol */
+		put16(f, 1);
+		put32(f, 0);
+		f->data[f->len - 4] = resol;
+		put32(f, 0); /* end of options */
+	}
+	put32(f, blen);
+}
+
+static void
+pcapng_epb(struct pcap_test_file *f, uint32_t id, uint32_t seq,
+	   uint32_t len, uint64_t ts)
+{
+	uint32_t blen = 32 + RTE_ALIGN(len, 4);
+
+	put32(f, 6);
+	put32(f, blen);
+	put32(f, id);
+	put32(f, ts >> 32);
+	put32(f, (uint32_t)ts);
+	put32(f, len);
+	put32(f, len);
+	put_pkt(f, seq, len, 1);
+	put32(f, blen);
+}
+
+static void
+pcapng_spb(struct pcap_test_file *f, uint32_t seq, uint32_t len)
+{
+	uint32_t blen = 16 + RTE_ALIGN(len, 4);
+
+	put32(f, 3);
+	put32(f, blen);
+	put32(f, len);
+	put_pkt(f, seq, len, 1);
+	put32(f, blen);
+}
+
+static int
+write_file(const struct pcap_test_file *f)
+{
+	int fd;
+
+	strcpy(file_name, "/tmp/pcap_mmap_XXXXXX.pcap");
+	fd = mkstemps(file_name, strlen(".pcap"));
+	if (fd < 0) {
+		printf("Line %i: Cannot create temporary file\n", __LINE__);
+		return -1;
+	}
+	if (write(fd, f->data, f->len) != (ssize_t)f->len) {
+		printf("Line %i: Cannot write %s\n", __LINE__, file_name);
+		close(fd);
+		unlink(file_name);
+		return -1;
+	}
+	close(fd);
+	return 0;
+}
+
+static int
+port_open(const char *extra_args, uint16_t *port)
+{
+	struct rte_eth_conf conf;
+	char args[128];
+
+	snprintf(args, sizeof(args), "rx_pcap=%s,rx_mmap=1%s",
+		 file_name, extra_args);
+	if (rte_vdev_init(PCAP_VDEV_NAME, args) != 0) {
+		printf("Line %i: Cannot create pcap device %s\n",
+			__LINE__, args);
+		return -1;
+	}
+
+	memset(&conf, 0, sizeof(conf));
+	if (rte_eth_dev_get_port_by_name(PCAP_VDEV_NAME, port) != 0 ||
+			rte_eth_dev_configure(*port, 1, 1, &conf) != 0 ||
+			rte_eth_rx_queue_setup(*port, 0, 0, SOCKET_ID_ANY,
+				NULL, mp) != 0 ||
+			rte_eth_tx_queue_setup(*port, 0, 0, SOCKET_ID_ANY,
+				NULL) != 0 ||
+			rte_eth_dev_start(*port) != 0) {
+		printf("Line %i: Cannot start pcap port\n", __LINE__);
+		rte_vdev_uninit(PCAP_VDEV_NAME);
+		return -1;
+	}
+
+	/* registered by the driver */
+	ts_offset = rte_mbuf_dynfield_lookup(RTE_MBUF_DYNFIELD_TIMESTAMP_NAME,
+					     NULL);
+	if (ts_offset < 0) {
+		printf("Line %i: No Rx timestamp field\n", __LINE__);
+		rte_vdev_uninit(PCAP_VDEV_NAME);
+		return -1;
+	}
+	return 0;
+}
+
+static int
+check_pkt(struct rte_mbuf *m, const struct pcap_test_pkt *e)
+{
+	uint8_t buf[RTE_MBUF_DEFAULT_DATAROOM];
+	const uint8_t *data;
+	uint64_t ts;
+	uint32_t i;
+
+	if (rte_pktmbuf_pkt_len(m) != e->len) {
+		printf("Line %i: Packet %u of %u bytes instead of %u\n",
+			__LINE__, e->seq, rte_pktmbuf_pkt_len(m), e->len);
+		return -1;
+	}
+	data = rte_pktmbuf_read(m, 0, e->len, buf);
+	for (i = 0; i < e->len; i++) {
+		if (data[i] != pkt_byte(e->seq, i)) {
+			printf("Line %i: Packet %u corrupted at byte %u\n",
+				__LINE__, e->seq, i);
+			return -1;
+		}
+	}
+	ts = *RTE_MBUF_DYNFIELD(m, ts_offset, rte_mbuf_timestamp_t *);
+	if (ts != e->ts_us) {
+		printf("Line %i: Packet %u timestamp %"PRIu64" instead of %"PRIu64"\n",
+			__LINE__, e->seq, ts, e->ts_us);
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * Receive the packets of the file, up to nb_rx of them,
+ * and compare them to the expected ones, in a loop.
+ * Return the number of packets received, or -1 on mismatch.
+ */
+static int
+receive(uint16_t port, const struct pcap_test_pkt *exp, unsigned int nb_exp,
+	unsigned int nb_rx, struct rte_mbuf **held)
+{
+	struct rte_mbuf *pkts[PCAP_MAX_PKTS];
+	unsigned int i, count = 0;
+	uint16_t n;
+	int ret = 0;
+
+	do {
+		/* small bursts, so that the file is read in several calls */
+		n = rte_eth_rx_burst(port, 0, pkts,
+				     RTE_MIN(nb_rx - count, 2u));
+		for (i = 0; i < n; i++) {
+			if (ret == 0 &&
+					check_pkt(pkts[i], &exp[count % nb_exp]) != 0)
+				ret = -1;
+			if (held != NULL)
+				held[count] = pkts[i];
+			else
+				rte_pktmbuf_free(pkts[i]);
+			count++;
+		}
+	} while (n > 0 && count < nb_rx);
+
+	return ret < 0 ? -1 : (int)count;
+}
+
+/* Receive a whole file, which stops at a malformed block */
+static int
+test_file(const struct pcap_test_file *f, const struct pcap_test_pkt *exp,
+	  unsigned int nb_exp, uint64_t nb_errors)
+{
+	struct rte_eth_stats stats;
+	uint16_t port;
+	int ret = TEST_FAILED, n;
+
+	if (write_file(f) != 0)
+		return TEST_FAILED;
+	if (port_open("", &port) != 0)
+		goto out;
+
+	n = receive(port, exp, nb_exp, PCAP_MAX_PKTS, NULL);
+	if (n != (int)nb_exp) {
+		printf("Line %i: %d packets received instead of %u\n",
+			__LINE__, n, nb_exp);
+		goto close;
+	}
+	/* nothing more is read after the malformed block */
+	n = receive(port, exp, nb_exp, PCAP_MAX_PKTS, NULL);
+	if (n != 0) {
+		printf("Line %i: %d packets received after the end\n",
+			__LINE__, n);
+		goto close;
+	}
+	if (rte_eth_stats_get(port, &stats) != 0 ||
+			stats.ipackets != nb_exp || stats.ierrors != nb_errors) {
+		printf("Line %i: %"PRIu64" packets and %"PRIu64" errors\n",
+			__LINE__, stats.ipackets, stats.ierrors);
+		goto close;
+	}
+	ret = TEST_SUCCESS;
+close:
+	rte_vdev_uninit(PCAP_VDEV_NAME);
+out:
+	unlink(file_name);
+	return ret;
+}
+
+/* pcap file in microseconds, ending with a truncated record */
+static int
+test_pcap_mmap_pcap(void)
+{
+	static const struct pcap_test_pkt exp[] = {
+		{ 0, 60, PCAP_TS_SEC * US_PER_S + 1 },
+		{ 1, 61, PCAP_TS_SEC * US_PER_S + 2 },
+		{ 2, 1514, (PCAP_TS_SEC + 1) * US_PER_S },
+	};
+	struct pcap_test_file f = { .len = 0 };
+
+	pcap_hdr(&f, 0xa1b2c3d4);
+	pcap_rec(&f, 0, 60, PCAP_TS_SEC, 1);
+	pcap_rec(&f, 1, 61, PCAP_TS_SEC, 2);
+	pcap_rec(&f, 2, 1514, PCAP_TS_SEC + 1, 0);
+	/* record header announcing more data than the file has */
+	put32(&f, PCAP_TS_SEC);
+	put32(&f, 3);
+	put32(&f, 100);
+	put32(&f, 100);
+	put_pkt(&f, 3, 10, 0);
+
+	return test_file(&f, exp, RTE_DIM(exp), 1);
+}
+
+/*
+ * pcapng file in host order, with interfaces of different timestamp
+ * resolutions, ending with a simple packet block shorter than its header
+ */
+static int
+test_pcap_mmap_pcapng(void)
+{
+	static const struct pcap_test_pkt exp[] = {
+		{ 0, 60, PCAP_TS_SEC * US_PER_S + 5 },
+		{ 1, 63, PCAP_TS_SEC * US_PER_S + 7000 },
+		/* without timestamp, the one of the previous packet */
+		{ 2, 65, PCAP_TS_SEC * US_PER_S + 7000 },
+	};
+	struct pcap_test_file f = { .len = 0 };
+
+	pcapng_shb(&f);
+	pcapng_idb(&f, -1);
+	pcapng_idb(&f, 3);
+	pcapng_epb(&f, 0, 0, 60, PCAP_TS_SEC * US_PER_S + 5);
+	pcapng_epb(&f, 1, 1, 63, PCAP_TS_SEC * MS_PER_S + 7);
+	pcapng_spb(&f, 2, 65);
+	put32(&f, 3);
+	put32(&f, 12);
+	put32(&f, 12);
+
+	return test_file(&f, exp, RTE_DIM(exp), 1);
+}
+
+/*
+ * pcapng file in the other byte order, in nanoseconds,
+ * ending with a packet block too short for its captured length
+ */
+static int
+test_pcap_mmap_pcapng_swapped(void)
+{
+	static const struct pcap_test_pkt exp[] = {
+		{ 0, 64, PCAP_TS_SEC * US_PER_S + 123456 },
+		{ 1, 99, PCAP_TS_SEC * US_PER_S + 123457 },
+	};
+	struct pcap_test_file f = { .len = 0, .swap = 1 };
+
+	pcapng_shb(&f);
+	pcapng_idb(&f, 9);
+	pcapng_epb(&f, 0, 0, 64, PCAP_TS_SEC * NS_PER_S + 123456789);
+	pcapng_epb(&f, 0, 1, 99, PCAP_TS_SEC * NS_PER_S + 123457000);
+	put32(&f, 6);
+	put32(&f, 36);
+	put32(&f, 0);
+	put32(&f, 0);
+	put32(&f, 0);
+	put32(&f, 8); /* captured length beyond the block */
+	put32(&f, 8);
+	put_pkt(&f, 2, 4, 1);
+	put32(&f, 36);
+
+	return test_file(&f, exp, RTE_DIM(exp), 1);
+}
+
+/* The file is replayed in place when its end is reached */
+static int
+test_pcap_mmap_infinite(void)
+{
+	static const struct pcap_test_pkt exp[] = {
+		{ 0, 60, PCAP_TS_SEC * US_PER_S },
+		{ 1, 70, PCAP_TS_SEC * US_PER_S + 1 },
+		{ 2, 80, PCAP_TS_SEC * US_PER_S + 2 },
+	};
+	struct pcap_test_file f = { .len = 0 };
+	unsigned int nb_rx = 3 * RTE_DIM(exp) + 1;
+	uint16_t port;
+	int ret = TEST_FAILED, n;
+
+	pcap_hdr(&f, 0xa1b23c4d);
+	pcap_rec(&f, 0, 60, PCAP_TS_SEC, 0);
+	pcap_rec(&f, 1, 70, PCAP_TS_SEC, 1000);
+	pcap_rec(&f, 2, 80, PCAP_TS_SEC, 2000);
+
+	if (write_file(&f) != 0)
+		return TEST_FAILED;
+	if (port_open(",infinite_rx=1", &port) != 0)
+		goto out;
+
+	n = receive(port, exp, RTE_DIM(exp), nb_rx, NULL);
+	if (n != (int)nb_rx) {
+		printf("Line %i: %d packets received instead of %u\n",
+			__LINE__, n, nb_rx);
+		goto close;
+	}
+	ret = TEST_SUCCESS;
+close:
+	rte_vdev_uninit(PCAP_VDEV_NAME);
+out:
+	unlink(file_name);
+	return ret;
+}
+
+/* Check whether the file is mapped in the process */
+static int
+file_mapped(void)
+{
+	char line[PATH_MAX + 128];
+	int found = 0;
+	FILE *maps;
+
+	maps = fopen("/proc/self/maps", "r");
+	if (maps == NULL)
+		return -1;
+	while (!found && fgets(line, sizeof(line), maps) != NULL)
+		found = strstr(line, file_name) != NULL;
+	fclose(maps);
+	return found;
+}
+
+/* The file stays mapped after close, until the mbufs are freed */
+static int
+test_pcap_mmap_close(void)
+{
+	static const struct pcap_test_pkt exp[] = {
+		{ 0, 60, PCAP_TS_SEC * US_PER_S },
+		{ 1, 61, PCAP_TS_SEC * US_PER_S + 1 },
+	};
+	struct pcap_test_file f = { .len = 0 };
+	struct rte_mbuf *held[PCAP_MAX_PKTS] = { NULL };
+	uint16_t port;
+	int ret = TEST_FAILED, n;
+
+	pcap_hdr(&f, 0xa1b2c3d4);
+	pcap_rec(&f, 0, 60, PCAP_TS_SEC, 0);
+	pcap_rec(&f, 1, 61, PCAP_TS_SEC, 1);
+
+	if (write_file(&f) != 0)
+		return TEST_FAILED;
+	if (port_open("", &port) != 0)
+		goto out;
+
+	n = receive(port, exp, RTE_DIM(exp), PCAP_MAX_PKTS, held);
+	rte_vdev_uninit(PCAP_VDEV_NAME);
+	if (n != (int)RTE_DIM(exp)) {
+		printf("Line %i: %d packets received instead of %zu\n",
+			__LINE__, n, RTE_DIM(exp));
+		rte_pktmbuf_free_bulk(held, RTE_DIM(held));
+		goto out;
+	}
+
+	/* the packets are still readable after close */
+	if (file_mapped() != 1 || check_pkt(held[1], &exp[1]) != 0) {
+		printf("Line %i: File unmapped before the mbufs are freed\n",
+			__LINE__);
+		rte_pktmbuf_free_bulk(held, n);
+		goto out;
+	}
+	rte_pktmbuf_free_bulk(held, n);
+	if (file_mapped() != 0) {
+		printf("Line %i: File still mapped after the mbufs are freed\n",
+			__LINE__);
+		goto out;
+	}
+	ret = TEST_SUCCESS;
+out:
+	unlink(file_name);
+	return ret;
+}
+
+static int
+test_setup(void)
+{
+	mp = rte_pktmbuf_pool_create("pcap_mmap_pool", PCAP_NB_MBUFS, 0, 0,
+		RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+	if (mp == NULL) {
+		printf("Line %i: Cannot create mbuf pool\n", __LINE__);
+		return TEST_FAILED;
+	}
+	return TEST_SUCCESS;
+}
+
+static void
+test_teardown(void)
+{
+	rte_mempool_free(mp);
+	mp = NULL;
+}
+
+static struct unit_test_suite test_pmd_pcap_suite = {
+	.suite_name = "pcap PMD mapped file unit test suite",
+	.setup = test_setup,
+	.teardown = test_teardown,
+	.unit_test_cases = {
+		TEST_CASE(test_pcap_mmap_pcap),
+		TEST_CASE(test_pcap_mmap_pcapng),
+		TEST_CASE(test_pcap_mmap_pcapng_swapped),
+		TEST_CASE(test_pcap_mmap_infinite),
+		TEST_CASE(test_pcap_mmap_close),
+		TEST_CASES_END()
+	}
+};
+
+static int
+test_pmd_pcap(void)
+{
+	return unit_test_suite_runner(&test_pmd_pcap_suite);
+}
+
+#endif /* !RTE_EXEC_ENV_WINDOWS */
+
+REGISTER_FAST_TEST(pcap_pmd_autotest, true, true, test_pmd_pcap);
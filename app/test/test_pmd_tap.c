@@ -0,0 +1,446 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 The DPDK contributors
+ */
+
+#include "test.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <linux/ethtool.h>
+#include <linux/if_packet.h>
+#include <linux/sockios.h>
+
+#include <rte_bus_vdev.h>
+#include <rte_cycles.h>
+#include <rte_ethdev.h>
+#include <rte_mbuf.h>
+#include <rte_string_fns.h>
+
+#define TAP_VDEV_NAME "net_tap_vnet"
+#define TAP_IFACE_NAME "dtap_vnet"
+
+/* Read an offload feature of the kernel side of the tap interface. */
+static int
+tap_kernel_feature(uint32_t cmd)
+{
+	struct ethtool_value ev = { .cmd = cmd };
+	struct ifreq ifr;
+	int fd, ret;
+
+	fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (fd < 0)
+		return -1;
+
+	memset(&ifr, 0, sizeof(ifr));
+	strlcpy(ifr.ifr_name, TAP_IFACE_NAME, sizeof(ifr.ifr_name));
+	ifr.ifr_data = (void *)&ev;
+	ret = ioctl(fd, SIOCETHTOOL, &ifr);
+	close(fd);
+
+	return ret < 0 ? -1 : (int)ev.data;
+}
+
+static int
+tap_configure(uint16_t port, uint64_t rx_offloads, uint64_t tx_offloads)
+{
+	struct rte_eth_conf conf;
+
+	memset(&conf, 0, sizeof(conf));
+	conf.rxmode.offloads = rx_offloads;
+	conf.txmode.offloads = tx_offloads;
+
+	return rte_eth_dev_configure(port, 1, 1, &conf);
+}
+
+static int
+tap_check_kernel_offloads(uint16_t port, uint64_t rx_offloads,
+	int csum, int tso)
+{
+	int ret;
+
+	ret = tap_configure(port, rx_offloads, 0);
+	if (ret != 0) {
+		printf("Line %i: Cannot configure Rx offloads %#"PRIx64": %d\n",
+			__LINE__, rx_offloads, ret);
+		return -1;
+	}
+	if (tap_kernel_feature(ETHTOOL_GTXCSUM) != csum ||
+			tap_kernel_feature(ETHTOOL_GTSO) != tso) {
+		printf("Line %i: Rx offloads %#"PRIx64" negotiated "
+			"checksum %d and TSO %d instead of %d and %d\n",
+			__LINE__, rx_offloads,
+			tap_kernel_feature(ETHTOOL_GTXCSUM),
+			tap_kernel_feature(ETHTOOL_GTSO), csum, tso);
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * Check that the Rx offloads are negotiated with the kernel
+ * through the virtio-net header of the tap queues.
+ */
+static int
+test_pmd_tap_vnet(uint16_t port)
+{
+	struct rte_eth_dev_info dev_info;
+	int ret;
+
+	ret = rte_eth_dev_info_get(port, &dev_info);
+	if (ret != 0) {
+		printf("Line %i: Cannot get device info: %d\n", __LINE__, ret);
+		return TEST_FAILED;
+	}
+	if (!(dev_info.rx_offload_capa & RTE_ETH_RX_OFFLOAD_TCP_LRO)) {
+		printf("No virtio-net header support in the kernel, skipping\n");
+		return TEST_SKIPPED;
+	}
+	if (!(dev_info.tx_offload_capa & RTE_ETH_TX_OFFLOAD_TCP_TSO)) {
+		printf("Line %i: TSO is not reported\n", __LINE__);
+		return TEST_FAILED;
+	}
+
+	/* coalesced packets do not fit a single mbuf */
+	ret = tap_configure(port, RTE_ETH_RX_OFFLOAD_TCP_LRO, 0);
+	if (ret != -EINVAL) {
+		printf("Line %i: LRO without scatter configured: %d\n",
+			__LINE__, ret);
+		return TEST_FAILED;
+	}
+
+	if (tap_check_kernel_offloads(port, RTE_ETH_RX_OFFLOAD_SCATTER |
+			RTE_ETH_RX_OFFLOAD_TCP_LRO, 1, 1) != 0)
+		return TEST_FAILED;
+	if (tap_check_kernel_offloads(port, 0, 0, 0) != 0)
+		return TEST_FAILED;
+	if (tap_check_kernel_offloads(port,
+			RTE_ETH_RX_OFFLOAD_TCP_CKSUM, 1, 0) != 0)
+		return TEST_FAILED;
+
+	/* the Tx offloads are carried per packet */
+	ret = tap_configure(port, 0, RTE_ETH_TX_OFFLOAD_TCP_TSO |
+		RTE_ETH_TX_OFFLOAD_TCP_CKSUM | RTE_ETH_TX_OFFLOAD_MULTI_SEGS);
+	if (ret != 0) {
+		printf("Line %i: Cannot configure Tx offloads: %d\n",
+			__LINE__, ret);
+		return TEST_FAILED;
+	}
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_pmd_tap_offloads(void)
+{
+	uint16_t port;
+	int ret;
+
+	if (rte_vdev_init(TAP_VDEV_NAME, "iface=" TAP_IFACE_NAME) != 0) {
+		printf("Cannot create tap device, skipping\n");
+		return TEST_SKIPPED;
+	}
+	if (rte_eth_dev_get_port_by_name(TAP_VDEV_NAME, &port) != 0) {
+		printf("Line %i: Cannot find tap port\n", __LINE__);
+		rte_vdev_uninit(TAP_VDEV_NAME);
+		return TEST_FAILED;
+	}
+
+	ret = test_pmd_tap_vnet(port);
+
+	rte_eth_dev_close(port);
+	rte_vdev_uninit(TAP_VDEV_NAME);
+
+	return ret;
+}
+
+#ifdef HAVE_LIBURING
+
+#define TAP_URING_VDEV_NAME "net_tap_uring"
+#define TAP_URING_IFACE_NAME "dtap_uring"
+#define TAP_URING_NB_MBUFS 2048
+#define TAP_URING_NB_DESC 512
+#define TAP_URING_NB_PKTS 32
+#define TAP_URING_PKT_LEN 128
+/* local experimental Ether type, not sent by the kernel on its own */
+#define TAP_URING_ETHER_TYPE 0x88b5
+
+/* Raw socket on the kernel side of the tap, for the test Ether type only */
+static int
+tap_uring_socket(void)
+{
+	struct timeval tv = { .tv_sec = 1 };
+	struct sockaddr_ll sll;
+	int fd;
+
+	fd = socket(AF_PACKET, SOCK_RAW, htons(TAP_URING_ETHER_TYPE));
+	if (fd < 0)
+		return -1;
+
+	memset(&sll, 0, sizeof(sll));
+	sll.sll_family = AF_PACKET;
+	sll.sll_protocol = htons(TAP_URING_ETHER_TYPE);
+	sll.sll_ifindex = if_nametoindex(TAP_URING_IFACE_NAME);
+	if (sll.sll_ifindex == 0 ||
+			bind(fd, (struct sockaddr *)&sll, sizeof(sll)) < 0 ||
+			setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) < 0) {
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+/* Broadcast frame of the test Ether type, with a payload depending on seq */
+static void
+tap_uring_frame(uint8_t *frame, uint32_t seq)
+{
+	struct rte_ether_hdr *eth = (struct rte_ether_hdr *)frame;
+	unsigned int i;
+
+	memset(&eth->dst_addr, 0xff, sizeof(eth->dst_addr));
+	memset(&eth->src_addr, 0, sizeof(eth->src_addr));
+	eth->src_addr.addr_bytes[0] = 0x02;
+	eth->ether_type = rte_cpu_to_be_16(TAP_URING_ETHER_TYPE);
+	for (i = sizeof(*eth); i < TAP_URING_PKT_LEN; i++)
+		frame[i] = (uint8_t)(seq + i);
+}
+
+static int
+tap_uring_frame_check(const uint8_t *frame, uint32_t len, uint32_t seq)
+{
+	uint8_t expected[TAP_URING_PKT_LEN];
+
+	tap_uring_frame(expected, seq);
+	if (len != TAP_URING_PKT_LEN || memcmp(frame, expected, len) != 0) {
+		printf("Line %i: packet %u of %u bytes is corrupted\n",
+			__LINE__, seq, len);
+		return -1;
+	}
+	return 0;
+}
+
+/* Allocate the test packets */
+static int
+tap_uring_alloc(struct rte_mempool *mp, struct rte_mbuf **pkts)
+{
+	unsigned int i;
+	char *data;
+
+	if (rte_pktmbuf_alloc_bulk(mp, pkts, TAP_URING_NB_PKTS) != 0) {
+		printf("Line %i: Cannot allocate packets\n", __LINE__);
+		return -1;
+	}
+	for (i = 0; i < TAP_URING_NB_PKTS; i++) {
+		data = rte_pktmbuf_append(pkts[i], TAP_URING_PKT_LEN);
+		if (data == NULL) {
+			printf("Line %i: No room for packet data\n", __LINE__);
+			rte_pktmbuf_free_bulk(pkts, TAP_URING_NB_PKTS);
+			return -1;
+		}
+		tap_uring_frame((uint8_t *)data, i);
+	}
+	return 0;
+}
+
+/* Write packets through io_uring, read them on the kernel side */
+static int
+tap_uring_tx(uint16_t port, struct rte_mempool *mp, int fd)
+{
+	struct rte_mbuf *pkts[TAP_URING_NB_PKTS];
+	uint8_t frame[TAP_URING_PKT_LEN + 1];
+	unsigned int i;
+	uint16_t sent;
+	ssize_t len;
+
+	if (tap_uring_alloc(mp, pkts) != 0)
+		return -1;
+
+	sent = rte_eth_tx_burst(port, 0, pkts, TAP_URING_NB_PKTS);
+	if (sent != TAP_URING_NB_PKTS) {
+		printf("Line %i: %u packets sent of %u\n",
+			__LINE__, sent, TAP_URING_NB_PKTS);
+		rte_pktmbuf_free_bulk(&pkts[sent], TAP_URING_NB_PKTS - sent);
+		return -1;
+	}
+
+	for (i = 0; i < TAP_URING_NB_PKTS; i++) {
+		len = recv(fd, frame, sizeof(frame), 0);
+		if (len < 0) {
+			printf("Line %i: Packet %u not received by the kernel\n",
+				__LINE__, i);
+			return -1;
+		}
+		if (tap_uring_frame_check(frame, len, i) != 0)
+			return -1;
+	}
+	return 0;
+}
+
+/* Write packets on the kernel side, receive them through io_uring */
+static int
+tap_uring_rx(uint16_t port, int fd)
+{
+	struct rte_mbuf *pkts[TAP_URING_NB_PKTS];
+	uint8_t frame[TAP_URING_PKT_LEN];
+	const struct rte_ether_hdr *eth;
+	unsigned int i, seq = 0, tries;
+	uint16_t n;
+	int ret = 0;
+
+	for (i = 0; i < TAP_URING_NB_PKTS; i++) {
+		tap_uring_frame(frame, i);
+		if (send(fd, frame, sizeof(frame), 0) != sizeof(frame)) {
+			printf("Line %i: Cannot send packet %u from the kernel\n",
+				__LINE__, i);
+			return -1;
+		}
+	}
+
+	for (tries = 0; seq < TAP_URING_NB_PKTS && tries < 1000; tries++) {
+		n = rte_eth_rx_burst(port, 0, pkts, RTE_DIM(pkts));
+		for (i = 0; i < n; i++) {
+			eth = rte_pktmbuf_mtod(pkts[i], const struct rte_ether_hdr *);
+			/* skip the packets sent by the kernel on its own */
+			if (ret == 0 && eth->ether_type ==
+					rte_cpu_to_be_16(TAP_URING_ETHER_TYPE)) {
+				if (pkts[i]->nb_segs != 1 ||
+						tap_uring_frame_check((const uint8_t *)eth,
+							rte_pktmbuf_pkt_len(pkts[i]),
+							seq) != 0)
+					ret = -1;
+				seq++;
+			}
+		}
+		rte_pktmbuf_free_bulk(pkts, n);
+		if (n == 0)
+			rte_delay_ms(1);
+	}
+	if (ret == 0 && seq != TAP_URING_NB_PKTS) {
+		printf("Line %i: %u packets received of %u\n",
+			__LINE__, seq, TAP_URING_NB_PKTS);
+		ret = -1;
+	}
+	return ret;
+}
+
+static int
+tap_uring_start(uint16_t port, struct rte_mempool *mp)
+{
+	struct rte_eth_conf conf;
+
+	memset(&conf, 0, sizeof(conf));
+	if (rte_eth_dev_configure(port, 1, 1, &conf) != 0 ||
+			rte_eth_rx_queue_setup(port, 0, TAP_URING_NB_DESC,
+				rte_eth_dev_socket_id(port), NULL, mp) != 0 ||
+			rte_eth_tx_queue_setup(port, 0, TAP_URING_NB_DESC,
+				rte_eth_dev_socket_id(port), NULL) != 0 ||
+			rte_eth_dev_start(port) != 0)
+		return -1;
+	return 0;
+}
+
+/* Exchange packets with the kernel through the io_uring datapath */
+static int
+test_pmd_tap_uring(void)
+{
+	struct rte_mbuf *pkts[TAP_URING_NB_PKTS];
+	struct rte_eth_stats stats;
+	struct rte_mempool *mp;
+	unsigned int i;
+	uint16_t port;
+	int fd = -1, ret = TEST_FAILED;
+
+	mp = rte_pktmbuf_pool_create("tap_uring_pool", TAP_URING_NB_MBUFS, 0, 0,
+		RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+	if (mp == NULL) {
+		printf("Line %i: Cannot create mbuf pool\n", __LINE__);
+		return TEST_FAILED;
+	}
+	if (rte_vdev_init(TAP_URING_VDEV_NAME,
+			"iface=" TAP_URING_IFACE_NAME ",io_uring") != 0) {
+		printf("Cannot create tap device, skipping\n");
+		rte_mempool_free(mp);
+		return TEST_SKIPPED;
+	}
+	if (rte_eth_dev_get_port_by_name(TAP_URING_VDEV_NAME, &port) != 0) {
+		printf("Line %i: Cannot find tap port\n", __LINE__);
+		goto out;
+	}
+	if (tap_uring_start(port, mp) != 0) {
+		printf("Line %i: Cannot start tap port\n", __LINE__);
+		goto out;
+	}
+
+	fd = tap_uring_socket();
+	if (fd < 0) {
+		printf("Line %i: Cannot open socket on %s: %s\n",
+			__LINE__, TAP_URING_IFACE_NAME, strerror(errno));
+		goto out;
+	}
+
+	if (tap_uring_tx(port, mp, fd) != 0 || tap_uring_rx(port, fd) != 0)
+		goto out;
+
+	if (rte_eth_stats_get(port, &stats) != 0 ||
+			stats.opackets != TAP_URING_NB_PKTS ||
+			stats.obytes != TAP_URING_NB_PKTS * TAP_URING_PKT_LEN ||
+			stats.oerrors != 0 ||
+			stats.ipackets < TAP_URING_NB_PKTS ||
+			stats.ierrors != 0) {
+		printf("Line %i: Unexpected stats: out %"PRIu64" packets %"PRIu64
+			" bytes %"PRIu64" errors, in %"PRIu64" packets %"PRIu64
+			" errors\n", __LINE__, stats.opackets, stats.obytes,
+			stats.oerrors, stats.ipackets, stats.ierrors);
+		goto out;
+	}
+
+	/* the queues are released while writes may still be in flight */
+	if (tap_uring_alloc(mp, pkts) != 0)
+		goto out;
+	i = rte_eth_tx_burst(port, 0, pkts, TAP_URING_NB_PKTS);
+	rte_pktmbuf_free_bulk(&pkts[i], TAP_URING_NB_PKTS - i);
+
+	ret = TEST_SUCCESS;
+out:
+	if (fd >= 0)
+		close(fd);
+	rte_vdev_uninit(TAP_URING_VDEV_NAME);
+
+	/* all the Rx buffers and written packets are back in the pool */
+	if (ret == TEST_SUCCESS &&
+			rte_mempool_avail_count(mp) != TAP_URING_NB_MBUFS) {
+		printf("Line %i: %u mbufs leaked\n", __LINE__,
+			TAP_URING_NB_MBUFS - rte_mempool_avail_count(mp));
+		ret = TEST_FAILED;
+	}
+	rte_mempool_free(mp);
+	return ret;
+}
+
+#endif /* HAVE_LIBURING */
+
+static struct unit_test_suite test_pmd_tap_suite = {
+	.suite_name = "tap PMD unit test suite",
+	.unit_test_cases = {
+		TEST_CASE(test_pmd_tap_offloads),
+#ifdef HAVE_LIBURING
+		TEST_CASE(test_pmd_tap_uring),
+#endif
+		TEST_CASES_END()
+	}
+};
+
+static int
+test_pmd_tap(void)
+{
+	return unit_test_suite_runner(&test_pmd_tap_suite);
+}
+
+REGISTER_FAST_TEST(tap_pmd_autotest, true, true, test_pmd_tap);
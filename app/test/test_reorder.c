@@ -14,6 +14,7 @@
 #include <rte_reorder.h>
 #include <rte_lcore.h>
 #include <rte_malloc.h>
+#include <rte_pause.h>
 
 #define BURST 32
 #define REORDER_BUFFER_SIZE 16384
@@ -485,6 +486,251 @@ test_reorder_set_seqn(void)
 	return ret;
 }
 
+static int
+test_reorder_concurrent(void)
+{
+	struct rte_mempool *p = test_params->p;
+	struct rte_reorder_buffer *b = NULL;
+	const unsigned int size = 4;
+	const unsigned int num_bufs = 7;
+	struct rte_mbuf *bufs[num_bufs];
+	struct rte_mbuf *robufs[num_bufs];
+	struct rte_mbuf *burst[3];
+	unsigned int i, cnt;
+	int ret = 0;
+
+	b = rte_reorder_create_ext("test_concurrent", rte_socket_id(), size,
+			RTE_REORDER_F_CONCURRENT | RTE_BIT32(31));
+	TEST_ASSERT((b == NULL) && (rte_errno == EINVAL),
+			"No error on create_ext() with invalid flags");
+
+	b = rte_reorder_create_ext("test_concurrent", rte_socket_id(), size,
+			RTE_REORDER_F_CONCURRENT);
+	TEST_ASSERT_NOT_NULL(b, "Failed to create reorder buffer");
+
+	for (i = 0; i < num_bufs; i++) {
+		bufs[i] = rte_pktmbuf_alloc(p);
+		TEST_ASSERT_NOT_NULL(bufs[i], "Packet allocation failed\n");
+		*rte_reorder_seqn(bufs[i]) = i;
+		robufs[i] = NULL;
+	}
+
+	/* OB[] = {0, 1, NULL, 3} */
+	burst[0] = bufs[3];
+	burst[1] = bufs[1];
+	burst[2] = bufs[0];
+	cnt = rte_reorder_insert_burst(b, burst, RTE_DIM(burst));
+	if (cnt != RTE_DIM(burst)) {
+		printf("%s:%d: burst insert returned %u\n", __func__, __LINE__,
+				cnt);
+		ret = -1;
+		goto exit;
+	}
+	bufs[0] = bufs[1] = bufs[3] = NULL;
+
+	/* the window cannot move past the missing packet 2 */
+	cnt = rte_reorder_drain(b, robufs, num_bufs);
+	if (cnt != 2 || *rte_reorder_seqn(robufs[0]) != 0 ||
+			*rte_reorder_seqn(robufs[1]) != 1) {
+		printf("%s:%d: unexpected drain of %u packets\n", __func__,
+				__LINE__, cnt);
+		ret = -1;
+		goto exit;
+	}
+	for (i = 0; i < cnt; i++) {
+		rte_pktmbuf_free(robufs[i]);
+		robufs[i] = NULL;
+	}
+
+	/* early packet, the window does not move */
+	ret = rte_reorder_insert(b, bufs[6]);
+	if (!((ret == -1) && (rte_errno == ENOSPC))) {
+		printf("%s:%d: No error inserting early packet\n", __func__,
+				__LINE__);
+		ret = -1;
+		goto exit;
+	}
+	cnt = rte_reorder_drain(b, robufs, num_bufs);
+	if (cnt != 0) {
+		printf("%s:%d: unexpected drain of %u packets\n", __func__,
+				__LINE__, cnt);
+		ret = -1;
+		goto exit;
+	}
+
+	/* skip packet 2: OB[] = {NULL, NULL, NULL, NULL}, window starts at 4 */
+	cnt = rte_reorder_drain_up_to_seqn(b, robufs, num_bufs, 4);
+	if (cnt != 1 || *rte_reorder_seqn(robufs[0]) != 3) {
+		printf("%s:%d: unexpected drain of %u packets\n", __func__,
+				__LINE__, cnt);
+		ret = -1;
+		goto exit;
+	}
+	rte_pktmbuf_free(robufs[0]);
+	robufs[0] = NULL;
+
+	/* late packet */
+	ret = rte_reorder_insert(b, bufs[2]);
+	if (!((ret == -1) && (rte_errno == ERANGE))) {
+		printf("%s:%d: No error inserting late packet\n", __func__,
+				__LINE__);
+		ret = -1;
+		goto exit;
+	}
+
+	/* OB[] = {4, 5, 6, NULL} */
+	burst[0] = bufs[6];
+	burst[1] = bufs[5];
+	burst[2] = bufs[4];
+	cnt = rte_reorder_insert_burst(b, burst, RTE_DIM(burst));
+	if (cnt != RTE_DIM(burst)) {
+		printf("%s:%d: burst insert returned %u\n", __func__, __LINE__,
+				cnt);
+		ret = -1;
+		goto exit;
+	}
+	bufs[4] = bufs[5] = bufs[6] = NULL;
+
+	cnt = rte_reorder_drain(b, robufs, num_bufs);
+	if (cnt != 3) {
+		printf("%s:%d: unexpected drain of %u packets\n", __func__,
+				__LINE__, cnt);
+		ret = -1;
+		goto exit;
+	}
+	for (i = 0; i < cnt; i++) {
+		if (*rte_reorder_seqn(robufs[i]) != 4 + i) {
+			printf("%s:%d: Packet with seqn:%u drained at %u\n",
+					__func__, __LINE__,
+					*rte_reorder_seqn(robufs[i]), i);
+			ret = -1;
+			goto exit;
+		}
+	}
+
+	ret = 0;
+exit:
+	rte_reorder_free(b);
+	for (i = 0; i < num_bufs; i++) {
+		rte_pktmbuf_free(bufs[i]);
+		rte_pktmbuf_free(robufs[i]);
+	}
+	return ret;
+}
+
+#define MT_REORDER_SIZE 256
+#define MT_PKTS_PER_WORKER 4096
+
+static struct {
+	struct rte_reorder_buffer *b;
+	unsigned int nb_workers;
+	RTE_ATOMIC(unsigned int) worker_idx;
+	RTE_ATOMIC(bool) stop;
+} mt_params;
+
+static int
+reorder_mt_worker(__rte_unused void *arg)
+{
+	struct rte_mempool *p = test_params->p;
+	struct rte_mbuf *bufs[BURST];
+	unsigned int idx, i, n, seqn;
+
+	idx = rte_atomic_fetch_add_explicit(&mt_params.worker_idx, 1,
+			rte_memory_order_relaxed);
+	seqn = idx;
+
+	/* each worker inserts one sequence number out of nb_workers */
+	for (n = 0; n < MT_PKTS_PER_WORKER; n += BURST) {
+		if (rte_pktmbuf_alloc_bulk(p, bufs, BURST) != 0)
+			return -1;
+		for (i = 0; i < BURST; i++) {
+			*rte_reorder_seqn(bufs[i]) = seqn;
+			seqn += mt_params.nb_workers;
+		}
+		i = 0;
+		while (i < BURST) {
+			i += rte_reorder_insert_burst(mt_params.b, &bufs[i],
+					BURST - i);
+			if (i < BURST) {
+				if (rte_errno != ENOSPC ||
+						rte_atomic_load_explicit(
+						&mt_params.stop,
+						rte_memory_order_relaxed)) {
+					rte_pktmbuf_free_bulk(&bufs[i],
+							BURST - i);
+					return -1;
+				}
+				rte_pause();
+			}
+		}
+	}
+
+	return 0;
+}
+
+static int
+test_reorder_concurrent_mt(void)
+{
+	struct rte_mbuf *robufs[BURST];
+	unsigned int i, cnt, lcore_id;
+	uint64_t deadline;
+	uint32_t expected, total;
+	int ret = 0;
+
+	mt_params.nb_workers = rte_lcore_count() - 1;
+	if (mt_params.nb_workers == 0) {
+		printf("%s: at least 2 lcores are needed\n", __func__);
+		return TEST_SKIPPED;
+	}
+	mt_params.worker_idx = 0;
+	mt_params.stop = false;
+
+	mt_params.b = rte_reorder_create_ext("test_concurrent_mt",
+			rte_socket_id(), MT_REORDER_SIZE,
+			RTE_REORDER_F_CONCURRENT);
+	TEST_ASSERT_NOT_NULL(mt_params.b, "Failed to create reorder buffer");
+
+	RTE_LCORE_FOREACH_WORKER(lcore_id)
+		rte_eal_remote_launch(reorder_mt_worker, NULL, lcore_id);
+
+	total = mt_params.nb_workers * MT_PKTS_PER_WORKER;
+	deadline = rte_get_timer_cycles() + 10 * rte_get_timer_hz();
+	expected = 0;
+	while (expected != total && ret == 0) {
+		cnt = rte_reorder_drain(mt_params.b, robufs, BURST);
+		for (i = 0; i < cnt; i++) {
+			if (*rte_reorder_seqn(robufs[i]) != expected + i) {
+				printf("%s: Packet with seqn:%u drained instead of %u\n",
+						__func__,
+						*rte_reorder_seqn(robufs[i]),
+						expected + i);
+				ret = -1;
+			}
+		}
+		rte_pktmbuf_free_bulk(robufs, cnt);
+		expected += cnt;
+
+		if (rte_get_timer_cycles() > deadline) {
+			printf("%s: timeout after %u packets\n", __func__,
+					expected);
+			ret = -1;
+		}
+	}
+
+	rte_atomic_store_explicit(&mt_params.stop, true,
+			rte_memory_order_relaxed);
+
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		if (rte_eal_wait_lcore(lcore_id) != 0)
+			ret = -1;
+	}
+
+	rte_reorder_free(mt_params.b);
+	mt_params.b = NULL;
+
+	return ret;
+}
+
 static int
 test_setup(void)
 {
@@ -537,6 +783,8 @@ static struct unit_test_suite reorder_test_suite  = {
 		TEST_CASE(test_reorder_drain),
 		TEST_CASE(test_reorder_drain_up_to_seqn),
 		TEST_CASE(test_reorder_set_seqn),
+		TEST_CASE(test_reorder_concurrent),
+		TEST_CASE(test_reorder_concurrent_mt),
 		TEST_CASES_END()
 	}
 };
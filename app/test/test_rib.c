@@ -9,6 +9,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include <rte_errno.h>
 #include <rte_ip.h>
 #include <rte_rib.h>
 
@@ -21,6 +22,7 @@ static int32_t test_insert_invalid(void);
 static int32_t test_get_fn(void);
 static int32_t test_basic(void);
 static int32_t test_tree_traversal(void);
+static int32_t test_insert_bulk(void);
 
 #define MAX_DEPTH 32
 #define MAX_RULES (1 << 22)
@@ -323,6 +325,61 @@ test_tree_traversal(void)
 	return TEST_SUCCESS;
 }
 
+/*
+ * Check that a batch of prefixes is inserted up to the first failing one
+ * and that the inserted prefixes are looked up
+ */
+int32_t
+test_insert_bulk(void)
+{
+	struct rte_rib *rib = NULL;
+	struct rte_rib_node *node, *nodes[6];
+	struct rte_rib_conf config;
+	const uint32_t ips[] = {
+		RTE_IPV4(10, 0, 0, 0),
+		RTE_IPV4(10, 10, 0, 0),
+		RTE_IPV4(10, 10, 10, 0),
+		RTE_IPV4(0, 0, 0, 0),
+		RTE_IPV4(10, 10, 0, 0),
+		RTE_IPV4(192, 168, 0, 0),
+	};
+	const uint8_t depths[] = { 8, 16, 24, 0, 16, 16 };
+	unsigned int i, ret;
+
+	config.max_nodes = MAX_RULES;
+	config.ext_sz = 0;
+
+	rib = rte_rib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(rib != NULL, "Failed to create RIB\n");
+
+	ret = rte_rib_insert_bulk(rib, ips, depths, nodes, RTE_DIM(ips));
+	RTE_TEST_ASSERT((ret == 4) && (rte_errno == EEXIST),
+		"Batch not stopped at the existing prefix\n");
+
+	for (i = 0; i < ret; i++) {
+		node = rte_rib_lookup_exact(rib, ips[i], depths[i]);
+		RTE_TEST_ASSERT((node != NULL) && (node == nodes[i]),
+			"Failed to lookup\n");
+	}
+
+	node = rte_rib_lookup(rib, RTE_IPV4(10, 10, 10, 1));
+	RTE_TEST_ASSERT(node == nodes[2], "Failed to lookup\n");
+	node = rte_rib_lookup(rib, RTE_IPV4(10, 10, 20, 1));
+	RTE_TEST_ASSERT(node == nodes[1], "Failed to lookup\n");
+	node = rte_rib_lookup(rib, RTE_IPV4(10, 20, 0, 1));
+	RTE_TEST_ASSERT(node == nodes[0], "Failed to lookup\n");
+	node = rte_rib_lookup(rib, RTE_IPV4(192, 168, 0, 1));
+	RTE_TEST_ASSERT(node == nodes[3], "Failed to lookup\n");
+
+	rte_rib_remove(rib, ips[1], depths[1]);
+	node = rte_rib_lookup(rib, RTE_IPV4(10, 10, 20, 1));
+	RTE_TEST_ASSERT(node == nodes[0], "Lookup returns removed rule\n");
+
+	rte_rib_free(rib);
+
+	return TEST_SUCCESS;
+}
+
 static struct unit_test_suite rib_tests = {
 	.suite_name = "rib autotest",
 	.setup = NULL,
@@ -334,6 +391,7 @@ static struct unit_test_suite rib_tests = {
 		TEST_CASE(test_get_fn),
 		TEST_CASE(test_basic),
 		TEST_CASE(test_tree_traversal),
+		TEST_CASE(test_insert_bulk),
 		TEST_CASES_END()
 	}
 };
@@ -6,6 +6,7 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <rte_errno.h>
 #include <rte_ip6.h>
 #include <rte_rib6.h>
 
@@ -20,6 +21,7 @@ static int32_t test_insert_invalid(void);
 static int32_t test_get_fn(void);
 static int32_t test_basic(void);
 static int32_t test_tree_traversal(void);
+static int32_t test_insert_bulk(void);
 
 #define MAX_DEPTH 128
 #define MAX_RULES (1 << 22)
@@ -322,6 +324,67 @@ test_tree_traversal(void)
 	return TEST_SUCCESS;
 }
 
+/*
+ * Check that a batch of prefixes is inserted up to the first failing one
+ * and that the inserted prefixes are looked up
+ */
+int32_t
+test_insert_bulk(void)
+{
+	struct rte_rib6 *rib = NULL;
+	struct rte_rib6_node *node, *nodes[6];
+	struct rte_rib6_conf config;
+	const struct rte_ipv6_addr ips[] = {
+		RTE_IPV6(0x2001, 0, 0, 0, 0, 0, 0, 0),
+		RTE_IPV6(0x2001, 0x0db8, 0, 0, 0, 0, 0, 0),
+		RTE_IPV6(0x2001, 0x0db8, 0x0001, 0, 0, 0, 0, 0),
+		RTE_IPV6_ADDR_UNSPEC,
+		RTE_IPV6(0x2001, 0x0db8, 0, 0, 0, 0, 0, 0),
+		RTE_IPV6(0xfd00, 0, 0, 0, 0, 0, 0, 0),
+	};
+	const uint8_t depths[] = { 16, 32, 48, 0, 32, 8 };
+	struct rte_ipv6_addr ip;
+	unsigned int i, ret;
+
+	config.max_nodes = MAX_RULES;
+	config.ext_sz = 0;
+
+	rib = rte_rib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(rib != NULL, "Failed to create RIB\n");
+
+	ret = rte_rib6_insert_bulk(rib, ips, depths, nodes, RTE_DIM(ips));
+	RTE_TEST_ASSERT((ret == 4) && (rte_errno == EEXIST),
+		"Batch not stopped at the existing prefix\n");
+
+	for (i = 0; i < ret; i++) {
+		node = rte_rib6_lookup_exact(rib, &ips[i], depths[i]);
+		RTE_TEST_ASSERT((node != NULL) && (node == nodes[i]),
+			"Failed to lookup\n");
+	}
+
+	ip = (struct rte_ipv6_addr)RTE_IPV6(0x2001, 0x0db8, 0x0001, 0, 0, 0, 0, 1);
+	node = rte_rib6_lookup(rib, &ip);
+	RTE_TEST_ASSERT(node == nodes[2], "Failed to lookup\n");
+	ip = (struct rte_ipv6_addr)RTE_IPV6(0x2001, 0x0db8, 0x0002, 0, 0, 0, 0, 1);
+	node = rte_rib6_lookup(rib, &ip);
+	RTE_TEST_ASSERT(node == nodes[1], "Failed to lookup\n");
+	ip = (struct rte_ipv6_addr)RTE_IPV6(0x2001, 0x0db9, 0, 0, 0, 0, 0, 1);
+	node = rte_rib6_lookup(rib, &ip);
+	RTE_TEST_ASSERT(node == nodes[0], "Failed to lookup\n");
+	ip = (struct rte_ipv6_addr)RTE_IPV6(0xfd00, 0, 0, 0, 0, 0, 0, 1);
+	node = rte_rib6_lookup(rib, &ip);
+	RTE_TEST_ASSERT(node == nodes[3], "Failed to lookup\n");
+
+	rte_rib6_remove(rib, &ips[1], depths[1]);
+	ip = (struct rte_ipv6_addr)RTE_IPV6(0x2001, 0x0db8, 0x0002, 0, 0, 0, 0, 1);
+	node = rte_rib6_lookup(rib, &ip);
+	RTE_TEST_ASSERT(node == nodes[0], "Lookup returns removed rule\n");
+
+	rte_rib6_free(rib);
+
+	return TEST_SUCCESS;
+}
+
 static struct unit_test_suite rib6_tests = {
 	.suite_name = "rib6 autotest",
 	.setup = NULL,
@@ -333,6 +396,7 @@ static struct unit_test_suite rib6_tests = {
 		TEST_CASE(test_get_fn),
 		TEST_CASE(test_basic),
 		TEST_CASE(test_tree_traversal),
+		TEST_CASE(test_insert_bulk),
 		TEST_CASES_END()
 	}
 };
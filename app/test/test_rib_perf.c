@@ -0,0 +1,242 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 The DPDK contributors
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <rte_cycles.h>
+#include <rte_errno.h>
+#include <rte_ip.h>
+#include <rte_ip6.h>
+#include <rte_malloc.h>
+#include <rte_random.h>
+#include <rte_rib.h>
+#include <rte_rib6.h>
+
+#include "test.h"
+
+#define NUM_ROUTES	(1 << 20)
+#define NUM_LOOKUPS	(1 << 22)
+#define NUM_ITER_NETS	256
+#define ITER_DEPTH	12
+#define IPV4_MAX_DEPTH	32
+
+/* Mostly /24 (or /48) prefixes, as in the Internet routing tables */
+static uint8_t
+get_depth(uint8_t max_depth, uint8_t common_depth)
+{
+	uint32_t r = rte_rand_max(100);
+
+	if (r < 60)
+		return common_depth;
+	if (r < 90)
+		return max_depth / 4 + rte_rand_max(common_depth - max_depth / 4);
+	return common_depth + 1 + rte_rand_max(max_depth - common_depth);
+}
+
+static void
+print_result(const char *op, uint64_t cycles, unsigned int num)
+{
+	printf("%-12s %10u in %12"PRIu64" cycles, %6.1f cycles per op\n",
+		op, num, cycles, num != 0 ? (double)cycles / num : 0.0);
+}
+
+static int
+test_rib_perf(void)
+{
+	struct rte_rib_conf config = {
+		.max_nodes = 2 * NUM_ROUTES,
+		.ext_sz = 0,
+	};
+	struct rte_rib_node *node;
+	struct rte_rib *rib;
+	uint32_t *ips, *addrs;
+	uint8_t *depths;
+	uint64_t begin, cycles;
+	unsigned int i, num, num_routes, found;
+	int ret = TEST_FAILED;
+
+	ips = rte_malloc(NULL, sizeof(*ips) * NUM_ROUTES, 0);
+	depths = rte_malloc(NULL, sizeof(*depths) * NUM_ROUTES, 0);
+	addrs = rte_malloc(NULL, sizeof(*addrs) * NUM_LOOKUPS, 0);
+	if (ips == NULL || depths == NULL || addrs == NULL) {
+		printf("Failed to allocate the routes\n");
+		goto free_arrays;
+	}
+	for (i = 0; i < NUM_ROUTES; i++) {
+		depths[i] = get_depth(IPV4_MAX_DEPTH, 24);
+		ips[i] = (uint32_t)rte_rand() &
+			rte_rib_depth_to_mask(depths[i]);
+	}
+	for (i = 0; i < NUM_LOOKUPS; i++)
+		addrs[i] = ips[rte_rand_max(NUM_ROUTES)] | rte_rand_max(256);
+
+	rib = rte_rib_create(__func__, SOCKET_ID_ANY, &config);
+	if (rib == NULL) {
+		printf("Failed to create RIB\n");
+		goto free_arrays;
+	}
+
+	printf("IPv4 RIB, %u random prefixes\n", NUM_ROUTES);
+
+	/* keep the unique prefixes only */
+	begin = rte_rdtsc_precise();
+	for (i = 0, num = 0; i < NUM_ROUTES; i++) {
+		if (rte_rib_insert(rib, ips[i], depths[i]) != NULL) {
+			ips[num] = ips[i];
+			depths[num++] = depths[i];
+		}
+	}
+	num_routes = num;
+	cycles = rte_rdtsc_precise() - begin;
+	print_result("insert", cycles, num);
+
+	begin = rte_rdtsc_precise();
+	for (i = 0, found = 0; i < NUM_LOOKUPS; i++)
+		found += (rte_rib_lookup(rib, addrs[i]) != NULL);
+	cycles = rte_rdtsc_precise() - begin;
+	print_result("lookup", cycles, NUM_LOOKUPS);
+
+	begin = rte_rdtsc_precise();
+	for (i = 0, num = 0; i < NUM_ITER_NETS; i++) {
+		uint32_t net = ips[rte_rand_max(num_routes)];
+
+		node = NULL;
+		while ((node = rte_rib_get_nxt(rib, net, ITER_DEPTH, node,
+				RTE_RIB_GET_NXT_ALL)) != NULL)
+			num++;
+	}
+	cycles = rte_rdtsc_precise() - begin;
+	print_result("iterate", cycles, num);
+
+	begin = rte_rdtsc_precise();
+	for (i = 0; i < num_routes; i++)
+		rte_rib_remove(rib, ips[i], depths[i]);
+	cycles = rte_rdtsc_precise() - begin;
+	print_result("remove", cycles, num_routes);
+
+	begin = rte_rdtsc_precise();
+	num = rte_rib_insert_bulk(rib, ips, depths, NULL, num_routes);
+	cycles = rte_rdtsc_precise() - begin;
+	print_result("insert bulk", cycles, num);
+
+	if (found == 0)
+		printf("Warning: no route found\n");
+	if (num == num_routes)
+		ret = TEST_SUCCESS;
+	else
+		printf("Failed to insert the routes in bulk\n");
+
+	rte_rib_free(rib);
+free_arrays:
+	rte_free(addrs);
+	rte_free(depths);
+	rte_free(ips);
+
+	return ret;
+}
+
+static int
+test_rib6_perf(void)
+{
+	struct rte_rib6_conf config = {
+		.max_nodes = 2 * NUM_ROUTES,
+		.ext_sz = 0,
+	};
+	struct rte_ipv6_addr *ips, *addrs;
+	struct rte_rib6_node *node;
+	struct rte_rib6 *rib;
+	uint8_t *depths;
+	uint64_t begin, cycles;
+	unsigned int i, j, num, num_routes, found;
+	int ret = TEST_FAILED;
+
+	ips = rte_malloc(NULL, sizeof(*ips) * NUM_ROUTES, 0);
+	depths = rte_malloc(NULL, sizeof(*depths) * NUM_ROUTES, 0);
+	addrs = rte_malloc(NULL, sizeof(*addrs) * NUM_LOOKUPS, 0);
+	if (ips == NULL || depths == NULL || addrs == NULL) {
+		printf("Failed to allocate the routes\n");
+		goto free_arrays;
+	}
+	for (i = 0; i < NUM_ROUTES; i++) {
+		depths[i] = get_depth(RTE_IPV6_MAX_DEPTH, 48);
+		for (j = 0; j < RTE_IPV6_ADDR_SIZE; j++)
+			ips[i].a[j] = rte_rand();
+		/* global unicast */
+		ips[i].a[0] = 0x20 | (ips[i].a[0] & 0x1f);
+		rte_ipv6_addr_mask(&ips[i], depths[i]);
+	}
+	for (i = 0; i < NUM_LOOKUPS; i++) {
+		addrs[i] = ips[rte_rand_max(NUM_ROUTES)];
+		addrs[i].a[RTE_IPV6_ADDR_SIZE - 1] = rte_rand();
+	}
+
+	rib = rte_rib6_create(__func__, SOCKET_ID_ANY, &config);
+	if (rib == NULL) {
+		printf("Failed to create RIB\n");
+		goto free_arrays;
+	}
+
+	printf("IPv6 RIB, %u random prefixes\n", NUM_ROUTES);
+
+	/* keep the unique prefixes only */
+	begin = rte_rdtsc_precise();
+	for (i = 0, num = 0; i < NUM_ROUTES; i++) {
+		if (rte_rib6_insert(rib, &ips[i], depths[i]) != NULL) {
+			ips[num] = ips[i];
+			depths[num++] = depths[i];
+		}
+	}
+	num_routes = num;
+	cycles = rte_rdtsc_precise() - begin;
+	print_result("insert", cycles, num);
+
+	begin = rte_rdtsc_precise();
+	for (i = 0, found = 0; i < NUM_LOOKUPS; i++)
+		found += (rte_rib6_lookup(rib, &addrs[i]) != NULL);
+	cycles = rte_rdtsc_precise() - begin;
+	print_result("lookup", cycles, NUM_LOOKUPS);
+
+	begin = rte_rdtsc_precise();
+	for (i = 0, num = 0; i < NUM_ITER_NETS; i++) {
+		const struct rte_ipv6_addr *net = &ips[rte_rand_max(num_routes)];
+
+		node = NULL;
+		while ((node = rte_rib6_get_nxt(rib, net, ITER_DEPTH, node,
+				RTE_RIB6_GET_NXT_ALL)) != NULL)
+			num++;
+	}
+	cycles = rte_rdtsc_precise() - begin;
+	print_result("iterate", cycles, num);
+
+	begin = rte_rdtsc_precise();
+	for (i = 0; i < num_routes; i++)
+		rte_rib6_remove(rib, &ips[i], depths[i]);
+	cycles = rte_rdtsc_precise() - begin;
+	print_result("remove", cycles, num_routes);
+
+	begin = rte_rdtsc_precise();
+	num = rte_rib6_insert_bulk(rib, ips, depths, NULL, num_routes);
+	cycles = rte_rdtsc_precise() - begin;
+	print_result("insert bulk", cycles, num);
+
+	if (found == 0)
+		printf("Warning: no route found\n");
+	if (num == num_routes)
+		ret = TEST_SUCCESS;
+	else
+		printf("Failed to insert the routes in bulk\n");
+
+	rte_rib6_free(rib);
+free_arrays:
+	rte_free(addrs);
+	rte_free(depths);
+	rte_free(ips);
+
+	return ret;
+}
+
+REGISTER_PERF_TEST(rib_perf_autotest, test_rib_perf);
+REGISTER_PERF_TEST(rib6_perf_autotest, test_rib6_perf);
@@ -30,6 +30,10 @@ static uint32_t service_remote_launch_flag;
 #define DUMMY_SERVICE_NAME "dummy_service"
 #define MT_SAFE_SERVICE_NAME "mt_safe_service"
 
+/* time spent by a busy service of the scheduling tests in every call */
+#define SCHED_BUSY_US 1
+#define SCHED_RUN_MS 100
+
 static int
 testsuite_setup(void)
 {
@@ -124,6 +128,27 @@ static int32_t dummy_mt_safe_cb(void *args)
 	return 0;
 }
 
+/* busy service of the scheduling tests, counting its calls */
+static int32_t sched_busy_cb(void *args)
+{
+	RTE_ATOMIC(uint64_t) *calls = args;
+
+	rte_atomic_fetch_add_explicit(calls, 1, rte_memory_order_relaxed);
+	rte_delay_us_block(SCHED_BUSY_US);
+
+	return 0;
+}
+
+/* idle service of the scheduling tests, counting its calls */
+static int32_t sched_idle_cb(void *args)
+{
+	RTE_ATOMIC(uint64_t) *calls = args;
+
+	rte_atomic_fetch_add_explicit(calls, 1, rte_memory_order_relaxed);
+
+	return -EAGAIN;
+}
+
 /* unregister all services */
 static int
 unregister_all(void)
@@ -748,6 +773,82 @@ service_threaded_test(int mt_safe)
 	return test_params[1];
 }
 
+/* run an MT safe service mapped to one core, the second core stealing it */
+static int
+service_mt_safe_steal(void)
+{
+	if (!rte_lcore_is_enabled(0) || !rte_lcore_is_enabled(1) ||
+	    !rte_lcore_is_enabled(2))
+		return TEST_SKIPPED;
+
+	unregister_all();
+
+	uint32_t slcore_1 = rte_get_next_lcore(/* start core */ -1,
+					       /* skip main */ 1,
+					       /* wrap */ 0);
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_add(slcore_1),
+			"mt safe lcore add fail");
+	uint32_t slcore_2 = rte_get_next_lcore(/* start core */ slcore_1,
+					       /* skip main */ 1,
+					       /* wrap */ 0);
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_add(slcore_2),
+			"mt safe lcore add fail");
+
+	/* expected failure cases */
+	TEST_ASSERT_EQUAL(-EINVAL, rte_service_lcore_steal_set(100000, 1),
+			"Enabling stealing on an invalid core did not fail");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_steal_get(slcore_2),
+			"Stealing enabled on a new service core");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_steal_set(slcore_2, 1),
+			"Enabling stealing failed");
+	TEST_ASSERT_EQUAL(1, rte_service_lcore_steal_get(slcore_2),
+			"Stealing not enabled");
+
+	/* the callback reports running concurrently on two cores */
+	uint32_t test_params[2];
+	memset(test_params, 0, sizeof(uint32_t) * 2);
+
+	struct rte_service_spec service;
+	memset(&service, 0, sizeof(struct rte_service_spec));
+	service.callback_userdata = test_params;
+	service.callback = dummy_mt_safe_cb;
+	service.capabilities |= RTE_SERVICE_CAP_MT_SAFE;
+	snprintf(service.name, sizeof(service.name), MT_SAFE_SERVICE_NAME);
+
+	uint32_t id;
+	TEST_ASSERT_EQUAL(0, rte_service_component_register(&service, &id),
+			"Register of MT SAFE service failed");
+	rte_service_component_runstate_set(id, 1);
+
+	/* map the service to the first core only */
+	TEST_ASSERT_EQUAL(0, rte_service_runstate_set(id, 1),
+			"Starting valid service failed");
+	TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(id, slcore_1, 1),
+			"Failed to enable lcore 1 on mt safe service");
+	rte_service_lcore_start(slcore_1);
+	rte_service_lcore_start(slcore_2);
+
+	/* wait for the worker threads to run */
+	rte_delay_ms(1000);
+	TEST_ASSERT_EQUAL(0, rte_service_runstate_set(id, 0),
+			"Failed to stop MT Safe service");
+	rte_service_lcore_stop(slcore_1);
+	rte_service_lcore_stop(slcore_2);
+
+	uint64_t stolen = 0;
+	TEST_ASSERT_EQUAL(0, rte_service_attr_get(id,
+			RTE_SERVICE_ATTR_STOLEN_CALL_COUNT, &stolen),
+			"Valid attr_get() call didn't return success");
+	TEST_ASSERT_NOT_EQUAL(0, stolen, "Service never stolen");
+	TEST_ASSERT_EQUAL(1, test_params[1],
+			"MT Safe service not run by two cores concurrently");
+
+	rte_eal_wait_lcore(slcore_1);
+	rte_eal_wait_lcore(slcore_2);
+
+	return unregister_all();
+}
+
 /* tests an MT SAFE service with two cores. The callback function ensures that
  * two threads access the callback concurrently.
  */
@@ -1055,6 +1156,291 @@ service_active_two_cores(void)
 	return unregister_all();
 }
 
+/* run a service on a service core in adaptive scheduling mode */
+static int
+service_lcore_sched(void)
+{
+	const uint32_t sid = 0;
+
+	/* expected failure cases */
+	TEST_ASSERT_EQUAL(-EINVAL, rte_service_lcore_sched_set(100000,
+			RTE_SERVICE_LCORE_SCHED_ADAPTIVE),
+			"Setting the mode of an invalid core did not fail");
+	TEST_ASSERT_EQUAL(-ENOTSUP, rte_service_lcore_sched_set(slcore_id,
+			RTE_SERVICE_LCORE_SCHED_ADAPTIVE),
+			"Setting the mode of a non service core did not fail");
+	TEST_ASSERT_EQUAL(-EINVAL, rte_service_weight_set(10000, 1),
+			"Setting the weight of an invalid service did not fail");
+	TEST_ASSERT_EQUAL(-EINVAL, rte_service_weight_set(sid, 0),
+			"Setting a zero weight did not fail");
+	TEST_ASSERT_EQUAL(-EINVAL, rte_service_weight_set(sid,
+			RTE_SERVICE_WEIGHT_MAX + 1),
+			"Setting a too large weight did not fail");
+	TEST_ASSERT_EQUAL(RTE_SERVICE_WEIGHT_DEFAULT,
+			rte_service_weight_get(sid),
+			"Service not registered with the default weight");
+
+	TEST_ASSERT_EQUAL(0, rte_service_weight_set(sid, 70),
+			"Setting a valid weight failed");
+	TEST_ASSERT_EQUAL(70, rte_service_weight_get(sid),
+			"Weight of the service not updated");
+
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_add(slcore_id),
+			"Add service core failed when not in use before");
+	TEST_ASSERT_EQUAL(RTE_SERVICE_LCORE_SCHED_RR,
+			rte_service_lcore_sched_get(slcore_id),
+			"Service core not added in round robin mode");
+	TEST_ASSERT_EQUAL(-EINVAL, rte_service_lcore_sched_set(slcore_id,
+			RTE_SERVICE_LCORE_SCHED_ADAPTIVE + 1),
+			"Setting an invalid mode did not fail");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_sched_set(slcore_id,
+			RTE_SERVICE_LCORE_SCHED_ADAPTIVE),
+			"Setting the adaptive mode failed");
+	TEST_ASSERT_EQUAL(RTE_SERVICE_LCORE_SCHED_ADAPTIVE,
+			rte_service_lcore_sched_get(slcore_id),
+			"Mode of the service core not updated");
+
+	/* start the service */
+	TEST_ASSERT_EQUAL(0, rte_service_runstate_set(sid, 1),
+			"Starting valid service failed");
+	TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(sid, slcore_id, 1),
+			"Enabling valid service on valid core failed");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_start(slcore_id),
+			"Service core start after add failed");
+
+	/* ensures core really is running the service function */
+	TEST_ASSERT_EQUAL(1, service_lcore_running_check(),
+			"Service core expected to poll service but it didn't");
+
+	/* a single service core has nothing to balance */
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_rebalance(),
+			"Service moved with a single service core");
+	TEST_ASSERT_EQUAL(1, rte_service_map_lcore_get(sid, slcore_id),
+			"Service unmapped by the rebalance");
+
+	/* stop the service, and wait for not-active with timeout */
+	TEST_ASSERT_EQUAL(0, rte_service_runstate_set(sid, 0),
+			"Error: Service stop returned non-zero");
+	TEST_ASSERT_EQUAL(0, service_ensure_stopped_with_timeout(sid),
+			  "Error: Service not stopped after timeout period.");
+
+	return unregister_all();
+}
+
+/* register and start a service of the scheduling tests */
+static int
+sched_service_register(const char *name, rte_service_func cb,
+		RTE_ATOMIC(uint64_t) *calls, uint32_t *id)
+{
+	struct rte_service_spec service;
+
+	memset(&service, 0, sizeof(struct rte_service_spec));
+	service.callback = cb;
+	service.callback_userdata = (void *)(uintptr_t)calls;
+	snprintf(service.name, sizeof(service.name), "%s", name);
+
+	TEST_ASSERT_EQUAL(0, rte_service_component_register(&service, id),
+			"Failed to register valid service");
+	rte_service_component_runstate_set(*id, 1);
+	TEST_ASSERT_EQUAL(0, rte_service_runstate_set(*id, 1),
+			"Starting valid service failed");
+
+	return TEST_SUCCESS;
+}
+
+/* busy services share an adaptive service core in proportion of weight */
+static int
+service_lcore_sched_weight(void)
+{
+	static RTE_ATOMIC(uint64_t) calls[2];
+	uint64_t heavy, light;
+	uint32_t id[2];
+	unsigned int i;
+
+	for (i = 0; i < RTE_DIM(calls); i++) {
+		char name[RTE_SERVICE_NAME_MAX];
+
+		rte_atomic_store_explicit(&calls[i], 0,
+				rte_memory_order_relaxed);
+		snprintf(name, sizeof(name), "sched_busy_%u", i);
+		TEST_ASSERT_EQUAL(TEST_SUCCESS, sched_service_register(name,
+				sched_busy_cb, &calls[i], &id[i]),
+				"Failed to register busy service");
+	}
+	TEST_ASSERT_EQUAL(0, rte_service_weight_set(id[0], 80),
+			"Setting a valid weight failed");
+	TEST_ASSERT_EQUAL(0, rte_service_weight_set(id[1], 20),
+			"Setting a valid weight failed");
+
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_add(slcore_id),
+			"Add service core failed when not in use before");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_sched_set(slcore_id,
+			RTE_SERVICE_LCORE_SCHED_ADAPTIVE),
+			"Setting the adaptive mode failed");
+	for (i = 0; i < RTE_DIM(id); i++)
+		TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(id[i],
+				slcore_id, 1),
+				"Enabling valid service on valid core failed");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_start(slcore_id),
+			"Service core start after add failed");
+
+	rte_delay_ms(SCHED_RUN_MS);
+
+	for (i = 0; i < RTE_DIM(id); i++) {
+		TEST_ASSERT_EQUAL(0, rte_service_runstate_set(id[i], 0),
+				"Error: Service stop returned non-zero");
+		TEST_ASSERT_EQUAL(0, service_ensure_stopped_with_timeout(id[i]),
+				"Error: Service not stopped after timeout period.");
+	}
+
+	/* 4 times more calls expected */
+	heavy = rte_atomic_load_explicit(&calls[0], rte_memory_order_relaxed);
+	light = rte_atomic_load_explicit(&calls[1], rte_memory_order_relaxed);
+	TEST_ASSERT(light > 0, "Service of low weight never called");
+	TEST_ASSERT(heavy > 2 * light,
+			"Weights not applied: %"PRIu64" calls for weight 80, "
+			"%"PRIu64" calls for weight 20", heavy, light);
+
+	return unregister_all();
+}
+
+/* an idle service is called less often by an adaptive service core */
+static int
+service_lcore_sched_idle(void)
+{
+	static RTE_ATOMIC(uint64_t) calls;
+	uint64_t rr_calls, adaptive_calls;
+	uint32_t id;
+
+	rte_atomic_store_explicit(&calls, 0, rte_memory_order_relaxed);
+	TEST_ASSERT_EQUAL(TEST_SUCCESS, sched_service_register("sched_idle",
+			sched_idle_cb, &calls, &id),
+			"Failed to register idle service");
+
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_add(slcore_id),
+			"Add service core failed when not in use before");
+	TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(id, slcore_id, 1),
+			"Enabling valid service on valid core failed");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_start(slcore_id),
+			"Service core start after add failed");
+
+	rte_delay_ms(SCHED_RUN_MS);
+	rr_calls = rte_atomic_exchange_explicit(&calls, 0,
+			rte_memory_order_relaxed);
+
+	/* switch the running service core to the adaptive mode */
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_sched_set(slcore_id,
+			RTE_SERVICE_LCORE_SCHED_ADAPTIVE),
+			"Setting the adaptive mode failed");
+	rte_delay_ms(1);
+	rte_atomic_store_explicit(&calls, 0, rte_memory_order_relaxed);
+	rte_delay_ms(SCHED_RUN_MS);
+	adaptive_calls = rte_atomic_load_explicit(&calls,
+			rte_memory_order_relaxed);
+
+	TEST_ASSERT_EQUAL(0, rte_service_runstate_set(id, 0),
+			"Error: Service stop returned non-zero");
+	TEST_ASSERT_EQUAL(0, service_ensure_stopped_with_timeout(id),
+			"Error: Service not stopped after timeout period.");
+
+	/* at most one call every 128 us once backed off */
+	TEST_ASSERT(adaptive_calls > 0, "Idle service never called");
+	TEST_ASSERT(adaptive_calls * 10 < rr_calls,
+			"Idle service not backed off: %"PRIu64" calls, "
+			"%"PRIu64" in round robin mode",
+			adaptive_calls, rr_calls);
+
+	return unregister_all();
+}
+
+/* the services of a busy adaptive service core are spread to an idle one */
+static int
+service_lcore_sched_rebalance(void)
+{
+	static RTE_ATOMIC(uint64_t) calls[2];
+	uint32_t id[2], slcore[2];
+	unsigned int i;
+
+	if (!rte_lcore_is_enabled(0) || !rte_lcore_is_enabled(1) ||
+	    !rte_lcore_is_enabled(2))
+		return TEST_SKIPPED;
+
+	slcore[0] = rte_get_next_lcore(/* start core */ -1,
+				       /* skip main */ 1,
+				       /* wrap */ 0);
+	slcore[1] = rte_get_next_lcore(/* start core */ slcore[0],
+				       /* skip main */ 1,
+				       /* wrap */ 0);
+
+	for (i = 0; i < RTE_DIM(calls); i++) {
+		char name[RTE_SERVICE_NAME_MAX];
+
+		rte_atomic_store_explicit(&calls[i], 0,
+				rte_memory_order_relaxed);
+		snprintf(name, sizeof(name), "sched_busy_%u", i);
+		TEST_ASSERT_EQUAL(TEST_SUCCESS, sched_service_register(name,
+				sched_busy_cb, &calls[i], &id[i]),
+				"Failed to register busy service");
+		/* no load before the service cores run */
+		TEST_ASSERT_EQUAL(0, rte_service_runstate_set(id[i], 0),
+				"Error: Service stop returned non-zero");
+	}
+
+	for (i = 0; i < RTE_DIM(slcore); i++) {
+		TEST_ASSERT_EQUAL(0, rte_service_lcore_add(slcore[i]),
+				"Add service core failed when not in use before");
+		TEST_ASSERT_EQUAL(0, rte_service_lcore_sched_set(slcore[i],
+				RTE_SERVICE_LCORE_SCHED_ADAPTIVE),
+				"Setting the adaptive mode failed");
+	}
+	/* both services on the first service core */
+	for (i = 0; i < RTE_DIM(id); i++)
+		TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(id[i],
+				slcore[0], 1),
+				"Enabling valid service on valid core failed");
+	for (i = 0; i < RTE_DIM(slcore); i++)
+		TEST_ASSERT_EQUAL(0, rte_service_lcore_start(slcore[i]),
+				"Service core start after add failed");
+
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_rebalance(),
+			"Service moved without load");
+
+	for (i = 0; i < RTE_DIM(id); i++)
+		TEST_ASSERT_EQUAL(0, rte_service_runstate_set(id[i], 1),
+				"Starting valid service failed");
+	rte_delay_ms(SCHED_RUN_MS);
+
+	TEST_ASSERT_EQUAL(1, rte_service_lcore_rebalance(),
+			"Services of the busy core not spread");
+	for (i = 0; i < RTE_DIM(id); i++)
+		TEST_ASSERT_EQUAL(1, rte_service_map_lcore_get(id[i],
+				slcore[0]) + rte_service_map_lcore_get(id[i],
+				slcore[1]),
+				"Service not mapped to a single core");
+	TEST_ASSERT_EQUAL(1, rte_service_map_lcore_get(id[0], slcore[0]) +
+			rte_service_map_lcore_get(id[1], slcore[0]),
+			"Services not spread over the service cores");
+
+	/* both services keep running */
+	for (i = 0; i < RTE_DIM(calls); i++)
+		rte_atomic_store_explicit(&calls[i], 0,
+				rte_memory_order_relaxed);
+	rte_delay_ms(SCHED_RUN_MS);
+	for (i = 0; i < RTE_DIM(calls); i++)
+		TEST_ASSERT(rte_atomic_load_explicit(&calls[i],
+				rte_memory_order_relaxed) > 0,
+				"Service %u not run after the rebalance", id[i]);
+
+	for (i = 0; i < RTE_DIM(id); i++) {
+		TEST_ASSERT_EQUAL(0, rte_service_runstate_set(id[i], 0),
+				"Error: Service stop returned non-zero");
+		TEST_ASSERT_EQUAL(0, service_ensure_stopped_with_timeout(id[i]),
+				"Error: Service not stopped after timeout period.");
+	}
+
+	return unregister_all();
+}
+
 static struct unit_test_suite service_tests  = {
 	.suite_name = "service core test suite",
 	.setup = testsuite_setup,
@@ -1070,8 +1456,14 @@ static struct unit_test_suite service_tests  = {
 		TEST_CASE_ST(dummy_register, NULL, service_lcore_en_dis_able),
 		TEST_CASE_ST(dummy_register, NULL, service_mt_unsafe_poll),
 		TEST_CASE_ST(dummy_register, NULL, service_mt_safe_poll),
+		TEST_CASE_ST(dummy_register, NULL, service_mt_safe_steal),
 		TEST_CASE_ST(dummy_register, NULL, service_may_be_active),
 		TEST_CASE_ST(dummy_register, NULL, service_active_two_cores),
+		TEST_CASE_ST(dummy_register, NULL, service_lcore_sched),
+		TEST_CASE_ST(dummy_register, NULL, service_lcore_sched_weight),
+		TEST_CASE_ST(dummy_register, NULL, service_lcore_sched_idle),
+		TEST_CASE_ST(dummy_register, NULL,
+				service_lcore_sched_rebalance),
 		TEST_CASES_END() /**< NULL terminate unit test array */
 	}
 };
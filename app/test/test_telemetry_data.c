@@ -13,6 +13,7 @@ telemetry_data_autotest(void)
 
 #else
 
+#include <stdlib.h>
 #include <string.h>
 #include <sys/socket.h>
 #include <sys/un.h>
@@ -30,7 +31,9 @@ telemetry_data_autotest(void)
 #define TELEMETRY_VERSION "v2"
 #define REQUEST_CMD "/test"
 #define BUF_SIZE 1024
+#define CACHED_CMD "/test_cached"
 #define CHECK_OUTPUT(exp) check_output(__func__, "{\"" REQUEST_CMD "\":" exp "}")
+#define CHECK_REQUEST(req, exp) check_request(__func__, req, exp)
 
 /*
  * Runs a series of test cases, checking the output of telemetry for various different types of
@@ -60,6 +63,7 @@ telemetry_data_autotest(void)
 
 static struct rte_tel_data response_data;
 static int sock;
+static unsigned int cached_calls;
 
 
 /*
@@ -76,17 +80,28 @@ telemetry_test_cb(const char *cmd __rte_unused, const char *params __rte_unused,
 }
 
 /*
- * This function is called by each test case function. It communicates with
- * the telemetry socket by requesting the /test command, and reading the
- * response. The expected response is passed in by the test case function,
- * and is compared to the actual response received from Telemetry.
+ * Callback of a command whose responses are cached, returning the number
+ * of times it was called.
  */
 static int
-check_output(const char *func_name, const char *expected)
+telemetry_cached_cb(const char *cmd __rte_unused, const char *params __rte_unused,
+		struct rte_tel_data *d)
+{
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_uint(d, "calls", ++cached_calls);
+	return 0;
+}
+
+/*
+ * Sends a request to the telemetry socket, and compares the response
+ * received with the expected one.
+ */
+static int
+check_request(const char *func_name, const char *request, const char *expected)
 {
 	int bytes;
 	char buf[BUF_SIZE * 16];
-	if (write(sock, REQUEST_CMD, strlen(REQUEST_CMD)) < 0) {
+	if (write(sock, request, strlen(request)) < 0) {
 		printf("%s: Error with socket write - %s\n", __func__,
 				strerror(errno));
 		return -1;
@@ -102,6 +117,18 @@ check_output(const char *func_name, const char *expected)
 	return strncmp(expected, buf, sizeof(buf));
 }
 
+/*
+ * This function is called by each test case function. It communicates with
+ * the telemetry socket by requesting the /test command, and reading the
+ * response. The expected response is passed in by the test case function,
+ * and is compared to the actual response received from Telemetry.
+ */
+static int
+check_output(const char *func_name, const char *expected)
+{
+	return check_request(func_name, REQUEST_CMD, expected);
+}
+
 static int
 test_null_return(void)
 {
@@ -528,6 +555,100 @@ test_dict_char_escaping(void)
 	return CHECK_OUTPUT("{\"name\":\"escaped\\n\\tvalue\"}");
 }
 
+static int
+test_batch(void)
+{
+	rte_tel_data_string(&response_data, "batch");
+	return CHECK_REQUEST("/batch,/test;/test,param;/unknown;/batch",
+			"{\"/batch\":[{\"/test\":\"batch\"},{\"/test\":\"batch\"},"
+			"{\"/unknown\":null},{\"/batch\":null}]}");
+}
+
+static int
+test_cache(void)
+{
+	cached_calls = 0;
+	if (rte_telemetry_cmd_cache_set("/not_registered", 1000) != -ENOENT)
+		return -1;
+	if (rte_telemetry_cmd_cache_set(CACHED_CMD, 60 * 1000) != 0)
+		return -1;
+	if (CHECK_REQUEST(CACHED_CMD, "{\"" CACHED_CMD "\":{\"calls\":1}}") != 0 ||
+			CHECK_REQUEST(CACHED_CMD, "{\"" CACHED_CMD "\":{\"calls\":1}}") != 0)
+		return -1;
+	/* parameters are part of the cache key */
+	if (CHECK_REQUEST(CACHED_CMD ",0", "{\"" CACHED_CMD "\":{\"calls\":2}}") != 0)
+		return -1;
+	if (rte_telemetry_cmd_cache_set(CACHED_CMD, 0) != 0)
+		return -1;
+	return CHECK_REQUEST(CACHED_CMD, "{\"" CACHED_CMD "\":{\"calls\":3}}");
+}
+
+/*
+ * Checks a response larger than the maximum message size is truncated to
+ * valid JSON by default, and is sent in full in several messages once
+ * streaming is enabled.
+ */
+static int
+test_large_output(void)
+{
+	const size_t max_len = BUF_SIZE * 16;
+	char str[RTE_TEL_MAX_STRING_LEN];
+	char *buf, *exp;
+	size_t len = 0, exp_len = 0;
+	unsigned int i;
+	int bytes, ret = -1;
+
+	buf = malloc(max_len * 8);
+	exp = malloc(max_len * 8);
+	if (buf == NULL || exp == NULL)
+		goto out;
+
+	memset(str, 'x', sizeof(str) - 1);
+	str[sizeof(str) - 1] = '\0';
+	exp_len = sprintf(exp, "{\"" REQUEST_CMD "\":[");
+	for (i = 0; i < RTE_TEL_MAX_ARRAY_ENTRIES; i++)
+		exp_len += sprintf(exp + exp_len, "%s\"%s\"", i == 0 ? "" : ",", str);
+	exp_len += sprintf(exp + exp_len, "]}");
+
+	rte_tel_data_start_array(&response_data, RTE_TEL_STRING_VAL);
+	for (i = 0; i < RTE_TEL_MAX_ARRAY_ENTRIES; i++)
+		rte_tel_data_add_array_string(&response_data, str);
+
+	/* truncated to whole array entries */
+	if (write(sock, REQUEST_CMD, strlen(REQUEST_CMD)) < 0)
+		goto out;
+	bytes = read(sock, buf, max_len * 8);
+	if (bytes <= 0 || (size_t)bytes > max_len ||
+			memcmp(buf, exp, bytes - 2) != 0 ||
+			memcmp(buf + bytes - 3, "\"]}", 3) != 0) {
+		printf("%s: invalid truncated response of %d bytes\n", __func__, bytes);
+		goto out;
+	}
+
+	if (CHECK_REQUEST("/stream,1",
+			"{\"/stream\":{\"stream\":1,\"max_output_len\":16384}}") != 0)
+		goto out;
+	if (write(sock, REQUEST_CMD, strlen(REQUEST_CMD)) < 0)
+		goto out;
+	do {
+		bytes = read(sock, buf + len, max_len * 8 - len);
+		if (bytes <= 0)
+			goto out;
+		len += bytes;
+	} while ((size_t)bytes == max_len);
+	if (len != exp_len || memcmp(buf, exp, len) != 0) {
+		printf("%s: invalid streamed response of %zu bytes\n", __func__, len);
+		goto out;
+	}
+
+	ret = CHECK_REQUEST("/stream,0",
+			"{\"/stream\":{\"stream\":0,\"max_output_len\":16384}}");
+out:
+	free(buf);
+	free(exp);
+	return ret;
+}
+
 static int
 connect_to_socket(void)
 {
@@ -600,9 +721,13 @@ telemetry_data_autotest(void)
 			test_string_char_escaping,
 			test_array_char_escaping,
 			test_dict_char_escaping,
+			test_batch,
+			test_cache,
+			test_large_output,
 	};
 
 	rte_telemetry_register_cmd(REQUEST_CMD, telemetry_test_cb, "Test");
+	rte_telemetry_register_cmd(CACHED_CMD, telemetry_cached_cb, "Test cache");
 	for (i = 0; i < RTE_DIM(test_cases); i++) {
 		memset(&response_data, 0, sizeof(response_data));
 		if (test_cases[i]() != 0) {
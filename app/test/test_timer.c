@@ -602,3 +602,156 @@ test_timer(void)
 }
 
 REGISTER_FAST_TEST(timer_autotest, false, true, test_timer);
+
+#define WHEEL_NB_TIMER 20000
+
+struct wheel_timer_info {
+	struct rte_timer tim;
+	uint64_t expire;
+	unsigned int count;
+	int early;
+};
+
+static struct wheel_timer_info *wheel_tims;
+static unsigned int wheel_nb_expired;
+
+static void
+timer_wheel_cb(struct rte_timer *tim)
+{
+	struct wheel_timer_info *info = tim->arg;
+
+	if (rte_get_timer_cycles() < info->expire)
+		info->early = 1;
+	info->expire += tim->period;
+	info->count++;
+	wheel_nb_expired++;
+}
+
+static void
+timer_wheel_stop_cb(struct rte_timer *tim __rte_unused, void *arg)
+{
+	(*(unsigned int *)arg)++;
+}
+
+static int
+test_timer_wheel_run(uint32_t data_id)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	uint64_t hz = rte_get_timer_hz();
+	uint64_t ticks, end;
+	unsigned int i, nb_armed = 0, nb_stopped = 0;
+	struct wheel_timer_info *info;
+
+	/* one-shot timers spread over several wheel levels */
+	for (i = 0; i < WHEEL_NB_TIMER; i++) {
+		info = &wheel_tims[i];
+		rte_timer_init(&info->tim);
+		ticks = rte_rand_max(hz / 5);
+		info->expire = rte_get_timer_cycles() + ticks;
+		TEST_ASSERT_SUCCESS(rte_timer_alt_reset(data_id, &info->tim,
+				ticks, SINGLE, lcore_id, NULL, info),
+				"Failed to arm timer %u", i);
+		nb_armed++;
+	}
+
+	/* cancel a third of them, and re-arm another third */
+	for (i = 0; i < WHEEL_NB_TIMER; i += 3) {
+		TEST_ASSERT_SUCCESS(rte_timer_alt_stop(data_id,
+				&wheel_tims[i].tim), "Failed to stop timer %u", i);
+		TEST_ASSERT(!rte_timer_pending(&wheel_tims[i].tim),
+				"Stopped timer %u still pending", i);
+		nb_armed--;
+		nb_stopped++;
+	}
+	for (i = 1; i < WHEEL_NB_TIMER; i += 3) {
+		info = &wheel_tims[i];
+		ticks = rte_rand_max(hz / 10);
+		info->expire = rte_get_timer_cycles() + ticks;
+		TEST_ASSERT_SUCCESS(rte_timer_alt_reset(data_id, &info->tim,
+				ticks, SINGLE, lcore_id, NULL, info),
+				"Failed to re-arm timer %u", i);
+	}
+
+	end = rte_get_timer_cycles() + hz / 2;
+	while (wheel_nb_expired < nb_armed && rte_get_timer_cycles() < end)
+		rte_timer_alt_manage(data_id, NULL, 0, timer_wheel_cb);
+
+	TEST_ASSERT_EQUAL(wheel_nb_expired, nb_armed,
+			"Expired %u timers, expected %u", wheel_nb_expired,
+			nb_armed);
+	for (i = 0; i < WHEEL_NB_TIMER; i++) {
+		info = &wheel_tims[i];
+		TEST_ASSERT_EQUAL(info->count, (i % 3 == 0) ? 0u : 1u,
+				"Timer %u expired %u times", i, info->count);
+		TEST_ASSERT(!info->early, "Timer %u expired early", i);
+		TEST_ASSERT(!rte_timer_pending(&info->tim),
+				"Expired timer %u still pending", i);
+	}
+
+	/* periodic timer */
+	info = &wheel_tims[0];
+	memset(info, 0, sizeof(*info));
+	rte_timer_init(&info->tim);
+	info->expire = rte_get_timer_cycles() + hz / 100;
+	TEST_ASSERT_SUCCESS(rte_timer_alt_reset(data_id, &info->tim, hz / 100,
+			PERIODICAL, lcore_id, NULL, info),
+			"Failed to arm periodic timer");
+	end = rte_get_timer_cycles() + hz / 10;
+	while (rte_get_timer_cycles() < end)
+		rte_timer_alt_manage(data_id, NULL, 0, timer_wheel_cb);
+	TEST_ASSERT(info->count >= 5 && info->count <= 10,
+			"Periodic timer expired %u times", info->count);
+	TEST_ASSERT(!info->early, "Periodic timer expired early");
+	TEST_ASSERT(rte_timer_pending(&info->tim),
+			"Periodic timer not pending");
+
+	/* stop all the remaining timers, including far ones */
+	for (i = 1; i < 100; i++)
+		TEST_ASSERT_SUCCESS(rte_timer_alt_reset(data_id,
+				&wheel_tims[i].tim, hz * i, SINGLE, lcore_id,
+				NULL, &wheel_tims[i]),
+				"Failed to arm timer %u", i);
+	nb_stopped = 0;
+	TEST_ASSERT_SUCCESS(rte_timer_stop_all(data_id, &lcore_id, 1,
+			timer_wheel_stop_cb, &nb_stopped),
+			"Failed to stop all timers");
+	TEST_ASSERT_EQUAL(nb_stopped, 100u, "Stopped %u timers", nb_stopped);
+	for (i = 0; i < 100; i++)
+		TEST_ASSERT(!rte_timer_pending(&wheel_tims[i].tim),
+				"Timer %u still pending", i);
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_timer_wheel(void)
+{
+	struct rte_timer_data_param param = {
+		.backend = RTE_TIMER_BACKEND_WHEEL,
+	};
+	uint32_t data_id;
+	int ret;
+
+	param.backend = (enum rte_timer_backend)-1;
+	TEST_ASSERT_EQUAL(rte_timer_data_alloc_ext(&data_id, &param), -EINVAL,
+			"Invalid backend accepted");
+	param.backend = RTE_TIMER_BACKEND_WHEEL;
+
+	wheel_tims = rte_zmalloc(NULL, sizeof(*wheel_tims) * WHEEL_NB_TIMER, 0);
+	TEST_ASSERT_NOT_NULL(wheel_tims, "Failed to allocate timers");
+	wheel_nb_expired = 0;
+
+	ret = rte_timer_data_alloc_ext(&data_id, &param);
+	if (ret < 0) {
+		rte_free(wheel_tims);
+		TEST_ASSERT_SUCCESS(ret, "Failed to allocate timer wheel");
+	}
+
+	ret = test_timer_wheel_run(data_id);
+
+	rte_timer_data_dealloc(data_id);
+	rte_free(wheel_tims);
+	return ret;
+}
+
+REGISTER_FAST_TEST(timer_wheel_autotest, true, true, test_timer_wheel);
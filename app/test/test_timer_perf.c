@@ -132,3 +132,127 @@ test_timer_perf(void)
 }
 
 REGISTER_PERF_TEST(timer_perf_autotest, test_timer_perf);
+
+static unsigned int backend_nb_expired;
+
+static void
+timer_backend_cb(struct rte_timer *t __rte_unused)
+{
+	backend_nb_expired++;
+}
+
+static void
+print_backend_cycles(const char *what, uint64_t cycles, unsigned int n)
+{
+	printf("  %-28s %8"PRIu64" cycles/timer\n", what, (cycles + n / 2) / n);
+}
+
+/* compare the pending timers backends with n timers on the current lcore */
+static int
+timer_backend_perf(enum rte_timer_backend backend, struct rte_timer *tms,
+		   unsigned int n)
+{
+	struct rte_timer_data_param param = { .backend = backend };
+	unsigned int lcore_id = rte_lcore_id();
+	const uint64_t hz = rte_get_timer_hz();
+	uint64_t start_tsc, end_tsc;
+	uint32_t data_id;
+	unsigned int i;
+	int ret;
+
+	ret = rte_timer_data_alloc_ext(&data_id, &param);
+	if (ret < 0) {
+		printf("Cannot allocate timer data: %d\n", ret);
+		return -1;
+	}
+
+	printf("%s backend, %u timers\n",
+	       backend == RTE_TIMER_BACKEND_WHEEL ? "Wheel" : "Skiplist", n);
+
+	for (i = 0; i < n; i++)
+		rte_timer_init(&tms[i]);
+
+	/* arm timers far enough in the future not to expire meanwhile */
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < n; i++)
+		rte_timer_alt_reset(data_id, &tms[i], hz * 60 + rte_rand_max(hz),
+				    SINGLE, lcore_id, NULL, NULL);
+	end_tsc = rte_rdtsc();
+	print_backend_cycles("arm:", end_tsc - start_tsc, n);
+
+	/* reset: cancel and arm again */
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < n; i++)
+		rte_timer_alt_reset(data_id, &tms[i],
+				    hz * 60 + rte_rand_max(hz * 60),
+				    SINGLE, lcore_id, NULL, NULL);
+	end_tsc = rte_rdtsc();
+	print_backend_cycles("reset:", end_tsc - start_tsc, n);
+
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < 1000; i++)
+		rte_timer_alt_manage(data_id, NULL, 0, timer_backend_cb);
+	end_tsc = rte_rdtsc();
+	printf("  %-28s %8"PRIu64" cycles/call\n", "manage, nothing expired:",
+	       (end_tsc - start_tsc + 500) / 1000);
+
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < n; i++)
+		rte_timer_alt_stop(data_id, &tms[i]);
+	end_tsc = rte_rdtsc();
+	print_backend_cycles("cancel:", end_tsc - start_tsc, n);
+
+	/* expire all timers in a single batch */
+	backend_nb_expired = 0;
+	for (i = 0; i < n; i++)
+		rte_timer_alt_reset(data_id, &tms[i], rte_rand_max(hz / 10),
+				    SINGLE, lcore_id, NULL, NULL);
+	rte_delay_ms(100);
+	start_tsc = rte_rdtsc();
+	rte_timer_alt_manage(data_id, NULL, 0, timer_backend_cb);
+	end_tsc = rte_rdtsc();
+	print_backend_cycles("expire:", end_tsc - start_tsc, n);
+
+	rte_timer_stop_all(data_id, &lcore_id, 1, NULL, NULL);
+	rte_timer_data_dealloc(data_id);
+
+	if (backend_nb_expired != n) {
+		printf("Error: %u timers expired, expected %u\n",
+		       backend_nb_expired, n);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int
+test_timer_backend_perf(void)
+{
+	static const unsigned int nb_timers[] = { 10000, 1000000, 4000000 };
+	struct rte_timer *tms;
+	unsigned int i;
+
+	for (i = 0; i < RTE_DIM(nb_timers); i++) {
+		tms = rte_malloc(NULL, sizeof(*tms) * nb_timers[i], 0);
+		if (tms == NULL) {
+			printf("Cannot allocate %u timers, skipping\n",
+			       nb_timers[i]);
+			continue;
+		}
+
+		if (timer_backend_perf(RTE_TIMER_BACKEND_SKIPLIST, tms,
+				       nb_timers[i]) < 0 ||
+		    timer_backend_perf(RTE_TIMER_BACKEND_WHEEL, tms,
+				       nb_timers[i]) < 0) {
+			rte_free(tms);
+			return -1;
+		}
+		printf("\n");
+
+		rte_free(tms);
+	}
+
+	return 0;
+}
+
+REGISTER_PERF_TEST(timer_backend_perf_autotest, test_timer_backend_perf);
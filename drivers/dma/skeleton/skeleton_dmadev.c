@@ -2,6 +2,7 @@
  * Copyright(c) 2021-2024 HiSilicon Limited
  */
 
+#include <errno.h>
 #include <inttypes.h>
 #include <stdlib.h>
 
@@ -15,6 +16,10 @@
 #include <rte_log.h>
 #include <rte_malloc.h>
 #include <rte_memcpy.h>
+#include <rte_prefetch.h>
+#ifdef RTE_ARCH_X86
+#include <rte_vect.h>
+#endif
 
 #include <rte_dmadev_pmd.h>
 
@@ -58,12 +63,76 @@ skeldma_configure(struct rte_dma_dev *dev, const struct rte_dma_conf *conf,
 	return 0;
 }
 
+/* The pattern is repeated every 8 bytes from the start of dst. */
 static inline void
-do_copy_sg_one(struct rte_dma_sge *src, struct rte_dma_sge *dst, uint16_t nb_dst, uint64_t offset)
+do_fill_cached(uint8_t *dst, uint64_t pattern, size_t len)
+{
+	for (; len >= 8; len -= 8, dst += 8)
+		memcpy(dst, &pattern, 8);
+	memcpy(dst, &pattern, len);
+}
+
+#ifdef RTE_ARCH_X86
+/* Copy with non-temporal stores, for the destination not to evict the cache. */
+static inline void
+do_copy_nt(uint8_t *dst, const uint8_t *src, size_t len)
+{
+	size_t head = RTE_MIN((16 - ((uintptr_t)dst & 15)) & 15, len);
+	__m128i x0, x1, x2, x3;
+
+	rte_memcpy(dst, src, head);
+	dst += head;
+	src += head;
+	len -= head;
+
+	for (; len >= 64; len -= 64, dst += 64, src += 64) {
+		x0 = _mm_loadu_si128((const __m128i *)(src + 0));
+		x1 = _mm_loadu_si128((const __m128i *)(src + 16));
+		x2 = _mm_loadu_si128((const __m128i *)(src + 32));
+		x3 = _mm_loadu_si128((const __m128i *)(src + 48));
+		_mm_stream_si128((__m128i *)(dst + 0), x0);
+		_mm_stream_si128((__m128i *)(dst + 16), x1);
+		_mm_stream_si128((__m128i *)(dst + 32), x2);
+		_mm_stream_si128((__m128i *)(dst + 48), x3);
+	}
+
+	rte_memcpy(dst, src, len);
+}
+
+static inline void
+do_fill_nt(uint8_t *dst, uint64_t pattern, size_t len)
+{
+	__m128i x = _mm_set1_epi64x(pattern);
+
+	for (; len >= 16; len -= 16, dst += 16)
+		_mm_stream_si128((__m128i *)dst, x);
+	do_fill_cached(dst, pattern, len);
+}
+#else
+#define do_copy_nt(dst, src, len) rte_memcpy(dst, src, len)
+#define do_fill_nt(dst, pattern, len) do_fill_cached(dst, pattern, len)
+#endif
+
+/* Returns true if non-temporal stores were used. */
+static inline bool
+do_copy(const struct skeldma_hw *hw, void *dst, const void *src, size_t len)
+{
+	if (hw->nt_threshold != 0 && len >= hw->nt_threshold) {
+		do_copy_nt(dst, src, len);
+		return true;
+	}
+	rte_memcpy(dst, src, len);
+	return false;
+}
+
+static inline bool
+do_copy_sg_one(const struct skeldma_hw *hw, struct rte_dma_sge *src,
+	       struct rte_dma_sge *dst, uint16_t nb_dst, uint64_t offset)
 {
 	uint32_t src_off = 0, dst_off = 0;
 	uint32_t copy_len = 0;
 	uint64_t tmp = 0;
+	bool nt = false;
 	uint16_t i;
 
 	/* Locate the segment from which the copy is started. */
@@ -78,38 +147,57 @@ do_copy_sg_one(struct rte_dma_sge *src, struct rte_dma_sge *dst, uint16_t nb_dst
 
 	for (/* Use the above index */; i < nb_dst; i++, copy_len = dst[i].length) {
 		copy_len = RTE_MIN(copy_len, src->length - src_off);
-		rte_memcpy((uint8_t *)(uintptr_t)dst[i].addr + dst_off,
-			   (uint8_t *)(uintptr_t)src->addr + src_off,
-			   copy_len);
+		nt |= do_copy(hw, (uint8_t *)(uintptr_t)dst[i].addr + dst_off,
+			(uint8_t *)(uintptr_t)src->addr + src_off,
+			copy_len);
 		src_off += copy_len;
 		if (src_off >= src->length)
 			break;
 		dst_off = 0;
 	}
+
+	return nt;
 }
 
-static inline void
-do_copy_sg(struct skeldma_desc *desc)
+static inline bool
+do_copy_sg(const struct skeldma_hw *hw, struct skeldma_desc *desc)
 {
 	uint64_t offset = 0;
+	bool nt = false;
 	uint16_t i;
 
 	for (i = 0; i < desc->copy_sg.nb_src; i++) {
-		do_copy_sg_one(&desc->copy_sg.src[i], desc->copy_sg.dst,
-			       desc->copy_sg.nb_dst, offset);
+		nt |= do_copy_sg_one(hw, &desc->copy_sg.src[i],
+				     desc->copy_sg.dst, desc->copy_sg.nb_dst,
+				     offset);
 		offset += desc->copy_sg.src[i].length;
 	}
+
+	return nt;
 }
 
-static inline void
-do_fill(struct skeldma_desc *desc)
+static inline bool
+do_fill(const struct skeldma_hw *hw, struct skeldma_desc *desc)
 {
 	uint8_t *fills = (uint8_t *)&desc->fill.pattern;
 	uint8_t *dst = (uint8_t *)desc->fill.dst;
-	uint32_t i;
+	size_t len = desc->fill.len;
+	uint64_t pattern;
+	uint32_t i, head;
+
+	if (hw->nt_threshold == 0 || len < hw->nt_threshold) {
+		do_fill_cached(dst, desc->fill.pattern, len);
+		return false;
+	}
 
-	for (i = 0; i < desc->fill.len; i++)
+	/* Align the destination, the pattern starting at the head offset. */
+	head = RTE_MIN((16 - ((uintptr_t)dst & 15)) & 15, len);
+	for (i = 0; i < head; i++)
 		dst[i] = fills[i % 8];
+	for (i = 0; i < 8; i++)
+		((uint8_t *)&pattern)[i] = fills[(head + i) % 8];
+	do_fill_nt(dst + head, pattern, len - head);
+	return true;
 }
 
 static uint32_t
@@ -117,45 +205,72 @@ cpuwork_thread(void *param)
 {
 #define SLEEP_THRESHOLD		10000
 #define SLEEP_US_VAL		10
+#define CPUWORK_BURST		32
 
-	struct rte_dma_dev *dev = param;
-	struct skeldma_hw *hw = dev->data->dev_private;
-	struct skeldma_desc *desc = NULL;
-	int ret;
+	struct skeldma_worker *worker = param;
+	struct skeldma_hw *hw = worker->hw;
+	struct skeldma_desc *descs[CPUWORK_BURST];
+	struct skeldma_desc *desc;
+	unsigned int burst, nb, i;
+	bool nt;
 
 	while (!hw->exit_flag) {
-		ret = rte_ring_dequeue(hw->desc_running, (void **)&desc);
-		if (ret) {
-			hw->zero_req_count++;
-			if (hw->zero_req_count == 0)
-				hw->zero_req_count = SLEEP_THRESHOLD;
-			if (hw->zero_req_count >= SLEEP_THRESHOLD)
+		/* Share the running descriptors between the threads, so that
+		 * a burst of large copies is not serialized on one of them.
+		 */
+		burst = (rte_ring_count(hw->desc_running) + hw->nb_workers - 1) /
+			hw->nb_workers;
+		burst = RTE_MIN(RTE_MAX(burst, 1U), (unsigned int)CPUWORK_BURST);
+		nb = rte_ring_dequeue_burst(hw->desc_running, (void **)descs,
+					    burst, NULL);
+		if (nb == 0) {
+			worker->zero_req_count++;
+			if (worker->zero_req_count == 0)
+				worker->zero_req_count = SLEEP_THRESHOLD;
+			if (worker->zero_req_count >= SLEEP_THRESHOLD)
 				rte_delay_us_sleep(SLEEP_US_VAL);
 			continue;
 		}
-		hw->zero_req_count = 0;
-
-		if (desc->op == SKELDMA_OP_COPY)
-			rte_memcpy(desc->copy.dst, desc->copy.src, desc->copy.len);
-		else if (desc->op == SKELDMA_OP_COPY_SG)
-			do_copy_sg(desc);
-		else if (desc->op == SKELDMA_OP_FILL)
-			do_fill(desc);
+		worker->zero_req_count = 0;
+
+		nt = false;
+		for (i = 0; i < nb; i++) {
+			desc = descs[i];
+			if (i + 1 < nb)
+				rte_prefetch0(descs[i + 1]);
+			if (desc->op == SKELDMA_OP_COPY)
+				nt |= do_copy(hw, desc->copy.dst,
+					      desc->copy.src, desc->copy.len);
+			else if (desc->op == SKELDMA_OP_COPY_SG)
+				nt |= do_copy_sg(hw, desc);
+			else if (desc->op == SKELDMA_OP_FILL)
+				nt |= do_fill(hw, desc);
+		}
 
-		rte_atomic_fetch_add_explicit(&hw->completed_count, 1, rte_memory_order_release);
-		(void)rte_ring_enqueue(hw->desc_completed, (void *)desc);
+		/* Order the non-temporal stores before the completions. */
+		if (nt)
+			rte_wmb();
+		for (i = 0; i < nb; i++)
+			rte_atomic_store_explicit(&descs[i]->done, 1,
+						  rte_memory_order_release);
+		rte_atomic_fetch_add_explicit(&hw->completed_count, nb,
+					      rte_memory_order_release);
 	}
 
 	return 0;
 }
 
 static void
-fflush_ring(struct skeldma_hw *hw, struct rte_ring *ring)
+stop_workers(struct skeldma_hw *hw, uint16_t nb_workers)
 {
-	struct skeldma_desc *desc = NULL;
-	while (rte_ring_count(ring) > 0) {
-		(void)rte_ring_dequeue(ring, (void **)&desc);
-		(void)rte_ring_enqueue(hw->desc_empty, (void *)desc);
+	uint16_t i;
+
+	hw->exit_flag = true;
+	rte_delay_ms(1);
+
+	for (i = 0; i < nb_workers; i++) {
+		(void)pthread_cancel((pthread_t)hw->workers[i].thread.opaque_id);
+		rte_thread_join(hw->workers[i].thread, NULL);
 	}
 }
 
@@ -164,7 +279,9 @@ skeldma_start(struct rte_dma_dev *dev)
 {
 	struct skeldma_hw *hw = dev->data->dev_private;
 	char name[RTE_THREAD_INTERNAL_NAME_SIZE];
+	struct skeldma_worker *worker;
 	rte_cpuset_t cpuset;
+	uint16_t i;
 	int ret;
 
 	if (hw->desc_mem == NULL) {
@@ -173,38 +290,44 @@ skeldma_start(struct rte_dma_dev *dev)
 	}
 
 	/* Reset the dmadev to a known state, include:
-	 * 1) fflush pending/running/completed ring to empty ring.
+	 * 1) drop the pending and running descriptors.
 	 * 2) init ring idx to zero.
 	 * 3) init running statistics.
-	 * 4) mark cpuwork task exit_flag to false.
+	 * 4) mark cpuwork tasks exit_flag to false.
 	 */
-	fflush_ring(hw, hw->desc_pending);
-	fflush_ring(hw, hw->desc_running);
-	fflush_ring(hw, hw->desc_completed);
+	rte_ring_reset(hw->desc_running);
 	hw->ridx = 0;
+	hw->submit_ridx = 0;
 	hw->last_ridx = hw->ridx - 1;
 	hw->submitted_count = 0;
-	hw->zero_req_count = 0;
 	hw->completed_count = 0;
 	hw->exit_flag = false;
+	for (i = 0; i < hw->nb_workers; i++)
+		hw->workers[i].zero_req_count = 0;
 
 	rte_mb();
 
-	snprintf(name, sizeof(name), "dma-skel%d", dev->data->dev_id);
-	ret = rte_thread_create_internal_control(&hw->thread, name,
-			cpuwork_thread, dev);
-	if (ret) {
-		SKELDMA_LOG(ERR, "Start cpuwork thread fail!");
-		return -EINVAL;
-	}
+	for (i = 0; i < hw->nb_workers; i++) {
+		worker = &hw->workers[i];
+		snprintf(name, sizeof(name), "dmask%d-%u",
+			 dev->data->dev_id, i);
+		ret = rte_thread_create_internal_control(&worker->thread, name,
+				cpuwork_thread, worker);
+		if (ret) {
+			SKELDMA_LOG(ERR, "Start cpuwork thread %u fail!", i);
+			stop_workers(hw, i);
+			return -EINVAL;
+		}
 
-	if (hw->lcore_id != -1) {
-		cpuset = rte_lcore_cpuset(hw->lcore_id);
-		ret = rte_thread_set_affinity_by_id(hw->thread, &cpuset);
-		if (ret)
-			SKELDMA_LOG(WARNING,
-				"Set thread affinity lcore = %d fail!",
-				hw->lcore_id);
+		if (worker->lcore_id != -1) {
+			cpuset = rte_lcore_cpuset(worker->lcore_id);
+			ret = rte_thread_set_affinity_by_id(worker->thread,
+							    &cpuset);
+			if (ret)
+				SKELDMA_LOG(WARNING,
+					"Set thread affinity lcore = %d fail!",
+					worker->lcore_id);
+		}
 	}
 
 	return 0;
@@ -215,11 +338,7 @@ skeldma_stop(struct rte_dma_dev *dev)
 {
 	struct skeldma_hw *hw = dev->data->dev_private;
 
-	hw->exit_flag = true;
-	rte_delay_ms(1);
-
-	(void)pthread_cancel((pthread_t)hw->thread.opaque_id);
-	rte_thread_join(hw->thread, NULL);
+	stop_workers(hw, hw->nb_workers);
 
 	return 0;
 }
@@ -229,11 +348,8 @@ vchan_setup(struct skeldma_hw *hw, int16_t dev_id, uint16_t nb_desc)
 {
 	char name[RTE_RING_NAMESIZE];
 	struct skeldma_desc *desc;
-	struct rte_ring *empty;
-	struct rte_ring *pending;
 	struct rte_ring *running;
-	struct rte_ring *completed;
-	uint16_t i;
+	unsigned int flags;
 
 	desc = rte_zmalloc_socket(NULL, nb_desc * sizeof(struct skeldma_desc),
 				  RTE_CACHE_LINE_SIZE, hw->socket_id);
@@ -242,41 +358,21 @@ vchan_setup(struct skeldma_hw *hw, int16_t dev_id, uint16_t nb_desc)
 		return -ENOMEM;
 	}
 
-	snprintf(name, RTE_RING_NAMESIZE, "dma_skel_desc_empty_%d", dev_id);
-	empty = rte_ring_create(name, nb_desc, hw->socket_id,
-				RING_F_SP_ENQ | RING_F_SC_DEQ);
-	snprintf(name, RTE_RING_NAMESIZE, "dma_skel_desc_pend_%d", dev_id);
-	pending = rte_ring_create(name, nb_desc, hw->socket_id,
-				  RING_F_SP_ENQ | RING_F_SC_DEQ);
+	flags = RING_F_SP_ENQ;
+	if (hw->nb_workers == 1)
+		flags |= RING_F_SC_DEQ;
 	snprintf(name, RTE_RING_NAMESIZE, "dma_skel_desc_run_%d", dev_id);
-	running = rte_ring_create(name, nb_desc, hw->socket_id,
-				  RING_F_SP_ENQ | RING_F_SC_DEQ);
-	snprintf(name, RTE_RING_NAMESIZE, "dma_skel_desc_comp_%d", dev_id);
-	completed = rte_ring_create(name, nb_desc, hw->socket_id,
-				    RING_F_SP_ENQ | RING_F_SC_DEQ);
-	if (empty == NULL || pending == NULL || running == NULL ||
-	    completed == NULL) {
+	running = rte_ring_create(name, nb_desc, hw->socket_id, flags);
+	if (running == NULL) {
 		SKELDMA_LOG(ERR, "Create dma skeleton desc ring fail!");
-		rte_ring_free(empty);
-		rte_ring_free(pending);
-		rte_ring_free(running);
-		rte_ring_free(completed);
 		rte_free(desc);
 		return -ENOMEM;
 	}
 
-	/* The real usable ring size is *count-1* instead of *count* to
-	 * differentiate a free ring from an empty ring.
-	 * @see rte_ring_create
-	 */
-	for (i = 0; i < nb_desc - 1; i++)
-		(void)rte_ring_enqueue(empty, (void *)(desc + i));
-
 	hw->desc_mem = desc;
-	hw->desc_empty = empty;
-	hw->desc_pending = pending;
+	hw->nb_desc = nb_desc;
+	hw->desc_mask = nb_desc - 1;
 	hw->desc_running = running;
-	hw->desc_completed = completed;
 
 	return 0;
 }
@@ -289,14 +385,8 @@ vchan_release(struct skeldma_hw *hw)
 
 	rte_free(hw->desc_mem);
 	hw->desc_mem = NULL;
-	rte_ring_free(hw->desc_empty);
-	hw->desc_empty = NULL;
-	rte_ring_free(hw->desc_pending);
-	hw->desc_pending = NULL;
 	rte_ring_free(hw->desc_running);
 	hw->desc_running = NULL;
-	rte_ring_free(hw->desc_completed);
-	hw->desc_completed = NULL;
 }
 
 static int
@@ -331,14 +421,22 @@ skeldma_vchan_status(const struct rte_dma_dev *dev,
 		uint16_t vchan, enum rte_dma_vchan_status *status)
 {
 	struct skeldma_hw *hw = dev->data->dev_private;
+	uint16_t i;
 
 	RTE_SET_USED(vchan);
 
 	*status = RTE_DMA_VCHAN_IDLE;
 	if (hw->submitted_count != rte_atomic_load_explicit(&hw->completed_count,
-			rte_memory_order_acquire)
-			|| hw->zero_req_count == 0)
+			rte_memory_order_acquire)) {
 		*status = RTE_DMA_VCHAN_ACTIVE;
+		return 0;
+	}
+	for (i = 0; i < hw->nb_workers; i++) {
+		if (hw->workers[i].zero_req_count == 0) {
+			*status = RTE_DMA_VCHAN_ACTIVE;
+			break;
+		}
+	}
 	return 0;
 }
 
@@ -377,19 +475,23 @@ skeldma_dump(const struct rte_dma_dev *dev, FILE *f)
 #define GET_RING_COUNT(ring)	((ring) ? (rte_ring_count(ring)) : 0)
 
 	struct skeldma_hw *hw = dev->data->dev_private;
+	uint16_t i;
 
 	(void)fprintf(f,
-		"    lcore_id: %d\n"
 		"    socket_id: %d\n"
-		"    desc_empty_ring_count: %u\n"
-		"    desc_pending_ring_count: %u\n"
-		"    desc_running_ring_count: %u\n"
-		"    desc_completed_ring_count: %u\n",
-		hw->lcore_id, hw->socket_id,
-		GET_RING_COUNT(hw->desc_empty),
-		GET_RING_COUNT(hw->desc_pending),
-		GET_RING_COUNT(hw->desc_running),
-		GET_RING_COUNT(hw->desc_completed));
+		"    nt_threshold: %u\n"
+		"    workers: %u\n",
+		hw->socket_id, hw->nt_threshold, hw->nb_workers);
+	for (i = 0; i < hw->nb_workers; i++)
+		(void)fprintf(f, "      worker %u lcore_id: %d\n",
+			i, hw->workers[i].lcore_id);
+	(void)fprintf(f,
+		"    nb_desc: %u\n"
+		"    desc_pending_count: %u\n"
+		"    desc_running_ring_count: %u\n",
+		hw->nb_desc,
+		(uint16_t)(hw->ridx - hw->submit_ridx),
+		GET_RING_COUNT(hw->desc_running));
 	(void)fprintf(f,
 		"    next_ring_idx: %u\n"
 		"    last_ring_idx: %u\n"
@@ -402,19 +504,56 @@ skeldma_dump(const struct rte_dma_dev *dev, FILE *f)
 }
 
 static inline void
-submit(struct skeldma_hw *hw, struct skeldma_desc *desc)
+submit(struct skeldma_hw *hw)
 {
-	uint16_t count = rte_ring_count(hw->desc_pending);
-	struct skeldma_desc *pend_desc = NULL;
+#define SUBMIT_BURST	32
+
+	struct skeldma_desc *descs[SUBMIT_BURST];
+	uint16_t count = hw->ridx - hw->submit_ridx;
+	uint16_t nb, i;
 
 	while (count > 0) {
-		(void)rte_ring_dequeue(hw->desc_pending, (void **)&pend_desc);
-		(void)rte_ring_enqueue(hw->desc_running, (void *)pend_desc);
-		count--;
+		nb = RTE_MIN(count, (uint16_t)SUBMIT_BURST);
+		for (i = 0; i < nb; i++)
+			descs[i] = &hw->desc_mem[(hw->submit_ridx + i) &
+						 hw->desc_mask];
+		/* The running ring cannot be full, it has room for all the
+		 * descriptors not completed.
+		 */
+		(void)rte_ring_enqueue_bulk(hw->desc_running, (void **)descs,
+					    nb, NULL);
+		hw->submit_ridx += nb;
+		count -= nb;
 	}
+}
+
+static inline struct skeldma_desc *
+desc_get(struct skeldma_hw *hw, enum skeldma_op op)
+{
+	struct skeldma_desc *desc;
+
+	/* As with a ring, one descriptor is kept unused, so that the ring
+	 * idx of the next descriptor differs from the last completed one.
+	 */
+	if (unlikely((uint16_t)(hw->ridx - hw->last_ridx) >= hw->nb_desc))
+		return NULL;
+
+	desc = &hw->desc_mem[hw->ridx & hw->desc_mask];
+	desc->op = op;
+	desc->ridx = hw->ridx;
+	desc->done = 0;
+	return desc;
+}
 
-	if (desc)
-		(void)rte_ring_enqueue(hw->desc_running, (void *)desc);
+static inline int
+desc_put(struct skeldma_hw *hw, uint64_t flags)
+{
+	hw->submitted_count++;
+	hw->ridx++;
+	if (flags & RTE_DMA_OP_FLAG_SUBMIT)
+		submit(hw);
+
+	return (uint16_t)(hw->ridx - 1);
 }
 
 static int
@@ -424,26 +563,17 @@ skeldma_copy(void *dev_private, uint16_t vchan,
 {
 	struct skeldma_hw *hw = dev_private;
 	struct skeldma_desc *desc;
-	int ret;
 
 	RTE_SET_USED(vchan);
-	RTE_SET_USED(flags);
 
-	ret = rte_ring_dequeue(hw->desc_empty, (void **)&desc);
-	if (ret)
+	desc = desc_get(hw, SKELDMA_OP_COPY);
+	if (desc == NULL)
 		return -ENOSPC;
-	desc->op = SKELDMA_OP_COPY;
-	desc->ridx = hw->ridx;
 	desc->copy.src = (void *)(uintptr_t)src;
 	desc->copy.dst = (void *)(uintptr_t)dst;
 	desc->copy.len = length;
-	if (flags & RTE_DMA_OP_FLAG_SUBMIT)
-		submit(hw, desc);
-	else
-		(void)rte_ring_enqueue(hw->desc_pending, (void *)desc);
-	hw->submitted_count++;
 
-	return hw->ridx++;
+	return desc_put(hw, flags);
 }
 
 static int
@@ -455,26 +585,18 @@ skeldma_copy_sg(void *dev_private, uint16_t vchan,
 {
 	struct skeldma_hw *hw = dev_private;
 	struct skeldma_desc *desc;
-	int ret;
 
 	RTE_SET_USED(vchan);
 
-	ret = rte_ring_dequeue(hw->desc_empty, (void **)&desc);
-	if (ret)
+	desc = desc_get(hw, SKELDMA_OP_COPY_SG);
+	if (desc == NULL)
 		return -ENOSPC;
-	desc->op = SKELDMA_OP_COPY_SG;
-	desc->ridx = hw->ridx;
 	memcpy(desc->copy_sg.src, src, sizeof(*src) * nb_src);
 	memcpy(desc->copy_sg.dst, dst, sizeof(*dst) * nb_dst);
 	desc->copy_sg.nb_src = nb_src;
 	desc->copy_sg.nb_dst = nb_dst;
-	if (flags & RTE_DMA_OP_FLAG_SUBMIT)
-		submit(hw, desc);
-	else
-		(void)rte_ring_enqueue(hw->desc_pending, (void *)desc);
-	hw->submitted_count++;
 
-	return hw->ridx++;
+	return desc_put(hw, flags);
 }
 
 static int
@@ -484,25 +606,17 @@ skeldma_fill(void *dev_private, uint16_t vchan,
 {
 	struct skeldma_hw *hw = dev_private;
 	struct skeldma_desc *desc;
-	int ret;
 
 	RTE_SET_USED(vchan);
 
-	ret = rte_ring_dequeue(hw->desc_empty, (void **)&desc);
-	if (ret)
+	desc = desc_get(hw, SKELDMA_OP_FILL);
+	if (desc == NULL)
 		return -ENOSPC;
-	desc->op = SKELDMA_OP_FILL;
-	desc->ridx = hw->ridx;
 	desc->fill.dst = (void *)(uintptr_t)dst;
 	desc->fill.len = length;
 	desc->fill.pattern = pattern;
-	if (flags & RTE_DMA_OP_FLAG_SUBMIT)
-		submit(hw, desc);
-	else
-		(void)rte_ring_enqueue(hw->desc_pending, (void *)desc);
-	hw->submitted_count++;
 
-	return hw->ridx++;
+	return desc_put(hw, flags);
 }
 
 static int
@@ -510,35 +624,41 @@ skeldma_submit(void *dev_private, uint16_t vchan)
 {
 	struct skeldma_hw *hw = dev_private;
 	RTE_SET_USED(vchan);
-	submit(hw, NULL);
+	submit(hw);
 	return 0;
 }
 
+/* Count the completed descriptors, in ring idx order. */
+static inline uint16_t
+completed_count(struct skeldma_hw *hw, uint16_t nb_cpls)
+{
+	uint16_t ridx = hw->last_ridx + 1;
+	uint16_t count = 0;
+
+	while (count < nb_cpls && ridx != hw->submit_ridx &&
+	       rte_atomic_load_explicit(&hw->desc_mem[ridx & hw->desc_mask].done,
+					rte_memory_order_acquire)) {
+		count++;
+		ridx++;
+	}
+
+	return count;
+}
+
 static uint16_t
 skeldma_completed(void *dev_private,
 		  uint16_t vchan, const uint16_t nb_cpls,
 		  uint16_t *last_idx, bool *has_error)
 {
 	struct skeldma_hw *hw = dev_private;
-	struct skeldma_desc *desc = NULL;
-	uint16_t index = 0;
 	uint16_t count;
 
 	RTE_SET_USED(vchan);
 	RTE_SET_USED(has_error);
 
-	count = RTE_MIN(nb_cpls, rte_ring_count(hw->desc_completed));
-	while (index < count) {
-		(void)rte_ring_dequeue(hw->desc_completed, (void **)&desc);
-		if (index == count - 1) {
-			hw->last_ridx = desc->ridx;
-			*last_idx = desc->ridx;
-		}
-		index++;
-		(void)rte_ring_enqueue(hw->desc_empty, (void *)desc);
-	}
-	if (unlikely(count == 0))
-		*last_idx = hw->last_ridx;
+	count = completed_count(hw, nb_cpls);
+	hw->last_ridx += count;
+	*last_idx = hw->last_ridx;
 
 	return count;
 }
@@ -549,24 +669,16 @@ skeldma_completed_status(void *dev_private,
 			 uint16_t *last_idx, enum rte_dma_status_code *status)
 {
 	struct skeldma_hw *hw = dev_private;
-	struct skeldma_desc *desc = NULL;
-	uint16_t index = 0;
+	uint16_t index;
 	uint16_t count;
 
 	RTE_SET_USED(vchan);
 
-	count = RTE_MIN(nb_cpls, rte_ring_count(hw->desc_completed));
-	while (index < count) {
-		(void)rte_ring_dequeue(hw->desc_completed, (void **)&desc);
-		if (index == count - 1) {
-			hw->last_ridx = desc->ridx;
-			*last_idx = desc->ridx;
-		}
-		status[index++] = RTE_DMA_STATUS_SUCCESSFUL;
-		(void)rte_ring_enqueue(hw->desc_empty, (void *)desc);
-	}
-	if (unlikely(count == 0))
-		*last_idx = hw->last_ridx;
+	count = completed_count(hw, nb_cpls);
+	for (index = 0; index < count; index++)
+		status[index] = RTE_DMA_STATUS_SUCCESSFUL;
+	hw->last_ridx += count;
+	*last_idx = hw->last_ridx;
 
 	return count;
 }
@@ -577,7 +689,7 @@ skeldma_burst_capacity(const void *dev_private, uint16_t vchan)
 	const struct skeldma_hw *hw = dev_private;
 
 	RTE_SET_USED(vchan);
-	return rte_ring_count(hw->desc_empty);
+	return hw->nb_desc - (uint16_t)(hw->ridx - hw->last_ridx);
 }
 
 static const struct rte_dma_dev_ops skeldma_ops = {
@@ -596,15 +708,24 @@ static const struct rte_dma_dev_ops skeldma_ops = {
 	.dev_dump         = skeldma_dump,
 };
 
+struct skeldma_args {
+	int lcore_ids[SKELDMA_MAX_THREADS];
+	uint16_t nb_lcores;
+	uint16_t nb_workers;
+	uint32_t nt_threshold;
+};
+
 static int
-skeldma_create(const char *name, struct rte_vdev_device *vdev, int lcore_id)
+skeldma_create(const char *name, struct rte_vdev_device *vdev,
+	       const struct skeldma_args *args)
 {
 	struct rte_dma_dev *dev;
 	struct skeldma_hw *hw;
 	int socket_id;
+	uint16_t i;
 
-	socket_id = (lcore_id < 0) ? rte_socket_id() :
-				     rte_lcore_to_socket_id(lcore_id);
+	socket_id = (args->nb_lcores == 0) ? rte_socket_id() :
+				rte_lcore_to_socket_id(args->lcore_ids[0]);
 	dev = rte_dma_pmd_allocate(name, socket_id, sizeof(struct skeldma_hw));
 	if (dev == NULL) {
 		SKELDMA_LOG(ERR, "Unable to allocate dmadev: %s", name);
@@ -623,8 +744,14 @@ skeldma_create(const char *name, struct rte_vdev_device *vdev, int lcore_id)
 	dev->fp_obj->burst_capacity = skeldma_burst_capacity;
 
 	hw = dev->data->dev_private;
-	hw->lcore_id = lcore_id;
 	hw->socket_id = socket_id;
+	hw->nb_workers = args->nb_workers;
+	hw->nt_threshold = args->nt_threshold;
+	for (i = 0; i < hw->nb_workers; i++) {
+		hw->workers[i].hw = hw;
+		hw->workers[i].lcore_id = (i < args->nb_lcores) ?
+					  args->lcore_ids[i] : -1;
+	}
 
 	dev->state = RTE_DMA_DEV_READY;
 
@@ -642,49 +769,120 @@ skeldma_parse_lcore(const char *key __rte_unused,
 		    const char *value,
 		    void *opaque)
 {
+	struct skeldma_args *args = opaque;
 	int lcore_id;
 
 	if (value == NULL || opaque == NULL)
 		return -EINVAL;
 
+	/* Each lcore argument is the affinity of the next cpuwork thread. */
 	lcore_id = atoi(value);
-	if (lcore_id >= 0 && lcore_id < RTE_MAX_LCORE)
-		*(int *)opaque = lcore_id;
+	if (lcore_id >= 0 && lcore_id < RTE_MAX_LCORE &&
+	    args->nb_lcores < SKELDMA_MAX_THREADS)
+		args->lcore_ids[args->nb_lcores++] = lcore_id;
 
 	return 0;
 }
 
-static void
-skeldma_parse_vdev_args(struct rte_vdev_device *vdev, int *lcore_id)
+static int
+skeldma_parse_threads(const char *key __rte_unused,
+		      const char *value,
+		      void *opaque)
 {
-	static const char *const args[] = {
+	int threads;
+
+	if (value == NULL || opaque == NULL)
+		return -EINVAL;
+
+	threads = atoi(value);
+	if (threads < 1 || threads > SKELDMA_MAX_THREADS) {
+		SKELDMA_LOG(ERR, "Invalid threads %s, must be in [1, %d]",
+			value, SKELDMA_MAX_THREADS);
+		return -EINVAL;
+	}
+	*(uint16_t *)opaque = threads;
+
+	return 0;
+}
+
+static int
+skeldma_parse_nt_threshold(const char *key __rte_unused,
+			   const char *value,
+			   void *opaque)
+{
+	char *end;
+	unsigned long val;
+
+	if (value == NULL || opaque == NULL)
+		return -EINVAL;
+
+	errno = 0;
+	val = strtoul(value, &end, 0);
+	if (errno != 0 || *end != '\0' || val > UINT32_MAX) {
+		SKELDMA_LOG(ERR, "Invalid nt_threshold %s", value);
+		return -EINVAL;
+	}
+	*(uint32_t *)opaque = val;
+
+	return 0;
+}
+
+static int
+skeldma_parse_vdev_args(struct rte_vdev_device *vdev,
+			struct skeldma_args *args)
+{
+	static const char *const valid_args[] = {
 		SKELDMA_ARG_LCORE,
+		SKELDMA_ARG_THREADS,
+		SKELDMA_ARG_NT_THRESHOLD,
 		NULL
 	};
 
 	struct rte_kvargs *kvlist;
 	const char *params;
+	int ret;
 
 	params = rte_vdev_device_args(vdev);
 	if (params == NULL || params[0] == '\0')
-		return;
+		goto out;
 
-	kvlist = rte_kvargs_parse(params, args);
+	kvlist = rte_kvargs_parse(params, valid_args);
 	if (!kvlist)
-		return;
+		goto out;
 
 	(void)rte_kvargs_process(kvlist, SKELDMA_ARG_LCORE,
-				 skeldma_parse_lcore, lcore_id);
-	SKELDMA_LOG(INFO, "Parse lcore_id = %d", *lcore_id);
-
+				 skeldma_parse_lcore, args);
+	ret = rte_kvargs_process(kvlist, SKELDMA_ARG_THREADS,
+				 skeldma_parse_threads, &args->nb_workers);
+	if (ret == 0)
+		ret = rte_kvargs_process(kvlist, SKELDMA_ARG_NT_THRESHOLD,
+					 skeldma_parse_nt_threshold,
+					 &args->nt_threshold);
 	rte_kvargs_free(kvlist);
+	if (ret < 0)
+		return ret;
+
+out:
+	/* Without the threads argument, a thread per lcore argument. */
+	if (args->nb_workers == 0)
+		args->nb_workers = RTE_MAX(args->nb_lcores, 1);
+	if (args->nb_lcores > args->nb_workers)
+		SKELDMA_LOG(WARNING, "Ignore lcores of threads after %u",
+			args->nb_workers);
+	SKELDMA_LOG(INFO, "Parse lcore_id = %d, threads = %u, nt_threshold = %u",
+		args->nb_lcores ? args->lcore_ids[0] : -1,
+		args->nb_workers, args->nt_threshold);
+
+	return 0;
 }
 
 static int
 skeldma_probe(struct rte_vdev_device *vdev)
 {
+	struct skeldma_args args = {
+		.nt_threshold = SKELDMA_DFLT_NT_THRESHOLD,
+	};
 	const char *name;
-	int lcore_id = -1;
 	int ret;
 
 	name = rte_vdev_device_name(vdev);
@@ -696,12 +894,14 @@ skeldma_probe(struct rte_vdev_device *vdev)
 		return -EINVAL;
 	}
 
-	skeldma_parse_vdev_args(vdev, &lcore_id);
+	ret = skeldma_parse_vdev_args(vdev, &args);
+	if (ret < 0)
+		return ret;
 
-	ret = skeldma_create(name, vdev, lcore_id);
+	ret = skeldma_create(name, vdev, &args);
 	if (ret >= 0)
-		SKELDMA_LOG(INFO, "Create %s dmadev with lcore-id %d",
-			name, lcore_id);
+		SKELDMA_LOG(INFO, "Create %s dmadev with %u cpuwork threads",
+			name, args.nb_workers);
 
 	return ret < 0 ? ret : 0;
 }
@@ -731,4 +931,6 @@ static struct rte_vdev_driver skeldma_pmd_drv = {
 
 RTE_PMD_REGISTER_VDEV(dma_skeleton, skeldma_pmd_drv);
 RTE_PMD_REGISTER_PARAM_STRING(dma_skeleton,
-		SKELDMA_ARG_LCORE "=<uint16> ");
+		SKELDMA_ARG_LCORE "=<uint16> "
+		SKELDMA_ARG_THREADS "=<uint16> "
+		SKELDMA_ARG_NT_THRESHOLD "=<uint32> ");
@@ -10,6 +10,12 @@
 #include <rte_thread.h>
 
 #define SKELDMA_ARG_LCORE	"lcore"
+#define SKELDMA_ARG_THREADS	"threads"
+#define SKELDMA_ARG_NT_THRESHOLD	"nt_threshold"
+
+#define SKELDMA_MAX_THREADS	16
+/* Copies of at least this size bypass the cache by default */
+#define SKELDMA_DFLT_NT_THRESHOLD	(256 * 1024)
 
 #define SKELDMA_MAX_SGES	4
 
@@ -22,6 +28,7 @@ enum skeldma_op {
 struct skeldma_desc {
 	enum skeldma_op op;
 	uint16_t ridx; /* ring idx */
+	RTE_ATOMIC(uint16_t) done; /* set by the cpuwork thread */
 
 	union {
 		struct {
@@ -43,44 +50,52 @@ struct skeldma_desc {
 	};
 };
 
-struct skeldma_hw {
+struct skeldma_hw;
+
+struct __rte_cache_aligned skeldma_worker {
+	struct skeldma_hw *hw;
 	int lcore_id; /* cpuwork task affinity core */
-	int socket_id;
 	rte_thread_t thread; /* cpuwork task thread */
-	volatile int exit_flag; /* cpuwork task exit flag */
+	volatile uint32_t zero_req_count;
+};
 
-	struct skeldma_desc *desc_mem;
+struct skeldma_hw {
+	int socket_id;
+	uint16_t nb_workers;
+	uint32_t nt_threshold; /* min length of non-temporal copies, 0 if none */
+	volatile int exit_flag; /* cpuwork tasks exit flag */
+	struct skeldma_worker workers[SKELDMA_MAX_THREADS];
 
-	/* Descriptor ring state machine:
+	/* Descriptors are used in ring idx order, the descriptor of ring idx
+	 * *ridx* being desc_mem[ridx & desc_mask].
 	 *
-	 *  -----------     enqueue without submit     -----------
-	 *  |  empty  |------------------------------->| pending |
-	 *  -----------\                               -----------
-	 *       ^      \------------                       |
-	 *       |                  |                       |submit doorbell
-	 *       |                  |                       |
-	 *       |                  |enqueue with submit    |
-	 *       |get completed     |------------------|    |
-	 *       |                                     |    |
-	 *       |                                     v    v
-	 *  -----------     cpuwork thread working     -----------
-	 *  |completed|<-------------------------------| running |
-	 *  -----------                                -----------
+	 *            enqueue            submit doorbell
+	 *  -------------------> pending ------------------> desc_running
+	 *                                                        |
+	 *                                   cpuwork threads     |
+	 *  <------------------- done <---------------------------
+	 *      get completed
+	 *
+	 * Enqueued descriptors stay pending until submitted to the running
+	 * ring, from which the cpuwork threads dequeue them by bursts.
+	 * The threads may finish them out of order, so the completions are
+	 * reported in ring idx order by checking the done flag of the oldest
+	 * descriptor not completed yet.
 	 */
-	struct rte_ring *desc_empty;
-	struct rte_ring *desc_pending;
+	struct skeldma_desc *desc_mem;
+	uint16_t nb_desc;
+	uint16_t desc_mask;
 	struct rte_ring *desc_running;
-	struct rte_ring *desc_completed;
 
 	/* Cache delimiter for dataplane API's operation data */
 	alignas(RTE_CACHE_LINE_SIZE) char cache1;
 	uint16_t ridx;  /* ring idx */
+	uint16_t submit_ridx; /* first ring idx not submitted */
 	uint16_t last_ridx;
 	uint64_t submitted_count;
 
-	/* Cache delimiter for cpuwork thread's operation data */
+	/* Cache delimiter for cpuwork threads' operation data */
 	alignas(RTE_CACHE_LINE_SIZE) char cache2;
-	volatile uint32_t zero_req_count;
 	RTE_ATOMIC(uint64_t) completed_count;
 };
 
@@ -24,10 +24,14 @@
 #define MIN_BURST_SIZE_ARG "min_burst"
 #define DEQ_BURST_SIZE_ARG "deq_burst"
 #define REFIL_ONCE_ARG "refill_once"
+#define SCHED_SHARDS_ARG "sched_shards"
 
 static void
 sw_info_get(struct rte_eventdev *dev, struct rte_event_dev_info *info);
 
+static void
+sw_port_release(void *port);
+
 static int
 sw_port_link(struct rte_eventdev *dev, void *port, const uint8_t queues[],
 		const uint8_t priorities[], uint16_t num)
@@ -114,12 +118,15 @@ sw_port_unlink(struct rte_eventdev *dev, void *port, uint8_t queues[],
 				if (q->type == RTE_SCHED_TYPE_ORDERED)
 					p->num_ordered_qids--;
 
+				/* to be acked by the shard of the queue */
+				sw_shard_port(sw, q->shard,
+						p->id)->unlinks_in_progress++;
+
 				continue;
 			}
 		}
 	}
 
-	p->unlinks_in_progress += unlinked;
 	rte_smp_mb();
 
 	return unlinked;
@@ -128,9 +135,59 @@ sw_port_unlink(struct rte_eventdev *dev, void *port, uint8_t queues[],
 static int
 sw_port_unlinks_in_progress(struct rte_eventdev *dev, void *port)
 {
-	RTE_SET_USED(dev);
+	struct sw_evdev *sw = sw_pmd_priv(dev);
 	struct sw_port *p = port;
-	return p->unlinks_in_progress;
+	unsigned int i;
+	int unlinks = 0;
+
+	for (i = 0; i < sw->nb_shards; i++)
+		unlinks += sw_shard_port(sw, i, p->id)->unlinks_in_progress;
+	return unlinks;
+}
+
+/* Set up the instance of a port in a shard other than the first one */
+static int
+sw_shard_port_setup(struct rte_eventdev *dev, unsigned int shard,
+		uint8_t port_id, const struct rte_event_port_conf *conf)
+{
+	struct sw_evdev *sw = sw_pmd_priv(dev);
+	struct sw_port *p = sw_shard_port(sw, shard, port_id);
+	char buf[RTE_RING_NAMESIZE];
+	unsigned int i;
+
+	*p = (struct sw_port){0}; /* zero entire structure */
+	p->id = port_id;
+	p->sw = sw;
+
+	snprintf(buf, sizeof(buf), "sw%d_s%u_p%u_rx", dev->data->dev_id,
+			shard, port_id);
+	rte_event_ring_free(rte_event_ring_lookup(buf));
+	p->rx_worker_ring = rte_event_ring_create(buf, MAX_SW_PROD_Q_DEPTH,
+			dev->data->socket_id,
+			RING_F_SP_ENQ | RING_F_SC_DEQ | RING_F_EXACT_SZ);
+
+	snprintf(buf, sizeof(buf), "sw%d_s%u_p%u_cq", dev->data->dev_id,
+			shard, port_id);
+	rte_event_ring_free(rte_event_ring_lookup(buf));
+	p->cq_worker_ring = rte_event_ring_create(buf, conf->dequeue_depth,
+			dev->data->socket_id,
+			RING_F_SP_ENQ | RING_F_SC_DEQ | RING_F_EXACT_SZ);
+
+	if (p->rx_worker_ring == NULL || p->cq_worker_ring == NULL) {
+		SW_LOG_ERR("Error creating rings for port %d in shard %u",
+				port_id, shard);
+		return -1;
+	}
+	sw->shards[shard].cq_ring_space[port_id] = conf->dequeue_depth;
+
+	/* set hist list contents to empty */
+	for (i = 0; i < SW_PORT_HIST_LIST; i++) {
+		p->hist_list[i].fid = -1;
+		p->hist_list[i].qid = -1;
+	}
+
+	p->initialized = 1;
+	return 0;
 }
 
 static int
@@ -152,10 +209,14 @@ sw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 		 * available in the port (p->inflight_credits). We must return
 		 * the sum to no leak credits
 		 */
-		int possible_inflights = p->inflight_credits + p->inflights;
+		int possible_inflights = p->inflight_credits;
+		for (i = 0; i < sw->nb_shards; i++)
+			possible_inflights +=
+				sw_shard_port(sw, i, port_id)->inflights;
 		rte_atomic32_sub(&sw->inflights, possible_inflights);
 	}
 
+	rte_free(p->deq_shards);
 	*p = (struct sw_port){0}; /* zero entire structure */
 	p->id = port_id;
 	p->sw = sw;
@@ -197,7 +258,26 @@ sw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 				port_id);
 		return -1;
 	}
-	sw->cq_ring_space[port_id] = conf->dequeue_depth;
+	sw->shards[0].cq_ring_space[port_id] = conf->dequeue_depth;
+
+	if (sw->nb_shards > 1) {
+		/* events of all the shards can be outstanding */
+		uint32_t size = rte_align32pow2(sw->nb_shards *
+				SW_PORT_HIST_LIST);
+
+		p->deq_shards = rte_zmalloc_socket(NULL, size, 0,
+				dev->data->socket_id);
+		if (p->deq_shards == NULL) {
+			SW_LOG_ERR("Error allocating shard list for port %d",
+					port_id);
+			goto err;
+		}
+		p->deq_shards_mask = size - 1;
+
+		for (i = 1; i < sw->nb_shards; i++)
+			if (sw_shard_port_setup(dev, i, port_id, conf) < 0)
+				goto err;
+	}
 
 	/* set hist list contents to empty */
 	for (i = 0; i < SW_PORT_HIST_LIST; i++) {
@@ -209,15 +289,32 @@ sw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 	rte_smp_wmb();
 	p->initialized = 1;
 	return 0;
+
+err:
+	sw_port_release(p);
+	return -1;
 }
 
 static void
 sw_port_release(void *port)
 {
 	struct sw_port *p = (void *)port;
+	struct sw_evdev *sw;
+	unsigned int i;
+
 	if (p == NULL)
 		return;
 
+	sw = p->sw;
+	for (i = 1; sw != NULL && i < sw->nb_shards; i++) {
+		struct sw_port *sp = sw_shard_port(sw, i, p->id);
+
+		rte_event_ring_free(sp->rx_worker_ring);
+		rte_event_ring_free(sp->cq_worker_ring);
+		memset(sp, 0, sizeof(*sp));
+	}
+
+	rte_free(p->deq_shards);
 	rte_event_ring_free(p->rx_worker_ring);
 	rte_event_ring_free(p->cq_worker_ring);
 	memset(p, 0, sizeof(*p));
@@ -239,6 +336,7 @@ qid_init(struct sw_evdev *sw, unsigned int idx, int type,
 	qid->id = idx;
 	qid->type = type;
 	qid->priority = queue_conf->priority;
+	qid->shard = idx % sw->nb_shards;
 
 	if (qid->type == RTE_SCHED_TYPE_ORDERED) {
 		uint32_t window_size;
@@ -359,7 +457,7 @@ sw_init_qid_iqs(struct sw_evdev *sw)
 			continue;
 
 		for (j = 0; j < SW_IQS_MAX; j++)
-			iq_init(sw, &qid->iq[j]);
+			iq_init(&sw->shards[qid->shard], &qid->iq[j]);
 	}
 }
 
@@ -375,18 +473,28 @@ sw_qids_empty(struct sw_evdev *sw)
 		}
 	}
 
+	for (i = 0; i < sw->nb_shards; i++) {
+		if (sw->shards[i].handoff_ring != NULL &&
+		    rte_event_ring_count(sw->shards[i].handoff_ring))
+			return 0;
+	}
+
 	return 1;
 }
 
 static int
 sw_ports_empty(struct sw_evdev *sw)
 {
-	unsigned int i;
+	unsigned int i, j;
 
-	for (i = 0; i < sw->port_count; i++) {
-		if ((rte_event_ring_count(sw->ports[i].rx_worker_ring)) ||
-		     rte_event_ring_count(sw->ports[i].cq_worker_ring))
-			return 0;
+	for (j = 0; j < sw->nb_shards; j++) {
+		for (i = 0; i < sw->port_count; i++) {
+			const struct sw_port *p = sw_shard_port(sw, j, i);
+
+			if ((rte_event_ring_count(p->rx_worker_ring)) ||
+			     rte_event_ring_count(p->cq_worker_ring))
+				return 0;
+		}
 	}
 
 	return 1;
@@ -419,9 +527,9 @@ sw_drain_ports(struct rte_eventdev *dev)
 }
 
 static void
-sw_drain_queue(struct rte_eventdev *dev, struct sw_iq *iq)
+sw_drain_queue(struct rte_eventdev *dev, struct sw_shard *sh,
+		struct sw_iq *iq)
 {
-	struct sw_evdev *sw = sw_pmd_priv(dev);
 	eventdev_stop_flush_t flush;
 	uint8_t dev_id;
 	void *arg;
@@ -433,7 +541,7 @@ sw_drain_queue(struct rte_eventdev *dev, struct sw_iq *iq)
 	while (iq_count(iq) > 0) {
 		struct rte_event ev;
 
-		iq_dequeue_burst(sw, iq, &ev, 1);
+		iq_dequeue_burst(sh, iq, &ev, 1);
 
 		if (flush)
 			flush(dev_id, ev, arg);
@@ -447,8 +555,11 @@ sw_drain_queues(struct rte_eventdev *dev)
 	unsigned int i, j;
 
 	for (i = 0; i < sw->qid_count; i++) {
+		struct sw_qid *qid = &sw->qids[i];
+
 		for (j = 0; j < SW_IQS_MAX; j++)
-			sw_drain_queue(dev, &sw->qids[i].iq[j]);
+			sw_drain_queue(dev, &sw->shards[qid->shard],
+					&qid->iq[j]);
 	}
 }
 
@@ -465,7 +576,8 @@ sw_clean_qid_iqs(struct rte_eventdev *dev)
 		for (j = 0; j < SW_IQS_MAX; j++) {
 			if (!qid->iq[j].head)
 				continue;
-			iq_free_chunk_list(sw, qid->iq[j].head);
+			iq_free_chunk_list(&sw->shards[qid->shard],
+					qid->iq[j].head);
 			qid->iq[j].head = NULL;
 		}
 	}
@@ -507,34 +619,43 @@ sw_dev_configure(const struct rte_eventdev *dev)
 	struct sw_evdev *sw = sw_pmd_priv(dev);
 	const struct rte_eventdev_data *data = dev->data;
 	const struct rte_event_dev_config *conf = &data->dev_conf;
-	int num_chunks, i;
+	int num_chunks, num_qids, i;
+	unsigned int j;
 
 	sw->qid_count = conf->nb_event_queues;
 	sw->port_count = conf->nb_event_ports;
 	sw->nb_events_limit = conf->nb_events_limit;
 	rte_atomic32_set(&sw->inflights, 0);
 
-	/* Number of chunks sized for worst-case spread of events across IQs */
-	num_chunks = ((SW_INFLIGHT_EVENTS_TOTAL/SW_EVS_PER_Q_CHUNK)+1) +
-			sw->qid_count*SW_IQS_MAX*2;
+	for (j = 0; j < sw->nb_shards; j++) {
+		struct sw_shard *sh = &sw->shards[j];
 
-	/* If this is a reconfiguration, free the previous IQ allocation. All
-	 * IQ chunk references were cleaned out of the QIDs in sw_stop(), and
-	 * will be reinitialized in sw_start().
-	 */
-	rte_free(sw->chunks);
-
-	sw->chunks = rte_malloc_socket(NULL,
-				       sizeof(struct sw_queue_chunk) *
-				       num_chunks,
-				       0,
-				       sw->data->socket_id);
-	if (!sw->chunks)
-		return -ENOMEM;
-
-	sw->chunk_list_head = NULL;
-	for (i = 0; i < num_chunks; i++)
-		iq_free_chunk(sw, &sw->chunks[i]);
+		/* Number of chunks sized for worst-case spread of events
+		 * across the IQs of the QIDs of the shard.
+		 */
+		num_qids = (sw->qid_count + sw->nb_shards - 1 - j) /
+				sw->nb_shards;
+		num_chunks = ((SW_INFLIGHT_EVENTS_TOTAL/SW_EVS_PER_Q_CHUNK)+1) +
+				num_qids*SW_IQS_MAX*2;
+
+		/* If this is a reconfiguration, free the previous IQ
+		 * allocation. All IQ chunk references were cleaned out of the
+		 * QIDs in sw_stop(), and will be reinitialized in sw_start().
+		 */
+		rte_free(sh->chunks);
+
+		sh->chunks = rte_malloc_socket(NULL,
+					       sizeof(struct sw_queue_chunk) *
+					       num_chunks,
+					       0,
+					       sw->data->socket_id);
+		if (!sh->chunks)
+			return -ENOMEM;
+
+		sh->chunk_list_head = NULL;
+		for (i = 0; i < num_chunks; i++)
+			iq_free_chunk(sh, &sh->chunks[i]);
+	}
 
 	if (conf->event_dev_cfg & RTE_EVENT_DEV_CFG_PER_DEQUEUE_TIMEOUT)
 		return -ENOTSUP;
@@ -623,16 +744,30 @@ sw_dump(struct rte_eventdev *dev, FILE *f)
 	static const char * const q_type_strings[] = {
 			"Ordered", "Atomic", "Parallel", "Directed"
 	};
+	uint64_t rx_pkts = 0, rx_dropped = 0, tx_pkts = 0;
+	uint64_t sched_called = 0, sched_cq_qid_called = 0;
+	uint64_t sched_no_iq_enqueues = 0, sched_no_cq_enqueues = 0;
 	uint32_t i;
-	fprintf(f, "EventDev %s: ports %d, qids %d\n",
-		dev->data->name, sw->port_count, sw->qid_count);
-
+	fprintf(f, "EventDev %s: ports %d, qids %d, shards %d\n",
+		dev->data->name, sw->port_count, sw->qid_count, sw->nb_shards);
+
+	for (i = 0; i < sw->nb_shards; i++) {
+		const struct sw_shard *sh = &sw->shards[i];
+
+		rx_pkts += sh->stats.rx_pkts;
+		rx_dropped += sh->stats.rx_dropped;
+		tx_pkts += sh->stats.tx_pkts;
+		sched_called += sh->sched_called;
+		sched_cq_qid_called += sh->sched_cq_qid_called;
+		sched_no_iq_enqueues += sh->sched_no_iq_enqueues;
+		sched_no_cq_enqueues += sh->sched_no_cq_enqueues;
+	}
 	fprintf(f, "\trx   %"PRIu64"\n\tdrop %"PRIu64"\n\ttx   %"PRIu64"\n",
-		sw->stats.rx_pkts, sw->stats.rx_dropped, sw->stats.tx_pkts);
-	fprintf(f, "\tsched calls: %"PRIu64"\n", sw->sched_called);
-	fprintf(f, "\tsched cq/qid call: %"PRIu64"\n", sw->sched_cq_qid_called);
-	fprintf(f, "\tsched no IQ enq: %"PRIu64"\n", sw->sched_no_iq_enqueues);
-	fprintf(f, "\tsched no CQ enq: %"PRIu64"\n", sw->sched_no_cq_enqueues);
+		rx_pkts, rx_dropped, tx_pkts);
+	fprintf(f, "\tsched calls: %"PRIu64"\n", sched_called);
+	fprintf(f, "\tsched cq/qid call: %"PRIu64"\n", sched_cq_qid_called);
+	fprintf(f, "\tsched no IQ enq: %"PRIu64"\n", sched_no_iq_enqueues);
+	fprintf(f, "\tsched no CQ enq: %"PRIu64"\n", sched_no_cq_enqueues);
 	uint32_t inflights = rte_atomic32_read(&sw->inflights);
 	uint32_t credits = sw->nb_events_limit - inflights;
 	fprintf(f, "\tinflight %d, credits: %d\n", inflights, credits);
@@ -798,12 +933,15 @@ sw_start(struct rte_eventdev *dev)
 	 * "If two members compare as equal, their order in the sorted
 	 * array is undefined."
 	 */
-	uint32_t qidx = 0;
+	for (i = 0; i < sw->nb_shards; i++)
+		sw->shards[i].qid_count = 0;
 	for (j = 0; j <= RTE_EVENT_DEV_PRIORITY_LOWEST; j++) {
 		for (i = 0; i < sw->qid_count; i++) {
 			if (sw->qids[i].priority == j) {
-				sw->qids_prioritized[qidx] = &sw->qids[i];
-				qidx++;
+				struct sw_shard *sh = &sw->shards[sw->qids[i].shard];
+
+				sh->qids_prioritized[sh->qid_count++] =
+						&sw->qids[i];
 			}
 		}
 	}
@@ -863,11 +1001,15 @@ sw_close(struct rte_eventdev *dev)
 		sw_port_release(&sw->ports[i]);
 	sw->port_count = 0;
 
-	memset(&sw->stats, 0, sizeof(sw->stats));
-	sw->sched_called = 0;
-	sw->sched_no_iq_enqueues = 0;
-	sw->sched_no_cq_enqueues = 0;
-	sw->sched_cq_qid_called = 0;
+	for (i = 0; i < sw->nb_shards; i++) {
+		struct sw_shard *sh = &sw->shards[i];
+
+		memset(&sh->stats, 0, sizeof(sh->stats));
+		sh->sched_called = 0;
+		sh->sched_no_iq_enqueues = 0;
+		sh->sched_no_cq_enqueues = 0;
+		sh->sched_cq_qid_called = 0;
+	}
 
 	return 0;
 }
@@ -932,6 +1074,84 @@ set_refill_once(const char *key __rte_unused, const char *value, void *opaque)
 	return 0;
 }
 
+static int
+set_sched_shards(const char *key __rte_unused, const char *value, void *opaque)
+{
+	int *sched_shards = opaque;
+	*sched_shards = atoi(value);
+	if (*sched_shards < 1 || *sched_shards > SW_SHARDS_MAX)
+		return -1;
+	return 0;
+}
+
+/* Free the resources of the shards, allocated once at probe */
+static void
+sw_shards_free(struct sw_evdev *sw)
+{
+	unsigned int i;
+
+	for (i = 0; i < sw->nb_shards; i++) {
+		struct sw_shard *sh = &sw->shards[i];
+
+		rte_event_ring_free(sh->handoff_ring);
+		sh->handoff_ring = NULL;
+		rte_free(sh->chunks);
+		sh->chunks = NULL;
+		if (i > 0) {
+			rte_free(sh->ports);
+			sh->ports = NULL;
+		}
+	}
+}
+
+static int
+sw_shards_init(struct rte_eventdev *dev, unsigned int nb_shards)
+{
+	struct sw_evdev *sw = sw_pmd_priv(dev);
+	char buf[RTE_RING_NAMESIZE];
+	unsigned int i;
+
+	sw->nb_shards = nb_shards;
+	for (i = 0; i < nb_shards; i++) {
+		struct sw_shard *sh = &sw->shards[i];
+
+		sh->sw = sw;
+		sh->id = i;
+		rte_spinlock_init(&sh->lock);
+
+		/* the first shard uses the ports seen by the application */
+		if (i == 0)
+			sh->ports = sw->ports;
+		else
+			sh->ports = rte_zmalloc_socket(NULL,
+					sizeof(struct sw_port) * SW_PORTS_MAX,
+					RTE_CACHE_LINE_SIZE,
+					dev->data->socket_id);
+		if (sh->ports == NULL)
+			goto err;
+
+		if (nb_shards == 1)
+			break;
+
+		/* events of the other shards for the queues of this one */
+		snprintf(buf, sizeof(buf), "sw%d_s%u_handoff",
+				dev->data->dev_id, i);
+		rte_event_ring_free(rte_event_ring_lookup(buf));
+		sh->handoff_ring = rte_event_ring_create(buf,
+				SW_HANDOFF_RING_SIZE, dev->data->socket_id,
+				RING_F_SC_DEQ | RING_F_EXACT_SZ);
+		if (sh->handoff_ring == NULL)
+			goto err;
+	}
+
+	return 0;
+
+err:
+	SW_LOG_ERR("Error allocating scheduler shard %u", i);
+	sw_shards_free(sw);
+	return -ENOMEM;
+}
+
 static int32_t sw_sched_service_func(void *args)
 {
 	struct rte_eventdev *dev = args;
@@ -980,6 +1200,7 @@ sw_probe(struct rte_vdev_device *vdev)
 		MIN_BURST_SIZE_ARG,
 		DEQ_BURST_SIZE_ARG,
 		REFIL_ONCE_ARG,
+		SCHED_SHARDS_ARG,
 		NULL
 	};
 	const char *name;
@@ -992,6 +1213,7 @@ sw_probe(struct rte_vdev_device *vdev)
 	int min_burst_size = 1;
 	int deq_burst_size = SCHED_DEQUEUE_DEFAULT_BURST_SIZE;
 	int refill_once = 0;
+	int sched_shards = 1;
 
 	name = rte_vdev_device_name(vdev);
 	params = rte_vdev_device_args(vdev);
@@ -1063,6 +1285,16 @@ sw_probe(struct rte_vdev_device *vdev)
 				return ret;
 			}
 
+			ret = rte_kvargs_process(kvlist, SCHED_SHARDS_ARG,
+					set_sched_shards, &sched_shards);
+			if (ret != 0) {
+				SW_LOG_ERR(
+					"%s: Error parsing scheduler shards parameter",
+					name);
+				rte_kvargs_free(kvlist);
+				return ret;
+			}
+
 			rte_kvargs_free(kvlist);
 		}
 	}
@@ -1070,9 +1302,11 @@ sw_probe(struct rte_vdev_device *vdev)
 	SW_LOG_INFO(
 			"Creating eventdev sw device %s, numa_node=%d, "
 			"sched_quanta=%d, credit_quanta=%d "
-			"min_burst=%d, deq_burst=%d, refill_once=%d",
+			"min_burst=%d, deq_burst=%d, refill_once=%d, "
+			"sched_shards=%d",
 			name, socket_id, sched_quanta, credit_quanta,
-			min_burst_size, deq_burst_size, refill_once);
+			min_burst_size, deq_burst_size, refill_once,
+			sched_shards);
 
 	dev = rte_event_pmd_vdev_init(name,
 			sizeof(struct sw_evdev), socket_id, vdev);
@@ -1099,6 +1333,11 @@ sw_probe(struct rte_vdev_device *vdev)
 	sw->sched_deq_burst_size = deq_burst_size;
 	sw->refill_once_per_iter = refill_once;
 
+	if (sw_shards_init(dev, sched_shards) < 0) {
+		rte_event_pmd_vdev_uninit(name);
+		return -ENOMEM;
+	}
+
 	/* register service with EAL */
 	struct rte_service_spec service;
 	memset(&service, 0, sizeof(struct rte_service_spec));
@@ -1108,6 +1347,9 @@ sw_probe(struct rte_vdev_device *vdev)
 	service.socket_id = socket_id;
 	service.callback = sw_sched_service_func;
 	service.callback_userdata = (void *)dev;
+	/* each shard is scheduled by a single core at a time */
+	if (sw->nb_shards > 1)
+		service.capabilities = RTE_SERVICE_CAP_MT_SAFE;
 
 	int32_t ret = rte_service_component_register(&service, &sw->service_id);
 	if (ret) {
@@ -1126,7 +1368,9 @@ sw_probe(struct rte_vdev_device *vdev)
 static int
 sw_remove(struct rte_vdev_device *vdev)
 {
+	struct rte_eventdev *dev;
 	const char *name;
+	int ret;
 
 	name = rte_vdev_device_name(vdev);
 	if (name == NULL)
@@ -1134,6 +1378,15 @@ sw_remove(struct rte_vdev_device *vdev)
 
 	SW_LOG_INFO("Closing eventdev sw device %s", name);
 
+	/* the shards are used when closing the device, free them after */
+	dev = rte_event_pmd_get_named_dev(name);
+	if (dev != NULL && rte_eal_process_type() == RTE_PROC_PRIMARY) {
+		ret = rte_event_dev_close(dev->data->dev_id);
+		if (ret < 0)
+			return ret;
+		sw_shards_free(sw_pmd_priv(dev));
+	}
+
 	return rte_event_pmd_vdev_uninit(name);
 }
 
@@ -1146,5 +1399,5 @@ RTE_PMD_REGISTER_VDEV(EVENTDEV_NAME_SW_PMD, evdev_sw_pmd_drv);
 RTE_PMD_REGISTER_PARAM_STRING(event_sw, NUMA_NODE_ARG "=<int> "
 		SCHED_QUANTA_ARG "=<int>" CREDIT_QUANTA_ARG "=<int>"
 		MIN_BURST_SIZE_ARG "=<int>" DEQ_BURST_SIZE_ARG "=<int>"
-		REFIL_ONCE_ARG "=<int>");
+		REFIL_ONCE_ARG "=<int>" SCHED_SHARDS_ARG "=<int>");
 RTE_LOG_REGISTER_DEFAULT(eventdev_sw_log_level, NOTICE);
@@ -9,6 +9,7 @@
 #include <rte_eventdev.h>
 #include <eventdev_pmd_vdev.h>
 #include <rte_atomic.h>
+#include <rte_spinlock.h>
 
 #define SW_DEFAULT_CREDIT_QUANTA 32
 #define SW_DEFAULT_SCHED_QUANTA 128
@@ -21,6 +22,10 @@
 /* allow for lots of over-provisioning */
 #define MAX_SW_PROD_Q_DEPTH 4096
 #define SW_FRAGMENTS_MAX 16
+#define SW_SHARDS_MAX 8
+/* events handed off between shards, more than can be inflight */
+#define SW_HANDOFF_RING_SIZE (SW_INFLIGHT_EVENTS_TOTAL * 2)
+#define SW_HANDOFF_BURST_SIZE 32
 
 /* Should be power-of-two minus one, to leave room for the next pointer */
 #define SW_EVS_PER_Q_CHUNK 255
@@ -133,6 +138,7 @@ struct sw_qid {
 	uint32_t window_size;          /* Used to wrap reorder_buffer_index */
 
 	uint8_t priority;
+	uint8_t shard; /* scheduler shard owning this QID */
 };
 
 struct sw_hist_list_entry {
@@ -207,6 +213,59 @@ struct sw_port {
 	struct rte_event cq_buf[MAX_SW_CONS_Q_DEPTH];
 
 	uint8_t num_qids_mapped;
+
+	/* With several shards, the shard which scheduled each event dequeued
+	 * and not released yet, to send it back there on completion.
+	 */
+	uint8_t *deq_shards;
+	uint32_t deq_shards_mask;
+	uint32_t deq_shards_head;
+	uint32_t deq_shards_tail;
+	uint8_t deq_next_shard;
+};
+
+/*
+ * Scheduler shard, scheduling the QIDs assigned to it. Each shard has its
+ * own instance of every port, holding the rings between the port and the
+ * shard and the history of the events the shard sent to the port.
+ * Shard 0 uses the ports of the device, which also hold the worker side
+ * state of the ports.
+ */
+struct __rte_cache_aligned sw_shard {
+	struct sw_evdev *sw;
+	struct sw_port *ports;
+	uint8_t id;
+	/* held while a service core schedules this shard */
+	rte_spinlock_t lock;
+
+	/* Array of pointers to the QIDs of this shard sorted by priority */
+	uint32_t qid_count;
+	struct sw_qid *qids_prioritized[RTE_EVENT_MAX_QUEUES_PER_DEV];
+
+	/* Events sent to the QIDs of this shard by the other shards */
+	struct rte_event_ring *handoff_ring;
+	/* Events to send to the other shards, flushed once per iteration */
+	uint16_t handoff_count[SW_SHARDS_MAX];
+	struct rte_event handoff_buf[SW_SHARDS_MAX][SW_HANDOFF_BURST_SIZE];
+
+	struct sw_queue_chunk *chunk_list_head;
+	struct sw_queue_chunk *chunks;
+
+	/* Current values */
+	uint32_t sched_flush_count;
+	uint32_t sched_min_burst;
+
+	/* Cache how many packets are in each cq */
+	alignas(RTE_CACHE_LINE_SIZE) uint16_t cq_ring_space[SW_PORTS_MAX];
+
+	/* Stats */
+	alignas(RTE_CACHE_LINE_SIZE) struct sw_point_stats stats;
+	uint64_t sched_called;
+	uint64_t sched_no_iq_enqueues;
+	uint64_t sched_no_cq_enqueues;
+	uint64_t sched_cq_qid_called;
+	uint64_t sched_last_iter_bitmask;
+	uint8_t sched_progress_last_iter;
 };
 
 struct sw_evdev {
@@ -226,9 +285,6 @@ struct sw_evdev {
 	uint32_t sched_deq_burst_size;
 	/* Refill pp buffers only once per scheduler call*/
 	uint32_t refill_once_per_iter;
-	/* Current values */
-	uint32_t sched_flush_count;
-	uint32_t sched_min_burst;
 
 	/* Contains all ports - load balanced and directed */
 	alignas(RTE_CACHE_LINE_SIZE) struct sw_port ports[SW_PORTS_MAX];
@@ -243,25 +299,12 @@ struct sw_evdev {
 
 	/* Internal queues - one per logical queue */
 	alignas(RTE_CACHE_LINE_SIZE) struct sw_qid qids[RTE_EVENT_MAX_QUEUES_PER_DEV];
-	struct sw_queue_chunk *chunk_list_head;
-	struct sw_queue_chunk *chunks;
-
-	/* Cache how many packets are in each cq */
-	alignas(RTE_CACHE_LINE_SIZE) uint16_t cq_ring_space[SW_PORTS_MAX];
 
-	/* Array of pointers to load-balanced QIDs sorted by priority level */
-	struct sw_qid *qids_prioritized[RTE_EVENT_MAX_QUEUES_PER_DEV];
+	/* Schedulers, each one running the QIDs assigned to it */
+	uint8_t nb_shards;
+	struct sw_shard shards[SW_SHARDS_MAX];
 
-	/* Stats */
-	alignas(RTE_CACHE_LINE_SIZE) struct sw_point_stats stats;
-	uint64_t sched_called;
 	int32_t sched_quanta;
-	uint64_t sched_no_iq_enqueues;
-	uint64_t sched_no_cq_enqueues;
-	uint64_t sched_cq_qid_called;
-	uint64_t sched_last_iter_bitmask;
-	uint8_t sched_progress_last_iter;
-
 	uint8_t started;
 	uint32_t credit_update_quanta;
 
@@ -288,6 +331,13 @@ sw_pmd_priv_const(const struct rte_eventdev *eventdev)
 	return eventdev->data->dev_private;
 }
 
+/* Instance of a port in a shard */
+static inline struct sw_port *
+sw_shard_port(const struct sw_evdev *sw, unsigned int shard, uint8_t port_id)
+{
+	return &sw->shards[shard].ports[port_id];
+}
+
 uint16_t sw_event_enqueue_burst(void *port, const struct rte_event ev[],
 		uint16_t num);
 
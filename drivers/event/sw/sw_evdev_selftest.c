@@ -20,6 +20,7 @@
 #include <rte_ethdev.h>
 #include <rte_cycles.h>
 #include <rte_eventdev.h>
+#include <rte_event_ring.h>
 #include <rte_pause.h>
 #include <rte_service.h>
 #include <rte_service_component.h>
@@ -3303,6 +3304,286 @@ worker_loopback(struct test *t, uint8_t disable_implicit_release)
 	return 0;
 }
 
+#define SHARDED_NUM_EVENTS 8
+
+static void
+run_service_iters(struct test *t, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		rte_service_run_iter_on_app_lcore(t->service_id, 1);
+}
+
+/* Check that no event is left in the history list of any shard */
+static int
+check_shards_inflights(struct test *t)
+{
+	struct sw_evdev *sw = sw_pmd_priv(&rte_eventdevs[evdev]);
+	unsigned int i, j;
+
+	for (i = 0; i < sw->nb_shards; i++) {
+		for (j = 0; j < sw->port_count; j++) {
+			if (sw_shard_port(sw, i, t->port[j])->inflights != 0) {
+				printf("%d: port %u inflight in shard %u\n",
+						__LINE__, j, i);
+				return -1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Events forwarded from an ordered queue to an atomic queue of another
+ * shard are handed off between the shards, and keep their original order.
+ */
+static int
+sharded_handoff(struct test *t)
+{
+	struct rte_event ev[SHARDED_NUM_EVENTS];
+	struct rte_event fwd[SHARDED_NUM_EVENTS];
+	struct rte_event rel[SHARDED_NUM_EVENTS];
+	int err, i;
+
+	/* qid 0 is scheduled by shard 0, qid 1 by shard 1 */
+	if (init(t, 2, 3) < 0 ||
+			create_ports(t, 3) < 0 ||
+			create_ordered_qids(t, 1) < 0 ||
+			create_atomic_qids(t, 1) < 0) {
+		printf("%d: Error initializing device\n", __LINE__);
+		return -1;
+	}
+	rte_event_dev_service_id_get(evdev, &t->service_id);
+
+	if (rte_event_port_link(evdev, t->port[1], &t->qid[0], NULL, 1) != 1 ||
+			rte_event_port_link(evdev, t->port[2], &t->qid[1],
+				NULL, 1) != 1) {
+		printf("%d: error mapping qids\n", __LINE__);
+		return -1;
+	}
+	if (rte_event_dev_start(evdev) < 0) {
+		printf("%d: Error with start call\n", __LINE__);
+		return -1;
+	}
+
+	for (i = 0; i < SHARDED_NUM_EVENTS; i++) {
+		ev[i] = (struct rte_event){
+			.op = RTE_EVENT_OP_NEW,
+			.queue_id = t->qid[0],
+			.flow_id = i,
+			.priority = RTE_EVENT_DEV_PRIORITY_NORMAL,
+			.u64 = i,
+		};
+	}
+	err = rte_event_enqueue_burst(evdev, t->port[0], ev,
+			SHARDED_NUM_EVENTS);
+	if (err != SHARDED_NUM_EVENTS) {
+		printf("%d: Failed to enqueue\n", __LINE__);
+		return -1;
+	}
+	run_service_iters(t, 4);
+
+	err = rte_event_dequeue_burst(evdev, t->port[1], ev,
+			SHARDED_NUM_EVENTS, 0);
+	if (err != SHARDED_NUM_EVENTS) {
+		printf("%d: dequeued %d ordered events\n", __LINE__, err);
+		return -1;
+	}
+
+	/* forward in reverse order, to a single atomic flow */
+	for (i = 0; i < SHARDED_NUM_EVENTS; i++) {
+		fwd[i] = ev[SHARDED_NUM_EVENTS - 1 - i];
+		fwd[i].op = RTE_EVENT_OP_FORWARD;
+		fwd[i].queue_id = t->qid[1];
+		fwd[i].flow_id = 0;
+	}
+	err = rte_event_enqueue_burst(evdev, t->port[1], fwd,
+			SHARDED_NUM_EVENTS);
+	if (err != SHARDED_NUM_EVENTS) {
+		printf("%d: Failed to forward\n", __LINE__);
+		return -1;
+	}
+	run_service_iters(t, 4);
+
+	err = rte_event_dequeue_burst(evdev, t->port[2], ev,
+			SHARDED_NUM_EVENTS, 0);
+	if (err != SHARDED_NUM_EVENTS) {
+		printf("%d: dequeued %d handed off events\n", __LINE__, err);
+		return -1;
+	}
+	for (i = 0; i < SHARDED_NUM_EVENTS; i++) {
+		if (ev[i].u64 != (uint64_t)i) {
+			printf("%d: event %d out of order: %"PRIu64"\n",
+					__LINE__, i, ev[i].u64);
+			return -1;
+		}
+		rel[i] = release_ev;
+	}
+
+	err = rte_event_enqueue_burst(evdev, t->port[2], rel,
+			SHARDED_NUM_EVENTS);
+	if (err != SHARDED_NUM_EVENTS) {
+		printf("%d: Failed to release\n", __LINE__);
+		return -1;
+	}
+	run_service_iters(t, 4);
+
+	if (check_shards_inflights(t) < 0)
+		return -1;
+
+	cleanup(t);
+	return 0;
+}
+
+/*
+ * The completions which cannot be enqueued because the ring towards a shard
+ * is full must be sent to the same shard when retried.
+ */
+static int
+sharded_backpressure(struct test *t)
+{
+	struct sw_evdev *sw = sw_pmd_priv(&rte_eventdevs[evdev]);
+	struct rte_event_ring *ring;
+	struct rte_event ev[2], fwd[2];
+	struct rte_event dummy = {0};
+	unsigned int nb_fill, nb_drain;
+	int enq, err, i;
+
+	/* qid 0 is scheduled by shard 0, qid 1 by shard 1 */
+	if (init(t, 2, 2) < 0 ||
+			create_ports(t, 2) < 0 ||
+			create_atomic_qids(t, 2) < 0) {
+		printf("%d: Error initializing device\n", __LINE__);
+		return -1;
+	}
+	rte_event_dev_service_id_get(evdev, &t->service_id);
+
+	if (rte_event_port_link(evdev, t->port[1], t->qid, NULL, 2) != 2) {
+		printf("%d: error mapping qids\n", __LINE__);
+		return -1;
+	}
+	if (rte_event_dev_start(evdev) < 0) {
+		printf("%d: Error with start call\n", __LINE__);
+		return -1;
+	}
+
+	for (i = 0; i < 2; i++) {
+		ev[i] = (struct rte_event){
+			.op = RTE_EVENT_OP_NEW,
+			.queue_id = t->qid[i],
+			.priority = RTE_EVENT_DEV_PRIORITY_NORMAL,
+			.u64 = i,
+		};
+	}
+	if (rte_event_enqueue_burst(evdev, t->port[0], ev, 2) != 2) {
+		printf("%d: Failed to enqueue\n", __LINE__);
+		return -1;
+	}
+	run_service_iters(t, 4);
+
+	/* one event scheduled by each shard */
+	err = rte_event_dequeue_burst(evdev, t->port[1], ev, 2, 0);
+	if (err != 2) {
+		printf("%d: dequeued %d events\n", __LINE__, err);
+		return -1;
+	}
+
+	/* fill the ring of the port towards shard 0 */
+	ring = sw_shard_port(sw, 0, t->port[1])->rx_worker_ring;
+	for (nb_fill = 0; rte_event_ring_enqueue_burst(ring, &dummy, 1,
+				NULL) == 1; nb_fill++)
+		;
+
+	for (i = 0; i < 2; i++) {
+		fwd[i] = ev[i];
+		fwd[i].op = RTE_EVENT_OP_FORWARD;
+	}
+	enq = rte_event_enqueue_burst(evdev, t->port[1], fwd, 2);
+	if (enq == 2) {
+		printf("%d: forwarded to a full ring\n", __LINE__);
+		return -1;
+	}
+
+	/* unblock the ring and retry */
+	nb_drain = 0;
+	while (rte_event_ring_dequeue_burst(ring, &dummy, 1, NULL) == 1)
+		nb_drain++;
+	if (nb_drain != nb_fill) {
+		printf("%d: %u events in the full ring, %u filled\n",
+				__LINE__, nb_drain, nb_fill);
+		return -1;
+	}
+	err = rte_event_enqueue_burst(evdev, t->port[1], &fwd[enq], 2 - enq);
+	if (err != 2 - enq) {
+		printf("%d: Failed to forward again\n", __LINE__);
+		return -1;
+	}
+	run_service_iters(t, 4);
+
+	err = rte_event_dequeue_burst(evdev, t->port[1], ev, 2, 0);
+	if (err != 2) {
+		printf("%d: dequeued %d forwarded events\n", __LINE__, err);
+		return -1;
+	}
+	fwd[0] = release_ev;
+	fwd[1] = release_ev;
+	if (rte_event_enqueue_burst(evdev, t->port[1], fwd, 2) != 2) {
+		printf("%d: Failed to release\n", __LINE__);
+		return -1;
+	}
+	run_service_iters(t, 4);
+
+	if (check_shards_inflights(t) < 0)
+		return -1;
+
+	cleanup(t);
+	return 0;
+}
+
+/* Run the tests of the scheduler shards on a device with 2 shards */
+static int
+test_sw_eventdev_shards(struct test *t)
+{
+	const char *eventdev_name = "event_sw_shards";
+	const int main_evdev = evdev;
+	uint32_t service_id;
+	int ret = -1;
+
+	if (rte_vdev_init(eventdev_name, "sched_shards=2") < 0) {
+		printf("Error creating sharded eventdev\n");
+		return -1;
+	}
+	evdev = rte_event_dev_get_dev_id(eventdev_name);
+	if (evdev < 0 ||
+			rte_event_dev_service_id_get(evdev, &service_id) < 0) {
+		printf("Error finding sharded eventdev\n");
+		goto out;
+	}
+	rte_service_runstate_set(service_id, 1);
+	rte_service_set_runstate_mapped_check(service_id, 0);
+
+	printf("*** Running Sharded Handoff test...\n");
+	if (sharded_handoff(t) != 0) {
+		printf("ERROR - Sharded Handoff test FAILED.\n");
+		goto out;
+	}
+	printf("*** Running Sharded Back-pressure test...\n");
+	if (sharded_backpressure(t) != 0) {
+		printf("ERROR - Sharded Back-pressure test FAILED.\n");
+		goto out;
+	}
+	ret = 0;
+
+out:
+	if (evdev >= 0)
+		rte_event_dev_stop(evdev);
+	evdev = main_evdev;
+	rte_vdev_uninit(eventdev_name);
+	return ret;
+}
+
 static struct rte_mempool *eventdev_func_mempool;
 
 int
@@ -3521,6 +3802,9 @@ test_sw_eventdev(void)
 		printf("ERROR - Ordered & Atomic hist-list test FAILED.\n");
 		goto test_fail;
 	}
+	ret = test_sw_eventdev_shards(t);
+	if (ret != 0)
+		goto test_fail;
 	if (rte_lcore_count() >= 3) {
 		printf("*** Running Worker loopback test...\n");
 		ret = worker_loopback(t, 0);
@@ -10,6 +10,19 @@
 
 #define PORT_ENQUEUE_MAX_BURST_SIZE 64
 
+/* Shard which scheduled the n-th oldest outstanding event of the port */
+static inline uint8_t
+sw_port_deq_shard_peek(const struct sw_port *p, uint32_t n)
+{
+	return p->deq_shards[(p->deq_shards_tail + n) & p->deq_shards_mask];
+}
+
+static inline uint8_t
+sw_port_deq_shard_pop(struct sw_port *p)
+{
+	return p->deq_shards[p->deq_shards_tail++ & p->deq_shards_mask];
+}
+
 static inline void
 sw_event_release(struct sw_port *p, uint8_t index)
 {
@@ -18,13 +31,19 @@ sw_event_release(struct sw_port *p, uint8_t index)
 	 * to clear any history before dequeuing more events.
 	 */
 	RTE_SET_USED(index);
+	struct rte_event_ring *ring = p->rx_worker_ring;
 
 	/* create drop message */
 	struct rte_event ev;
 	ev.op = sw_qe_flag_map[RTE_EVENT_OP_RELEASE];
 
+	/* the release goes to the shard which scheduled the event */
+	if (p->deq_shards != NULL)
+		ring = sw_shard_port(p->sw, sw_port_deq_shard_pop(p),
+				p->id)->rx_worker_ring;
+
 	uint16_t free_count;
-	rte_event_ring_enqueue_burst(p->rx_worker_ring, &ev, 1, &free_count);
+	rte_event_ring_enqueue_burst(ring, &ev, 1, &free_count);
 
 	/* each release returns one credit */
 	p->outstanding_releases--;
@@ -49,11 +68,101 @@ enqueue_burst_with_ops(struct rte_event_ring *r, const struct rte_event *events,
 	return rte_event_ring_enqueue_burst(r, tmp_evs, n, NULL);
 }
 
+/*
+ * With several shards, the events are sent to the ring of the port towards
+ * their shard: the completions to the shard which scheduled the event,
+ * the new events to the shard of their queue. Events to the same shard are
+ * enqueued together, stopping at the first ring full.
+ */
+static inline unsigned int
+enqueue_burst_sharded(struct sw_port *p, const struct rte_event *events,
+		unsigned int n, uint8_t *ops, const uint8_t *shards)
+{
+	struct rte_event_ring *r;
+	unsigned int start, end, enq;
+
+	for (start = 0; start < n; start = end) {
+		for (end = start + 1; end < n; end++)
+			if (shards[end] != shards[start])
+				break;
+
+		r = sw_shard_port(p->sw, shards[start], p->id)->rx_worker_ring;
+		enq = enqueue_burst_with_ops(r, &events[start], end - start,
+				&ops[start]);
+		if (enq != end - start)
+			return start + enq;
+	}
+
+	return n;
+}
+
+/*
+ * Consume the shards of the completions which were enqueued, and revert the
+ * accounting of the events which were not, so that a retry sends them again
+ * towards the same shards.
+ */
+static inline void
+enqueue_sharded_commit(struct sw_port *p, const struct rte_event ev[],
+		unsigned int n, unsigned int enq, const uint8_t *completes)
+{
+	const struct sw_evdev *sw = p->sw;
+	unsigned int i;
+
+	for (i = 0; i < enq; i++)
+		p->deq_shards_tail += completes[i];
+
+	for (; i < n; i++) {
+		int op = ev[i].op;
+
+		p->inflight_credits += (op == RTE_EVENT_OP_NEW);
+		if (completes[i]) {
+			p->outstanding_releases++;
+			p->inflight_credits -= (op == RTE_EVENT_OP_RELEASE);
+		}
+		if (unlikely(ev[i].queue_id >= sw->qid_count &&
+				op != RTE_EVENT_OP_RELEASE)) {
+			p->stats.rx_dropped--;
+			p->inflight_credits--;
+		}
+	}
+}
+
+static inline uint16_t
+dequeue_burst_sharded(struct sw_port *p, struct rte_event *ev, uint16_t num)
+{
+	const struct sw_evdev *sw = p->sw;
+	uint8_t shard = p->deq_next_shard;
+	struct rte_event_ring *r;
+	uint16_t ndeq = 0, n, j;
+	unsigned int i;
+
+	/* start from another shard on each call, not to starve any */
+	p->deq_next_shard = (shard + 1) % sw->nb_shards;
+
+	for (i = 0; i < sw->nb_shards && ndeq < num; i++) {
+		r = sw_shard_port(sw, shard, p->id)->cq_worker_ring;
+		n = rte_event_ring_dequeue_burst(r, &ev[ndeq], num - ndeq,
+				NULL);
+		for (j = 0; j < n; j++)
+			p->deq_shards[p->deq_shards_head++ &
+				p->deq_shards_mask] = shard;
+		ndeq += n;
+
+		if (++shard == sw->nb_shards)
+			shard = 0;
+	}
+
+	return ndeq;
+}
+
 uint16_t
 sw_event_enqueue_burst(void *port, const struct rte_event ev[], uint16_t num)
 {
 	int32_t i;
 	uint8_t new_ops[PORT_ENQUEUE_MAX_BURST_SIZE];
+	uint8_t shards[PORT_ENQUEUE_MAX_BURST_SIZE];
+	uint8_t completes[PORT_ENQUEUE_MAX_BURST_SIZE];
+	uint32_t nb_completes = 0;
 	struct sw_port *p = port;
 	struct sw_evdev *sw = (void *)p->sw;
 	uint32_t sw_inflights = rte_atomic32_read(&sw->inflights);
@@ -95,6 +204,19 @@ sw_event_enqueue_burst(void *port, const struct rte_event ev[], uint16_t num)
 		new_ops[i] = sw_qe_flag_map[op];
 		new_ops[i] &= ~(invalid_qid << QE_FLAG_VALID_SHIFT);
 
+		if (p->deq_shards != NULL) {
+			/* consumed once the event is enqueued */
+			completes[i] = (new_ops[i] & QE_FLAG_COMPLETE) &&
+					outstanding;
+			if (completes[i])
+				shards[i] = sw_port_deq_shard_peek(p,
+						nb_completes++);
+			else if (new_ops[i] & QE_FLAG_VALID)
+				shards[i] = sw->qids[ev[i].queue_id].shard;
+			else
+				shards[i] = 0;
+		}
+
 		/* FWD and RELEASE packets will both resolve to taken (assuming
 		 * correct usage of the API), providing very high correct
 		 * prediction rate.
@@ -110,8 +232,14 @@ sw_event_enqueue_burst(void *port, const struct rte_event ev[], uint16_t num)
 	}
 
 	/* returns number of events actually enqueued */
-	uint32_t enq = enqueue_burst_with_ops(p->rx_worker_ring, ev, i,
+	uint32_t enq;
+	if (p->deq_shards == NULL)
+		enq = enqueue_burst_with_ops(p->rx_worker_ring, ev, i,
 					     new_ops);
+	else {
+		enq = enqueue_burst_sharded(p, ev, i, new_ops, shards);
+		enqueue_sharded_commit(p, ev, i, enq, completes);
+	}
 	if (p->outstanding_releases == 0 && p->last_dequeue_burst_sz != 0) {
 		uint64_t burst_ticks = rte_get_timer_cycles() -
 				p->last_dequeue_ticks;
@@ -156,7 +284,11 @@ sw_event_dequeue_burst(void *port, struct rte_event *ev, uint16_t num,
 	}
 
 	/* returns number of events actually dequeued */
-	uint16_t ndeq = rte_event_ring_dequeue_burst(ring, ev, num, NULL);
+	uint16_t ndeq;
+	if (p->deq_shards == NULL)
+		ndeq = rte_event_ring_dequeue_burst(ring, ev, num, NULL);
+	else
+		ndeq = dequeue_burst_sharded(p, ev, num);
 	if (unlikely(ndeq == 0)) {
 		p->zero_polls++;
 		p->total_polls++;
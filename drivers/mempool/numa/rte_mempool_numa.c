@@ -0,0 +1,478 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 The DPDK contributors
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_errno.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_memory.h>
+#include <rte_mempool.h>
+#include <rte_ring.h>
+#include <rte_stdatomic.h>
+
+#include "rte_pmd_numa_mempool.h"
+
+/*
+ * Every NUMA socket has two rings:
+ * - the free ring holds the free objects stored in the memory of the socket,
+ *   it is used by the lcores of the socket only, unless it runs out;
+ * - the return ring holds the objects of the socket freed by the lcores
+ *   of other sockets, it is drained by the lcores of the socket
+ *   when their free ring is empty.
+ * Remote frees only touch the return ring, so the head and tail of the
+ * free ring are not bounced between the sockets.
+ */
+
+/* Maximum number of disjoint memory ranges of the pool. */
+#define NUMA_MEMPOOL_MAX_RANGES 64
+
+struct numa_mempool_socket {
+	alignas(RTE_CACHE_LINE_SIZE) struct rte_ring *free_ring;
+	struct rte_ring *return_ring;
+	RTE_ATOMIC(uint64_t) local_alloc;
+	RTE_ATOMIC(uint64_t) remote_alloc;
+	RTE_ATOMIC(uint64_t) local_free;
+	RTE_ATOMIC(uint64_t) remote_free;
+	RTE_ATOMIC(uint64_t) returned;
+};
+
+/* Objects from start to end (excluded) belong to socket. */
+struct numa_mempool_range {
+	uintptr_t start;
+	uintptr_t end;
+	unsigned int socket;
+};
+
+struct numa_mempool_data {
+	unsigned int nb_sockets;
+	/* socket index used for unknown socket IDs */
+	unsigned int default_socket;
+	/* objects are enqueued during the populate operation */
+	bool populating;
+	/* socket index of each socket ID, nb_sockets if not present */
+	uint8_t socket_idx[RTE_MAX_NUMA_NODES];
+	unsigned int nb_ranges;
+	struct numa_mempool_range ranges[NUMA_MEMPOOL_MAX_RANGES];
+	struct numa_mempool_socket sockets[RTE_MAX_NUMA_NODES];
+};
+
+static inline unsigned int
+numa_mempool_socket_idx(const struct numa_mempool_data *nd, int socket_id)
+{
+	if (socket_id >= 0 && socket_id < RTE_MAX_NUMA_NODES &&
+			nd->socket_idx[socket_id] < nd->nb_sockets)
+		return nd->socket_idx[socket_id];
+	return nd->default_socket;
+}
+
+/* Get the index of the socket where an object is stored. */
+static inline unsigned int
+numa_mempool_obj_socket(const struct numa_mempool_data *nd, const void *obj)
+{
+	uintptr_t addr = (uintptr_t)obj;
+	unsigned int lo = 0, hi = nd->nb_ranges;
+
+	/* last range starting before the object */
+	while (hi - lo > 1) {
+		unsigned int mid = (lo + hi) / 2;
+
+		if (addr < nd->ranges[mid].start)
+			hi = mid;
+		else
+			lo = mid;
+	}
+	if (unlikely(hi == 0 || addr < nd->ranges[lo].start ||
+			addr >= nd->ranges[lo].end))
+		return nd->default_socket;
+	return nd->ranges[lo].socket;
+}
+
+/* Put back objects in the free ring of their socket. */
+static void
+numa_mempool_put_home(struct numa_mempool_data *nd, void * const *obj_table,
+		unsigned int n)
+{
+	unsigned int i, j, s;
+
+	for (i = 0; i < n; i = j) {
+		s = numa_mempool_obj_socket(nd, obj_table[i]);
+		for (j = i + 1; j < n; j++)
+			if (numa_mempool_obj_socket(nd, obj_table[j]) != s)
+				break;
+		/* rings are sized for all the objects, it cannot fail */
+		rte_ring_mp_enqueue_bulk(nd->sockets[s].free_ring,
+			&obj_table[i], j - i, NULL);
+	}
+}
+
+static int
+numa_mempool_enqueue(struct rte_mempool *mp, void * const *obj_table,
+		unsigned int n)
+{
+	struct numa_mempool_data *nd = mp->pool_data;
+	struct numa_mempool_socket *ns;
+	unsigned int i, j, s, local;
+	uint64_t remote = 0;
+
+	if (nd->populating) {
+		numa_mempool_put_home(nd, obj_table, n);
+		return 0;
+	}
+
+	local = numa_mempool_socket_idx(nd, rte_socket_id());
+
+	/* enqueue the runs of objects of a same socket together */
+	for (i = 0; i < n; i = j) {
+		s = numa_mempool_obj_socket(nd, obj_table[i]);
+		for (j = i + 1; j < n; j++)
+			if (numa_mempool_obj_socket(nd, obj_table[j]) != s)
+				break;
+
+		ns = &nd->sockets[s];
+		if (s == local) {
+			rte_ring_mp_enqueue_bulk(ns->free_ring,
+				&obj_table[i], j - i, NULL);
+		} else {
+			rte_ring_mp_enqueue_bulk(ns->return_ring,
+				&obj_table[i], j - i, NULL);
+			remote += j - i;
+		}
+	}
+
+	ns = &nd->sockets[local];
+	if (remote != 0)
+		rte_atomic_fetch_add_explicit(&ns->remote_free, remote,
+			rte_memory_order_relaxed);
+	if (n != remote)
+		rte_atomic_fetch_add_explicit(&ns->local_free, n - remote,
+			rte_memory_order_relaxed);
+
+	return 0;
+}
+
+static int
+numa_mempool_dequeue(struct rte_mempool *mp, void **obj_table, unsigned int n)
+{
+	struct numa_mempool_data *nd = mp->pool_data;
+	struct numa_mempool_socket *ns;
+	unsigned int i, s, local, cnt, ret;
+
+	local = numa_mempool_socket_idx(nd, rte_socket_id());
+	ns = &nd->sockets[local];
+
+	if (rte_ring_mc_dequeue_bulk(ns->free_ring, obj_table, n, NULL) != 0) {
+		rte_atomic_fetch_add_explicit(&ns->local_alloc, n,
+			rte_memory_order_relaxed);
+		return 0;
+	}
+
+	/* take back the objects freed by the other sockets */
+	cnt = rte_ring_mc_dequeue_burst(ns->free_ring, obj_table, n, NULL);
+	ret = rte_ring_mc_dequeue_burst(ns->return_ring, &obj_table[cnt],
+		n - cnt, NULL);
+	cnt += ret;
+	if (cnt == n) {
+		rte_atomic_fetch_add_explicit(&ns->returned, ret,
+			rte_memory_order_relaxed);
+		rte_atomic_fetch_add_explicit(&ns->local_alloc, n,
+			rte_memory_order_relaxed);
+		return 0;
+	}
+
+	/* local socket is exhausted, use the memory of the other sockets */
+	for (i = 1; i < nd->nb_sockets && cnt < n; i++) {
+		struct numa_mempool_socket *rs;
+
+		s = (local + i) % nd->nb_sockets;
+		rs = &nd->sockets[s];
+		cnt += rte_ring_mc_dequeue_burst(rs->free_ring,
+			&obj_table[cnt], n - cnt, NULL);
+		cnt += rte_ring_mc_dequeue_burst(rs->return_ring,
+			&obj_table[cnt], n - cnt, NULL);
+	}
+
+	if (cnt < n) {
+		numa_mempool_put_home(nd, obj_table, cnt);
+		return -ENOBUFS;
+	}
+
+	for (i = 0, cnt = 0; i < n; i++)
+		cnt += (numa_mempool_obj_socket(nd, obj_table[i]) == local);
+	rte_atomic_fetch_add_explicit(&ns->returned, ret,
+		rte_memory_order_relaxed);
+	rte_atomic_fetch_add_explicit(&ns->local_alloc, cnt,
+		rte_memory_order_relaxed);
+	rte_atomic_fetch_add_explicit(&ns->remote_alloc, n - cnt,
+		rte_memory_order_relaxed);
+
+	return 0;
+}
+
+static unsigned int
+numa_mempool_get_count(const struct rte_mempool *mp)
+{
+	const struct numa_mempool_data *nd = mp->pool_data;
+	unsigned int i, count = 0;
+
+	for (i = 0; i < nd->nb_sockets; i++) {
+		count += rte_ring_count(nd->sockets[i].free_ring);
+		count += rte_ring_count(nd->sockets[i].return_ring);
+	}
+
+	return count;
+}
+
+static void
+numa_mempool_free(struct rte_mempool *mp)
+{
+	struct numa_mempool_data *nd = mp->pool_data;
+	unsigned int i;
+
+	if (nd == NULL)
+		return;
+
+	for (i = 0; i < nd->nb_sockets; i++) {
+		rte_ring_free(nd->sockets[i].free_ring);
+		rte_ring_free(nd->sockets[i].return_ring);
+	}
+	rte_free(nd);
+}
+
+static int
+numa_mempool_alloc(struct rte_mempool *mp)
+{
+	struct numa_mempool_data *nd;
+	char rg_name[RTE_RING_NAMESIZE];
+	unsigned int i, ring_size;
+	int rc, socket_id;
+
+	nd = rte_zmalloc_socket("numa_mempool", sizeof(*nd),
+		RTE_CACHE_LINE_SIZE, mp->socket_id);
+	if (nd == NULL)
+		return -ENOMEM;
+	mp->pool_data = nd;
+
+	nd->nb_sockets = RTE_MIN(rte_socket_count(),
+		(unsigned int)RTE_MAX_NUMA_NODES);
+	if (nd->nb_sockets == 0)
+		nd->nb_sockets = 1;
+	memset(nd->socket_idx, UINT8_MAX, sizeof(nd->socket_idx));
+	for (i = 0; i < nd->nb_sockets; i++) {
+		socket_id = rte_socket_id_by_idx(i);
+		if (socket_id >= 0 && socket_id < RTE_MAX_NUMA_NODES)
+			nd->socket_idx[socket_id] = i;
+	}
+	nd->default_socket = 0;
+	nd->default_socket = numa_mempool_socket_idx(nd, mp->socket_id);
+
+	/* every ring can hold all the objects */
+	ring_size = rte_align32pow2(mp->size + 1);
+	for (i = 0; i < nd->nb_sockets; i++) {
+		struct numa_mempool_socket *ns = &nd->sockets[i];
+
+		socket_id = rte_socket_id_by_idx(i);
+		if (socket_id < 0)
+			socket_id = mp->socket_id;
+
+		rc = snprintf(rg_name, sizeof(rg_name),
+			RTE_MEMPOOL_MZ_FORMAT ".f%u", mp->name, i);
+		if (rc < 0 || rc >= (int)sizeof(rg_name)) {
+			rc = -ENAMETOOLONG;
+			goto error;
+		}
+		ns->free_ring = rte_ring_create(rg_name, ring_size,
+			socket_id, 0);
+		if (ns->free_ring == NULL) {
+			rc = -rte_errno;
+			goto error;
+		}
+
+		rc = snprintf(rg_name, sizeof(rg_name),
+			RTE_MEMPOOL_MZ_FORMAT ".r%u", mp->name, i);
+		if (rc < 0 || rc >= (int)sizeof(rg_name)) {
+			rc = -ENAMETOOLONG;
+			goto error;
+		}
+		ns->return_ring = rte_ring_create(rg_name, ring_size,
+			socket_id, 0);
+		if (ns->return_ring == NULL) {
+			rc = -rte_errno;
+			goto error;
+		}
+	}
+
+	return 0;
+
+error:
+	numa_mempool_free(mp);
+	mp->pool_data = NULL;
+	return rc;
+}
+
+/*
+ * Record the socket of a memory chunk, keeping the ranges sorted.
+ * The chunk is merged with the ranges of the same socket it is contiguous to.
+ */
+static int
+numa_mempool_add_range(struct numa_mempool_data *nd, uintptr_t start,
+		uintptr_t end, unsigned int socket)
+{
+	struct numa_mempool_range *prev, *next;
+	unsigned int pos;
+
+	for (pos = 0; pos < nd->nb_ranges; pos++)
+		if (start < nd->ranges[pos].start)
+			break;
+
+	prev = pos > 0 ? &nd->ranges[pos - 1] : NULL;
+	next = pos < nd->nb_ranges ? &nd->ranges[pos] : NULL;
+	if (prev != NULL && prev->socket == socket && prev->end == start) {
+		prev->end = end;
+		/* the chunk fills the gap with the next range */
+		if (next != NULL && next->socket == socket &&
+				next->start == end) {
+			prev->end = next->end;
+			memmove(next, next + 1,
+				(nd->nb_ranges - pos - 1) * sizeof(*next));
+			nd->nb_ranges--;
+		}
+		return 0;
+	}
+	if (next != NULL && next->socket == socket && next->start == end) {
+		next->start = start;
+		return 0;
+	}
+
+	if (nd->nb_ranges == NUMA_MEMPOOL_MAX_RANGES)
+		return -ENOSPC;
+
+	memmove(&nd->ranges[pos + 1], &nd->ranges[pos],
+		(nd->nb_ranges - pos) * sizeof(nd->ranges[0]));
+	nd->ranges[pos].start = start;
+	nd->ranges[pos].end = end;
+	nd->ranges[pos].socket = socket;
+	nd->nb_ranges++;
+
+	return 0;
+}
+
+static int
+numa_mempool_populate(struct rte_mempool *mp, unsigned int max_objs,
+		void *vaddr, rte_iova_t iova, size_t len,
+		rte_mempool_populate_obj_cb_t *obj_cb, void *obj_cb_arg)
+{
+	struct numa_mempool_data *nd = mp->pool_data;
+	const struct rte_memseg_list *msl;
+	int socket_id, rc;
+
+	/* external or anonymous memory defaults to the mempool socket */
+	msl = rte_mem_virt2memseg_list(vaddr);
+	socket_id = msl != NULL && !msl->external ? msl->socket_id :
+		mp->socket_id;
+
+	rc = numa_mempool_add_range(nd, (uintptr_t)vaddr,
+		(uintptr_t)vaddr + len, numa_mempool_socket_idx(nd, socket_id));
+	if (rc < 0)
+		return rc;
+
+	nd->populating = true;
+	rc = rte_mempool_op_populate_helper(mp, 0, max_objs, vaddr, iova, len,
+		obj_cb, obj_cb_arg);
+	nd->populating = false;
+
+	return rc;
+}
+
+int
+rte_pmd_numa_mempool_stats_get(const struct rte_mempool *mp, int socket_id,
+		struct rte_pmd_numa_mempool_stats *stats)
+{
+	const struct numa_mempool_data *nd;
+	const struct numa_mempool_socket *ns;
+	unsigned int i;
+	bool found = false;
+
+	if (mp == NULL || stats == NULL ||
+			strcmp(rte_mempool_get_ops(mp->ops_index)->name,
+				"numa") != 0)
+		return -EINVAL;
+
+	nd = mp->pool_data;
+	if (nd == NULL)
+		return -EINVAL;
+
+	memset(stats, 0, sizeof(*stats));
+	for (i = 0; i < nd->nb_sockets; i++) {
+		if (socket_id != SOCKET_ID_ANY &&
+				socket_id != rte_socket_id_by_idx(i))
+			continue;
+
+		found = true;
+		ns = &nd->sockets[i];
+		stats->local_alloc += rte_atomic_load_explicit(
+			&ns->local_alloc, rte_memory_order_relaxed);
+		stats->remote_alloc += rte_atomic_load_explicit(
+			&ns->remote_alloc, rte_memory_order_relaxed);
+		stats->local_free += rte_atomic_load_explicit(
+			&ns->local_free, rte_memory_order_relaxed);
+		stats->remote_free += rte_atomic_load_explicit(
+			&ns->remote_free, rte_memory_order_relaxed);
+		stats->returned += rte_atomic_load_explicit(
+			&ns->returned, rte_memory_order_relaxed);
+		stats->free_count += rte_ring_count(ns->free_ring);
+		stats->return_count += rte_ring_count(ns->return_ring);
+	}
+
+	return found ? 0 : -EINVAL;
+}
+
+int
+rte_pmd_numa_mempool_stats_reset(struct rte_mempool *mp)
+{
+	struct numa_mempool_data *nd;
+	struct numa_mempool_socket *ns;
+	unsigned int i;
+
+	if (mp == NULL ||
+			strcmp(rte_mempool_get_ops(mp->ops_index)->name,
+				"numa") != 0)
+		return -EINVAL;
+
+	nd = mp->pool_data;
+	if (nd == NULL)
+		return -EINVAL;
+
+	for (i = 0; i < nd->nb_sockets; i++) {
+		ns = &nd->sockets[i];
+		rte_atomic_store_explicit(&ns->local_alloc, 0,
+			rte_memory_order_relaxed);
+		rte_atomic_store_explicit(&ns->remote_alloc, 0,
+			rte_memory_order_relaxed);
+		rte_atomic_store_explicit(&ns->local_free, 0,
+			rte_memory_order_relaxed);
+		rte_atomic_store_explicit(&ns->remote_free, 0,
+			rte_memory_order_relaxed);
+		rte_atomic_store_explicit(&ns->returned, 0,
+			rte_memory_order_relaxed);
+	}
+
+	return 0;
+}
+
+static const struct rte_mempool_ops ops_numa = {
+	.name = "numa",
+	.alloc = numa_mempool_alloc,
+	.free = numa_mempool_free,
+	.enqueue = numa_mempool_enqueue,
+	.dequeue = numa_mempool_dequeue,
+	.get_count = numa_mempool_get_count,
+	.populate = numa_mempool_populate,
+};
+
+RTE_MEMPOOL_REGISTER_OPS(ops_numa);
@@ -0,0 +1,84 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 The DPDK contributors
+ */
+
+/**
+ * @file rte_pmd_numa_mempool.h
+ * NUMA mempool driver specific functions.
+ *
+ **/
+
+#ifndef _RTE_PMD_NUMA_MEMPOOL_H_
+#define _RTE_PMD_NUMA_MEMPOOL_H_
+
+#include <stdint.h>
+
+#include <rte_compat.h>
+#include <rte_mempool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Cross-socket statistics of a NUMA mempool.
+ * Allocations and frees are accounted to the socket of the calling lcore.
+ */
+struct rte_pmd_numa_mempool_stats {
+	/** Objects allocated from the memory of the calling socket. */
+	uint64_t local_alloc;
+	/** Objects allocated from the memory of another socket. */
+	uint64_t remote_alloc;
+	/** Objects freed to the memory of the calling socket. */
+	uint64_t local_free;
+	/** Objects freed to the return ring of another socket. */
+	uint64_t remote_free;
+	/** Objects taken back from the return ring of the socket. */
+	uint64_t returned;
+	/** Objects in the free ring of the socket. */
+	uint64_t free_count;
+	/** Objects in the return ring of the socket. */
+	uint64_t return_count;
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the statistics of a mempool using the "numa" ops.
+ *
+ * @param mp
+ *   Pointer to the mempool.
+ * @param socket_id
+ *   The socket to get the statistics of,
+ *   or SOCKET_ID_ANY for the sum of all the sockets.
+ * @param stats
+ *   Pointer to the structure filled with the statistics.
+ * @return
+ *   0 on success, -EINVAL if the mempool does not use the "numa" ops
+ *   or the socket is not found.
+ */
+__rte_experimental
+int rte_pmd_numa_mempool_stats_get(const struct rte_mempool *mp,
+				   int socket_id,
+				   struct rte_pmd_numa_mempool_stats *stats);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Reset the allocation and free counters of a mempool using the "numa" ops.
+ *
+ * @param mp
+ *   Pointer to the mempool.
+ * @return
+ *   0 on success, -EINVAL if the mempool does not use the "numa" ops.
+ */
+__rte_experimental
+int rte_pmd_numa_mempool_stats_reset(struct rte_mempool *mp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_PMD_NUMA_MEMPOOL_H_ */
@@ -13,6 +13,7 @@
 #include <ethdev_vdev.h>
 #include <rte_malloc.h>
 #include <rte_kvargs.h>
+#include <rte_stdatomic.h>
 #include <bus_vdev_driver.h>
 
 #include <errno.h>
@@ -36,32 +37,74 @@
 #define ETH_AF_PACKET_FRAMESIZE_ARG	"framesz"
 #define ETH_AF_PACKET_FRAMECOUNT_ARG	"framecnt"
 #define ETH_AF_PACKET_QDISC_BYPASS_ARG	"qdisc_bypass"
+#define ETH_AF_PACKET_TPVER_ARG		"tpver"
+#define ETH_AF_PACKET_RX_ZEROCOPY_ARG	"rx_zerocopy"
 
 #define DFLT_FRAME_SIZE		(1 << 11)
 #define DFLT_FRAME_COUNT	(1 << 9)
+#define DFLT_BLOCK_SIZE_V3	(1 << 17)
 
 static uint64_t timestamp_dynflag;
 static int timestamp_dynfield_offset = -1;
 
+struct pkt_rx_zc;
+
+/*
+ * TPACKET_V3 Rx block lent to the mbufs attached to its frames.
+ * The reference count of the shared info counts these mbufs,
+ * plus one for the Rx burst while it walks the block.
+ */
+struct pkt_rx_block {
+	struct rte_mbuf_ext_shared_info shinfo;
+	struct tpacket_block_desc *pbd;
+	struct pkt_rx_zc *zc;
+	/* set from the opening of the block until it is given back */
+	RTE_ATOMIC(uint8_t) held;
+};
+
+/*
+ * TPACKET_V3 Rx ring of a zero-copy queue. As mbufs may still point
+ * into the ring when the queue is closed, it is unmapped on the last
+ * of the close and the release of the held blocks.
+ */
+struct pkt_rx_zc {
+	uint8_t *map;
+	size_t map_size;
+	/* held blocks, plus one until the queue is closed */
+	RTE_ATOMIC(uint32_t) refcnt;
+	struct pkt_rx_block blocks[];
+};
+
 struct __rte_cache_aligned pkt_rx_queue {
 	int sockfd;
 
+	/* frames with TPACKET_V2, blocks with TPACKET_V3 */
 	struct iovec *rd;
 	uint8_t *map;
 	unsigned int framecount;
 	unsigned int framenum;
 
+	/* TPACKET_V3 only */
+	struct tpacket3_hdr *ppd; /* next frame of the current block */
+	unsigned int pkts_left; /* frames left in the current block */
+	struct pkt_rx_zc *zc; /* zero-copy only */
+
 	struct rte_mempool *mb_pool;
 	uint16_t in_port;
+	uint8_t tpver;
+	uint8_t zerocopy;
 	uint8_t vlan_strip;
 	uint8_t timestamp_offloading;
 
 	volatile unsigned long rx_pkts;
 	volatile unsigned long rx_bytes;
+	volatile unsigned long err_pkts;
 };
 
 struct __rte_cache_aligned pkt_tx_queue {
 	int sockfd;
+	uint8_t tpver;
+	unsigned int frame_data_off;
 	unsigned int frame_data_size;
 
 	struct iovec *rd;
@@ -81,7 +124,9 @@ struct pmd_internals {
 	char *if_name;
 	struct rte_ether_addr eth_addr;
 
-	struct tpacket_req req;
+	/* only the tpacket_req fields are used with TPACKET_V2 */
+	struct tpacket_req3 req;
+	int tpver;
 
 	struct pkt_rx_queue *rx_queue;
 	struct pkt_tx_queue *tx_queue;
@@ -96,6 +141,8 @@ static const char *valid_arguments[] = {
 	ETH_AF_PACKET_FRAMESIZE_ARG,
 	ETH_AF_PACKET_FRAMECOUNT_ARG,
 	ETH_AF_PACKET_QDISC_BYPASS_ARG,
+	ETH_AF_PACKET_TPVER_ARG,
+	ETH_AF_PACKET_RX_ZEROCOPY_ARG,
 	NULL
 };
 
@@ -189,6 +236,219 @@ eth_af_packet_rx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	return num_rx;
 }
 
+/*
+ * Give a TPACKET_V3 block back to the kernel
+ */
+static inline void
+rx_block_release(struct tpacket_block_desc *pbd)
+{
+	/* the frames must be read before the kernel overwrites them */
+	rte_atomic_thread_fence(rte_memory_order_release);
+	pbd->hdr.bh1.block_status = TP_STATUS_KERNEL;
+}
+
+static void
+rx_zc_put(struct pkt_rx_zc *zc)
+{
+	if (rte_atomic_fetch_sub_explicit(&zc->refcnt, 1,
+			rte_memory_order_acq_rel) != 1)
+		return;
+
+	munmap(zc->map, zc->map_size);
+	rte_free(zc);
+}
+
+/*
+ * Called when the last mbuf attached to a block is freed,
+ * after the Rx burst is done with the block.
+ */
+static void
+rx_block_free_cb(void *addr __rte_unused, void *opaque)
+{
+	struct pkt_rx_block *block = opaque;
+
+	rx_block_release(block->pbd);
+	/* the block can be opened again once the kernel owns it */
+	rte_atomic_store_explicit(&block->held, 0, rte_memory_order_release);
+	rx_zc_put(block->zc);
+}
+
+/*
+ * Drop the reference of the Rx burst on a block
+ */
+static inline void
+rx_block_put(struct pkt_rx_queue *pkt_q, unsigned int blocknum)
+{
+	struct pkt_rx_block *block;
+
+	if (!pkt_q->zerocopy) {
+		rx_block_release(pkt_q->rd[blocknum].iov_base);
+		return;
+	}
+
+	block = &pkt_q->zc->blocks[blocknum];
+	if (rte_mbuf_ext_refcnt_update(&block->shinfo, -1) == 0)
+		rx_block_free_cb(NULL, block);
+}
+
+/*
+ * Insert the VLAN tag stripped by the kernel in the frame headroom,
+ * rte_vlan_insert() does not work on mbufs with an external buffer.
+ */
+static inline void
+rx_vlan_insert_inplace(struct rte_mbuf *mbuf)
+{
+	struct rte_ether_hdr *oh, *nh;
+	struct rte_vlan_hdr *vh;
+
+	oh = rte_pktmbuf_mtod(mbuf, struct rte_ether_hdr *);
+	nh = (struct rte_ether_hdr *)
+		rte_pktmbuf_prepend(mbuf, sizeof(struct rte_vlan_hdr));
+	memmove(nh, oh, 2 * RTE_ETHER_ADDR_LEN);
+	nh->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_VLAN);
+
+	vh = (struct rte_vlan_hdr *)(nh + 1);
+	vh->vlan_tci = rte_cpu_to_be_16(mbuf->vlan_tci);
+
+	mbuf->ol_flags &= ~RTE_MBUF_F_RX_VLAN_STRIPPED;
+}
+
+/*
+ * Receive from a TPACKET_V3 ring: the kernel retires a block of frames
+ * at once, and the block is given back once all its frames are read.
+ * In zero-copy mode, the mbufs point into the block, which is given back
+ * when the last of them is freed. A held block still has the user status,
+ * it is not read again until given back. When half of the ring is held
+ * this way, the frames are copied so that the kernel does not run out
+ * of blocks.
+ */
+static uint16_t
+eth_af_packet_rx_v3(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
+{
+	struct pkt_rx_queue *pkt_q = queue;
+	struct tpacket_block_desc *pbd;
+	struct tpacket3_hdr *ppd;
+	struct pkt_rx_block *block = NULL;
+	struct rte_mbuf *mbuf;
+	unsigned int blocknum, snaplen;
+	uint16_t num_rx = 0;
+	unsigned long num_rx_bytes = 0;
+	unsigned long num_err = 0;
+	bool copy;
+
+	if (unlikely(nb_pkts == 0))
+		return 0;
+
+	blocknum = pkt_q->framenum;
+	pbd = pkt_q->rd[blocknum].iov_base;
+	copy = !pkt_q->zerocopy ||
+		rte_atomic_load_explicit(&pkt_q->zc->refcnt,
+			rte_memory_order_relaxed) > pkt_q->framecount / 2;
+	if (pkt_q->zerocopy)
+		block = &pkt_q->zc->blocks[blocknum];
+
+	while (num_rx < nb_pkts) {
+		if (pkt_q->pkts_left == 0) {
+			/* release the current block and open the next one */
+			if (pkt_q->ppd != NULL) {
+				rx_block_put(pkt_q, blocknum);
+				pkt_q->ppd = NULL;
+				if (++blocknum >= pkt_q->framecount)
+					blocknum = 0;
+				pbd = pkt_q->rd[blocknum].iov_base;
+				if (pkt_q->zerocopy)
+					block = &pkt_q->zc->blocks[blocknum];
+			}
+			if (block != NULL &&
+					rte_atomic_load_explicit(&block->held,
+						rte_memory_order_acquire))
+				break;
+			if ((pbd->hdr.bh1.block_status & TP_STATUS_USER) == 0)
+				break;
+			rte_atomic_thread_fence(rte_memory_order_acquire);
+
+			pkt_q->pkts_left = pbd->hdr.bh1.num_pkts;
+			pkt_q->ppd = (struct tpacket3_hdr *)((uint8_t *)pbd +
+				pbd->hdr.bh1.offset_to_first_pkt);
+			if (block != NULL) {
+				rte_atomic_store_explicit(&block->held, 1,
+					rte_memory_order_relaxed);
+				rte_atomic_fetch_add_explicit(&pkt_q->zc->refcnt,
+					1, rte_memory_order_relaxed);
+				rte_mbuf_ext_refcnt_set(&block->shinfo,
+					pkt_q->pkts_left + 1);
+			}
+			continue;
+		}
+
+		/* allocate the next mbuf */
+		mbuf = rte_pktmbuf_alloc(pkt_q->mb_pool);
+		if (unlikely(mbuf == NULL))
+			break;
+
+		/* point at the next incoming frame */
+		ppd = pkt_q->ppd;
+		pkt_q->ppd = (struct tpacket3_hdr *)((uint8_t *)ppd +
+			ppd->tp_next_offset);
+		pkt_q->pkts_left--;
+
+		snaplen = ppd->tp_snaplen;
+		if (!copy || snaplen > rte_pktmbuf_tailroom(mbuf)) {
+			if (unlikely(block == NULL ||
+					ppd->tp_mac + snaplen > UINT16_MAX)) {
+				/* frame does not fit in the mbuf */
+				rte_pktmbuf_free(mbuf);
+				if (block != NULL)
+					rte_mbuf_ext_refcnt_update(&block->shinfo, -1);
+				num_err++;
+				continue;
+			}
+			rte_pktmbuf_attach_extbuf(mbuf, ppd, RTE_BAD_IOVA,
+				ppd->tp_mac + snaplen, &block->shinfo);
+			mbuf->data_off = ppd->tp_mac;
+		} else {
+			memcpy(rte_pktmbuf_mtod(mbuf, void *),
+				(uint8_t *)ppd + ppd->tp_mac, snaplen);
+			if (block != NULL)
+				rte_mbuf_ext_refcnt_update(&block->shinfo, -1);
+		}
+		rte_pktmbuf_pkt_len(mbuf) = rte_pktmbuf_data_len(mbuf) = snaplen;
+
+		/* check for vlan info */
+		if (ppd->tp_status & TP_STATUS_VLAN_VALID) {
+			mbuf->vlan_tci = ppd->hv1.tp_vlan_tci;
+			mbuf->ol_flags |= (RTE_MBUF_F_RX_VLAN | RTE_MBUF_F_RX_VLAN_STRIPPED);
+
+			if (!pkt_q->vlan_strip) {
+				if (RTE_MBUF_HAS_EXTBUF(mbuf))
+					rx_vlan_insert_inplace(mbuf);
+				else if (rte_vlan_insert(&mbuf))
+					PMD_LOG(ERR, "Failed to reinsert VLAN tag");
+			}
+		}
+
+		/* add kernel provided timestamp when offloading is enabled */
+		if (pkt_q->timestamp_offloading) {
+			*RTE_MBUF_DYNFIELD(mbuf, timestamp_dynfield_offset,
+				rte_mbuf_timestamp_t *) =
+					(uint64_t)ppd->tp_sec * 1000000000 + ppd->tp_nsec;
+
+			mbuf->ol_flags |= timestamp_dynflag;
+		}
+
+		mbuf->port = pkt_q->in_port;
+
+		/* account for the receive frame */
+		bufs[num_rx++] = mbuf;
+		num_rx_bytes += mbuf->pkt_len;
+	}
+	pkt_q->framenum = blocknum;
+	pkt_q->rx_pkts += num_rx;
+	pkt_q->rx_bytes += num_rx_bytes;
+	pkt_q->err_pkts += num_err;
+	return num_rx;
+}
+
 /*
  * Check if there is an available frame in the ring
  */
@@ -209,13 +469,42 @@ tx_ring_status_available(uint32_t tp_status)
 	return tp_status == TP_STATUS_AVAILABLE;
 }
 
+/*
+ * The Tx frames of TPACKET_V2 and TPACKET_V3 only differ by their header
+ */
+static inline uint32_t *
+tx_frame_status(const struct pkt_tx_queue *pkt_q, void *ppd)
+{
+	if (pkt_q->tpver == TPACKET_V3)
+		return &((struct tpacket3_hdr *)ppd)->tp_status;
+	return &((struct tpacket2_hdr *)ppd)->tp_status;
+}
+
+static inline void
+tx_frame_set_len(const struct pkt_tx_queue *pkt_q, void *ppd, uint32_t len)
+{
+	if (pkt_q->tpver == TPACKET_V3) {
+		struct tpacket3_hdr *ppd3 = ppd;
+
+		/* variable frame size is not supported on Tx */
+		ppd3->tp_next_offset = 0;
+		ppd3->tp_len = len;
+		ppd3->tp_snaplen = len;
+	} else {
+		struct tpacket2_hdr *ppd2 = ppd;
+
+		ppd2->tp_len = len;
+		ppd2->tp_snaplen = len;
+	}
+}
+
 /*
  * Callback to handle sending packets through a real NIC.
  */
 static uint16_t
 eth_af_packet_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 {
-	struct tpacket2_hdr *ppd;
+	void *ppd;
 	struct rte_mbuf *mbuf;
 	uint8_t *pbuf;
 	unsigned int framecount, framenum;
@@ -235,7 +524,7 @@ eth_af_packet_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 
 	framecount = pkt_q->framecount;
 	framenum = pkt_q->framenum;
-	ppd = (struct tpacket2_hdr *) pkt_q->rd[framenum].iov_base;
+	ppd = pkt_q->rd[framenum].iov_base;
 	for (i = 0; i < nb_pkts; i++) {
 		mbuf = *bufs++;
 
@@ -254,7 +543,7 @@ eth_af_packet_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 		}
 
 		/* point at the next incoming frame */
-		if (!tx_ring_status_available(ppd->tp_status)) {
+		if (!tx_ring_status_available(*tx_frame_status(pkt_q, ppd))) {
 			if (poll(&pfd, 1, -1) < 0)
 				break;
 
@@ -277,12 +566,11 @@ eth_af_packet_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 		 *
 		 * This results in poll() returning POLLOUT.
 		 */
-		if (!tx_ring_status_available(ppd->tp_status))
+		if (!tx_ring_status_available(*tx_frame_status(pkt_q, ppd)))
 			break;
 
 		/* copy the tx frame data */
-		pbuf = (uint8_t *) ppd + TPACKET2_HDRLEN -
-			sizeof(struct sockaddr_ll);
+		pbuf = (uint8_t *) ppd + pkt_q->frame_data_off;
 
 		struct rte_mbuf *tmp_mbuf = mbuf;
 		while (tmp_mbuf) {
@@ -292,14 +580,13 @@ eth_af_packet_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 			tmp_mbuf = tmp_mbuf->next;
 		}
 
-		ppd->tp_len = mbuf->pkt_len;
-		ppd->tp_snaplen = mbuf->pkt_len;
+		tx_frame_set_len(pkt_q, ppd, mbuf->pkt_len);
 
 		/* release incoming frame and advance ring buffer */
-		ppd->tp_status = TP_STATUS_SEND_REQUEST;
+		*tx_frame_status(pkt_q, ppd) = TP_STATUS_SEND_REQUEST;
 		if (++framenum >= framecount)
 			framenum = 0;
-		ppd = (struct tpacket2_hdr *) pkt_q->rd[framenum].iov_base;
+		ppd = pkt_q->rd[framenum].iov_base;
 
 		num_tx++;
 		num_tx_bytes += mbuf->pkt_len;
@@ -417,7 +704,8 @@ static int
 eth_stats_get(struct rte_eth_dev *dev, struct rte_eth_stats *igb_stats)
 {
 	unsigned i, imax;
-	unsigned long rx_total = 0, tx_total = 0, tx_err_total = 0;
+	unsigned long rx_total = 0, rx_err_total = 0;
+	unsigned long tx_total = 0, tx_err_total = 0;
 	unsigned long rx_bytes_total = 0, tx_bytes_total = 0;
 	const struct pmd_internals *internal = dev->data->dev_private;
 
@@ -427,6 +715,7 @@ eth_stats_get(struct rte_eth_dev *dev, struct rte_eth_stats *igb_stats)
 		igb_stats->q_ipackets[i] = internal->rx_queue[i].rx_pkts;
 		igb_stats->q_ibytes[i] = internal->rx_queue[i].rx_bytes;
 		rx_total += igb_stats->q_ipackets[i];
+		rx_err_total += internal->rx_queue[i].err_pkts;
 		rx_bytes_total += igb_stats->q_ibytes[i];
 	}
 
@@ -442,6 +731,7 @@ eth_stats_get(struct rte_eth_dev *dev, struct rte_eth_stats *igb_stats)
 
 	igb_stats->ipackets = rx_total;
 	igb_stats->ibytes = rx_bytes_total;
+	igb_stats->ierrors = rx_err_total;
 	igb_stats->opackets = tx_total;
 	igb_stats->oerrors = tx_err_total;
 	igb_stats->obytes = tx_bytes_total;
@@ -457,6 +747,7 @@ eth_stats_reset(struct rte_eth_dev *dev)
 	for (i = 0; i < internal->nb_queues; i++) {
 		internal->rx_queue[i].rx_pkts = 0;
 		internal->rx_queue[i].rx_bytes = 0;
+		internal->rx_queue[i].err_pkts = 0;
 	}
 
 	for (i = 0; i < internal->nb_queues; i++) {
@@ -472,7 +763,7 @@ static int
 eth_dev_close(struct rte_eth_dev *dev)
 {
 	struct pmd_internals *internals;
-	struct tpacket_req *req;
+	struct tpacket_req3 *req;
 	unsigned int q;
 
 	if (rte_eal_process_type() != RTE_PROC_PRIMARY)
@@ -484,8 +775,25 @@ eth_dev_close(struct rte_eth_dev *dev)
 	internals = dev->data->dev_private;
 	req = &internals->req;
 	for (q = 0; q < internals->nb_queues; q++) {
-		munmap(internals->rx_queue[q].map,
-			2 * req->tp_block_size * req->tp_block_nr);
+		struct pkt_rx_queue *rxq = &internals->rx_queue[q];
+
+		/* a zero-copy ring is unmapped with its last held block */
+		if (rxq->zc != NULL) {
+			if (rxq->ppd != NULL) {
+				struct pkt_rx_block *block =
+					&rxq->zc->blocks[rxq->framenum];
+
+				/* drop the frames never received, and the burst */
+				if (rte_mbuf_ext_refcnt_update(&block->shinfo,
+						-(int16_t)(rxq->pkts_left + 1)) == 0)
+					rx_block_free_cb(NULL, block);
+				rxq->ppd = NULL;
+				rxq->pkts_left = 0;
+			}
+			rx_zc_put(rxq->zc);
+		} else
+			munmap(internals->rx_queue[q].map,
+				2 * req->tp_block_size * req->tp_block_nr);
 		rte_free(internals->rx_queue[q].rd);
 		rte_free(internals->tx_queue[q].rd);
 	}
@@ -518,6 +826,12 @@ eth_link_update(struct rte_eth_dev *dev,
 	return 0;
 }
 
+static unsigned int
+tpacket_hdrlen(int tpver)
+{
+	return tpver == TPACKET_V3 ? TPACKET3_HDRLEN : TPACKET2_HDRLEN;
+}
+
 static int
 eth_rx_queue_setup(struct rte_eth_dev *dev,
                    uint16_t rx_queue_id,
@@ -536,7 +850,7 @@ eth_rx_queue_setup(struct rte_eth_dev *dev,
 	buf_size = rte_pktmbuf_data_room_size(pkt_q->mb_pool) -
 		RTE_PKTMBUF_HEADROOM;
 	data_size = internals->req.tp_frame_size;
-	data_size -= TPACKET2_HDRLEN - sizeof(struct sockaddr_ll);
+	data_size -= tpacket_hdrlen(internals->tpver) - sizeof(struct sockaddr_ll);
 
 	if (data_size > buf_size) {
 		PMD_LOG(ERR,
@@ -575,7 +889,7 @@ eth_dev_mtu_set(struct rte_eth_dev *dev, uint16_t mtu)
 	int ret;
 	int s;
 	unsigned int data_size = internals->req.tp_frame_size -
-				 TPACKET2_HDRLEN;
+				 tpacket_hdrlen(internals->tpver);
 
 	if (mtu > data_size)
 		return -EINVAL;
@@ -709,6 +1023,8 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
                        unsigned int framesize,
                        unsigned int framecnt,
 		       unsigned int qdisc_bypass,
+		       int tpver,
+		       unsigned int zerocopy,
                        struct pmd_internals **internals,
                        struct rte_eth_dev **eth_dev,
                        struct rte_kvargs *kvlist)
@@ -721,10 +1037,11 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 	size_t ifnamelen;
 	unsigned k_idx;
 	struct sockaddr_ll sockaddr;
-	struct tpacket_req *req;
+	struct tpacket_req3 *req;
+	socklen_t reqsize;
 	struct pkt_rx_queue *rx_queue;
 	struct pkt_tx_queue *tx_queue;
-	int rc, tpver, discard;
+	int rc, discard;
 	int qsockfd = -1;
 	unsigned int i, q, rdsize;
 #if defined(PACKET_FANOUT)
@@ -778,6 +1095,11 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 	req->tp_block_nr = blockcnt;
 	req->tp_frame_size = framesize;
 	req->tp_frame_nr = framecnt;
+	/* the Tx ring has no block timeout, let the kernel choose it on Rx */
+	req->tp_retire_blk_tov = 0;
+	reqsize = tpver == TPACKET_V3 ? sizeof(struct tpacket_req3) :
+		sizeof(struct tpacket_req);
+	(*internals)->tpver = tpver;
 
 	ifnamelen = strlen(pair->value);
 	if (ifnamelen < sizeof(ifr.ifr_name)) {
@@ -827,7 +1149,6 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 			goto error;
 		}
 
-		tpver = TPACKET_V2;
 		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_VERSION,
 				&tpver, sizeof(tpver));
 		if (rc == -1) {
@@ -860,7 +1181,7 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 #endif
 		}
 
-		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_RX_RING, req, sizeof(*req));
+		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_RX_RING, req, reqsize);
 		if (rc == -1) {
 			PMD_LOG_ERRNO(ERR,
 				"%s: could not set PACKET_RX_RING on AF_PACKET socket for %s",
@@ -868,7 +1189,7 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 			goto error;
 		}
 
-		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_TX_RING, req, sizeof(*req));
+		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_TX_RING, req, reqsize);
 		if (rc == -1) {
 			PMD_LOG_ERRNO(ERR,
 				"%s: could not set PACKET_TX_RING on AF_PACKET "
@@ -877,7 +1198,10 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 		}
 
 		rx_queue = &((*internals)->rx_queue[q]);
-		rx_queue->framecount = req->tp_frame_nr;
+		rx_queue->tpver = tpver;
+		rx_queue->zerocopy = zerocopy;
+		rx_queue->framecount = tpver == TPACKET_V3 ?
+			req->tp_block_nr : req->tp_frame_nr;
 
 		rx_queue->map = mmap(NULL, 2 * req->tp_block_size * req->tp_block_nr,
 				    PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED,
@@ -889,23 +1213,56 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 			goto error;
 		}
 
-		/* rdsize is same for both Tx and Rx */
-		rdsize = req->tp_frame_nr * sizeof(*(rx_queue->rd));
+		/* Rx walks blocks with TPACKET_V3, frames otherwise */
+		rdsize = rx_queue->framecount * sizeof(*(rx_queue->rd));
 
 		rx_queue->rd = rte_zmalloc_socket(name, rdsize, 0, numa_node);
 		if (rx_queue->rd == NULL)
 			goto error;
-		for (i = 0; i < req->tp_frame_nr; ++i) {
-			rx_queue->rd[i].iov_base = rx_queue->map + (i * framesize);
-			rx_queue->rd[i].iov_len = req->tp_frame_size;
+		for (i = 0; i < rx_queue->framecount; ++i) {
+			if (tpver == TPACKET_V3) {
+				rx_queue->rd[i].iov_base = rx_queue->map +
+					(i * blocksize);
+				rx_queue->rd[i].iov_len = req->tp_block_size;
+			} else {
+				rx_queue->rd[i].iov_base = rx_queue->map +
+					(i * framesize);
+				rx_queue->rd[i].iov_len = req->tp_frame_size;
+			}
 		}
 		rx_queue->sockfd = qsockfd;
 
+		if (zerocopy) {
+			struct pkt_rx_zc *zc;
+
+			zc = rte_zmalloc_socket(name, sizeof(*zc) +
+				req->tp_block_nr * sizeof(zc->blocks[0]),
+				0, numa_node);
+			if (zc == NULL)
+				goto error;
+			zc->map = rx_queue->map;
+			zc->map_size = 2 * req->tp_block_size * req->tp_block_nr;
+			rte_atomic_store_explicit(&zc->refcnt, 1,
+				rte_memory_order_relaxed);
+			for (i = 0; i < req->tp_block_nr; ++i) {
+				struct pkt_rx_block *block = &zc->blocks[i];
+
+				block->pbd = rx_queue->rd[i].iov_base;
+				block->zc = zc;
+				block->shinfo.free_cb = rx_block_free_cb;
+				block->shinfo.fcb_opaque = block;
+			}
+			rx_queue->zc = zc;
+		}
+
 		tx_queue = &((*internals)->tx_queue[q]);
+		tx_queue->tpver = tpver;
 		tx_queue->framecount = req->tp_frame_nr;
-		tx_queue->frame_data_size = req->tp_frame_size;
-		tx_queue->frame_data_size -= TPACKET2_HDRLEN -
+		tx_queue->frame_data_off = tpacket_hdrlen(tpver) -
 			sizeof(struct sockaddr_ll);
+		tx_queue->frame_data_size = req->tp_frame_size -
+			tx_queue->frame_data_off;
+		rdsize = req->tp_frame_nr * sizeof(*(tx_queue->rd));
 
 		tx_queue->map = rx_queue->map + req->tp_block_size * req->tp_block_nr;
 
@@ -974,6 +1331,8 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 			       2 * req->tp_block_size * req->tp_block_nr);
 
 		rte_free((*internals)->rx_queue[q].rd);
+		/* no block was lent yet, the ring is unmapped above */
+		rte_free((*internals)->rx_queue[q].zc);
 		rte_free((*internals)->tx_queue[q].rd);
 		if (((*internals)->rx_queue[q].sockfd >= 0) &&
 			((*internals)->rx_queue[q].sockfd != qsockfd))
@@ -998,18 +1357,18 @@ rte_eth_from_packet(struct rte_vdev_device *dev,
 	struct rte_kvargs_pair *pair = NULL;
 	unsigned k_idx;
 	unsigned int blockcount;
-	unsigned int blocksize;
+	unsigned int blocksize = 0;
 	unsigned int framesize = DFLT_FRAME_SIZE;
 	unsigned int framecount = DFLT_FRAME_COUNT;
 	unsigned int qpairs = 1;
 	unsigned int qdisc_bypass = 1;
+	unsigned int zerocopy = 0;
+	int tpver = TPACKET_V2;
 
 	/* do some parameter checking */
 	if (*sockfd < 0)
 		return -1;
 
-	blocksize = getpagesize();
-
 	/*
 	 * Walk arguments for configurable settings
 	 */
@@ -1065,6 +1424,53 @@ rte_eth_from_packet(struct rte_vdev_device *dev,
 			}
 			continue;
 		}
+		if (strstr(pair->key, ETH_AF_PACKET_TPVER_ARG) != NULL) {
+			switch (atoi(pair->value)) {
+			case 2:
+				tpver = TPACKET_V2;
+				break;
+			case 3:
+				tpver = TPACKET_V3;
+				break;
+			default:
+				PMD_LOG(ERR,
+					"%s: invalid tpver value",
+					name);
+				return -1;
+			}
+			continue;
+		}
+		if (strstr(pair->key, ETH_AF_PACKET_RX_ZEROCOPY_ARG) != NULL) {
+			zerocopy = atoi(pair->value);
+			if (zerocopy > 1) {
+				PMD_LOG(ERR,
+					"%s: invalid rx_zerocopy value",
+					name);
+				return -1;
+			}
+			continue;
+		}
+	}
+
+	/* a TPACKET_V3 block should hold many frames */
+	if (!blocksize)
+		blocksize = tpver == TPACKET_V3 ? DFLT_BLOCK_SIZE_V3 :
+			(unsigned int)getpagesize();
+
+	if (zerocopy && tpver != TPACKET_V3) {
+		PMD_LOG(ERR,
+			"%s: Rx zero-copy requires tpver=3",
+			name);
+		return -1;
+	}
+
+	/* the frames of a block are counted in the mbuf shared info */
+	if (zerocopy &&
+			blocksize / TPACKET_ALIGN(TPACKET3_HDRLEN) >= UINT16_MAX) {
+		PMD_LOG(ERR,
+			"%s: AF_PACKET MMAP block size too large for Rx zero-copy",
+			name);
+		return -1;
 	}
 
 	if (framesize > blocksize) {
@@ -1086,16 +1492,23 @@ rte_eth_from_packet(struct rte_vdev_device *dev,
 	PMD_LOG(INFO, "%s:\tblock count %d", name, blockcount);
 	PMD_LOG(INFO, "%s:\tframe size %d", name, framesize);
 	PMD_LOG(INFO, "%s:\tframe count %d", name, framecount);
+	PMD_LOG(INFO, "%s:\tTPACKET version %d", name,
+		tpver == TPACKET_V3 ? 3 : 2);
+	PMD_LOG(INFO, "%s:\tRx zero-copy %u", name, zerocopy);
 
 	if (rte_pmd_init_internals(dev, *sockfd, qpairs,
 				   blocksize, blockcount,
 				   framesize, framecount,
 				   qdisc_bypass,
+				   tpver, zerocopy,
 				   &internals, &eth_dev,
 				   kvlist) < 0)
 		return -1;
 
-	eth_dev->rx_pkt_burst = eth_af_packet_rx;
+	if (tpver == TPACKET_V3)
+		eth_dev->rx_pkt_burst = eth_af_packet_rx_v3;
+	else
+		eth_dev->rx_pkt_burst = eth_af_packet_rx;
 	eth_dev->tx_pkt_burst = eth_af_packet_tx;
 
 	rte_eth_dev_probing_finish(eth_dev);
@@ -1187,4 +1600,6 @@ RTE_PMD_REGISTER_PARAM_STRING(net_af_packet,
 	"blocksz=<int> "
 	"framesz=<int> "
 	"framecnt=<int> "
-	"qdisc_bypass=<0|1>");
+	"qdisc_bypass=<0|1> "
+	"tpver=<2|3> "
+	"rx_zerocopy=<0|1>");
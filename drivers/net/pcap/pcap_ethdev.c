@@ -20,6 +20,7 @@
 #include <rte_os_shim.h>
 
 #include "pcap_osdep.h"
+#include "pcap_mmap.h"
 
 #define RTE_ETH_PCAP_SNAPSHOT_LEN 65535
 #define RTE_ETH_PCAP_SNAPLEN RTE_ETHER_MAX_JUMBO_FRAME_LEN
@@ -34,11 +35,18 @@
 #define ETH_PCAP_IFACE_ARG    "iface"
 #define ETH_PCAP_PHY_MAC_ARG  "phy_mac"
 #define ETH_PCAP_INFINITE_RX_ARG  "infinite_rx"
+#define ETH_PCAP_RX_MMAP_ARG  "rx_mmap"
+#define ETH_PCAP_REPLAY_SPEED_ARG  "replay_speed"
 
 #define ETH_PCAP_ARG_MAXLEN	64
 
 #define RTE_PMD_PCAP_MAX_QUEUES 16
 
+#define NSEC_PER_SEC	1000000000L
+
+/* Buffer of the pcap records written in a Tx burst */
+#define RTE_ETH_PCAP_TX_BUF_SIZE (1 << 18)
+
 static char errbuf[PCAP_ERRBUF_SIZE];
 static struct timespec start_time;
 static uint64_t start_cycles;
@@ -75,12 +83,21 @@ struct pcap_rx_queue {
 
 	/* Contains pre-generated packets to be looped through */
 	struct rte_ring *pkts;
+
+	/* Mapped pcap file, with the timing of its replay */
+	struct pcap_mmap *mmap;
+	unsigned int infinite_rx;
+	double cycles_per_ns; /* 0 if not paced */
+	uint64_t replay_cycles; /* 0 until the first packet */
+	uint64_t first_ts;
+	uint64_t loop_ts;
 };
 
 struct pcap_tx_queue {
 	uint16_t port_id;
 	uint16_t queue_id;
 	struct queue_stat tx_stat;
+	uint8_t *buf;
 	char name[PATH_MAX];
 	char type[ETH_PCAP_ARG_MAXLEN];
 };
@@ -94,6 +111,8 @@ struct pmd_internals {
 	int single_iface;
 	int phy_mac;
 	unsigned int infinite_rx;
+	unsigned int rx_mmap;
+	double replay_speed;
 };
 
 struct pmd_process_private {
@@ -122,6 +141,8 @@ struct pmd_devargs_all {
 	unsigned int is_rx_pcap;
 	unsigned int is_rx_iface;
 	unsigned int infinite_rx;
+	unsigned int rx_mmap;
+	double replay_speed;
 };
 
 static const char *valid_arguments[] = {
@@ -133,6 +154,8 @@ static const char *valid_arguments[] = {
 	ETH_PCAP_IFACE_ARG,
 	ETH_PCAP_PHY_MAC_ARG,
 	ETH_PCAP_INFINITE_RX_ARG,
+	ETH_PCAP_RX_MMAP_ARG,
+	ETH_PCAP_REPLAY_SPEED_ARG,
 	NULL
 };
 
@@ -339,6 +362,118 @@ eth_pcap_rx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	return num_rx;
 }
 
+/*
+ * Receive mbufs attached to the packets of the mapped pcap file,
+ * when their time has come if the replay is paced.
+ */
+static uint16_t
+eth_pcap_rx_mmap(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
+{
+	struct pcap_rx_queue *pcap_q = queue;
+	struct pcap_mmap *pm = pcap_q->mmap;
+	struct rte_mbuf_ext_shared_info *shinfo = NULL, *pkt_shinfo;
+	struct pcap_mmap_pkt pkt;
+	struct rte_mbuf *mbuf;
+	uint16_t num_rx = 0;
+	uint32_t rx_bytes = 0;
+	uint32_t refs = 0;
+	uint64_t now = 0;
+	int64_t delay;
+	bool rewound = false;
+	int ret;
+
+	if (unlikely(nb_pkts == 0))
+		return 0;
+
+	if (pcap_q->cycles_per_ns != 0)
+		now = rte_get_timer_cycles();
+
+	while (num_rx < nb_pkts) {
+		ret = pcap_mmap_read(pm, &pkt);
+		if (unlikely(ret != 1)) {
+			if (ret < 0)
+				pcap_q->rx_stat.err_pkts++;
+
+			/* stop if the file has no packet */
+			if (!pcap_q->infinite_rx || rewound)
+				break;
+
+			/* replay the file again, after its last packet */
+			pcap_q->loop_ts += pm->last_ts - pcap_q->first_ts;
+			pcap_mmap_rewind(pm);
+			rewound = true;
+			continue;
+		}
+
+		if (pcap_q->cycles_per_ns != 0) {
+			if (pcap_q->replay_cycles == 0) {
+				pcap_q->replay_cycles = now;
+				pcap_q->first_ts = pkt.ts;
+			}
+
+			/* packets earlier than the first one are not delayed */
+			delay = pkt.ts + pcap_q->loop_ts - pcap_q->first_ts;
+			if (delay > 0 && pcap_q->replay_cycles +
+					(uint64_t)(delay * pcap_q->cycles_per_ns) > now)
+				break;
+		}
+
+		mbuf = rte_pktmbuf_alloc(pcap_q->mb_pool);
+		if (unlikely(mbuf == NULL)) {
+			pcap_q->rx_stat.rx_nombuf++;
+			break;
+		}
+
+		/* a file chunk counts the mbufs pointing into it */
+		pkt_shinfo = pcap_mmap_shinfo(pm, &pkt);
+		if (pkt_shinfo != shinfo) {
+			if (refs != 0)
+				rte_mbuf_ext_refcnt_update(shinfo, refs);
+			shinfo = pkt_shinfo;
+			refs = 0;
+		}
+
+		if (likely(pkt.caplen <= UINT16_MAX &&
+				rte_mbuf_ext_refcnt_read(shinfo) + refs <
+					UINT16_MAX)) {
+			rte_pktmbuf_attach_extbuf(mbuf, pkt.data, RTE_BAD_IOVA,
+				pkt.caplen, shinfo);
+			mbuf->data_len = pkt.caplen;
+			refs++;
+		} else if (pkt.caplen <= rte_pktmbuf_tailroom(mbuf)) {
+			/* too many mbufs attached, copy the packet */
+			rte_memcpy(rte_pktmbuf_mtod(mbuf, void *), pkt.data,
+				pkt.caplen);
+			mbuf->data_len = pkt.caplen;
+		} else if (unlikely(pkt.caplen > UINT16_MAX ||
+				eth_pcap_rx_jumbo(pcap_q->mb_pool, mbuf,
+					pkt.data, pkt.caplen) == -1)) {
+			pcap_q->rx_stat.err_pkts++;
+			rte_pktmbuf_free(mbuf);
+			break;
+		}
+
+		mbuf->pkt_len = pkt.caplen;
+		*RTE_MBUF_DYNFIELD(mbuf, timestamp_dynfield_offset,
+			rte_mbuf_timestamp_t *) = pkt.ts / (NSEC_PER_SEC / US_PER_S);
+		mbuf->ol_flags |= timestamp_rx_dynflag;
+		mbuf->port = pcap_q->port_id;
+		bufs[num_rx] = mbuf;
+		num_rx++;
+		rx_bytes += pkt.caplen;
+
+		pcap_mmap_consume(pm, &pkt);
+		rewound = false;
+	}
+	if (refs != 0)
+		rte_mbuf_ext_refcnt_update(shinfo, refs);
+
+	pcap_q->rx_stat.pkts += num_rx;
+	pcap_q->rx_stat.bytes += rx_bytes;
+
+	return num_rx;
+}
+
 static uint16_t
 eth_null_rx(void *queue __rte_unused,
 		struct rte_mbuf **bufs __rte_unused,
@@ -347,8 +482,6 @@ eth_null_rx(void *queue __rte_unused,
 	return 0;
 }
 
-#define NSEC_PER_SEC	1000000000L
-
 /*
  * This function stores nanoseconds in `tv_usec` field of `struct timeval`,
  * because `ts` goes directly to nanosecond-precision dump.
@@ -370,8 +503,25 @@ calculate_timestamp(struct timeval *ts) {
 	}
 }
 
+/*
+ * Write the buffered pcap records to the file of the dumper.
+ */
+static inline int
+eth_pcap_tx_flush(pcap_dumper_t *dumper, const uint8_t *buf, size_t len)
+{
+	if (len == 0)
+		return 0;
+
+	if (fwrite(buf, 1, len, pcap_dump_file(dumper)) != len)
+		return -1;
+
+	return 0;
+}
+
 /*
  * Callback to handle writing packets to a pcap file.
+ * The records are formatted in a buffer written at once,
+ * instead of a pcap_dump() call per packet.
  */
 static uint16_t
 eth_pcap_tx_dumper(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
@@ -380,12 +530,14 @@ eth_pcap_tx_dumper(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	struct rte_mbuf *mbuf;
 	struct pmd_process_private *pp;
 	struct pcap_tx_queue *dumper_q = queue;
-	uint16_t num_tx = 0;
-	uint32_t tx_bytes = 0;
-	struct pcap_pkthdr header;
+	uint16_t num_tx = 0, num_buf = 0;
+	uint32_t tx_bytes = 0, buf_bytes = 0;
+	struct pcap_rec_hdr *rec;
+	struct timeval ts;
 	pcap_dumper_t *dumper;
-	unsigned char temp_data[RTE_ETH_PCAP_SNAPLEN];
-	size_t len, caplen;
+	uint8_t *buf = dumper_q->buf;
+	const void *data;
+	size_t len, caplen, off = 0;
 
 	pp = rte_eth_devices[dumper_q->port_id].process_private;
 	dumper = pp->tx_dumper[dumper_q->queue_id];
@@ -393,31 +545,52 @@ eth_pcap_tx_dumper(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	if (dumper == NULL || nb_pkts == 0)
 		return 0;
 
+	/* the packets of a burst are written at the same time */
+	calculate_timestamp(&ts);
+
 	/* writes the nb_pkts packets to the previously opened pcap file
 	 * dumper */
 	for (i = 0; i < nb_pkts; i++) {
 		mbuf = bufs[i];
-		len = caplen = rte_pktmbuf_pkt_len(mbuf);
-		if (unlikely(!rte_pktmbuf_is_contiguous(mbuf) &&
-				len > sizeof(temp_data))) {
-			caplen = sizeof(temp_data);
+		len = rte_pktmbuf_pkt_len(mbuf);
+		caplen = RTE_MIN(len, (size_t)RTE_ETH_PCAP_SNAPSHOT_LEN);
+
+		if (off + sizeof(*rec) + caplen > RTE_ETH_PCAP_TX_BUF_SIZE) {
+			if (eth_pcap_tx_flush(dumper, buf, off) == 0) {
+				num_tx += num_buf;
+				tx_bytes += buf_bytes;
+			}
+			off = 0;
+			num_buf = 0;
+			buf_bytes = 0;
 		}
 
-		calculate_timestamp(&header.ts);
-		header.len = len;
-		header.caplen = caplen;
+		rec = (struct pcap_rec_hdr *)(buf + off);
+		rec->ts_sec = ts.tv_sec;
+		rec->ts_frac = ts.tv_usec;
+		rec->len = len;
+		rec->caplen = caplen;
+		off += sizeof(*rec);
+
 		/* rte_pktmbuf_read() returns a pointer to the data directly
 		 * in the mbuf (when the mbuf is contiguous) or, otherwise,
-		 * a pointer to temp_data after copying into it.
+		 * a pointer to the buffer after copying into it.
 		 */
-		pcap_dump((u_char *)dumper, &header,
-			rte_pktmbuf_read(mbuf, 0, caplen, temp_data));
+		data = rte_pktmbuf_read(mbuf, 0, caplen, buf + off);
+		if (data != buf + off)
+			rte_memcpy(buf + off, data, caplen);
+		off += caplen;
 
-		num_tx++;
-		tx_bytes += caplen;
+		num_buf++;
+		buf_bytes += caplen;
 		rte_pktmbuf_free(mbuf);
 	}
 
+	if (eth_pcap_tx_flush(dumper, buf, off) == 0) {
+		num_tx += num_buf;
+		tx_bytes += buf_bytes;
+	}
+
 	/*
 	 * Since there's no place to hook a callback when the forwarding
 	 * process stops and to make sure the pcap file is actually written,
@@ -660,6 +833,19 @@ eth_dev_start(struct rte_eth_dev *dev)
 		}
 	}
 
+	/* Replay the mapped files from the start */
+	for (i = 0; i < dev->data->nb_rx_queues; i++) {
+		rx = &internals->rx_queue[i];
+
+		if (rx->mmap == NULL)
+			continue;
+
+		pcap_mmap_rewind(rx->mmap);
+		rx->replay_cycles = 0;
+		rx->first_ts = 0;
+		rx->loop_ts = 0;
+	}
+
 status_up:
 	for (i = 0; i < dev->data->nb_rx_queues; i++)
 		dev->data->rx_queue_state[i] = RTE_ETH_QUEUE_STATE_STARTED;
@@ -858,6 +1044,21 @@ eth_dev_close(struct rte_eth_dev *dev)
 		}
 	}
 
+	for (i = 0; i < dev->data->nb_rx_queues; i++) {
+		struct pcap_rx_queue *pcap_q = &internals->rx_queue[i];
+
+		/* unmapped once the mbufs pointing into it are freed */
+		if (pcap_q->mmap != NULL) {
+			pcap_mmap_close(pcap_q->mmap);
+			pcap_q->mmap = NULL;
+		}
+	}
+
+	for (i = 0; i < dev->data->nb_tx_queues; i++) {
+		rte_free(internals->tx_queue[i].buf);
+		internals->tx_queue[i].buf = NULL;
+	}
+
 	if (internals->phy_mac == 0)
 		/* not dynamically allocated, must not be freed */
 		dev->data->mac_addrs = NULL;
@@ -876,7 +1077,7 @@ static int
 eth_rx_queue_setup(struct rte_eth_dev *dev,
 		uint16_t rx_queue_id,
 		uint16_t nb_rx_desc __rte_unused,
-		unsigned int socket_id __rte_unused,
+		unsigned int socket_id,
 		const struct rte_eth_rxconf *rx_conf __rte_unused,
 		struct rte_mempool *mb_pool)
 {
@@ -888,6 +1089,22 @@ eth_rx_queue_setup(struct rte_eth_dev *dev,
 	pcap_q->queue_id = rx_queue_id;
 	dev->data->rx_queues[rx_queue_id] = pcap_q;
 
+	if (internals->rx_mmap) {
+		if (pcap_q->mmap == NULL) {
+			pcap_q->mmap = pcap_mmap_open(pcap_q->name, socket_id);
+			if (pcap_q->mmap == NULL)
+				return -ENOENT;
+		}
+
+		/* the file is looped over in place, without a ring of mbufs */
+		pcap_q->infinite_rx = internals->infinite_rx;
+		pcap_q->cycles_per_ns = 0;
+		if (internals->replay_speed > 0)
+			pcap_q->cycles_per_ns = (double)rte_get_timer_hz() /
+				NSEC_PER_SEC / internals->replay_speed;
+		return 0;
+	}
+
 	if (internals->infinite_rx) {
 		struct pmd_process_private *pp;
 		char ring_name[RTE_RING_NAMESIZE];
@@ -952,12 +1169,20 @@ static int
 eth_tx_queue_setup(struct rte_eth_dev *dev,
 		uint16_t tx_queue_id,
 		uint16_t nb_tx_desc __rte_unused,
-		unsigned int socket_id __rte_unused,
+		unsigned int socket_id,
 		const struct rte_eth_txconf *tx_conf __rte_unused)
 {
 	struct pmd_internals *internals = dev->data->dev_private;
 	struct pcap_tx_queue *pcap_q = &internals->tx_queue[tx_queue_id];
 
+	if (pcap_q->buf == NULL &&
+			strcmp(pcap_q->type, ETH_PCAP_TX_PCAP_ARG) == 0) {
+		pcap_q->buf = rte_malloc_socket("pcap_tx_buf",
+			RTE_ETH_PCAP_TX_BUF_SIZE, 0, socket_id);
+		if (pcap_q->buf == NULL)
+			return -ENOMEM;
+	}
+
 	pcap_q->port_id = dev->data->port_id;
 	pcap_q->queue_id = tx_queue_id;
 	dev->data->tx_queues[tx_queue_id] = pcap_q;
@@ -1194,6 +1419,35 @@ get_infinite_rx_arg(const char *key __rte_unused,
 	return 0;
 }
 
+static int
+get_rx_mmap_arg(const char *key __rte_unused,
+		const char *value, void *extra_args)
+{
+	if (extra_args) {
+		const int rx_mmap = atoi(value);
+		unsigned int *enable_rx_mmap = extra_args;
+
+		if (rx_mmap > 0)
+			*enable_rx_mmap = 1;
+	}
+	return 0;
+}
+
+static int
+get_replay_speed_arg(const char *key __rte_unused,
+		const char *value, void *extra_args)
+{
+	double *replay_speed = extra_args;
+	char *end;
+
+	*replay_speed = strtod(value, &end);
+	if (*end != '\0' || !(*replay_speed >= 0)) {
+		PMD_LOG(ERR, "Invalid replay speed %s", value);
+		return -1;
+	}
+	return 0;
+}
+
 static int
 pmd_init_internals(struct rte_vdev_device *vdev,
 		const unsigned int nb_rx_queues,
@@ -1353,8 +1607,12 @@ eth_from_pcaps(struct rte_vdev_device *vdev,
 	}
 
 	internals->infinite_rx = infinite_rx;
+	internals->rx_mmap = devargs_all->rx_mmap;
+	internals->replay_speed = devargs_all->replay_speed;
 	/* Assign rx ops. */
-	if (infinite_rx)
+	if (devargs_all->rx_mmap)
+		eth_dev->rx_pkt_burst = eth_pcap_rx_mmap;
+	else if (infinite_rx)
 		eth_dev->rx_pkt_burst = eth_pcap_rx_infinite;
 	else if (devargs_all->is_rx_pcap || devargs_all->is_rx_iface ||
 			single_iface)
@@ -1520,6 +1778,24 @@ pmd_pcap_probe(struct rte_vdev_device *dev)
 					"for %s", name);
 		}
 
+		ret = rte_kvargs_process(kvlist, ETH_PCAP_RX_MMAP_ARG,
+				&get_rx_mmap_arg, &devargs_all.rx_mmap);
+		if (ret < 0)
+			goto free_kvlist;
+
+		ret = rte_kvargs_process(kvlist, ETH_PCAP_REPLAY_SPEED_ARG,
+				&get_replay_speed_arg, &devargs_all.replay_speed);
+		if (ret < 0)
+			goto free_kvlist;
+
+		if (devargs_all.replay_speed > 0 && !devargs_all.rx_mmap) {
+			PMD_LOG(ERR, "%s requires %s for %s",
+					ETH_PCAP_REPLAY_SPEED_ARG,
+					ETH_PCAP_RX_MMAP_ARG, name);
+			ret = -EINVAL;
+			goto free_kvlist;
+		}
+
 		ret = rte_kvargs_process(kvlist, ETH_PCAP_RX_PCAP_ARG,
 				&open_rx_pcap, &pcaps);
 	} else if (devargs_all.is_rx_iface) {
@@ -1659,5 +1935,7 @@ RTE_PMD_REGISTER_PARAM_STRING(net_pcap,
 	ETH_PCAP_RX_IFACE_IN_ARG "=<ifc> "
 	ETH_PCAP_TX_IFACE_ARG "=<ifc> "
 	ETH_PCAP_IFACE_ARG "=<ifc> "
-	ETH_PCAP_PHY_MAC_ARG "=<int>"
-	ETH_PCAP_INFINITE_RX_ARG "=<0|1>");
+	ETH_PCAP_PHY_MAC_ARG "=<int> "
+	ETH_PCAP_INFINITE_RX_ARG "=<0|1> "
+	ETH_PCAP_RX_MMAP_ARG "=<0|1> "
+	ETH_PCAP_REPLAY_SPEED_ARG "=<float>");
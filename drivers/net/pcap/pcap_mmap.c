@@ -0,0 +1,388 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 The DPDK contributors
+ */
+
+#include <string.h>
+
+#include <rte_byteorder.h>
+#include <rte_common.h>
+#include <rte_malloc.h>
+#include <rte_time.h>
+
+#include "pcap_osdep.h"
+#include "pcap_mmap.h"
+
+#define PCAP_MAGIC_USEC		0xa1b2c3d4
+#define PCAP_MAGIC_NSEC		0xa1b23c4d
+#define PCAP_FILE_HDR_LEN	24
+
+#define PCAPNG_BLOCK_SHB	0x0a0d0d0a
+#define PCAPNG_BLOCK_IDB	1
+#define PCAPNG_BLOCK_PB		2 /* obsolete packet block */
+#define PCAPNG_BLOCK_SPB	3
+#define PCAPNG_BLOCK_EPB	6
+#define PCAPNG_BYTE_ORDER_MAGIC	0x1a2b3c4d
+#define PCAPNG_BLOCK_MIN_LEN	12
+
+#define PCAPNG_OPT_ENDOFOPT	0
+#define PCAPNG_OPT_TSRESOL	9
+#define PCAPNG_OPT_TSOFFSET	14
+
+static inline uint16_t
+rd16(const struct pcap_mmap *pm, const uint8_t *p)
+{
+	uint16_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return pm->swapped ? rte_bswap16(v) : v;
+}
+
+static inline uint32_t
+rd32(const struct pcap_mmap *pm, const uint8_t *p)
+{
+	uint32_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return pm->swapped ? rte_bswap32(v) : v;
+}
+
+static inline uint64_t
+rd64(const struct pcap_mmap *pm, const uint8_t *p)
+{
+	uint64_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return pm->swapped ? rte_bswap64(v) : v;
+}
+
+/* Called when a chunk is not used anymore, by the reader or by mbufs. */
+static void
+pcap_mmap_chunk_free(void *addr __rte_unused, void *opaque)
+{
+	struct pcap_mmap *pm = opaque;
+
+	if (rte_atomic_fetch_sub_explicit(&pm->refcnt, 1,
+			rte_memory_order_acq_rel) != 1)
+		return;
+
+	osdep_file_unmap(pm->addr, pm->len);
+	rte_free(pm->shinfo);
+	rte_free(pm);
+}
+
+struct pcap_mmap *
+pcap_mmap_open(const char *path, int socket_id)
+{
+	struct pcap_mmap *pm;
+	void *addr;
+	size_t len;
+	uint32_t magic;
+	unsigned int i;
+
+	pm = rte_zmalloc_socket("pcap_mmap", sizeof(*pm), 0, socket_id);
+	if (pm == NULL)
+		return NULL;
+
+	if (osdep_file_map(path, &addr, &len) < 0) {
+		PMD_LOG(ERR, "Couldn't map %s", path);
+		rte_free(pm);
+		return NULL;
+	}
+	pm->addr = addr;
+	pm->len = len;
+	pm->end = len;
+
+	if (len < sizeof(magic))
+		goto bad_format;
+	memcpy(&magic, pm->addr, sizeof(magic));
+	switch (magic) {
+	case PCAP_MAGIC_NSEC:
+		pm->ts_nsec = 1;
+		/* fallthrough */
+	case PCAP_MAGIC_USEC:
+		pm->start = PCAP_FILE_HDR_LEN;
+		break;
+	case RTE_STATIC_BSWAP32(PCAP_MAGIC_NSEC):
+		pm->ts_nsec = 1;
+		/* fallthrough */
+	case RTE_STATIC_BSWAP32(PCAP_MAGIC_USEC):
+		pm->swapped = 1;
+		pm->start = PCAP_FILE_HDR_LEN;
+		break;
+	case PCAPNG_BLOCK_SHB:
+		/* byte order is given by each section header */
+		pm->pcapng = 1;
+		pm->start = 0;
+		break;
+	default:
+		goto bad_format;
+	}
+	if (pm->start > len)
+		goto bad_format;
+
+	pm->nb_chunks = ((len - 1) >> PCAP_MMAP_CHUNK_SHIFT) + 1;
+	pm->shinfo = rte_zmalloc_socket("pcap_mmap_shinfo",
+		pm->nb_chunks * sizeof(*pm->shinfo), 0, socket_id);
+	if (pm->shinfo == NULL) {
+		osdep_file_unmap(pm->addr, pm->len);
+		rte_free(pm);
+		return NULL;
+	}
+	for (i = 0; i < pm->nb_chunks; i++) {
+		pm->shinfo[i].free_cb = pcap_mmap_chunk_free;
+		pm->shinfo[i].fcb_opaque = pm;
+		rte_mbuf_ext_refcnt_set(&pm->shinfo[i], 1);
+	}
+	rte_atomic_store_explicit(&pm->refcnt, pm->nb_chunks,
+		rte_memory_order_relaxed);
+
+	pcap_mmap_rewind(pm);
+	return pm;
+
+bad_format:
+	PMD_LOG(ERR, "%s is not a pcap or pcapng file", path);
+	osdep_file_unmap(pm->addr, pm->len);
+	rte_free(pm);
+	return NULL;
+}
+
+/*
+ * The file stays mapped until the mbufs attached to it are freed.
+ */
+void
+pcap_mmap_close(struct pcap_mmap *pm)
+{
+	struct rte_mbuf_ext_shared_info *shinfo = pm->shinfo;
+	unsigned int i, nb_chunks = pm->nb_chunks;
+
+	for (i = 0; i < nb_chunks; i++) {
+		if (rte_mbuf_ext_refcnt_update(&shinfo[i], -1) == 0)
+			pcap_mmap_chunk_free(NULL, pm);
+	}
+}
+
+void
+pcap_mmap_rewind(struct pcap_mmap *pm)
+{
+	pm->pos = pm->start;
+	pm->last_ts = 0;
+}
+
+static int
+pcap_read(struct pcap_mmap *pm, struct pcap_mmap_pkt *pkt)
+{
+	const uint8_t *p = pm->addr + pm->pos;
+	size_t left = pm->end - pm->pos;
+	uint64_t frac;
+
+	if (left == 0)
+		return 0;
+	if (left < sizeof(struct pcap_rec_hdr))
+		return -1;
+
+	pkt->caplen = rd32(pm, p + offsetof(struct pcap_rec_hdr, caplen));
+	pkt->len = rd32(pm, p + offsetof(struct pcap_rec_hdr, len));
+	if (pkt->caplen > left - sizeof(struct pcap_rec_hdr))
+		return -1;
+
+	frac = rd32(pm, p + offsetof(struct pcap_rec_hdr, ts_frac));
+	if (!pm->ts_nsec)
+		frac *= 1000;
+	pkt->ts = (uint64_t)rd32(pm, p + offsetof(struct pcap_rec_hdr, ts_sec)) *
+		NSEC_PER_SEC + frac;
+	pkt->data = pm->addr + pm->pos + sizeof(struct pcap_rec_hdr);
+	pkt->next = pm->pos + sizeof(struct pcap_rec_hdr) + pkt->caplen;
+	return 1;
+}
+
+static int
+pcapng_parse_shb(struct pcap_mmap *pm, const uint8_t *p, size_t left)
+{
+	uint32_t magic;
+
+	if (left < PCAPNG_BLOCK_MIN_LEN + sizeof(magic))
+		return -1;
+
+	memcpy(&magic, p + 8, sizeof(magic));
+	if (magic == PCAPNG_BYTE_ORDER_MAGIC)
+		pm->swapped = 0;
+	else if (magic == RTE_STATIC_BSWAP32(PCAPNG_BYTE_ORDER_MAGIC))
+		pm->swapped = 1;
+	else
+		return -1;
+
+	/* the interfaces are numbered per section */
+	pm->nb_ifaces = 0;
+	return 0;
+}
+
+static int
+pcapng_parse_idb(struct pcap_mmap *pm, const uint8_t *p, uint32_t blen)
+{
+	struct pcap_mmap_iface *iface;
+	const uint8_t *opt, *end;
+	uint16_t code, olen;
+	unsigned int i;
+	uint8_t resol;
+
+	if (pm->nb_ifaces == PCAP_MMAP_MAX_IFACES || blen < 20)
+		return -1;
+
+	iface = &pm->ifaces[pm->nb_ifaces++];
+	iface->snaplen = rd32(pm, p + 12);
+	iface->ts_units = 1000000;
+	iface->ts_shift = 0;
+	iface->ts_offset = 0;
+
+	opt = p + 16;
+	end = p + blen - 4;
+	while (end - opt >= 4) {
+		code = rd16(pm, opt);
+		olen = rd16(pm, opt + 2);
+		opt += 4;
+		if (code == PCAPNG_OPT_ENDOFOPT || olen > end - opt)
+			break;
+
+		if (code == PCAPNG_OPT_TSRESOL && olen >= 1) {
+			resol = opt[0];
+			if (resol & 0x80) {
+				iface->ts_units = 0;
+				iface->ts_shift = resol & 0x7f;
+				if (iface->ts_shift > 63)
+					return -1;
+			} else {
+				if (resol > 19)
+					return -1;
+				iface->ts_units = 1;
+				for (i = 0; i < resol; i++)
+					iface->ts_units *= 10;
+			}
+		} else if (code == PCAPNG_OPT_TSOFFSET && olen >= 8) {
+			iface->ts_offset = (int64_t)rd64(pm, opt);
+		}
+		opt += RTE_ALIGN(olen, 4);
+	}
+
+	return 0;
+}
+
+static uint64_t
+pcapng_ts(const struct pcap_mmap_iface *iface, uint64_t ts)
+{
+	uint64_t sec, frac;
+
+	if (iface->ts_units == 0) {
+		unsigned int shift = iface->ts_shift;
+
+		sec = ts >> shift;
+		frac = ts & (RTE_BIT64(shift) - 1);
+		/* keep 32 bits of fraction to avoid an overflow */
+		if (shift > 32) {
+			frac >>= shift - 32;
+			shift = 32;
+		}
+		frac = (frac * NSEC_PER_SEC) >> shift;
+	} else {
+		sec = ts / iface->ts_units;
+		frac = ts % iface->ts_units;
+		if (iface->ts_units > NSEC_PER_SEC)
+			frac /= iface->ts_units / NSEC_PER_SEC;
+		else
+			frac *= NSEC_PER_SEC / iface->ts_units;
+	}
+
+	return (sec + iface->ts_offset) * NSEC_PER_SEC + frac;
+}
+
+static int
+pcapng_read(struct pcap_mmap *pm, struct pcap_mmap_pkt *pkt)
+{
+	const struct pcap_mmap_iface *iface;
+	const uint8_t *p;
+	uint32_t type, blen, id;
+	size_t left;
+
+	while (pm->pos < pm->end) {
+		p = pm->addr + pm->pos;
+		left = pm->end - pm->pos;
+		if (left < PCAPNG_BLOCK_MIN_LEN)
+			return -1;
+
+		/* the section header type reads the same in both orders */
+		memcpy(&type, p, sizeof(type));
+		if (type == PCAPNG_BLOCK_SHB &&
+				pcapng_parse_shb(pm, p, left) < 0)
+			return -1;
+
+		type = rd32(pm, p);
+		blen = rd32(pm, p + 4);
+		if (blen < PCAPNG_BLOCK_MIN_LEN || blen % 4 != 0 || blen > left)
+			return -1;
+
+		switch (type) {
+		case PCAPNG_BLOCK_IDB:
+			if (pcapng_parse_idb(pm, p, blen) < 0)
+				return -1;
+			break;
+		case PCAPNG_BLOCK_EPB:
+		case PCAPNG_BLOCK_PB:
+			if (blen < 32)
+				return -1;
+			if (type == PCAPNG_BLOCK_EPB)
+				id = rd32(pm, p + 8);
+			else
+				id = rd16(pm, p + 8);
+			if (id >= pm->nb_ifaces)
+				return -1;
+			iface = &pm->ifaces[id];
+
+			pkt->caplen = rd32(pm, p + 20);
+			pkt->len = rd32(pm, p + 24);
+			if (pkt->caplen > blen - 32)
+				return -1;
+			pkt->ts = pcapng_ts(iface,
+				(uint64_t)rd32(pm, p + 12) << 32 | rd32(pm, p + 16));
+			pkt->data = pm->addr + pm->pos + 28;
+			pkt->next = pm->pos + blen;
+			return 1;
+		case PCAPNG_BLOCK_SPB:
+			if (blen < 16 || pm->nb_ifaces == 0)
+				return -1;
+			iface = &pm->ifaces[0];
+
+			/* the captured length is implicit, without timestamp */
+			pkt->len = rd32(pm, p + 8);
+			pkt->caplen = RTE_MIN(pkt->len, blen - 16);
+			if (iface->snaplen != 0)
+				pkt->caplen = RTE_MIN(pkt->caplen, iface->snaplen);
+			pkt->ts = pm->last_ts;
+			pkt->data = pm->addr + pm->pos + 12;
+			pkt->next = pm->pos + blen;
+			return 1;
+		default:
+			break;
+		}
+
+		pm->pos += blen;
+	}
+
+	return 0;
+}
+
+int
+pcap_mmap_read(struct pcap_mmap *pm, struct pcap_mmap_pkt *pkt)
+{
+	int ret;
+
+	if (pm->pcapng)
+		ret = pcapng_read(pm, pkt);
+	else
+		ret = pcap_read(pm, pkt);
+
+	/* the file is read up to the malformed block from now on */
+	if (unlikely(ret < 0)) {
+		PMD_LOG(ERR, "Malformed block at offset %zu", pm->pos);
+		pm->end = pm->pos;
+	}
+	return ret;
+}
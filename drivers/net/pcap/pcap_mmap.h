@@ -0,0 +1,100 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 The DPDK contributors
+ */
+
+#ifndef _PCAP_MMAP_H_
+#define _PCAP_MMAP_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <rte_mbuf.h>
+#include <rte_stdatomic.h>
+
+/*
+ * Reader of a pcap or pcapng file mapped in memory,
+ * for receiving mbufs attached to the packets of the file.
+ */
+
+/* Record header of a pcap file, in the byte order of the file */
+struct pcap_rec_hdr {
+	uint32_t ts_sec;
+	uint32_t ts_frac; /* microseconds or nanoseconds */
+	uint32_t caplen;
+	uint32_t len;
+};
+
+/* Packets of a chunk of the file share a reference count. */
+#define PCAP_MMAP_CHUNK_SHIFT 19
+
+#define PCAP_MMAP_MAX_IFACES 32
+
+struct pcap_mmap {
+	uint8_t *addr;
+	size_t len;
+
+	/* offset of the next block, and of the end of the valid blocks */
+	size_t pos;
+	size_t end;
+	/* offset of the first block after the file or section header */
+	size_t start;
+
+	/* pcapng section */
+	unsigned int pcapng:1;
+	unsigned int swapped:1;
+	unsigned int nb_ifaces;
+	struct pcap_mmap_iface {
+		uint32_t snaplen;
+		/* timestamp units per second, 0 for 2^-shift */
+		uint64_t ts_units;
+		unsigned int ts_shift;
+		int64_t ts_offset;
+	} ifaces[PCAP_MMAP_MAX_IFACES];
+
+	/* pcap file */
+	unsigned int ts_nsec:1;
+
+	/* timestamp of the last packet read, in nanoseconds */
+	uint64_t last_ts;
+
+	/*
+	 * Chunks not released, the file is unmapped when all of them are,
+	 * i.e. on close and after the last mbuf pointing into them is freed.
+	 */
+	RTE_ATOMIC(uint32_t) refcnt;
+	unsigned int nb_chunks;
+	struct rte_mbuf_ext_shared_info *shinfo;
+};
+
+struct pcap_mmap_pkt {
+	uint8_t *data;
+	uint32_t caplen;
+	uint32_t len;
+	uint64_t ts; /* nanoseconds */
+	size_t next; /* offset of the following block */
+};
+
+struct pcap_mmap *pcap_mmap_open(const char *path, int socket_id);
+void pcap_mmap_close(struct pcap_mmap *pm);
+void pcap_mmap_rewind(struct pcap_mmap *pm);
+
+/*
+ * Read the packet at the current position, without consuming it.
+ * Return 1 on success, 0 at end of file, -1 if the file is malformed.
+ */
+int pcap_mmap_read(struct pcap_mmap *pm, struct pcap_mmap_pkt *pkt);
+
+static inline void
+pcap_mmap_consume(struct pcap_mmap *pm, const struct pcap_mmap_pkt *pkt)
+{
+	pm->pos = pkt->next;
+	pm->last_ts = pkt->ts;
+}
+
+static inline struct rte_mbuf_ext_shared_info *
+pcap_mmap_shinfo(struct pcap_mmap *pm, const struct pcap_mmap_pkt *pkt)
+{
+	return &pm->shinfo[(pkt->data - pm->addr) >> PCAP_MMAP_CHUNK_SHIFT];
+}
+
+#endif /* _PCAP_MMAP_H_ */
@@ -5,6 +5,8 @@
 #ifndef _RTE_PCAP_OSDEP_
 #define _RTE_PCAP_OSDEP_
 
+#include <stddef.h>
+
 #include <rte_ether.h>
 
 #define PMD_LOG(level, ...) \
@@ -15,4 +17,8 @@ extern int eth_pcap_logtype;
 int osdep_iface_index_get(const char *name);
 int osdep_iface_mac_get(const char *name, struct rte_ether_addr *mac);
 
+/* Map a whole file copy-on-write, for reading it in place. */
+int osdep_file_map(const char *path, void **addr, size_t *len);
+void osdep_file_unmap(void *addr, size_t len);
+
 #endif
@@ -4,9 +4,13 @@
  * All rights reserved.
  */
 
+#include <fcntl.h>
 #include <net/if.h>
 #include <net/if_dl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/sysctl.h>
+#include <unistd.h>
 
 #include <rte_malloc.h>
 #include <rte_memcpy.h>
@@ -57,3 +61,38 @@ osdep_iface_mac_get(const char *if_name, struct rte_ether_addr *mac)
 	rte_free(buf);
 	return 0;
 }
+
+int
+osdep_file_map(const char *path, void **addr, size_t *len)
+{
+	struct stat st;
+	void *map;
+	int fd;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return -1;
+
+	if (fstat(fd, &st) < 0 || st.st_size == 0) {
+		close(fd);
+		return -1;
+	}
+
+	/* private mapping, so that packets can be modified in place */
+	map = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+		fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+		return -1;
+
+	madvise(map, st.st_size, MADV_SEQUENTIAL);
+	*addr = map;
+	*len = st.st_size;
+	return 0;
+}
+
+void
+osdep_file_unmap(void *addr, size_t len)
+{
+	munmap(addr, len);
+}
@@ -116,3 +116,49 @@ osdep_iface_mac_get(const char *device_name, struct rte_ether_addr *mac)
 	free(info);
 	return ret;
 }
+
+int
+osdep_file_map(const char *path, void **addr, size_t *len)
+{
+	LARGE_INTEGER size;
+	HANDLE file, mapping;
+	void *map;
+
+	file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file == INVALID_HANDLE_VALUE) {
+		PMD_LOG(ERR, "CreateFileA(%s) = %lu", path, GetLastError());
+		return -1;
+	}
+
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+		CloseHandle(file);
+		return -1;
+	}
+
+	/* copy-on-write view, so that packets can be modified in place */
+	mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+	CloseHandle(file);
+	if (mapping == NULL) {
+		PMD_LOG(ERR, "CreateFileMappingA(%s) = %lu", path,
+			GetLastError());
+		return -1;
+	}
+
+	map = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+	CloseHandle(mapping);
+	if (map == NULL) {
+		PMD_LOG(ERR, "MapViewOfFile(%s) = %lu", path, GetLastError());
+		return -1;
+	}
+
+	*addr = map;
+	*len = size.QuadPart;
+	return 0;
+}
+
+void
+osdep_file_unmap(void *addr, size_t len __rte_unused)
+{
+	UnmapViewOfFile(addr);
+}
@@ -37,6 +37,7 @@
 #include <net/if.h>
 #include <linux/if_tun.h>
 #include <linux/if_ether.h>
+#include <linux/virtio_net.h>
 #include <fcntl.h>
 #include <ctype.h>
 
@@ -56,6 +57,7 @@
 #define ETH_TAP_MAC_ARG         "mac"
 #define ETH_TAP_MAC_FIXED       "fixed"
 #define ETH_TAP_PERSIST_ARG     "persist"
+#define ETH_TAP_IO_URING_ARG    "io_uring"
 
 #define ETH_TAP_USR_MAC_FMT     "xx:xx:xx:xx:xx:xx"
 #define ETH_TAP_CMP_MAC_FMT     "0123456789ABCDEFabcdef"
@@ -97,6 +99,7 @@ static const char *valid_arguments[] = {
 	ETH_TAP_REMOTE_ARG,
 	ETH_TAP_MAC_ARG,
 	ETH_TAP_PERSIST_ARG,
+	ETH_TAP_IO_URING_ARG,
 	NULL
 };
 
@@ -183,6 +186,11 @@ tun_alloc(struct pmd_internals *pmd, int is_keepalive, int persistent)
 	}
 	TAP_LOG(DEBUG, "%s Features %08x", TUN_TAP_DEV_PATH, features);
 
+	if (pmd->vnet_hdr && !(features & IFF_VNET_HDR)) {
+		TAP_LOG(DEBUG, "  No virtio-net header support");
+		pmd->vnet_hdr = 0;
+	}
+
 	if (features & IFF_MULTI_QUEUE) {
 		TAP_LOG(DEBUG, "  Multi-queue support for %d queues",
 			RTE_PMD_TAP_MAX_QUEUES);
@@ -194,6 +202,10 @@ tun_alloc(struct pmd_internals *pmd, int is_keepalive, int persistent)
 		TAP_LOG(DEBUG, "  Single queue only support");
 	}
 
+	/* Exchange the offload information with the kernel */
+	if (pmd->vnet_hdr)
+		ifr.ifr_flags |= IFF_VNET_HDR;
+
 	/* Set the TUN/TAP configuration and set the name if needed */
 	if (ioctl(fd, TUNSETIFF, (void *)&ifr) < 0) {
 		TAP_LOG(WARNING, "Unable to set TUNSETIFF for %s: %s",
@@ -318,7 +330,7 @@ tun_alloc(struct pmd_internals *pmd, int is_keepalive, int persistent)
 	return -1;
 }
 
-static void
+void
 tap_verify_csum(struct rte_mbuf *mbuf)
 {
 	uint32_t l2 = mbuf->packet_type & RTE_PTYPE_L2_MASK;
@@ -375,6 +387,9 @@ tap_verify_csum(struct rte_mbuf *mbuf)
 		 */
 		return;
 	}
+	/* L4 checksum status may be given by the virtio-net header */
+	if (mbuf->ol_flags & RTE_MBUF_F_RX_L4_CKSUM_MASK)
+		return;
 	if (l4 == RTE_PTYPE_L4_UDP || l4 == RTE_PTYPE_L4_TCP) {
 		int cksum_ok;
 
@@ -406,6 +421,55 @@ tap_verify_csum(struct rte_mbuf *mbuf)
 	}
 }
 
+void
+tap_vnet_rx_offload(struct rte_mbuf *mbuf, const struct virtio_net_hdr *hdr,
+		    const struct rte_net_hdr_lens *hdr_lens)
+{
+	uint32_t l4 = mbuf->packet_type & RTE_PTYPE_L4_MASK;
+	uint32_t hdrlen;
+
+	/* nothing to do */
+	if (hdr->flags == 0 && hdr->gso_type == VIRTIO_NET_HDR_GSO_NONE)
+		return;
+
+	if (hdr->flags & VIRTIO_NET_HDR_F_NEEDS_CSUM) {
+		hdrlen = hdr_lens->l2_len + hdr_lens->l3_len;
+		if (hdr->csum_start == hdrlen &&
+		    (l4 == RTE_PTYPE_L4_TCP || l4 == RTE_PTYPE_L4_UDP)) {
+			mbuf->ol_flags |= RTE_MBUF_F_RX_L4_CKSUM_NONE;
+		} else {
+			/* Unknown protocol or tunnel, do software checksum. */
+			uint16_t csum = 0, off;
+
+			if (rte_raw_cksum_mbuf(mbuf, hdr->csum_start,
+					rte_pktmbuf_pkt_len(mbuf) - hdr->csum_start,
+					&csum) < 0)
+				return;
+			if (likely(csum != 0xffff))
+				csum = ~csum;
+			off = hdr->csum_offset + hdr->csum_start;
+			if (rte_pktmbuf_data_len(mbuf) >= off + sizeof(csum))
+				*rte_pktmbuf_mtod_offset(mbuf, uint16_t *, off) = csum;
+		}
+	} else if (hdr->flags & VIRTIO_NET_HDR_F_DATA_VALID &&
+		   (l4 == RTE_PTYPE_L4_TCP || l4 == RTE_PTYPE_L4_UDP)) {
+		mbuf->ol_flags |= RTE_MBUF_F_RX_L4_CKSUM_GOOD;
+	}
+
+	/* Packet coalesced by the kernel, save the segment size */
+	switch (hdr->gso_type & ~VIRTIO_NET_HDR_GSO_ECN) {
+	case VIRTIO_NET_HDR_GSO_TCPV4:
+	case VIRTIO_NET_HDR_GSO_TCPV6:
+		if (hdr->gso_size == 0)
+			break;
+		mbuf->ol_flags |= RTE_MBUF_F_RX_LRO;
+		mbuf->tso_segsz = hdr->gso_size;
+		break;
+	default:
+		break;
+	}
+}
+
 static void
 tap_rxq_pool_free(struct rte_mbuf *pool)
 {
@@ -443,6 +507,7 @@ pmd_rx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 		struct rte_mbuf *mbuf = rxq->pool;
 		struct rte_mbuf *seg = NULL;
 		struct rte_mbuf *new_tail = NULL;
+		struct rte_net_hdr_lens hdr_lens;
 		uint16_t data_off = rte_pktmbuf_headroom(mbuf);
 		int len;
 
@@ -450,16 +515,16 @@ pmd_rx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 			*rxq->iovecs,
 			1 + (rxq->rxmode->offloads & RTE_ETH_RX_OFFLOAD_SCATTER ?
 			     rxq->nb_rx_desc : 1));
-		if (len < (int)sizeof(struct tun_pi))
+		if (len < rxq->hdr_len)
 			break;
 
 		/* Packet couldn't fit in the provided mbuf */
-		if (unlikely(rxq->pi.flags & TUN_PKT_STRIP)) {
+		if (unlikely(rxq->hdr.pi.flags & TUN_PKT_STRIP)) {
 			rxq->stats.ierrors++;
 			continue;
 		}
 
-		len -= sizeof(struct tun_pi);
+		len -= rxq->hdr_len;
 
 		mbuf->pkt_len = len;
 		mbuf->port = rxq->in_port;
@@ -502,8 +567,10 @@ pmd_rx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 			data_off = 0;
 		}
 		seg->next = NULL;
-		mbuf->packet_type = rte_net_get_ptype(mbuf, NULL,
+		mbuf->packet_type = rte_net_get_ptype(mbuf, &hdr_lens,
 						      RTE_PTYPE_ALL_MASK);
+		if (rxq->hdr_len > sizeof(struct tun_pi))
+			tap_vnet_rx_offload(mbuf, &rxq->hdr.vnet, &hdr_lens);
 		if (rxq->rxmode->offloads & RTE_ETH_RX_OFFLOAD_CHECKSUM)
 			tap_verify_csum(mbuf);
 
@@ -521,6 +588,41 @@ pmd_rx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	return num_rx;
 }
 
+/*
+ * Let the kernel complete the L4 checksum and segment the packet:
+ * the checksum field is set to the pseudo-header checksum
+ * including the L4 length, as expected by the kernel.
+ */
+static void
+tap_vnet_tx_offload(struct virtio_net_hdr *hdr, struct rte_mbuf *mbuf,
+		    void *l3_hdr, uint16_t *l4_cksum, uint16_t csum_offset)
+{
+	uint16_t l4_len = rte_pktmbuf_pkt_len(mbuf) - mbuf->l2_len -
+		mbuf->l3_len;
+	uint32_t sum;
+
+	/* RTE_MBUF_F_TX_TCP_SEG excludes the length from the checksum */
+	if (mbuf->ol_flags & RTE_MBUF_F_TX_IPV4)
+		sum = rte_ipv4_phdr_cksum(l3_hdr, RTE_MBUF_F_TX_TCP_SEG);
+	else
+		sum = rte_ipv6_phdr_cksum(l3_hdr, RTE_MBUF_F_TX_TCP_SEG);
+	sum += rte_cpu_to_be_16(l4_len);
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+	*l4_cksum = (uint16_t)sum;
+
+	hdr->flags = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+	hdr->csum_start = mbuf->l2_len + mbuf->l3_len;
+	hdr->csum_offset = csum_offset;
+
+	if (mbuf->ol_flags & RTE_MBUF_F_TX_TCP_SEG) {
+		hdr->gso_type = (mbuf->ol_flags & RTE_MBUF_F_TX_IPV6) ?
+			VIRTIO_NET_HDR_GSO_TCPV6 : VIRTIO_NET_HDR_GSO_TCPV4;
+		hdr->gso_size = mbuf->tso_segsz;
+		hdr->hdr_len = mbuf->l2_len + mbuf->l3_len + mbuf->l4_len;
+	}
+}
+
 static inline int
 tap_write_mbufs(struct tx_queue *txq, uint16_t num_mbufs,
 			struct rte_mbuf **pmbufs,
@@ -534,9 +636,10 @@ tap_write_mbufs(struct tx_queue *txq, uint16_t num_mbufs,
 	for (i = 0; i < num_mbufs; i++) {
 		struct rte_mbuf *mbuf = pmbufs[i];
 		struct iovec iovecs[mbuf->nb_segs + 2];
-		struct tun_pi pi = { .flags = 0, .proto = 0x00 };
+		struct tap_hdr hdr = { .pi = { .flags = 0, .proto = 0x00 } };
 		struct rte_mbuf *seg = mbuf;
 		uint64_t l4_ol_flags;
+		uint64_t tso;
 		int proto;
 		int n;
 		int j;
@@ -555,7 +658,7 @@ tap_write_mbufs(struct tx_queue *txq, uint16_t num_mbufs,
 			 */
 			char *buff_data = rte_pktmbuf_mtod(seg, void *);
 			proto = (*buff_data & 0xf0);
-			pi.proto = (proto == 0x40) ?
+			hdr.pi.proto = (proto == 0x40) ?
 				rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4) :
 				((proto == 0x60) ?
 					rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6) :
@@ -563,19 +666,25 @@ tap_write_mbufs(struct tx_queue *txq, uint16_t num_mbufs,
 		}
 
 		k = 0;
-		iovecs[k].iov_base = &pi;
-		iovecs[k].iov_len = sizeof(pi);
+		iovecs[k].iov_base = &hdr;
+		iovecs[k].iov_len = txq->vnet ? sizeof(hdr) : sizeof(hdr.pi);
 		k++;
 
+		/* Only sent unsegmented with the virtio-net header */
+		tso = txq->vnet ? mbuf->ol_flags & RTE_MBUF_F_TX_TCP_SEG : 0;
 		l4_ol_flags = mbuf->ol_flags & RTE_MBUF_F_TX_L4_MASK;
-		if (txq->csum && (mbuf->ol_flags & RTE_MBUF_F_TX_IP_CKSUM ||
+		if ((txq->csum || tso) &&
+				(mbuf->ol_flags & RTE_MBUF_F_TX_IP_CKSUM ||
 				l4_ol_flags == RTE_MBUF_F_TX_UDP_CKSUM ||
 				l4_ol_flags == RTE_MBUF_F_TX_TCP_CKSUM)) {
 			unsigned int hdrlens = mbuf->l2_len + mbuf->l3_len;
+			uint16_t csum_offset;
 			uint16_t *l4_cksum;
 			void *l3_hdr;
 
-			if (l4_ol_flags == RTE_MBUF_F_TX_UDP_CKSUM)
+			if (tso)
+				hdrlens += mbuf->l4_len;
+			else if (l4_ol_flags == RTE_MBUF_F_TX_UDP_CKSUM)
 				hdrlens += sizeof(struct rte_udp_hdr);
 			else if (l4_ol_flags == RTE_MBUF_F_TX_TCP_CKSUM)
 				hdrlens += sizeof(struct rte_tcp_hdr);
@@ -616,12 +725,20 @@ tap_write_mbufs(struct tx_queue *txq, uint16_t num_mbufs,
 				udp_hdr = rte_pktmbuf_mtod_offset(mbuf, struct rte_udp_hdr *,
 					mbuf->l2_len + mbuf->l3_len);
 				l4_cksum = &udp_hdr->dgram_cksum;
+				csum_offset = offsetof(struct rte_udp_hdr, dgram_cksum);
 			} else {
 				struct rte_tcp_hdr *tcp_hdr;
 
 				tcp_hdr = rte_pktmbuf_mtod_offset(mbuf, struct rte_tcp_hdr *,
 					mbuf->l2_len + mbuf->l3_len);
 				l4_cksum = &tcp_hdr->cksum;
+				csum_offset = offsetof(struct rte_tcp_hdr, cksum);
+			}
+
+			if (txq->vnet) {
+				tap_vnet_tx_offload(&hdr.vnet, mbuf, l3_hdr,
+						    l4_cksum, csum_offset);
+				goto skip_l4_cksum;
 			}
 
 			*l4_cksum = 0;
@@ -643,7 +760,12 @@ tap_write_mbufs(struct tx_queue *txq, uint16_t num_mbufs,
 		}
 
 		/* copy the tx frame data */
-		n = writev(process_private->fds[txq->queue_id], iovecs, k);
+#ifdef HAVE_LIBURING
+		if (txq->uring != NULL)
+			n = tap_uring_write(txq, mbuf, iovecs, k);
+		else
+#endif
+			n = writev(process_private->fds[txq->queue_id], iovecs, k);
 		if (n <= 0)
 			return -1;
 
@@ -681,7 +803,16 @@ pmd_tx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 		uint64_t tso;
 
 		tso = mbuf_in->ol_flags & RTE_MBUF_F_TX_TCP_SEG;
-		if (tso) {
+		if (tso && txq->vnet) {
+			/* segmented by the kernel */
+			mbuf_in->ol_flags |= RTE_MBUF_F_TX_TCP_CKSUM;
+			if (unlikely(mbuf_in->tso_segsz == 0))
+				break;
+
+			num_tso_mbufs = 0;
+			mbuf = &mbuf_in;
+			num_mbufs = 1;
+		} else if (tso) {
 			struct rte_gso_ctx *gso_ctx = &txq->gso_ctx;
 
 			/* TCP segmentation implies TCP checksum offload */
@@ -753,6 +884,11 @@ pmd_tx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	txq->stats.errs += nb_pkts - num_tx;
 	txq->stats.obytes += num_tx_bytes;
 
+#ifdef HAVE_LIBURING
+	if (txq->uring != NULL)
+		tap_uring_tx_flush(txq);
+#endif
+
 	return num_tx;
 }
 
@@ -945,10 +1081,35 @@ tap_dev_stop(struct rte_eth_dev *dev)
 	return 0;
 }
 
+/* Select the offloads of the packets received from the kernel */
+static int
+tap_vnet_offload_set(struct rte_eth_dev *dev)
+{
+	struct pmd_internals *pmd = dev->data->dev_private;
+	uint64_t offloads = dev->data->dev_conf.rxmode.offloads;
+	unsigned int features = 0;
+
+	if (offloads & (RTE_ETH_RX_OFFLOAD_UDP_CKSUM |
+			RTE_ETH_RX_OFFLOAD_TCP_CKSUM |
+			RTE_ETH_RX_OFFLOAD_TCP_LRO))
+		features |= TUN_F_CSUM;
+	if (offloads & RTE_ETH_RX_OFFLOAD_TCP_LRO)
+		features |= TUN_F_TSO4 | TUN_F_TSO6;
+
+	if (ioctl(pmd->ka_fd, TUNSETOFFLOAD, features) < 0) {
+		TAP_LOG(ERR, "%s: Unable to set offloads %#x: %s",
+			pmd->name, features, strerror(errno));
+		return -errno;
+	}
+	return 0;
+}
+
 static int
 tap_dev_configure(struct rte_eth_dev *dev)
 {
 	struct pmd_internals *pmd = dev->data->dev_private;
+	uint64_t offloads = dev->data->dev_conf.rxmode.offloads;
+	int ret;
 
 	if (dev->data->nb_rx_queues != dev->data->nb_tx_queues) {
 		TAP_LOG(ERR,
@@ -959,6 +1120,25 @@ tap_dev_configure(struct rte_eth_dev *dev)
 		return -1;
 	}
 
+	if ((offloads & RTE_ETH_RX_OFFLOAD_TCP_LRO) &&
+	    !(offloads & RTE_ETH_RX_OFFLOAD_SCATTER)) {
+		TAP_LOG(ERR, "%s: LRO requires the scatter Rx offload",
+			dev->device->name);
+		return -EINVAL;
+	}
+
+	if (pmd->io_uring && dev->data->dev_conf.intr_conf.rxq) {
+		TAP_LOG(ERR, "%s: Rx interrupts are not supported with io_uring",
+			dev->device->name);
+		return -ENOTSUP;
+	}
+
+	if (pmd->vnet_hdr) {
+		ret = tap_vnet_offload_set(dev);
+		if (ret < 0)
+			return ret;
+	}
+
 	TAP_LOG(INFO, "%s: %s: TX configured queues number: %u",
 		dev->device->name, pmd->name, dev->data->nb_tx_queues);
 
@@ -1016,6 +1196,11 @@ tap_dev_info(struct rte_eth_dev *dev, struct rte_eth_dev_info *dev_info)
 	dev_info->speed_capa = tap_dev_speed_capa();
 	dev_info->rx_queue_offload_capa = TAP_RX_OFFLOAD;
 	dev_info->rx_offload_capa = dev_info->rx_queue_offload_capa;
+	if (internals->vnet_hdr) {
+		/* device-wide in the kernel */
+		dev_info->rx_offload_capa |= RTE_ETH_RX_OFFLOAD_TCP_LRO;
+		dev_info->max_lro_pkt_size = RTE_IPV4_MAX_PKT_LEN;
+	}
 	dev_info->tx_queue_offload_capa = TAP_TX_OFFLOAD;
 	dev_info->tx_offload_capa = dev_info->tx_queue_offload_capa;
 	dev_info->hash_key_size = TAP_RSS_HASH_KEY_SIZE;
@@ -1133,6 +1318,12 @@ tap_dev_close(struct rte_eth_dev *dev)
 	for (i = 0; i < RTE_PMD_TAP_MAX_QUEUES; i++) {
 		struct rx_queue *rxq = &internals->rxq[i];
 
+#ifdef HAVE_LIBURING
+		if (rxq->uring != NULL)
+			tap_uring_rxq_release(rxq);
+		if (internals->txq[i].uring != NULL)
+			tap_uring_txq_release(&internals->txq[i]);
+#endif
 		tap_queue_close(process_private, i);
 
 		tap_rxq_pool_free(rxq->pool);
@@ -1196,6 +1387,10 @@ tap_rx_queue_release(struct rte_eth_dev *dev, uint16_t qid)
 
 	process_private = rte_eth_devices[rxq->in_port].process_private;
 
+#ifdef HAVE_LIBURING
+	if (rxq->uring != NULL)
+		tap_uring_rxq_release(rxq);
+#endif
 	tap_rxq_pool_free(rxq->pool);
 	rte_free(rxq->iovecs);
 	rxq->pool = NULL;
@@ -1215,6 +1410,10 @@ tap_tx_queue_release(struct rte_eth_dev *dev, uint16_t qid)
 		return;
 
 	process_private = rte_eth_devices[txq->out_port].process_private;
+#ifdef HAVE_LIBURING
+	if (txq->uring != NULL)
+		tap_uring_txq_release(txq);
+#endif
 	if (dev->data->rx_queues[qid] == NULL)
 		tap_queue_close(process_private, qid);
 }
@@ -1576,8 +1775,21 @@ tap_rx_queue_setup(struct rte_eth_dev *dev,
 		goto error;
 	}
 
-	(*rxq->iovecs)[0].iov_len = sizeof(struct tun_pi);
-	(*rxq->iovecs)[0].iov_base = &rxq->pi;
+	rxq->hdr_len = sizeof(struct tun_pi);
+	if (internals->vnet_hdr)
+		rxq->hdr_len += sizeof(struct virtio_net_hdr);
+	(*rxq->iovecs)[0].iov_len = rxq->hdr_len;
+	(*rxq->iovecs)[0].iov_base = &rxq->hdr;
+
+#ifdef HAVE_LIBURING
+	if (internals->io_uring) {
+		/* buffers are posted to io_uring instead of the pool */
+		ret = tap_uring_rxq_setup(rxq, fd, nb_rx_desc, socket_id);
+		if (ret < 0)
+			goto error;
+		nb_desc = 0;
+	}
+#endif
 
 	for (i = 1; i <= nb_desc; i++) {
 		*tmp = rte_pktmbuf_alloc(rxq->mp);
@@ -1612,8 +1824,8 @@ tap_rx_queue_setup(struct rte_eth_dev *dev,
 static int
 tap_tx_queue_setup(struct rte_eth_dev *dev,
 		   uint16_t tx_queue_id,
-		   uint16_t nb_tx_desc __rte_unused,
-		   unsigned int socket_id __rte_unused,
+		   uint16_t nb_tx_desc,
+		   unsigned int socket_id,
 		   const struct rte_eth_txconf *tx_conf)
 {
 	struct pmd_internals *internals = dev->data->dev_private;
@@ -1634,10 +1846,21 @@ tap_tx_queue_setup(struct rte_eth_dev *dev,
 			(RTE_ETH_TX_OFFLOAD_IPV4_CKSUM |
 			 RTE_ETH_TX_OFFLOAD_UDP_CKSUM |
 			 RTE_ETH_TX_OFFLOAD_TCP_CKSUM));
+	txq->vnet = !!internals->vnet_hdr;
 
 	ret = tap_setup_queue(dev, internals, tx_queue_id, 0);
 	if (ret == -1)
 		return -1;
+#ifdef HAVE_LIBURING
+	if (internals->io_uring) {
+		ret = tap_uring_txq_setup(txq, ret, nb_tx_desc, socket_id);
+		if (ret < 0)
+			return ret;
+	}
+#else
+	RTE_SET_USED(nb_tx_desc);
+	RTE_SET_USED(socket_id);
+#endif
 	TAP_LOG(DEBUG,
 		"  TX TUNTAP device name %s, qid %d on fd %d csum %s",
 		internals->name, tx_queue_id,
@@ -1906,7 +2129,7 @@ static const struct eth_dev_ops ops = {
 static int
 eth_dev_tap_create(struct rte_vdev_device *vdev, const char *tap_name,
 		   char *remote_iface, struct rte_ether_addr *mac_addr,
-		   enum rte_tuntap_type type, int persist)
+		   enum rte_tuntap_type type, int persist, int io_uring)
 {
 	int numa_node = rte_socket_id();
 	struct rte_eth_dev *dev;
@@ -1939,6 +2162,9 @@ eth_dev_tap_create(struct rte_vdev_device *vdev, const char *tap_name,
 	strlcpy(pmd->name, tap_name, sizeof(pmd->name));
 	pmd->type = type;
 	pmd->ka_fd = -1;
+	/* disabled by tun_alloc() if not supported by the kernel */
+	pmd->vnet_hdr = 1;
+	pmd->io_uring = io_uring;
 
 #ifdef HAVE_TCA_FLOWER
 	pmd->nlsk_fd = -1;
@@ -1976,6 +2202,10 @@ eth_dev_tap_create(struct rte_vdev_device *vdev, const char *tap_name,
 	dev->dev_ops = &ops;
 	dev->rx_pkt_burst = pmd_rx_burst;
 	dev->tx_pkt_burst = pmd_tx_burst;
+#ifdef HAVE_LIBURING
+	if (io_uring)
+		dev->rx_pkt_burst = tap_uring_rx_burst;
+#endif
 
 	rte_intr_type_set(pmd->intr_handle, RTE_INTR_HANDLE_EXT);
 	rte_intr_fd_set(pmd->intr_handle, -1);
@@ -2004,7 +2234,9 @@ eth_dev_tap_create(struct rte_vdev_device *vdev, const char *tap_name,
 		TAP_LOG(ERR, "Unable to create %s interface", tuntap_name);
 		goto error_exit;
 	}
-	TAP_LOG(DEBUG, "allocated %s", pmd->name);
+	TAP_LOG(DEBUG, "allocated %s, virtio-net header %s, io_uring %s",
+		pmd->name, pmd->vnet_hdr ? "on" : "off",
+		pmd->io_uring ? "on" : "off");
 
 	ifr.ifr_mtu = dev->data->mtu;
 	if (tap_ioctl(pmd, SIOCSIFMTU, &ifr, 1, LOCAL_AND_REMOTE) < 0)
@@ -2238,6 +2470,20 @@ set_mac_type(const char *key __rte_unused,
 	return -1;
 }
 
+/* Return 1 if the io_uring datapath can be used */
+static int
+set_io_uring(const char *name)
+{
+#ifdef HAVE_LIBURING
+	TAP_LOG(DEBUG, "%s: io_uring datapath", name);
+	return 1;
+#else
+	TAP_LOG(WARNING, "%s: built without liburing, %s is ignored",
+		name, ETH_TAP_IO_URING_ARG);
+	return 0;
+#endif
+}
+
 /*
  * Open a TUN interface device. TUN PMD
  * 1) sets tap_type as false
@@ -2253,6 +2499,7 @@ rte_pmd_tun_probe(struct rte_vdev_device *dev)
 	char tun_name[RTE_ETH_NAME_MAX_LEN];
 	char remote_iface[RTE_ETH_NAME_MAX_LEN];
 	struct rte_eth_dev *eth_dev;
+	int io_uring = 0;
 
 	name = rte_vdev_device_name(dev);
 	params = rte_vdev_device_args(dev);
@@ -2288,6 +2535,9 @@ rte_pmd_tun_probe(struct rte_vdev_device *dev)
 				if (ret == -1)
 					goto leave;
 			}
+
+			if (rte_kvargs_count(kvlist, ETH_TAP_IO_URING_ARG) == 1)
+				io_uring = set_io_uring(name);
 		}
 	}
 	pmd_link.link_speed = RTE_ETH_SPEED_NUM_10G;
@@ -2295,7 +2545,7 @@ rte_pmd_tun_probe(struct rte_vdev_device *dev)
 	TAP_LOG(DEBUG, "Initializing pmd_tun for %s", name);
 
 	ret = eth_dev_tap_create(dev, tun_name, remote_iface, 0,
-				 ETH_TUNTAP_TYPE_TUN, 0);
+				 ETH_TUNTAP_TYPE_TUN, 0, io_uring);
 
 leave:
 	if (ret == -1) {
@@ -2419,6 +2669,7 @@ rte_pmd_tap_probe(struct rte_vdev_device *dev)
 	struct rte_eth_dev *eth_dev;
 	int tap_devices_count_increased = 0;
 	int persist = 0;
+	int io_uring = 0;
 
 	name = rte_vdev_device_name(dev);
 	params = rte_vdev_device_args(dev);
@@ -2429,6 +2680,11 @@ rte_pmd_tap_probe(struct rte_vdev_device *dev)
 			TAP_LOG(ERR, "Failed to probe %s", name);
 			return -1;
 		}
+		if (((struct pmd_internals *)eth_dev->data->dev_private)->io_uring) {
+			TAP_LOG(ERR, "io_uring is not supported in secondary process");
+			rte_eth_dev_release_port(eth_dev);
+			return -1;
+		}
 		eth_dev->dev_ops = &ops;
 		eth_dev->device = &dev->device;
 		eth_dev->rx_pkt_burst = pmd_rx_burst;
@@ -2502,6 +2758,9 @@ rte_pmd_tap_probe(struct rte_vdev_device *dev)
 
 			if (rte_kvargs_count(kvlist, ETH_TAP_PERSIST_ARG) == 1)
 				persist = 1;
+
+			if (rte_kvargs_count(kvlist, ETH_TAP_IO_URING_ARG) == 1)
+				io_uring = set_io_uring(name);
 		}
 	}
 	pmd_link.link_speed = speed;
@@ -2520,7 +2779,7 @@ rte_pmd_tap_probe(struct rte_vdev_device *dev)
 	tap_devices_count++;
 	tap_devices_count_increased = 1;
 	ret = eth_dev_tap_create(dev, tap_name, remote_iface, &user_mac,
-				 ETH_TUNTAP_TYPE_TAP, persist);
+				 ETH_TUNTAP_TYPE_TAP, persist, io_uring);
 
 leave:
 	if (ret == -1) {
@@ -2569,9 +2828,11 @@ RTE_PMD_REGISTER_VDEV(net_tap, pmd_tap_drv);
 RTE_PMD_REGISTER_VDEV(net_tun, pmd_tun_drv);
 RTE_PMD_REGISTER_ALIAS(net_tap, eth_tap);
 RTE_PMD_REGISTER_PARAM_STRING(net_tun,
-			      ETH_TAP_IFACE_ARG "=<string> ");
+			      ETH_TAP_IFACE_ARG "=<string> "
+			      ETH_TAP_IO_URING_ARG);
 RTE_PMD_REGISTER_PARAM_STRING(net_tap,
 			      ETH_TAP_IFACE_ARG "=<string> "
 			      ETH_TAP_MAC_ARG "=" ETH_TAP_MAC_ARG_FMT " "
-			      ETH_TAP_REMOTE_ARG "=<string>");
+			      ETH_TAP_REMOTE_ARG "=<string> "
+			      ETH_TAP_IO_URING_ARG);
 RTE_LOG_REGISTER_DEFAULT(tap_logtype, NOTICE);
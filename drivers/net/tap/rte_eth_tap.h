@@ -12,10 +12,12 @@
 #include <net/if.h>
 
 #include <linux/if_tun.h>
+#include <linux/virtio_net.h>
 
 #include <ethdev_driver.h>
 #include <rte_ether.h>
 #include <rte_gso.h>
+#include <rte_net.h>
 
 #include "tap_log.h"
 
@@ -26,6 +28,15 @@
 #endif
 #define MAX_GSO_MBUFS 64
 
+/*
+ * Header of the packets exchanged with the kernel:
+ * the packet info, followed by the virtio-net header if enabled.
+ */
+struct tap_hdr {
+	struct tun_pi pi;
+	struct virtio_net_hdr vnet;
+} __rte_packed;
+
 enum rte_tuntap_type {
 	ETH_TUNTAP_TYPE_UNKNOWN,
 	ETH_TUNTAP_TYPE_TUN,
@@ -53,17 +64,25 @@ struct rx_queue {
 	struct rte_eth_rxmode *rxmode;  /* RX features */
 	struct rte_mbuf *pool;          /* mbufs pool for this queue */
 	struct iovec (*iovecs)[];       /* descriptors for this queue */
-	struct tun_pi pi;               /* packet info for iovecs */
+	struct tap_hdr hdr;             /* packet info for iovecs */
+	uint8_t hdr_len;                /* size of hdr read from the kernel */
+#ifdef HAVE_LIBURING
+	struct tap_uring_rxq *uring;    /* io_uring datapath, if enabled */
+#endif
 };
 
 struct tx_queue {
 	int type;                       /* Type field - TUN|TAP */
 	uint16_t *mtu;                  /* Pointer to MTU from dev_data */
 	uint16_t csum:1;                /* Enable checksum offloading */
+	uint16_t vnet:1;                /* Offloads in virtio-net header */
 	struct pkt_stats stats;         /* Stats for this TX queue */
 	struct rte_gso_ctx gso_ctx;     /* GSO context */
 	uint16_t out_port;              /* Port ID */
 	uint16_t queue_id;		/* queue ID*/
+#ifdef HAVE_LIBURING
+	struct tap_uring_txq *uring;    /* io_uring datapath, if enabled */
+#endif
 };
 
 struct pmd_internals {
@@ -72,6 +91,8 @@ struct pmd_internals {
 	char name[RTE_ETH_NAME_MAX_LEN];  /* Internal Tap device name */
 	int type;                         /* Type field - TUN|TAP */
 	int persist;			  /* 1 if keep link up, else 0 */
+	int vnet_hdr;                     /* 1 if virtio-net header is used */
+	int io_uring;                     /* 1 if io_uring datapath is used */
 	struct rte_ether_addr eth_addr;   /* Mac address of the device port */
 	struct ifreq remote_initial_flags;/* Remote netdevice flags on init */
 	int remote_if_index;              /* remote netdevice IF_INDEX */
@@ -104,4 +125,27 @@ struct pmd_process_private {
 
 int tap_rx_intr_vec_set(struct rte_eth_dev *dev, int set);
 
+/* rte_eth_tap.c */
+
+void tap_vnet_rx_offload(struct rte_mbuf *mbuf,
+			 const struct virtio_net_hdr *hdr,
+			 const struct rte_net_hdr_lens *hdr_lens);
+void tap_verify_csum(struct rte_mbuf *mbuf);
+
+#ifdef HAVE_LIBURING
+/* tap_uring.c */
+
+int tap_uring_rxq_setup(struct rx_queue *rxq, int fd, uint16_t nb_desc,
+			unsigned int socket_id);
+void tap_uring_rxq_release(struct rx_queue *rxq);
+uint16_t tap_uring_rx_burst(void *queue, struct rte_mbuf **bufs,
+			    uint16_t nb_pkts);
+int tap_uring_txq_setup(struct tx_queue *txq, int fd, uint16_t nb_desc,
+			unsigned int socket_id);
+void tap_uring_txq_release(struct tx_queue *txq);
+int tap_uring_write(struct tx_queue *txq, struct rte_mbuf *mbuf,
+		    const struct iovec *iovecs, int nb_iovecs);
+void tap_uring_tx_flush(struct tx_queue *txq);
+#endif
+
 #endif /* _RTE_ETH_TAP_H_ */
@@ -0,0 +1,492 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 The DPDK contributors
+ */
+
+/**
+ * @file
+ * io_uring datapath for tap driver.
+ *
+ * The Rx buffers are posted in advance as read requests,
+ * which are re-armed by batches in the Rx burst.
+ * The Tx packets are written with a single submission per Tx burst,
+ * their mbufs being freed on completion.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+#include <liburing.h>
+
+#include <rte_common.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_net.h>
+
+#include <rte_eth_tap.h>
+
+/* Maximum number of completions handled at once */
+#define TAP_URING_BURST 64
+/* Maximum number of requests in flight on a queue */
+#define TAP_URING_MAX_DESC 1024
+/* Maximum number of segments of a packet written asynchronously */
+#define TAP_URING_TX_MAX_SEGS 64
+
+struct tap_uring_rx_slot {
+	struct tap_hdr hdr;             /* header read from the kernel */
+	struct rte_mbuf **mbufs;        /* buffers of the packet segments */
+	struct iovec *iovecs;           /* header and segments */
+};
+
+struct tap_uring_rxq {
+	struct io_uring ring;
+	int fd;
+	uint16_t nb_slots;              /* number of read requests */
+	uint16_t nb_segs;               /* buffers per read request */
+	uint16_t nb_inflight;           /* read requests not completed */
+	struct rte_mbuf **fresh;        /* buffers replacing a packet */
+	struct rte_mbuf **mbufs;        /* buffers of all the slots */
+	struct tap_uring_rx_slot slots[];
+};
+
+struct tap_uring_tx_slot {
+	struct tap_hdr hdr;             /* header written to the kernel */
+	struct rte_mbuf *mbuf;          /* packet freed on completion */
+	struct iovec iovecs[TAP_URING_TX_MAX_SEGS + 1];
+};
+
+struct tap_uring_txq {
+	struct io_uring ring;
+	int fd;
+	uint16_t nb_slots;              /* number of write requests */
+	uint16_t nb_free;               /* write requests available */
+	struct tap_uring_tx_slot **free_slots;
+	struct tap_uring_tx_slot slots[];
+};
+
+/*
+ * The requests must wait for the file to be ready:
+ * io_uring polls the file instead of failing on a non-blocking one.
+ * The Rx signal is not needed anymore.
+ */
+static int
+tap_uring_fd_setup(int fd)
+{
+	int flags;
+
+	flags = fcntl(fd, F_GETFL);
+	if (flags == -1)
+		return -errno;
+	if (fcntl(fd, F_SETFL, flags & ~(O_NONBLOCK | O_ASYNC)) < 0)
+		return -errno;
+	return 0;
+}
+
+/* Point the iovec of a slot buffer to the mbuf data room */
+static inline void
+tap_uring_rx_iovec_set(struct tap_uring_rx_slot *slot, uint16_t i)
+{
+	struct rte_mbuf *mbuf = slot->mbufs[i];
+
+	/* First segment has headroom, not the others */
+	if (i != 0)
+		mbuf->data_off = 0;
+	slot->iovecs[i + 1].iov_base =
+		(char *)mbuf->buf_addr + mbuf->data_off;
+	slot->iovecs[i + 1].iov_len = mbuf->buf_len - mbuf->data_off;
+}
+
+static inline int
+tap_uring_rx_post(struct tap_uring_rxq *urq, struct tap_uring_rx_slot *slot)
+{
+	struct io_uring_sqe *sqe;
+
+	/* cannot fail, there are as many entries as slots */
+	sqe = io_uring_get_sqe(&urq->ring);
+	if (unlikely(sqe == NULL))
+		return -ENOSPC;
+	io_uring_prep_readv(sqe, urq->fd, slot->iovecs, urq->nb_segs + 1, 0);
+	io_uring_sqe_set_data(sqe, slot);
+	urq->nb_inflight++;
+	return 0;
+}
+
+int
+tap_uring_rxq_setup(struct rx_queue *rxq, int fd, uint16_t nb_desc,
+		    unsigned int socket_id)
+{
+	struct tap_uring_rxq *urq;
+	uint16_t seg_len, nb_segs = 1, nb_slots;
+	size_t size;
+	unsigned int i;
+	int ret;
+
+	if (rxq->uring != NULL)
+		tap_uring_rxq_release(rxq);
+
+	seg_len = rte_pktmbuf_data_room_size(rxq->mp);
+	if (seg_len <= RTE_PKTMBUF_HEADROOM) {
+		TAP_LOG(ERR, "No room for data in mbufs of %s",
+			rxq->mp->name);
+		return -EINVAL;
+	}
+	seg_len -= RTE_PKTMBUF_HEADROOM;
+
+	/* Read the largest packet in as many buffers as needed */
+	if (rxq->rxmode->offloads & RTE_ETH_RX_OFFLOAD_SCATTER) {
+		uint32_t max_len = RTE_ETHER_MAX_JUMBO_FRAME_LEN;
+
+		if (rxq->rxmode->offloads & RTE_ETH_RX_OFFLOAD_TCP_LRO)
+			max_len = RTE_IPV4_MAX_PKT_LEN + sizeof(struct rte_ether_hdr);
+		nb_segs = RTE_MIN((max_len + seg_len - 1) / seg_len,
+				  (uint32_t)IOV_MAX - 1);
+	}
+	/* hold about the same number of mbufs as the readv datapath */
+	nb_slots = RTE_MAX(nb_desc / nb_segs, 1);
+	nb_slots = RTE_MIN(nb_slots, TAP_URING_MAX_DESC);
+
+	size = sizeof(*urq) + nb_slots * sizeof(urq->slots[0]) +
+		(nb_slots + 1) * nb_segs * sizeof(struct rte_mbuf *) +
+		nb_slots * (nb_segs + 1) * sizeof(struct iovec);
+	urq = rte_zmalloc_socket("tap_uring_rxq", size, RTE_CACHE_LINE_SIZE,
+				 socket_id);
+	if (urq == NULL)
+		return -ENOMEM;
+	urq->fd = fd;
+	urq->nb_slots = nb_slots;
+	urq->nb_segs = nb_segs;
+	urq->mbufs = (struct rte_mbuf **)&urq->slots[nb_slots];
+	urq->fresh = &urq->mbufs[nb_slots * nb_segs];
+	for (i = 0; i < nb_slots; i++) {
+		urq->slots[i].mbufs = &urq->mbufs[i * nb_segs];
+		urq->slots[i].iovecs =
+			(struct iovec *)&urq->fresh[nb_segs] + i * (nb_segs + 1);
+	}
+
+	ret = tap_uring_fd_setup(fd);
+	if (ret < 0) {
+		TAP_LOG(ERR, "Unable to set flags of fd %d: %s",
+			fd, strerror(-ret));
+		rte_free(urq);
+		return ret;
+	}
+
+	ret = io_uring_queue_init(nb_slots, &urq->ring, 0);
+	if (ret < 0) {
+		TAP_LOG(ERR, "Unable to create io_uring of %u entries: %s",
+			nb_slots, strerror(-ret));
+		rte_free(urq);
+		return ret;
+	}
+	rxq->uring = urq;
+
+	for (i = 0; i < nb_slots; i++) {
+		struct tap_uring_rx_slot *slot = &urq->slots[i];
+		uint16_t j;
+
+		if (rte_pktmbuf_alloc_bulk(rxq->mp, slot->mbufs, nb_segs) != 0) {
+			TAP_LOG(WARNING, "Couldn't allocate %u Rx buffers",
+				nb_slots * nb_segs);
+			ret = -ENOMEM;
+			goto error;
+		}
+		slot->iovecs[0].iov_base = &slot->hdr;
+		slot->iovecs[0].iov_len = rxq->hdr_len;
+		for (j = 0; j < nb_segs; j++)
+			tap_uring_rx_iovec_set(slot, j);
+		tap_uring_rx_post(urq, slot);
+	}
+
+	ret = io_uring_submit(&urq->ring);
+	if (ret < 0) {
+		TAP_LOG(ERR, "Unable to post Rx buffers: %s", strerror(-ret));
+		goto error;
+	}
+
+	TAP_LOG(DEBUG, "io_uring Rx queue of %u reads of %u buffers",
+		nb_slots, nb_segs);
+	return 0;
+
+error:
+	tap_uring_rxq_release(rxq);
+	return ret;
+}
+
+void
+tap_uring_rxq_release(struct rx_queue *rxq)
+{
+	struct tap_uring_rxq *urq = rxq->uring;
+	struct io_uring_cqe *cqe;
+	unsigned int i;
+
+	if (urq == NULL)
+		return;
+
+	/* Cancel the reads before freeing their buffers */
+	io_uring_submit(&urq->ring);
+	for (i = 0; i < urq->nb_slots; i++) {
+		struct io_uring_sqe *sqe = io_uring_get_sqe(&urq->ring);
+
+		if (sqe == NULL) {
+			io_uring_submit(&urq->ring);
+			sqe = io_uring_get_sqe(&urq->ring);
+			if (sqe == NULL)
+				break;
+		}
+		io_uring_prep_cancel(sqe, &urq->slots[i], 0);
+		io_uring_sqe_set_data(sqe, NULL);
+	}
+	io_uring_submit(&urq->ring);
+
+	while (urq->nb_inflight > 0) {
+		if (io_uring_wait_cqe(&urq->ring, &cqe) < 0)
+			break;
+		if (io_uring_cqe_get_data(cqe) != NULL)
+			urq->nb_inflight--;
+		io_uring_cqe_seen(&urq->ring, cqe);
+	}
+	io_uring_queue_exit(&urq->ring);
+
+	rte_pktmbuf_free_bulk(urq->mbufs, urq->nb_slots * urq->nb_segs);
+	rte_free(urq);
+	rxq->uring = NULL;
+}
+
+uint16_t
+tap_uring_rx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
+{
+	struct rx_queue *rxq = queue;
+	struct tap_uring_rxq *urq = rxq->uring;
+	struct io_uring_cqe *cqes[TAP_URING_BURST];
+	unsigned long num_rx_bytes = 0;
+	uint16_t num_rx = 0;
+	unsigned int i, n;
+
+	n = io_uring_peek_batch_cqe(&urq->ring, cqes,
+				    RTE_MIN(nb_pkts, TAP_URING_BURST));
+	for (i = 0; i < n; i++) {
+		struct tap_uring_rx_slot *slot = io_uring_cqe_get_data(cqes[i]);
+		struct rte_net_hdr_lens hdr_lens;
+		struct rte_mbuf *mbuf;
+		int len = cqes[i]->res;
+		uint16_t used, j;
+		int rest;
+
+		urq->nb_inflight--;
+		if (unlikely(len < rxq->hdr_len)) {
+			if (len != -EINTR && len != -EAGAIN)
+				rxq->stats.ierrors++;
+			goto rearm;
+		}
+
+		/* Packet couldn't fit in the provided mbufs */
+		if (unlikely(slot->hdr.pi.flags & TUN_PKT_STRIP)) {
+			rxq->stats.ierrors++;
+			goto rearm;
+		}
+
+		len -= rxq->hdr_len;
+		rest = len - (int)slot->iovecs[1].iov_len;
+		for (used = 1; rest > 0; used++)
+			rest -= (int)slot->iovecs[used + 1].iov_len;
+
+		/* Replace the buffers, or post them again on failure */
+		if (unlikely(rte_pktmbuf_alloc_bulk(rxq->mp, urq->fresh,
+						    used) != 0)) {
+			rxq->stats.rx_nombuf++;
+			goto rearm;
+		}
+
+		mbuf = slot->mbufs[0];
+		mbuf->pkt_len = len;
+		mbuf->nb_segs = used;
+		mbuf->port = rxq->in_port;
+		rest = len;
+		for (j = 0; j < used; j++) {
+			struct rte_mbuf *seg = slot->mbufs[j];
+
+			seg->data_len = RTE_MIN(rest,
+						(int)slot->iovecs[j + 1].iov_len);
+			rest -= seg->data_len;
+			seg->next = j + 1 < used ? slot->mbufs[j + 1] : NULL;
+			slot->mbufs[j] = urq->fresh[j];
+			tap_uring_rx_iovec_set(slot, j);
+		}
+
+		mbuf->packet_type = rte_net_get_ptype(mbuf, &hdr_lens,
+						      RTE_PTYPE_ALL_MASK);
+		if (rxq->hdr_len > sizeof(struct tun_pi))
+			tap_vnet_rx_offload(mbuf, &slot->hdr.vnet, &hdr_lens);
+		if (rxq->rxmode->offloads & RTE_ETH_RX_OFFLOAD_CHECKSUM)
+			tap_verify_csum(mbuf);
+
+		/* account for the receive frame */
+		bufs[num_rx++] = mbuf;
+		num_rx_bytes += mbuf->pkt_len;
+rearm:
+		tap_uring_rx_post(urq, slot);
+	}
+
+	if (n > 0) {
+		io_uring_cq_advance(&urq->ring, n);
+		io_uring_submit(&urq->ring);
+	}
+
+	rxq->stats.ipackets += num_rx;
+	rxq->stats.ibytes += num_rx_bytes;
+
+	return num_rx;
+}
+
+int
+tap_uring_txq_setup(struct tx_queue *txq, int fd, uint16_t nb_desc,
+		    unsigned int socket_id)
+{
+	struct tap_uring_txq *utq;
+	uint16_t nb_slots;
+	size_t size;
+	unsigned int i;
+	int ret;
+
+	if (txq->uring != NULL)
+		tap_uring_txq_release(txq);
+
+	nb_slots = RTE_MIN(RTE_MAX(nb_desc, 1), TAP_URING_MAX_DESC);
+	size = sizeof(*utq) + nb_slots * sizeof(utq->slots[0]) +
+		nb_slots * sizeof(utq->free_slots[0]);
+	utq = rte_zmalloc_socket("tap_uring_txq", size, RTE_CACHE_LINE_SIZE,
+				 socket_id);
+	if (utq == NULL)
+		return -ENOMEM;
+	utq->fd = fd;
+	utq->nb_slots = nb_slots;
+	utq->free_slots = (struct tap_uring_tx_slot **)&utq->slots[nb_slots];
+	for (i = 0; i < nb_slots; i++)
+		utq->free_slots[i] = &utq->slots[nb_slots - i - 1];
+	utq->nb_free = nb_slots;
+
+	ret = tap_uring_fd_setup(fd);
+	if (ret < 0) {
+		TAP_LOG(ERR, "Unable to set flags of fd %d: %s",
+			fd, strerror(-ret));
+		rte_free(utq);
+		return ret;
+	}
+
+	ret = io_uring_queue_init(nb_slots, &utq->ring, 0);
+	if (ret < 0) {
+		TAP_LOG(ERR, "Unable to create io_uring of %u entries: %s",
+			nb_slots, strerror(-ret));
+		rte_free(utq);
+		return ret;
+	}
+	txq->uring = utq;
+
+	TAP_LOG(DEBUG, "io_uring Tx queue of %u writes", nb_slots);
+	return 0;
+}
+
+/* Free the packets written, and account the failed writes */
+static void
+tap_uring_tx_complete(struct tx_queue *txq, struct io_uring_cqe *cqe)
+{
+	struct tap_uring_txq *utq = txq->uring;
+	struct tap_uring_tx_slot *slot = io_uring_cqe_get_data(cqe);
+
+	if (unlikely(cqe->res <= 0)) {
+		txq->stats.errs++;
+		txq->stats.opackets--;
+		txq->stats.obytes -= rte_pktmbuf_pkt_len(slot->mbuf);
+	}
+	rte_pktmbuf_free(slot->mbuf);
+	slot->mbuf = NULL;
+	utq->free_slots[utq->nb_free++] = slot;
+}
+
+void
+tap_uring_txq_release(struct tx_queue *txq)
+{
+	struct tap_uring_txq *utq = txq->uring;
+	struct io_uring_cqe *cqe;
+
+	if (utq == NULL)
+		return;
+
+	/* Writes to the tap cannot block for long, wait for them */
+	io_uring_submit(&utq->ring);
+	while (utq->nb_free < utq->nb_slots) {
+		if (io_uring_wait_cqe(&utq->ring, &cqe) < 0)
+			break;
+		tap_uring_tx_complete(txq, cqe);
+		io_uring_cqe_seen(&utq->ring, cqe);
+	}
+	io_uring_queue_exit(&utq->ring);
+
+	rte_free(utq);
+	txq->uring = NULL;
+}
+
+int
+tap_uring_write(struct tx_queue *txq, struct rte_mbuf *mbuf,
+		const struct iovec *iovecs, int nb_iovecs)
+{
+	struct tap_uring_txq *utq = txq->uring;
+	struct tap_uring_tx_slot *slot;
+	struct io_uring_sqe *sqe;
+	struct rte_mbuf *seg;
+
+	if (unlikely(utq->nb_free == 0))
+		tap_uring_tx_flush(txq);
+	if (unlikely(utq->nb_free == 0 ||
+		     nb_iovecs > TAP_URING_TX_MAX_SEGS + 1)) {
+		/* write synchronously, after the pending requests */
+		tap_uring_tx_flush(txq);
+		return writev(utq->fd, iovecs, nb_iovecs);
+	}
+
+	/* cannot fail, there are as many entries as slots */
+	sqe = io_uring_get_sqe(&utq->ring);
+	if (unlikely(sqe == NULL))
+		return -1;
+	slot = utq->free_slots[--utq->nb_free];
+
+	/* The header is on the stack of the caller */
+	memcpy(&slot->hdr, iovecs[0].iov_base, iovecs[0].iov_len);
+	slot->iovecs[0].iov_base = &slot->hdr;
+	slot->iovecs[0].iov_len = iovecs[0].iov_len;
+	memcpy(&slot->iovecs[1], &iovecs[1],
+	       (nb_iovecs - 1) * sizeof(*iovecs));
+
+	/* The caller frees the packet, keep it until completion */
+	for (seg = mbuf; seg != NULL; seg = seg->next)
+		rte_mbuf_refcnt_update(seg, 1);
+	slot->mbuf = mbuf;
+
+	io_uring_prep_writev(sqe, utq->fd, slot->iovecs, nb_iovecs, 0);
+	io_uring_sqe_set_data(sqe, slot);
+
+	return iovecs[0].iov_len + rte_pktmbuf_pkt_len(mbuf);
+}
+
+void
+tap_uring_tx_flush(struct tx_queue *txq)
+{
+	struct tap_uring_txq *utq = txq->uring;
+	struct io_uring_cqe *cqes[TAP_URING_BURST];
+	unsigned int i, n;
+
+	if (io_uring_sq_ready(&utq->ring) > 0)
+		io_uring_submit(&utq->ring);
+
+	/* The writes usually complete during the submission */
+	do {
+		n = io_uring_peek_batch_cqe(&utq->ring, cqes, RTE_DIM(cqes));
+		for (i = 0; i < n; i++)
+			tap_uring_tx_complete(txq, cqes[i]);
+		io_uring_cq_advance(&utq->ring, n);
+	} while (n == RTE_DIM(cqes));
+}
@@ -185,6 +185,7 @@ struct rte_acl_ctx {
 	void               *mem;
 	size_t              mem_sz;
 	struct rte_acl_config config; /* copy of build config. */
+	struct acl_incr    *incr; /* incremental update state, if enabled. */
 };
 
 int rte_acl_gen(struct rte_acl_ctx *ctx, struct rte_acl_trie *trie,
@@ -194,6 +195,46 @@ int rte_acl_gen(struct rte_acl_ctx *ctx, struct rte_acl_trie *trie,
 typedef int (*rte_acl_classify_t)
 (const struct rte_acl_ctx *, const uint8_t **, uint32_t *, uint32_t, uint32_t);
 
+/*
+ * Allocate/free a context that is not registered in the ACL tailq.
+ * Used for the tries backing an incrementally updated context.
+ */
+struct rte_acl_ctx *
+acl_ctx_alloc(const char *name, int32_t socket_id, uint32_t max_rules,
+	uint32_t rule_sz);
+
+void
+acl_ctx_release(struct rte_acl_ctx *ctx);
+
+rte_acl_classify_t
+acl_get_classify_fn(enum rte_acl_classify_alg alg);
+
+int
+acl_check_rule(const struct rte_acl_rule_data *rd);
+
+int
+acl_check_bld_param(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg);
+
+/*
+ * Incremental update support (acl_incr.c).
+ */
+int
+acl_incr_classify(const struct rte_acl_ctx *ctx, const uint8_t **data,
+	uint32_t *results, uint32_t num, uint32_t categories,
+	enum rte_acl_classify_alg alg);
+
+int
+acl_incr_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg);
+
+void
+acl_incr_reset_rules(struct rte_acl_ctx *ctx);
+
+void
+acl_incr_free(struct rte_acl_ctx *ctx);
+
+void
+acl_incr_dump(const struct rte_acl_ctx *ctx);
+
 /*
  * Different implementations of ACL classify.
  */
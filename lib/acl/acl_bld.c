@@ -4,6 +4,7 @@
 
 #include <rte_acl.h>
 #include <rte_log.h>
+#include <rte_thread.h>
 
 #include "tb_mem.h"
 #include "acl.h"
@@ -68,6 +69,8 @@ struct rte_acl_build_rule {
 	uint32_t                    *wildness;
 };
 
+struct acl_build_job;
+
 /* Context for build phase */
 struct acl_build_context {
 	const struct rte_acl_ctx *acx;
@@ -91,6 +94,25 @@ struct acl_build_context {
 	/* memory free lists for nodes and blocks used for node ptrs */
 	struct acl_mem_block      blocks[MEM_BLOCK_NUM];
 	struct rte_acl_node       *node_free_list;
+
+	/* tries rebuilt by worker threads */
+	uint32_t                  num_workers;
+	uint32_t                  num_jobs;
+	uint32_t                  num_done;
+	struct acl_build_job      *jobs[RTE_ACL_MAX_TRIES];
+};
+
+/*
+ * Rebuild of one trie, for the reduced rule set left after a split,
+ * performed by a worker thread with its own copy of the build context.
+ */
+struct acl_build_job {
+	struct acl_build_context   bcx;
+	struct rte_acl_build_rule  *rule_sets[RTE_ACL_MAX_TRIES];
+	uint32_t                   n;
+	int32_t                    rc;
+	int32_t                    threaded;
+	rte_thread_t               tid;
 };
 
 static int acl_merge_trie(struct acl_build_context *context,
@@ -1344,10 +1366,132 @@ build_one_trie(struct acl_build_context *context,
 	return last;
 }
 
+static uint32_t
+acl_build_job_run(void *arg)
+{
+	struct acl_build_job *job;
+	struct acl_build_context *bcx;
+	struct rte_acl_build_rule *last;
+	int32_t rc;
+
+	job = arg;
+	bcx = &job->bcx;
+
+	rc = sigsetjmp(bcx->pool.fail, 0);
+	if (rc != 0) {
+		ACL_LOG(ERR, "ACL context: %s, rebuild of %u-th trie failed "
+			"with error code: %d", bcx->acx->name, job->n, rc);
+		job->rc = rc;
+		return 0;
+	}
+
+	last = build_one_trie(bcx, job->rule_sets, job->n, INT32_MAX);
+	if (bcx->bld_tries[job->n].trie == NULL || last != NULL) {
+		ACL_LOG(ERR, "Build of %u-th trie failed", job->n);
+		job->rc = -ENOMEM;
+	}
+	return 0;
+}
+
+/*
+ * Wait for the worker threads, and collect the tries they built.
+ * Returns the error code of the first failed job.
+ */
+static int
+acl_build_jobs_wait(struct acl_build_context *context, uint32_t num)
+{
+	int32_t rc;
+	uint32_t n;
+	struct acl_build_job *job;
+
+	rc = 0;
+	for (; context->num_done != num; context->num_done++) {
+		job = context->jobs[context->num_done];
+		if (job->threaded)
+			rte_thread_join(job->tid, NULL);
+
+		n = job->n;
+		if (job->rc == 0) {
+			context->tries[n] = job->bcx.tries[n];
+			memcpy(context->data_indexes[n],
+				job->bcx.data_indexes[n],
+				sizeof(context->data_indexes[n]));
+			context->tries[n].data_index =
+				context->data_indexes[n];
+			context->bld_tries[n] = job->bcx.bld_tries[n];
+			context->num_nodes += job->bcx.num_nodes;
+		} else if (rc == 0)
+			rc = job->rc;
+	}
+	return rc;
+}
+
+static void
+acl_build_jobs_free(struct acl_build_context *context)
+{
+	uint32_t i;
+
+	for (i = 0; i != context->num_jobs; i++) {
+		tb_free_pool(&context->jobs[i]->bcx.pool);
+		free(context->jobs[i]);
+	}
+	context->num_jobs = 0;
+	context->num_done = 0;
+}
+
+/*
+ * Hand the rebuild of the n-th trie to a worker thread.
+ * If no thread can be started, rebuild it in place.
+ */
+static int
+acl_build_job_start(struct acl_build_context *context,
+	struct rte_acl_build_rule *rule_sets[RTE_ACL_MAX_TRIES], uint32_t n)
+{
+	int32_t rc;
+	struct acl_build_job *job;
+	struct acl_build_context *bcx;
+	char name[RTE_THREAD_INTERNAL_NAME_SIZE];
+
+	/* keep at most num_workers - 1 jobs in flight */
+	if (context->num_jobs - context->num_done + 1 >= context->num_workers) {
+		rc = acl_build_jobs_wait(context, context->num_done + 1);
+		if (rc != 0)
+			return rc;
+	}
+
+	job = calloc(1, sizeof(*job));
+	if (job == NULL)
+		return -ENOMEM;
+
+	bcx = &job->bcx;
+	bcx->acx = context->acx;
+	bcx->cfg = context->cfg;
+	bcx->category_mask = context->category_mask;
+	bcx->node_max = context->node_max;
+	bcx->pool.alignment = context->pool.alignment;
+	bcx->pool.min_alloc = context->pool.min_alloc;
+	bcx->pool.arena = context->pool.arena;
+	job->rule_sets[n] = rule_sets[n];
+	job->n = n;
+
+	context->jobs[context->num_jobs++] = job;
+
+	snprintf(name, sizeof(name), "acl-bld-%u", n);
+	rc = rte_thread_create_internal_control(&job->tid, name,
+		acl_build_job_run, job);
+	if (rc == 0)
+		job->threaded = 1;
+	else
+		acl_build_job_run(job);
+
+	return 0;
+}
+
 static int
 acl_build_tries(struct acl_build_context *context,
 	struct rte_acl_build_rule *head)
 {
+	int32_t rc;
 	uint32_t n, num_tries;
 	struct rte_acl_config *config;
 	struct rte_acl_build_rule *last;
@@ -1375,7 +1519,8 @@ acl_build_tries(struct acl_build_context *context,
 		last = build_one_trie(context, rule_sets, n, context->node_max);
 		if (context->bld_tries[n].trie == NULL) {
 			ACL_LOG(ERR, "Build of %u-th trie failed", n);
-			return -ENOMEM;
+			rc = -ENOMEM;
+			goto err;
 		}
 
 		/* Build of the last trie completed. */
@@ -1386,7 +1531,8 @@ acl_build_tries(struct acl_build_context *context,
 			ACL_LOG(ERR,
 				"Exceeded max number of tries: %u",
 				num_tries);
-			return -ENOMEM;
+			rc = -ENOMEM;
+			goto err;
 		}
 
 		/* Trie is getting too big, split remaining rule set. */
@@ -1406,32 +1552,57 @@ acl_build_tries(struct acl_build_context *context,
 		/*
 		 * Rebuild the trie for the reduced rule-set.
 		 * Don't try to split it any further.
+		 * With workers, that runs while the next split is searched.
 		 */
+		if (context->num_workers > 1) {
+			rc = acl_build_job_start(context, rule_sets, n);
+			if (rc != 0)
+				goto err;
+			continue;
+		}
+
 		last = build_one_trie(context, rule_sets, n, INT32_MAX);
 		if (context->bld_tries[n].trie == NULL || last != NULL) {
 			ACL_LOG(ERR, "Build of %u-th trie failed", n);
-			return -ENOMEM;
+			rc = -ENOMEM;
+			goto err;
 		}
 
 	}
 
+	rc = acl_build_jobs_wait(context, context->num_jobs);
+	if (rc != 0)
+		return rc;
+
 	context->num_tries = num_tries;
 	return 0;
+
+err:
+	/* the workers use the build context, don't leave them running */
+	acl_build_jobs_wait(context, context->num_jobs);
+	return rc;
 }
 
 static void
 acl_build_log(const struct acl_build_context *ctx)
 {
 	uint32_t n;
+	size_t alloc;
+
+	alloc = ctx->pool.alloc;
+	for (n = 0; n != ctx->num_jobs; n++)
+		alloc += ctx->jobs[n]->bcx.pool.alloc;
 
 	RTE_LOG(DEBUG, ACL, "Build phase for ACL \"%s\":\n"
 		"node limit for tree split: %u\n"
 		"nodes created: %u\n"
-		"memory consumed: %zu\n",
+		"memory consumed: %zu\n"
+		"tries rebuilt by workers: %u\n",
 		ctx->acx->name,
 		ctx->node_max,
 		ctx->num_nodes,
-		ctx->pool.alloc);
+		alloc,
+		ctx->num_jobs);
 
 	for (n = 0; n < RTE_DIM(ctx->tries); n++) {
 		if (ctx->tries[n].count != 0)
@@ -1508,7 +1679,8 @@ acl_set_data_indexes(struct rte_acl_ctx *ctx)
  */
 static int
 acl_bld(struct acl_build_context *bcx, struct rte_acl_ctx *ctx,
-	const struct rte_acl_config *cfg, uint32_t node_max)
+	const struct rte_acl_config *cfg, uint32_t node_max,
+	uint32_t num_workers, struct tb_mem_arena *arena)
 {
 	int32_t rc;
 
@@ -1517,18 +1689,27 @@ acl_bld(struct acl_build_context *bcx, struct rte_acl_ctx *ctx,
 	bcx->acx = ctx;
 	bcx->pool.alignment = ACL_POOL_ALIGN;
 	bcx->pool.min_alloc = ACL_POOL_ALLOC_MIN;
+	bcx->pool.arena = arena;
 	bcx->cfg = *cfg;
 	bcx->category_mask = RTE_LEN2MASK(bcx->cfg.num_categories,
 		typeof(bcx->category_mask));
 	bcx->node_max = node_max;
+	bcx->num_workers = num_workers;
 
 	rc = sigsetjmp(bcx->pool.fail, 0);
 
 	/* build phase runs out of memory. */
 	if (rc != 0) {
-		ACL_LOG(ERR,
-			"ACL context: %s, %s() failed with error code: %d",
-			bcx->acx->name, __func__, rc);
+		if (rc == -ERANGE)
+			ACL_LOG(DEBUG,
+				"ACL context: %s, %s() exceeds memory limit "
+				"with node limit: %u",
+				bcx->acx->name, __func__, node_max);
+		else
+			ACL_LOG(ERR,
+				"ACL context: %s, %s() failed with error code: %d",
+				bcx->acx->name, __func__, rc);
+		acl_build_jobs_wait(bcx, bcx->num_jobs);
 		return rc;
 	}
 
@@ -1550,7 +1731,7 @@ acl_bld(struct acl_build_context *bcx, struct rte_acl_ctx *ctx,
 /*
  * Check that parameters for acl_build() are valid.
  */
-static int
+int
 acl_check_bld_param(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
 {
 	static const size_t field_sizes[] = {
@@ -1623,16 +1804,35 @@ get_first_load_size(const struct rte_acl_config *cfg)
 
 int
 rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
+{
+	return rte_acl_build_ext(ctx, cfg, NULL, NULL);
+}
+
+int
+rte_acl_build_ext(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg,
+	const struct rte_acl_build_param *prm, struct rte_acl_build_stats *stats)
 {
 	int32_t rc;
-	uint32_t n;
+	uint32_t n, num_workers;
 	size_t max_size;
 	struct acl_build_context bcx;
+	struct tb_mem_arena arena;
 
 	rc = acl_check_bld_param(ctx, cfg);
 	if (rc != 0)
 		return rc;
 
+	/* incrementally updated context: rebuild its main trie */
+	if (ctx->incr != NULL)
+		return acl_incr_build(ctx, cfg);
+
+	num_workers = 1;
+	tb_arena_init(&arena, 0);
+	if (prm != NULL) {
+		num_workers = RTE_MAX(prm->num_workers, 1U);
+		tb_arena_init(&arena, prm->max_tmp_size);
+	}
+
 	acl_build_reset(ctx);
 
 	if (cfg->max_size == 0) {
@@ -1646,7 +1846,7 @@ rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
 	for (rc = -ERANGE; n >= NODE_MIN && rc == -ERANGE; n /= 2) {
 
 		/* perform build phase. */
-		rc = acl_bld(&bcx, ctx, cfg, n);
+		rc = acl_bld(&bcx, ctx, cfg, n, num_workers, &arena);
 
 		if (rc == 0) {
 			/* allocate and fill run-time  structures. */
@@ -1668,9 +1868,22 @@ rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
 
 		acl_build_log(&bcx);
 
+		if (stats != NULL) {
+			stats->num_tries = bcx.num_tries;
+			stats->num_nodes = bcx.num_nodes;
+		}
+
 		/* cleanup after build. */
+		acl_build_jobs_free(&bcx);
 		tb_free_pool(&bcx.pool);
 	}
 
+	if (stats != NULL) {
+		stats->peak_tmp_size = tb_arena_peak(&arena);
+		stats->rt_size = (rc == 0) ? ctx->mem_sz : 0;
+		if (rc != 0)
+			stats->num_tries = 0;
+	}
+
 	return rc;
 }
@@ -0,0 +1,694 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 The DPDK contributors
+ */
+
+#include <rte_acl.h>
+#include <rte_rcu_qsbr.h>
+#include <rte_stdatomic.h>
+
+#include "acl.h"
+#include "acl_log.h"
+
+/*
+ * Incremental updates.
+ *
+ * The rules of the context are split between a main trie, built from
+ * all the rules at the time of the last merge, and a small delta trie
+ * rebuilt on every update. The delta holds:
+ * - the rules added since the last merge;
+ * - the live main rules that could be the best match of a packet whose
+ *   main trie match is a deleted rule.
+ * Any such rule matches the same packet as the deleted one, so it
+ * overlaps it on all fields, shares a category with it and doesn't have
+ * a higher priority. Only those are replicated into the delta.
+ *
+ * The classification looks up both tries and per category keeps the
+ * highest priority match, ignoring main matches on deleted rules.
+ * Rules in the internal tries carry their internal index as userdata,
+ * the user one is restored from the meta arrays.
+ */
+
+/* number of packets classified against both tries at once */
+#define ACL_INCR_BURST	64
+
+struct acl_incr_meta {
+	uint32_t userdata;
+	int32_t priority;
+};
+
+/* run-time state, replaced as a whole on each update */
+struct acl_incr_state {
+	struct rte_acl_ctx *main;
+	struct acl_incr_meta *main_meta;
+	uint64_t *deleted;  /* deleted main rules, NULL if none */
+	struct rte_acl_ctx *delta;
+	struct acl_incr_meta *delta_meta;
+};
+
+struct acl_incr {
+	RTE_ATOMIC(struct acl_incr_state *) state;
+	struct rte_rcu_qsbr *v;
+	uint32_t max_delta;
+	struct rte_acl_config cfg;
+
+	/* writer side bookkeeping */
+	uint32_t num_main;    /* rules in the main trie */
+	uint8_t *main_rules;  /* copy of the rules in the main trie */
+	uint64_t *deleted;    /* deleted main rules */
+	uint32_t num_deleted;
+	uint8_t *in_delta;    /* main rules replicated into the delta */
+	uint32_t num_in_delta;
+	uint32_t num_added;   /* trailing ctx->rules not in the main trie */
+};
+
+#define ACL_INCR_BMP_SZ(n)	(RTE_ALIGN_CEIL(n, 64) / 64 * sizeof(uint64_t))
+
+static inline int
+acl_incr_bmp_test(const uint64_t *bmp, uint32_t i)
+{
+	return (bmp[i / 64] & (UINT64_C(1) << (i % 64))) != 0;
+}
+
+static inline void
+acl_incr_bmp_set(uint64_t *bmp, uint32_t i)
+{
+	bmp[i / 64] |= UINT64_C(1) << (i % 64);
+}
+
+static inline const struct rte_acl_rule *
+acl_incr_rule(const void *rules, uint32_t rule_sz, uint32_t i)
+{
+	return (const struct rte_acl_rule *)
+		((uintptr_t)rules + (size_t)i * rule_sz);
+}
+
+static void
+acl_incr_state_free(struct acl_incr_state *st, int free_main)
+{
+	if (st == NULL)
+		return;
+
+	if (free_main) {
+		acl_ctx_release(st->main);
+		rte_free(st->main_meta);
+	}
+	acl_ctx_release(st->delta);
+	rte_free(st->delta_meta);
+	rte_free(st->deleted);
+	rte_free(st);
+}
+
+/*
+ * Make a new state visible to the classification and reclaim the old one.
+ */
+static void
+acl_incr_publish(struct acl_incr *incr, struct acl_incr_state *st)
+{
+	struct acl_incr_state *old;
+
+	old = rte_atomic_exchange_explicit(&incr->state, st,
+		rte_memory_order_acq_rel);
+	if (old == NULL)
+		return;
+
+	if (incr->v != NULL)
+		rte_rcu_qsbr_synchronize(incr->v, RTE_QSBR_THRID_INVALID);
+
+	acl_incr_state_free(old, old->main != st->main);
+}
+
+/*
+ * Build an internal context from the given rule pointers,
+ * replacing their userdata with internal indexes.
+ */
+static int
+acl_incr_trie_build(const struct rte_acl_ctx *ctx,
+	const struct rte_acl_config *cfg, const struct rte_acl_rule **rules,
+	uint32_t num, struct rte_acl_ctx **trie, struct acl_incr_meta **meta)
+{
+	int32_t rc;
+	uint32_t i;
+	struct rte_acl_ctx *tctx;
+	struct rte_acl_rule *r;
+	struct acl_incr_meta *md;
+
+	*trie = NULL;
+	*meta = NULL;
+	if (num == 0)
+		return 0;
+
+	tctx = acl_ctx_alloc(ctx->name, ctx->socket_id, num, ctx->rule_sz);
+	md = rte_malloc_socket(NULL, num * sizeof(md[0]), 0, ctx->socket_id);
+	if (tctx == NULL || md == NULL) {
+		acl_ctx_release(tctx);
+		rte_free(md);
+		return -ENOMEM;
+	}
+
+	for (i = 0; i != num; i++) {
+		r = (struct rte_acl_rule *)((uintptr_t)tctx->rules +
+			(size_t)i * tctx->rule_sz);
+		memcpy(r, rules[i], ctx->rule_sz);
+		md[i].userdata = r->data.userdata;
+		md[i].priority = r->data.priority;
+		r->data.userdata = i + 1;
+	}
+	tctx->num_rules = num;
+	tctx->alg = ctx->alg;
+
+	rc = rte_acl_build(tctx, cfg);
+	if (rc != 0) {
+		acl_ctx_release(tctx);
+		rte_free(md);
+		return rc;
+	}
+
+	*trie = tctx;
+	*meta = md;
+	return 0;
+}
+
+/*
+ * Rebuild the main trie from all live rules of the context.
+ */
+static int
+acl_incr_merge(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
+{
+	int32_t rc;
+	uint32_t i, n;
+	struct acl_incr *incr;
+	struct acl_incr_state *st;
+	const struct rte_acl_rule **rp;
+	uint8_t *main_rules, *in_delta;
+	uint64_t *deleted;
+
+	incr = ctx->incr;
+	n = ctx->num_rules;
+
+	rp = rte_malloc(NULL, (n + 1) * sizeof(rp[0]), 0);
+	st = rte_zmalloc_socket(NULL, sizeof(*st), 0, ctx->socket_id);
+	main_rules = rte_malloc(NULL, (size_t)n * ctx->rule_sz + 1, 0);
+	deleted = rte_zmalloc(NULL, ACL_INCR_BMP_SZ(n + 1), 0);
+	in_delta = rte_zmalloc(NULL, n + 1, 0);
+	if (rp == NULL || st == NULL || main_rules == NULL ||
+			deleted == NULL || in_delta == NULL) {
+		rc = -ENOMEM;
+		goto err;
+	}
+
+	for (i = 0; i != n; i++)
+		rp[i] = acl_incr_rule(ctx->rules, ctx->rule_sz, i);
+
+	rc = acl_incr_trie_build(ctx, cfg, rp, n, &st->main, &st->main_meta);
+	if (rc != 0)
+		goto err;
+
+	rte_free(rp);
+	acl_incr_publish(incr, st);
+
+	memcpy(main_rules, ctx->rules, (size_t)n * ctx->rule_sz);
+	rte_free(incr->main_rules);
+	rte_free(incr->deleted);
+	rte_free(incr->in_delta);
+	incr->main_rules = main_rules;
+	incr->deleted = deleted;
+	incr->in_delta = in_delta;
+	incr->num_main = n;
+	incr->num_deleted = 0;
+	incr->num_in_delta = 0;
+	incr->num_added = 0;
+	incr->cfg = *cfg;
+
+	ctx->config = *cfg;
+	ctx->num_categories = cfg->num_categories;
+	return 0;
+
+err:
+	rte_free(rp);
+	rte_free(st);
+	rte_free(main_rules);
+	rte_free(deleted);
+	rte_free(in_delta);
+	return rc;
+}
+
+/*
+ * Rebuild the delta trie after an update, or the main one if
+ * the delta grew too big.
+ */
+static int
+acl_incr_update(struct rte_acl_ctx *ctx)
+{
+	int32_t rc;
+	uint32_t i, j, n, num_added;
+	struct acl_incr *incr;
+	struct acl_incr_state *cur, *st;
+	const struct rte_acl_rule **rp;
+
+	incr = ctx->incr;
+	num_added = incr->num_added;
+	n = num_added + incr->num_in_delta;
+	if (n > incr->max_delta)
+		return acl_incr_merge(ctx, &incr->cfg);
+
+	cur = rte_atomic_load_explicit(&incr->state, rte_memory_order_relaxed);
+
+	rp = rte_malloc(NULL, (n + 1) * sizeof(rp[0]), 0);
+	st = rte_zmalloc_socket(NULL, sizeof(*st), 0, ctx->socket_id);
+	if (rp == NULL || st == NULL) {
+		rc = -ENOMEM;
+		goto err;
+	}
+
+	st->main = cur->main;
+	st->main_meta = cur->main_meta;
+
+	if (incr->num_deleted != 0) {
+		st->deleted = rte_malloc_socket(NULL,
+			ACL_INCR_BMP_SZ(incr->num_main), 0, ctx->socket_id);
+		if (st->deleted == NULL) {
+			rc = -ENOMEM;
+			goto err;
+		}
+		memcpy(st->deleted, incr->deleted,
+			ACL_INCR_BMP_SZ(incr->num_main));
+	}
+
+	j = 0;
+	for (i = 0; i != incr->num_main; i++) {
+		if (incr->in_delta[i] != 0)
+			rp[j++] = acl_incr_rule(incr->main_rules,
+				ctx->rule_sz, i);
+	}
+	for (i = ctx->num_rules - num_added; i != ctx->num_rules; i++)
+		rp[j++] = acl_incr_rule(ctx->rules, ctx->rule_sz, i);
+
+	rc = acl_incr_trie_build(ctx, &incr->cfg, rp, n, &st->delta,
+		&st->delta_meta);
+	if (rc != 0)
+		goto err;
+
+	rte_free(rp);
+	acl_incr_publish(incr, st);
+	return 0;
+
+err:
+	rte_free(rp);
+	if (st != NULL)
+		rte_free(st->deleted);
+	rte_free(st);
+	return rc;
+}
+
+static uint64_t
+acl_incr_fld_val(const union rte_acl_field_types *fld, uint32_t size)
+{
+	switch (size) {
+	case sizeof(uint8_t):
+		return fld->u8;
+	case sizeof(uint16_t):
+		return fld->u16;
+	case sizeof(uint32_t):
+		return fld->u32;
+	default:
+		return fld->u64;
+	}
+}
+
+/*
+ * Check if there is an input that both rules match.
+ */
+static int
+acl_incr_rule_overlap(const struct rte_acl_config *cfg,
+	const struct rte_acl_rule *a, const struct rte_acl_rule *b)
+{
+	uint32_t i, k, len, size;
+	uint64_t msk, ma, mb, va, vb;
+	const struct rte_acl_field *fa, *fb;
+
+	if ((a->data.category_mask & b->data.category_mask) == 0)
+		return 0;
+
+	for (i = 0; i != cfg->num_fields; i++) {
+		k = cfg->defs[i].field_index;
+		size = cfg->defs[i].size;
+		fa = &a->field[k];
+		fb = &b->field[k];
+
+		msk = RTE_LEN2MASK(size * CHAR_BIT, uint64_t);
+		va = acl_incr_fld_val(&fa->value, size);
+		vb = acl_incr_fld_val(&fb->value, size);
+		ma = acl_incr_fld_val(&fa->mask_range, size);
+		mb = acl_incr_fld_val(&fb->mask_range, size);
+
+		switch (cfg->defs[i].type) {
+		case RTE_ACL_FIELD_TYPE_RANGE:
+			if (va > mb || vb > ma)
+				return 0;
+			break;
+		case RTE_ACL_FIELD_TYPE_MASK:
+			len = RTE_MIN(fa->mask_range.u32, size * CHAR_BIT);
+			ma = RTE_ACL_MASKLEN_TO_BITMASK((uint64_t)len, size);
+			len = RTE_MIN(fb->mask_range.u32, size * CHAR_BIT);
+			mb = RTE_ACL_MASKLEN_TO_BITMASK((uint64_t)len, size);
+			/* fall through */
+		default:
+			if (((va ^ vb) & ma & mb & msk) != 0)
+				return 0;
+		}
+	}
+
+	return 1;
+}
+
+static int
+acl_incr_rule_equal(const struct rte_acl_config *cfg,
+	const struct rte_acl_rule *a, const struct rte_acl_rule *b)
+{
+	uint32_t i, k, size;
+
+	if (a->data.category_mask != b->data.category_mask ||
+			a->data.priority != b->data.priority ||
+			a->data.userdata != b->data.userdata)
+		return 0;
+
+	for (i = 0; i != cfg->num_fields; i++) {
+		k = cfg->defs[i].field_index;
+		size = cfg->defs[i].size;
+		if (acl_incr_fld_val(&a->field[k].value, size) !=
+				acl_incr_fld_val(&b->field[k].value, size) ||
+				acl_incr_fld_val(&a->field[k].mask_range, size) !=
+				acl_incr_fld_val(&b->field[k].mask_range, size))
+			return 0;
+	}
+
+	return 1;
+}
+
+/*
+ * Delete main rule idx: replicate into the delta the live main rules
+ * that can take over its matches.
+ */
+static void
+acl_incr_del_main(struct rte_acl_ctx *ctx, uint32_t idx)
+{
+	uint32_t i;
+	struct acl_incr *incr;
+	const struct rte_acl_rule *rd, *r;
+
+	incr = ctx->incr;
+	rd = acl_incr_rule(incr->main_rules, ctx->rule_sz, idx);
+
+	acl_incr_bmp_set(incr->deleted, idx);
+	incr->num_deleted++;
+	if (incr->in_delta[idx] != 0) {
+		incr->in_delta[idx] = 0;
+		incr->num_in_delta--;
+	}
+
+	for (i = 0; i != incr->num_main; i++) {
+		if (incr->in_delta[i] != 0 ||
+				acl_incr_bmp_test(incr->deleted, i))
+			continue;
+		r = acl_incr_rule(incr->main_rules, ctx->rule_sz, i);
+		if (r->data.priority <= rd->data.priority &&
+				acl_incr_rule_overlap(&incr->cfg, r, rd)) {
+			incr->in_delta[i] = 1;
+			incr->num_in_delta++;
+		}
+	}
+}
+
+/*
+ * Find and delete one live rule equal to the given one.
+ */
+static int
+acl_incr_del_rule(struct rte_acl_ctx *ctx, const struct rte_acl_rule *rule)
+{
+	uint32_t i, n, pos;
+	uint8_t *p;
+	struct acl_incr *incr;
+
+	incr = ctx->incr;
+	n = ctx->num_rules - incr->num_added;
+
+	/* main rules are kept in ctx->rules in the same order */
+	pos = 0;
+	for (i = 0; i != incr->num_main; i++) {
+		if (acl_incr_bmp_test(incr->deleted, i))
+			continue;
+		if (acl_incr_rule_equal(&incr->cfg, rule,
+				acl_incr_rule(incr->main_rules, ctx->rule_sz,
+				i)))
+			break;
+		pos++;
+	}
+
+	if (i != incr->num_main)
+		acl_incr_del_main(ctx, i);
+	else {
+		for (pos = n; pos != ctx->num_rules; pos++) {
+			if (acl_incr_rule_equal(&incr->cfg, rule,
+					acl_incr_rule(ctx->rules,
+					ctx->rule_sz, pos)))
+				break;
+		}
+		if (pos == ctx->num_rules)
+			return -ENOENT;
+		incr->num_added--;
+	}
+
+	p = ctx->rules;
+	memmove(p + (size_t)pos * ctx->rule_sz,
+		p + (size_t)(pos + 1) * ctx->rule_sz,
+		(size_t)(ctx->num_rules - pos - 1) * ctx->rule_sz);
+	ctx->num_rules--;
+	return 0;
+}
+
+int
+acl_incr_classify(const struct rte_acl_ctx *ctx, const uint8_t **data,
+	uint32_t *results, uint32_t num, uint32_t categories,
+	enum rte_acl_classify_alg alg)
+{
+	int32_t rc;
+	uint32_t d, i, k, m, n;
+	uint32_t *res;
+	rte_acl_classify_t fn;
+	const struct acl_incr_state *st;
+	uint32_t dres[ACL_INCR_BURST * RTE_ACL_MAX_CATEGORIES];
+
+	st = rte_atomic_load_explicit(&ctx->incr->state,
+		rte_memory_order_acquire);
+	fn = acl_get_classify_fn(alg);
+
+	for (n = 0; n < num; n += k) {
+		k = RTE_MIN(num - n, (uint32_t)ACL_INCR_BURST);
+		res = results + n * categories;
+
+		if (st->main != NULL) {
+			rc = fn(st->main, data + n, res, k, categories);
+			if (rc != 0)
+				return rc;
+		} else
+			memset(res, 0, k * categories * sizeof(res[0]));
+
+		if (st->delta != NULL) {
+			rc = fn(st->delta, data + n, dres, k, categories);
+			if (rc != 0)
+				return rc;
+		}
+
+		for (i = 0; i != k * categories; i++) {
+			m = res[i];
+			d = (st->delta != NULL) ? dres[i] : 0;
+
+			if (m != 0 && st->deleted != NULL &&
+					acl_incr_bmp_test(st->deleted, m - 1))
+				m = 0;
+
+			if (d != 0 && (m == 0 ||
+					st->delta_meta[d - 1].priority >
+					st->main_meta[m - 1].priority))
+				res[i] = st->delta_meta[d - 1].userdata;
+			else if (m != 0)
+				res[i] = st->main_meta[m - 1].userdata;
+			else
+				res[i] = 0;
+		}
+	}
+
+	return 0;
+}
+
+int
+acl_incr_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
+{
+	return acl_incr_merge(ctx, cfg);
+}
+
+void
+acl_incr_reset_rules(struct rte_acl_ctx *ctx)
+{
+	uint32_t i;
+	struct acl_incr *incr;
+
+	incr = ctx->incr;
+	if (incr == NULL)
+		return;
+
+	/* all rules are gone, visible after the next update or build */
+	memset(incr->in_delta, 0, incr->num_main);
+	for (i = 0; i != incr->num_main; i++)
+		acl_incr_bmp_set(incr->deleted, i);
+	incr->num_deleted = incr->num_main;
+	incr->num_in_delta = 0;
+	incr->num_added = 0;
+}
+
+void
+acl_incr_free(struct rte_acl_ctx *ctx)
+{
+	struct acl_incr *incr;
+
+	incr = ctx->incr;
+	if (incr == NULL)
+		return;
+
+	ctx->incr = NULL;
+	acl_incr_state_free(rte_atomic_load_explicit(&incr->state,
+		rte_memory_order_relaxed), 1);
+	rte_free(incr->main_rules);
+	rte_free(incr->deleted);
+	rte_free(incr->in_delta);
+	rte_free(incr);
+}
+
+void
+acl_incr_dump(const struct rte_acl_ctx *ctx)
+{
+	const struct acl_incr *incr;
+
+	incr = ctx->incr;
+	if (incr == NULL)
+		return;
+
+	printf("  incremental: main_rules=%"PRIu32", deleted=%"PRIu32
+		", added=%"PRIu32", replicated=%"PRIu32
+		", max_delta=%"PRIu32"\n",
+		incr->num_main, incr->num_deleted, incr->num_added,
+		incr->num_in_delta, incr->max_delta);
+}
+
+int
+rte_acl_incr_enable(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg,
+	const struct rte_acl_incr_config *icfg)
+{
+	int32_t rc;
+	struct acl_incr *incr;
+
+	if (ctx == NULL || cfg == NULL || ctx->rule_sz == 0)
+		return -EINVAL;
+	if (ctx->incr != NULL)
+		return -EEXIST;
+
+	rc = acl_check_bld_param(ctx, cfg);
+	if (rc != 0)
+		return rc;
+
+	incr = rte_zmalloc_socket(NULL, sizeof(*incr), 0, ctx->socket_id);
+	if (incr == NULL)
+		return -ENOMEM;
+
+	incr->max_delta = RTE_ACL_INCR_MAX_DELTA_DEFAULT;
+	if (icfg != NULL) {
+		incr->v = icfg->v;
+		if (icfg->max_delta_rules != 0)
+			incr->max_delta = icfg->max_delta_rules;
+	}
+
+	ctx->incr = incr;
+	rc = acl_incr_merge(ctx, cfg);
+	if (rc != 0) {
+		ACL_LOG(ERR, "ACL context: %s, incremental mode setup failed: %d",
+			ctx->name, rc);
+		ctx->incr = NULL;
+		rte_free(incr);
+	}
+
+	return rc;
+}
+
+int
+rte_acl_incr_add_rules(struct rte_acl_ctx *ctx,
+	const struct rte_acl_rule *rules, uint32_t num)
+{
+	int32_t rc;
+	uint32_t i;
+	uint8_t *pos;
+
+	if (ctx == NULL || rules == NULL || ctx->incr == NULL)
+		return -EINVAL;
+
+	for (i = 0; i != num; i++) {
+		rc = acl_check_rule(&acl_incr_rule(rules, ctx->rule_sz,
+			i)->data);
+		if (rc != 0) {
+			ACL_LOG(ERR, "%s(%s): rule #%u is invalid",
+				__func__, ctx->name, i + 1);
+			return rc;
+		}
+	}
+
+	if (num + ctx->num_rules > ctx->max_rules)
+		return -ENOMEM;
+
+	pos = ctx->rules;
+	memcpy(pos + (size_t)ctx->num_rules * ctx->rule_sz, rules,
+		(size_t)num * ctx->rule_sz);
+	ctx->num_rules += num;
+	ctx->incr->num_added += num;
+
+	rc = acl_incr_update(ctx);
+	if (rc != 0) {
+		ctx->num_rules -= num;
+		ctx->incr->num_added -= num;
+	}
+
+	return rc;
+}
+
+int
+rte_acl_incr_del_rules(struct rte_acl_ctx *ctx,
+	const struct rte_acl_rule *rules, uint32_t num)
+{
+	int32_t rc, rc2;
+	uint32_t i;
+
+	if (ctx == NULL || rules == NULL || ctx->incr == NULL)
+		return -EINVAL;
+
+	rc = 0;
+	for (i = 0; i != num && rc == 0; i++)
+		rc = acl_incr_del_rule(ctx,
+			acl_incr_rule(rules, ctx->rule_sz, i));
+
+	if (i == 1 && rc != 0)
+		return rc;
+
+	/* publish the deletions done, fall back to a full rebuild */
+	rc2 = acl_incr_update(ctx);
+	if (rc2 != 0)
+		rc2 = acl_incr_merge(ctx, &ctx->incr->cfg);
+
+	return (rc2 != 0) ? rc2 : rc;
+}
+
+int
+rte_acl_incr_merge(struct rte_acl_ctx *ctx)
+{
+	if (ctx == NULL || ctx->incr == NULL)
+		return -EINVAL;
+
+	return acl_incr_merge(ctx, &ctx->incr->cfg);
+}
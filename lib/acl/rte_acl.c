@@ -104,6 +104,12 @@ static const rte_acl_classify_t classify_fns[] = {
 	[RTE_ACL_CLASSIFY_AVX512X32] = rte_acl_classify_avx512x32,
 };
 
+rte_acl_classify_t
+acl_get_classify_fn(enum rte_acl_classify_alg alg)
+{
+	return classify_fns[alg];
+}
+
 /*
  * Helper function for acl_check_alg.
  * Check support for ARM specific classify methods.
@@ -294,6 +300,10 @@ rte_acl_classify_alg(const struct rte_acl_ctx *ctx, const uint8_t **data,
 			((RTE_ACL_RESULTS_MULTIPLIER - 1) & categories) != 0)
 		return -EINVAL;
 
+	if (ctx->incr != NULL)
+		return acl_incr_classify(ctx, data, results, num, categories,
+			alg);
+
 	return classify_fns[alg](ctx, data, results, num, categories);
 }
 
@@ -356,19 +366,59 @@ rte_acl_free(struct rte_acl_ctx *ctx)
 
 	rte_mcfg_tailq_write_unlock();
 
+	acl_incr_free(ctx);
+	acl_ctx_release(ctx);
+	rte_free(te);
+}
+
+struct rte_acl_ctx *
+acl_ctx_alloc(const char *name, int32_t socket_id, uint32_t max_rules,
+	uint32_t rule_sz)
+{
+	size_t sz;
+	struct rte_acl_ctx *ctx;
+	char buf[sizeof(ctx->name)];
+
+	snprintf(buf, sizeof(buf), "ACL_%s", name);
+
+	/* calculate amount of memory required for pattern set. */
+	sz = sizeof(*ctx) + (size_t)max_rules * rule_sz;
+
+	ctx = rte_zmalloc_socket(buf, sz, RTE_CACHE_LINE_SIZE, socket_id);
+	if (ctx == NULL) {
+		ACL_LOG(ERR,
+			"allocation of %zu bytes on socket %d for %s failed",
+			sz, socket_id, buf);
+		return NULL;
+	}
+
+	/* init new allocated context. */
+	ctx->rules = ctx + 1;
+	ctx->max_rules = max_rules;
+	ctx->rule_sz = rule_sz;
+	ctx->socket_id = socket_id;
+	ctx->alg = acl_get_best_alg();
+	strlcpy(ctx->name, name, sizeof(ctx->name));
+
+	return ctx;
+}
+
+void
+acl_ctx_release(struct rte_acl_ctx *ctx)
+{
+	if (ctx == NULL)
+		return;
+
 	rte_free(ctx->mem);
 	rte_free(ctx);
-	rte_free(te);
 }
 
 struct rte_acl_ctx *
 rte_acl_create(const struct rte_acl_param *param)
 {
-	size_t sz;
 	struct rte_acl_ctx *ctx;
 	struct rte_acl_list *acl_list;
 	struct rte_tailq_entry *te;
-	char name[sizeof(ctx->name)];
 
 	acl_list = RTE_TAILQ_CAST(rte_acl_tailq.head, rte_acl_list);
 
@@ -378,11 +428,6 @@ rte_acl_create(const struct rte_acl_param *param)
 		return NULL;
 	}
 
-	snprintf(name, sizeof(name), "ACL_%s", param->name);
-
-	/* calculate amount of memory required for pattern set. */
-	sz = sizeof(*ctx) + param->max_rule_num * param->rule_size;
-
 	/* get EAL TAILQ lock. */
 	rte_mcfg_tailq_write_lock();
 
@@ -403,22 +448,12 @@ rte_acl_create(const struct rte_acl_param *param)
 			goto exit;
 		}
 
-		ctx = rte_zmalloc_socket(name, sz, RTE_CACHE_LINE_SIZE, param->socket_id);
-
+		ctx = acl_ctx_alloc(param->name, param->socket_id,
+			param->max_rule_num, param->rule_size);
 		if (ctx == NULL) {
-			ACL_LOG(ERR,
-				"allocation of %zu bytes on socket %d for %s failed",
-				sz, param->socket_id, name);
 			rte_free(te);
 			goto exit;
 		}
-		/* init new allocated context. */
-		ctx->rules = ctx + 1;
-		ctx->max_rules = param->max_rule_num;
-		ctx->rule_sz = param->rule_size;
-		ctx->socket_id = param->socket_id;
-		ctx->alg = acl_get_best_alg();
-		strlcpy(ctx->name, param->name, sizeof(ctx->name));
 
 		te->data = (void *) ctx;
 
@@ -446,7 +481,7 @@ acl_add_rules(struct rte_acl_ctx *ctx, const void *rules, uint32_t num)
 	return 0;
 }
 
-static int
+int
 acl_check_rule(const struct rte_acl_rule_data *rd)
 {
 	if ((RTE_LEN2MASK(RTE_ACL_MAX_CATEGORIES, typeof(rd->category_mask)) &
@@ -468,6 +503,9 @@ rte_acl_add_rules(struct rte_acl_ctx *ctx, const struct rte_acl_rule *rules,
 	if (ctx == NULL || rules == NULL || 0 == ctx->rule_sz)
 		return -EINVAL;
 
+	if (ctx->incr != NULL)
+		return rte_acl_incr_add_rules(ctx, rules, num);
+
 	for (i = 0; i != num; i++) {
 		rv = (const struct rte_acl_rule *)
 			((uintptr_t)rules + i * ctx->rule_sz);
@@ -489,8 +527,10 @@ rte_acl_add_rules(struct rte_acl_ctx *ctx, const struct rte_acl_rule *rules,
 void
 rte_acl_reset_rules(struct rte_acl_ctx *ctx)
 {
-	if (ctx != NULL)
+	if (ctx != NULL) {
 		ctx->num_rules = 0;
+		acl_incr_reset_rules(ctx);
+	}
 }
 
 /*
@@ -500,6 +540,7 @@ void
 rte_acl_reset(struct rte_acl_ctx *ctx)
 {
 	if (ctx != NULL) {
+		acl_incr_free(ctx);
 		rte_acl_reset_rules(ctx);
 		rte_acl_build(ctx, &ctx->config);
 	}
@@ -522,6 +563,7 @@ rte_acl_dump(const struct rte_acl_ctx *ctx)
 	printf("  num_rules=%"PRIu32"\n", ctx->num_rules);
 	printf("  num_categories=%"PRIu32"\n", ctx->num_categories);
 	printf("  num_tries=%"PRIu32"\n", ctx->num_tries);
+	acl_incr_dump(ctx);
 }
 
 /*
@@ -12,6 +12,7 @@
  */
 
 #include <rte_acl_osdep.h>
+#include <rte_compat.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -221,6 +222,65 @@ rte_acl_reset_rules(struct rte_acl_ctx *ctx);
 int
 rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg);
 
+/**
+ * Parameters for rte_acl_build_ext().
+ */
+struct rte_acl_build_param {
+	/**
+	 * Number of threads building the tries, including the calling one.
+	 * Once the rule set is split, each trie is rebuilt by a control
+	 * thread while the next split is searched.
+	 * 0 or 1 builds on the calling thread only.
+	 */
+	uint32_t num_workers;
+	/**
+	 * Limit of the temporary memory used by the build phase, in bytes.
+	 * When exceeded with a non-zero *max_size* in the configuration,
+	 * the build is retried with smaller tries as for *max_size*.
+	 * Zero means no limit.
+	 */
+	size_t max_tmp_size;
+};
+
+/**
+ * Statistics of a build, filled by rte_acl_build_ext().
+ */
+struct rte_acl_build_stats {
+	size_t peak_tmp_size; /**< Peak temporary memory of the build. */
+	size_t rt_size;       /**< Size of the run-time structures. */
+	uint32_t num_tries;   /**< Number of tries built. */
+	uint32_t num_nodes;   /**< Number of build nodes created. */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Analyze set of rules and build required internal run-time structures,
+ * possibly using several threads and bounding the temporary memory.
+ * This function is not multi-thread safe.
+ *
+ * @param ctx
+ *   ACL context to build.
+ * @param cfg
+ *   Pointer to struct rte_acl_config - defines build parameters.
+ * @param prm
+ *   Build resources, NULL to behave as rte_acl_build().
+ * @param stats
+ *   Filled with statistics of the build if not NULL.
+ * @return
+ *   - -ENOMEM if couldn't allocate enough memory.
+ *   - -ERANGE if the build couldn't fit in the given memory limits.
+ *   - -EINVAL if the parameters are invalid.
+ *   - Negative error code if operation failed.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_build_ext(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg,
+	const struct rte_acl_build_param *prm,
+	struct rte_acl_build_stats *stats);
+
 /**
  * Delete all rules from the ACL context and
  * destroy all internal run-time structures.
@@ -232,6 +292,138 @@ rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg);
 void
 rte_acl_reset(struct rte_acl_ctx *ctx);
 
+struct rte_rcu_qsbr;
+
+/** Default limit on the number of rules kept outside of the main trie. */
+#define RTE_ACL_INCR_MAX_DELTA_DEFAULT	1024
+
+/**
+ * Parameters for incremental updates of an ACL context.
+ */
+struct rte_acl_incr_config {
+	/**
+	 * RCU QSBR variable used to reclaim run-time structures replaced
+	 * by an update. If NULL, they are freed immediately and the
+	 * application must make sure no classification on the context
+	 * runs concurrently with an update.
+	 */
+	struct rte_rcu_qsbr *v;
+	/**
+	 * Maximum number of rules held in the delta trie. Once an update
+	 * makes the delta grow past it, the main trie is rebuilt from all
+	 * live rules. Zero means RTE_ACL_INCR_MAX_DELTA_DEFAULT.
+	 */
+	uint32_t max_delta_rules;
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Switch an ACL context to incremental update mode.
+ *
+ * The rules currently in the context are built into a main trie.
+ * Rules added or deleted afterwards with rte_acl_incr_add_rules() and
+ * rte_acl_incr_del_rules() only rebuild a small delta trie, that is
+ * looked up together with the main one by rte_acl_classify().
+ * Updates are published atomically: a classification running
+ * concurrently sees either the old or the new rule set.
+ *
+ * In that mode rte_acl_add_rules() behaves as rte_acl_incr_add_rules(),
+ * rte_acl_build() rebuilds the main trie from all live rules using the
+ * given configuration and rte_acl_reset() leaves the incremental mode.
+ *
+ * @param ctx
+ *   ACL context.
+ * @param cfg
+ *   Build configuration, used for both the main and the delta tries.
+ * @param icfg
+ *   Incremental update parameters, may be NULL for defaults.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - -EEXIST if the context is already in incremental mode.
+ *   - -ENOMEM if couldn't allocate enough memory.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_incr_enable(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg,
+	const struct rte_acl_incr_config *icfg);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Add rules to an ACL context in incremental update mode and make them
+ * visible to the classification.
+ * This function is not multi-thread safe with respect to other updates
+ * of the same context.
+ *
+ * @param ctx
+ *   ACL context.
+ * @param rules
+ *   Array of rules to add, same format as for rte_acl_add_rules().
+ * @param num
+ *   Number of elements in the input array of rules.
+ * @return
+ *   - -ENOMEM if there is no space in the ACL context for these rules.
+ *   - -EINVAL if the parameters are invalid.
+ *   - Negative error code if the rebuild of the delta trie failed,
+ *     the rules are not added then.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_incr_add_rules(struct rte_acl_ctx *ctx,
+	const struct rte_acl_rule *rules, uint32_t num);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Delete rules from an ACL context in incremental update mode.
+ * A rule is deleted if its data and all fields defined by the build
+ * configuration are equal to the given one. If several equal rules
+ * exist, only one of them is deleted.
+ * This function is not multi-thread safe with respect to other updates
+ * of the same context.
+ *
+ * @param ctx
+ *   ACL context.
+ * @param rules
+ *   Array of rules to delete.
+ * @param num
+ *   Number of elements in the input array of rules.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - -ENOENT if a rule was not found, the rules preceding it
+ *     in the array are deleted.
+ *   - Negative error code if the rebuild of the tries failed.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_incr_del_rules(struct rte_acl_ctx *ctx,
+	const struct rte_acl_rule *rules, uint32_t num);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Rebuild the main trie of an ACL context in incremental update mode
+ * from all live rules, emptying the delta trie.
+ *
+ * @param ctx
+ *   ACL context.
+ * @return
+ *   - -EINVAL if the context is not in incremental mode.
+ *   - Negative error code if the build failed.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_incr_merge(struct rte_acl_ctx *ctx);
+
 /**
  *  Available implementations of ACL classify.
  */
@@ -14,8 +14,41 @@
  *  it would do siglongjmp(pool->fail).
  *  It is responsibility of the caller to save the proper context/environment,
  *  in the pool->fail before calling tb_alloc() for the given pool first time.
+ *  Pools can share an arena, that keeps track of the memory allocated
+ *  by all of them and enforces a limit on it. Exceeding that limit
+ *  makes tb_alloc() do siglongjmp(pool->fail, -ERANGE).
  */
 
+static void
+tb_arena_alloc(struct tb_mem_pool *pool, size_t size)
+{
+	struct tb_mem_arena *arena;
+	size_t alloc, peak;
+
+	arena = pool->arena;
+	if (arena == NULL)
+		return;
+
+	alloc = rte_atomic_fetch_add_explicit(&arena->alloc, size,
+		rte_memory_order_relaxed) + size;
+
+	if (arena->limit != 0 && alloc > arena->limit) {
+		rte_atomic_fetch_sub_explicit(&arena->alloc, size,
+			rte_memory_order_relaxed);
+		ACL_LOG(DEBUG, "%s(%zu) exceeds build memory limit: %zu bytes",
+			__func__, size, arena->limit);
+		siglongjmp(pool->fail, -ERANGE);
+	}
+
+	peak = rte_atomic_load_explicit(&arena->peak,
+		rte_memory_order_relaxed);
+	while (alloc > peak &&
+			!rte_atomic_compare_exchange_weak_explicit(&arena->peak,
+				&peak, alloc, rte_memory_order_relaxed,
+				rte_memory_order_relaxed))
+		;
+}
+
 static struct tb_mem_block *
 tb_pool(struct tb_mem_pool *pool, size_t sz)
 {
@@ -24,10 +57,14 @@ tb_pool(struct tb_mem_pool *pool, size_t sz)
 	size_t size;
 
 	size = sz + pool->alignment - 1;
+	tb_arena_alloc(pool, size);
 	block = calloc(1, size + sizeof(*pool->block));
 	if (block == NULL) {
 		ACL_LOG(ERR, "%s(%zu) failed, currently allocated by pool: %zu bytes",
 			__func__, sz, pool->alloc);
+		if (pool->arena != NULL)
+			rte_atomic_fetch_sub_explicit(&pool->arena->alloc,
+				size, rte_memory_order_relaxed);
 		siglongjmp(pool->fail, -ENOMEM);
 		return NULL;
 	}
@@ -75,6 +112,24 @@ tb_free_pool(struct tb_mem_pool *pool)
 		next = block->next;
 		free(block);
 	}
+	if (pool->arena != NULL)
+		rte_atomic_fetch_sub_explicit(&pool->arena->alloc,
+			pool->alloc, rte_memory_order_relaxed);
 	pool->block = NULL;
 	pool->alloc = 0;
 }
+
+void
+tb_arena_init(struct tb_mem_arena *arena, size_t limit)
+{
+	rte_atomic_store_explicit(&arena->alloc, 0, rte_memory_order_relaxed);
+	rte_atomic_store_explicit(&arena->peak, 0, rte_memory_order_relaxed);
+	arena->limit = limit;
+}
+
+size_t
+tb_arena_peak(const struct tb_mem_arena *arena)
+{
+	return rte_atomic_load_explicit(&arena->peak,
+		rte_memory_order_relaxed);
+}
@@ -15,8 +15,20 @@
  */
 
 #include <rte_acl_osdep.h>
+#include <rte_stdatomic.h>
 #include <setjmp.h>
 
+/*
+ * Memory accounting shared by all the pools of one build,
+ * pools can be used from different threads.
+ */
+struct tb_mem_arena {
+	RTE_ATOMIC(size_t)   alloc;
+	RTE_ATOMIC(size_t)   peak;
+	/* max amount of memory for all pools, zero means no limit. */
+	size_t               limit;
+};
+
 struct tb_mem_block {
 	struct tb_mem_block *next;
 	struct tb_mem_pool  *pool;
@@ -29,6 +41,8 @@ struct tb_mem_pool {
 	size_t               alignment;
 	size_t               min_alloc;
 	size_t               alloc;
+	/* optional arena the pool allocations are accounted in. */
+	struct tb_mem_arena *arena;
 	/* jump target in case of memory allocation failure. */
 	sigjmp_buf           fail;
 };
@@ -36,4 +50,7 @@ struct tb_mem_pool {
 void *tb_alloc(struct tb_mem_pool *pool, size_t size);
 void tb_free_pool(struct tb_mem_pool *pool);
 
+void tb_arena_init(struct tb_mem_arena *arena, size_t limit);
+size_t tb_arena_peak(const struct tb_mem_arena *arena);
+
 #endif /* _TB_MEM_H_ */
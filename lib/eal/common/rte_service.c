@@ -3,6 +3,7 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <inttypes.h>
 #include <string.h>
 
@@ -19,6 +20,7 @@
 #include <rte_atomic.h>
 #include <rte_malloc.h>
 #include <rte_spinlock.h>
+#include <rte_telemetry.h>
 #include <rte_trace_point.h>
 
 #include "eal_private.h"
@@ -33,6 +35,12 @@
 #define RUNSTATE_STOPPED 0
 #define RUNSTATE_RUNNING 1
 
+/* cycles granted to a service per unit of weight, in adaptive mode */
+#define SERVICE_SCHED_QUANTUM 100
+/* range of the delay before calling again an idle service */
+#define SERVICE_SCHED_BACKOFF_MIN_US 1
+#define SERVICE_SCHED_BACKOFF_MAX_US 128
+
 /* internal representation of a service */
 struct __rte_cache_aligned rte_service_spec_impl {
 	/* public part of the struct */
@@ -49,6 +57,9 @@ struct __rte_cache_aligned rte_service_spec_impl {
 	RTE_ATOMIC(int8_t) comp_runstate;
 	uint8_t internal_flags;
 
+	/* share of the service cores time in adaptive mode */
+	RTE_ATOMIC(uint32_t) weight;
+
 	/* per service statistics */
 	/* Indicates how many cores the service is mapped to run on.
 	 * It does not indicate the number of cores the service is running
@@ -62,6 +73,23 @@ struct service_stats {
 	RTE_ATOMIC(uint64_t) idle_calls;
 	RTE_ATOMIC(uint64_t) error_calls;
 	RTE_ATOMIC(uint64_t) cycles;
+	/* calls of a service not mapped to the core, always counted */
+	RTE_ATOMIC(uint64_t) stolen_calls;
+};
+
+/* adaptive scheduling state of a service on a service core */
+struct service_sched {
+	/* cycles left to the service in the current loop, can go negative
+	 * when a call overruns the budget
+	 */
+	int64_t credit;
+	/* delay before calling again an idle service, 0 if not idle */
+	uint64_t backoff;
+	uint64_t next_tsc;
+	/* cycles spent in non-idle calls, written by the service core */
+	RTE_ATOMIC(uint64_t) busy_cycles;
+	/* busy_cycles seen by the last rebalance */
+	uint64_t busy_cycles_last;
 };
 
 /* the internal values of a service core */
@@ -75,12 +103,25 @@ struct __rte_cache_aligned core_state {
 	RTE_ATOMIC(uint64_t) loops;
 	RTE_ATOMIC(uint64_t) cycles;
 	struct service_stats service_stats[RTE_SERVICE_NUM_MAX];
+	RTE_ATOMIC(uint8_t) sched_mode; /* RTE_SERVICE_LCORE_SCHED_* */
+	struct service_sched sched[RTE_SERVICE_NUM_MAX];
+	RTE_ATOMIC(uint8_t) steal; /* set to run busy services of other cores */
+	uint32_t steal_next; /* service to look for first in the steal queue */
 };
 
 static uint32_t rte_service_count;
 static struct rte_service_spec_impl *rte_services;
 static RTE_LCORE_VAR_HANDLE(struct core_state, lcore_states);
 static uint32_t rte_service_library_initialized;
+static uint64_t sched_backoff_min;
+static uint64_t sched_backoff_max;
+
+/* MT safe services which did some work on their last call, to be run
+ * by the idle service cores with stealing enabled
+ */
+static RTE_ATOMIC(uint64_t) steal_queue;
+/* number of service cores with stealing enabled */
+static RTE_ATOMIC(uint32_t) steal_lcores;
 
 int32_t
 rte_service_init(void)
@@ -103,6 +144,11 @@ rte_service_init(void)
 	if (lcore_states == NULL)
 		RTE_LCORE_VAR_ALLOC(lcore_states);
 
+	sched_backoff_min = rte_get_tsc_hz() * SERVICE_SCHED_BACKOFF_MIN_US /
+		US_PER_S;
+	sched_backoff_max = rte_get_tsc_hz() * SERVICE_SCHED_BACKOFF_MAX_US /
+		US_PER_S;
+
 	int i;
 	struct rte_config *cfg = rte_eal_get_configuration();
 	for (i = 0; i < RTE_MAX_LCORE; i++) {
@@ -265,6 +311,8 @@ rte_service_component_register(const struct rte_service_spec *spec,
 	struct rte_service_spec_impl *s = &rte_services[free_slot];
 	s->spec = *spec;
 	s->internal_flags |= SERVICE_F_REGISTERED | SERVICE_F_START_CHECK;
+	rte_atomic_store_explicit(&s->weight, RTE_SERVICE_WEIGHT_DEFAULT,
+		rte_memory_order_relaxed);
 
 	rte_service_count++;
 
@@ -289,8 +337,13 @@ rte_service_component_unregister(uint32_t id)
 	unsigned int lcore_id;
 	struct core_state *cs;
 	/* clear the run-bit in all cores */
-	RTE_LCORE_VAR_FOREACH(lcore_id, cs, lcore_states)
+	RTE_LCORE_VAR_FOREACH(lcore_id, cs, lcore_states) {
 		rte_bitset_clear(cs->mapped_services, id);
+		memset(&cs->sched[id], 0, sizeof(cs->sched[id]));
+	}
+
+	rte_atomic_fetch_and_explicit(&steal_queue, ~(UINT64_C(1) << id),
+		rte_memory_order_relaxed);
 
 	memset(&rte_services[id], 0, sizeof(struct rte_service_spec_impl));
 
@@ -378,16 +431,17 @@ service_counter_add(RTE_ATOMIC(uint64_t) *counter, uint64_t operand)
 				  rte_memory_order_relaxed);
 }
 
-static inline void
+static inline int32_t
 service_runner_do_callback(struct rte_service_spec_impl *s,
 			   struct core_state *cs, uint32_t service_idx)
 {
 	rte_eal_trace_service_run_begin(service_idx, rte_lcore_id());
 	void *userdata = s->spec.callback_userdata;
+	int32_t rc;
 
 	if (service_stats_enabled(s)) {
 		uint64_t start = rte_rdtsc();
-		int rc = s->spec.callback(userdata);
+		rc = s->spec.callback(userdata);
 
 		struct service_stats *service_stats =
 			&cs->service_stats[service_idx];
@@ -407,16 +461,43 @@ service_runner_do_callback(struct rte_service_spec_impl *s,
 			service_counter_add(&service_stats->cycles, cycles);
 		}
 	} else {
-		s->spec.callback(userdata);
+		rc = s->spec.callback(userdata);
 	}
 	rte_eal_trace_service_run_end(service_idx, rte_lcore_id());
+
+	return rc;
 }
 
 
-/* Expects the service 's' is valid. */
+/* Add a busy MT safe service to the steal queue, remove an idle one. */
+static inline void
+service_steal_post(uint32_t id, int32_t rc)
+{
+	uint64_t bit = UINT64_C(1) << id;
+	uint64_t queue;
+
+	if (rte_atomic_load_explicit(&steal_lcores,
+			rte_memory_order_relaxed) == 0)
+		return;
+
+	/* avoid writing the shared queue when the state is unchanged */
+	queue = rte_atomic_load_explicit(&steal_queue, rte_memory_order_relaxed);
+	if (rc != -EAGAIN) {
+		if ((queue & bit) == 0)
+			rte_atomic_fetch_or_explicit(&steal_queue, bit,
+				rte_memory_order_relaxed);
+	} else if ((queue & bit) != 0)
+		rte_atomic_fetch_and_explicit(&steal_queue, ~bit,
+			rte_memory_order_relaxed);
+}
+
+/* Expects the service 's' is valid.
+ * The return value of the callback is stored in 'rc' if the service was run.
+ */
 static int32_t
 service_run(uint32_t i, struct core_state *cs, const uint64_t *mapped_services,
-	    struct rte_service_spec_impl *s, uint32_t serialize_mt_unsafe)
+	    struct rte_service_spec_impl *s, uint32_t serialize_mt_unsafe,
+	    int32_t *rc)
 {
 	if (!s)
 		return -EINVAL;
@@ -440,10 +521,13 @@ service_run(uint32_t i, struct core_state *cs, const uint64_t *mapped_services,
 		if (!rte_spinlock_trylock(&s->execute_lock))
 			return -EBUSY;
 
-		service_runner_do_callback(s, cs, i);
+		*rc = service_runner_do_callback(s, cs, i);
 		rte_spinlock_unlock(&s->execute_lock);
-	} else
-		service_runner_do_callback(s, cs, i);
+	} else {
+		*rc = service_runner_do_callback(s, cs, i);
+		if (service_mt_safe(s))
+			service_steal_post(i, *rc);
+	}
 
 	return 0;
 }
@@ -458,6 +542,11 @@ rte_service_may_be_active(uint32_t id)
 	if (!service_valid(id))
 		return -EINVAL;
 
+	/* pairs with the fence of a stolen run, between its active bit
+	 * and its runstate check
+	 */
+	rte_atomic_thread_fence(rte_memory_order_seq_cst);
+
 	for (i = 0; i < lcore_count; i++) {
 		struct core_state *cs =
 			RTE_LCORE_VAR_LCORE(ids[i], lcore_states);
@@ -484,13 +573,120 @@ rte_service_run_iter_on_app_lcore(uint32_t id, uint32_t serialize_mt_unsafe)
 
 	RTE_BITSET_DECLARE(all_services, RTE_SERVICE_NUM_MAX);
 	rte_bitset_set_all(all_services, RTE_SERVICE_NUM_MAX);
-	int ret = service_run(id, cs, all_services, s, serialize_mt_unsafe);
+	int32_t rc;
+	int ret = service_run(id, cs, all_services, s, serialize_mt_unsafe, &rc);
 
 	rte_atomic_fetch_sub_explicit(&s->num_mapped_cores, 1, rte_memory_order_relaxed);
 
 	return ret;
 }
 
+/* Run the mapped services for their budget of cycles, skipping the idle
+ * services until their backoff delay expires.
+ * Returns true if a service did some work.
+ */
+static bool
+service_runner_sched(struct core_state *cs)
+{
+	uint64_t now = rte_rdtsc();
+	bool busy = false;
+	ssize_t id;
+
+	RTE_BITSET_FOREACH_SET(id, cs->mapped_services, RTE_SERVICE_NUM_MAX) {
+		struct rte_service_spec_impl *s = service_get(id);
+		struct service_sched *ss = &cs->sched[id];
+		int64_t quantum;
+
+		if (ss->backoff != 0 && (int64_t)(ss->next_tsc - now) > 0)
+			continue;
+
+		quantum = (int64_t)rte_atomic_load_explicit(&s->weight,
+			rte_memory_order_relaxed) * SERVICE_SCHED_QUANTUM;
+		/* unused credit is not carried over, overruns are */
+		ss->credit = RTE_MIN(ss->credit + quantum, quantum);
+		if (ss->credit <= 0)
+			continue;
+
+		do {
+			uint64_t start = now;
+			int32_t rc;
+
+			if (service_run(id, cs, cs->mapped_services, s, 1,
+					&rc) != 0) {
+				ss->credit = 0;
+				break;
+			}
+
+			now = rte_rdtsc();
+			ss->credit -= now - start;
+
+			if (rc == -EAGAIN) {
+				ss->backoff = RTE_MIN(ss->backoff * 2,
+					sched_backoff_max);
+				if (ss->backoff == 0)
+					ss->backoff = sched_backoff_min;
+				ss->next_tsc = now + ss->backoff;
+				ss->credit = 0;
+				break;
+			}
+
+			ss->backoff = 0;
+			busy = true;
+			service_counter_add(&ss->busy_cycles, now - start);
+		} while (ss->credit > 0);
+	}
+
+	return busy;
+}
+
+/* Run one iteration of a service of the steal queue not mapped to this core.
+ * The queued services are picked in turn.
+ */
+static void
+service_runner_steal(struct core_state *cs)
+{
+	RTE_BITSET_DECLARE(stolen, RTE_SERVICE_NUM_MAX);
+	uint64_t queue, high;
+	uint32_t id;
+	int32_t rc;
+
+	RTE_BUILD_BUG_ON(RTE_SERVICE_NUM_MAX != 64);
+
+	queue = rte_atomic_load_explicit(&steal_queue,
+		rte_memory_order_relaxed);
+	queue &= ~cs->mapped_services[0];
+	if (queue == 0)
+		return;
+
+	high = queue & (UINT64_MAX << cs->steal_next);
+	id = rte_ctz64(high != 0 ? high : queue);
+	cs->steal_next = (id + 1) % RTE_SERVICE_NUM_MAX;
+
+	/* only steal from the services still run by a service core */
+	if (rte_atomic_load_explicit(&rte_services[id].num_mapped_cores,
+			rte_memory_order_relaxed) == 0) {
+		rte_atomic_fetch_and_explicit(&steal_queue,
+			~(UINT64_C(1) << id), rte_memory_order_relaxed);
+		return;
+	}
+
+	/* The service is not mapped, so it is inactive between the steals.
+	 * Mark it active before service_run() checks its runstate, for
+	 * rte_service_may_be_active() not to miss a call about to be made.
+	 */
+	rte_bitset_atomic_set(cs->service_active_on_lcore, id,
+		rte_memory_order_relaxed);
+	rte_atomic_thread_fence(rte_memory_order_seq_cst);
+
+	rte_bitset_init(stolen, RTE_SERVICE_NUM_MAX);
+	rte_bitset_set(stolen, id);
+	if (service_run(id, cs, stolen, service_get(id), 1, &rc) == 0)
+		service_counter_add(&cs->service_stats[id].stolen_calls, 1);
+
+	rte_bitset_atomic_clear(cs->service_active_on_lcore, id,
+		rte_memory_order_release);
+}
+
 static int32_t
 service_runner_func(void *arg)
 {
@@ -505,13 +701,28 @@ service_runner_func(void *arg)
 	 */
 	while (rte_atomic_load_explicit(&cs->runstate, rte_memory_order_acquire) ==
 			RUNSTATE_RUNNING) {
+		bool busy = false;
 		ssize_t id;
-
-		RTE_BITSET_FOREACH_SET(id, cs->mapped_services, RTE_SERVICE_NUM_MAX) {
-			/* return value ignored as no change to code flow */
-			service_run(id, cs, cs->mapped_services, service_get(id), 1);
+		int32_t rc;
+
+		if (rte_atomic_load_explicit(&cs->sched_mode,
+				rte_memory_order_relaxed) ==
+				RTE_SERVICE_LCORE_SCHED_ADAPTIVE)
+			busy = service_runner_sched(cs);
+		else {
+			RTE_BITSET_FOREACH_SET(id, cs->mapped_services,
+					RTE_SERVICE_NUM_MAX) {
+				if (service_run(id, cs, cs->mapped_services,
+						service_get(id), 1, &rc) == 0 &&
+						rc != -EAGAIN)
+					busy = true;
+			}
 		}
 
+		if (!busy && rte_atomic_load_explicit(&cs->steal,
+				rte_memory_order_relaxed))
+			service_runner_steal(cs);
+
 		rte_atomic_store_explicit(&cs->loops, cs->loops + 1, rte_memory_order_relaxed);
 	}
 
@@ -684,6 +895,21 @@ rte_service_map_lcore_get(uint32_t id, uint32_t lcore)
 	return ret;
 }
 
+static void
+set_lcore_steal(struct core_state *cs, uint8_t steal)
+{
+	if (rte_atomic_exchange_explicit(&cs->steal, steal,
+			rte_memory_order_relaxed) == steal)
+		return;
+
+	if (steal)
+		rte_atomic_fetch_add_explicit(&steal_lcores, 1,
+			rte_memory_order_relaxed);
+	else
+		rte_atomic_fetch_sub_explicit(&steal_lcores, 1,
+			rte_memory_order_relaxed);
+}
+
 static void
 set_lcore_state(uint32_t lcore, int32_t state)
 {
@@ -711,6 +937,9 @@ rte_service_lcore_reset_all(void)
 
 		if (cs->is_service_core) {
 			rte_bitset_clear_all(cs->mapped_services, RTE_SERVICE_NUM_MAX);
+			rte_atomic_store_explicit(&cs->sched_mode,
+				RTE_SERVICE_LCORE_SCHED_RR, rte_memory_order_relaxed);
+			set_lcore_steal(cs, 0);
 			set_lcore_state(i, ROLE_RTE);
 			/* runstate act as guard variable Use
 			 * store-release memory order here to synchronize
@@ -741,6 +970,9 @@ rte_service_lcore_add(uint32_t lcore)
 
 	/* ensure that after adding a core the mask and state are defaults */
 	rte_bitset_clear_all(cs->mapped_services, RTE_SERVICE_NUM_MAX);
+	rte_atomic_store_explicit(&cs->sched_mode, RTE_SERVICE_LCORE_SCHED_RR,
+		rte_memory_order_relaxed);
+	set_lcore_steal(cs, 0);
 	/* Use store-release memory order here to synchronize with
 	 * load-acquire in runstate read functions.
 	 */
@@ -768,6 +1000,7 @@ rte_service_lcore_del(uint32_t lcore)
 			RUNSTATE_STOPPED)
 		return -EBUSY;
 
+	set_lcore_steal(cs, 0);
 	set_lcore_state(lcore, ROLE_RTE);
 
 	rte_smp_wmb();
@@ -851,6 +1084,192 @@ rte_service_lcore_stop(uint32_t lcore)
 	return 0;
 }
 
+int32_t
+rte_service_lcore_sched_set(uint32_t lcore, uint32_t mode)
+{
+	struct core_state *cs;
+
+	if (lcore >= RTE_MAX_LCORE || mode > RTE_SERVICE_LCORE_SCHED_ADAPTIVE)
+		return -EINVAL;
+
+	cs = RTE_LCORE_VAR_LCORE(lcore, lcore_states);
+	if (!cs->is_service_core)
+		return -ENOTSUP;
+
+	rte_atomic_store_explicit(&cs->sched_mode, mode,
+		rte_memory_order_relaxed);
+
+	return 0;
+}
+
+int32_t
+rte_service_lcore_sched_get(uint32_t lcore)
+{
+	struct core_state *cs;
+
+	if (lcore >= RTE_MAX_LCORE)
+		return -EINVAL;
+
+	cs = RTE_LCORE_VAR_LCORE(lcore, lcore_states);
+	if (!cs->is_service_core)
+		return -ENOTSUP;
+
+	return rte_atomic_load_explicit(&cs->sched_mode,
+		rte_memory_order_relaxed);
+}
+
+int32_t
+rte_service_lcore_steal_set(uint32_t lcore, uint32_t enable)
+{
+	struct core_state *cs;
+
+	if (lcore >= RTE_MAX_LCORE)
+		return -EINVAL;
+
+	cs = RTE_LCORE_VAR_LCORE(lcore, lcore_states);
+	if (!cs->is_service_core)
+		return -ENOTSUP;
+
+	set_lcore_steal(cs, enable > 0);
+
+	return 0;
+}
+
+int32_t
+rte_service_lcore_steal_get(uint32_t lcore)
+{
+	struct core_state *cs;
+
+	if (lcore >= RTE_MAX_LCORE)
+		return -EINVAL;
+
+	cs = RTE_LCORE_VAR_LCORE(lcore, lcore_states);
+	if (!cs->is_service_core)
+		return -ENOTSUP;
+
+	return rte_atomic_load_explicit(&cs->steal, rte_memory_order_relaxed);
+}
+
+int32_t
+rte_service_weight_set(uint32_t id, uint32_t weight)
+{
+	struct rte_service_spec_impl *s;
+	SERVICE_VALID_GET_OR_ERR_RET(id, s, -EINVAL);
+
+	if (weight == 0 || weight > RTE_SERVICE_WEIGHT_MAX)
+		return -EINVAL;
+
+	rte_atomic_store_explicit(&s->weight, weight, rte_memory_order_relaxed);
+
+	return 0;
+}
+
+int32_t
+rte_service_weight_get(uint32_t id)
+{
+	struct rte_service_spec_impl *s;
+	SERVICE_VALID_GET_OR_ERR_RET(id, s, -EINVAL);
+
+	return rte_atomic_load_explicit(&s->weight, rte_memory_order_relaxed);
+}
+
+int32_t
+rte_service_lcore_rebalance(void)
+{
+	uint32_t lcores[RTE_MAX_LCORE];
+	uint64_t cur_load[RTE_MAX_LCORE], new_load[RTE_MAX_LCORE];
+	uint64_t load[RTE_SERVICE_NUM_MAX];
+	int32_t owner[RTE_SERVICE_NUM_MAX], target[RTE_SERVICE_NUM_MAX];
+	uint32_t order[RTE_SERVICE_NUM_MAX];
+	uint64_t cur_max = 0, new_max = 0;
+	uint32_t i, j, id, nb_lcores = 0, nb_order = 0;
+	int32_t moved = 0;
+
+	for (i = 0; i < RTE_MAX_LCORE; i++) {
+		struct core_state *cs = RTE_LCORE_VAR_LCORE(i, lcore_states);
+
+		if (cs->is_service_core &&
+				rte_atomic_load_explicit(&cs->runstate,
+					rte_memory_order_acquire) ==
+					RUNSTATE_RUNNING &&
+				rte_atomic_load_explicit(&cs->sched_mode,
+					rte_memory_order_relaxed) ==
+					RTE_SERVICE_LCORE_SCHED_ADAPTIVE)
+			lcores[nb_lcores++] = i;
+	}
+
+	/* load of the services since the last call, per service core */
+	for (j = 0; j < nb_lcores; j++) {
+		struct core_state *cs = RTE_LCORE_VAR_LCORE(lcores[j],
+			lcore_states);
+
+		new_load[j] = 0;
+		cur_load[j] = 0;
+		for (id = 0; id < RTE_SERVICE_NUM_MAX; id++) {
+			struct service_sched *ss = &cs->sched[id];
+			uint64_t busy = rte_atomic_load_explicit(
+				&ss->busy_cycles, rte_memory_order_relaxed);
+			uint64_t delta = busy - ss->busy_cycles_last;
+
+			ss->busy_cycles_last = busy;
+			if (!rte_bitset_test(cs->mapped_services, id))
+				continue;
+			cur_load[j] += delta;
+			if (rte_atomic_load_explicit(
+					&rte_services[id].num_mapped_cores,
+					rte_memory_order_relaxed) == 1) {
+				/* movable service */
+				owner[id] = j;
+				load[id] = delta;
+				order[nb_order++] = id;
+			} else
+				new_load[j] += delta;
+		}
+		cur_max = RTE_MAX(cur_max, cur_load[j]);
+	}
+
+	if (nb_lcores < 2 || nb_order == 0)
+		return 0;
+
+	/* sort the movable services by decreasing load */
+	for (i = 1; i < nb_order; i++) {
+		id = order[i];
+		for (j = i; j > 0 && load[order[j - 1]] < load[id]; j--)
+			order[j] = order[j - 1];
+		order[j] = id;
+	}
+
+	/* give every service to the least loaded core, preferring its own */
+	for (i = 0; i < nb_order; i++) {
+		int32_t best;
+
+		id = order[i];
+		best = owner[id];
+		for (j = 0; j < nb_lcores; j++)
+			if (new_load[j] < new_load[best])
+				best = j;
+		target[id] = best;
+		new_load[best] += load[id];
+	}
+
+	for (j = 0; j < nb_lcores; j++)
+		new_max = RTE_MAX(new_max, new_load[j]);
+
+	if (new_max + cur_max / 8 >= cur_max)
+		return 0;
+
+	for (i = 0; i < nb_order; i++) {
+		id = order[i];
+		if (target[id] == owner[id])
+			continue;
+		rte_service_map_lcore_set(id, lcores[target[id]], 1);
+		rte_service_map_lcore_set(id, lcores[owner[id]], 0);
+		moved++;
+	}
+
+	return moved;
+}
+
 static uint64_t
 lcore_attr_get_loops(unsigned int lcore)
 {
@@ -879,7 +1298,7 @@ lcore_attr_get_service_calls(uint32_t service_id, unsigned int lcore)
 static uint64_t
 lcore_attr_get_service_idle_calls(uint32_t service_id, unsigned int lcore)
 {
-	struct core_state *cs = &lcore_states[lcore];
+	struct core_state *cs =	RTE_LCORE_VAR_LCORE(lcore, lcore_states);
 
 	return rte_atomic_load_explicit(&cs->service_stats[service_id].idle_calls,
 		rte_memory_order_relaxed);
@@ -888,7 +1307,7 @@ lcore_attr_get_service_idle_calls(uint32_t service_id, unsigned int lcore)
 static uint64_t
 lcore_attr_get_service_error_calls(uint32_t service_id, unsigned int lcore)
 {
-	struct core_state *cs = &lcore_states[lcore];
+	struct core_state *cs =	RTE_LCORE_VAR_LCORE(lcore, lcore_states);
 
 	return rte_atomic_load_explicit(&cs->service_stats[service_id].error_calls,
 		rte_memory_order_relaxed);
@@ -903,6 +1322,15 @@ lcore_attr_get_service_cycles(uint32_t service_id, unsigned int lcore)
 		rte_memory_order_relaxed);
 }
 
+static uint64_t
+lcore_attr_get_service_stolen_calls(uint32_t service_id, unsigned int lcore)
+{
+	struct core_state *cs =	RTE_LCORE_VAR_LCORE(lcore, lcore_states);
+
+	return rte_atomic_load_explicit(&cs->service_stats[service_id].stolen_calls,
+		rte_memory_order_relaxed);
+}
+
 typedef uint64_t (*lcore_attr_get_fun)(uint32_t service_id,
 				       unsigned int lcore);
 
@@ -947,6 +1375,12 @@ attr_get_service_cycles(uint32_t service_id)
 	return attr_get(service_id, lcore_attr_get_service_cycles);
 }
 
+static uint64_t
+attr_get_service_stolen_calls(uint32_t service_id)
+{
+	return attr_get(service_id, lcore_attr_get_service_stolen_calls);
+}
+
 int32_t
 rte_service_attr_get(uint32_t id, uint32_t attr_id, uint64_t *attr_value)
 {
@@ -969,6 +1403,9 @@ rte_service_attr_get(uint32_t id, uint32_t attr_id, uint64_t *attr_value)
 	case RTE_SERVICE_ATTR_CYCLES:
 		*attr_value = attr_get_service_cycles(id);
 		return 0;
+	case RTE_SERVICE_ATTR_STOLEN_CALL_COUNT:
+		*attr_value = attr_get_service_stolen_calls(id);
+		return 0;
 	default:
 		return -EINVAL;
 	}
@@ -1102,3 +1539,73 @@ rte_service_dump(FILE *f, uint32_t id)
 
 	return 0;
 }
+
+#ifndef RTE_EXEC_ENV_WINDOWS
+static int
+handle_service_list(const char *cmd __rte_unused,
+		const char *params __rte_unused, struct rte_tel_data *d)
+{
+	uint32_t i;
+
+	if (!rte_service_library_initialized)
+		return -ENOTSUP;
+
+	rte_tel_data_start_array(d, RTE_TEL_INT_VAL);
+	for (i = 0; i < RTE_SERVICE_NUM_MAX; i++) {
+		if (service_registered(i))
+			rte_tel_data_add_array_int(d, i);
+	}
+
+	return 0;
+}
+
+static int
+handle_service_info(const char *cmd __rte_unused, const char *params,
+		struct rte_tel_data *d)
+{
+	struct rte_service_spec_impl *s;
+	unsigned long id;
+	char *endptr;
+
+	if (!rte_service_library_initialized)
+		return -ENOTSUP;
+	if (params == NULL)
+		return -EINVAL;
+	errno = 0;
+	id = strtoul(params, &endptr, 10);
+	if (errno)
+		return -errno;
+	if (*params == '\0' || *endptr != '\0' || !service_valid(id))
+		return -EINVAL;
+
+	s = service_get(id);
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_int(d, "id", id);
+	rte_tel_data_add_dict_string(d, "name", s->spec.name);
+	rte_tel_data_add_dict_int(d, "mt_safe", service_mt_safe(s));
+	rte_tel_data_add_dict_int(d, "stats_enabled", service_stats_enabled(s));
+	rte_tel_data_add_dict_uint(d, "weight",
+		rte_atomic_load_explicit(&s->weight, rte_memory_order_relaxed));
+	rte_tel_data_add_dict_uint(d, "mapped_cores",
+		rte_atomic_load_explicit(&s->num_mapped_cores,
+			rte_memory_order_relaxed));
+	rte_tel_data_add_dict_uint(d, "calls", attr_get_service_calls(id));
+	rte_tel_data_add_dict_uint(d, "idle_calls",
+		attr_get_service_idle_calls(id));
+	rte_tel_data_add_dict_uint(d, "error_calls",
+		attr_get_service_error_calls(id));
+	rte_tel_data_add_dict_uint(d, "cycles", attr_get_service_cycles(id));
+	rte_tel_data_add_dict_uint(d, "stolen_calls",
+		attr_get_service_stolen_calls(id));
+
+	return 0;
+}
+
+RTE_INIT(service_telemetry)
+{
+	rte_telemetry_register_cmd("/eal/service/list", handle_service_list,
+		"List of service ids. Takes no parameters");
+	rte_telemetry_register_cmd("/eal/service/info", handle_service_info,
+		"Returns service info and statistics. Parameters: int service_id");
+}
+#endif /* !RTE_EXEC_ENV_WINDOWS */
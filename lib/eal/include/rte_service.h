@@ -26,6 +26,7 @@
 #include<stdio.h>
 #include <stdint.h>
 
+#include <rte_compat.h>
 #include <rte_config.h>
 #include <rte_lcore.h>
 
@@ -400,6 +401,14 @@ int32_t rte_service_dump(FILE *f, uint32_t id);
  */
 #define RTE_SERVICE_ATTR_ERROR_CALL_COUNT 3
 
+/**
+ * Returns the number of invocations of this service function by service
+ * cores it is not mapped to, stealing work of a busy multi-thread safe
+ * service (see rte_service_lcore_steal_set()).
+ * Counted even if the statistics of the service are not enabled.
+ */
+#define RTE_SERVICE_ATTR_STOLEN_CALL_COUNT 4
+
 /**
  * Get an attribute from a service.
  *
@@ -455,6 +464,170 @@ rte_service_lcore_attr_get(uint32_t lcore, uint32_t attr_id,
 int32_t
 rte_service_lcore_attr_reset_all(uint32_t lcore);
 
+/**
+ * Default scheduling of a service core: every mapped service is called
+ * once per loop of the service core.
+ */
+#define RTE_SERVICE_LCORE_SCHED_RR 0
+
+/**
+ * Adaptive scheduling of a service core: the busy services share the time
+ * of the service core in proportion of their weight, set with
+ * rte_service_weight_set(), and the services reporting to be idle
+ * (i.e., returning -EAGAIN) are called less and less often.
+ */
+#define RTE_SERVICE_LCORE_SCHED_ADAPTIVE 1
+
+/** Default weight of a service. */
+#define RTE_SERVICE_WEIGHT_DEFAULT 100
+
+/** Maximum weight of a service. */
+#define RTE_SERVICE_WEIGHT_MAX 10000
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Set the scheduling mode of a service core.
+ *
+ * With RTE_SERVICE_LCORE_SCHED_ADAPTIVE, every loop of the service core
+ * grants each mapped service a budget of cycles proportional to its weight.
+ * A service is called again and again until its budget is spent,
+ * so that a service given a weight of 70 runs 70% of the time
+ * when sharing a busy core with a service of weight 30.
+ * A service returning -EAGAIN ends its turn and is not called again
+ * for a delay doubling after every idle call, from 1 to 128 microseconds,
+ * and reset by the first non-idle call.
+ *
+ * The mode can be changed while the service core is running.
+ *
+ * @param lcore
+ *   The service core to configure.
+ * @param mode
+ *   RTE_SERVICE_LCORE_SCHED_RR or RTE_SERVICE_LCORE_SCHED_ADAPTIVE.
+ * @retval 0 Success
+ * @retval -EINVAL Invalid lcore or mode.
+ * @retval -ENOTSUP lcore is not a service core.
+ */
+__rte_experimental
+int32_t rte_service_lcore_sched_set(uint32_t lcore, uint32_t mode);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the scheduling mode of a service core.
+ *
+ * @param lcore
+ *   The service core.
+ * @retval >=0 The scheduling mode, RTE_SERVICE_LCORE_SCHED_*.
+ * @retval -EINVAL Invalid lcore.
+ * @retval -ENOTSUP lcore is not a service core.
+ */
+__rte_experimental
+int32_t rte_service_lcore_sched_get(uint32_t lcore);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enable or disable work stealing on a service core.
+ *
+ * A multi-thread safe service (RTE_SERVICE_CAP_MT_SAFE) that did some work
+ * on its last call, i.e. did not return -EAGAIN, is added to a run queue
+ * shared by the service cores, and removed when a call returns -EAGAIN.
+ * When none of its mapped services did any work in a loop,
+ * a service core with stealing enabled runs one iteration of the next
+ * service of the run queue which is mapped to another service core.
+ * The stolen iterations are counted in RTE_SERVICE_ATTR_STOLEN_CALL_COUNT.
+ *
+ * Services which are not multi-thread safe are never stolen.
+ *
+ * @param lcore
+ *   The service core to configure.
+ * @param enable
+ *   Non-zero to enable stealing, zero to disable it.
+ * @retval 0 Success
+ * @retval -EINVAL Invalid lcore.
+ * @retval -ENOTSUP lcore is not a service core.
+ */
+__rte_experimental
+int32_t rte_service_lcore_steal_set(uint32_t lcore, uint32_t enable);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Check if work stealing is enabled on a service core.
+ *
+ * @param lcore
+ *   The service core.
+ * @retval 1 Stealing is enabled.
+ * @retval 0 Stealing is disabled.
+ * @retval -EINVAL Invalid lcore.
+ * @retval -ENOTSUP lcore is not a service core.
+ */
+__rte_experimental
+int32_t rte_service_lcore_steal_get(uint32_t lcore);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Set the weight of a service, used by the service cores
+ * in RTE_SERVICE_LCORE_SCHED_ADAPTIVE mode.
+ *
+ * @param id
+ *   The service to configure.
+ * @param weight
+ *   The weight, from 1 to RTE_SERVICE_WEIGHT_MAX.
+ *   Services are registered with RTE_SERVICE_WEIGHT_DEFAULT.
+ * @retval 0 Success
+ * @retval -EINVAL Invalid service id or weight.
+ */
+__rte_experimental
+int32_t rte_service_weight_set(uint32_t id, uint32_t weight);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the weight of a service.
+ *
+ * @param id
+ *   The service.
+ * @retval >0 The weight of the service.
+ * @retval -EINVAL Invalid service id.
+ */
+__rte_experimental
+int32_t rte_service_weight_get(uint32_t id);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Balance the services between the running service cores
+ * in RTE_SERVICE_LCORE_SCHED_ADAPTIVE mode.
+ *
+ * The load of every service is the number of cycles spent in its
+ * non-idle calls since the previous call of this function.
+ * The services mapped to a single one of these service cores
+ * are moved to even out the load of the service cores,
+ * if this lowers the load of the busiest one by more than 1/8.
+ * A service is mapped to its new service core before being unmapped
+ * from the previous one, multi-thread unsafe services are still
+ * never run concurrently.
+ *
+ * This function is meant to be called periodically by the application,
+ * it must not be called concurrently with the other functions
+ * changing the service mappings.
+ *
+ * @return
+ *   The number of services moved to another service core.
+ */
+__rte_experimental
+int32_t rte_service_lcore_rebalance(void);
+
 #ifdef __cplusplus
 }
 #endif
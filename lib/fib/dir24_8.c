@@ -5,6 +5,7 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include <rte_debug.h>
 #include <rte_malloc.h>
@@ -126,6 +127,92 @@ dir24_8_get_lookup_fn(void *p, enum rte_fib_lookup_type type, bool be_addr)
 	return NULL;
 }
 
+static inline rte_fib_vrf_lookup_fn_t
+get_vrf_scalar_fn(enum rte_fib_dir24_8_nh_sz nh_sz, bool be_addr)
+{
+	switch (nh_sz) {
+	case RTE_FIB_DIR24_8_1B:
+		return be_addr ? dir24_8_vrf_lookup_bulk_1b_be :
+			dir24_8_vrf_lookup_bulk_1b;
+	case RTE_FIB_DIR24_8_2B:
+		return be_addr ? dir24_8_vrf_lookup_bulk_2b_be :
+			dir24_8_vrf_lookup_bulk_2b;
+	case RTE_FIB_DIR24_8_4B:
+		return be_addr ? dir24_8_vrf_lookup_bulk_4b_be :
+			dir24_8_vrf_lookup_bulk_4b;
+	case RTE_FIB_DIR24_8_8B:
+		return be_addr ? dir24_8_vrf_lookup_bulk_8b_be :
+			dir24_8_vrf_lookup_bulk_8b;
+	default:
+		return NULL;
+	}
+}
+
+static inline rte_fib_vrf_lookup_fn_t
+get_vrf_vector_fn(enum rte_fib_dir24_8_nh_sz nh_sz, bool be_addr)
+{
+#ifdef CC_DIR24_8_AVX512_SUPPORT
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) <= 0 ||
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512DQ) <= 0 ||
+			rte_vect_get_max_simd_bitwidth() < RTE_VECT_SIMD_512)
+		return NULL;
+
+	if (be_addr && rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW) <= 0)
+		return NULL;
+
+	switch (nh_sz) {
+	case RTE_FIB_DIR24_8_1B:
+		return be_addr ? rte_dir24_8_vec_vrf_lookup_bulk_1b_be :
+			rte_dir24_8_vec_vrf_lookup_bulk_1b;
+	case RTE_FIB_DIR24_8_2B:
+		return be_addr ? rte_dir24_8_vec_vrf_lookup_bulk_2b_be :
+			rte_dir24_8_vec_vrf_lookup_bulk_2b;
+	case RTE_FIB_DIR24_8_4B:
+		return be_addr ? rte_dir24_8_vec_vrf_lookup_bulk_4b_be :
+			rte_dir24_8_vec_vrf_lookup_bulk_4b;
+	case RTE_FIB_DIR24_8_8B:
+		return be_addr ? rte_dir24_8_vec_vrf_lookup_bulk_8b_be :
+			rte_dir24_8_vec_vrf_lookup_bulk_8b;
+	default:
+		return NULL;
+	}
+#else
+	RTE_SET_USED(nh_sz);
+	RTE_SET_USED(be_addr);
+#endif
+	return NULL;
+}
+
+rte_fib_vrf_lookup_fn_t
+dir24_8_get_vrf_lookup_fn(void *p, enum rte_fib_lookup_type type,
+	bool be_addr)
+{
+	enum rte_fib_dir24_8_nh_sz nh_sz;
+	rte_fib_vrf_lookup_fn_t ret_fn;
+	struct dir24_8_tbl *dp = p;
+
+	if (dp == NULL)
+		return NULL;
+
+	nh_sz = dp->nh_sz;
+
+	switch (type) {
+	case RTE_FIB_LOOKUP_DIR24_8_SCALAR_MACRO:
+	case RTE_FIB_LOOKUP_DIR24_8_SCALAR_INLINE:
+	case RTE_FIB_LOOKUP_DIR24_8_SCALAR_UNI:
+		return get_vrf_scalar_fn(nh_sz, be_addr);
+	case RTE_FIB_LOOKUP_DIR24_8_VECTOR_AVX512:
+		return get_vrf_vector_fn(nh_sz, be_addr);
+	case RTE_FIB_LOOKUP_DEFAULT:
+		ret_fn = get_vrf_vector_fn(nh_sz, be_addr);
+		return ret_fn != NULL ? ret_fn : get_vrf_scalar_fn(nh_sz, be_addr);
+	default:
+		return NULL;
+	}
+
+	return NULL;
+}
+
 static void
 write_to_fib(void *ptr, uint64_t val, enum rte_fib_dir24_8_nh_sz size, int n)
 {
@@ -179,6 +266,34 @@ tbl8_free_idx(struct dir24_8_tbl *dp, int idx)
 		~(1ULL << (idx & BITMAP_SLAB_BITMASK));
 }
 
+static void
+tbl8_cleanup_and_free(struct dir24_8_tbl *dp, uint64_t tbl8_idx)
+{
+	uint8_t *ptr = (uint8_t *)dp->tbl8 + (tbl8_idx * DIR24_8_TBL8_GRP_NUM_ENT << dp->nh_sz);
+
+	memset(ptr, 0, DIR24_8_TBL8_GRP_NUM_ENT << dp->nh_sz);
+	tbl8_free_idx(dp, tbl8_idx);
+	dp->cur_tbl8s--;
+}
+
+/*
+ * Release the tbl8 groups unlinked during a bulk update
+ * after a single grace period.
+ */
+static void
+tbl8_pend_flush(struct dir24_8_tbl *dp)
+{
+	uint32_t i;
+
+	if (dp->nb_tbl8_pend == 0)
+		return;
+
+	rte_rcu_qsbr_synchronize(dp->v, RTE_QSBR_THRID_INVALID);
+	for (i = 0; i < dp->nb_tbl8_pend; i++)
+		tbl8_cleanup_and_free(dp, dp->tbl8_pend[i]);
+	dp->nb_tbl8_pend = 0;
+}
+
 static int
 tbl8_alloc(struct dir24_8_tbl *dp, uint64_t nh)
 {
@@ -192,6 +307,12 @@ tbl8_alloc(struct dir24_8_tbl *dp, uint64_t nh)
 			!rte_rcu_qsbr_dq_reclaim(dp->dq, 1, NULL, NULL, NULL)))
 		tbl8_idx = tbl8_get_idx(dp);
 
+	/* Or wait for the ones released by the current bulk update. */
+	if (unlikely(tbl8_idx == -ENOSPC && dp->nb_tbl8_pend != 0)) {
+		tbl8_pend_flush(dp);
+		tbl8_idx = tbl8_get_idx(dp);
+	}
+
 	if (tbl8_idx < 0)
 		return tbl8_idx;
 	tbl8_ptr = (uint8_t *)dp->tbl8 +
@@ -205,16 +326,6 @@ tbl8_alloc(struct dir24_8_tbl *dp, uint64_t nh)
 	return tbl8_idx;
 }
 
-static void
-tbl8_cleanup_and_free(struct dir24_8_tbl *dp, uint64_t tbl8_idx)
-{
-	uint8_t *ptr = (uint8_t *)dp->tbl8 + (tbl8_idx * DIR24_8_TBL8_GRP_NUM_ENT << dp->nh_sz);
-
-	memset(ptr, 0, DIR24_8_TBL8_GRP_NUM_ENT << dp->nh_sz);
-	tbl8_free_idx(dp, tbl8_idx);
-	dp->cur_tbl8s--;
-}
-
 static void
 __rcu_qsbr_free_resource(void *p, void *data, unsigned int n __rte_unused)
 {
@@ -224,9 +335,30 @@ __rcu_qsbr_free_resource(void *p, void *data, unsigned int n __rte_unused)
 	tbl8_cleanup_and_free(dp, tbl8_idx);
 }
 
+/* Release a tbl8 group that is no longer referenced by tbl24. */
 static void
-tbl8_recycle(struct dir24_8_tbl *dp, uint32_t ip, uint64_t tbl8_idx)
+tbl8_free(struct dir24_8_tbl *dp, uint64_t tbl8_idx)
 {
+	if (dp->v == NULL) {
+		tbl8_cleanup_and_free(dp, tbl8_idx);
+	} else if (dp->rcu_mode == RTE_FIB_QSBR_MODE_SYNC) {
+		if (dp->tbl8_pend != NULL) {
+			dp->tbl8_pend[dp->nb_tbl8_pend++] = tbl8_idx;
+			return;
+		}
+		rte_rcu_qsbr_synchronize(dp->v, RTE_QSBR_THRID_INVALID);
+		tbl8_cleanup_and_free(dp, tbl8_idx);
+	} else { /* RTE_FIB_QSBR_MODE_DQ */
+		if (rte_rcu_qsbr_dq_enqueue(dp->dq, &tbl8_idx))
+			FIB_LOG(ERR, "Failed to push QSBR FIFO");
+	}
+}
+
+static void
+tbl8_recycle(struct dir24_8_tbl *dp, uint16_t vrf_id, uint32_t ip,
+	uint64_t tbl8_idx)
+{
+	uint64_t tbl24_idx = get_vrf_tbl24_idx(vrf_id, ip);
 	uint32_t i;
 	uint64_t nh;
 	uint8_t *ptr8;
@@ -243,7 +375,7 @@ tbl8_recycle(struct dir24_8_tbl *dp, uint32_t ip, uint64_t tbl8_idx)
 			if (nh != ptr8[i])
 				return;
 		}
-		((uint8_t *)dp->tbl24)[ip >> 8] =
+		((uint8_t *)dp->tbl24)[tbl24_idx] =
 			nh & ~DIR24_8_EXT_ENT;
 		break;
 	case RTE_FIB_DIR24_8_2B:
@@ -254,7 +386,7 @@ tbl8_recycle(struct dir24_8_tbl *dp, uint32_t ip, uint64_t tbl8_idx)
 			if (nh != ptr16[i])
 				return;
 		}
-		((uint16_t *)dp->tbl24)[ip >> 8] =
+		((uint16_t *)dp->tbl24)[tbl24_idx] =
 			nh & ~DIR24_8_EXT_ENT;
 		break;
 	case RTE_FIB_DIR24_8_4B:
@@ -265,7 +397,7 @@ tbl8_recycle(struct dir24_8_tbl *dp, uint32_t ip, uint64_t tbl8_idx)
 			if (nh != ptr32[i])
 				return;
 		}
-		((uint32_t *)dp->tbl24)[ip >> 8] =
+		((uint32_t *)dp->tbl24)[tbl24_idx] =
 			nh & ~DIR24_8_EXT_ENT;
 		break;
 	case RTE_FIB_DIR24_8_8B:
@@ -276,25 +408,17 @@ tbl8_recycle(struct dir24_8_tbl *dp, uint32_t ip, uint64_t tbl8_idx)
 			if (nh != ptr64[i])
 				return;
 		}
-		((uint64_t *)dp->tbl24)[ip >> 8] =
+		((uint64_t *)dp->tbl24)[tbl24_idx] =
 			nh & ~DIR24_8_EXT_ENT;
 		break;
 	}
 
-	if (dp->v == NULL) {
-		tbl8_cleanup_and_free(dp, tbl8_idx);
-	} else if (dp->rcu_mode == RTE_FIB_QSBR_MODE_SYNC) {
-		rte_rcu_qsbr_synchronize(dp->v, RTE_QSBR_THRID_INVALID);
-		tbl8_cleanup_and_free(dp, tbl8_idx);
-	} else { /* RTE_FIB_QSBR_MODE_DQ */
-		if (rte_rcu_qsbr_dq_enqueue(dp->dq, &tbl8_idx))
-			FIB_LOG(ERR, "Failed to push QSBR FIFO");
-	}
+	tbl8_free(dp, tbl8_idx);
 }
 
 static int
-install_to_fib(struct dir24_8_tbl *dp, uint32_t ledge, uint32_t redge,
-	uint64_t next_hop)
+install_to_fib(struct dir24_8_tbl *dp, uint16_t vrf_id, uint32_t ledge,
+	uint32_t redge, uint64_t next_hop)
 {
 	uint64_t	tbl24_tmp;
 	int	tbl8_idx;
@@ -307,7 +431,7 @@ install_to_fib(struct dir24_8_tbl *dp, uint32_t ledge, uint32_t redge,
 
 	if (((ledge >> 8) != (redge >> 8)) || (len == 1 << 24)) {
 		if ((ROUNDUP(ledge, 24) - ledge) != 0) {
-			tbl24_tmp = get_tbl24(dp, ledge, dp->nh_sz);
+			tbl24_tmp = get_vrf_tbl24(dp, vrf_id, ledge, dp->nh_sz);
 			if ((tbl24_tmp & DIR24_8_EXT_ENT) !=
 					DIR24_8_EXT_ENT) {
 				/**
@@ -325,8 +449,8 @@ install_to_fib(struct dir24_8_tbl *dp, uint32_t ledge, uint32_t redge,
 				}
 				tbl8_free_idx(dp, tmp_tbl8_idx);
 				/*update dir24 entry with tbl8 index*/
-				write_to_fib(get_tbl24_p(dp, ledge,
-					dp->nh_sz), (tbl8_idx << 1)|
+				write_to_fib(get_vrf_tbl24_p(dp, vrf_id,
+					ledge, dp->nh_sz), (tbl8_idx << 1)|
 					DIR24_8_EXT_ENT,
 					dp->nh_sz, 1);
 			} else
@@ -339,20 +463,21 @@ install_to_fib(struct dir24_8_tbl *dp, uint32_t ledge, uint32_t redge,
 			write_to_fib((void *)tbl8_ptr, (next_hop << 1)|
 				DIR24_8_EXT_ENT,
 				dp->nh_sz, ROUNDUP(ledge, 24) - ledge);
-			tbl8_recycle(dp, ledge, tbl8_idx);
+			tbl8_recycle(dp, vrf_id, ledge, tbl8_idx);
 		}
-		write_to_fib(get_tbl24_p(dp, ROUNDUP(ledge, 24), dp->nh_sz),
+		write_to_fib(get_vrf_tbl24_p(dp, vrf_id, ROUNDUP(ledge, 24),
+			dp->nh_sz),
 			next_hop << 1, dp->nh_sz, len);
 		if (redge & ~DIR24_8_TBL24_MASK) {
-			tbl24_tmp = get_tbl24(dp, redge, dp->nh_sz);
+			tbl24_tmp = get_vrf_tbl24(dp, vrf_id, redge, dp->nh_sz);
 			if ((tbl24_tmp & DIR24_8_EXT_ENT) !=
 					DIR24_8_EXT_ENT) {
 				tbl8_idx = tbl8_alloc(dp, tbl24_tmp);
 				if (tbl8_idx < 0)
 					return -ENOSPC;
 				/*update dir24 entry with tbl8 index*/
-				write_to_fib(get_tbl24_p(dp, redge,
-					dp->nh_sz), (tbl8_idx << 1)|
+				write_to_fib(get_vrf_tbl24_p(dp, vrf_id,
+					redge, dp->nh_sz), (tbl8_idx << 1)|
 					DIR24_8_EXT_ENT,
 					dp->nh_sz, 1);
 			} else
@@ -364,17 +489,18 @@ install_to_fib(struct dir24_8_tbl *dp, uint32_t ledge, uint32_t redge,
 			write_to_fib((void *)tbl8_ptr, (next_hop << 1)|
 				DIR24_8_EXT_ENT,
 				dp->nh_sz, redge & ~DIR24_8_TBL24_MASK);
-			tbl8_recycle(dp, redge, tbl8_idx);
+			tbl8_recycle(dp, vrf_id, redge, tbl8_idx);
 		}
 	} else if ((redge - ledge) != 0) {
-		tbl24_tmp = get_tbl24(dp, ledge, dp->nh_sz);
+		tbl24_tmp = get_vrf_tbl24(dp, vrf_id, ledge, dp->nh_sz);
 		if ((tbl24_tmp & DIR24_8_EXT_ENT) !=
 				DIR24_8_EXT_ENT) {
 			tbl8_idx = tbl8_alloc(dp, tbl24_tmp);
 			if (tbl8_idx < 0)
 				return -ENOSPC;
 			/*update dir24 entry with tbl8 index*/
-			write_to_fib(get_tbl24_p(dp, ledge, dp->nh_sz),
+			write_to_fib(get_vrf_tbl24_p(dp, vrf_id, ledge,
+				dp->nh_sz),
 				(tbl8_idx << 1)|
 				DIR24_8_EXT_ENT,
 				dp->nh_sz, 1);
@@ -388,14 +514,14 @@ install_to_fib(struct dir24_8_tbl *dp, uint32_t ledge, uint32_t redge,
 		write_to_fib((void *)tbl8_ptr, (next_hop << 1)|
 			DIR24_8_EXT_ENT,
 			dp->nh_sz, redge - ledge);
-		tbl8_recycle(dp, ledge, tbl8_idx);
+		tbl8_recycle(dp, vrf_id, ledge, tbl8_idx);
 	}
 	return 0;
 }
 
 static int
-modify_fib(struct dir24_8_tbl *dp, struct rte_rib *rib, uint32_t ip,
-	uint8_t depth, uint64_t next_hop)
+modify_fib(struct dir24_8_tbl *dp, struct rte_rib *rib, uint16_t vrf_id,
+	uint32_t ip, uint8_t depth, uint64_t next_hop)
 {
 	struct rte_rib_node *tmp = NULL;
 	uint32_t ledge, redge, tmp_ip;
@@ -415,9 +541,15 @@ modify_fib(struct dir24_8_tbl *dp, struct rte_rib *rib, uint32_t ip,
 			if (ledge == redge) {
 				ledge = redge +
 					(uint32_t)(1ULL << (32 - tmp_depth));
+				/*
+				 * the covered prefix ends at the end
+				 * of address space, nothing left to install
+				 */
+				if (ledge == 0)
+					break;
 				continue;
 			}
-			ret = install_to_fib(dp, ledge, redge,
+			ret = install_to_fib(dp, vrf_id, ledge, redge,
 				next_hop);
 			if (ret != 0)
 				return ret;
@@ -433,7 +565,7 @@ modify_fib(struct dir24_8_tbl *dp, struct rte_rib *rib, uint32_t ip,
 			redge = ip + (uint32_t)(1ULL << (32 - depth));
 			if (ledge == redge && ledge != 0)
 				break;
-			ret = install_to_fib(dp, ledge, redge,
+			ret = install_to_fib(dp, vrf_id, ledge, redge,
 				next_hop);
 			if (ret != 0)
 				return ret;
@@ -444,8 +576,8 @@ modify_fib(struct dir24_8_tbl *dp, struct rte_rib *rib, uint32_t ip,
 }
 
 int
-dir24_8_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
-	uint64_t next_hop, int op)
+dir24_8_vrf_modify(struct rte_fib *fib, uint16_t vrf_id, uint32_t ip,
+	uint8_t depth, uint64_t next_hop, int op)
 {
 	struct dir24_8_tbl *dp;
 	struct rte_rib *rib;
@@ -459,8 +591,10 @@ dir24_8_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
 		return -EINVAL;
 
 	dp = rte_fib_get_dp(fib);
-	rib = rte_fib_get_rib(fib);
-	RTE_ASSERT((dp != NULL) && (rib != NULL));
+	rib = rte_fib_vrf_get_rib(fib, vrf_id);
+	RTE_ASSERT(dp != NULL);
+	if (rib == NULL)
+		return -EINVAL;
 
 	if (next_hop > get_max_nh(dp->nh_sz))
 		return -EINVAL;
@@ -474,7 +608,7 @@ dir24_8_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
 			rte_rib_get_nh(node, &node_nh);
 			if (node_nh == next_hop)
 				return 0;
-			ret = modify_fib(dp, rib, ip, depth, next_hop);
+			ret = modify_fib(dp, rib, vrf_id, ip, depth, next_hop);
 			if (ret == 0)
 				rte_rib_set_nh(node, next_hop);
 			return 0;
@@ -497,7 +631,7 @@ dir24_8_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
 			if (par_nh == next_hop)
 				return 0;
 		}
-		ret = modify_fib(dp, rib, ip, depth, next_hop);
+		ret = modify_fib(dp, rib, vrf_id, ip, depth, next_hop);
 		if (ret != 0) {
 			rte_rib_remove(rib, ip, depth);
 			return ret;
@@ -514,9 +648,11 @@ dir24_8_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
 			rte_rib_get_nh(parent, &par_nh);
 			rte_rib_get_nh(node, &node_nh);
 			if (par_nh != node_nh)
-				ret = modify_fib(dp, rib, ip, depth, par_nh);
+				ret = modify_fib(dp, rib, vrf_id, ip, depth,
+					par_nh);
 		} else
-			ret = modify_fib(dp, rib, ip, depth, dp->def_nh);
+			ret = modify_fib(dp, rib, vrf_id, ip, depth,
+				dp->def_nh);
 		if (ret == 0) {
 			rte_rib_remove(rib, ip, depth);
 			if (depth > 24) {
@@ -533,16 +669,278 @@ dir24_8_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
 	return -EINVAL;
 }
 
+int
+dir24_8_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
+	uint64_t next_hop, int op)
+{
+	return dir24_8_vrf_modify(fib, 0, ip, depth, next_hop, op);
+}
+
+/* Prefix whose routes were changed by a bulk update. */
+struct dir24_8_dirty {
+	uint32_t	ip;
+	uint8_t		depth;
+};
+
+static int
+dirty_cmp(const void *p1, const void *p2)
+{
+	const struct dir24_8_dirty *d1 = p1;
+	const struct dir24_8_dirty *d2 = p2;
+
+	if (d1->ip != d2->ip)
+		return (d1->ip < d2->ip) ? -1 : 1;
+	/* covering prefix goes first */
+	return (int)d1->depth - (int)d2->depth;
+}
+
+static inline uint64_t
+prefix_end(uint32_t ip, uint8_t depth)
+{
+	return (uint64_t)ip + (1ULL << (32 - depth));
+}
+
+/*
+ * Check if one of the sorted dirty prefixes lies within ip/depth.
+ * Prefixes are either nested or disjoint, so it is enough to look
+ * at the first one that is not smaller than ip/depth.
+ */
+static bool
+has_dirty(const struct dir24_8_dirty *dirty, uint32_t n, uint32_t ip,
+	uint8_t depth)
+{
+	uint32_t l = 0, r = n, m;
+
+	while (l < r) {
+		m = l + (r - l) / 2;
+		if ((dirty[m].ip < ip) ||
+				((dirty[m].ip == ip) && (dirty[m].depth < depth)))
+			l = m + 1;
+		else
+			r = m;
+	}
+	return (l < n) && (dirty[l].ip < prefix_end(ip, depth));
+}
+
+/* Next hop of the longest route covering the whole ip/depth prefix. */
+static uint64_t
+get_cover_nh(struct dir24_8_tbl *dp, struct rte_rib *rib, uint32_t ip,
+	uint8_t depth)
+{
+	struct rte_rib_node *node;
+	uint64_t nh;
+	uint8_t node_depth;
+
+	node = rte_rib_lookup(rib, ip);
+	while (node != NULL) {
+		rte_rib_get_depth(node, &node_depth);
+		if (node_depth <= depth)
+			break;
+		node = rte_rib_lookup_parent(node);
+	}
+	if (node == NULL)
+		return dp->def_nh;
+	rte_rib_get_nh(node, &nh);
+	return nh;
+}
+
+/*
+ * Write next_hop to the part of ip/depth not covered by more specific
+ * routes, then descend only into the routes containing changes.
+ * Everything else under ip/depth already holds the right next hops.
+ */
+static int
+rewrite_fib(struct dir24_8_tbl *dp, struct rte_rib *rib, uint16_t vrf_id,
+	const struct dir24_8_dirty *dirty, uint32_t nb_dirty,
+	uint32_t ip, uint8_t depth, uint64_t next_hop)
+{
+	struct rte_rib_node *tmp = NULL;
+	uint32_t tmp_ip;
+	uint64_t tmp_nh;
+	uint8_t tmp_depth;
+	int ret;
+
+	ret = modify_fib(dp, rib, vrf_id, ip, depth, next_hop);
+	if (ret != 0)
+		return ret;
+
+	while ((tmp = rte_rib_get_nxt(rib, ip, depth, tmp,
+			RTE_RIB_GET_NXT_COVER)) != NULL) {
+		rte_rib_get_ip(tmp, &tmp_ip);
+		rte_rib_get_depth(tmp, &tmp_depth);
+		if (!has_dirty(dirty, nb_dirty, tmp_ip, tmp_depth))
+			continue;
+		rte_rib_get_nh(tmp, &tmp_nh);
+		ret = rewrite_fib(dp, rib, vrf_id, dirty, nb_dirty, tmp_ip,
+			tmp_depth, tmp_nh);
+		if (ret != 0)
+			return ret;
+	}
+	return 0;
+}
+
+/*
+ * Unlink the tbl8 group of a /24 which has no routes longer than /24
+ * anymore, so that it is rewritten through tbl24 only.
+ */
+static void
+collapse_tbl24(struct dir24_8_tbl *dp, struct rte_rib *rib, uint16_t vrf_id,
+	uint32_t ip)
+{
+	uint64_t ent;
+
+	ip &= DIR24_8_TBL24_MASK;
+	ent = get_vrf_tbl24(dp, vrf_id, ip, dp->nh_sz);
+	if (((ent & DIR24_8_EXT_ENT) != DIR24_8_EXT_ENT) ||
+			(rte_rib_get_nxt(rib, ip, 24, NULL,
+			RTE_RIB_GET_NXT_COVER) != NULL))
+		return;
+
+	write_to_fib(get_vrf_tbl24_p(dp, vrf_id, ip, dp->nh_sz),
+		get_cover_nh(dp, rib, ip, 24) << 1, dp->nh_sz, 1);
+	tbl8_free(dp, ent >> 1);
+}
+
+int
+dir24_8_modify_bulk(struct rte_fib *fib, const struct rte_fib_route_op *ops,
+	unsigned int n)
+{
+	struct dir24_8_tbl *dp;
+	struct rte_rib *rib;
+	struct rte_rib_node *node, *tmp;
+	struct dir24_8_dirty *dirty;
+	uint32_t i, ip, nb_dirty, nb_ops;
+	uint64_t nh, end;
+	int ret = 0, err = 0;
+	uint8_t depth;
+
+	if ((fib == NULL) || ((ops == NULL) && (n != 0)))
+		return -EINVAL;
+	if (n == 0)
+		return 0;
+
+	dp = rte_fib_get_dp(fib);
+	rib = rte_fib_get_rib(fib);
+	RTE_ASSERT((dp != NULL) && (rib != NULL));
+
+	dirty = rte_malloc(NULL, sizeof(*dirty) * n, 0);
+	if (dirty == NULL)
+		return -ENOMEM;
+
+	/* Apply all operations to the RIB first. */
+	nb_dirty = 0;
+	for (i = 0; i != n; i++) {
+		depth = ops[i].depth;
+		if (depth > RTE_FIB_MAXDEPTH) {
+			err = -EINVAL;
+			break;
+		}
+		ip = ops[i].ip & rte_rib_depth_to_mask(depth);
+		node = rte_rib_lookup_exact(rib, ip, depth);
+
+		if (ops[i].op == RTE_FIB_ADD) {
+			if (ops[i].next_hop > get_max_nh(dp->nh_sz)) {
+				err = -EINVAL;
+				break;
+			}
+			if (node != NULL) {
+				rte_rib_get_nh(node, &nh);
+				if (nh == ops[i].next_hop)
+					continue;
+			} else {
+				tmp = NULL;
+				if (depth > 24) {
+					tmp = rte_rib_get_nxt(rib, ip, 24, NULL,
+						RTE_RIB_GET_NXT_COVER);
+					if ((tmp == NULL) && (dp->rsvd_tbl8s >=
+							dp->number_tbl8s)) {
+						err = -ENOSPC;
+						break;
+					}
+				}
+				node = rte_rib_insert(rib, ip, depth);
+				if (node == NULL) {
+					err = -rte_errno;
+					break;
+				}
+				if ((depth > 24) && (tmp == NULL))
+					dp->rsvd_tbl8s++;
+			}
+			rte_rib_set_nh(node, ops[i].next_hop);
+		} else if (ops[i].op == RTE_FIB_DEL) {
+			if (node == NULL) {
+				err = -ENOENT;
+				break;
+			}
+			rte_rib_remove(rib, ip, depth);
+			if ((depth > 24) && (rte_rib_get_nxt(rib, ip, 24, NULL,
+					RTE_RIB_GET_NXT_COVER) == NULL))
+				dp->rsvd_tbl8s--;
+		} else {
+			err = -EINVAL;
+			break;
+		}
+		dirty[nb_dirty].ip = ip;
+		dirty[nb_dirty].depth = depth;
+		nb_dirty++;
+	}
+	nb_ops = i;
+
+	/*
+	 * In blocking mode wait for the readers once for all the tbl8
+	 * groups released below instead of once per group.
+	 */
+	if ((dp->v != NULL) && (dp->rcu_mode == RTE_FIB_QSBR_MODE_SYNC))
+		dp->tbl8_pend = rte_malloc(NULL,
+			sizeof(*dp->tbl8_pend) * dp->number_tbl8s, 0);
+
+	for (i = 0; i != nb_dirty; i++) {
+		if (dirty[i].depth > 24)
+			collapse_tbl24(dp, rib, 0, dirty[i].ip);
+	}
+
+	/*
+	 * Rewrite every outermost changed prefix once, with the next hops
+	 * the RIB holds after all operations.
+	 */
+	qsort(dirty, nb_dirty, sizeof(*dirty), dirty_cmp);
+	end = 0;
+	for (i = 0; i != nb_dirty; i++) {
+		if ((i != 0) && (dirty[i].ip < end))
+			continue;
+		end = prefix_end(dirty[i].ip, dirty[i].depth);
+		ret = rewrite_fib(dp, rib, 0, dirty, nb_dirty, dirty[i].ip,
+			dirty[i].depth, get_cover_nh(dp, rib, dirty[i].ip,
+			dirty[i].depth));
+		if (ret != 0)
+			break;
+	}
+
+	tbl8_pend_flush(dp);
+	rte_free(dp->tbl8_pend);
+	dp->tbl8_pend = NULL;
+	rte_free(dirty);
+
+	if (ret != 0)
+		return ret;
+	if (err != 0)
+		rte_errno = -err;
+	return nb_ops;
+}
+
 void *
-dir24_8_create(const char *name, int socket_id, struct rte_fib_conf *fib_conf)
+dir24_8_create(const char *name, int socket_id, struct rte_fib_conf *fib_conf,
+	uint32_t num_vrfs)
 {
 	char mem_name[DIR24_8_NAMESIZE];
 	struct dir24_8_tbl *dp;
 	uint64_t	def_nh;
 	uint32_t	num_tbl8;
+	uint32_t	i;
 	enum rte_fib_dir24_8_nh_sz	nh_sz;
 
 	if ((name == NULL) || (fib_conf == NULL) ||
+			(num_vrfs == 0) || (num_vrfs > RTE_FIB_MAX_VRFS) ||
 			(fib_conf->dir24_8.nh_sz < RTE_FIB_DIR24_8_1B) ||
 			(fib_conf->dir24_8.nh_sz > RTE_FIB_DIR24_8_8B) ||
 			(fib_conf->dir24_8.num_tbl8 >
@@ -561,15 +959,17 @@ dir24_8_create(const char *name, int socket_id, struct rte_fib_conf *fib_conf)
 
 	snprintf(mem_name, sizeof(mem_name), "DP_%s", name);
 	dp = rte_zmalloc_socket(name, sizeof(struct dir24_8_tbl) +
-		DIR24_8_TBL24_NUM_ENT * (1 << nh_sz) + sizeof(uint32_t),
-		RTE_CACHE_LINE_SIZE, socket_id);
+		(size_t)num_vrfs * DIR24_8_TBL24_NUM_ENT * (1 << nh_sz) +
+		sizeof(uint32_t), RTE_CACHE_LINE_SIZE, socket_id);
 	if (dp == NULL) {
 		rte_errno = ENOMEM;
 		return NULL;
 	}
 
-	/* Init table with default value */
-	write_to_fib(dp->tbl24, (def_nh << 1), nh_sz, 1 << 24);
+	/* Init tables with default value */
+	for (i = 0; i < num_vrfs; i++)
+		write_to_fib(get_vrf_tbl24_p(dp, i, 0, nh_sz), (def_nh << 1),
+			nh_sz, 1 << 24);
 
 	snprintf(mem_name, sizeof(mem_name), "TBL8_%p", dp);
 	uint64_t tbl8_sz = DIR24_8_TBL8_GRP_NUM_ENT * (1ULL << nh_sz) *
@@ -584,6 +984,7 @@ dir24_8_create(const char *name, int socket_id, struct rte_fib_conf *fib_conf)
 	dp->def_nh = def_nh;
 	dp->nh_sz = nh_sz;
 	dp->number_tbl8s = num_tbl8;
+	dp->num_vrfs = num_vrfs;
 
 	snprintf(mem_name, sizeof(mem_name), "TBL8_idxes_%p", dp);
 	dp->tbl8_idxes = rte_zmalloc_socket(mem_name,
@@ -32,23 +32,33 @@ struct dir24_8_tbl {
 	uint32_t	number_tbl8s;	/**< Total number of tbl8s */
 	uint32_t	rsvd_tbl8s;	/**< Number of reserved tbl8s */
 	uint32_t	cur_tbl8s;	/**< Current number of tbl8s */
+	uint32_t	num_vrfs;	/**< Number of VRFs */
 	enum rte_fib_dir24_8_nh_sz	nh_sz;	/**< Size of nexthop entry */
 	/* RCU config. */
 	enum rte_fib_qsbr_mode rcu_mode;/* Blocking, defer queue. */
 	struct rte_rcu_qsbr *v;		/* RCU QSBR variable. */
 	struct rte_rcu_qsbr_dq *dq;	/* RCU QSBR defer queue. */
+	uint32_t	*tbl8_pend;	/* tbl8s unlinked by a bulk update. */
+	uint32_t	nb_tbl8_pend;	/* Number of pending tbl8s. */
 	uint64_t	def_nh;		/**< Default next hop */
 	uint64_t	*tbl8;		/**< tbl8 table. */
 	uint64_t	*tbl8_idxes;	/**< bitmap containing free tbl8 idxes*/
-	/* tbl24 table. */
+	/* tbl24 tables of all VRFs, one after another. */
 	alignas(RTE_CACHE_LINE_SIZE) uint64_t	tbl24[];
 };
 
+static inline void *
+get_vrf_tbl24_p(struct dir24_8_tbl *dp, uint16_t vrf_id, uint32_t ip,
+	uint8_t nh_sz)
+{
+	return (void *)&((uint8_t *)dp->tbl24)[((uint64_t)vrf_id <<
+		(24 + nh_sz)) + ((ip & DIR24_8_TBL24_MASK) >> (8 - nh_sz))];
+}
+
 static inline void *
 get_tbl24_p(struct dir24_8_tbl *dp, uint32_t ip, uint8_t nh_sz)
 {
-	return (void *)&((uint8_t *)dp->tbl24)[(ip &
-		DIR24_8_TBL24_MASK) >> (8 - nh_sz)];
+	return get_vrf_tbl24_p(dp, 0, ip, nh_sz);
 }
 
 static inline  uint8_t
@@ -69,6 +79,12 @@ get_tbl24_idx(uint32_t ip)
 	return ip >> 8;
 }
 
+static inline uint64_t
+get_vrf_tbl24_idx(uint16_t vrf_id, uint32_t ip)
+{
+	return ((uint64_t)vrf_id << 24) + (ip >> 8);
+}
+
 static  inline uint32_t
 get_tbl8_idx(uint32_t res, uint32_t ip)
 {
@@ -93,6 +109,17 @@ get_tbl_idx(uint32_t val, uint8_t nh_sz)
 	return val >> (3 - nh_sz);
 }
 
+static inline uint64_t
+get_vrf_tbl24(struct dir24_8_tbl *dp, uint16_t vrf_id, uint32_t ip,
+	uint8_t nh_sz)
+{
+	uint64_t idx = get_vrf_tbl24_idx(vrf_id, ip);
+
+	return ((dp->tbl24[idx >> (3 - nh_sz)] >>
+		(get_psd_idx(idx, nh_sz) * bits_in_nh(nh_sz))) &
+		lookup_msk(nh_sz));
+}
+
 static inline uint64_t
 get_tbl24(struct dir24_8_tbl *dp, uint32_t ip, uint8_t nh_sz)
 {
@@ -150,6 +177,46 @@ LOOKUP_FUNC(2b, uint16_t, 6, 1)
 LOOKUP_FUNC(4b, uint32_t, 15, 2)
 LOOKUP_FUNC(8b, uint64_t, 12, 3)
 
+#define VRF_LOOKUP_FUNC(suffix, type, bulk_prefetch, nh_sz)		\
+static inline void dir24_8_vrf_lookup_bulk_##suffix(void *p,		\
+	const uint16_t *vrf_ids, const uint32_t *ips,			\
+	uint64_t *next_hops, const unsigned int n)			\
+{									\
+	struct dir24_8_tbl *dp = (struct dir24_8_tbl *)p;		\
+	uint64_t tmp;							\
+	uint32_t i;							\
+	uint32_t prefetch_offset =					\
+		RTE_MIN((unsigned int)bulk_prefetch, n);		\
+									\
+	for (i = 0; i < prefetch_offset; i++)				\
+		rte_prefetch0(get_vrf_tbl24_p(dp, vrf_ids[i], ips[i],	\
+			nh_sz));					\
+	for (i = 0; i < (n - prefetch_offset); i++) {			\
+		rte_prefetch0(get_vrf_tbl24_p(dp,			\
+			vrf_ids[i + prefetch_offset],			\
+			ips[i + prefetch_offset], nh_sz));		\
+		tmp = ((type *)dp->tbl24)[get_vrf_tbl24_idx(vrf_ids[i],	\
+			ips[i])];					\
+		if (unlikely(is_entry_extended(tmp)))			\
+			tmp = ((type *)dp->tbl8)[(uint8_t)ips[i] +	\
+				((tmp >> 1) * DIR24_8_TBL8_GRP_NUM_ENT)]; \
+		next_hops[i] = tmp >> 1;				\
+	}								\
+	for (; i < n; i++) {						\
+		tmp = ((type *)dp->tbl24)[get_vrf_tbl24_idx(vrf_ids[i],	\
+			ips[i])];					\
+		if (unlikely(is_entry_extended(tmp)))			\
+			tmp = ((type *)dp->tbl8)[(uint8_t)ips[i] +	\
+				((tmp >> 1) * DIR24_8_TBL8_GRP_NUM_ENT)]; \
+		next_hops[i] = tmp >> 1;				\
+	}								\
+}									\
+
+VRF_LOOKUP_FUNC(1b, uint8_t, 5, 0)
+VRF_LOOKUP_FUNC(2b, uint16_t, 6, 1)
+VRF_LOOKUP_FUNC(4b, uint32_t, 15, 2)
+VRF_LOOKUP_FUNC(8b, uint64_t, 12, 3)
+
 static inline void
 dir24_8_lookup_bulk(struct dir24_8_tbl *dp, const uint32_t *ips,
 	uint64_t *next_hops, const unsigned int n, uint8_t nh_sz)
@@ -286,8 +353,45 @@ DECLARE_BE_LOOKUP_FN(dir24_8_lookup_bulk_2)
 DECLARE_BE_LOOKUP_FN(dir24_8_lookup_bulk_3)
 DECLARE_BE_LOOKUP_FN(dir24_8_lookup_bulk_uni)
 
+typedef void (*dir24_8_vrf_lookup_bulk_be_cb)(void *p, const uint16_t *vrf_ids,
+	const uint32_t *ips, uint64_t *next_hops, const unsigned int n);
+
+static inline void
+dir24_8_vrf_lookup_bulk_be(void *p, const uint16_t *vrf_ids, const uint32_t *ips,
+	uint64_t *next_hops, const unsigned int n, dir24_8_vrf_lookup_bulk_be_cb cb)
+{
+	uint32_t le_ips[BSWAP_MAX_LENGTH];
+	unsigned int i;
+
+#if RTE_BYTE_ORDER == RTE_BIG_ENDIAN
+	cb(p, vrf_ids, ips, next_hops, n);
+#else
+	for (i = 0; i < n; i += BSWAP_MAX_LENGTH) {
+		int j;
+		for (j = 0; j < BSWAP_MAX_LENGTH && i + j < n; j++)
+			le_ips[j] = rte_be_to_cpu_32(ips[i + j]);
+
+		cb(p, vrf_ids + i, le_ips, next_hops + i, j);
+	}
+#endif
+}
+
+#define DECLARE_VRF_BE_LOOKUP_FN(name) \
+static inline void \
+name##_be(void *p, const uint16_t *vrf_ids, const uint32_t *ips, \
+	uint64_t *next_hops, const unsigned int n) \
+{ \
+	dir24_8_vrf_lookup_bulk_be(p, vrf_ids, ips, next_hops, n, name); \
+}
+
+DECLARE_VRF_BE_LOOKUP_FN(dir24_8_vrf_lookup_bulk_1b)
+DECLARE_VRF_BE_LOOKUP_FN(dir24_8_vrf_lookup_bulk_2b)
+DECLARE_VRF_BE_LOOKUP_FN(dir24_8_vrf_lookup_bulk_4b)
+DECLARE_VRF_BE_LOOKUP_FN(dir24_8_vrf_lookup_bulk_8b)
+
 void *
-dir24_8_create(const char *name, int socket_id, struct rte_fib_conf *conf);
+dir24_8_create(const char *name, int socket_id, struct rte_fib_conf *conf,
+	uint32_t num_vrfs);
 
 void
 dir24_8_free(void *p);
@@ -295,10 +399,22 @@ dir24_8_free(void *p);
 rte_fib_lookup_fn_t
 dir24_8_get_lookup_fn(void *p, enum rte_fib_lookup_type type, bool be_addr);
 
+rte_fib_vrf_lookup_fn_t
+dir24_8_get_vrf_lookup_fn(void *p, enum rte_fib_lookup_type type,
+	bool be_addr);
+
 int
 dir24_8_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
 	uint64_t next_hop, int op);
 
+int
+dir24_8_vrf_modify(struct rte_fib *fib, uint16_t vrf_id, uint32_t ip,
+	uint8_t depth, uint64_t next_hop, int op);
+
+int
+dir24_8_modify_bulk(struct rte_fib *fib, const struct rte_fib_route_op *ops,
+	unsigned int n);
+
 int
 dir24_8_rcu_qsbr_add(struct dir24_8_tbl *dp, struct rte_fib_rcu_config *cfg,
 	const char *name);
@@ -169,3 +169,120 @@ rte_dir24_8_vec_lookup_bulk_8b_be(void *p, const uint32_t *ips,
 		dir24_8_vec_lookup_x8_8b(p, ips + i * 8, next_hops + i * 8, true);
 	dir24_8_lookup_bulk_8b_be(p, ips + i * 8, next_hops + i * 8, n - i * 8);
 }
+
+/*
+ * Lookup 8 addresses in the tbl24 of their VRF. The tbl24 index
+ * (vrf_id << 24) + (ip >> 8) does not fit 32 bits, so 64-bit indexes
+ * are gathered 8 at a time.
+ */
+static __rte_always_inline void
+dir24_8_vec_vrf_lookup_x8(void *p, const uint16_t *vrf_ids,
+	const uint32_t *ips, uint64_t *next_hops, int size, bool be_addr)
+{
+	struct dir24_8_tbl *dp = (struct dir24_8_tbl *)p;
+	const __m512i zero = _mm512_set1_epi32(0);
+	const __m512i lsbyte_msk = _mm512_set1_epi64(0xff);
+	const __m512i lsb = _mm512_set1_epi64(1);
+	__m512i res, idxes, bytes, ip_vec, vrf_vec, res_msk;
+	__m256i ip_256, res_256;
+	__mmask8 msk_ext;
+
+	/* used to mask gather values if size is 1/2 (8/16 bit next hops) */
+	if (size == sizeof(uint8_t))
+		res_msk = _mm512_set1_epi64(UINT8_MAX);
+	else if (size == sizeof(uint16_t))
+		res_msk = _mm512_set1_epi64(UINT16_MAX);
+
+	ip_256 = _mm256_loadu_si256((const void *)ips);
+	if (be_addr) {
+		const __m256i bswap32 = _mm256_set_epi8(
+			12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+			12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3
+		);
+		ip_256 = _mm256_shuffle_epi8(ip_256, bswap32);
+	}
+	ip_vec = _mm512_cvtepu32_epi64(ip_256);
+	vrf_vec = _mm512_cvtepu16_epi64(_mm_loadu_si128((const void *)vrf_ids));
+
+	/* index in the tbl24 of the VRF */
+	idxes = _mm512_add_epi64(_mm512_slli_epi64(vrf_vec, 24),
+		_mm512_srli_epi64(ip_vec, 8));
+
+	/**
+	 * lookup in tbl24
+	 * Put it inside branch to make compiler happy with -O0
+	 */
+	if (size == sizeof(uint8_t)) {
+		res_256 = _mm512_i64gather_epi32(idxes,
+			(const void *)dp->tbl24, 1);
+		res = _mm512_and_si512(_mm512_cvtepu32_epi64(res_256),
+			res_msk);
+	} else if (size == sizeof(uint16_t)) {
+		res_256 = _mm512_i64gather_epi32(idxes,
+			(const void *)dp->tbl24, 2);
+		res = _mm512_and_si512(_mm512_cvtepu32_epi64(res_256),
+			res_msk);
+	} else if (size == sizeof(uint32_t)) {
+		res_256 = _mm512_i64gather_epi32(idxes,
+			(const void *)dp->tbl24, 4);
+		res = _mm512_cvtepu32_epi64(res_256);
+	} else
+		res = _mm512_i64gather_epi64(idxes, (const void *)dp->tbl24, 8);
+
+	/* get extended entries indexes */
+	msk_ext = _mm512_test_epi64_mask(res, lsb);
+
+	if (msk_ext != 0) {
+		idxes = _mm512_srli_epi64(res, 1);
+		idxes = _mm512_slli_epi64(idxes, 8);
+		bytes = _mm512_and_si512(ip_vec, lsbyte_msk);
+		idxes = _mm512_maskz_add_epi64(msk_ext, idxes, bytes);
+		if (size == sizeof(uint8_t)) {
+			res_256 = _mm512_mask_i64gather_epi32(
+				_mm256_setzero_si256(), msk_ext, idxes,
+				(const void *)dp->tbl8, 1);
+			idxes = _mm512_and_si512(
+				_mm512_cvtepu32_epi64(res_256), res_msk);
+		} else if (size == sizeof(uint16_t)) {
+			res_256 = _mm512_mask_i64gather_epi32(
+				_mm256_setzero_si256(), msk_ext, idxes,
+				(const void *)dp->tbl8, 2);
+			idxes = _mm512_and_si512(
+				_mm512_cvtepu32_epi64(res_256), res_msk);
+		} else if (size == sizeof(uint32_t)) {
+			res_256 = _mm512_mask_i64gather_epi32(
+				_mm256_setzero_si256(), msk_ext, idxes,
+				(const void *)dp->tbl8, 4);
+			idxes = _mm512_cvtepu32_epi64(res_256);
+		} else
+			idxes = _mm512_mask_i64gather_epi64(zero, msk_ext,
+				idxes, (const void *)dp->tbl8, 8);
+
+		res = _mm512_mask_blend_epi64(msk_ext, res, idxes);
+	}
+
+	res = _mm512_srli_epi64(res, 1);
+	_mm512_storeu_si512(next_hops, res);
+}
+
+#define DECLARE_VRF_VECTOR_FN(suffix, nh_type, be_addr) \
+void \
+rte_dir24_8_vec_vrf_lookup_bulk_##suffix(void *p, const uint16_t *vrf_ids, \
+	const uint32_t *ips, uint64_t *next_hops, const unsigned int n) \
+{ \
+	uint32_t i; \
+	for (i = 0; i < (n / 8); i++) \
+		dir24_8_vec_vrf_lookup_x8(p, vrf_ids + i * 8, ips + i * 8, \
+			next_hops + i * 8, sizeof(nh_type), be_addr); \
+	dir24_8_vrf_lookup_bulk_##suffix(p, vrf_ids + i * 8, ips + i * 8, \
+		next_hops + i * 8, n - i * 8); \
+}
+
+DECLARE_VRF_VECTOR_FN(1b, uint8_t, false)
+DECLARE_VRF_VECTOR_FN(1b_be, uint8_t, true)
+DECLARE_VRF_VECTOR_FN(2b, uint16_t, false)
+DECLARE_VRF_VECTOR_FN(2b_be, uint16_t, true)
+DECLARE_VRF_VECTOR_FN(4b, uint32_t, false)
+DECLARE_VRF_VECTOR_FN(4b_be, uint32_t, true)
+DECLARE_VRF_VECTOR_FN(8b, uint64_t, false)
+DECLARE_VRF_VECTOR_FN(8b_be, uint64_t, true)
@@ -0,0 +1,1111 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 The DPDK contributors
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <rte_debug.h>
+#include <rte_malloc.h>
+#include <rte_errno.h>
+#include <rte_atomic.h>
+#include <rte_vect.h>
+
+#include <rte_rib.h>
+#include <rte_rib6.h>
+#include <rte_fib.h>
+#include <rte_fib6.h>
+#include "poptrie.h"
+#include "fib_log.h"
+
+#ifdef CC_POPTRIE_AVX512_SUPPORT
+
+#include "poptrie_avx512.h"
+
+#endif /* CC_POPTRIE_AVX512_SUPPORT */
+
+#define POPTRIE_NAMESIZE	64
+
+/* Memory block descriptor: index, size order and array it belongs to. */
+#define BLK(idx, order, leaf)	((uint64_t)(idx) | ((uint64_t)(order) << 32) | \
+	((uint64_t)(leaf) << 40))
+#define BLK_IDX(blk)		((uint32_t)(blk))
+#define BLK_ORDER(blk)		((uint8_t)((blk) >> 32))
+#define BLK_IS_LEAF(blk)	(((blk) >> 40) & 1)
+
+#define POPTRIE_SLAB_BITS	64
+
+/* State of a single route update. */
+struct poptrie_upd {
+	struct poptrie_tbl	*dp;
+	struct poptrie_key	key;	/**< updated prefix */
+	uint8_t			depth;	/**< updated prefix length */
+	uint64_t	*new_blk;	/**< blocks allocated by the update */
+	uint32_t	nb_new;
+	uint32_t	sz_new;
+	uint64_t	*old_blk;	/**< blocks unlinked by the update */
+	uint32_t	nb_old;
+	uint32_t	sz_old;
+};
+
+static void
+poptrie_lookup_bulk(void *p, const uint32_t *ips,
+	uint64_t *next_hops, const unsigned int n)
+{
+	const struct poptrie_tbl *dp = p;
+	unsigned int i;
+
+	for (i = 0; i < n; i++)
+		next_hops[i] = poptrie_lookup4(dp, ips[i]);
+}
+
+static void
+poptrie_lookup_bulk_be(void *p, const uint32_t *ips,
+	uint64_t *next_hops, const unsigned int n)
+{
+	const struct poptrie_tbl *dp = p;
+	unsigned int i;
+
+	for (i = 0; i < n; i++)
+		next_hops[i] = poptrie_lookup4(dp, rte_be_to_cpu_32(ips[i]));
+}
+
+static void
+poptrie6_lookup_bulk(void *p, const struct rte_ipv6_addr *ips,
+	uint64_t *next_hops, const unsigned int n)
+{
+	const struct poptrie_tbl *dp = p;
+	unsigned int i;
+
+	for (i = 0; i < n; i++)
+		next_hops[i] = poptrie_lookup6(dp, &ips[i]);
+}
+
+static inline rte_fib_lookup_fn_t
+get_vector_fn(bool be_addr)
+{
+#ifdef CC_POPTRIE_AVX512_SUPPORT
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) <= 0 ||
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512DQ) <= 0 ||
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512VPOPCNTDQ) <= 0 ||
+			rte_vect_get_max_simd_bitwidth() < RTE_VECT_SIMD_512)
+		return NULL;
+
+	return be_addr ? rte_poptrie_vec_lookup_bulk_be :
+		rte_poptrie_vec_lookup_bulk;
+#else
+	RTE_SET_USED(be_addr);
+#endif
+	return NULL;
+}
+
+rte_fib_lookup_fn_t
+poptrie_get_lookup_fn(void *p, enum rte_fib_lookup_type type, bool be_addr)
+{
+	rte_fib_lookup_fn_t ret_fn;
+
+	if (p == NULL)
+		return NULL;
+
+	switch (type) {
+	case RTE_FIB_LOOKUP_POPTRIE_SCALAR:
+		return be_addr ? poptrie_lookup_bulk_be : poptrie_lookup_bulk;
+	case RTE_FIB_LOOKUP_POPTRIE_VECTOR_AVX512:
+		return get_vector_fn(be_addr);
+	case RTE_FIB_LOOKUP_DEFAULT:
+		ret_fn = get_vector_fn(be_addr);
+		if (ret_fn != NULL)
+			return ret_fn;
+		return be_addr ? poptrie_lookup_bulk_be : poptrie_lookup_bulk;
+	default:
+		return NULL;
+	}
+
+	return NULL;
+}
+
+rte_fib6_lookup_fn_t
+poptrie6_get_lookup_fn(void *p, enum rte_fib6_lookup_type type)
+{
+	if (p == NULL)
+		return NULL;
+
+	switch (type) {
+	case RTE_FIB6_LOOKUP_POPTRIE_SCALAR:
+	case RTE_FIB6_LOOKUP_DEFAULT:
+		return poptrie6_lookup_bulk;
+	default:
+		return NULL;
+	}
+
+	return NULL;
+}
+
+/* Extract n bits of the key starting at bit pos, n <= 64. */
+static inline uint64_t
+key_bits(const struct poptrie_key *key, unsigned int pos, unsigned int n)
+{
+	unsigned int end = pos + n;
+	uint64_t mask = (n == 64) ? UINT64_MAX : ((1ULL << n) - 1);
+
+	if (end <= 64)
+		return (key->hi >> (64 - end)) & mask;
+	if (pos >= 64)
+		return (key->lo >> (128 - end)) & mask;
+	return ((key->hi << (end - 64)) | (key->lo >> (128 - end))) & mask;
+}
+
+/* Set n bits of the key starting at bit pos to val, the bits must be 0. */
+static inline void
+key_set_bits(struct poptrie_key *key, unsigned int pos, unsigned int n,
+	uint64_t val)
+{
+	unsigned int end = pos + n;
+
+	if (end <= 64)
+		key->hi |= val << (64 - end);
+	else if (pos >= 64)
+		key->lo |= val << (128 - end);
+	else {
+		key->hi |= val >> (end - 64);
+		key->lo |= val << (128 - end);
+	}
+}
+
+/* Check whether the first depth bits of the keys are equal. */
+static inline bool
+key_prefix_eq(const struct poptrie_key *k1, const struct poptrie_key *k2,
+	unsigned int depth)
+{
+	uint64_t mask;
+
+	if (depth == 0)
+		return true;
+	if (depth <= 64) {
+		mask = UINT64_MAX << (64 - depth);
+		return ((k1->hi ^ k2->hi) & mask) == 0;
+	}
+	mask = UINT64_MAX << (128 - depth);
+	return (k1->hi == k2->hi) && (((k1->lo ^ k2->lo) & mask) == 0);
+}
+
+static inline uint8_t
+blk_order(uint32_t n)
+{
+	return (n <= 1) ? 0 : rte_log2_u32(n);
+}
+
+/* Number of bitmap slabs to track the blocks of an order in n entries. */
+static inline uint32_t
+blk_nb_slabs(uint32_t n, uint8_t order)
+{
+	return ((n >> order) + POPTRIE_SLAB_BITS - 1) / POPTRIE_SLAB_BITS;
+}
+
+static inline uint64_t *
+blk_free_map(struct poptrie_tbl *dp, bool leaf, uint8_t order)
+{
+	return leaf ? dp->leaf_free[order] : dp->node_free[order];
+}
+
+static inline uint32_t *
+blk_free_hint(struct poptrie_tbl *dp, bool leaf, uint8_t order)
+{
+	return leaf ? &dp->leaf_hint[order] : &dp->node_hint[order];
+}
+
+static void
+blk_set_free(struct poptrie_tbl *dp, bool leaf, uint32_t idx, uint8_t order)
+{
+	uint32_t bit = idx >> order;
+	uint32_t *hint = blk_free_hint(dp, leaf, order);
+
+	blk_free_map(dp, leaf, order)[bit / POPTRIE_SLAB_BITS] |=
+		RTE_BIT64(bit % POPTRIE_SLAB_BITS);
+	*hint = RTE_MIN(*hint, bit / POPTRIE_SLAB_BITS);
+}
+
+/* Clear the free bit of a block, return whether it was set. */
+static bool
+blk_clear_free(struct poptrie_tbl *dp, bool leaf, uint32_t idx, uint8_t order)
+{
+	uint32_t bit = idx >> order;
+	uint64_t *slab = &blk_free_map(dp, leaf, order)[bit / POPTRIE_SLAB_BITS];
+	uint64_t mask = RTE_BIT64(bit % POPTRIE_SLAB_BITS);
+
+	if ((*slab & mask) == 0)
+		return false;
+	*slab &= ~mask;
+	return true;
+}
+
+/* Take the first free block of the given size. */
+static uint32_t
+blk_take(struct poptrie_tbl *dp, bool leaf, uint8_t order)
+{
+	uint32_t num = leaf ? dp->num_leaves : dp->num_nodes;
+	uint32_t nb_slabs = blk_nb_slabs(num, order);
+	uint64_t *map = blk_free_map(dp, leaf, order);
+	uint32_t *hint = blk_free_hint(dp, leaf, order);
+	uint32_t i, bit;
+
+	for (i = *hint; i < nb_slabs; i++) {
+		if (map[i] == 0)
+			continue;
+		bit = i * POPTRIE_SLAB_BITS + rte_ctz64(map[i]);
+		map[i] &= map[i] - 1;
+		*hint = i;
+		return bit << order;
+	}
+	*hint = nb_slabs;
+	return POPTRIE_INVALID_IDX;
+}
+
+/* Give back a block, merging it with its free buddies. */
+static void
+blk_free(struct poptrie_tbl *dp, bool leaf, uint32_t idx, uint8_t order)
+{
+	uint32_t num = leaf ? dp->num_leaves : dp->num_nodes;
+	uint32_t buddy;
+
+	for (; order < POPTRIE_NUM_ORDERS - 1; order++) {
+		buddy = idx ^ (1U << order);
+		if ((buddy >> order) >= (num >> order) ||
+				!blk_clear_free(dp, leaf, buddy, order))
+			break;
+		idx &= buddy;
+	}
+	blk_set_free(dp, leaf, idx, order);
+}
+
+static void
+blk_release(struct poptrie_tbl *dp, uint64_t blk)
+{
+	bool leaf = BLK_IS_LEAF(blk);
+
+	blk_free(dp, leaf, BLK_IDX(blk), BLK_ORDER(blk));
+	if (leaf)
+		dp->cur_leaves -= 1U << BLK_ORDER(blk);
+	else
+		dp->cur_nodes -= 1U << BLK_ORDER(blk);
+}
+
+/*
+ * Take a free block of the given size, splitting a larger free block
+ * or carving it from the unused tail of the array if necessary.
+ * Blocks are aligned on their size so that freed buddies merge back.
+ */
+static uint32_t
+blk_get(struct poptrie_tbl *dp, bool leaf, uint8_t order)
+{
+	uint32_t *top = leaf ? &dp->leaf_top : &dp->node_top;
+	uint32_t num = leaf ? dp->num_leaves : dp->num_nodes;
+	uint32_t idx, end;
+	uint8_t o;
+
+	for (o = order; o < POPTRIE_NUM_ORDERS; o++) {
+		idx = blk_take(dp, leaf, o);
+		if (idx == POPTRIE_INVALID_IDX)
+			continue;
+		/* give back the upper halves */
+		while (o-- > order)
+			blk_set_free(dp, leaf, idx + (1U << o), o);
+		return idx;
+	}
+
+	/*
+	 * Free the tail up to the block alignment, it may merge
+	 * with the free blocks below into a large enough block.
+	 */
+	end = RTE_MIN(RTE_ALIGN_CEIL(*top, 1U << order), num);
+	if (*top < end) {
+		while (*top < end) {
+			o = rte_ctz32(*top);
+			while (*top + (1U << o) > end)
+				o--;
+			blk_free(dp, leaf, *top, o);
+			*top += 1U << o;
+		}
+		return blk_get(dp, leaf, order);
+	}
+
+	if (*top + (1U << order) > num)
+		return POPTRIE_INVALID_IDX;
+	idx = *top;
+	*top += 1U << order;
+	return idx;
+}
+
+static int
+blk_track(uint64_t **list, uint32_t *nb, uint32_t *sz, uint64_t blk)
+{
+	uint64_t *tmp;
+
+	if (*nb == *sz) {
+		tmp = realloc(*list, sizeof(*tmp) * RTE_MAX(*sz * 2, 64U));
+		if (tmp == NULL)
+			return -ENOMEM;
+		*list = tmp;
+		*sz = RTE_MAX(*sz * 2, 64U);
+	}
+	(*list)[(*nb)++] = blk;
+	return 0;
+}
+
+static int
+blk_alloc(struct poptrie_upd *upd, bool leaf, uint32_t n, uint32_t *idx)
+{
+	struct poptrie_tbl *dp = upd->dp;
+	uint8_t order = blk_order(n);
+	int ret;
+
+	*idx = blk_get(dp, leaf, order);
+
+	/* If there are no free blocks try to reclaim some. */
+	if (unlikely(*idx == POPTRIE_INVALID_IDX && dp->dq != NULL &&
+			!rte_rcu_qsbr_dq_reclaim(dp->dq, UINT32_MAX,
+			NULL, NULL, NULL)))
+		*idx = blk_get(dp, leaf, order);
+
+	if (*idx == POPTRIE_INVALID_IDX)
+		return -ENOSPC;
+
+	if (leaf)
+		dp->cur_leaves += 1U << order;
+	else
+		dp->cur_nodes += 1U << order;
+
+	ret = blk_track(&upd->new_blk, &upd->nb_new, &upd->sz_new,
+		BLK(*idx, order, leaf));
+	if (ret != 0) {
+		blk_release(dp, BLK(*idx, order, leaf));
+		return ret;
+	}
+	return 0;
+}
+
+/* Remember a block that has to be freed once the update is visible. */
+static int
+blk_retire(struct poptrie_upd *upd, bool leaf, uint32_t idx, uint32_t n)
+{
+	if (n == 0)
+		return 0;
+	return blk_track(&upd->old_blk, &upd->nb_old, &upd->sz_old,
+		BLK(idx, blk_order(n), leaf));
+}
+
+/* Retire all the blocks hanging from a node unlinked by the update. */
+static int
+retire_subtree(struct poptrie_upd *upd, const struct poptrie_node *node)
+{
+	struct poptrie_tbl *dp = upd->dp;
+	uint32_t i, nb_child = rte_popcount64(node->vector);
+	int ret;
+
+	for (i = 0; i < nb_child; i++) {
+		ret = retire_subtree(upd, &dp->nodes[node->base1 + i]);
+		if (ret != 0)
+			return ret;
+	}
+	ret = blk_retire(upd, false, node->base1, nb_child);
+	if (ret != 0)
+		return ret;
+	return blk_retire(upd, true, node->base0,
+		rte_popcount64(node->leafvec));
+}
+
+static int
+build_node(struct poptrie_upd *upd, const struct poptrie_key *key,
+	uint8_t depth, const struct poptrie_node *old, uint32_t old_nh,
+	struct poptrie_node *res);
+
+/*
+ * Compute the content of the slot covering key/depth.
+ * old_node is the node previously in the slot or NULL if it was a leaf
+ * holding old_nh. On return *res_node is filled when the slot holds
+ * a node, *res_nh otherwise.
+ */
+static int
+build_slot(struct poptrie_upd *upd, const struct poptrie_key *key,
+	uint8_t depth, const struct poptrie_node *old_node, uint32_t old_nh,
+	bool *is_node, struct poptrie_node *res_node, uint32_t *res_nh)
+{
+	struct poptrie_tbl *dp = upd->dp;
+	uint64_t nh;
+	int cover_depth;
+	int ret;
+
+	/* The update only changes the addresses inside the updated prefix. */
+	if (!key_prefix_eq(key, &upd->key, RTE_MIN(depth, upd->depth)))
+		goto reuse;
+
+	nh = dp->ops->cover_nh(dp, key, depth, &cover_depth);
+
+	/* ... which are not covered by a longer route. */
+	if (upd->depth <= depth && cover_depth > upd->depth)
+		goto reuse;
+
+	if (depth < dp->max_depth && dp->ops->has_deeper(dp, key, depth)) {
+		/* reuse the unchanged parts of the old node */
+		ret = build_node(upd, key, depth, old_node, old_nh, res_node);
+		if (ret != 0)
+			return ret;
+		*is_node = true;
+		return 0;
+	}
+
+	if (old_node != NULL) {
+		ret = retire_subtree(upd, old_node);
+		if (ret != 0)
+			return ret;
+	}
+	*is_node = false;
+	*res_nh = nh;
+	return 0;
+
+reuse:
+	*is_node = (old_node != NULL);
+	if (old_node != NULL)
+		*res_node = *old_node;
+	else
+		*res_nh = old_nh;
+	return 0;
+}
+
+/*
+ * Build the node covering key/depth into res.
+ * The slots untouched by the update are taken from old, or all hold
+ * old_nh if the node replaces a leaf.
+ */
+static int
+build_node(struct poptrie_upd *upd, const struct poptrie_key *key,
+	uint8_t depth, const struct poptrie_node *old, uint32_t old_nh,
+	struct poptrie_node *res)
+{
+	struct poptrie_tbl *dp = upd->dp;
+	struct poptrie_node child[POPTRIE_NUM_SLOTS];
+	uint32_t leaf[POPTRIE_NUM_SLOTS];
+	const struct poptrie_node *old_child;
+	struct poptrie_key ckey;
+	uint64_t bit, vector = 0, leafvec = 0;
+	uint32_t nb_child = 0, nb_leaf = 0;
+	uint32_t nh, child_idx = 0, leaf_idx = 0;
+	bool changed = (old == NULL);
+	bool is_node;
+	unsigned int i;
+	int ret;
+
+	for (i = 0; i < POPTRIE_NUM_SLOTS; i++) {
+		bit = 1ULL << i;
+		ckey = *key;
+		key_set_bits(&ckey, depth, POPTRIE_STRIDE, i);
+
+		old_child = NULL;
+		if (old != NULL && (old->vector & bit))
+			old_child = &dp->nodes[old->base1 +
+				poptrie_rank(old->vector, bit)];
+		else if (old != NULL)
+			old_nh = dp->leaves[old->base0 +
+				poptrie_rank(old->leafvec, bit)];
+
+		ret = build_slot(upd, &ckey, depth + POPTRIE_STRIDE, old_child,
+			old_nh, &is_node, &child[nb_child], &nh);
+		if (ret != 0)
+			return ret;
+
+		if (is_node) {
+			if (old_child == NULL || memcmp(&child[nb_child],
+					old_child, sizeof(*old_child)) != 0)
+				changed = true;
+			vector |= bit;
+			nb_child++;
+			continue;
+		}
+
+		if (old_child != NULL || nh != old_nh)
+			changed = true;
+		if (nb_leaf == 0 || leaf[nb_leaf - 1] != nh) {
+			leafvec |= bit;
+			leaf[nb_leaf++] = nh;
+		}
+	}
+
+	if (!changed) {
+		*res = *old;
+		return 0;
+	}
+
+	if (nb_child != 0) {
+		ret = blk_alloc(upd, false, nb_child, &child_idx);
+		if (ret != 0)
+			return ret;
+		memcpy(&dp->nodes[child_idx], child,
+			sizeof(child[0]) * nb_child);
+	}
+	if (nb_leaf != 0) {
+		ret = blk_alloc(upd, true, nb_leaf, &leaf_idx);
+		if (ret != 0)
+			return ret;
+		memcpy(&dp->leaves[leaf_idx], leaf, sizeof(leaf[0]) * nb_leaf);
+	}
+
+	if (old != NULL) {
+		ret = blk_retire(upd, false, old->base1,
+			rte_popcount64(old->vector));
+		if (ret == 0)
+			ret = blk_retire(upd, true, old->base0,
+				rte_popcount64(old->leafvec));
+		if (ret != 0)
+			return ret;
+	}
+
+	res->vector = vector;
+	res->leafvec = leafvec;
+	res->base0 = leaf_idx;
+	res->base1 = child_idx;
+	return 0;
+}
+
+static void
+__rcu_qsbr_free_resource(void *p, void *data, unsigned int n __rte_unused)
+{
+	blk_release(p, *(uint64_t *)data);
+}
+
+/* Release the blocks unlinked by an update that is now visible. */
+static void
+retire_flush(struct poptrie_tbl *dp, struct poptrie_upd *upd)
+{
+	bool synced = false;
+	uint32_t i;
+
+	if (dp->v != NULL && dp->rcu_mode == RTE_FIB_QSBR_MODE_SYNC &&
+			upd->nb_old != 0) {
+		rte_rcu_qsbr_synchronize(dp->v, RTE_QSBR_THRID_INVALID);
+		synced = true;
+	}
+
+	for (i = 0; i < upd->nb_old; i++) {
+		if (dp->v == NULL || synced) {
+			blk_release(dp, upd->old_blk[i]);
+			continue;
+		}
+		/* RTE_FIB_QSBR_MODE_DQ */
+		if (rte_rcu_qsbr_dq_enqueue(dp->dq, &upd->old_blk[i]) == 0)
+			continue;
+		/* the defer queue is full, wait for the readers instead */
+		rte_rcu_qsbr_synchronize(dp->v, RTE_QSBR_THRID_INVALID);
+		synced = true;
+		blk_release(dp, upd->old_blk[i]);
+	}
+}
+
+/*
+ * Bring the dataplane in line with the RIB after the route key/depth
+ * was changed there. On failure the dataplane is left untouched.
+ */
+static int
+poptrie_update(struct poptrie_tbl *dp, const struct poptrie_key *key,
+	uint8_t depth)
+{
+	struct poptrie_upd upd = {
+		.dp = dp,
+		.key = *key,
+		.depth = depth,
+	};
+	const struct poptrie_node *old_node;
+	struct poptrie_node node;
+	struct poptrie_key ekey;
+	uint32_t *ent = NULL;
+	uint32_t first, nb_ent, nh = 0, i;
+	bool is_node;
+	int ret = 0;
+
+	first = key_bits(key, 0, POPTRIE_DIR_BITS);
+	nb_ent = (depth < POPTRIE_DIR_BITS) ?
+		1U << (POPTRIE_DIR_BITS - depth) : 1;
+	ent = malloc(sizeof(*ent) * nb_ent);
+	if (ent == NULL)
+		return -ENOMEM;
+
+	for (i = 0; i < nb_ent; i++) {
+		ent[i] = dp->dir[first + i];
+		old_node = (ent[i] & POPTRIE_NODE_ENT) ?
+			&dp->nodes[ent[i] & ~POPTRIE_NODE_ENT] : NULL;
+
+		memset(&ekey, 0, sizeof(ekey));
+		key_set_bits(&ekey, 0, POPTRIE_DIR_BITS, first + i);
+		ret = build_slot(&upd, &ekey, POPTRIE_DIR_BITS, old_node,
+			ent[i], &is_node, &node, &nh);
+		if (ret != 0)
+			goto err;
+
+		if (!is_node) {
+			if (old_node != NULL)
+				ret = blk_retire(&upd, false,
+					ent[i] & ~POPTRIE_NODE_ENT, 1);
+			ent[i] = nh;
+		} else if (old_node == NULL ||
+				memcmp(&node, old_node, sizeof(node)) != 0) {
+			/* the root node of a direct entry is a block on its own */
+			if (old_node != NULL)
+				ret = blk_retire(&upd, false,
+					ent[i] & ~POPTRIE_NODE_ENT, 1);
+			if (ret == 0)
+				ret = blk_alloc(&upd, false, 1, &nh);
+			if (ret == 0) {
+				dp->nodes[nh] = node;
+				ent[i] = nh | POPTRIE_NODE_ENT;
+			}
+		}
+		if (ret != 0)
+			goto err;
+	}
+
+	/* Make the new nodes visible before the entries pointing to them. */
+	rte_atomic_thread_fence(rte_memory_order_release);
+	for (i = 0; i < nb_ent; i++)
+		dp->dir[first + i] = ent[i];
+
+	retire_flush(dp, &upd);
+	goto out;
+
+err:
+	/* nothing was published, the new blocks can be reused right away */
+	for (i = 0; i < upd.nb_new; i++)
+		blk_release(dp, upd.new_blk[i]);
+out:
+	free(upd.new_blk);
+	free(upd.old_blk);
+	free(ent);
+	return ret;
+}
+
+static inline void
+key_from_ip4(struct poptrie_key *key, uint32_t ip)
+{
+	key->hi = (uint64_t)ip << 32;
+	key->lo = 0;
+}
+
+static uint64_t
+rib4_cover_nh(struct poptrie_tbl *dp, const struct poptrie_key *key,
+	uint8_t depth, int *cover_depth)
+{
+	struct rte_rib_node *node;
+	uint64_t nh;
+	uint8_t d;
+
+	node = rte_rib_lookup(dp->rib, key->hi >> 32);
+	while (node != NULL) {
+		rte_rib_get_depth(node, &d);
+		if (d <= depth) {
+			rte_rib_get_nh(node, &nh);
+			*cover_depth = d;
+			return nh;
+		}
+		node = rte_rib_lookup_parent(node);
+	}
+	*cover_depth = -1;
+	return dp->def_nh;
+}
+
+static bool
+rib4_has_deeper(struct poptrie_tbl *dp, const struct poptrie_key *key,
+	uint8_t depth)
+{
+	return rte_rib_get_nxt(dp->rib, key->hi >> 32, depth, NULL,
+		RTE_RIB_GET_NXT_COVER) != NULL;
+}
+
+static const struct poptrie_rib_ops rib4_ops = {
+	.cover_nh = rib4_cover_nh,
+	.has_deeper = rib4_has_deeper,
+};
+
+static inline void
+key_from_ip6(struct poptrie_key *key, const struct rte_ipv6_addr *ip)
+{
+	memcpy(key, ip, sizeof(*key));
+	key->hi = rte_be_to_cpu_64(key->hi);
+	key->lo = rte_be_to_cpu_64(key->lo);
+}
+
+static inline void
+key_to_ip6(struct rte_ipv6_addr *ip, const struct poptrie_key *key)
+{
+	struct poptrie_key tmp;
+
+	tmp.hi = rte_cpu_to_be_64(key->hi);
+	tmp.lo = rte_cpu_to_be_64(key->lo);
+	memcpy(ip, &tmp, sizeof(*ip));
+}
+
+static uint64_t
+rib6_cover_nh(struct poptrie_tbl *dp, const struct poptrie_key *key,
+	uint8_t depth, int *cover_depth)
+{
+	struct rte_rib6_node *node;
+	struct rte_ipv6_addr ip;
+	uint64_t nh;
+	uint8_t d;
+
+	key_to_ip6(&ip, key);
+	node = rte_rib6_lookup(dp->rib, &ip);
+	while (node != NULL) {
+		rte_rib6_get_depth(node, &d);
+		if (d <= depth) {
+			rte_rib6_get_nh(node, &nh);
+			*cover_depth = d;
+			return nh;
+		}
+		node = rte_rib6_lookup_parent(node);
+	}
+	*cover_depth = -1;
+	return dp->def_nh;
+}
+
+static bool
+rib6_has_deeper(struct poptrie_tbl *dp, const struct poptrie_key *key,
+	uint8_t depth)
+{
+	struct rte_ipv6_addr ip;
+
+	key_to_ip6(&ip, key);
+	return rte_rib6_get_nxt(dp->rib, &ip, depth, NULL,
+		RTE_RIB6_GET_NXT_COVER) != NULL;
+}
+
+static const struct poptrie_rib_ops rib6_ops = {
+	.cover_nh = rib6_cover_nh,
+	.has_deeper = rib6_has_deeper,
+};
+
+int
+poptrie_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
+	uint64_t next_hop, int op)
+{
+	struct poptrie_tbl *dp;
+	struct rte_rib *rib;
+	struct rte_rib_node *node;
+	struct poptrie_key key;
+	uint64_t node_nh;
+	int ret;
+
+	if ((fib == NULL) || (depth > RTE_FIB_MAXDEPTH))
+		return -EINVAL;
+
+	dp = rte_fib_get_dp(fib);
+	rib = rte_fib_get_rib(fib);
+	RTE_ASSERT((dp != NULL) && (rib != NULL));
+
+	if (next_hop > POPTRIE_MAX_NH)
+		return -EINVAL;
+
+	ip &= rte_rib_depth_to_mask(depth);
+	key_from_ip4(&key, ip);
+
+	node = rte_rib_lookup_exact(rib, ip, depth);
+	switch (op) {
+	case RTE_FIB_ADD:
+		if (node != NULL) {
+			rte_rib_get_nh(node, &node_nh);
+			if (node_nh == next_hop)
+				return 0;
+			rte_rib_set_nh(node, next_hop);
+			ret = poptrie_update(dp, &key, depth);
+			if (ret != 0)
+				rte_rib_set_nh(node, node_nh);
+			return ret;
+		}
+		node = rte_rib_insert(rib, ip, depth);
+		if (node == NULL)
+			return -rte_errno;
+		rte_rib_set_nh(node, next_hop);
+		ret = poptrie_update(dp, &key, depth);
+		if (ret != 0)
+			rte_rib_remove(rib, ip, depth);
+		return ret;
+	case RTE_FIB_DEL:
+		if (node == NULL)
+			return -ENOENT;
+		rte_rib_get_nh(node, &node_nh);
+		rte_rib_remove(rib, ip, depth);
+		ret = poptrie_update(dp, &key, depth);
+		if (ret != 0) {
+			node = rte_rib_insert(rib, ip, depth);
+			if (node != NULL)
+				rte_rib_set_nh(node, node_nh);
+		}
+		return ret;
+	default:
+		break;
+	}
+	return -EINVAL;
+}
+
+int
+poptrie6_modify(struct rte_fib6 *fib, const struct rte_ipv6_addr *ip,
+	uint8_t depth, uint64_t next_hop, int op)
+{
+	struct poptrie_tbl *dp;
+	struct rte_rib6 *rib;
+	struct rte_rib6_node *node;
+	struct rte_ipv6_addr ip_masked;
+	struct poptrie_key key;
+	uint64_t node_nh;
+	int ret;
+
+	if ((fib == NULL) || (ip == NULL) || (depth > RTE_IPV6_MAX_DEPTH))
+		return -EINVAL;
+
+	dp = rte_fib6_get_dp(fib);
+	rib = rte_fib6_get_rib(fib);
+	RTE_ASSERT((dp != NULL) && (rib != NULL));
+
+	if (next_hop > POPTRIE_MAX_NH)
+		return -EINVAL;
+
+	ip_masked = *ip;
+	rte_ipv6_addr_mask(&ip_masked, depth);
+	key_from_ip6(&key, &ip_masked);
+
+	node = rte_rib6_lookup_exact(rib, &ip_masked, depth);
+	switch (op) {
+	case RTE_FIB6_ADD:
+		if (node != NULL) {
+			rte_rib6_get_nh(node, &node_nh);
+			if (node_nh == next_hop)
+				return 0;
+			rte_rib6_set_nh(node, next_hop);
+			ret = poptrie_update(dp, &key, depth);
+			if (ret != 0)
+				rte_rib6_set_nh(node, node_nh);
+			return ret;
+		}
+		node = rte_rib6_insert(rib, &ip_masked, depth);
+		if (node == NULL)
+			return -rte_errno;
+		rte_rib6_set_nh(node, next_hop);
+		ret = poptrie_update(dp, &key, depth);
+		if (ret != 0)
+			rte_rib6_remove(rib, &ip_masked, depth);
+		return ret;
+	case RTE_FIB6_DEL:
+		if (node == NULL)
+			return -ENOENT;
+		rte_rib6_get_nh(node, &node_nh);
+		rte_rib6_remove(rib, &ip_masked, depth);
+		ret = poptrie_update(dp, &key, depth);
+		if (ret != 0) {
+			node = rte_rib6_insert(rib, &ip_masked, depth);
+			if (node != NULL)
+				rte_rib6_set_nh(node, node_nh);
+		}
+		return ret;
+	default:
+		break;
+	}
+	return -EINVAL;
+}
+
+/* Allocate the free block bitmaps of every order for n entries. */
+static void
+free_maps_create(const char *name, int socket_id, uint32_t n,
+	uint64_t *map[POPTRIE_NUM_ORDERS])
+{
+	uint64_t *mem;
+	uint32_t nb_slabs = 0;
+	unsigned int i;
+
+	for (i = 0; i < POPTRIE_NUM_ORDERS; i++)
+		nb_slabs += blk_nb_slabs(n, i);
+	mem = rte_zmalloc_socket(name, sizeof(uint64_t) * nb_slabs,
+		RTE_CACHE_LINE_SIZE, socket_id);
+	if (mem == NULL)
+		return;
+
+	for (i = 0, nb_slabs = 0; i < POPTRIE_NUM_ORDERS; i++) {
+		map[i] = mem + nb_slabs;
+		nb_slabs += blk_nb_slabs(n, i);
+	}
+}
+
+static struct poptrie_tbl *
+tbl_create(const char *name, int socket_id, uint64_t def_nh,
+	uint32_t num_nodes, uint32_t num_leaves)
+{
+	char mem_name[POPTRIE_NAMESIZE];
+	struct poptrie_tbl *dp;
+	unsigned int i;
+
+	if (def_nh > POPTRIE_MAX_NH) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	snprintf(mem_name, sizeof(mem_name), "DP_%s", name);
+	dp = rte_zmalloc_socket(mem_name, sizeof(struct poptrie_tbl),
+		RTE_CACHE_LINE_SIZE, socket_id);
+	if (dp == NULL) {
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	snprintf(mem_name, sizeof(mem_name), "POPTRIE_NODES_%p", dp);
+	dp->nodes = rte_zmalloc_socket(mem_name,
+		sizeof(struct poptrie_node) * num_nodes,
+		RTE_CACHE_LINE_SIZE, socket_id);
+	snprintf(mem_name, sizeof(mem_name), "POPTRIE_LEAVES_%p", dp);
+	dp->leaves = rte_zmalloc_socket(mem_name,
+		sizeof(uint32_t) * num_leaves,
+		RTE_CACHE_LINE_SIZE, socket_id);
+	snprintf(mem_name, sizeof(mem_name), "POPTRIE_NODE_FREE_%p", dp);
+	free_maps_create(mem_name, socket_id, num_nodes, dp->node_free);
+	snprintf(mem_name, sizeof(mem_name), "POPTRIE_LEAF_FREE_%p", dp);
+	free_maps_create(mem_name, socket_id, num_leaves, dp->leaf_free);
+	if (dp->nodes == NULL || dp->leaves == NULL ||
+			dp->node_free[0] == NULL || dp->leaf_free[0] == NULL) {
+		rte_errno = ENOMEM;
+		rte_free(dp->node_free[0]);
+		rte_free(dp->leaf_free[0]);
+		rte_free(dp->nodes);
+		rte_free(dp->leaves);
+		rte_free(dp);
+		return NULL;
+	}
+
+	for (i = 0; i < POPTRIE_DIR_NUM_ENT; i++)
+		dp->dir[i] = def_nh;
+
+	dp->num_nodes = num_nodes;
+	dp->num_leaves = num_leaves;
+	dp->def_nh = def_nh;
+	return dp;
+}
+
+void *
+poptrie_create(const char *name, int socket_id, struct rte_fib_conf *conf,
+	struct rte_rib *rib)
+{
+	struct poptrie_tbl *dp;
+	uint64_t num_nodes, num_leaves;
+
+	if ((name == NULL) || (conf == NULL) || (rib == NULL)) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	num_nodes = conf->poptrie.num_nodes;
+	if (num_nodes == 0)
+		num_nodes = RTE_MAX(2ULL * conf->max_routes,
+			(uint64_t)POPTRIE_NUM_SLOTS);
+	num_leaves = conf->poptrie.num_leaves;
+	if (num_leaves == 0)
+		num_leaves = RTE_MAX(8ULL * conf->max_routes,
+			(uint64_t)POPTRIE_NUM_SLOTS);
+
+	dp = tbl_create(name, socket_id, conf->default_nh,
+		RTE_MIN(num_nodes, (uint64_t)POPTRIE_MAX_NH),
+		RTE_MIN(num_leaves, (uint64_t)POPTRIE_MAX_NH));
+	if (dp == NULL)
+		return NULL;
+
+	dp->max_depth = RTE_FIB_MAXDEPTH;
+	dp->rib = rib;
+	dp->ops = &rib4_ops;
+	return dp;
+}
+
+void *
+poptrie6_create(const char *name, int socket_id, struct rte_fib6_conf *conf,
+	struct rte_rib6 *rib)
+{
+	struct poptrie_tbl *dp;
+	uint64_t num_nodes, num_leaves;
+
+	if ((name == NULL) || (conf == NULL) || (rib == NULL)) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	num_nodes = conf->poptrie.num_nodes;
+	if (num_nodes == 0)
+		num_nodes = RTE_MAX(8ULL * conf->max_routes,
+			(uint64_t)POPTRIE_NUM_SLOTS);
+	num_leaves = conf->poptrie.num_leaves;
+	if (num_leaves == 0)
+		num_leaves = RTE_MAX(16ULL * conf->max_routes,
+			(uint64_t)POPTRIE_NUM_SLOTS);
+
+	dp = tbl_create(name, socket_id, conf->default_nh,
+		RTE_MIN(num_nodes, (uint64_t)POPTRIE_MAX_NH),
+		RTE_MIN(num_leaves, (uint64_t)POPTRIE_MAX_NH));
+	if (dp == NULL)
+		return NULL;
+
+	dp->max_depth = RTE_IPV6_MAX_DEPTH;
+	dp->rib = rib;
+	dp->ops = &rib6_ops;
+	return dp;
+}
+
+void
+poptrie_free(void *p)
+{
+	struct poptrie_tbl *dp = (struct poptrie_tbl *)p;
+
+	rte_rcu_qsbr_dq_delete(dp->dq);
+	rte_free(dp->leaf_free[0]);
+	rte_free(dp->node_free[0]);
+	rte_free(dp->leaves);
+	rte_free(dp->nodes);
+	rte_free(dp);
+}
+
+int
+poptrie_rcu_qsbr_add(struct poptrie_tbl *dp, struct rte_fib_rcu_config *cfg,
+	const char *name)
+{
+	struct rte_rcu_qsbr_dq_parameters params = {0};
+	char rcu_dq_name[RTE_RCU_QSBR_DQ_NAMESIZE];
+
+	if (dp == NULL || cfg == NULL)
+		return -EINVAL;
+
+	if (dp->v != NULL)
+		return -EEXIST;
+
+	if (cfg->mode == RTE_FIB_QSBR_MODE_SYNC) {
+		/* No other things to do. */
+	} else if (cfg->mode == RTE_FIB_QSBR_MODE_DQ) {
+		/* Init QSBR defer queue. */
+		snprintf(rcu_dq_name, sizeof(rcu_dq_name),
+				"FIB_RCU_%s", name);
+		params.name = rcu_dq_name;
+		params.size = cfg->dq_size;
+		if (params.size == 0)
+			params.size = RTE_FIB_RCU_DQ_RECLAIM_SZ;
+		params.trigger_reclaim_limit = cfg->reclaim_thd;
+		params.max_reclaim_size = cfg->reclaim_max;
+		if (params.max_reclaim_size == 0)
+			params.max_reclaim_size = RTE_FIB_RCU_DQ_RECLAIM_MAX;
+		params.esize = sizeof(uint64_t);
+		params.free_fn = __rcu_qsbr_free_resource;
+		params.p = dp;
+		params.v = cfg->v;
+		dp->dq = rte_rcu_qsbr_dq_create(&params);
+		if (dp->dq == NULL) {
+			FIB_LOG(ERR, "FIB defer queue creation failed");
+			return -rte_errno;
+		}
+	} else {
+		return -EINVAL;
+	}
+
+	dp->rcu_mode = cfg->mode;
+	dp->v = cfg->v;
+
+	return 0;
+}
@@ -0,0 +1,203 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 The DPDK contributors
+ */
+
+#ifndef _POPTRIE_H_
+#define _POPTRIE_H_
+
+#include <stdalign.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <rte_bitops.h>
+#include <rte_byteorder.h>
+#include <rte_common.h>
+#include <rte_fib.h>
+#include <rte_fib6.h>
+#include <rte_rcu_qsbr.h>
+
+/**
+ * @file
+ * Poptrie: multibit trie with bitmap compressed nodes.
+ *
+ * The most significant POPTRIE_DIR_BITS bits of the address index
+ * a direct table. Every following level consumes POPTRIE_STRIDE bits
+ * and is made of nodes holding two 64 bit maps: "vector" marks the
+ * slots pointing to a child node, "leafvec" marks the slots starting
+ * a run of identical next hops. The children of a node and its leaves
+ * are stored contiguously, so a slot is found by counting the bits set
+ * before it.
+ */
+
+#define POPTRIE_DIR_BITS	14
+#define POPTRIE_DIR_NUM_ENT	(1 << POPTRIE_DIR_BITS)
+#define POPTRIE_STRIDE		6
+#define POPTRIE_NUM_SLOTS	(1 << POPTRIE_STRIDE)
+#define POPTRIE_SLOT_MASK	(POPTRIE_NUM_SLOTS - 1)
+/* direct table entry pointing to a node rather than holding a next hop */
+#define POPTRIE_NODE_ENT	(1U << 31)
+#define POPTRIE_MAX_NH		((uint64_t)POPTRIE_NODE_ENT - 1)
+/* block sizes are powers of two from 1 to POPTRIE_NUM_SLOTS */
+#define POPTRIE_NUM_ORDERS	(POPTRIE_STRIDE + 1)
+#define POPTRIE_INVALID_IDX	UINT32_MAX
+
+struct poptrie_node {
+	uint64_t	vector;		/**< slots pointing to a node */
+	uint64_t	leafvec;	/**< slots starting a run of leaves */
+	uint32_t	base0;		/**< index of the first leaf */
+	uint32_t	base1;		/**< index of the first child node */
+};
+
+/* Address as a 128 bit value, most significant bit first. */
+struct poptrie_key {
+	uint64_t	hi;
+	uint64_t	lo;
+};
+
+struct poptrie_tbl;
+
+/* Address family specific RIB accessors used by the update code. */
+struct poptrie_rib_ops {
+	/*
+	 * next hop of the longest route covering the whole prefix,
+	 * the depth of that route or -1 is returned in cover_depth
+	 */
+	uint64_t (*cover_nh)(struct poptrie_tbl *dp,
+		const struct poptrie_key *key, uint8_t depth, int *cover_depth);
+	/* whether the RIB holds routes longer than the prefix inside it */
+	bool (*has_deeper)(struct poptrie_tbl *dp,
+		const struct poptrie_key *key, uint8_t depth);
+};
+
+struct poptrie_tbl {
+	uint32_t	num_nodes;	/**< Size of the node array */
+	uint32_t	num_leaves;	/**< Size of the leaf array */
+	uint32_t	cur_nodes;	/**< Number of nodes in use */
+	uint32_t	cur_leaves;	/**< Number of leaves in use */
+	uint32_t	node_top;	/**< First never used node */
+	uint32_t	leaf_top;	/**< First never used leaf */
+	/* free blocks of every size, one bit per block aligned on its size */
+	uint64_t	*node_free[POPTRIE_NUM_ORDERS];
+	uint64_t	*leaf_free[POPTRIE_NUM_ORDERS];
+	/* first bitmap slab of every size which may have a free block */
+	uint32_t	node_hint[POPTRIE_NUM_ORDERS];
+	uint32_t	leaf_hint[POPTRIE_NUM_ORDERS];
+	uint8_t		max_depth;	/**< 32 or 128 */
+	uint64_t	def_nh;		/**< Default next hop */
+	void		*rib;		/**< RIB of the owning FIB */
+	const struct poptrie_rib_ops *ops;
+	/* RCU config. */
+	int		rcu_mode;	/* Blocking, defer queue. */
+	struct rte_rcu_qsbr *v;		/* RCU QSBR variable. */
+	struct rte_rcu_qsbr_dq *dq;	/* RCU QSBR defer queue. */
+	struct poptrie_node *nodes;	/**< Node array */
+	uint32_t	*leaves;	/**< Leaf array */
+	/* Direct table. */
+	alignas(RTE_CACHE_LINE_SIZE) uint32_t	dir[POPTRIE_DIR_NUM_ENT];
+};
+
+/* Rank of the slot bit among the bits set up to it, minus one. */
+static inline uint32_t
+poptrie_rank(uint64_t map, uint64_t bit)
+{
+	return rte_popcount64(map & ((bit << 1) - 1)) - 1;
+}
+
+/* Walk the nodes from a direct table entry. */
+static inline uint32_t
+poptrie_walk(const struct poptrie_tbl *dp, uint32_t ent,
+	const struct poptrie_key *key)
+{
+	const struct poptrie_node *node;
+	unsigned int pos = POPTRIE_DIR_BITS;
+	uint64_t bit;
+	uint32_t slot;
+
+	node = &dp->nodes[ent & ~POPTRIE_NODE_ENT];
+	for (;;) {
+		if (pos + POPTRIE_STRIDE <= 64)
+			slot = key->hi >> (64 - POPTRIE_STRIDE - pos);
+		else if (pos >= 64)
+			slot = key->lo >> (128 - POPTRIE_STRIDE - pos);
+		else
+			slot = (key->hi << (pos + POPTRIE_STRIDE - 64)) |
+				(key->lo >> (128 - POPTRIE_STRIDE - pos));
+		bit = 1ULL << (slot & POPTRIE_SLOT_MASK);
+		if ((node->vector & bit) == 0)
+			return dp->leaves[node->base0 +
+				poptrie_rank(node->leafvec, bit)];
+		node = &dp->nodes[node->base1 + poptrie_rank(node->vector, bit)];
+		pos += POPTRIE_STRIDE;
+	}
+}
+
+static inline uint32_t
+poptrie_lookup4(const struct poptrie_tbl *dp, uint32_t ip)
+{
+	const struct poptrie_node *node;
+	unsigned int shift = 32 - POPTRIE_DIR_BITS;
+	uint32_t ent;
+	uint64_t bit;
+
+	ent = dp->dir[ip >> shift];
+	if ((ent & POPTRIE_NODE_ENT) == 0)
+		return ent;
+
+	node = &dp->nodes[ent & ~POPTRIE_NODE_ENT];
+	for (;;) {
+		shift -= POPTRIE_STRIDE;
+		bit = 1ULL << ((ip >> shift) & POPTRIE_SLOT_MASK);
+		if ((node->vector & bit) == 0)
+			return dp->leaves[node->base0 +
+				poptrie_rank(node->leafvec, bit)];
+		node = &dp->nodes[node->base1 + poptrie_rank(node->vector, bit)];
+	}
+}
+
+static inline uint32_t
+poptrie_lookup6(const struct poptrie_tbl *dp, const struct rte_ipv6_addr *ip)
+{
+	struct poptrie_key key;
+	uint32_t ent;
+
+	memcpy(&key, ip, sizeof(key));
+	key.hi = rte_be_to_cpu_64(key.hi);
+	ent = dp->dir[key.hi >> (64 - POPTRIE_DIR_BITS)];
+	if ((ent & POPTRIE_NODE_ENT) == 0)
+		return ent;
+
+	key.lo = rte_be_to_cpu_64(key.lo);
+	return poptrie_walk(dp, ent, &key);
+}
+
+void *
+poptrie_create(const char *name, int socket_id, struct rte_fib_conf *conf,
+	struct rte_rib *rib);
+
+void *
+poptrie6_create(const char *name, int socket_id, struct rte_fib6_conf *conf,
+	struct rte_rib6 *rib);
+
+void
+poptrie_free(void *p);
+
+rte_fib_lookup_fn_t
+poptrie_get_lookup_fn(void *p, enum rte_fib_lookup_type type, bool be_addr);
+
+rte_fib6_lookup_fn_t
+poptrie6_get_lookup_fn(void *p, enum rte_fib6_lookup_type type);
+
+int
+poptrie_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
+	uint64_t next_hop, int op);
+
+int
+poptrie6_modify(struct rte_fib6 *fib, const struct rte_ipv6_addr *ip,
+	uint8_t depth, uint64_t next_hop, int op);
+
+int
+poptrie_rcu_qsbr_add(struct poptrie_tbl *dp, struct rte_fib_rcu_config *cfg,
+	const char *name);
+
+#endif /* _POPTRIE_H_ */
@@ -0,0 +1,114 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 The DPDK contributors
+ */
+
+#include <rte_vect.h>
+#include <rte_fib.h>
+
+#include "poptrie.h"
+#include "poptrie_avx512.h"
+
+/* Offsets of the node fields in 8 byte units. */
+#define NODE_VECTOR_OFF		0
+#define NODE_LEAFVEC_OFF	1
+#define NODE_BASE_OFF		2
+
+static __rte_always_inline void
+poptrie_vec_lookup_x8(void *p, const uint32_t *ips,
+	uint64_t *next_hops, bool be_addr)
+{
+	const struct poptrie_tbl *dp = (struct poptrie_tbl *)p;
+	const uint64_t *nodes = (const uint64_t *)dp->nodes;
+	const __m512i one = _mm512_set1_epi64(1);
+	const __m512i slot_msk = _mm512_set1_epi64(POPTRIE_SLOT_MASK);
+	const __m512i base_msk = _mm512_set1_epi64(UINT32_MAX);
+	const __m512i node_ent = _mm512_set1_epi64(POPTRIE_NODE_ENT);
+	const __m512i zero = _mm512_setzero_si512();
+	__m512i ip_vec, res, idxes, vector, leafvec, base, bit, below, rank;
+	__m256i ip_256, nh_256;
+	__mmask8 msk_node, msk_child;
+	unsigned int shift = 32 - POPTRIE_DIR_BITS;
+
+	ip_256 = _mm256_loadu_si256((const void *)ips);
+	if (be_addr) {
+		const __m256i bswap32 = _mm256_set_epi8(
+			12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+			12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3
+		);
+		ip_256 = _mm256_shuffle_epi8(ip_256, bswap32);
+	}
+	ip_vec = _mm512_cvtepu32_epi64(ip_256);
+
+	/* lookup in the direct table */
+	idxes = _mm512_srli_epi64(ip_vec, shift);
+	res = _mm512_cvtepu32_epi64(_mm512_i64gather_epi32(idxes,
+		(const void *)dp->dir, 4));
+	msk_node = _mm512_test_epi64_mask(res, node_ent);
+	idxes = _mm512_andnot_si512(node_ent, res);
+
+	while (msk_node != 0) {
+		shift -= POPTRIE_STRIDE;
+
+		/* node index to offset in 8 byte units, nodes are 24 bytes */
+		idxes = _mm512_add_epi64(idxes, _mm512_slli_epi64(idxes, 1));
+		vector = _mm512_mask_i64gather_epi64(zero, msk_node, idxes,
+			nodes + NODE_VECTOR_OFF, 8);
+		leafvec = _mm512_mask_i64gather_epi64(zero, msk_node, idxes,
+			nodes + NODE_LEAFVEC_OFF, 8);
+		base = _mm512_mask_i64gather_epi64(zero, msk_node, idxes,
+			nodes + NODE_BASE_OFF, 8);
+
+		/* slot bit and all the bits below it */
+		bit = _mm512_and_si512(_mm512_srl_epi64(ip_vec,
+			_mm_cvtsi32_si128(shift)), slot_msk);
+		bit = _mm512_sllv_epi64(one, bit);
+		below = _mm512_sub_epi64(_mm512_slli_epi64(bit, 1), one);
+
+		msk_child = _mm512_mask_test_epi64_mask(msk_node, vector, bit);
+
+		/* lanes ending in a leaf */
+		rank = _mm512_popcnt_epi64(_mm512_and_si512(leafvec, below));
+		idxes = _mm512_add_epi64(_mm512_and_si512(base, base_msk),
+			_mm512_sub_epi64(rank, one));
+		nh_256 = _mm512_mask_i64gather_epi32(_mm256_setzero_si256(),
+			msk_node & ~msk_child, idxes, (const void *)dp->leaves, 4);
+		res = _mm512_mask_mov_epi64(res, msk_node & ~msk_child,
+			_mm512_cvtepu32_epi64(nh_256));
+
+		/* lanes going down to a child node */
+		rank = _mm512_popcnt_epi64(_mm512_and_si512(vector, below));
+		idxes = _mm512_add_epi64(_mm512_srli_epi64(base, 32),
+			_mm512_sub_epi64(rank, one));
+		msk_node = msk_child;
+	}
+
+	_mm512_storeu_si512(next_hops, res);
+}
+
+void
+rte_poptrie_vec_lookup_bulk(void *p, const uint32_t *ips,
+	uint64_t *next_hops, const unsigned int n)
+{
+	const struct poptrie_tbl *dp = p;
+	uint32_t i;
+
+	for (i = 0; i < (n / 8); i++)
+		poptrie_vec_lookup_x8(p, ips + i * 8, next_hops + i * 8, false);
+
+	for (i = i * 8; i < n; i++)
+		next_hops[i] = poptrie_lookup4(dp, ips[i]);
+}
+
+void
+rte_poptrie_vec_lookup_bulk_be(void *p, const uint32_t *ips,
+	uint64_t *next_hops, const unsigned int n)
+{
+	const struct poptrie_tbl *dp = p;
+	uint32_t i;
+
+	for (i = 0; i < (n / 8); i++)
+		poptrie_vec_lookup_x8(p, ips + i * 8, next_hops + i * 8, true);
+
+	for (i = i * 8; i < n; i++)
+		next_hops[i] = poptrie_lookup4(dp, rte_be_to_cpu_32(ips[i]));
+}
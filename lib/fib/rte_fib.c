@@ -17,6 +17,7 @@
 #include <rte_fib.h>
 
 #include "dir24_8.h"
+#include "poptrie.h"
 #include "fib_log.h"
 
 RTE_LOG_REGISTER_DEFAULT(fib_logtype, INFO);
@@ -44,8 +45,11 @@ struct rte_fib {
 	enum rte_fib_type	type;	/**< Type of FIB struct */
 	unsigned int flags;		/**< Flags */
 	struct rte_rib		*rib;	/**< RIB helper datastructure */
+	struct rte_rib		**vrf_rib; /**< RIBs of all VRFs */
+	uint32_t		nb_vrfs; /**< Number of VRFs */
 	void			*dp;	/**< pointer to the dataplane struct*/
 	rte_fib_lookup_fn_t	lookup;	/**< FIB lookup function */
+	rte_fib_vrf_lookup_fn_t	vrf_lookup; /**< FIB VRF lookup function */
 	rte_fib_modify_fn_t	modify; /**< modify FIB datastructure */
 	uint64_t		def_nh;
 };
@@ -67,35 +71,62 @@ dummy_lookup(void *fib_p, const uint32_t *ips, uint64_t *next_hops,
 	}
 }
 
+static void
+dummy_vrf_lookup(void *fib_p, const uint16_t *vrf_ids, const uint32_t *ips,
+	uint64_t *next_hops, const unsigned int n)
+{
+	unsigned int i;
+	struct rte_fib *fib = fib_p;
+	struct rte_rib_node *node;
+
+	for (i = 0; i < n; i++) {
+		node = rte_rib_lookup(fib->vrf_rib[vrf_ids[i]], ips[i]);
+		if (node != NULL)
+			rte_rib_get_nh(node, &next_hops[i]);
+		else
+			next_hops[i] = fib->def_nh;
+	}
+}
+
 static int
-dummy_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
-	uint64_t next_hop, int op)
+dummy_vrf_modify(struct rte_fib *fib, uint16_t vrf_id, uint32_t ip,
+	uint8_t depth, uint64_t next_hop, int op)
 {
+	struct rte_rib *rib;
 	struct rte_rib_node *node;
-	if ((fib == NULL) || (depth > RTE_FIB_MAXDEPTH))
+	if ((fib == NULL) || (depth > RTE_FIB_MAXDEPTH) ||
+			(vrf_id >= fib->nb_vrfs))
 		return -EINVAL;
 
-	node = rte_rib_lookup_exact(fib->rib, ip, depth);
+	rib = fib->vrf_rib[vrf_id];
+	node = rte_rib_lookup_exact(rib, ip, depth);
 
 	switch (op) {
 	case RTE_FIB_ADD:
 		if (node == NULL)
-			node = rte_rib_insert(fib->rib, ip, depth);
+			node = rte_rib_insert(rib, ip, depth);
 		if (node == NULL)
 			return -rte_errno;
 		return rte_rib_set_nh(node, next_hop);
 	case RTE_FIB_DEL:
 		if (node == NULL)
 			return -ENOENT;
-		rte_rib_remove(fib->rib, ip, depth);
+		rte_rib_remove(rib, ip, depth);
 		return 0;
 	}
 	return -EINVAL;
 }
 
+static int
+dummy_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
+	uint64_t next_hop, int op)
+{
+	return dummy_vrf_modify(fib, 0, ip, depth, next_hop, op);
+}
+
 static int
 init_dataplane(struct rte_fib *fib, __rte_unused int socket_id,
-	struct rte_fib_conf *conf)
+	struct rte_fib_conf *conf, uint32_t nb_vrfs)
 {
 	char dp_name[sizeof(void *)];
 
@@ -104,16 +135,27 @@ init_dataplane(struct rte_fib *fib, __rte_unused int socket_id,
 	case RTE_FIB_DUMMY:
 		fib->dp = fib;
 		fib->lookup = dummy_lookup;
+		fib->vrf_lookup = dummy_vrf_lookup;
 		fib->modify = dummy_modify;
 		return 0;
 	case RTE_FIB_DIR24_8:
-		fib->dp = dir24_8_create(dp_name, socket_id, conf);
+		fib->dp = dir24_8_create(dp_name, socket_id, conf, nb_vrfs);
 		if (fib->dp == NULL)
 			return -rte_errno;
 		fib->lookup = dir24_8_get_lookup_fn(fib->dp,
 			RTE_FIB_LOOKUP_DEFAULT, !!(fib->flags & RTE_FIB_F_LOOKUP_NETWORK_ORDER));
+		fib->vrf_lookup = dir24_8_get_vrf_lookup_fn(fib->dp,
+			RTE_FIB_LOOKUP_DEFAULT, !!(fib->flags & RTE_FIB_F_LOOKUP_NETWORK_ORDER));
 		fib->modify = dir24_8_modify;
 		return 0;
+	case RTE_FIB_POPTRIE:
+		fib->dp = poptrie_create(dp_name, socket_id, conf, fib->rib);
+		if (fib->dp == NULL)
+			return -rte_errno;
+		fib->lookup = poptrie_get_lookup_fn(fib->dp,
+			RTE_FIB_LOOKUP_DEFAULT, !!(fib->flags & RTE_FIB_F_LOOKUP_NETWORK_ORDER));
+		fib->modify = poptrie_modify;
+		return 0;
 	default:
 		return -EINVAL;
 	}
@@ -138,6 +180,66 @@ rte_fib_delete(struct rte_fib *fib, uint32_t ip, uint8_t depth)
 	return fib->modify(fib, ip, depth, 0, RTE_FIB_DEL);
 }
 
+static int
+vrf_modify(struct rte_fib *fib, uint16_t vrf_id, uint32_t ip, uint8_t depth,
+	uint64_t next_hop, int op)
+{
+	if ((fib == NULL) || (fib->modify == NULL) ||
+			(depth > RTE_FIB_MAXDEPTH) || (vrf_id >= fib->nb_vrfs))
+		return -EINVAL;
+
+	switch (fib->type) {
+	case RTE_FIB_DUMMY:
+		return dummy_vrf_modify(fib, vrf_id, ip, depth, next_hop, op);
+	case RTE_FIB_DIR24_8:
+		return dir24_8_vrf_modify(fib, vrf_id, ip, depth, next_hop, op);
+	default:
+		/* single VRF */
+		return fib->modify(fib, ip, depth, next_hop, op);
+	}
+}
+
+int
+rte_fib_vrf_add(struct rte_fib *fib, uint16_t vrf_id, uint32_t ip,
+	uint8_t depth, uint64_t next_hop)
+{
+	return vrf_modify(fib, vrf_id, ip, depth, next_hop, RTE_FIB_ADD);
+}
+
+int
+rte_fib_vrf_delete(struct rte_fib *fib, uint16_t vrf_id, uint32_t ip,
+	uint8_t depth)
+{
+	return vrf_modify(fib, vrf_id, ip, depth, 0, RTE_FIB_DEL);
+}
+
+int
+rte_fib_modify_bulk(struct rte_fib *fib, const struct rte_fib_route_op *ops,
+	unsigned int n)
+{
+	unsigned int i;
+	int ret;
+
+	if ((fib == NULL) || (fib->modify == NULL) ||
+			((ops == NULL) && (n != 0)))
+		return -EINVAL;
+
+	switch (fib->type) {
+	case RTE_FIB_DIR24_8:
+		return dir24_8_modify_bulk(fib, ops, n);
+	default:
+		for (i = 0; i != n; i++) {
+			ret = fib->modify(fib, ops[i].ip, ops[i].depth,
+				ops[i].next_hop, ops[i].op);
+			if (ret != 0) {
+				rte_errno = -ret;
+				break;
+			}
+		}
+		return i;
+	}
+}
+
 int
 rte_fib_lookup_bulk(struct rte_fib *fib, uint32_t *ips,
 	uint64_t *next_hops, int n)
@@ -149,21 +251,43 @@ rte_fib_lookup_bulk(struct rte_fib *fib, uint32_t *ips,
 	return 0;
 }
 
-struct rte_fib *
-rte_fib_create(const char *name, int socket_id, struct rte_fib_conf *conf)
+int
+rte_fib_vrf_lookup_bulk(struct rte_fib *fib, const uint16_t *vrf_ids,
+	uint32_t *ips, uint64_t *next_hops, int n)
+{
+	FIB_RETURN_IF_TRUE(((fib == NULL) || (vrf_ids == NULL) ||
+		(ips == NULL) || (next_hops == NULL) ||
+		(fib->lookup == NULL)), -EINVAL);
+
+	/* dataplanes without VRF support only have VRF 0 */
+	if (fib->vrf_lookup == NULL)
+		fib->lookup(fib->dp, ips, next_hops, n);
+	else
+		fib->vrf_lookup(fib->dp, vrf_ids, ips, next_hops, n);
+	return 0;
+}
+
+static struct rte_fib *
+fib_create(const char *name, int socket_id, struct rte_fib_conf *conf,
+	uint32_t nb_vrfs)
 {
 	char mem_name[RTE_FIB_NAMESIZE];
 	int ret;
 	struct rte_fib *fib = NULL;
 	struct rte_rib *rib = NULL;
+	struct rte_rib **vrf_rib;
 	struct rte_tailq_entry *te;
 	struct rte_fib_list *fib_list;
 	struct rte_rib_conf rib_conf;
+	uint32_t i;
 
 	/* Check user arguments. */
 	if ((name == NULL) || (conf == NULL) ||	(conf->max_routes < 0) ||
 			(conf->flags & ~RTE_FIB_ALLOWED_FLAGS) ||
-			(conf->type > RTE_FIB_DIR24_8)) {
+			(conf->type > RTE_FIB_POPTRIE) ||
+			(nb_vrfs == 0) || (nb_vrfs > RTE_FIB_MAX_VRFS) ||
+			((nb_vrfs > 1) && (conf->type != RTE_FIB_DUMMY) &&
+			(conf->type != RTE_FIB_DIR24_8))) {
 		rte_errno = EINVAL;
 		return NULL;
 	}
@@ -178,6 +302,25 @@ rte_fib_create(const char *name, int socket_id, struct rte_fib_conf *conf)
 		return NULL;
 	}
 
+	vrf_rib = rte_zmalloc_socket("FIB_VRF_RIB", sizeof(*vrf_rib) * nb_vrfs,
+		0, socket_id);
+	if (vrf_rib == NULL) {
+		FIB_LOG(ERR, "Can not allocate VRF RIBs for FIB %s", name);
+		rte_errno = ENOMEM;
+		rte_rib_free(rib);
+		return NULL;
+	}
+	vrf_rib[0] = rib;
+	for (i = 1; i < nb_vrfs; i++) {
+		snprintf(mem_name, sizeof(mem_name), "VRF%u_%p", i, vrf_rib);
+		vrf_rib[i] = rte_rib_create(mem_name, socket_id, &rib_conf);
+		if (vrf_rib[i] == NULL) {
+			FIB_LOG(ERR, "Can not allocate RIB of VRF %u for FIB %s",
+				i, name);
+			goto free_rib;
+		}
+	}
+
 	snprintf(mem_name, sizeof(mem_name), "FIB_%s", name);
 	fib_list = RTE_TAILQ_CAST(rte_fib_tailq.head, rte_fib_list);
 
@@ -215,10 +358,12 @@ rte_fib_create(const char *name, int socket_id, struct rte_fib_conf *conf)
 
 	rte_strlcpy(fib->name, name, sizeof(fib->name));
 	fib->rib = rib;
+	fib->vrf_rib = vrf_rib;
+	fib->nb_vrfs = nb_vrfs;
 	fib->type = conf->type;
 	fib->flags = conf->flags;
 	fib->def_nh = conf->default_nh;
-	ret = init_dataplane(fib, socket_id, conf);
+	ret = init_dataplane(fib, socket_id, conf, nb_vrfs);
 	if (ret < 0) {
 		FIB_LOG(ERR,
 			"FIB dataplane struct %s memory allocation failed "
@@ -240,11 +385,27 @@ rte_fib_create(const char *name, int socket_id, struct rte_fib_conf *conf)
 	rte_free(te);
 exit:
 	rte_mcfg_tailq_write_unlock();
-	rte_rib_free(rib);
+free_rib:
+	for (i = 0; i < nb_vrfs; i++)
+		rte_rib_free(vrf_rib[i]);
+	rte_free(vrf_rib);
 
 	return NULL;
 }
 
+struct rte_fib *
+rte_fib_create(const char *name, int socket_id, struct rte_fib_conf *conf)
+{
+	return fib_create(name, socket_id, conf, 1);
+}
+
+struct rte_fib *
+rte_fib_vrf_create(const char *name, int socket_id, struct rte_fib_conf *conf,
+	unsigned int max_vrfs)
+{
+	return fib_create(name, socket_id, conf, max_vrfs);
+}
+
 struct rte_fib *
 rte_fib_find_existing(const char *name)
 {
@@ -278,6 +439,10 @@ free_dataplane(struct rte_fib *fib)
 		return;
 	case RTE_FIB_DIR24_8:
 		dir24_8_free(fib->dp);
+		return;
+	case RTE_FIB_POPTRIE:
+		poptrie_free(fib->dp);
+		return;
 	default:
 		return;
 	}
@@ -288,6 +453,7 @@ rte_fib_free(struct rte_fib *fib)
 {
 	struct rte_tailq_entry *te;
 	struct rte_fib_list *fib_list;
+	uint32_t i;
 
 	if (fib == NULL)
 		return;
@@ -307,7 +473,9 @@ rte_fib_free(struct rte_fib *fib)
 	rte_mcfg_tailq_write_unlock();
 
 	free_dataplane(fib);
-	rte_rib_free(fib->rib);
+	for (i = 0; i < fib->nb_vrfs; i++)
+		rte_rib_free(fib->vrf_rib[i]);
+	rte_free(fib->vrf_rib);
 	rte_free(fib);
 	rte_free(te);
 }
@@ -324,16 +492,35 @@ rte_fib_get_rib(struct rte_fib *fib)
 	return (fib == NULL) ? NULL : fib->rib;
 }
 
+struct rte_rib *
+rte_fib_vrf_get_rib(struct rte_fib *fib, uint16_t vrf_id)
+{
+	if ((fib == NULL) || (vrf_id >= fib->nb_vrfs))
+		return NULL;
+	return fib->vrf_rib[vrf_id];
+}
+
 int
 rte_fib_select_lookup(struct rte_fib *fib,
 	enum rte_fib_lookup_type type)
 {
 	rte_fib_lookup_fn_t fn;
+	rte_fib_vrf_lookup_fn_t vrf_fn;
 
 	switch (fib->type) {
 	case RTE_FIB_DIR24_8:
 		fn = dir24_8_get_lookup_fn(fib->dp, type,
 			!!(fib->flags & RTE_FIB_F_LOOKUP_NETWORK_ORDER));
+		vrf_fn = dir24_8_get_vrf_lookup_fn(fib->dp, type,
+			!!(fib->flags & RTE_FIB_F_LOOKUP_NETWORK_ORDER));
+		if ((fn == NULL) || (vrf_fn == NULL))
+			return -EINVAL;
+		fib->lookup = fn;
+		fib->vrf_lookup = vrf_fn;
+		return 0;
+	case RTE_FIB_POPTRIE:
+		fn = poptrie_get_lookup_fn(fib->dp, type,
+			!!(fib->flags & RTE_FIB_F_LOOKUP_NETWORK_ORDER));
 		if (fn == NULL)
 			return -EINVAL;
 		fib->lookup = fn;
@@ -352,6 +539,8 @@ rte_fib_rcu_qsbr_add(struct rte_fib *fib, struct rte_fib_rcu_config *cfg)
 	switch (fib->type) {
 	case RTE_FIB_DIR24_8:
 		return dir24_8_rcu_qsbr_add(fib->dp, cfg, fib->name);
+	case RTE_FIB_POPTRIE:
+		return poptrie_rcu_qsbr_add(fib->dp, cfg, fib->name);
 	default:
 		return -ENOTSUP;
 	}
@@ -29,6 +29,9 @@ struct rte_rib;
 /** Maximum depth value possible for IPv4 FIB. */
 #define RTE_FIB_MAXDEPTH	32
 
+/** Maximum number of VRFs in a FIB. */
+#define RTE_FIB_MAX_VRFS	(UINT16_MAX + 1)
+
 /** @internal Default RCU defer queue entries to reclaim in one go. */
 #define RTE_FIB_RCU_DQ_RECLAIM_MAX	16
 /** @internal Default RCU defer queue size. */
@@ -45,7 +48,8 @@ enum rte_fib_qsbr_mode {
 /** Type of FIB struct */
 enum rte_fib_type {
 	RTE_FIB_DUMMY,		/**< RIB tree based FIB */
-	RTE_FIB_DIR24_8		/**< DIR24_8 based FIB */
+	RTE_FIB_DIR24_8,	/**< DIR24_8 based FIB */
+	RTE_FIB_POPTRIE		/**< Poptrie based FIB */
 };
 
 /** Modify FIB function */
@@ -54,12 +58,23 @@ typedef int (*rte_fib_modify_fn_t)(struct rte_fib *fib, uint32_t ip,
 /** FIB bulk lookup function */
 typedef void (*rte_fib_lookup_fn_t)(void *fib, const uint32_t *ips,
 	uint64_t *next_hops, const unsigned int n);
+/** FIB bulk lookup function for (VRF, IP) pairs */
+typedef void (*rte_fib_vrf_lookup_fn_t)(void *fib, const uint16_t *vrf_ids,
+	const uint32_t *ips, uint64_t *next_hops, const unsigned int n);
 
 enum rte_fib_op {
 	RTE_FIB_ADD,
 	RTE_FIB_DEL,
 };
 
+/** Route operation for rte_fib_modify_bulk() */
+struct rte_fib_route_op {
+	uint32_t	ip;		/**< IPv4 prefix */
+	uint8_t		depth;		/**< Prefix length */
+	uint8_t		op;		/**< RTE_FIB_ADD or RTE_FIB_DEL */
+	uint64_t	next_hop;	/**< Next hop, ignored on delete */
+};
+
 /** Size of nexthop (1 << nh_sz) bits for DIR24_8 based FIB */
 enum rte_fib_dir24_8_nh_sz {
 	RTE_FIB_DIR24_8_1B,
@@ -83,8 +98,12 @@ enum rte_fib_lookup_type {
 	/**<
 	 * Unified lookup function for all next hop sizes
 	 */
-	RTE_FIB_LOOKUP_DIR24_8_VECTOR_AVX512
+	RTE_FIB_LOOKUP_DIR24_8_VECTOR_AVX512,
 	/**< Vector implementation using AVX512 */
+	RTE_FIB_LOOKUP_POPTRIE_SCALAR,
+	/**< Scalar poptrie lookup function */
+	RTE_FIB_LOOKUP_POPTRIE_VECTOR_AVX512
+	/**< Vector poptrie implementation using AVX512 and VPOPCNTDQ */
 };
 
 /** If set, fib lookup is expecting IPv4 address in network byte order */
@@ -104,6 +123,12 @@ struct rte_fib_conf {
 			enum rte_fib_dir24_8_nh_sz nh_sz;
 			uint32_t	num_tbl8;
 		} dir24_8;
+		struct {
+			/** Number of trie nodes, 0 to size it from max_routes */
+			uint32_t	num_nodes;
+			/** Number of leaves, 0 to size it from max_routes */
+			uint32_t	num_leaves;
+		} poptrie;
 	};
 	unsigned int flags; /**< Optional feature flags from RTE_FIB_F_* **/
 };
@@ -278,6 +303,167 @@ __rte_experimental
 int
 rte_fib_rcu_qsbr_add(struct rte_fib *fib, struct rte_fib_rcu_config *cfg);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Add and delete a batch of routes.
+ *
+ * The operations are applied to the RIB in order, then the dataplane
+ * tables are updated once for all of them: every entry affected by the
+ * batch is written a single time with its final next hop, and the tbl8
+ * groups released by the batch are reclaimed through the RCU QSBR
+ * variable associated with the FIB, if any. In blocking mode, a single
+ * grace period is waited for the whole batch.
+ *
+ * Lookups running concurrently with the update can return the next hop
+ * a route had before or after the batch, the same as with a sequence of
+ * rte_fib_add() and rte_fib_delete() calls.
+ *
+ * @param fib
+ *   FIB object handle
+ * @param ops
+ *   Array of route operations
+ * @param n
+ *   Number of operations
+ * @return
+ *   Number of operations applied. If it is less than n, rte_errno is set
+ *   to the error of the first rejected operation and the following ones
+ *   are not applied. The operations before it are applied and visible
+ *   to lookups. Negative value on failure:
+ *   - -EINVAL - invalid parameters
+ *   - -ENOMEM - memory allocation failure
+ *   - -ENOSPC - not enough tbl8 groups to update the dataplane
+ */
+__rte_experimental
+int
+rte_fib_modify_bulk(struct rte_fib *fib, const struct rte_fib_route_op *ops,
+	unsigned int n);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Create FIB holding the routes of several VRFs
+ *
+ * Every VRF has its own routes, max_routes of the configuration
+ * applies to each of them.
+ * Only DUMMY and DIR24_8 types support more than 1 VRF.
+ * rte_fib_create() is the same as creating a FIB with 1 VRF.
+ *
+ * @param name
+ *  FIB name
+ * @param socket_id
+ *  NUMA socket ID for FIB table memory allocation
+ * @param conf
+ *  Structure containing the configuration
+ * @param max_vrfs
+ *  Number of VRFs, from 1 to RTE_FIB_MAX_VRFS
+ * @return
+ *  Handle to the FIB object on success
+ *  NULL otherwise with rte_errno set to an appropriate values.
+ */
+__rte_experimental
+struct rte_fib *
+rte_fib_vrf_create(const char *name, int socket_id, struct rte_fib_conf *conf,
+	unsigned int max_vrfs);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Add a route to a VRF of the FIB.
+ *
+ * rte_fib_add() is the same as adding to VRF 0.
+ *
+ * @param fib
+ *   FIB object handle
+ * @param vrf_id
+ *   VRF ID, lower than the max_vrfs of rte_fib_vrf_create()
+ * @param ip
+ *   IPv4 prefix address to be added to the FIB
+ * @param depth
+ *   Prefix length
+ * @param next_hop
+ *   Next hop to be added to the FIB
+ * @return
+ *   0 on success, negative value otherwise
+ */
+__rte_experimental
+int
+rte_fib_vrf_add(struct rte_fib *fib, uint16_t vrf_id, uint32_t ip,
+	uint8_t depth, uint64_t next_hop);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Delete a rule from a VRF of the FIB.
+ *
+ * @param fib
+ *   FIB object handle
+ * @param vrf_id
+ *   VRF ID, lower than the max_vrfs of rte_fib_vrf_create()
+ * @param ip
+ *   IPv4 prefix address to be deleted from the FIB
+ * @param depth
+ *   Prefix length
+ * @return
+ *   0 on success, negative value otherwise
+ */
+__rte_experimental
+int
+rte_fib_vrf_delete(struct rte_fib *fib, uint16_t vrf_id, uint32_t ip,
+	uint8_t depth);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Lookup multiple (VRF, IP) pairs in the FIB.
+ *
+ * Every address is looked up in the routes of its own VRF.
+ * The VRF IDs are not checked, they must be lower than the max_vrfs
+ * of rte_fib_vrf_create().
+ *
+ * @param fib
+ *   FIB object handle
+ * @param vrf_ids
+ *   Array of VRF IDs of the IPs
+ * @param ips
+ *   Array of IPs to be looked up in the FIB
+ * @param next_hops
+ *   Next hop of the most specific rule found for IP in its VRF.
+ *   If the lookup for the given IP failed, then corresponding element would
+ *   contain default nexthop value configured for a FIB.
+ * @param n
+ *   Number of elements in vrf_ids, ips and next_hops arrays to lookup.
+ * @return
+ *   -EINVAL for incorrect arguments, otherwise 0
+ */
+__rte_experimental
+int
+rte_fib_vrf_lookup_bulk(struct rte_fib *fib, const uint16_t *vrf_ids,
+	uint32_t *ips, uint64_t *next_hops, int n);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get pointer to the RIB of a VRF
+ *
+ * @param fib
+ *   FIB object handle
+ * @param vrf_id
+ *   VRF ID
+ * @return
+ *   Pointer on the RIB on success
+ *   NULL otherwise
+ */
+__rte_experimental
+struct rte_rib *
+rte_fib_vrf_get_rib(struct rte_fib *fib, uint16_t vrf_id);
+
 #ifdef __cplusplus
 }
 #endif
@@ -34,7 +34,8 @@ struct rte_rib6;
 /** Type of FIB struct */
 enum rte_fib6_type {
 	RTE_FIB6_DUMMY,		/**< RIB6 tree based FIB */
-	RTE_FIB6_TRIE		/**< TRIE based fib  */
+	RTE_FIB6_TRIE,		/**< TRIE based fib  */
+	RTE_FIB6_POPTRIE	/**< Poptrie based fib */
 };
 
 /** Modify FIB function */
@@ -63,7 +64,8 @@ enum rte_fib6_lookup_type {
 	RTE_FIB6_LOOKUP_DEFAULT,
 	/**< Selects the best implementation based on the max simd bitwidth */
 	RTE_FIB6_LOOKUP_TRIE_SCALAR, /**< Scalar lookup function implementation*/
-	RTE_FIB6_LOOKUP_TRIE_VECTOR_AVX512 /**< Vector implementation using AVX512 */
+	RTE_FIB6_LOOKUP_TRIE_VECTOR_AVX512, /**< Vector implementation using AVX512 */
+	RTE_FIB6_LOOKUP_POPTRIE_SCALAR /**< Scalar poptrie lookup function */
 };
 
 /** FIB configuration structure */
@@ -79,6 +81,12 @@ struct rte_fib6_conf {
 			enum rte_fib_trie_nh_sz nh_sz;
 			uint32_t	num_tbl8;
 		} trie;
+		struct {
+			/** Number of trie nodes, 0 to size it from max_routes */
+			uint32_t	num_nodes;
+			/** Number of leaves, 0 to size it from max_routes */
+			uint32_t	num_leaves;
+		} poptrie;
 	};
 };
 
@@ -200,7 +200,7 @@ gro_tcp4_reassemble(struct rte_mbuf *pkt,
 				tbl->items[item_start_idx].start_time = 0;
 			return process_tcp_item(pkt, tcp_hdr, tcp_dl, tbl->items,
 						tbl->flows[i].start_index, &tbl->item_num,
-						tbl->max_item_num, ip_id, is_atomic, start_time);
+						tbl->max_item_num, ip_id, is_atomic, start_time, 0);
 		} else {
 			return -1;
 		}
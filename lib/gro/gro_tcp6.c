@@ -210,7 +210,7 @@ gro_tcp6_reassemble(struct rte_mbuf *pkt,
 
 	return process_tcp_item(pkt, tcp_hdr, tcp_dl, tbl->items, tbl->flows[i].start_index,
 						&tbl->item_num, tbl->max_item_num,
-						0, true, start_time);
+						0, true, start_time, 0);
 }
 
 uint16_t
@@ -81,7 +81,8 @@ process_tcp_item(struct rte_mbuf *pkt,
 	uint32_t max_item_num,
 	uint16_t ip_id,
 	uint8_t is_atomic,
-	uint64_t start_time)
+	uint64_t start_time,
+	uint16_t l2_offset)
 {
 	uint32_t cur_idx;
 	uint32_t prev_idx;
@@ -97,11 +98,12 @@ process_tcp_item(struct rte_mbuf *pkt,
 	prev_idx = cur_idx;
 	do {
 		cmp = check_seq_option(&items[cur_idx], tcp_hdr,
-				sent_seq, ip_id, pkt->l4_len, tcp_dl, 0,
+				sent_seq, ip_id, pkt->l4_len, tcp_dl, l2_offset,
 				is_atomic);
 		if (cmp) {
 			if (merge_two_tcp_packets(&items[cur_idx],
-						pkt, cmp, sent_seq, tcp_hdr->tcp_flags, ip_id, 0))
+						pkt, cmp, sent_seq, tcp_hdr->tcp_flags, ip_id,
+						l2_offset))
 				return 1;
 			/*
 			 * Fail to merge the two packets, as the packet
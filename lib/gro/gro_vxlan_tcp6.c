@@ -0,0 +1,380 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 The DPDK contributors
+ */
+
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_ethdev.h>
+#include <rte_udp.h>
+
+#include "gro_vxlan_tcp6.h"
+#include "gro_tcp_internal.h"
+
+/* Fields of the IPv6 version, traffic class and flow label word to match */
+#define VXLAN_TCP6_VTC_FLOW_MASK RTE_BE32(0xF00FFFFF)
+
+void *
+gro_vxlan_tcp6_tbl_create(uint16_t socket_id,
+		uint16_t max_flow_num,
+		uint16_t max_item_per_flow)
+{
+	struct gro_vxlan_tcp6_tbl *tbl;
+	size_t size;
+	uint32_t entries_num, i;
+
+	entries_num = max_flow_num * max_item_per_flow;
+	entries_num = RTE_MIN(entries_num, GRO_VXLAN_TCP6_TBL_MAX_ITEM_NUM);
+
+	if (entries_num == 0)
+		return NULL;
+
+	tbl = rte_zmalloc_socket(__func__,
+			sizeof(struct gro_vxlan_tcp6_tbl),
+			RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if (tbl == NULL)
+		return NULL;
+
+	size = sizeof(struct gro_tcp_item) * entries_num;
+	tbl->items = rte_zmalloc_socket(__func__,
+			size,
+			RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if (tbl->items == NULL) {
+		rte_free(tbl);
+		return NULL;
+	}
+	tbl->max_item_num = entries_num;
+
+	size = sizeof(struct gro_vxlan_tcp6_flow) * entries_num;
+	tbl->flows = rte_zmalloc_socket(__func__,
+			size,
+			RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if (tbl->flows == NULL) {
+		rte_free(tbl->items);
+		rte_free(tbl);
+		return NULL;
+	}
+
+	for (i = 0; i < entries_num; i++)
+		tbl->flows[i].start_index = INVALID_ARRAY_INDEX;
+	tbl->max_flow_num = entries_num;
+
+	return tbl;
+}
+
+void
+gro_vxlan_tcp6_tbl_destroy(void *tbl)
+{
+	struct gro_vxlan_tcp6_tbl *vxlan_tbl = tbl;
+
+	if (vxlan_tbl) {
+		rte_free(vxlan_tbl->items);
+		rte_free(vxlan_tbl->flows);
+	}
+	rte_free(vxlan_tbl);
+}
+
+static inline uint32_t
+find_an_empty_flow(struct gro_vxlan_tcp6_tbl *tbl)
+{
+	uint32_t max_flow_num = tbl->max_flow_num, i;
+
+	for (i = 0; i < max_flow_num; i++)
+		if (tbl->flows[i].start_index == INVALID_ARRAY_INDEX)
+			return i;
+	return INVALID_ARRAY_INDEX;
+}
+
+static inline uint32_t
+insert_new_flow(struct gro_vxlan_tcp6_tbl *tbl,
+		struct vxlan_tcp6_flow_key *src,
+		uint32_t item_idx)
+{
+	uint32_t flow_idx;
+
+	flow_idx = find_an_empty_flow(tbl);
+	if (unlikely(flow_idx == INVALID_ARRAY_INDEX))
+		return INVALID_ARRAY_INDEX;
+
+	memcpy(&tbl->flows[flow_idx].key, src, sizeof(*src));
+	tbl->flows[flow_idx].start_index = item_idx;
+	tbl->flow_num++;
+
+	return flow_idx;
+}
+
+static inline int
+is_same_vxlan_tcp6_flow(const struct vxlan_tcp6_flow_key *k1,
+		const struct vxlan_tcp6_flow_key *k2)
+{
+	return memcmp(k1, k2, sizeof(struct vxlan_tcp6_flow_key)) == 0;
+}
+
+static inline int
+is_ipv6_hdr(const void *l3_hdr)
+{
+	return (*(const uint8_t *)l3_hdr >> 4) == 6;
+}
+
+/*
+ * Update the length fields of the outer L3, outer UDP and inner L3
+ * headers for the flushed packet.
+ */
+static inline void
+update_vxlan_header(struct gro_tcp_item *item)
+{
+	struct rte_ipv4_hdr *ipv4_hdr;
+	struct rte_ipv6_hdr *ipv6_hdr;
+	struct rte_udp_hdr *udp_hdr;
+	struct rte_mbuf *pkt = item->firstseg;
+	char *l3_hdr;
+	uint16_t len;
+
+	/* Update the outer IP header. */
+	len = pkt->pkt_len - pkt->outer_l2_len;
+	l3_hdr = rte_pktmbuf_mtod_offset(pkt, char *, pkt->outer_l2_len);
+	if (is_ipv6_hdr(l3_hdr)) {
+		ipv6_hdr = (struct rte_ipv6_hdr *)l3_hdr;
+		ipv6_hdr->payload_len = rte_cpu_to_be_16(len -
+				sizeof(struct rte_ipv6_hdr));
+	} else {
+		ipv4_hdr = (struct rte_ipv4_hdr *)l3_hdr;
+		ipv4_hdr->total_length = rte_cpu_to_be_16(len);
+	}
+
+	/* Update the outer UDP header. */
+	len -= pkt->outer_l3_len;
+	udp_hdr = (struct rte_udp_hdr *)(l3_hdr + pkt->outer_l3_len);
+	udp_hdr->dgram_len = rte_cpu_to_be_16(len);
+
+	/* Update the inner IP header. */
+	len -= pkt->l2_len;
+	l3_hdr = (char *)udp_hdr + pkt->l2_len;
+	if (is_ipv6_hdr(l3_hdr)) {
+		ipv6_hdr = (struct rte_ipv6_hdr *)l3_hdr;
+		ipv6_hdr->payload_len = rte_cpu_to_be_16(len -
+				sizeof(struct rte_ipv6_hdr));
+	} else {
+		ipv4_hdr = (struct rte_ipv4_hdr *)l3_hdr;
+		ipv4_hdr->total_length = rte_cpu_to_be_16(len);
+	}
+}
+
+int32_t
+gro_vxlan_tcp6_reassemble(struct rte_mbuf *pkt,
+		struct gro_vxlan_tcp6_tbl *tbl,
+		uint64_t start_time)
+{
+	struct rte_ether_hdr *outer_eth_hdr, *eth_hdr;
+	struct rte_ipv4_hdr *ipv4_hdr;
+	struct rte_ipv6_hdr *ipv6_hdr;
+	struct rte_tcp_hdr *tcp_hdr;
+	struct rte_udp_hdr *udp_hdr;
+	struct rte_vxlan_hdr *vxlan_hdr;
+	char *outer_l3_hdr, *l3_hdr;
+	uint32_t sent_seq;
+	int32_t tcp_dl;
+	uint16_t frag_off, ip_id = 0;
+	uint8_t is_atomic = 1, has_ipv4 = 0;
+
+	struct vxlan_tcp6_flow_key key;
+	uint32_t item_idx;
+	uint32_t i, max_flow_num, remaining_flow_num;
+	uint16_t hdr_len;
+	uint8_t find;
+
+	/*
+	 * Don't process the packet whose TCP header length is greater
+	 * than 60 bytes or less than 20 bytes.
+	 */
+	if (unlikely(INVALID_TCP_HDRLEN(pkt->l4_len)))
+		return -1;
+
+	outer_eth_hdr = rte_pktmbuf_mtod(pkt, struct rte_ether_hdr *);
+	outer_l3_hdr = (char *)outer_eth_hdr + pkt->outer_l2_len;
+	udp_hdr = (struct rte_udp_hdr *)(outer_l3_hdr + pkt->outer_l3_len);
+	vxlan_hdr = (struct rte_vxlan_hdr *)((char *)udp_hdr +
+			sizeof(struct rte_udp_hdr));
+	eth_hdr = (struct rte_ether_hdr *)((char *)vxlan_hdr +
+			sizeof(struct rte_vxlan_hdr));
+	l3_hdr = (char *)udp_hdr + pkt->l2_len;
+	tcp_hdr = (struct rte_tcp_hdr *)(l3_hdr + pkt->l3_len);
+
+	/*
+	 * Don't process the packet which has FIN, SYN, RST, PSH, URG,
+	 * ECE or CWR set.
+	 */
+	if (tcp_hdr->tcp_flags != RTE_TCP_ACK_FLAG)
+		return -1;
+
+	hdr_len = pkt->outer_l2_len + pkt->outer_l3_len + pkt->l2_len +
+		pkt->l3_len + pkt->l4_len;
+	/*
+	 * Don't process the packet whose payload length is less than or
+	 * equal to 0.
+	 */
+	tcp_dl = pkt->pkt_len - hdr_len;
+	if (tcp_dl <= 0)
+		return -1;
+
+	/* Padding bytes of the key must be zero, as keys are memcmp'ed. */
+	memset(&key, 0, sizeof(key));
+
+	if (is_ipv6_hdr(outer_l3_hdr)) {
+		ipv6_hdr = (struct rte_ipv6_hdr *)outer_l3_hdr;
+		key.outer_src_addr = ipv6_hdr->src_addr;
+		key.outer_dst_addr = ipv6_hdr->dst_addr;
+	} else {
+		/*
+		 * Save IPv4 ID for the packet whose DF bit is 0. For the
+		 * packet whose DF bit is 1, IPv4 ID is ignored.
+		 */
+		ipv4_hdr = (struct rte_ipv4_hdr *)outer_l3_hdr;
+		memcpy(&key.outer_src_addr, &ipv4_hdr->src_addr,
+				sizeof(ipv4_hdr->src_addr));
+		memcpy(&key.outer_dst_addr, &ipv4_hdr->dst_addr,
+				sizeof(ipv4_hdr->dst_addr));
+		frag_off = rte_be_to_cpu_16(ipv4_hdr->fragment_offset);
+		is_atomic = (frag_off & RTE_IPV4_HDR_DF_FLAG) ==
+			RTE_IPV4_HDR_DF_FLAG;
+		ip_id = is_atomic ? 0 : rte_be_to_cpu_16(ipv4_hdr->packet_id);
+		has_ipv4 = 1;
+	}
+
+	if (is_ipv6_hdr(l3_hdr)) {
+		/* GRO with inner extension headers is not supported */
+		if (pkt->l3_len != sizeof(struct rte_ipv6_hdr))
+			return -1;
+		ipv6_hdr = (struct rte_ipv6_hdr *)l3_hdr;
+		key.inner_src_addr = ipv6_hdr->src_addr;
+		key.inner_dst_addr = ipv6_hdr->dst_addr;
+		key.inner_vtc_flow = ipv6_hdr->vtc_flow &
+			VXLAN_TCP6_VTC_FLOW_MASK;
+	} else {
+		/* Both IPv4 headers are handled by VxLAN TCP/IPv4 GRO. */
+		if (has_ipv4)
+			return -1;
+		ipv4_hdr = (struct rte_ipv4_hdr *)l3_hdr;
+		memcpy(&key.inner_src_addr, &ipv4_hdr->src_addr,
+				sizeof(ipv4_hdr->src_addr));
+		memcpy(&key.inner_dst_addr, &ipv4_hdr->dst_addr,
+				sizeof(ipv4_hdr->dst_addr));
+		frag_off = rte_be_to_cpu_16(ipv4_hdr->fragment_offset);
+		is_atomic = (frag_off & RTE_IPV4_HDR_DF_FLAG) ==
+			RTE_IPV4_HDR_DF_FLAG;
+		ip_id = is_atomic ? 0 : rte_be_to_cpu_16(ipv4_hdr->packet_id);
+	}
+
+	rte_ether_addr_copy(&(eth_hdr->src_addr), &(key.inner_key.eth_saddr));
+	rte_ether_addr_copy(&(eth_hdr->dst_addr), &(key.inner_key.eth_daddr));
+	key.inner_key.recv_ack = tcp_hdr->recv_ack;
+	key.inner_key.src_port = tcp_hdr->src_port;
+	key.inner_key.dst_port = tcp_hdr->dst_port;
+
+	key.vxlan_hdr.vx_flags = vxlan_hdr->vx_flags;
+	key.vxlan_hdr.vx_vni = vxlan_hdr->vx_vni;
+	rte_ether_addr_copy(&(outer_eth_hdr->src_addr), &(key.outer_eth_saddr));
+	rte_ether_addr_copy(&(outer_eth_hdr->dst_addr), &(key.outer_eth_daddr));
+	key.outer_src_port = udp_hdr->src_port;
+	key.outer_dst_port = udp_hdr->dst_port;
+
+	/* Search for a matched flow. */
+	max_flow_num = tbl->max_flow_num;
+	remaining_flow_num = tbl->flow_num;
+	find = 0;
+	for (i = 0; i < max_flow_num && remaining_flow_num; i++) {
+		if (tbl->flows[i].start_index != INVALID_ARRAY_INDEX) {
+			if (is_same_vxlan_tcp6_flow(&tbl->flows[i].key, &key)) {
+				find = 1;
+				break;
+			}
+			remaining_flow_num--;
+		}
+	}
+
+	/*
+	 * Can't find a matched flow. Insert a new flow and store the
+	 * packet into the flow.
+	 */
+	if (find == 0) {
+		sent_seq = rte_be_to_cpu_32(tcp_hdr->sent_seq);
+		item_idx = insert_new_tcp_item(pkt, tbl->items, &tbl->item_num,
+				tbl->max_item_num, start_time,
+				INVALID_ARRAY_INDEX, sent_seq, ip_id,
+				is_atomic);
+		if (item_idx == INVALID_ARRAY_INDEX)
+			return -1;
+		if (insert_new_flow(tbl, &key, item_idx) ==
+				INVALID_ARRAY_INDEX) {
+			/*
+			 * Fail to insert a new flow, so
+			 * delete the inserted packet.
+			 */
+			delete_tcp_item(tbl->items, item_idx, &tbl->item_num,
+					INVALID_ARRAY_INDEX);
+			return -1;
+		}
+		return 0;
+	}
+
+	return process_tcp_item(pkt, tcp_hdr, tcp_dl, tbl->items,
+			tbl->flows[i].start_index, &tbl->item_num,
+			tbl->max_item_num, ip_id, is_atomic, start_time,
+			pkt->outer_l2_len + pkt->outer_l3_len);
+}
+
+uint16_t
+gro_vxlan_tcp6_tbl_timeout_flush(struct gro_vxlan_tcp6_tbl *tbl,
+		uint64_t flush_timestamp,
+		struct rte_mbuf **out,
+		uint16_t nb_out)
+{
+	uint16_t k = 0;
+	uint32_t i, j;
+	uint32_t max_flow_num = tbl->max_flow_num;
+
+	for (i = 0; i < max_flow_num; i++) {
+		if (unlikely(tbl->flow_num == 0))
+			return k;
+
+		j = tbl->flows[i].start_index;
+		while (j != INVALID_ARRAY_INDEX) {
+			if (tbl->items[j].start_time <= flush_timestamp) {
+				out[k++] = tbl->items[j].firstseg;
+				if (tbl->items[j].nb_merged > 1)
+					update_vxlan_header(&(tbl->items[j]));
+				/*
+				 * Delete the item and get the next packet
+				 * index.
+				 */
+				j = delete_tcp_item(tbl->items, j,
+						&tbl->item_num, INVALID_ARRAY_INDEX);
+				tbl->flows[i].start_index = j;
+				if (j == INVALID_ARRAY_INDEX)
+					tbl->flow_num--;
+
+				if (unlikely(k == nb_out))
+					return k;
+			} else
+				/*
+				 * The left packets in the flow won't be
+				 * timeout. Go to check other flows.
+				 */
+				break;
+		}
+	}
+	return k;
+}
+
+uint32_t
+gro_vxlan_tcp6_tbl_pkt_count(void *tbl)
+{
+	struct gro_vxlan_tcp6_tbl *gro_tbl = tbl;
+
+	if (gro_tbl)
+		return gro_tbl->item_num;
+
+	return 0;
+}
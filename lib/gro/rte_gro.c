@@ -10,7 +10,9 @@
 #include "gro_tcp4.h"
 #include "gro_tcp6.h"
 #include "gro_udp4.h"
+#include "gro_udp6.h"
 #include "gro_vxlan_tcp4.h"
+#include "gro_vxlan_tcp6.h"
 #include "gro_vxlan_udp4.h"
 
 typedef void *(*gro_tbl_create_fn)(uint16_t socket_id,
@@ -21,16 +23,22 @@ typedef uint32_t (*gro_tbl_pkt_count_fn)(void *tbl);
 
 static gro_tbl_create_fn tbl_create_fn[RTE_GRO_TYPE_MAX_NUM] = {
 		gro_tcp4_tbl_create, gro_vxlan_tcp4_tbl_create,
-		gro_udp4_tbl_create, gro_vxlan_udp4_tbl_create, gro_tcp6_tbl_create, NULL};
+		gro_udp4_tbl_create, gro_vxlan_udp4_tbl_create, gro_tcp6_tbl_create,
+		gro_udp6_tbl_create, gro_vxlan_tcp6_tbl_create,
+		gro_vxlan_tcp6_tbl_create, gro_vxlan_tcp6_tbl_create, NULL};
 static gro_tbl_destroy_fn tbl_destroy_fn[RTE_GRO_TYPE_MAX_NUM] = {
 			gro_tcp4_tbl_destroy, gro_vxlan_tcp4_tbl_destroy,
 			gro_udp4_tbl_destroy, gro_vxlan_udp4_tbl_destroy,
-			gro_tcp6_tbl_destroy,
+			gro_tcp6_tbl_destroy, gro_udp6_tbl_destroy,
+			gro_vxlan_tcp6_tbl_destroy, gro_vxlan_tcp6_tbl_destroy,
+			gro_vxlan_tcp6_tbl_destroy,
 			NULL};
 static gro_tbl_pkt_count_fn tbl_pkt_count_fn[RTE_GRO_TYPE_MAX_NUM] = {
 			gro_tcp4_tbl_pkt_count, gro_vxlan_tcp4_tbl_pkt_count,
 			gro_udp4_tbl_pkt_count, gro_vxlan_udp4_tbl_pkt_count,
-			gro_tcp6_tbl_pkt_count,
+			gro_tcp6_tbl_pkt_count, gro_udp6_tbl_pkt_count,
+			gro_vxlan_tcp6_tbl_pkt_count, gro_vxlan_tcp6_tbl_pkt_count,
+			gro_vxlan_tcp6_tbl_pkt_count,
 			NULL};
 
 #define IS_IPV4_TCP_PKT(ptype) (RTE_ETH_IS_IPV4_HDR(ptype) && \
@@ -48,6 +56,50 @@ static gro_tbl_pkt_count_fn tbl_pkt_count_fn[RTE_GRO_TYPE_MAX_NUM] = {
 		((ptype & RTE_PTYPE_L4_UDP) == RTE_PTYPE_L4_UDP) && \
 		(RTE_ETH_IS_TUNNEL_PKT(ptype) == 0))
 
+/* Only IPv6 fragments are merged, whose L4 type is a subset of UDP */
+#define IS_IPV6_UDP_PKT(ptype) (RTE_ETH_IS_IPV6_HDR(ptype) && \
+		((ptype & RTE_PTYPE_L4_UDP) == RTE_PTYPE_L4_UDP) && \
+		(RTE_ETH_IS_TUNNEL_PKT(ptype) == 0))
+
+#define IS_VXLAN_TCP_PKT(ptype) \
+		(((ptype & RTE_PTYPE_L4_UDP) == RTE_PTYPE_L4_UDP) && \
+		((ptype & RTE_PTYPE_L4_FRAG) != RTE_PTYPE_L4_FRAG) && \
+		((ptype & RTE_PTYPE_TUNNEL_VXLAN) == \
+		 RTE_PTYPE_TUNNEL_VXLAN) && \
+		((ptype & RTE_PTYPE_INNER_L4_TCP) == \
+		 RTE_PTYPE_INNER_L4_TCP))
+
+#define IS_INNER_IPV4_HDR(ptype) \
+		(((ptype & RTE_PTYPE_INNER_L3_MASK) == \
+		  RTE_PTYPE_INNER_L3_IPV4) || \
+		 ((ptype & RTE_PTYPE_INNER_L3_MASK) == \
+		  RTE_PTYPE_INNER_L3_IPV4_EXT) || \
+		 ((ptype & RTE_PTYPE_INNER_L3_MASK) == \
+		  RTE_PTYPE_INNER_L3_IPV4_EXT_UNKNOWN))
+
+#define IS_INNER_IPV6_HDR(ptype) \
+		(((ptype & RTE_PTYPE_INNER_L3_MASK) == \
+		  RTE_PTYPE_INNER_L3_IPV6) || \
+		 ((ptype & RTE_PTYPE_INNER_L3_MASK) == \
+		  RTE_PTYPE_INNER_L3_IPV6_EXT) || \
+		 ((ptype & RTE_PTYPE_INNER_L3_MASK) == \
+		  RTE_PTYPE_INNER_L3_IPV6_EXT_UNKNOWN))
+
+#define IS_IPV6_VXLAN_TCP4_PKT(ptype) (RTE_ETH_IS_IPV6_HDR(ptype) && \
+		IS_VXLAN_TCP_PKT(ptype) && IS_INNER_IPV4_HDR(ptype))
+
+#define IS_IPV4_VXLAN_TCP6_PKT(ptype) (RTE_ETH_IS_IPV4_HDR(ptype) && \
+		IS_VXLAN_TCP_PKT(ptype) && IS_INNER_IPV6_HDR(ptype))
+
+#define IS_IPV6_VXLAN_TCP6_PKT(ptype) (RTE_ETH_IS_IPV6_HDR(ptype) && \
+		IS_VXLAN_TCP_PKT(ptype) && IS_INNER_IPV6_HDR(ptype))
+
+#define GRO_SUPPORTED_TYPES (RTE_GRO_IPV4_VXLAN_TCP_IPV4 | \
+		RTE_GRO_TCP_IPV4 | RTE_GRO_TCP_IPV6 | \
+		RTE_GRO_IPV4_VXLAN_UDP_IPV4 | RTE_GRO_UDP_IPV4 | \
+		RTE_GRO_UDP_IPV6 | RTE_GRO_IPV6_VXLAN_TCP_IPV4 | \
+		RTE_GRO_IPV4_VXLAN_TCP_IPV6 | RTE_GRO_IPV6_VXLAN_TCP_IPV6)
+
 #define IS_IPV4_VXLAN_TCP4_PKT(ptype) (RTE_ETH_IS_IPV4_HDR(ptype) && \
 		((ptype & RTE_PTYPE_L4_UDP) == RTE_PTYPE_L4_UDP) && \
 		((ptype & RTE_PTYPE_L4_FRAG) != RTE_PTYPE_L4_FRAG) && \
@@ -179,17 +231,35 @@ rte_gro_reassemble_burst(struct rte_mbuf **pkts,
 	struct gro_vxlan_udp4_item vxlan_udp_items[RTE_GRO_MAX_BURST_ITEM_NUM]
 			= {{{0}} };
 
+	/* Allocate a reassembly table for UDP/IPv6 GRO */
+	struct gro_udp6_tbl udp6_tbl;
+	struct gro_udp6_flow udp6_flows[RTE_GRO_MAX_BURST_ITEM_NUM];
+	struct gro_udp4_item udp6_items[RTE_GRO_MAX_BURST_ITEM_NUM];
+
+	/*
+	 * Allocate reassembly tables for VXLAN TCP GRO with an outer
+	 * IPv6 header or an inner TCP/IPv6 packet. Their items are only
+	 * initialized when the corresponding GRO type is enabled.
+	 */
+	struct gro_vxlan_tcp6_tbl vxlan_tcp6_tbls[3];
+	struct gro_vxlan_tcp6_flow vxlan_tcp6_flows[3][RTE_GRO_MAX_BURST_ITEM_NUM];
+	struct gro_tcp_item vxlan_tcp6_items[3][RTE_GRO_MAX_BURST_ITEM_NUM];
+	static const uint64_t vxlan_tcp6_types[3] = {
+		RTE_GRO_IPV6_VXLAN_TCP_IPV4,
+		RTE_GRO_IPV4_VXLAN_TCP_IPV6,
+		RTE_GRO_IPV6_VXLAN_TCP_IPV6,
+	};
+	struct gro_vxlan_tcp6_tbl *vxlan_tcp6_tbl;
+
 	struct rte_mbuf *unprocess_pkts[nb_pkts];
-	uint32_t item_num;
+	uint32_t item_num, j;
 	int32_t ret;
 	uint16_t i, unprocess_num = 0, nb_after_gro = nb_pkts;
 	uint8_t do_tcp4_gro = 0, do_vxlan_tcp_gro = 0, do_udp4_gro = 0,
-		do_vxlan_udp_gro = 0, do_tcp6_gro = 0;
+		do_vxlan_udp_gro = 0, do_tcp6_gro = 0, do_udp6_gro = 0;
+	uint8_t do_vxlan_tcp6_gro[3] = {0};
 
-	if (unlikely((param->gro_types & (RTE_GRO_IPV4_VXLAN_TCP_IPV4 |
-					RTE_GRO_TCP_IPV4 | RTE_GRO_TCP_IPV6 |
-					RTE_GRO_IPV4_VXLAN_UDP_IPV4 |
-					RTE_GRO_UDP_IPV4)) == 0))
+	if (unlikely((param->gro_types & GRO_SUPPORTED_TYPES) == 0))
 		return nb_pkts;
 
 	/* Get the maximum number of packets */
@@ -262,12 +332,63 @@ rte_gro_reassemble_burst(struct rte_mbuf **pkts,
 		do_tcp6_gro = 1;
 	}
 
+	if (param->gro_types & RTE_GRO_UDP_IPV6) {
+		for (i = 0; i < item_num; i++)
+			udp6_flows[i].start_index = INVALID_ARRAY_INDEX;
+		memset(udp6_items, 0, sizeof(udp6_items[0]) * item_num);
+
+		udp6_tbl.flows = udp6_flows;
+		udp6_tbl.items = udp6_items;
+		udp6_tbl.flow_num = 0;
+		udp6_tbl.item_num = 0;
+		udp6_tbl.max_flow_num = item_num;
+		udp6_tbl.max_item_num = item_num;
+		do_udp6_gro = 1;
+	}
+
+	for (j = 0; j < RTE_DIM(vxlan_tcp6_types); j++) {
+		if ((param->gro_types & vxlan_tcp6_types[j]) == 0)
+			continue;
+
+		for (i = 0; i < item_num; i++)
+			vxlan_tcp6_flows[j][i].start_index = INVALID_ARRAY_INDEX;
+		memset(vxlan_tcp6_items[j], 0,
+				sizeof(vxlan_tcp6_items[j][0]) * item_num);
+
+		vxlan_tcp6_tbls[j].flows = vxlan_tcp6_flows[j];
+		vxlan_tcp6_tbls[j].items = vxlan_tcp6_items[j];
+		vxlan_tcp6_tbls[j].flow_num = 0;
+		vxlan_tcp6_tbls[j].item_num = 0;
+		vxlan_tcp6_tbls[j].max_flow_num = item_num;
+		vxlan_tcp6_tbls[j].max_item_num = item_num;
+		do_vxlan_tcp6_gro[j] = 1;
+	}
+
 	for (i = 0; i < nb_pkts; i++) {
 		/*
 		 * The timestamp is ignored, since all packets
 		 * will be flushed from the tables.
 		 */
-		if (IS_IPV4_VXLAN_TCP4_PKT(pkts[i]->packet_type) &&
+		vxlan_tcp6_tbl = NULL;
+		if (IS_IPV6_VXLAN_TCP4_PKT(pkts[i]->packet_type) &&
+				do_vxlan_tcp6_gro[0])
+			vxlan_tcp6_tbl = &vxlan_tcp6_tbls[0];
+		else if (IS_IPV4_VXLAN_TCP6_PKT(pkts[i]->packet_type) &&
+				do_vxlan_tcp6_gro[1])
+			vxlan_tcp6_tbl = &vxlan_tcp6_tbls[1];
+		else if (IS_IPV6_VXLAN_TCP6_PKT(pkts[i]->packet_type) &&
+				do_vxlan_tcp6_gro[2])
+			vxlan_tcp6_tbl = &vxlan_tcp6_tbls[2];
+
+		if (vxlan_tcp6_tbl != NULL) {
+			ret = gro_vxlan_tcp6_reassemble(pkts[i],
+							vxlan_tcp6_tbl, 0);
+			if (ret > 0)
+				/* Merge successfully */
+				nb_after_gro--;
+			else if (ret < 0)
+				unprocess_pkts[unprocess_num++] = pkts[i];
+		} else if (IS_IPV4_VXLAN_TCP4_PKT(pkts[i]->packet_type) &&
 				do_vxlan_tcp_gro) {
 			ret = gro_vxlan_tcp4_reassemble(pkts[i],
 							&vxlan_tcp_tbl, 0);
@@ -309,6 +430,14 @@ rte_gro_reassemble_burst(struct rte_mbuf **pkts,
 				nb_after_gro--;
 			else if (ret < 0)
 				unprocess_pkts[unprocess_num++] = pkts[i];
+		} else if (IS_IPV6_UDP_PKT(pkts[i]->packet_type) &&
+				do_udp6_gro) {
+			ret = gro_udp6_reassemble(pkts[i], &udp6_tbl, 0);
+			if (ret > 0)
+				/* merge successfully */
+				nb_after_gro--;
+			else if (ret < 0)
+				unprocess_pkts[unprocess_num++] = pkts[i];
 		} else
 			unprocess_pkts[unprocess_num++] = pkts[i];
 	}
@@ -350,6 +479,18 @@ rte_gro_reassemble_burst(struct rte_mbuf **pkts,
 			i += gro_tcp6_tbl_timeout_flush(&tcp6_tbl, 0,
 					&pkts[i], nb_pkts - i);
 		}
+
+		if (do_udp6_gro) {
+			i += gro_udp6_tbl_timeout_flush(&udp6_tbl, 0,
+					&pkts[i], nb_pkts - i);
+		}
+
+		for (j = 0; j < RTE_DIM(vxlan_tcp6_types); j++) {
+			if (do_vxlan_tcp6_gro[j])
+				i += gro_vxlan_tcp6_tbl_timeout_flush(
+						&vxlan_tcp6_tbls[j], 0,
+						&pkts[i], nb_pkts - i);
+		}
 	}
 
 	return nb_after_gro;
@@ -363,14 +504,13 @@ rte_gro_reassemble(struct rte_mbuf **pkts,
 	struct rte_mbuf *unprocess_pkts[nb_pkts];
 	struct gro_ctx *gro_ctx = ctx;
 	void *tcp_tbl, *udp_tbl, *vxlan_tcp_tbl, *vxlan_udp_tbl, *tcp6_tbl;
-	uint64_t current_time;
+	void *udp6_tbl, *vxlan_tcp6_tbl;
+	uint64_t current_time, gro_types;
 	uint16_t i, unprocess_num = 0;
 	uint8_t do_tcp4_gro, do_vxlan_tcp_gro, do_udp4_gro, do_vxlan_udp_gro, do_tcp6_gro;
+	uint8_t do_udp6_gro;
 
-	if (unlikely((gro_ctx->gro_types & (RTE_GRO_IPV4_VXLAN_TCP_IPV4 |
-					RTE_GRO_TCP_IPV4 | RTE_GRO_TCP_IPV6 |
-					RTE_GRO_IPV4_VXLAN_UDP_IPV4 |
-					RTE_GRO_UDP_IPV4)) == 0))
+	if (unlikely((gro_ctx->gro_types & GRO_SUPPORTED_TYPES) == 0))
 		return nb_pkts;
 
 	tcp_tbl = gro_ctx->tbls[RTE_GRO_TCP_IPV4_INDEX];
@@ -388,11 +528,32 @@ rte_gro_reassemble(struct rte_mbuf **pkts,
 	do_vxlan_udp_gro = (gro_ctx->gro_types & RTE_GRO_IPV4_VXLAN_UDP_IPV4) ==
 		RTE_GRO_IPV4_VXLAN_UDP_IPV4;
 	do_tcp6_gro = (gro_ctx->gro_types & RTE_GRO_TCP_IPV6) == RTE_GRO_TCP_IPV6;
+	udp6_tbl = gro_ctx->tbls[RTE_GRO_UDP_IPV6_INDEX];
+	do_udp6_gro = (gro_ctx->gro_types & RTE_GRO_UDP_IPV6) == RTE_GRO_UDP_IPV6;
+	gro_types = gro_ctx->gro_types;
 
 	current_time = rte_rdtsc();
 
 	for (i = 0; i < nb_pkts; i++) {
-		if (IS_IPV4_VXLAN_TCP4_PKT(pkts[i]->packet_type) &&
+		vxlan_tcp6_tbl = NULL;
+		if (IS_IPV6_VXLAN_TCP4_PKT(pkts[i]->packet_type) &&
+				(gro_types & RTE_GRO_IPV6_VXLAN_TCP_IPV4))
+			vxlan_tcp6_tbl = gro_ctx->tbls[
+				RTE_GRO_IPV6_VXLAN_TCP_IPV4_INDEX];
+		else if (IS_IPV4_VXLAN_TCP6_PKT(pkts[i]->packet_type) &&
+				(gro_types & RTE_GRO_IPV4_VXLAN_TCP_IPV6))
+			vxlan_tcp6_tbl = gro_ctx->tbls[
+				RTE_GRO_IPV4_VXLAN_TCP_IPV6_INDEX];
+		else if (IS_IPV6_VXLAN_TCP6_PKT(pkts[i]->packet_type) &&
+				(gro_types & RTE_GRO_IPV6_VXLAN_TCP_IPV6))
+			vxlan_tcp6_tbl = gro_ctx->tbls[
+				RTE_GRO_IPV6_VXLAN_TCP_IPV6_INDEX];
+
+		if (vxlan_tcp6_tbl != NULL) {
+			if (gro_vxlan_tcp6_reassemble(pkts[i], vxlan_tcp6_tbl,
+						current_time) < 0)
+				unprocess_pkts[unprocess_num++] = pkts[i];
+		} else if (IS_IPV4_VXLAN_TCP4_PKT(pkts[i]->packet_type) &&
 				do_vxlan_tcp_gro) {
 			if (gro_vxlan_tcp4_reassemble(pkts[i], vxlan_tcp_tbl,
 						current_time) < 0)
@@ -417,6 +578,11 @@ rte_gro_reassemble(struct rte_mbuf **pkts,
 			if (gro_tcp6_reassemble(pkts[i], tcp6_tbl,
 						current_time) < 0)
 				unprocess_pkts[unprocess_num++] = pkts[i];
+		} else if (IS_IPV6_UDP_PKT(pkts[i]->packet_type) &&
+				do_udp6_gro) {
+			if (gro_udp6_reassemble(pkts[i], udp6_tbl,
+						current_time) < 0)
+				unprocess_pkts[unprocess_num++] = pkts[i];
 		} else
 			unprocess_pkts[unprocess_num++] = pkts[i];
 	}
@@ -480,7 +646,35 @@ rte_gro_timeout_flush(void *ctx,
 				gro_ctx->tbls[RTE_GRO_TCP_IPV6_INDEX],
 				flush_timestamp,
 				&out[num], left_nb_out);
+		left_nb_out = max_nb_out - num;
+	}
+
+	if ((gro_types & RTE_GRO_UDP_IPV6) && left_nb_out > 0) {
+		num += gro_udp6_tbl_timeout_flush(
+				gro_ctx->tbls[RTE_GRO_UDP_IPV6_INDEX],
+				flush_timestamp,
+				&out[num], left_nb_out);
+		left_nb_out = max_nb_out - num;
+	}
+
+	if ((gro_types & RTE_GRO_IPV6_VXLAN_TCP_IPV4) && left_nb_out > 0) {
+		num += gro_vxlan_tcp6_tbl_timeout_flush(gro_ctx->tbls[
+				RTE_GRO_IPV6_VXLAN_TCP_IPV4_INDEX],
+				flush_timestamp, &out[num], left_nb_out);
+		left_nb_out = max_nb_out - num;
+	}
+
+	if ((gro_types & RTE_GRO_IPV4_VXLAN_TCP_IPV6) && left_nb_out > 0) {
+		num += gro_vxlan_tcp6_tbl_timeout_flush(gro_ctx->tbls[
+				RTE_GRO_IPV4_VXLAN_TCP_IPV6_INDEX],
+				flush_timestamp, &out[num], left_nb_out);
+		left_nb_out = max_nb_out - num;
+	}
 
+	if ((gro_types & RTE_GRO_IPV6_VXLAN_TCP_IPV6) && left_nb_out > 0) {
+		num += gro_vxlan_tcp6_tbl_timeout_flush(gro_ctx->tbls[
+				RTE_GRO_IPV6_VXLAN_TCP_IPV6_INDEX],
+				flush_timestamp, &out[num], left_nb_out);
 	}
 
 	return num;
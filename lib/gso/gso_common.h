@@ -38,6 +38,39 @@
 #define IS_IPV4_UDP(flag) (((flag) & (RTE_MBUF_F_TX_UDP_SEG | RTE_MBUF_F_TX_IPV4)) == \
 		(RTE_MBUF_F_TX_UDP_SEG | RTE_MBUF_F_TX_IPV4))
 
+#define IS_IPV6_TCP(flag) (((flag) & (RTE_MBUF_F_TX_TCP_SEG | RTE_MBUF_F_TX_IPV6)) == \
+		(RTE_MBUF_F_TX_TCP_SEG | RTE_MBUF_F_TX_IPV6))
+
+#define IS_IPV6_UDP(flag) (((flag) & (RTE_MBUF_F_TX_UDP_SEG | RTE_MBUF_F_TX_IPV6)) == \
+		(RTE_MBUF_F_TX_UDP_SEG | RTE_MBUF_F_TX_IPV6))
+
+#define IS_TUNNEL_PKT(flag, seg, inner, outer, tunnel) \
+	(((flag) & ((seg) | RTE_MBUF_F_TX_IPV4 | RTE_MBUF_F_TX_IPV6 | \
+			RTE_MBUF_F_TX_OUTER_IPV4 | RTE_MBUF_F_TX_OUTER_IPV6 | \
+			RTE_MBUF_F_TX_TUNNEL_MASK)) == \
+		((seg) | (inner) | (outer) | (tunnel)))
+
+#define IS_IPV6_VXLAN_TCP4(flag) IS_TUNNEL_PKT(flag, RTE_MBUF_F_TX_TCP_SEG, \
+		RTE_MBUF_F_TX_IPV4, RTE_MBUF_F_TX_OUTER_IPV6, RTE_MBUF_F_TX_TUNNEL_VXLAN)
+
+#define IS_IPV4_VXLAN_TCP6(flag) IS_TUNNEL_PKT(flag, RTE_MBUF_F_TX_TCP_SEG, \
+		RTE_MBUF_F_TX_IPV6, RTE_MBUF_F_TX_OUTER_IPV4, RTE_MBUF_F_TX_TUNNEL_VXLAN)
+
+#define IS_IPV6_VXLAN_TCP6(flag) IS_TUNNEL_PKT(flag, RTE_MBUF_F_TX_TCP_SEG, \
+		RTE_MBUF_F_TX_IPV6, RTE_MBUF_F_TX_OUTER_IPV6, RTE_MBUF_F_TX_TUNNEL_VXLAN)
+
+#define IS_IPV6_GRE_TCP4(flag) IS_TUNNEL_PKT(flag, RTE_MBUF_F_TX_TCP_SEG, \
+		RTE_MBUF_F_TX_IPV4, RTE_MBUF_F_TX_OUTER_IPV6, RTE_MBUF_F_TX_TUNNEL_GRE)
+
+#define IS_IPV4_GRE_TCP6(flag) IS_TUNNEL_PKT(flag, RTE_MBUF_F_TX_TCP_SEG, \
+		RTE_MBUF_F_TX_IPV6, RTE_MBUF_F_TX_OUTER_IPV4, RTE_MBUF_F_TX_TUNNEL_GRE)
+
+#define IS_IPV6_GRE_TCP6(flag) IS_TUNNEL_PKT(flag, RTE_MBUF_F_TX_TCP_SEG, \
+		RTE_MBUF_F_TX_IPV6, RTE_MBUF_F_TX_OUTER_IPV6, RTE_MBUF_F_TX_TUNNEL_GRE)
+
+#define IS_IPV6_VXLAN_UDP4(flag) IS_TUNNEL_PKT(flag, RTE_MBUF_F_TX_UDP_SEG, \
+		RTE_MBUF_F_TX_IPV4, RTE_MBUF_F_TX_OUTER_IPV6, RTE_MBUF_F_TX_TUNNEL_VXLAN)
+
 /**
  * Internal function which updates the UDP header of a packet, following
  * segmentation. This is required to update the header's datagram length field.
@@ -110,6 +143,47 @@ update_ipv4_header(struct rte_mbuf *pkt, uint16_t l3_offset, uint16_t id)
 	ipv4_hdr->packet_id = rte_cpu_to_be_16(id);
 }
 
+/**
+ * Internal function which updates the IPv6 header of a packet, following
+ * segmentation. This is required to update the header's 'payload_len' field,
+ * to reflect the reduced length of the now-segmented packet.
+ *
+ * @param pkt
+ *  The packet containing the IPv6 header.
+ * @param l3_offset
+ *  The offset of the IPv6 header from the start of the packet.
+ */
+static inline void
+update_ipv6_header(struct rte_mbuf *pkt, uint16_t l3_offset)
+{
+	struct rte_ipv6_hdr *ipv6_hdr;
+
+	ipv6_hdr = rte_pktmbuf_mtod_offset(pkt, struct rte_ipv6_hdr *,
+					   l3_offset);
+	ipv6_hdr->payload_len = rte_cpu_to_be_16(pkt->pkt_len - l3_offset -
+			sizeof(struct rte_ipv6_hdr));
+}
+
+/**
+ * Internal function which updates the outer IP header of a tunneled
+ * packet, following segmentation. Only IPv4 headers carry an ID.
+ *
+ * @param pkt
+ *  The packet containing the outer IP header.
+ * @param l3_offset
+ *  The offset of the outer IP header from the start of the packet.
+ * @param id
+ *  The new ID of the packet, for an outer IPv4 header.
+ */
+static inline void
+update_outer_ip_header(struct rte_mbuf *pkt, uint16_t l3_offset, uint16_t id)
+{
+	if (pkt->ol_flags & RTE_MBUF_F_TX_OUTER_IPV6)
+		update_ipv6_header(pkt, l3_offset);
+	else
+		update_ipv4_header(pkt, l3_offset, id);
+}
+
 /**
  * Internal function which divides the input packet into small segments.
  * Each of the newly-created segments is organized as a two-segment MBUF,
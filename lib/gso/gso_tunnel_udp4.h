@@ -8,10 +8,10 @@
 #include <stdint.h>
 
 /**
- * Segment a tunneling packet with inner UDP/IPv4 headers. This function
- * does not check if the input packet has correct checksums, and does not
- * update checksums for output GSO segments. Furthermore, it does not
- * process IP fragment packets.
+ * Segment a tunneling packet with an outer IPv4 or IPv6 header and inner
+ * UDP/IPv4 headers. This function doesn't check if the input packet has
+ * correct checksums, and doesn't update checksums for output GSO segments.
+ * Furthermore, it doesn't process IP fragment packets.
  *
  * @param pkt
  *  The packet mbuf to segment.
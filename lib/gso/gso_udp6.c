@@ -0,0 +1,116 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 The DPDK contributors
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include <rte_random.h>
+
+#include "gso_common.h"
+#include "gso_udp6.h"
+
+/*
+ * Insert an IPv6 fragment header after the IPv6 header of an output
+ * segment. The headers live in the first (direct) mbuf of the segment,
+ * so they are moved into its headroom to make space.
+ */
+static inline int
+insert_ipv6_frag_header(struct rte_mbuf *seg, uint16_t l3_offset,
+		uint16_t frag_offset, uint8_t is_mf, rte_be32_t id)
+{
+	struct rte_ipv6_fragment_ext *frag_hdr;
+	struct rte_ipv6_hdr *ipv6_hdr;
+	uint16_t hdr_len = l3_offset + sizeof(struct rte_ipv6_hdr);
+	char *hdr;
+
+	hdr = rte_pktmbuf_prepend(seg, RTE_IPV6_FRAG_HDR_SIZE);
+	if (unlikely(hdr == NULL))
+		return -ENOMEM;
+	memmove(hdr, hdr + RTE_IPV6_FRAG_HDR_SIZE, hdr_len);
+
+	ipv6_hdr = (struct rte_ipv6_hdr *)(hdr + l3_offset);
+	frag_hdr = (struct rte_ipv6_fragment_ext *)(hdr + hdr_len);
+	frag_hdr->next_header = ipv6_hdr->proto;
+	frag_hdr->reserved = 0;
+	frag_hdr->frag_data = rte_cpu_to_be_16(RTE_IPV6_SET_FRAG_DATA(
+				frag_offset << RTE_IPV6_EHDR_FO_SHIFT, is_mf));
+	frag_hdr->id = id;
+	ipv6_hdr->proto = IPPROTO_FRAGMENT;
+	seg->l3_len += RTE_IPV6_FRAG_HDR_SIZE;
+
+	update_ipv6_header(seg, l3_offset);
+
+	return 0;
+}
+
+static inline int
+update_ipv6_udp_headers(struct rte_mbuf *pkt, struct rte_mbuf **segs,
+		uint16_t nb_segs)
+{
+	uint16_t frag_offset = 0;
+	uint16_t l2_hdrlen = pkt->l2_len, l3_hdrlen = pkt->l3_len;
+	uint16_t tail_idx = nb_segs - 1, length, i;
+	rte_be32_t id = rte_cpu_to_be_32((uint32_t)rte_rand());
+
+	/*
+	 * Add a fragment header to every output segment, with the same
+	 * fragment ID, its fragment offset and the more fragments flag.
+	 */
+	for (i = 0; i < nb_segs; i++) {
+		length = segs[i]->pkt_len - l2_hdrlen - l3_hdrlen;
+		if (unlikely(insert_ipv6_frag_header(segs[i], l2_hdrlen,
+					frag_offset, i < tail_idx, id) < 0))
+			return -ENOMEM;
+		frag_offset += (length >> 3);
+	}
+
+	return 0;
+}
+
+int
+gso_udp6_segment(struct rte_mbuf *pkt,
+		uint16_t gso_size,
+		struct rte_mempool *direct_pool,
+		struct rte_mempool *indirect_pool,
+		struct rte_mbuf **pkts_out,
+		uint16_t nb_pkts_out)
+{
+	uint16_t pyld_unit_size, hdr_offset, i;
+	int ret;
+
+	/*
+	 * Extension headers would have to be split into per-fragment and
+	 * fragmentable parts, only a bare IPv6 header is supported.
+	 */
+	if (unlikely(pkt->l3_len != sizeof(struct rte_ipv6_hdr)))
+		return 0;
+
+	/*
+	 * UDP fragmentation is the same as IP fragmentation.
+	 * Except the first one, other output packets just have l2,
+	 * l3 and fragment headers.
+	 */
+	hdr_offset = pkt->l2_len + pkt->l3_len;
+
+	/* Don't process the packet without data. */
+	if (unlikely(hdr_offset + pkt->l4_len >= pkt->pkt_len))
+		return 0;
+
+	/* pyld_unit_size must be a multiple of 8 because the fragment
+	 * offset uses 8 bytes as unit.
+	 */
+	pyld_unit_size = (gso_size - hdr_offset - RTE_IPV6_FRAG_HDR_SIZE) &
+		~7U;
+
+	/* Segment the payload */
+	ret = gso_do_segment(pkt, hdr_offset, pyld_unit_size, direct_pool,
+			indirect_pool, pkts_out, nb_pkts_out);
+	if (ret > 1 && update_ipv6_udp_headers(pkt, pkts_out, ret) < 0) {
+		for (i = 0; i < ret; i++)
+			rte_pktmbuf_free(pkts_out[i]);
+		ret = -ENOMEM;
+	}
+
+	return ret;
+}
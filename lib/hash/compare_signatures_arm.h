@@ -17,7 +17,7 @@
 #define DENSE_HASH_BULK_LOOKUP 1
 
 static inline void
-compare_signatures_dense(uint16_t *hitmask_buffer,
+compare_signatures_dense(hash_hitmask_t *hitmask_buffer,
 			const uint16_t *prim_bucket_sigs,
 			const uint16_t *sec_bucket_sigs,
 			uint16_t sig,
@@ -79,8 +79,8 @@ compare_signatures_dense(uint16_t *hitmask_buffer,
 		} else {
 			do {
 				pred = svwhilelt_b16(i, RTE_HASH_BUCKET_ENTRIES);
-				uint16_t lower_half = 0;
-				uint16_t upper_half = 0;
+				hash_hitmask_t lower_half = 0;
+				hash_hitmask_t upper_half = 0;
 				/* Compare all signatures in the primary bucket */
 				match = svcmpeq_u16(pred, vsign, svld1_u16(pred,
 					&prim_bucket_sigs[i]));
@@ -95,10 +95,10 @@ compare_signatures_dense(uint16_t *hitmask_buffer,
 				if (svptest_any(svptrue_b16(), match)) {
 					sv_matches = svdup_u16(1);
 					sv_matches = svlsl_u16_z(match, sv_matches, shift);
-					upper_half = svorv_u16(svptrue_b16(), sv_matches)
-						<< RTE_HASH_BUCKET_ENTRIES;
+					upper_half = (hash_hitmask_t)svorv_u16(svptrue_b16(),
+						sv_matches) << RTE_HASH_BUCKET_ENTRIES;
 				}
-				hitmask_buffer[i / 8] = upper_half | lower_half;
+				*hitmask_buffer |= (upper_half | lower_half) << i;
 				i += vl;
 			} while (i < RTE_HASH_BUCKET_ENTRIES);
 		}
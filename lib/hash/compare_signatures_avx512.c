@@ -0,0 +1,82 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 The DPDK contributors
+ */
+
+#include <rte_vect.h>
+
+#include "rte_hash.h"
+#include "rte_cuckoo_hash.h"
+#include "compare_signatures_avx512.h"
+
+/*
+ * Each 16-bit match of the comparison is widened to two bits,
+ * the first bit of every two bits indicates the match.
+ */
+static inline uint64_t
+sparse_matches(__m512i sigs, __m512i vsig)
+{
+	__mmask32 match = _mm512_cmpeq_epi16_mask(sigs, vsig);
+
+	return _mm512_movepi8_mask(_mm512_movm_epi16(match)) &
+		0x5555555555555555ULL;
+}
+
+#if RTE_HASH_BUCKET_ENTRIES == 16
+/* The 16 signatures of a bucket fill half a 512-bit register. */
+void
+compare_signatures_sparse_bulk_avx512(uint32_t *prim_hash_matches,
+			uint32_t *sec_hash_matches,
+			const struct rte_hash_bucket **prim_bkt,
+			const struct rte_hash_bucket **sec_bkt,
+			const uint16_t *sig, int32_t num_keys)
+{
+	__m512i sigs;
+	uint64_t matches;
+	int32_t i;
+
+	for (i = 0; i < num_keys; i++) {
+		sigs = _mm512_inserti64x4(_mm512_castsi256_si512(
+			_mm256_load_si256((const __m256i *)prim_bkt[i]->sig_current)),
+			_mm256_load_si256((const __m256i *)sec_bkt[i]->sig_current), 1);
+		matches = sparse_matches(sigs, _mm512_set1_epi16(sig[i]));
+
+		prim_hash_matches[i] = (uint32_t)matches;
+		sec_hash_matches[i] = (uint32_t)(matches >> 32);
+	}
+}
+#else
+/* The signatures of the buckets of two keys fill a 512-bit register. */
+void
+compare_signatures_sparse_bulk_avx512(uint32_t *prim_hash_matches,
+			uint32_t *sec_hash_matches,
+			const struct rte_hash_bucket **prim_bkt,
+			const struct rte_hash_bucket **sec_bkt,
+			const uint16_t *sig, int32_t num_keys)
+{
+	__m512i sigs, vsig;
+	uint64_t matches;
+	int32_t i, j;
+
+	for (i = 0; i < num_keys; i += 2) {
+		/* an odd last key is compared twice */
+		j = (i + 1 < num_keys) ? i + 1 : i;
+
+		sigs = _mm512_castsi128_si512(
+			_mm_load_si128((const __m128i *)prim_bkt[i]->sig_current));
+		sigs = _mm512_inserti32x4(sigs,
+			_mm_load_si128((const __m128i *)sec_bkt[i]->sig_current), 1);
+		sigs = _mm512_inserti32x4(sigs,
+			_mm_load_si128((const __m128i *)prim_bkt[j]->sig_current), 2);
+		sigs = _mm512_inserti32x4(sigs,
+			_mm_load_si128((const __m128i *)sec_bkt[j]->sig_current), 3);
+		vsig = _mm512_inserti64x4(_mm512_set1_epi16(sig[i]),
+			_mm256_set1_epi16(sig[j]), 1);
+		matches = sparse_matches(sigs, vsig);
+
+		prim_hash_matches[i] = (uint16_t)matches;
+		sec_hash_matches[i] = (uint16_t)(matches >> 16);
+		prim_hash_matches[j] = (uint16_t)(matches >> 32);
+		sec_hash_matches[j] = (uint16_t)(matches >> 48);
+	}
+}
+#endif
@@ -0,0 +1,24 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 The DPDK contributors
+ */
+
+#ifndef COMPARE_SIGNATURES_AVX512_H
+#define COMPARE_SIGNATURES_AVX512_H
+
+#include <stdint.h>
+
+struct rte_hash_bucket;
+
+/*
+ * Compare the signatures of a burst of keys with their primary and
+ * secondary buckets, filling sparsely packed hitmasks as
+ * compare_signatures_sparse() does.
+ */
+void
+compare_signatures_sparse_bulk_avx512(uint32_t *prim_hash_matches,
+			uint32_t *sec_hash_matches,
+			const struct rte_hash_bucket **prim_bkt,
+			const struct rte_hash_bucket **sec_bkt,
+			const uint16_t *sig, int32_t num_keys);
+
+#endif /* COMPARE_SIGNATURES_AVX512_H */
@@ -12,6 +12,9 @@
 #include <rte_vect.h>
 
 #include "rte_cuckoo_hash.h"
+#ifdef CC_AVX512_SUPPORT
+#include "compare_signatures_avx512.h"
+#endif
 
 /* x86's version uses a sparsely packed hitmask buffer: every other bit is padding. */
 #define DENSE_HASH_BULK_LOOKUP 0
@@ -27,7 +30,29 @@ compare_signatures_sparse(uint32_t *prim_hash_matches, uint32_t *sec_hash_matche
 
 	/* For match mask the first bit of every two bits indicates the match */
 	switch (sig_cmp_fn) {
-#if defined(__SSE2__) && RTE_HASH_BUCKET_ENTRIES <= 8
+#if defined(__SSE2__) && RTE_HASH_BUCKET_ENTRIES == 16
+	case RTE_HASH_COMPARE_SSE: {
+		const __m128i vsig = _mm_set1_epi16(sig);
+		const __m128i *prim_sigs = (__m128i const *)prim_bkt->sig_current;
+		const __m128i *sec_sigs = (__m128i const *)sec_bkt->sig_current;
+
+		/* Compare all signatures in the bucket, 8 at a time */
+		*prim_hash_matches = _mm_movemask_epi8(_mm_cmpeq_epi16(
+			_mm_load_si128(&prim_sigs[0]), vsig)) |
+			_mm_movemask_epi8(_mm_cmpeq_epi16(
+			_mm_load_si128(&prim_sigs[1]), vsig)) << 16;
+		/* Extract the even-index bits only */
+		*prim_hash_matches &= 0x55555555;
+		/* Compare all signatures in the bucket, 8 at a time */
+		*sec_hash_matches = _mm_movemask_epi8(_mm_cmpeq_epi16(
+			_mm_load_si128(&sec_sigs[0]), vsig)) |
+			_mm_movemask_epi8(_mm_cmpeq_epi16(
+			_mm_load_si128(&sec_sigs[1]), vsig)) << 16;
+		/* Extract the even-index bits only */
+		*sec_hash_matches &= 0x55555555;
+		break;
+	}
+#elif defined(__SSE2__) && RTE_HASH_BUCKET_ENTRIES <= 8
 	case RTE_HASH_COMPARE_SSE:
 		/* Compare all signatures in the bucket */
 		*prim_hash_matches = _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_load_si128(
@@ -40,6 +65,11 @@ compare_signatures_sparse(uint32_t *prim_hash_matches, uint32_t *sec_hash_matche
 		/* Extract the even-index bits only */
 		*sec_hash_matches &= 0x5555;
 		break;
+#endif
+#ifdef CC_AVX512_SUPPORT
+	case RTE_HASH_COMPARE_AVX512:
+		/* Already done for the whole burst */
+		break;
 #endif
 	default:
 		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
@@ -41,6 +41,7 @@ enum rte_hash_sig_compare_function {
 	RTE_HASH_COMPARE_SSE,
 	RTE_HASH_COMPARE_NEON,
 	RTE_HASH_COMPARE_SVE,
+	RTE_HASH_COMPARE_AVX512,
 };
 
 #if defined(__ARM_NEON)
@@ -191,10 +192,10 @@ rte_hash_create(const struct rte_hash_parameters *params)
 
 	/* Check for valid parameters */
 	if ((params->entries > RTE_HASH_ENTRIES_MAX) ||
-			(params->entries < RTE_HASH_BUCKET_ENTRIES)) {
+			(params->entries < RTE_HASH_ENTRIES_MIN)) {
 		rte_errno = EINVAL;
 		HASH_LOG(ERR, "%s() entries (%u) must be in range [%d, %d] inclusive",
-			__func__, params->entries, RTE_HASH_BUCKET_ENTRIES,
+			__func__, params->entries, RTE_HASH_ENTRIES_MIN,
 			RTE_HASH_ENTRIES_MAX);
 		return NULL;
 	}
@@ -471,6 +472,13 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	h->readwrite_concur_lf_support = readwrite_concur_lf_support;
 
 #if defined(RTE_ARCH_X86)
+#ifdef CC_AVX512_SUPPORT
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW) &&
+			rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_512)
+		h->sig_cmp_fn = RTE_HASH_COMPARE_AVX512;
+	else
+#endif
 	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_SSE2))
 		h->sig_cmp_fn = RTE_HASH_COMPARE_SSE;
 	else
@@ -1931,7 +1939,7 @@ __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 
 #if DENSE_HASH_BULK_LOOKUP
 	const int hitmask_padding = 0;
-	uint16_t hitmask_buffer[RTE_HASH_LOOKUP_BULK_MAX] = {0};
+	hash_hitmask_t hitmask_buffer[RTE_HASH_LOOKUP_BULK_MAX] = {0};
 #else
 	const int hitmask_padding = 1;
 	uint32_t prim_hitmask_buffer[RTE_HASH_LOOKUP_BULK_MAX] = {0};
@@ -1940,16 +1948,24 @@ __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 
 	__hash_rw_reader_lock(h);
 
+#ifdef CC_AVX512_SUPPORT
+	if (h->sig_cmp_fn == RTE_HASH_COMPARE_AVX512)
+		compare_signatures_sparse_bulk_avx512(prim_hitmask_buffer,
+			sec_hitmask_buffer, primary_bkt, secondary_bkt,
+			sig, num_keys);
+#endif
+
 	/* Compare signatures and prefetch key slot of first hit */
 	for (i = 0; i < num_keys; i++) {
 #if DENSE_HASH_BULK_LOOKUP
-		uint16_t *hitmask = &hitmask_buffer[i];
+		hash_hitmask_t *hitmask = &hitmask_buffer[i];
 		compare_signatures_dense(hitmask,
 			primary_bkt[i]->sig_current,
 			secondary_bkt[i]->sig_current,
 			sig[i], h->sig_cmp_fn);
-		const unsigned int prim_hitmask = *(uint8_t *)(hitmask);
-		const unsigned int sec_hitmask = *((uint8_t *)(hitmask)+1);
+		const unsigned int prim_hitmask = *hitmask &
+			RTE_LEN2MASK(RTE_HASH_BUCKET_ENTRIES, hash_hitmask_t);
+		const unsigned int sec_hitmask = *hitmask >> RTE_HASH_BUCKET_ENTRIES;
 #else
 		compare_signatures_sparse(&prim_hitmask_buffer[i], &sec_hitmask_buffer[i],
 			primary_bkt[i], secondary_bkt[i],
@@ -1990,9 +2006,10 @@ __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 	for (i = 0; i < num_keys; i++) {
 		positions[i] = -ENOENT;
 #if DENSE_HASH_BULK_LOOKUP
-		uint16_t *hitmask = &hitmask_buffer[i];
-		unsigned int prim_hitmask = *(uint8_t *)(hitmask);
-		unsigned int sec_hitmask = *((uint8_t *)(hitmask)+1);
+		hash_hitmask_t *hitmask = &hitmask_buffer[i];
+		unsigned int prim_hitmask = *hitmask &
+			RTE_LEN2MASK(RTE_HASH_BUCKET_ENTRIES, hash_hitmask_t);
+		unsigned int sec_hitmask = *hitmask >> RTE_HASH_BUCKET_ENTRIES;
 #else
 		unsigned int prim_hitmask = prim_hitmask_buffer[i];
 		unsigned int sec_hitmask = sec_hitmask_buffer[i];
@@ -2106,7 +2123,7 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 
 #if DENSE_HASH_BULK_LOOKUP
 	const int hitmask_padding = 0;
-	uint16_t hitmask_buffer[RTE_HASH_LOOKUP_BULK_MAX] = {0};
+	hash_hitmask_t hitmask_buffer[RTE_HASH_LOOKUP_BULK_MAX] = {0};
 	static_assert(sizeof(*hitmask_buffer)*8/2 == RTE_HASH_BUCKET_ENTRIES,
 	"The hitmask must be exactly wide enough to accept the whole hitmask chen it is dense");
 #else
@@ -2126,16 +2143,24 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 		cnt_b = rte_atomic_load_explicit(h->tbl_chng_cnt,
 					rte_memory_order_acquire);
 
+#ifdef CC_AVX512_SUPPORT
+		if (h->sig_cmp_fn == RTE_HASH_COMPARE_AVX512)
+			compare_signatures_sparse_bulk_avx512(prim_hitmask_buffer,
+				sec_hitmask_buffer, primary_bkt, secondary_bkt,
+				sig, num_keys);
+#endif
+
 		/* Compare signatures and prefetch key slot of first hit */
 		for (i = 0; i < num_keys; i++) {
 #if DENSE_HASH_BULK_LOOKUP
-			uint16_t *hitmask = &hitmask_buffer[i];
+			hash_hitmask_t *hitmask = &hitmask_buffer[i];
 			compare_signatures_dense(hitmask,
 				primary_bkt[i]->sig_current,
 				secondary_bkt[i]->sig_current,
 				sig[i], h->sig_cmp_fn);
-			const unsigned int prim_hitmask = *(uint8_t *)(hitmask);
-			const unsigned int sec_hitmask = *((uint8_t *)(hitmask)+1);
+			const unsigned int prim_hitmask = *hitmask &
+				RTE_LEN2MASK(RTE_HASH_BUCKET_ENTRIES, hash_hitmask_t);
+			const unsigned int sec_hitmask = *hitmask >> RTE_HASH_BUCKET_ENTRIES;
 #else
 			compare_signatures_sparse(&prim_hitmask_buffer[i], &sec_hitmask_buffer[i],
 				primary_bkt[i], secondary_bkt[i],
@@ -2175,9 +2200,10 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 		/* Compare keys, first hits in primary first */
 		for (i = 0; i < num_keys; i++) {
 #if DENSE_HASH_BULK_LOOKUP
-			uint16_t *hitmask = &hitmask_buffer[i];
-			unsigned int prim_hitmask = *(uint8_t *)(hitmask);
-			unsigned int sec_hitmask = *((uint8_t *)(hitmask)+1);
+			hash_hitmask_t *hitmask = &hitmask_buffer[i];
+			unsigned int prim_hitmask = *hitmask &
+				RTE_LEN2MASK(RTE_HASH_BUCKET_ENTRIES, hash_hitmask_t);
+			unsigned int sec_hitmask = *hitmask >> RTE_HASH_BUCKET_ENTRIES;
 #else
 			unsigned int prim_hitmask = prim_hitmask_buffer[i];
 			unsigned int sec_hitmask = sec_hitmask_buffer[i];
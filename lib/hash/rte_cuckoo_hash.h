@@ -57,7 +57,7 @@ enum cmp_jump_table_case {
  * Table storing all different key compare functions
  * (multi-process supported)
  */
-const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
+static const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
 	NULL,
 	rte_hash_k16_cmp_eq,
 	rte_hash_k32_cmp_eq,
@@ -84,7 +84,7 @@ enum cmp_jump_table_case {
  * Table storing all different key compare functions
  * (multi-process supported)
  */
-const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
+static const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
 	NULL,
 	memcmp
 };
@@ -93,16 +93,28 @@ const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
 
 
 /**
- * Number of items per bucket.
+ * Number of items per bucket, can be overridden at build time.
  * 8 is a tradeoff between performance and memory consumption.
  * When it is equal to 8, multiple 'struct rte_hash_bucket' can be fit
  * on a single cache line (64 or 128 bytes long) without any gaps
  * in memory between them due to alignment.
+ * With 16, a bucket spans two 64-byte cache lines, but the table
+ * reaches a higher load before cuckoo displacement, and the signatures
+ * of both candidate buckets are compared in a single 512-bit operation.
  */
+#ifndef RTE_HASH_BUCKET_ENTRIES
 #define RTE_HASH_BUCKET_ENTRIES		8
+#endif
+
+#if RTE_HASH_BUCKET_ENTRIES != 8 && RTE_HASH_BUCKET_ENTRIES != 16
+#error RTE_HASH_BUCKET_ENTRIES must be 8 or 16
+#endif
 
-#if !RTE_IS_POWER_OF_2(RTE_HASH_BUCKET_ENTRIES)
-#error RTE_HASH_BUCKET_ENTRIES must be a power of 2
+/* Densely packed hitmask of a primary (low bits) and secondary bucket. */
+#if RTE_HASH_BUCKET_ENTRIES == 8
+typedef uint16_t hash_hitmask_t;
+#else
+typedef uint32_t hash_hitmask_t;
 #endif
 
 #define NULL_SIGNATURE			0
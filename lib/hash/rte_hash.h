@@ -23,6 +23,13 @@ extern "C" {
 /** Maximum size of hash table that can be created. */
 #define RTE_HASH_ENTRIES_MAX			(1 << 30)
 
+/** Minimum size of hash table that can be created: one bucket of entries. */
+#ifdef RTE_HASH_BUCKET_ENTRIES
+#define RTE_HASH_ENTRIES_MIN			RTE_HASH_BUCKET_ENTRIES
+#else
+#define RTE_HASH_ENTRIES_MIN			8
+#endif
+
 /** Maximum number of characters in hash name.*/
 #define RTE_HASH_NAMESIZE			32
 
@@ -8,6 +8,9 @@
 #include <sys/queue.h>
 
 #include <rte_common.h>
+#include <rte_prefetch.h>
+#include <rte_spinlock.h>
+#include <rte_tailq.h>
 
 #if defined(RTE_ARCH_ARM64)
 #include <rte_cmp_arm64.h>
@@ -34,8 +37,18 @@ extern int ipfrag_logtype;
 #define IPV4_KEYLEN 1
 #define IPV6_KEYLEN 4
 
+/* max number of packets hashed and prefetched ahead by the burst functions */
+#define IP_FRAG_BURST	32
+
 /* helper macros */
-#define	IP_FRAG_MBUF2DR(dr, mb)	((dr)->row[(dr)->cnt++] = (mb))
+#define	IP_FRAG_MBUF2DR(dr, mb)	ip_frag_mbuf2dr(dr, mb)
+
+#define	IP_FRAG_TBL_POS(tbl, sig)	\
+	((struct ip_frag_pkt *)((uintptr_t)(tbl)->pkt + \
+		(size_t)((sig) & (tbl)->entry_mask) * (tbl)->entry_size))
+
+#define	IP_FRAG_TBL_NEXT(tbl, fp)	\
+	((struct ip_frag_pkt *)((uintptr_t)(fp) + (tbl)->entry_size))
 
 #define IPv6_KEY_BYTES(key) \
 	(key)[0], (key)[1], (key)[2], (key)[3]
@@ -49,18 +62,26 @@ extern int ipfrag_logtype;
 #endif /* IP_FRAG_TBL_STAT */
 
 /* internal functions declarations */
-struct rte_mbuf * ip_frag_process(struct ip_frag_pkt *fp,
-		struct rte_ip_frag_death_row *dr, struct rte_mbuf *mb,
-		uint16_t ofs, uint16_t len, uint16_t more_frags);
+struct rte_mbuf * ip_frag_process(const struct rte_ip_frag_tbl *tbl,
+		struct ip_frag_pkt *fp, struct rte_ip_frag_death_row *dr,
+		struct rte_mbuf *mb, uint16_t ofs, uint16_t len,
+		uint16_t more_frags);
 
+/*
+ * sig is the pair of hash values of the key computed by ip_frag_key_hash(),
+ * it can be NULL for tables which are not shared.
+ */
 struct ip_frag_pkt * ip_frag_find(struct rte_ip_frag_tbl *tbl,
 		struct rte_ip_frag_death_row *dr,
-		const struct ip_frag_key *key, uint64_t tms);
+		const struct ip_frag_key *key, const uint32_t *sig,
+		uint64_t tms);
 
 struct ip_frag_pkt * ip_frag_lookup(struct rte_ip_frag_tbl *tbl,
-	const struct ip_frag_key *key, uint64_t tms,
+	const struct ip_frag_key *key, const uint32_t *sig, uint64_t tms,
 	struct ip_frag_pkt **free, struct ip_frag_pkt **stale);
 
+void ip_frag_key_hash(const struct ip_frag_key *key, uint32_t sig[2]);
+
 /* these functions need to be declared here as ip_frag_process relies on them */
 struct rte_mbuf *ipv4_frag_reassemble(struct ip_frag_pkt *fp);
 struct rte_mbuf *ipv6_frag_reassemble(struct ip_frag_pkt *fp);
@@ -107,6 +128,20 @@ ip_frag_key_cmp(const struct ip_frag_key * k1, const struct ip_frag_key * k2)
  * misc fragment functions
  */
 
+/*
+ * put mbuf on death row, or free it immediately if the death row is full,
+ * which can happen with tables allowing more than
+ * RTE_LIBRTE_IP_FRAG_MAX_FRAG fragments per packet.
+ */
+static inline void
+ip_frag_mbuf2dr(struct rte_ip_frag_death_row *dr, struct rte_mbuf *mb)
+{
+	if (likely(dr->cnt < RTE_DIM(dr->row)))
+		dr->row[dr->cnt++] = mb;
+	else
+		rte_pktmbuf_free(mb);
+}
+
 /* put fragment on death row */
 static inline void
 ip_frag_free(struct ip_frag_pkt *fp, struct rte_ip_frag_death_row *dr)
@@ -116,7 +151,10 @@ ip_frag_free(struct ip_frag_pkt *fp, struct rte_ip_frag_death_row *dr)
 	k = dr->cnt;
 	for (i = 0; i != fp->last_idx; i++) {
 		if (fp->frags[i].mb != NULL) {
-			dr->row[k++] = fp->frags[i].mb;
+			if (likely(k < RTE_DIM(dr->row)))
+				dr->row[k++] = fp->frags[i].mb;
+			else
+				rte_pktmbuf_free(fp->frags[i].mb);
 			fp->frags[i].mb = NULL;
 		}
 	}
@@ -145,13 +183,153 @@ ip_frag_free_immediate(struct ip_frag_pkt *fp)
 	fp->last_idx = 0;
 }
 
+/*
+ * shared table locking.
+ * Each associativity line has its own lock, taken for the two lines
+ * a key hashes to, in ascending order. The LRU list and the number of
+ * entries in use are protected by the LRU lock, which is taken while
+ * holding the line locks. Entries of other lines are only locked
+ * with a trylock while holding the LRU lock.
+ */
+
+/* index of the associativity line a hash value maps to */
+static inline uint32_t
+ip_frag_tbl_line(const struct rte_ip_frag_tbl *tbl, uint32_t sig)
+{
+	return (sig & tbl->entry_mask) >> rte_ctz32(tbl->bucket_entries);
+}
+
+/* index of the associativity line an entry belongs to */
+static inline uint32_t
+ip_frag_tbl_entry_line(const struct rte_ip_frag_tbl *tbl,
+	const struct ip_frag_pkt *fp)
+{
+	uint32_t idx;
+
+	idx = ((const uint8_t *)fp - tbl->pkt) / tbl->entry_size;
+	return idx >> rte_ctz32(tbl->bucket_entries);
+}
+
+static inline int
+ip_frag_tbl_is_shared(const struct rte_ip_frag_tbl *tbl)
+{
+	return (tbl->flags & RTE_IP_FRAG_TBL_F_SHARED) != 0;
+}
+
+/* lock the two lines of a key */
+static inline void
+ip_frag_tbl_lock(struct rte_ip_frag_tbl *tbl, const uint32_t sig[2])
+{
+	uint32_t l1, l2;
+
+	if (!ip_frag_tbl_is_shared(tbl))
+		return;
+
+	l1 = ip_frag_tbl_line(tbl, sig[0]);
+	l2 = ip_frag_tbl_line(tbl, sig[1]);
+
+	rte_spinlock_lock(&tbl->line_locks[RTE_MIN(l1, l2)]);
+	if (l1 != l2)
+		rte_spinlock_lock(&tbl->line_locks[RTE_MAX(l1, l2)]);
+}
+
+/* unlock the two lines of a key */
+static inline void
+ip_frag_tbl_unlock(struct rte_ip_frag_tbl *tbl, const uint32_t sig[2])
+{
+	uint32_t l1, l2;
+
+	if (!ip_frag_tbl_is_shared(tbl))
+		return;
+
+	l1 = ip_frag_tbl_line(tbl, sig[0]);
+	l2 = ip_frag_tbl_line(tbl, sig[1]);
+
+	if (l1 != l2)
+		rte_spinlock_unlock(&tbl->line_locks[RTE_MAX(l1, l2)]);
+	rte_spinlock_unlock(&tbl->line_locks[RTE_MIN(l1, l2)]);
+}
+
+/*
+ * try to lock the line of an entry, unless it is one of the lines
+ * of sig, already locked by the caller. sig can be NULL.
+ */
+static inline int
+ip_frag_tbl_trylock_entry(struct rte_ip_frag_tbl *tbl,
+	const struct ip_frag_pkt *fp, const uint32_t *sig)
+{
+	uint32_t l;
+
+	if (!ip_frag_tbl_is_shared(tbl))
+		return 1;
+
+	l = ip_frag_tbl_entry_line(tbl, fp);
+	if (sig != NULL && (l == ip_frag_tbl_line(tbl, sig[0]) ||
+			l == ip_frag_tbl_line(tbl, sig[1])))
+		return 1;
+
+	return rte_spinlock_trylock(&tbl->line_locks[l]);
+}
+
+/* unlock the line of an entry locked by ip_frag_tbl_trylock_entry() */
+static inline void
+ip_frag_tbl_unlock_entry(struct rte_ip_frag_tbl *tbl,
+	const struct ip_frag_pkt *fp, const uint32_t *sig)
+{
+	uint32_t l;
+
+	if (!ip_frag_tbl_is_shared(tbl))
+		return;
+
+	l = ip_frag_tbl_entry_line(tbl, fp);
+	if (sig != NULL && (l == ip_frag_tbl_line(tbl, sig[0]) ||
+			l == ip_frag_tbl_line(tbl, sig[1])))
+		return;
+
+	rte_spinlock_unlock(&tbl->line_locks[l]);
+}
+
+static inline void
+ip_frag_lru_lock(struct rte_ip_frag_tbl *tbl)
+{
+	if (ip_frag_tbl_is_shared(tbl))
+		rte_spinlock_lock(&tbl->lru_lock);
+}
+
+static inline void
+ip_frag_lru_unlock(struct rte_ip_frag_tbl *tbl)
+{
+	if (ip_frag_tbl_is_shared(tbl))
+		rte_spinlock_unlock(&tbl->lru_lock);
+}
+
+/* prefetch the entries of the two lines of a key */
+static inline void
+ip_frag_tbl_prefetch(const struct rte_ip_frag_tbl *tbl, const uint32_t sig[2])
+{
+	const struct ip_frag_pkt *p1, *p2;
+	uint32_t i;
+
+	p1 = IP_FRAG_TBL_POS(tbl, sig[0]);
+	p2 = IP_FRAG_TBL_POS(tbl, sig[1]);
+
+	for (i = 0; i != tbl->bucket_entries; i++) {
+		rte_prefetch0(p1);
+		rte_prefetch0(p2);
+		p1 = IP_FRAG_TBL_NEXT(tbl, p1);
+		p2 = IP_FRAG_TBL_NEXT(tbl, p2);
+	}
+}
+
 /* if key is empty, mark key as in use */
 static inline void
 ip_frag_inuse(struct rte_ip_frag_tbl *tbl, const struct  ip_frag_pkt *fp)
 {
 	if (ip_frag_key_is_empty(&fp->key)) {
+		ip_frag_lru_lock(tbl);
 		TAILQ_REMOVE(&tbl->lru, fp, lru);
 		tbl->use_entries--;
+		ip_frag_lru_unlock(tbl);
 	}
 }
 
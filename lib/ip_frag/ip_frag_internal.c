@@ -11,9 +11,6 @@
 
 #define	PRIME_VALUE	0xeaad8405
 
-#define	IP_FRAG_TBL_POS(tbl, sig)	\
-	((tbl)->pkt + ((sig) & (tbl)->entry_mask))
-
 static inline void
 ip_frag_tbl_add(struct rte_ip_frag_tbl *tbl,  struct ip_frag_pkt *fp,
 	const struct ip_frag_key *key, uint64_t tms)
@@ -87,9 +84,20 @@ ipv6_frag_hash(const struct ip_frag_key *key, uint32_t *v1, uint32_t *v2)
 	*v2 = (v << 7) + (v >> 14);
 }
 
+/* different hashing methods for IPv4 and IPv6 */
+void
+ip_frag_key_hash(const struct ip_frag_key *key, uint32_t sig[2])
+{
+	if (key->key_len == IPV4_KEYLEN)
+		ipv4_frag_hash(key, &sig[0], &sig[1]);
+	else
+		ipv6_frag_hash(key, &sig[0], &sig[1]);
+}
+
 struct rte_mbuf *
-ip_frag_process(struct ip_frag_pkt *fp, struct rte_ip_frag_death_row *dr,
-	struct rte_mbuf *mb, uint16_t ofs, uint16_t len, uint16_t more_frags)
+ip_frag_process(const struct rte_ip_frag_tbl *tbl, struct ip_frag_pkt *fp,
+	struct rte_ip_frag_death_row *dr, struct rte_mbuf *mb, uint16_t ofs,
+	uint16_t len, uint16_t more_frags)
 {
 	uint32_t idx;
 
@@ -107,7 +115,7 @@ ip_frag_process(struct ip_frag_pkt *fp, struct rte_ip_frag_death_row *dr,
 				IP_LAST_FRAG_IDX : UINT32_MAX;
 
 	/* this is the intermediate fragment. */
-	} else if ((idx = fp->last_idx) < RTE_DIM(fp->frags)) {
+	} else if ((idx = fp->last_idx) < tbl->max_frags) {
 		fp->last_idx++;
 	}
 
@@ -115,7 +123,7 @@ ip_frag_process(struct ip_frag_pkt *fp, struct rte_ip_frag_death_row *dr,
 	 * erroneous packet: either exceed max allowed number of fragments,
 	 * or duplicate first/last fragment encountered.
 	 */
-	if (idx >= RTE_DIM(fp->frags)) {
+	if (idx >= tbl->max_frags) {
 
 		/* report an error. */
 		if (fp->key.key_len == IPV4_KEYLEN)
@@ -220,7 +228,7 @@ ip_frag_process(struct ip_frag_pkt *fp, struct rte_ip_frag_death_row *dr,
  */
 struct ip_frag_pkt *
 ip_frag_find(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
-	const struct ip_frag_key *key, uint64_t tms)
+	const struct ip_frag_key *key, const uint32_t *sig, uint64_t tms)
 {
 	struct ip_frag_pkt *pkt, *free, *stale, *lru;
 	uint64_t max_cycles;
@@ -235,7 +243,9 @@ ip_frag_find(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
 
 	IP_FRAG_TBL_STAT_UPDATE(&tbl->stat, find_num, 1);
 
-	if ((pkt = ip_frag_lookup(tbl, key, tms, &free, &stale)) == NULL) {
+	if ((pkt = ip_frag_lookup(tbl, key, sig, tms, &free, &stale)) == NULL) {
+
+		ip_frag_lru_lock(tbl);
 
 		/*timed-out entry, free and invalidate it*/
 		if (stale != NULL) {
@@ -250,8 +260,10 @@ ip_frag_find(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
 		} else if (free != NULL &&
 				tbl->max_entries <= tbl->use_entries) {
 			lru = TAILQ_FIRST(&tbl->lru);
-			if (max_cycles + lru->start < tms) {
+			if (max_cycles + lru->start < tms &&
+					ip_frag_tbl_trylock_entry(tbl, lru, sig)) {
 				ip_frag_tbl_del(tbl, dr, lru);
+				ip_frag_tbl_unlock_entry(tbl, lru, sig);
 			} else {
 				free = NULL;
 				IP_FRAG_TBL_STAT_UPDATE(&tbl->stat,
@@ -265,30 +277,36 @@ ip_frag_find(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
 			pkt = free;
 		}
 
+		ip_frag_lru_unlock(tbl);
+
 	/*
 	 * we found the flow, but it is already timed out,
 	 * so free associated resources, reposition it in the LRU list,
 	 * and reuse it.
 	 */
 	} else if (max_cycles + pkt->start < tms) {
+		ip_frag_lru_lock(tbl);
 		ip_frag_tbl_reuse(tbl, dr, pkt, tms);
+		ip_frag_lru_unlock(tbl);
 	}
 
 	IP_FRAG_TBL_STAT_UPDATE(&tbl->stat, fail_total, (pkt == NULL));
 
-	tbl->last = pkt;
+	/* entries of a shared table can change once its lines are unlocked */
+	if (!ip_frag_tbl_is_shared(tbl))
+		tbl->last = pkt;
 	return pkt;
 }
 
 struct ip_frag_pkt *
 ip_frag_lookup(struct rte_ip_frag_tbl *tbl,
-	const struct ip_frag_key *key, uint64_t tms,
+	const struct ip_frag_key *key, const uint32_t *sig, uint64_t tms,
 	struct ip_frag_pkt **free, struct ip_frag_pkt **stale)
 {
 	struct ip_frag_pkt *p1, *p2;
 	struct ip_frag_pkt *empty, *old;
 	uint64_t max_cycles;
-	uint32_t i, assoc, sig1, sig2;
+	uint32_t i, assoc, hsig[2];
 
 	empty = NULL;
 	old = NULL;
@@ -299,14 +317,13 @@ ip_frag_lookup(struct rte_ip_frag_tbl *tbl,
 	if (tbl->last != NULL && ip_frag_key_cmp(key, &tbl->last->key) == 0)
 		return tbl->last;
 
-	/* different hashing methods for IPv4 and IPv6 */
-	if (key->key_len == IPV4_KEYLEN)
-		ipv4_frag_hash(key, &sig1, &sig2);
-	else
-		ipv6_frag_hash(key, &sig1, &sig2);
+	if (sig == NULL) {
+		ip_frag_key_hash(key, hsig);
+		sig = hsig;
+	}
 
-	p1 = IP_FRAG_TBL_POS(tbl, sig1);
-	p2 = IP_FRAG_TBL_POS(tbl, sig2);
+	p1 = IP_FRAG_TBL_POS(tbl, sig[0]);
+	p2 = IP_FRAG_TBL_POS(tbl, sig[1]);
 
 	for (i = 0; i != assoc; i++) {
 		if (p1->key.key_len == IPV4_KEYLEN)
@@ -317,7 +334,7 @@ ip_frag_lookup(struct rte_ip_frag_tbl *tbl,
 					__func__, __LINE__,
 					tbl, tbl->max_entries, tbl->use_entries,
 					p1, i, assoc,
-			p1[i].key.src_dst[0], p1[i].key.id, p1[i].start);
+			p1->key.src_dst[0], p1->key.id, p1->start);
 		else
 			IP_FRAG_LOG(DEBUG, "%s:%d:\n"
 					"tbl: %p, max_entries: %u, use_entries: %u\n"
@@ -326,14 +343,14 @@ ip_frag_lookup(struct rte_ip_frag_tbl *tbl,
 					__func__, __LINE__,
 					tbl, tbl->max_entries, tbl->use_entries,
 					p1, i, assoc,
-			IPv6_KEY_BYTES(p1[i].key.src_dst), p1[i].key.id, p1[i].start);
+			IPv6_KEY_BYTES(p1->key.src_dst), p1->key.id, p1->start);
 
-		if (ip_frag_key_cmp(key, &p1[i].key) == 0)
-			return p1 + i;
-		else if (ip_frag_key_is_empty(&p1[i].key))
-			empty = (empty == NULL) ? (p1 + i) : empty;
-		else if (max_cycles + p1[i].start < tms)
-			old = (old == NULL) ? (p1 + i) : old;
+		if (ip_frag_key_cmp(key, &p1->key) == 0)
+			return p1;
+		else if (ip_frag_key_is_empty(&p1->key))
+			empty = (empty == NULL) ? p1 : empty;
+		else if (max_cycles + p1->start < tms)
+			old = (old == NULL) ? p1 : old;
 
 		if (p2->key.key_len == IPV4_KEYLEN)
 			IP_FRAG_LOG(DEBUG, "%s:%d:\n"
@@ -343,7 +360,7 @@ ip_frag_lookup(struct rte_ip_frag_tbl *tbl,
 					__func__, __LINE__,
 					tbl, tbl->max_entries, tbl->use_entries,
 					p2, i, assoc,
-			p2[i].key.src_dst[0], p2[i].key.id, p2[i].start);
+			p2->key.src_dst[0], p2->key.id, p2->start);
 		else
 			IP_FRAG_LOG(DEBUG, "%s:%d:\n"
 					"tbl: %p, max_entries: %u, use_entries: %u\n"
@@ -352,14 +369,17 @@ ip_frag_lookup(struct rte_ip_frag_tbl *tbl,
 					__func__, __LINE__,
 					tbl, tbl->max_entries, tbl->use_entries,
 					p2, i, assoc,
-			IPv6_KEY_BYTES(p2[i].key.src_dst), p2[i].key.id, p2[i].start);
-
-		if (ip_frag_key_cmp(key, &p2[i].key) == 0)
-			return p2 + i;
-		else if (ip_frag_key_is_empty(&p2[i].key))
-			empty = (empty == NULL) ?( p2 + i) : empty;
-		else if (max_cycles + p2[i].start < tms)
-			old = (old == NULL) ? (p2 + i) : old;
+			IPv6_KEY_BYTES(p2->key.src_dst), p2->key.id, p2->start);
+
+		if (ip_frag_key_cmp(key, &p2->key) == 0)
+			return p2;
+		else if (ip_frag_key_is_empty(&p2->key))
+			empty = (empty == NULL) ? p2 : empty;
+		else if (max_cycles + p2->start < tms)
+			old = (old == NULL) ? p2 : old;
+
+		p1 = IP_FRAG_TBL_NEXT(tbl, p1);
+		p2 = IP_FRAG_TBL_NEXT(tbl, p2);
 	}
 
 	*free = empty;
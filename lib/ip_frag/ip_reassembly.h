@@ -11,13 +11,14 @@
  */
 
 #include <rte_ip_frag.h>
+#include <rte_spinlock.h>
 
 enum {
 	IP_LAST_FRAG_IDX,    /* index of last fragment */
 	IP_FIRST_FRAG_IDX,   /* index of first fragment */
 	IP_MIN_FRAG_NUM,     /* minimum number of fragments */
 	IP_MAX_FRAG_NUM = RTE_LIBRTE_IP_FRAG_MAX_FRAG,
-	/* maximum number of fragments per packet */
+	/* default maximum number of fragments per packet */
 };
 
 /* fragmented mbuf */
@@ -46,6 +47,7 @@ struct ip_frag_key {
 /*
  * Fragmented packet to reassemble.
  * First two entries in the frags[] array are for the last and first fragments.
+ * The size of frags[] is the max_frags value of the table.
  */
 struct __rte_cache_aligned ip_frag_pkt {
 	RTE_TAILQ_ENTRY(ip_frag_pkt) lru;      /* LRU list */
@@ -54,7 +56,7 @@ struct __rte_cache_aligned ip_frag_pkt {
 	uint32_t total_size;                   /* expected reassembled size */
 	uint32_t frag_size;                    /* size of fragments received */
 	uint32_t last_idx;                     /* index of next entry to fill */
-	struct ip_frag frags[IP_MAX_FRAG_NUM]; /* fragments */
+	struct ip_frag frags[];                /* fragments */
 };
 
  /* fragments tailq */
@@ -79,10 +81,15 @@ struct rte_ip_frag_tbl {
 	uint32_t bucket_entries; /* hash associativity. */
 	uint32_t nb_entries;     /* total size of the table. */
 	uint32_t nb_buckets;     /* num of associativity lines. */
+	uint32_t max_frags;      /* max fragments per packet. */
+	uint32_t entry_size;     /* size of each entry in bytes. */
+	uint32_t flags;          /* RTE_IP_FRAG_TBL_F_* flags. */
 	struct ip_frag_pkt *last;     /* last used entry. */
 	struct ip_pkt_list lru;       /* LRU list for table entries. */
+	rte_spinlock_t lru_lock;      /* LRU list lock for shared tables. */
+	rte_spinlock_t *line_locks;   /* per line locks for shared tables. */
 	struct ip_frag_tbl_stat stat; /* statistics counters. */
-	struct ip_frag_pkt pkt[]; /* hash table. */
+	alignas(RTE_CACHE_LINE_SIZE) uint8_t pkt[]; /* hash table. */
 };
 
 #endif /* _IP_REASSEMBLY_H_ */
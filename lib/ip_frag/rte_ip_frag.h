@@ -15,6 +15,7 @@
 #include <stdint.h>
 #include <stdio.h>
 
+#include <rte_compat.h>
 #include <rte_config.h>
 #include <rte_malloc.h>
 #include <rte_memory.h>
@@ -64,6 +65,57 @@ struct rte_ip_frag_tbl * rte_ip_frag_table_create(uint32_t bucket_num,
 		uint32_t bucket_entries,  uint32_t max_entries,
 		uint64_t max_cycles, int socket_id);
 
+/** The fragmentation table can be used by several lcores at once. */
+#define RTE_IP_FRAG_TBL_F_SHARED RTE_BIT32(0)
+
+/**
+ * Parameters used to create an IP fragmentation table
+ * with rte_ip_frag_table_create_ext().
+ */
+struct rte_ip_frag_tbl_param {
+	uint32_t bucket_num;
+	/**< Number of buckets in the hash table. */
+	uint32_t bucket_entries;
+	/**< Number of entries per bucket, should be power of two. */
+	uint32_t max_entries;
+	/**< Maximum number of entries that could be stored in the table. */
+	uint32_t max_frags;
+	/**< Maximum number of fragments per packet, at least 2.
+	 * 0 means RTE_LIBRTE_IP_FRAG_MAX_FRAG.
+	 */
+	uint64_t max_cycles;
+	/**< Maximum TTL in cycles for each fragmented packet. */
+	int socket_id;
+	/**< Socket to allocate the table on, or SOCKET_ID_ANY. */
+	uint32_t flags;
+	/**< RTE_IP_FRAG_TBL_F_* flags. */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Create a new IP fragmentation table with extended parameters.
+ *
+ * Unlike the tables created by rte_ip_frag_table_create(), the maximum
+ * number of fragments per packet is set at runtime. Fragments beyond
+ * what a death row can hold are freed immediately.
+ *
+ * If RTE_IP_FRAG_TBL_F_SHARED is set, the table can be used by several
+ * lcores at once, so fragments of one packet received on different
+ * queues are reassembled together. Each associativity line of the hash
+ * table is then protected by its own lock, and the table statistics
+ * become approximate. Each lcore must use its own death row.
+ *
+ * @param param
+ *   Parameters of the table.
+ * @return
+ *   The pointer to the new allocated fragmentation table, on success. NULL on error.
+ */
+__rte_experimental
+struct rte_ip_frag_tbl *
+rte_ip_frag_table_create_ext(const struct rte_ip_frag_tbl_param *param);
+
 /**
  * Free allocated IP fragmentation table.
  *
@@ -128,6 +180,37 @@ struct rte_mbuf *rte_ipv6_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 		struct rte_mbuf *mb, uint64_t tms, struct rte_ipv6_hdr *ip_hdr,
 		struct rte_ipv6_fragment_ext *frag_hdr);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * This function implements reassembly of a burst of IPv6 packets.
+ * Incoming mbufs should have their l2_len/l3_len fields setup correctly.
+ * The hash table buckets of all fragments are prefetched before
+ * the fragments are processed one by one.
+ *
+ * Only fragments whose fragment header directly follows the IPv6 header
+ * are processed. Other packets are returned unmodified.
+ *
+ * @param tbl
+ *   Table where to lookup/add the fragmented packets.
+ * @param dr
+ *   Death row to free buffers to
+ * @param mbs
+ *   Incoming mbufs. It is also used to return the reassembled packets
+ *   and the packets which are not fragments, in their arrival order.
+ * @param nb_pkts
+ *   Number of mbufs in mbs.
+ * @param tms
+ *   Fragments arrival timestamp.
+ * @return
+ *   Number of packets returned in mbs.
+ */
+__rte_experimental
+uint16_t rte_ipv6_frag_reassemble_burst(struct rte_ip_frag_tbl *tbl,
+		struct rte_ip_frag_death_row *dr, struct rte_mbuf **mbs,
+		uint16_t nb_pkts, uint64_t tms);
+
 /**
  * Return a pointer to the packet's fragment header, if found.
  * It only looks at the extension header that's right after the fixed IPv6
@@ -234,6 +317,36 @@ struct rte_mbuf * rte_ipv4_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 		struct rte_ip_frag_death_row *dr,
 		struct rte_mbuf *mb, uint64_t tms, struct rte_ipv4_hdr *ip_hdr);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * This function implements reassembly of a burst of IPv4 packets.
+ * Incoming mbufs should have their l2_len/l3_len fields setup correctly.
+ * The hash table buckets of all fragments are prefetched before
+ * the fragments are processed one by one.
+ *
+ * Packets which are not fragments are returned unmodified.
+ *
+ * @param tbl
+ *   Table where to lookup/add the fragmented packets.
+ * @param dr
+ *   Death row to free buffers to
+ * @param mbs
+ *   Incoming mbufs. It is also used to return the reassembled packets
+ *   and the packets which are not fragments, in their arrival order.
+ * @param nb_pkts
+ *   Number of mbufs in mbs.
+ * @param tms
+ *   Fragments arrival timestamp.
+ * @return
+ *   Number of packets returned in mbs.
+ */
+__rte_experimental
+uint16_t rte_ipv4_frag_reassemble_burst(struct rte_ip_frag_tbl *tbl,
+		struct rte_ip_frag_death_row *dr, struct rte_mbuf **mbs,
+		uint16_t nb_pkts, uint64_t tms);
+
 /**
  * Check if the IPv4 packet is fragmented
  *
@@ -39,48 +39,93 @@ rte_ip_frag_free_death_row(struct rte_ip_frag_death_row *dr,
 
 /* create fragmentation table */
 struct rte_ip_frag_tbl *
-rte_ip_frag_table_create(uint32_t bucket_num, uint32_t bucket_entries,
-	uint32_t max_entries, uint64_t max_cycles, int socket_id)
+rte_ip_frag_table_create_ext(const struct rte_ip_frag_tbl_param *param)
 {
 	struct rte_ip_frag_tbl *tbl;
-	size_t sz;
+	size_t sz, entry_sz, locks_ofs;
 	uint64_t nb_entries;
+	uint32_t i, max_frags, nb_lines;
 
-	nb_entries = rte_align32pow2(bucket_num);
-	nb_entries *= bucket_entries;
+	if (param == NULL) {
+		IP_FRAG_LOG_LINE(ERR, "%s: invalid input parameter", __func__);
+		return NULL;
+	}
+
+	max_frags = (param->max_frags == 0) ?
+		IP_MAX_FRAG_NUM : param->max_frags;
+
+	nb_entries = rte_align32pow2(param->bucket_num);
+	nb_entries *= param->bucket_entries;
 	nb_entries *= IP_FRAG_HASH_FNUM;
 
 	/* check input parameters. */
-	if (rte_is_power_of_2(bucket_entries) == 0 ||
+	if (rte_is_power_of_2(param->bucket_entries) == 0 ||
 			nb_entries > UINT32_MAX || nb_entries == 0 ||
-			nb_entries < max_entries) {
+			nb_entries < param->max_entries ||
+			max_frags < IP_MIN_FRAG_NUM || max_frags > UINT16_MAX ||
+			(param->flags & ~RTE_IP_FRAG_TBL_F_SHARED) != 0) {
 		IP_FRAG_LOG_LINE(ERR, "%s: invalid input parameter", __func__);
 		return NULL;
 	}
 
-	sz = sizeof (*tbl) + nb_entries * sizeof (tbl->pkt[0]);
-	if ((tbl = rte_zmalloc_socket(__func__, sz, RTE_CACHE_LINE_SIZE,
-			socket_id)) == NULL) {
+	/* entries are cache line aligned, followed by the line locks. */
+	entry_sz = RTE_ALIGN_CEIL(offsetof(struct ip_frag_pkt, frags) +
+		max_frags * sizeof(struct ip_frag), RTE_CACHE_LINE_SIZE);
+	nb_lines = nb_entries / param->bucket_entries;
+	locks_ofs = sizeof(*tbl) + nb_entries * entry_sz;
+	sz = locks_ofs;
+	if (param->flags & RTE_IP_FRAG_TBL_F_SHARED)
+		sz += nb_lines * sizeof(rte_spinlock_t);
+
+	tbl = rte_zmalloc_socket(__func__, sz, RTE_CACHE_LINE_SIZE,
+			param->socket_id);
+	if (tbl == NULL) {
 		IP_FRAG_LOG_LINE(ERR,
 			"%s: allocation of %zu bytes at socket %d failed do",
-			__func__, sz, socket_id);
+			__func__, sz, param->socket_id);
 		return NULL;
 	}
 
 	IP_FRAG_LOG_LINE(INFO, "%s: allocated of %zu bytes at socket %d",
-		__func__, sz, socket_id);
+		__func__, sz, param->socket_id);
 
-	tbl->max_cycles = max_cycles;
-	tbl->max_entries = max_entries;
+	tbl->max_cycles = param->max_cycles;
+	tbl->max_entries = param->max_entries;
 	tbl->nb_entries = (uint32_t)nb_entries;
-	tbl->nb_buckets = bucket_num;
-	tbl->bucket_entries = bucket_entries;
+	tbl->nb_buckets = param->bucket_num;
+	tbl->bucket_entries = param->bucket_entries;
 	tbl->entry_mask = (tbl->nb_entries - 1) & ~(tbl->bucket_entries  - 1);
+	tbl->max_frags = max_frags;
+	tbl->entry_size = entry_sz;
+	tbl->flags = param->flags;
+
+	rte_spinlock_init(&tbl->lru_lock);
+	if (param->flags & RTE_IP_FRAG_TBL_F_SHARED) {
+		tbl->line_locks = (rte_spinlock_t *)((uintptr_t)tbl + locks_ofs);
+		for (i = 0; i != nb_lines; i++)
+			rte_spinlock_init(&tbl->line_locks[i]);
+	}
 
 	TAILQ_INIT(&(tbl->lru));
 	return tbl;
 }
 
+struct rte_ip_frag_tbl *
+rte_ip_frag_table_create(uint32_t bucket_num, uint32_t bucket_entries,
+	uint32_t max_entries, uint64_t max_cycles, int socket_id)
+{
+	struct rte_ip_frag_tbl_param param = {
+		.bucket_num = bucket_num,
+		.bucket_entries = bucket_entries,
+		.max_entries = max_entries,
+		.max_frags = IP_MAX_FRAG_NUM,
+		.max_cycles = max_cycles,
+		.socket_id = socket_id,
+	};
+
+	return rte_ip_frag_table_create_ext(&param);
+}
+
 /* delete fragmentation table */
 void
 rte_ip_frag_table_destroy(struct rte_ip_frag_tbl *tbl)
@@ -129,18 +174,26 @@ rte_ip_frag_table_del_expired_entries(struct rte_ip_frag_tbl *tbl,
 	struct rte_ip_frag_death_row *dr, uint64_t tms)
 {
 	uint64_t max_cycles;
-	struct ip_frag_pkt *fp;
+	struct ip_frag_pkt *fp, *next;
 
 	max_cycles = tbl->max_cycles;
 
-	TAILQ_FOREACH(fp, &tbl->lru, lru)
-		if (max_cycles + fp->start < tms) {
-			/* check that death row has enough space */
-			if (RTE_IP_FRAG_DEATH_ROW_MBUF_LEN - dr->cnt >=
-					fp->last_idx)
-				ip_frag_tbl_del(tbl, dr, fp);
-			else
-				return;
-		} else
-			return;
+	ip_frag_lru_lock(tbl);
+
+	/*
+	 * In a shared table, an entry whose line is locked by another lcore
+	 * is being updated, so stop there.
+	 */
+	RTE_TAILQ_FOREACH_SAFE(fp, &tbl->lru, lru, next) {
+		if (max_cycles + fp->start >= tms ||
+				RTE_IP_FRAG_DEATH_ROW_MBUF_LEN - dr->cnt <
+				fp->last_idx ||
+				!ip_frag_tbl_trylock_entry(tbl, fp, NULL))
+			break;
+
+		ip_frag_tbl_del(tbl, dr, fp);
+		ip_frag_tbl_unlock_entry(tbl, fp, NULL);
+	}
+
+	ip_frag_lru_unlock(tbl);
 }
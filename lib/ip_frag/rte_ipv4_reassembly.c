@@ -78,30 +78,29 @@ ipv4_frag_reassemble(struct ip_frag_pkt *fp)
 	return m;
 }
 
+/* fill the reassembly key of an IPv4 fragment */
+static inline void
+ipv4_frag_key(const struct rte_ipv4_hdr *ip_hdr, struct ip_frag_key *key)
+{
+	/* use first 8 bytes only */
+	memcpy(&key->src_dst[0], &ip_hdr->src_addr, 8);
+	key->id = ip_hdr->packet_id;
+	key->key_len = IPV4_KEYLEN;
+}
+
 /*
- * Process new mbuf with fragment of IPV4 packet.
- * Incoming mbuf should have it's l2_len/l3_len fields setup correctly.
- * @param tbl
- *   Table where to lookup/add the fragmented packet.
- * @param mb
- *   Incoming mbuf with IPV4 fragment.
- * @param tms
- *   Fragment arrival timestamp.
- * @param ip_hdr
- *   Pointer to the IPV4 header inside the fragment.
- * @return
- *   Pointer to mbuf for reassembled packet, or NULL if:
- *   - an error occurred.
- *   - not all fragments of the packet are collected yet.
+ * Process new mbuf with fragment of IPV4 packet, whose key has been
+ * computed already, and whose hash values sig can be NULL.
  */
-struct rte_mbuf *
-rte_ipv4_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
+static inline struct rte_mbuf *
+ipv4_frag_reassemble_key(struct rte_ip_frag_tbl *tbl,
 	struct rte_ip_frag_death_row *dr, struct rte_mbuf *mb, uint64_t tms,
-	struct rte_ipv4_hdr *ip_hdr)
+	const struct rte_ipv4_hdr *ip_hdr, const struct ip_frag_key *key,
+	const uint32_t *sig)
 {
 	struct ip_frag_pkt *fp;
-	struct ip_frag_key key;
 	uint16_t flag_offset, ip_ofs, ip_flag;
+	uint32_t hsig[2];
 	int32_t ip_len;
 	int32_t trim;
 
@@ -109,11 +108,6 @@ rte_ipv4_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 	ip_ofs = (uint16_t)(flag_offset & RTE_IPV4_HDR_OFFSET_MASK);
 	ip_flag = (uint16_t)(flag_offset & RTE_IPV4_HDR_MF_FLAG);
 
-	/* use first 8 bytes only */
-	memcpy(&key.src_dst[0], &ip_hdr->src_addr, 8);
-	key.id = ip_hdr->packet_id;
-	key.key_len = IPV4_KEYLEN;
-
 	ip_ofs *= RTE_IPV4_HDR_OFFSET_UNITS;
 	ip_len = rte_be_to_cpu_16(ip_hdr->total_length) - mb->l3_len;
 	trim = mb->pkt_len - (ip_len + mb->l3_len + mb->l2_len);
@@ -124,7 +118,7 @@ rte_ipv4_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 		"tbl: %p, max_cycles: %" PRIu64 ", entry_mask: %#x, "
 		"max_entries: %u, use_entries: %u\n\n",
 		__func__, __LINE__,
-		mb, tms, key.src_dst[0], key.id, ip_ofs, ip_len, trim, ip_flag,
+		mb, tms, key->src_dst[0], key->id, ip_ofs, ip_len, trim, ip_flag,
 		tbl, tbl->max_cycles, tbl->entry_mask, tbl->max_entries,
 		tbl->use_entries);
 
@@ -137,8 +131,17 @@ rte_ipv4_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 	if (unlikely(trim > 0))
 		rte_pktmbuf_trim(mb, trim);
 
+	/* shared tables need the hash values to lock the key lines. */
+	if (sig == NULL && ip_frag_tbl_is_shared(tbl)) {
+		ip_frag_key_hash(key, hsig);
+		sig = hsig;
+	}
+
+	ip_frag_tbl_lock(tbl, sig);
+
 	/* try to find/add entry into the fragment's table. */
-	if ((fp = ip_frag_find(tbl, dr, &key, tms)) == NULL) {
+	if ((fp = ip_frag_find(tbl, dr, key, sig, tms)) == NULL) {
+		ip_frag_tbl_unlock(tbl, sig);
 		IP_FRAG_MBUF2DR(dr, mb);
 		return NULL;
 	}
@@ -154,7 +157,7 @@ rte_ipv4_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 
 
 	/* process the fragmented packet. */
-	mb = ip_frag_process(fp, dr, mb, ip_ofs, ip_len, ip_flag);
+	mb = ip_frag_process(tbl, fp, dr, mb, ip_ofs, ip_len, ip_flag);
 	ip_frag_inuse(tbl, fp);
 
 	IP_FRAG_LOG(DEBUG, "%s:%d:\n"
@@ -167,5 +170,83 @@ rte_ipv4_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 		fp, fp->key.src_dst[0], fp->key.id, fp->start,
 		fp->total_size, fp->frag_size, fp->last_idx);
 
+	ip_frag_tbl_unlock(tbl, sig);
+
 	return mb;
 }
+
+/*
+ * Process new mbuf with fragment of IPV4 packet.
+ * Incoming mbuf should have it's l2_len/l3_len fields setup correctly.
+ * @param tbl
+ *   Table where to lookup/add the fragmented packet.
+ * @param mb
+ *   Incoming mbuf with IPV4 fragment.
+ * @param tms
+ *   Fragment arrival timestamp.
+ * @param ip_hdr
+ *   Pointer to the IPV4 header inside the fragment.
+ * @return
+ *   Pointer to mbuf for reassembled packet, or NULL if:
+ *   - an error occurred.
+ *   - not all fragments of the packet are collected yet.
+ */
+struct rte_mbuf *
+rte_ipv4_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
+	struct rte_ip_frag_death_row *dr, struct rte_mbuf *mb, uint64_t tms,
+	struct rte_ipv4_hdr *ip_hdr)
+{
+	struct ip_frag_key key;
+
+	ipv4_frag_key(ip_hdr, &key);
+	return ipv4_frag_reassemble_key(tbl, dr, mb, tms, ip_hdr, &key, NULL);
+}
+
+/*
+ * Process a burst of IPV4 packets.
+ * The keys of a group of fragments are hashed and their table lines
+ * prefetched, before the fragments are processed one by one.
+ */
+uint16_t
+rte_ipv4_frag_reassemble_burst(struct rte_ip_frag_tbl *tbl,
+	struct rte_ip_frag_death_row *dr, struct rte_mbuf **mbs,
+	uint16_t nb_pkts, uint64_t tms)
+{
+	struct ip_frag_key key[IP_FRAG_BURST];
+	uint32_t sig[IP_FRAG_BURST][2];
+	const struct rte_ipv4_hdr *ip_hdr;
+	struct rte_mbuf *mb;
+	uint32_t i, j, k, n;
+
+	k = 0;
+	for (i = 0; i != nb_pkts; i += n) {
+		n = RTE_MIN(nb_pkts - i, (uint32_t)IP_FRAG_BURST);
+
+		for (j = 0; j != n; j++) {
+			mb = mbs[i + j];
+			ip_hdr = rte_pktmbuf_mtod_offset(mb,
+				const struct rte_ipv4_hdr *, mb->l2_len);
+			if (rte_ipv4_frag_pkt_is_fragmented(ip_hdr)) {
+				ipv4_frag_key(ip_hdr, &key[j]);
+				ip_frag_key_hash(&key[j], sig[j]);
+				ip_frag_tbl_prefetch(tbl, sig[j]);
+			} else
+				ip_frag_key_invalidate(&key[j]);
+		}
+
+		for (j = 0; j != n; j++) {
+			mb = mbs[i + j];
+			if (!ip_frag_key_is_empty(&key[j])) {
+				ip_hdr = rte_pktmbuf_mtod_offset(mb,
+					const struct rte_ipv4_hdr *,
+					mb->l2_len);
+				mb = ipv4_frag_reassemble_key(tbl, dr, mb, tms,
+					ip_hdr, &key[j], sig[j]);
+			}
+			if (mb != NULL)
+				mbs[k++] = mb;
+		}
+	}
+
+	return k;
+}
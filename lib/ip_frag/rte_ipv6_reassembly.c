@@ -112,43 +112,38 @@ ipv6_frag_reassemble(struct ip_frag_pkt *fp)
 	return m;
 }
 
-/*
- * Process new mbuf with fragment of IPV6 datagram.
- * Incoming mbuf should have its l2_len/l3_len fields setup correctly.
- * @param tbl
- *   Table where to lookup/add the fragmented packet.
- * @param mb
- *   Incoming mbuf with IPV6 fragment.
- * @param tms
- *   Fragment arrival timestamp.
- * @param ip_hdr
- *   Pointer to the IPV6 header.
- * @param frag_hdr
- *   Pointer to the IPV6 fragment extension header.
- * @return
- *   Pointer to mbuf for reassembled packet, or NULL if:
- *   - an error occurred.
- *   - not all fragments of the packet are collected yet.
- */
+/* fill the reassembly key of an IPv6 fragment */
+static inline void
+ipv6_frag_key(const struct rte_ipv6_hdr *ip_hdr,
+	const struct rte_ipv6_fragment_ext *frag_hdr, struct ip_frag_key *key)
+{
+	rte_memcpy(&key->src_dst[0], &ip_hdr->src_addr, 16);
+	rte_memcpy(&key->src_dst[2], &ip_hdr->dst_addr, 16);
+
+	key->id = frag_hdr->id;
+	key->key_len = IPV6_KEYLEN;
+}
+
 #define MORE_FRAGS(x) (((x) & 0x100) >> 8)
 #define FRAG_OFFSET(x) (rte_cpu_to_be_16(x) >> 3)
-struct rte_mbuf *
-rte_ipv6_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
+
+/*
+ * Process new mbuf with fragment of IPV6 datagram, whose key has been
+ * computed already, and whose hash values sig can be NULL.
+ */
+static inline struct rte_mbuf *
+ipv6_frag_reassemble_key(struct rte_ip_frag_tbl *tbl,
 	struct rte_ip_frag_death_row *dr, struct rte_mbuf *mb, uint64_t tms,
-	struct rte_ipv6_hdr *ip_hdr, struct rte_ipv6_fragment_ext *frag_hdr)
+	const struct rte_ipv6_hdr *ip_hdr,
+	const struct rte_ipv6_fragment_ext *frag_hdr,
+	const struct ip_frag_key *key, const uint32_t *sig)
 {
 	struct ip_frag_pkt *fp;
-	struct ip_frag_key key;
 	uint16_t ip_ofs;
+	uint32_t hsig[2];
 	int32_t ip_len;
 	int32_t trim;
 
-	rte_memcpy(&key.src_dst[0], &ip_hdr->src_addr, 16);
-	rte_memcpy(&key.src_dst[2], &ip_hdr->dst_addr, 16);
-
-	key.id = frag_hdr->id;
-	key.key_len = IPV6_KEYLEN;
-
 	ip_ofs = FRAG_OFFSET(frag_hdr->frag_data) * 8;
 
 	/*
@@ -167,7 +162,7 @@ rte_ipv6_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 		"tbl: %p, max_cycles: %" PRIu64 ", entry_mask: %#x, "
 		"max_entries: %u, use_entries: %u\n\n",
 		__func__, __LINE__,
-		mb, tms, IPv6_KEY_BYTES(key.src_dst), key.id, ip_ofs, ip_len,
+		mb, tms, IPv6_KEY_BYTES(key->src_dst), key->id, ip_ofs, ip_len,
 		trim, RTE_IPV6_GET_MF(frag_hdr->frag_data),
 		tbl, tbl->max_cycles, tbl->entry_mask, tbl->max_entries,
 		tbl->use_entries);
@@ -181,9 +176,18 @@ rte_ipv6_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 	if (unlikely(trim > 0))
 		rte_pktmbuf_trim(mb, trim);
 
+	/* shared tables need the hash values to lock the key lines. */
+	if (sig == NULL && ip_frag_tbl_is_shared(tbl)) {
+		ip_frag_key_hash(key, hsig);
+		sig = hsig;
+	}
+
+	ip_frag_tbl_lock(tbl, sig);
+
 	/* try to find/add entry into the fragment's table. */
-	fp = ip_frag_find(tbl, dr, &key, tms);
+	fp = ip_frag_find(tbl, dr, key, sig, tms);
 	if (fp == NULL) {
+		ip_frag_tbl_unlock(tbl, sig);
 		IP_FRAG_MBUF2DR(dr, mb);
 		return NULL;
 	}
@@ -199,7 +203,7 @@ rte_ipv6_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 
 
 	/* process the fragmented packet. */
-	mb = ip_frag_process(fp, dr, mb, ip_ofs, ip_len,
+	mb = ip_frag_process(tbl, fp, dr, mb, ip_ofs, ip_len,
 			MORE_FRAGS(frag_hdr->frag_data));
 	ip_frag_inuse(tbl, fp);
 
@@ -213,5 +217,86 @@ rte_ipv6_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 		fp, IPv6_KEY_BYTES(fp->key.src_dst), fp->key.id, fp->start,
 		fp->total_size, fp->frag_size, fp->last_idx);
 
+	ip_frag_tbl_unlock(tbl, sig);
+
 	return mb;
 }
+
+/*
+ * Process new mbuf with fragment of IPV6 datagram.
+ * Incoming mbuf should have its l2_len/l3_len fields setup correctly.
+ * @param tbl
+ *   Table where to lookup/add the fragmented packet.
+ * @param mb
+ *   Incoming mbuf with IPV6 fragment.
+ * @param tms
+ *   Fragment arrival timestamp.
+ * @param ip_hdr
+ *   Pointer to the IPV6 header.
+ * @param frag_hdr
+ *   Pointer to the IPV6 fragment extension header.
+ * @return
+ *   Pointer to mbuf for reassembled packet, or NULL if:
+ *   - an error occurred.
+ *   - not all fragments of the packet are collected yet.
+ */
+struct rte_mbuf *
+rte_ipv6_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
+	struct rte_ip_frag_death_row *dr, struct rte_mbuf *mb, uint64_t tms,
+	struct rte_ipv6_hdr *ip_hdr, struct rte_ipv6_fragment_ext *frag_hdr)
+{
+	struct ip_frag_key key;
+
+	ipv6_frag_key(ip_hdr, frag_hdr, &key);
+	return ipv6_frag_reassemble_key(tbl, dr, mb, tms, ip_hdr, frag_hdr,
+		&key, NULL);
+}
+
+/*
+ * Process a burst of IPV6 packets.
+ * The keys of a group of fragments are hashed and their table lines
+ * prefetched, before the fragments are processed one by one.
+ */
+uint16_t
+rte_ipv6_frag_reassemble_burst(struct rte_ip_frag_tbl *tbl,
+	struct rte_ip_frag_death_row *dr, struct rte_mbuf **mbs,
+	uint16_t nb_pkts, uint64_t tms)
+{
+	struct ip_frag_key key[IP_FRAG_BURST];
+	uint32_t sig[IP_FRAG_BURST][2];
+	struct rte_ipv6_fragment_ext *frag_hdr[IP_FRAG_BURST];
+	struct rte_ipv6_hdr *ip_hdr;
+	struct rte_mbuf *mb;
+	uint32_t i, j, k, n;
+
+	k = 0;
+	for (i = 0; i != nb_pkts; i += n) {
+		n = RTE_MIN(nb_pkts - i, (uint32_t)IP_FRAG_BURST);
+
+		for (j = 0; j != n; j++) {
+			mb = mbs[i + j];
+			ip_hdr = rte_pktmbuf_mtod_offset(mb,
+				struct rte_ipv6_hdr *, mb->l2_len);
+			frag_hdr[j] = rte_ipv6_frag_get_ipv6_fragment_header(ip_hdr);
+			if (frag_hdr[j] != NULL) {
+				ipv6_frag_key(ip_hdr, frag_hdr[j], &key[j]);
+				ip_frag_key_hash(&key[j], sig[j]);
+				ip_frag_tbl_prefetch(tbl, sig[j]);
+			}
+		}
+
+		for (j = 0; j != n; j++) {
+			mb = mbs[i + j];
+			if (frag_hdr[j] != NULL) {
+				ip_hdr = rte_pktmbuf_mtod_offset(mb,
+					struct rte_ipv6_hdr *, mb->l2_len);
+				mb = ipv6_frag_reassemble_key(tbl, dr, mb, tms,
+					ip_hdr, frag_hdr[j], &key[j], sig[j]);
+			}
+			if (mb != NULL)
+				mbs[k++] = mb;
+		}
+	}
+
+	return k;
+}
@@ -26,7 +26,7 @@
 #define SAD_FORMAT		SAD_PREFIX "%s"
 
 #define DEFAULT_HASH_FUNC	rte_hash_crc
-#define MIN_HASH_ENTRIES	8U /* From rte_cuckoo_hash.h */
+#define MIN_HASH_ENTRIES	((uint32_t)RTE_HASH_ENTRIES_MIN)
 
 struct hash_cnt {
 	uint32_t cnt_dip;
@@ -2,8 +2,11 @@
  * Copyright(c) 2018 Intel Corporation
  */
 
+#include <ctype.h>
 #include <math.h>
+#include <stdlib.h>
 
+#include <rte_bitops.h>
 #include <rte_string_fns.h>
 #include <rte_mbuf_dyn.h>
 #include <rte_log.h>
@@ -12,6 +15,7 @@
 #include <rte_metrics.h>
 #include <rte_memzone.h>
 #include <rte_lcore.h>
+#include <rte_telemetry.h>
 
 #include "rte_latencystats.h"
 
@@ -46,12 +50,41 @@ static uint64_t samp_intvl;
 static uint64_t timer_tsc;
 static uint64_t prev_tsc;
 
+/*
+ * Latency samples are accumulated in log-linear (HDR style) histograms:
+ * latencies below LAT_HIST_SUB_BUCKETS cycles are counted exactly, larger
+ * ones fall into LAT_HIST_SUB_BUCKETS linear sub-buckets per power of two.
+ * This bounds the relative error of a reported percentile to
+ * 1/LAT_HIST_SUB_BUCKETS while keeping the histogram a few KB in size.
+ */
+#define LAT_HIST_SUB_BITS	4
+#define LAT_HIST_SUB_BUCKETS	(1u << LAT_HIST_SUB_BITS)
+#define LAT_HIST_MAX_BITS	40
+#define LAT_HIST_BUCKETS \
+	((LAT_HIST_MAX_BITS - LAT_HIST_SUB_BITS + 1) * LAT_HIST_SUB_BUCKETS)
+
+/*
+ * Latency statistics of one Tx queue, in TSC cycles.
+ *
+ * A Tx queue is never used by more than one thread at a time, so the Tx
+ * callback is the only writer and no lock or atomic is needed. Readers
+ * merge the per-queue values lazily and tolerate slightly stale data.
+ */
+struct __rte_cache_aligned latency_queue_stats {
+	uint64_t samples; /**< Number of sampled packets */
+	uint64_t min_latency; /**< Minimum latency */
+	uint64_t max_latency; /**< Maximum latency */
+	float avg_latency; /**< Average latency (EWMA) */
+	float jitter; /**< Latency variation */
+	float prev_latency; /**< Latency of the previous sample */
+	uint64_t hist[LAT_HIST_BUCKETS]; /**< Latency histogram */
+};
+
 struct rte_latency_stats {
-	float min_latency; /**< Minimum latency in nano seconds */
-	float avg_latency; /**< Average latency in nano seconds */
-	float max_latency; /**< Maximum latency in nano seconds */
-	float jitter; /** Latency variation */
-	rte_spinlock_t lock; /** Latency calculation lock */
+	uint16_t nb_queues; /**< Number of Tx queue stats slots */
+	/** Stats slot index + 1 of each Tx queue, 0 if not registered */
+	uint16_t queue_slot[RTE_MAX_ETHPORTS][RTE_MAX_QUEUES_PER_PORT];
+	struct latency_queue_stats queues[];
 };
 
 static struct rte_latency_stats *glob_stats;
@@ -69,54 +102,159 @@ struct latency_stats_nameoff {
 };
 
 static const struct latency_stats_nameoff lat_stats_strings[] = {
-	{"min_latency_ns", offsetof(struct rte_latency_stats, min_latency)},
-	{"avg_latency_ns", offsetof(struct rte_latency_stats, avg_latency)},
-	{"max_latency_ns", offsetof(struct rte_latency_stats, max_latency)},
-	{"jitter_ns", offsetof(struct rte_latency_stats, jitter)},
+	{"min_latency_ns", offsetof(struct rte_latencystats_queue, min_ns)},
+	{"avg_latency_ns", offsetof(struct rte_latencystats_queue, avg_ns)},
+	{"max_latency_ns", offsetof(struct rte_latencystats_queue, max_ns)},
+	{"jitter_ns", offsetof(struct rte_latencystats_queue, jitter_ns)},
+	{"p50_latency_ns", offsetof(struct rte_latencystats_queue, p50_ns)},
+	{"p99_latency_ns", offsetof(struct rte_latencystats_queue, p99_ns)},
+	{"p999_latency_ns", offsetof(struct rte_latencystats_queue, p999_ns)},
 };
 
 #define NUM_LATENCY_STATS (sizeof(lat_stats_strings) / \
 				sizeof(lat_stats_strings[0]))
 
-int32_t
-rte_latencystats_update(void)
+/* Histogram bucket of a latency given in cycles. */
+static inline unsigned int
+lat_hist_index(uint64_t cycles)
 {
-	unsigned int i;
-	float *stats_ptr = NULL;
-	uint64_t values[NUM_LATENCY_STATS] = {0};
-	int ret;
+	unsigned int shift;
 
-	for (i = 0; i < NUM_LATENCY_STATS; i++) {
-		stats_ptr = RTE_PTR_ADD(glob_stats,
-				lat_stats_strings[i].offset);
-		values[i] = (uint64_t)floor((*stats_ptr)/
-				latencystat_cycles_per_ns());
+	if (cycles < LAT_HIST_SUB_BUCKETS)
+		return cycles;
+	if (cycles >= RTE_BIT64(LAT_HIST_MAX_BITS))
+		return LAT_HIST_BUCKETS - 1;
+
+	shift = rte_fls_u64(cycles) - 1 - LAT_HIST_SUB_BITS;
+	return (shift + 1) * LAT_HIST_SUB_BUCKETS +
+		(cycles >> shift) - LAT_HIST_SUB_BUCKETS;
+}
+
+/* Latency in cycles represented by a histogram bucket (its midpoint). */
+static uint64_t
+lat_hist_value(unsigned int idx)
+{
+	unsigned int group = idx / LAT_HIST_SUB_BUCKETS;
+	unsigned int sub = idx % LAT_HIST_SUB_BUCKETS;
+
+	if (group == 0)
+		return sub;
+
+	return ((uint64_t)(LAT_HIST_SUB_BUCKETS + sub) << (group - 1)) +
+		(RTE_BIT64(group - 1) >> 1);
+}
+
+static uint64_t
+latencystat_cycles_to_ns(double cycles)
+{
+	return (uint64_t)floor(cycles * NS_PER_SEC / rte_get_timer_hz());
+}
+
+/*
+ * Merge the stats of nb_queues Tx queue slots starting at first,
+ * converting the result to nano seconds.
+ */
+static void
+latency_stats_merge(unsigned int first, unsigned int nb_queues,
+		struct rte_latencystats_queue *out)
+{
+	static const struct {
+		uint64_t num;
+		uint64_t den;
+		unsigned int offset;
+	} pct[] = {
+		{ 1, 2, offsetof(struct rte_latencystats_queue, p50_ns) },
+		{ 99, 100, offsetof(struct rte_latencystats_queue, p99_ns) },
+		{ 999, 1000, offsetof(struct rte_latencystats_queue, p999_ns) },
+	};
+	uint64_t hist[LAT_HIST_BUCKETS] = {0};
+	uint64_t min = UINT64_MAX, max = 0;
+	uint64_t samples = 0, rank, seen;
+	double avg = 0, jitter = 0;
+	unsigned int i, j;
+
+	memset(out, 0, sizeof(*out));
+
+	for (i = first; i < first + nb_queues; i++) {
+		const struct latency_queue_stats *q = &glob_stats->queues[i];
+		uint64_t n = q->samples;
+
+		if (n == 0)
+			continue;
+
+		samples += n;
+		min = RTE_MIN(min, q->min_latency);
+		max = RTE_MAX(max, q->max_latency);
+		/* weight the per queue moving averages by their sample count */
+		avg += (double)q->avg_latency * n;
+		jitter += (double)q->jitter * n;
+		for (j = 0; j < LAT_HIST_BUCKETS; j++)
+			hist[j] += q->hist[j];
 	}
 
-	ret = rte_metrics_update_values(RTE_METRICS_GLOBAL,
-					latency_stats_index,
-					values, NUM_LATENCY_STATS);
-	if (ret < 0)
-		LATENCY_STATS_LOG(INFO, "Failed to push the stats");
+	if (samples == 0)
+		return;
 
-	return ret;
+	out->samples = samples;
+	out->min_ns = latencystat_cycles_to_ns(min);
+	out->max_ns = latencystat_cycles_to_ns(max);
+	out->avg_ns = latencystat_cycles_to_ns(avg / samples);
+	out->jitter_ns = latencystat_cycles_to_ns(jitter / samples);
+
+	/*
+	 * The histogram may be updated concurrently, so its total can differ
+	 * a little from the sample count: use the histogram's own total.
+	 */
+	for (j = 0, samples = 0; j < LAT_HIST_BUCKETS; j++)
+		samples += hist[j];
+
+	for (i = 0, j = 0, seen = 0; i < RTE_DIM(pct); i++) {
+		uint64_t *p = RTE_PTR_ADD(out, pct[i].offset);
+
+		rank = (samples * pct[i].num + pct[i].den - 1) / pct[i].den;
+		while (j < LAT_HIST_BUCKETS - 1 && seen + hist[j] < rank)
+			seen += hist[j++];
+		*p = latencystat_cycles_to_ns(RTE_MAX(min,
+					RTE_MIN(max, lat_hist_value(j))));
+	}
 }
 
 static void
 rte_latencystats_fill_values(struct rte_metric_value *values)
 {
+	struct rte_latencystats_queue stats;
 	unsigned int i;
-	float *stats_ptr = NULL;
+
+	latency_stats_merge(0, glob_stats->nb_queues, &stats);
 
 	for (i = 0; i < NUM_LATENCY_STATS; i++) {
-		stats_ptr = RTE_PTR_ADD(glob_stats,
-				lat_stats_strings[i].offset);
 		values[i].key = i;
-		values[i].value = (uint64_t)floor((*stats_ptr)/
-						latencystat_cycles_per_ns());
+		values[i].value = *(uint64_t *)RTE_PTR_ADD(&stats,
+				lat_stats_strings[i].offset);
 	}
 }
 
+int32_t
+rte_latencystats_update(void)
+{
+	unsigned int i;
+	struct rte_metric_value metrics[NUM_LATENCY_STATS];
+	uint64_t values[NUM_LATENCY_STATS] = {0};
+	int ret;
+
+	rte_latencystats_fill_values(metrics);
+	for (i = 0; i < NUM_LATENCY_STATS; i++)
+		values[i] = metrics[i].value;
+
+	ret = rte_metrics_update_values(RTE_METRICS_GLOBAL,
+					latency_stats_index,
+					values, NUM_LATENCY_STATS);
+	if (ret < 0)
+		LATENCY_STATS_LOG(INFO, "Failed to push the stats");
+
+	return ret;
+}
+
 static uint16_t
 add_time_stamps(uint16_t pid __rte_unused,
 		uint16_t qid __rte_unused,
@@ -155,12 +293,12 @@ calc_latency(uint16_t pid __rte_unused,
 		uint16_t qid __rte_unused,
 		struct rte_mbuf **pkts,
 		uint16_t nb_pkts,
-		void *_ __rte_unused)
+		void *arg)
 {
+	struct latency_queue_stats *stats = arg;
 	unsigned int i;
-	uint64_t now;
+	uint64_t now, cycles;
 	float latency;
-	static float prev_latency;
 	/*
 	 * Alpha represents degree of weighting decrease in EWMA,
 	 * a constant smoothing factor between 0 and 1. The value
@@ -170,12 +308,12 @@ calc_latency(uint16_t pid __rte_unused,
 
 	now = rte_rdtsc();
 
-	rte_spinlock_lock(&glob_stats->lock);
 	for (i = 0; i < nb_pkts; i++) {
 		if (!(pkts[i]->ol_flags & timestamp_dynflag))
 			continue;
 
-		latency = now - *timestamp_dynfield(pkts[i]);
+		cycles = now - *timestamp_dynfield(pkts[i]);
+		latency = cycles;
 
 		/*
 		 * The jitter is calculated as statistical mean of interpacket
@@ -188,24 +326,23 @@ calc_latency(uint16_t pid __rte_unused,
 		 * Reference: Calculated as per RFC 5481, sec 4.1,
 		 * RFC 3393 sec 4.5, RFC 1889 sec.
 		 */
-		glob_stats->jitter +=  (fabsf(prev_latency - latency)
-					- glob_stats->jitter)/16;
-		if (glob_stats->min_latency == 0)
-			glob_stats->min_latency = latency;
-		else if (latency < glob_stats->min_latency)
-			glob_stats->min_latency = latency;
-		else if (latency > glob_stats->max_latency)
-			glob_stats->max_latency = latency;
+		stats->jitter +=  (fabsf(stats->prev_latency - latency)
+					- stats->jitter)/16;
+		if (stats->samples == 0 || cycles < stats->min_latency)
+			stats->min_latency = cycles;
+		if (cycles > stats->max_latency)
+			stats->max_latency = cycles;
 		/*
 		 * The average latency is measured using exponential moving
 		 * average, i.e. using EWMA
 		 * https://en.wikipedia.org/wiki/Moving_average
 		 */
-		glob_stats->avg_latency +=
-			alpha * (latency - glob_stats->avg_latency);
-		prev_latency = latency;
+		stats->avg_latency +=
+			alpha * (latency - stats->avg_latency);
+		stats->hist[lat_hist_index(cycles)]++;
+		stats->samples++;
+		stats->prev_latency = latency;
 	}
-	rte_spinlock_unlock(&glob_stats->lock);
 
 	return nb_pkts;
 }
@@ -221,14 +358,28 @@ rte_latencystats_init(uint64_t app_samp_intvl,
 	const char *ptr_strings[NUM_LATENCY_STATS] = {0};
 	const struct rte_memzone *mz = NULL;
 	const unsigned int flags = 0;
+	unsigned int nb_queues = 0;
 	int ret;
 
 	if (rte_memzone_lookup(MZ_RTE_LATENCY_STATS))
 		return -EEXIST;
 
+	/** Reserve one stats slot per Tx queue */
+	RTE_ETH_FOREACH_DEV(pid) {
+		struct rte_eth_dev_info dev_info;
+
+		if (rte_eth_dev_info_get(pid, &dev_info) == 0)
+			nb_queues += dev_info.nb_tx_queues;
+	}
+	if (nb_queues > UINT16_MAX) {
+		LATENCY_STATS_LOG(ERR, "Too many Tx queues: %u", nb_queues);
+		return -EINVAL;
+	}
+
 	/** Allocate stats in shared memory fo multi process support */
-	mz = rte_memzone_reserve(MZ_RTE_LATENCY_STATS, sizeof(*glob_stats),
-					rte_socket_id(), flags);
+	mz = rte_memzone_reserve(MZ_RTE_LATENCY_STATS, sizeof(*glob_stats) +
+			nb_queues * sizeof(glob_stats->queues[0]),
+			rte_socket_id(), flags);
 	if (mz == NULL) {
 		LATENCY_STATS_LOG(ERR, "Cannot reserve memory: %s:%d",
 			__func__, __LINE__);
@@ -236,7 +387,7 @@ rte_latencystats_init(uint64_t app_samp_intvl,
 	}
 
 	glob_stats = mz->addr;
-	rte_spinlock_init(&glob_stats->lock);
+	memset(glob_stats, 0, mz->len);
 	samp_intvl = app_samp_intvl * latencystat_cycles_per_ns();
 
 	/** Register latency stats with stats library */
@@ -283,9 +434,12 @@ rte_latencystats_init(uint64_t app_samp_intvl,
 					"qid=%d", pid, qid);
 		}
 		for (qid = 0; qid < dev_info.nb_tx_queues; qid++) {
+			if (glob_stats->nb_queues == nb_queues)
+				break;
 			cbs = &tx_cbs[pid][qid];
-			cbs->cb =  rte_eth_add_tx_callback(pid, qid,
-					calc_latency, user_cb);
+			cbs->cb =  rte_eth_add_tx_callback(pid, qid, calc_latency,
+					&glob_stats->queues[glob_stats->nb_queues]);
+			glob_stats->queue_slot[pid][qid] = ++glob_stats->nb_queues;
 			if (!cbs->cb)
 				LATENCY_STATS_LOG(INFO, "Failed to "
 					"register Tx callback for pid=%d, "
@@ -338,6 +492,7 @@ rte_latencystats_uninit(void)
 	/* free up the memzone */
 	mz = rte_memzone_lookup(MZ_RTE_LATENCY_STATS);
 	rte_memzone_free(mz);
+	glob_stats = NULL;
 
 	return 0;
 }
@@ -357,12 +512,9 @@ rte_latencystats_get_names(struct rte_metric_name *names, uint16_t size)
 	return NUM_LATENCY_STATS;
 }
 
-int
-rte_latencystats_get(struct rte_metric_value *values, uint16_t size)
+static int
+latency_stats_lookup(void)
 {
-	if (size < NUM_LATENCY_STATS || values == NULL)
-		return NUM_LATENCY_STATS;
-
 	if (rte_eal_process_type() == RTE_PROC_SECONDARY) {
 		const struct rte_memzone *mz;
 		mz = rte_memzone_lookup(MZ_RTE_LATENCY_STATS);
@@ -374,8 +526,119 @@ rte_latencystats_get(struct rte_metric_value *values, uint16_t size)
 		glob_stats =  mz->addr;
 	}
 
+	if (glob_stats == NULL)
+		return -ENOMEM;
+
+	return 0;
+}
+
+int
+rte_latencystats_get(struct rte_metric_value *values, uint16_t size)
+{
+	int ret;
+
+	if (size < NUM_LATENCY_STATS || values == NULL)
+		return NUM_LATENCY_STATS;
+
+	ret = latency_stats_lookup();
+	if (ret < 0)
+		return ret;
+
 	/* Retrieve latency stats */
 	rte_latencystats_fill_values(values);
 
 	return NUM_LATENCY_STATS;
 }
+
+int
+rte_latencystats_queue_get(uint16_t port_id, uint16_t queue_id,
+		struct rte_latencystats_queue *stats)
+{
+	uint16_t slot;
+	int ret;
+
+	if (stats == NULL || port_id >= RTE_MAX_ETHPORTS ||
+			queue_id >= RTE_MAX_QUEUES_PER_PORT)
+		return -EINVAL;
+
+	ret = latency_stats_lookup();
+	if (ret < 0)
+		return ret;
+
+	slot = glob_stats->queue_slot[port_id][queue_id];
+	if (slot == 0)
+		return -ENOENT;
+
+	latency_stats_merge(slot - 1, 1, stats);
+
+	return 0;
+}
+
+static void
+latency_stats_tel_add(struct rte_tel_data *d,
+		const struct rte_latencystats_queue *stats)
+{
+	unsigned int i;
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_uint(d, "samples", stats->samples);
+	for (i = 0; i < NUM_LATENCY_STATS; i++)
+		rte_tel_data_add_dict_uint(d, lat_stats_strings[i].name,
+			*(const uint64_t *)RTE_PTR_ADD(stats,
+				lat_stats_strings[i].offset));
+}
+
+static int
+latency_stats_handle_stats(const char *cmd __rte_unused,
+		const char *params __rte_unused,
+		struct rte_tel_data *d)
+{
+	struct rte_latencystats_queue stats;
+
+	if (latency_stats_lookup() < 0)
+		return -EINVAL;
+
+	latency_stats_merge(0, glob_stats->nb_queues, &stats);
+	latency_stats_tel_add(d, &stats);
+
+	return 0;
+}
+
+static int
+latency_stats_handle_queue(const char *cmd __rte_unused,
+		const char *params,
+		struct rte_tel_data *d)
+{
+	struct rte_latencystats_queue stats;
+	unsigned long port_id, queue_id;
+	char *end_param;
+
+	if (params == NULL || !isdigit(*params))
+		return -EINVAL;
+
+	port_id = strtoul(params, &end_param, 0);
+	if (*end_param != ',' || !isdigit(*(end_param + 1)))
+		return -EINVAL;
+
+	queue_id = strtoul(end_param + 1, &end_param, 0);
+	if (*end_param != '\0' || port_id >= UINT16_MAX ||
+			queue_id >= UINT16_MAX)
+		return -EINVAL;
+
+	if (rte_latencystats_queue_get(port_id, queue_id, &stats) < 0)
+		return -EINVAL;
+
+	latency_stats_tel_add(d, &stats);
+
+	return 0;
+}
+
+RTE_INIT(latencystats_init_telemetry)
+{
+	rte_telemetry_register_cmd("/latencystats/stats",
+			latency_stats_handle_stats,
+			"Returns latency stats merged over all Tx queues. No parameters.");
+	rte_telemetry_register_cmd("/latencystats/queue",
+			latency_stats_handle_queue,
+			"Returns latency stats of a Tx queue. Parameters: int port_id,int queue_id");
+}
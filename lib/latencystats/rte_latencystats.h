@@ -13,6 +13,7 @@
  */
 
 #include <stdint.h>
+#include <rte_compat.h>
 #include <rte_metrics.h>
 #include <rte_mbuf.h>
 
@@ -40,6 +41,23 @@ extern "C" {
 typedef uint16_t (*rte_latency_stats_flow_type_fn)(struct rte_mbuf *pkt,
 							void *user_param);
 
+/**
+ * Latency statistics, in nano seconds.
+ *
+ * Percentiles are computed from a log-linear histogram
+ * and have a relative error of at most 1/16.
+ */
+struct rte_latencystats_queue {
+	uint64_t samples; /**< Number of sampled packets */
+	uint64_t min_ns; /**< Minimum latency */
+	uint64_t avg_ns; /**< Average latency (exponential moving average) */
+	uint64_t max_ns; /**< Maximum latency */
+	uint64_t jitter_ns; /**< Latency variation */
+	uint64_t p50_ns; /**< Median latency */
+	uint64_t p99_ns; /**< 99th percentile latency */
+	uint64_t p999_ns; /**< 99.9th percentile latency */
+};
+
 /**
  *  Registers Rx/Tx callbacks for each active port, queue.
  *
@@ -121,6 +139,31 @@ int rte_latencystats_get_names(struct rte_metric_name *names,
 int rte_latencystats_get(struct rte_metric_value *values,
 			uint16_t size);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Retrieve latency statistics of a single Tx queue.
+ *
+ * Each Tx queue accumulates its statistics without locking,
+ * they are only merged when read.
+ *
+ * @param port_id
+ *   The port identifier of the Ethernet device.
+ * @param queue_id
+ *   The index of the Tx queue.
+ * @param stats
+ *   A pointer to a structure to be filled with the queue statistics.
+ * @return
+ *   - 0: On success.
+ *   - -EINVAL: Invalid parameters.
+ *   - -ENOENT: No latency stats registered for this queue.
+ *   - -ENOMEM: Latency stats not initialized.
+ */
+__rte_experimental
+int rte_latencystats_queue_get(uint16_t port_id, uint16_t queue_id,
+			struct rte_latencystats_queue *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,30 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 The DPDK contributors
+ */
+
+#ifndef _LPM6_H_
+#define _LPM6_H_
+
+#include <stdint.h>
+
+#include <rte_ip6.h>
+
+#define RTE_LPM6_TBL8_GROUP_NUM_ENTRIES         256
+
+#define RTE_LPM6_VALID_EXT_ENTRY_BITMASK 0xA0000000
+#define RTE_LPM6_LOOKUP_SUCCESS          0x20000000
+#define RTE_LPM6_TBL8_BITMASK            0x001FFFFF
+
+/* Number of lookups advanced together by the bulk lookup. */
+#define LPM6_LOOKUP_BATCH	16
+
+/*
+ * Look up n addresses with AVX512 gathers, n being a multiple
+ * of LPM6_LOOKUP_BATCH. tbl24 and tbl8 are the tables of the LPM,
+ * as arrays of raw entries.
+ */
+void
+lpm6_vec_lookup_bulk(const uint32_t *tbl24, const uint32_t *tbl8,
+	const struct rte_ipv6_addr *ips, int32_t *next_hops, unsigned int n);
+
+#endif /* _LPM6_H_ */
@@ -0,0 +1,70 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 The DPDK contributors
+ */
+
+#include <rte_vect.h>
+
+#include "lpm6.h"
+
+/* The tbl24 index is made of the first 3 bytes, each tbl8 uses one more. */
+#define LPM6_TBL8_FIRST_BYTE	3
+
+static __rte_always_inline void
+lpm6_vec_lookup_x16(const uint32_t *tbl24, const uint32_t *tbl8,
+	const struct rte_ipv6_addr *ips, int32_t *next_hops)
+{
+	const __m512i lane_offs = _mm512_set_epi32(
+		15 * 16, 14 * 16, 13 * 16, 12 * 16,
+		11 * 16, 10 * 16, 9 * 16, 8 * 16,
+		7 * 16, 6 * 16, 5 * 16, 4 * 16,
+		3 * 16, 2 * 16, 1 * 16, 0);
+	const __m512i ext_msk = _mm512_set1_epi32(RTE_LPM6_VALID_EXT_ENTRY_BITMASK);
+	const __m512i nh_msk = _mm512_set1_epi32(RTE_LPM6_TBL8_BITMASK);
+	const __m512i byte_msk = _mm512_set1_epi32(UINT8_MAX);
+	const __m512i lookup_miss = _mm512_set1_epi32(-1);
+	const uint8_t *base = (const uint8_t *)ips;
+	__m512i addr, idx, ent, res;
+	__mmask16 ext, hit;
+	unsigned int byte;
+
+	/* first 4 bytes of every IP, in network order in memory */
+	addr = _mm512_i32gather_epi32(lane_offs, base, 1);
+	idx = _mm512_or_epi32(
+		_mm512_slli_epi32(_mm512_and_epi32(addr, byte_msk), 16),
+		_mm512_and_epi32(addr, _mm512_set1_epi32(0xff00)));
+	idx = _mm512_or_epi32(idx,
+		_mm512_and_epi32(_mm512_srli_epi32(addr, 16), byte_msk));
+
+	ent = _mm512_i32gather_epi32(idx, tbl24, 4);
+	ext = _mm512_cmpeq_epi32_mask(_mm512_and_epi32(ent, ext_msk), ext_msk);
+
+	for (byte = LPM6_TBL8_FIRST_BYTE;
+			ext != 0 && byte < RTE_IPV6_ADDR_SIZE; byte++) {
+		/*
+		 * Read the byte as the top one of a dword ending with it,
+		 * to never read past the last IP.
+		 */
+		addr = _mm512_mask_i32gather_epi32(ent, ext, lane_offs,
+			base + byte - 3, 1);
+		idx = _mm512_add_epi32(_mm512_srli_epi32(addr, 24),
+			_mm512_slli_epi32(_mm512_and_epi32(ent, nh_msk), 8));
+		ent = _mm512_mask_i32gather_epi32(ent, ext, idx, tbl8, 4);
+		ext = _mm512_mask_cmpeq_epi32_mask(ext,
+			_mm512_and_epi32(ent, ext_msk), ext_msk);
+	}
+
+	hit = _mm512_test_epi32_mask(ent,
+		_mm512_set1_epi32(RTE_LPM6_LOOKUP_SUCCESS));
+	res = _mm512_mask_and_epi32(lookup_miss, hit, ent, nh_msk);
+	_mm512_storeu_si512(next_hops, res);
+}
+
+void
+lpm6_vec_lookup_bulk(const uint32_t *tbl24, const uint32_t *tbl8,
+	const struct rte_ipv6_addr *ips, int32_t *next_hops, unsigned int n)
+{
+	unsigned int i;
+
+	for (i = 0; i + LPM6_LOOKUP_BATCH <= n; i += LPM6_LOOKUP_BATCH)
+		lpm6_vec_lookup_x16(tbl24, tbl8, &ips[i], &next_hops[i]);
+}
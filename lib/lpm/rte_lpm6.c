@@ -3,6 +3,7 @@
  */
 #include <string.h>
 #include <stdalign.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <errno.h>
 #include <stdio.h>
@@ -18,19 +19,20 @@
 #include <rte_hash.h>
 #include <assert.h>
 #include <rte_jhash.h>
+#include <rte_prefetch.h>
 #include <rte_tailq.h>
+#ifdef CC_LPM6_AVX512_SUPPORT
+#include <rte_cpuflags.h>
+#include <rte_vect.h>
+#endif
 
 #include "rte_lpm6.h"
+#include "lpm6.h"
 #include "lpm_log.h"
 
 #define RTE_LPM6_TBL24_NUM_ENTRIES        (1 << 24)
-#define RTE_LPM6_TBL8_GROUP_NUM_ENTRIES         256
 #define RTE_LPM6_TBL8_MAX_NUM_GROUPS      (1 << 21)
 
-#define RTE_LPM6_VALID_EXT_ENTRY_BITMASK 0xA0000000
-#define RTE_LPM6_LOOKUP_SUCCESS          0x20000000
-#define RTE_LPM6_TBL8_BITMASK            0x001FFFFF
-
 #define ADD_FIRST_BYTE                            3
 #define LOOKUP_FIRST_BYTE                         4
 #define BYTE_SIZE                                 8
@@ -905,6 +907,60 @@ lookup_step(const struct rte_lpm6 *lpm, const struct rte_lpm6_tbl_entry *tbl,
 	}
 }
 
+/*
+ * Looks up a batch of up to LPM6_LOOKUP_BATCH IPs, advancing all of them
+ * one level at a time so that the memory accesses of a level overlap.
+ */
+static inline void
+lookup_batch(const struct rte_lpm6 *lpm, const struct rte_ipv6_addr *ips,
+		int32_t *next_hops, unsigned int n)
+{
+	const uint32_t *tbl[LPM6_LOOKUP_BATCH];
+	uint8_t active[LPM6_LOOKUP_BATCH];
+	uint32_t tbl24_index, tbl8_index, tbl_entry;
+	unsigned int i, j, k, nb_active;
+	uint8_t byte;
+
+	for (i = 0; i < n; i++) {
+		tbl24_index = (ips[i].a[0] << BYTES2_SIZE) |
+				(ips[i].a[1] << BYTE_SIZE) | ips[i].a[2];
+		tbl[i] = (const uint32_t *)&lpm->tbl24[tbl24_index];
+		rte_prefetch0(tbl[i]);
+		active[i] = i;
+	}
+
+	/* every level consumes one byte of all the IPs still looked up */
+	nb_active = n;
+	for (byte = LOOKUP_FIRST_BYTE - 1; nb_active != 0; byte++) {
+		for (i = 0, j = 0; i < nb_active; i++) {
+			k = active[i];
+			tbl_entry = *tbl[k];
+			if ((tbl_entry & RTE_LPM6_VALID_EXT_ENTRY_BITMASK) ==
+					RTE_LPM6_VALID_EXT_ENTRY_BITMASK) {
+				tbl8_index = ips[k].a[byte] +
+					((tbl_entry & RTE_LPM6_TBL8_BITMASK) *
+					RTE_LPM6_TBL8_GROUP_NUM_ENTRIES);
+				tbl[k] = (const uint32_t *)&lpm->tbl8[tbl8_index];
+				rte_prefetch0(tbl[k]);
+				active[j++] = k;
+			} else if (tbl_entry & RTE_LPM6_LOOKUP_SUCCESS)
+				next_hops[k] = tbl_entry & RTE_LPM6_TBL8_BITMASK;
+			else
+				next_hops[k] = -1;
+		}
+		nb_active = j;
+	}
+}
+
+#ifdef CC_LPM6_AVX512_SUPPORT
+static inline bool
+lookup_vec_enabled(void)
+{
+	return rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_512 &&
+		rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) > 0;
+}
+#endif
+
 /*
  * Looks up an IP
  */
@@ -946,38 +1002,24 @@ rte_lpm6_lookup_bulk_func(const struct rte_lpm6 *lpm,
 		int32_t *next_hops, unsigned int n)
 {
 	unsigned int i;
-	const struct rte_lpm6_tbl_entry *tbl;
-	const struct rte_lpm6_tbl_entry *tbl_next = NULL;
-	uint32_t tbl24_index, next_hop;
-	uint8_t first_byte;
-	int status;
 
 	/* DEBUG: Check user input arguments. */
 	if ((lpm == NULL) || (ips == NULL) || (next_hops == NULL))
 		return -EINVAL;
 
-	for (i = 0; i < n; i++) {
-		first_byte = LOOKUP_FIRST_BYTE;
-		tbl24_index = (ips[i].a[0] << BYTES2_SIZE) |
-				(ips[i].a[1] << BYTE_SIZE) | ips[i].a[2];
-
-		/* Calculate pointer to the first entry to be inspected */
-		tbl = &lpm->tbl24[tbl24_index];
-
-		do {
-			/* Continue inspecting following levels
-			 * until success or failure
-			 */
-			status = lookup_step(lpm, tbl, &tbl_next, &ips[i],
-					first_byte++, &next_hop);
-			tbl = tbl_next;
-		} while (status == 1);
-
-		if (status < 0)
-			next_hops[i] = -1;
-		else
-			next_hops[i] = (int32_t)next_hop;
+	i = 0;
+#ifdef CC_LPM6_AVX512_SUPPORT
+	if (n >= LPM6_LOOKUP_BATCH && lookup_vec_enabled()) {
+		i = RTE_ALIGN_FLOOR(n, LPM6_LOOKUP_BATCH);
+		lpm6_vec_lookup_bulk((const uint32_t *)lpm->tbl24,
+			(const uint32_t *)lpm->tbl8, ips, next_hops, i);
 	}
+#endif
+
+	for (; i + LPM6_LOOKUP_BATCH <= n; i += LPM6_LOOKUP_BATCH)
+		lookup_batch(lpm, &ips[i], &next_hops[i], LPM6_LOOKUP_BATCH);
+	if (i < n)
+		lookup_batch(lpm, &ips[i], &next_hops[i], n - i);
 
 	return 0;
 }
@@ -177,6 +177,9 @@ rte_lpm6_lookup(const struct rte_lpm6 *lpm, const struct rte_ipv6_addr *ip, uint
 /**
  * Lookup multiple IP addresses in an LPM table.
  *
+ * The addresses are looked up in batches, with the memory accesses
+ * of a batch overlapped. Bursts of at least 16 addresses perform best.
+ *
  * @param lpm
  *   LPM object handle
  * @param ips
@@ -451,16 +451,16 @@ rte_mempool_populate_virt(struct rte_mempool *mp, char *addr,
 	return ret;
 }
 
-/* Get the minimal page size used in a mempool before populating it. */
-int
-rte_mempool_get_page_size(struct rte_mempool *mp, size_t *pg_sz)
+/* Get the minimal page size of the memory of a socket used by a mempool. */
+static int
+mempool_get_page_size(struct rte_mempool *mp, int socket_id, size_t *pg_sz)
 {
 	bool need_iova_contig_obj;
 	bool alloc_in_ext_mem;
 	int ret;
 
 	/* check if we can retrieve a valid socket ID */
-	ret = rte_malloc_heap_socket_is_external(mp->socket_id);
+	ret = rte_malloc_heap_socket_is_external(socket_id);
 	if (ret < 0)
 		return -EINVAL;
 	alloc_in_ext_mem = (ret == 1);
@@ -469,20 +469,33 @@ rte_mempool_get_page_size(struct rte_mempool *mp, size_t *pg_sz)
 	if (!need_iova_contig_obj)
 		*pg_sz = 0;
 	else if (rte_eal_has_hugepages() || alloc_in_ext_mem)
-		*pg_sz = get_min_page_size(mp->socket_id);
+		*pg_sz = get_min_page_size(socket_id);
 	else
 		*pg_sz = rte_mem_page_size();
 
+	return 0;
+}
+
+/* Get the minimal page size used in a mempool before populating it. */
+int
+rte_mempool_get_page_size(struct rte_mempool *mp, size_t *pg_sz)
+{
+	int ret;
+
+	ret = mempool_get_page_size(mp, mp->socket_id, pg_sz);
+	if (ret < 0)
+		return ret;
+
 	rte_mempool_trace_get_page_size(mp, *pg_sz);
 	return 0;
 }
 
-/* Default function to populate the mempool: allocate memory in memzones,
+/* Allocate memory for n objects in memzones on the given socket,
  * and populate them. Return the number of objects added, or a negative
  * value on error.
  */
-int
-rte_mempool_populate_default(struct rte_mempool *mp)
+static int
+mempool_populate_mz(struct rte_mempool *mp, int socket_id, unsigned int n)
 {
 	unsigned int mz_flags = RTE_MEMZONE_1GB|RTE_MEMZONE_SIZE_HINT_ONLY;
 	char mz_name[RTE_MEMZONE_NAMESIZE];
@@ -490,19 +503,11 @@ rte_mempool_populate_default(struct rte_mempool *mp)
 	ssize_t mem_size;
 	size_t align, pg_sz, pg_shift = 0;
 	rte_iova_t iova;
-	unsigned mz_id, n;
-	int ret;
+	unsigned int mz_id;
+	int ret, cnt = 0;
 	bool need_iova_contig_obj;
 	size_t max_alloc_size = SIZE_MAX;
 
-	ret = mempool_ops_alloc_once(mp);
-	if (ret != 0)
-		return ret;
-
-	/* mempool must not be populated */
-	if (mp->nb_mem_chunks != 0)
-		return -EEXIST;
-
 	/*
 	 * the following section calculates page shift and page size values.
 	 *
@@ -542,14 +547,16 @@ rte_mempool_populate_default(struct rte_mempool *mp)
 	 */
 
 	need_iova_contig_obj = !(mp->flags & RTE_MEMPOOL_F_NO_IOVA_CONTIG);
-	ret = rte_mempool_get_page_size(mp, &pg_sz);
+	ret = mempool_get_page_size(mp, socket_id, &pg_sz);
 	if (ret < 0)
 		return ret;
 
 	if (pg_sz != 0)
 		pg_shift = rte_bsf32(pg_sz);
 
-	for (mz_id = 0, n = mp->size; n > 0; mz_id++, n -= ret) {
+	/* memzones of a previous population have lower IDs */
+	for (mz_id = mp->nb_mem_chunks; n > 0;
+			mz_id++, n -= RTE_MIN(n, (unsigned int)ret)) {
 		size_t min_chunk_size;
 
 		mem_size = rte_mempool_ops_calc_mem_size(
@@ -577,7 +584,7 @@ rte_mempool_populate_default(struct rte_mempool *mp)
 		do {
 			mz = rte_memzone_reserve_aligned(mz_name,
 				RTE_MIN((size_t)mem_size, max_alloc_size),
-				mp->socket_id, mz_flags, align);
+				socket_id, mz_flags, align);
 
 			if (mz != NULL || rte_errno != ENOMEM)
 				break;
@@ -612,16 +619,61 @@ rte_mempool_populate_default(struct rte_mempool *mp)
 			rte_memzone_free(mz);
 			goto fail;
 		}
+		cnt += ret;
 	}
 
-	rte_mempool_trace_populate_default(mp);
-	return mp->size;
+	return cnt;
 
  fail:
 	rte_mempool_free_memchunks(mp);
 	return ret;
 }
 
+/* Default function to populate the mempool: allocate memory in memzones,
+ * and populate them. Return the number of objects added, or a negative
+ * value on error.
+ */
+int
+rte_mempool_populate_default(struct rte_mempool *mp)
+{
+	int ret;
+
+	ret = mempool_ops_alloc_once(mp);
+	if (ret != 0)
+		return ret;
+
+	/* mempool must not be populated */
+	if (mp->nb_mem_chunks != 0)
+		return -EEXIST;
+
+	ret = mempool_populate_mz(mp, mp->socket_id, mp->size);
+	if (ret < 0)
+		return ret;
+
+	rte_mempool_trace_populate_default(mp);
+	return mp->size;
+}
+
+/* Populate a part of the mempool with memzones of a given socket. */
+int
+rte_mempool_populate_socket(struct rte_mempool *mp, int socket_id,
+	unsigned int n)
+{
+	int ret;
+
+	if (n == 0)
+		return -EINVAL;
+
+	ret = mempool_ops_alloc_once(mp);
+	if (ret != 0)
+		return ret;
+
+	if (n > mp->size - mp->populated_size)
+		return -ENOSPC;
+
+	return mempool_populate_mz(mp, socket_id, n);
+}
+
 /* return the memory size required for mempool objects in anonymous mem */
 static ssize_t
 get_anon_size(const struct rte_mempool *mp)
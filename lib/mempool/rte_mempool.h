@@ -1229,6 +1229,35 @@ rte_mempool_populate_virt(struct rte_mempool *mp, char *addr,
  */
 int rte_mempool_populate_default(struct rte_mempool *mp);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Add memory of a given socket for a part of the objects in the pool at init
+ *
+ * Unlike rte_mempool_populate_default(), this function can be called
+ * several times, for example once per NUMA socket, until the mempool
+ * is fully populated. It adds memory allocated using rte_memzone_reserve()
+ * on the given socket, sized for n objects.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param socket_id
+ *   The socket identifier where the memory should be allocated.
+ *   The value can be *SOCKET_ID_ANY* if there is no NUMA constraint.
+ * @param n
+ *   The number of objects to add.
+ * @return
+ *   The number of objects added on success.
+ *   On error, a negative errno is returned:
+ *     (-EINVAL): n is 0.
+ *     (-ENOSPC): there is no room for n more objects in the mempool.
+ *     (-ENOMEM): allocation failure, all the memory of the mempool is freed.
+ */
+__rte_experimental
+int rte_mempool_populate_socket(struct rte_mempool *mp, int socket_id,
+	unsigned int n);
+
 /**
  * Add memory from anonymous mapping for objects in the pool at init
  *
@@ -23,9 +23,12 @@
 #include <rte_ethdev.h>
 #include <rte_ether.h>
 #include <rte_mbuf.h>
+#include <rte_memzone.h>
 #include <rte_os_shim.h>
 #include <rte_pcapng.h>
+#include <rte_pause.h>
 #include <rte_reciprocal.h>
+#include <rte_stdatomic.h>
 #include <rte_time.h>
 
 #include "pcapng_proto.h"
@@ -675,6 +678,431 @@ rte_pcapng_write_packets(rte_pcapng_t *self,
 	return total + ret;
 }
 
+/*
+ * Ring of pcapng blocks in shared memory.
+ *
+ * Producers reserve space for a burst of blocks by moving the producer
+ * head, format the blocks in place, then publish them in order by moving
+ * the producer tail, like a multi-producer rte_ring.
+ * Blocks are a multiple of 32 bits, and may wrap around the end of the ring.
+ * Interface index and timestamp are recorded as port id and TSC,
+ * and are converted by the consumer before writing the blocks to the file.
+ */
+struct rte_pcapng_ring {
+	const struct rte_memzone *mz;
+	uint32_t size;		/* size of data in bytes, power of 2 */
+	uint32_t mask;
+
+	alignas(RTE_CACHE_LINE_SIZE) RTE_ATOMIC(uint32_t) prod_head;
+	RTE_ATOMIC(uint32_t) prod_tail;
+
+	alignas(RTE_CACHE_LINE_SIZE) RTE_ATOMIC(uint32_t) cons_tail;
+	uint32_t cons_head;	/* end of the blocks already converted */
+	uint32_t cons_block;	/* first block not completely written */
+	uint64_t dropped;	/* blocks of ports not in the file */
+
+	alignas(RTE_CACHE_LINE_SIZE) uint8_t data[];
+};
+
+/* upper bound of the Enhanced Packet Block options written in the ring */
+#define PCAPNG_RING_OPTLEN	32
+
+/* number of packets for which space is reserved at once */
+#define PCAPNG_RING_BURST	32
+
+/* Layout of a packet block, computed before reserving space in the ring */
+struct pcapng_ring_pkt {
+	uint32_t block_len;
+	uint32_t cap_len;	/* packet data, including inserted tags */
+	uint32_t orig_len;
+	uint32_t nb_tags;
+	uint32_t tags[2];	/* VLAN tags to insert, in network order */
+};
+
+struct rte_pcapng_ring *
+rte_pcapng_ring_create(const char *name, uint32_t size, int socket_id)
+{
+	const struct rte_memzone *mz;
+	struct rte_pcapng_ring *r;
+	char mz_name[RTE_MEMZONE_NAMESIZE];
+
+	if (name == NULL || size == 0 || size > RTE_BIT32(31)) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+	size = rte_align32pow2(size);
+
+	if (snprintf(mz_name, sizeof(mz_name), "PCAPNG_%s", name) >=
+	    (int)sizeof(mz_name)) {
+		rte_errno = ENAMETOOLONG;
+		return NULL;
+	}
+
+	mz = rte_memzone_reserve_aligned(mz_name, sizeof(*r) + size, socket_id,
+					 0, RTE_CACHE_LINE_SIZE);
+	if (mz == NULL)
+		return NULL;
+
+	r = mz->addr;
+	memset(r, 0, sizeof(*r));
+	r->mz = mz;
+	r->size = size;
+	r->mask = size - 1;
+
+	return r;
+}
+
+void
+rte_pcapng_ring_free(struct rte_pcapng_ring *r)
+{
+	if (r != NULL)
+		rte_memzone_free(r->mz);
+}
+
+/* Copy to the ring at position pos, and return the following position */
+static uint32_t
+pcapng_ring_put(struct rte_pcapng_ring *r, uint32_t pos,
+		const void *src, uint32_t len)
+{
+	uint32_t idx = pos & r->mask;
+	uint32_t n = RTE_MIN(len, r->size - idx);
+
+	memcpy(r->data + idx, src, n);
+	if (unlikely(n < len))
+		memcpy(r->data, (const uint8_t *)src + n, len - n);
+
+	return pos + len;
+}
+
+/* Copy len bytes of packet data, starting at offset off, to the ring */
+static uint32_t
+pcapng_ring_put_mbuf(struct rte_pcapng_ring *r, uint32_t pos,
+		     const struct rte_mbuf *m, uint32_t off, uint32_t len)
+{
+	uint32_t n;
+
+	while (m != NULL && off >= rte_pktmbuf_data_len(m)) {
+		off -= rte_pktmbuf_data_len(m);
+		m = m->next;
+	}
+
+	for (; len > 0 && m != NULL; m = m->next, off = 0) {
+		n = RTE_MIN(len, rte_pktmbuf_data_len(m) - off);
+		pos = pcapng_ring_put(r, pos,
+				      rte_pktmbuf_mtod_offset(m, void *, off), n);
+		len -= n;
+	}
+
+	return pos;
+}
+
+/* A 32 bit field of a block in the ring, which never wraps */
+static inline uint32_t *
+pcapng_ring_u32(struct rte_pcapng_ring *r, uint32_t pos)
+{
+	return (uint32_t *)(r->data + (pos & r->mask));
+}
+
+/* Ether type and TCI of a VLAN tag, as inserted after the MAC addresses */
+static inline uint32_t
+pcapng_vlan_tag(uint16_t ether_type, uint16_t tci)
+{
+	const rte_be16_t tag[2] = {
+		rte_cpu_to_be_16(ether_type),
+		rte_cpu_to_be_16(tci),
+	};
+	uint32_t v;
+
+	memcpy(&v, tag, sizeof(v));
+	return v;
+}
+
+/* Compute the layout of a packet block, with data truncated to length */
+static void
+pcapng_ring_pkt_layout(struct pcapng_ring_pkt *p, const struct rte_mbuf *md,
+		       uint32_t length, enum rte_pcapng_direction direction)
+{
+	uint32_t optlen;
+
+	p->nb_tags = 0;
+	/* Expand any offloaded VLAN information, outer tag first */
+	if (rte_pktmbuf_pkt_len(md) >= 2u * RTE_ETHER_ADDR_LEN) {
+		if ((direction == RTE_PCAPNG_DIRECTION_IN &&
+		     (md->ol_flags & RTE_MBUF_F_RX_QINQ_STRIPPED)) ||
+		    (direction == RTE_PCAPNG_DIRECTION_OUT &&
+		     (md->ol_flags & RTE_MBUF_F_TX_QINQ)))
+			p->tags[p->nb_tags++] = pcapng_vlan_tag(RTE_ETHER_TYPE_QINQ,
+							       md->vlan_tci_outer);
+		if ((direction == RTE_PCAPNG_DIRECTION_IN &&
+		     (md->ol_flags & RTE_MBUF_F_RX_VLAN_STRIPPED)) ||
+		    (direction == RTE_PCAPNG_DIRECTION_OUT &&
+		     (md->ol_flags & RTE_MBUF_F_TX_VLAN)))
+			p->tags[p->nb_tags++] = pcapng_vlan_tag(RTE_ETHER_TYPE_VLAN,
+							       md->vlan_tci);
+	}
+
+	p->orig_len = rte_pktmbuf_pkt_len(md) + p->nb_tags * sizeof(uint32_t);
+	p->cap_len = RTE_MIN(p->orig_len, length);
+
+	optlen = pcapng_optlen(sizeof(uint32_t));	/* flags */
+	optlen += pcapng_optlen(sizeof(uint32_t));	/* queue */
+	if (direction == RTE_PCAPNG_DIRECTION_IN &&
+	    (md->ol_flags & RTE_MBUF_F_RX_RSS_HASH))
+		optlen += pcapng_optlen(sizeof(uint8_t) + sizeof(uint32_t));
+
+	p->block_len = sizeof(struct pcapng_enhance_packet_block) +
+		RTE_ALIGN(p->cap_len, sizeof(uint32_t)) +
+		optlen + sizeof(uint32_t);
+}
+
+/* Format a packet block in the ring, and return the following position */
+static uint32_t
+pcapng_ring_put_pkt(struct rte_pcapng_ring *r, uint32_t pos,
+		    const struct pcapng_ring_pkt *p, const struct rte_mbuf *md,
+		    uint16_t port_id, uint32_t queue, uint64_t cycles,
+		    enum rte_pcapng_direction direction)
+{
+	static const uint8_t zero[sizeof(uint32_t)];
+	struct pcapng_enhance_packet_block epb = {
+		.block_type = PCAPNG_ENHANCED_PACKET_BLOCK,
+		.block_length = p->block_len,
+		.interface_id = port_id,	/* converted when written */
+		.timestamp_hi = cycles >> 32,
+		.timestamp_lo = (uint32_t)cycles,
+		.capture_length = p->cap_len,
+		.original_length = p->orig_len,
+	};
+	uint32_t opts[PCAPNG_RING_OPTLEN / sizeof(uint32_t)];
+	struct pcapng_option *opt;
+	uint32_t len, head, flags;
+
+	pos = pcapng_ring_put(r, pos, &epb, sizeof(epb));
+
+	/* packet data: MAC addresses, inserted tags, then the rest */
+	len = p->cap_len;
+	if (p->nb_tags > 0) {
+		head = RTE_MIN(len, 2u * RTE_ETHER_ADDR_LEN);
+		pos = pcapng_ring_put_mbuf(r, pos, md, 0, head);
+		len -= head;
+
+		head = RTE_MIN(len, p->nb_tags * sizeof(uint32_t));
+		pos = pcapng_ring_put(r, pos, p->tags, head);
+		len -= head;
+
+		pos = pcapng_ring_put_mbuf(r, pos, md, 2u * RTE_ETHER_ADDR_LEN, len);
+	} else {
+		pos = pcapng_ring_put_mbuf(r, pos, md, 0, len);
+	}
+	pos = pcapng_ring_put(r, pos, zero,
+			      RTE_ALIGN(p->cap_len, sizeof(uint32_t)) - p->cap_len);
+
+	switch (direction) {
+	case RTE_PCAPNG_DIRECTION_IN:
+		flags = PCAPNG_IFB_INBOUND;
+		break;
+	case RTE_PCAPNG_DIRECTION_OUT:
+		flags = PCAPNG_IFB_OUTBOUND;
+		break;
+	default:
+		flags = 0;
+	}
+
+	opt = pcapng_add_option((struct pcapng_option *)opts, PCAPNG_EPB_FLAGS,
+				&flags, sizeof(flags));
+	opt = pcapng_add_option(opt, PCAPNG_EPB_QUEUE,
+				&queue, sizeof(queue));
+	if (direction == RTE_PCAPNG_DIRECTION_IN &&
+	    (md->ol_flags & RTE_MBUF_F_RX_RSS_HASH)) {
+		uint8_t hash_opt[5];
+
+		hash_opt[0] = PCAPNG_HASH_TOEPLITZ;
+		memcpy(&hash_opt[1], &md->hash.rss, sizeof(uint32_t));
+		opt = pcapng_add_option(opt, PCAPNG_EPB_HASH,
+					&hash_opt, sizeof(hash_opt));
+	}
+
+	/* set trailer of block length */
+	*(uint32_t *)opt = p->block_len;
+	len = (uint8_t *)opt - (uint8_t *)opts + sizeof(uint32_t);
+
+	return pcapng_ring_put(r, pos, opts, len);
+}
+
+/* Format a burst of at most PCAPNG_RING_BURST packets in the ring */
+static uint16_t
+pcapng_ring_copy_burst(struct rte_pcapng_ring *r,
+		       uint16_t port_id, uint32_t queue,
+		       struct rte_mbuf * const pkts[], uint16_t nb_pkts,
+		       uint32_t length, enum rte_pcapng_direction direction)
+{
+	struct pcapng_ring_pkt layout[PCAPNG_RING_BURST];
+	uint32_t head, pos, total, free_space;
+	uint64_t cycles;
+	uint16_t i, n;
+
+	for (i = 0; i < nb_pkts; i++)
+		pcapng_ring_pkt_layout(&layout[i], pkts[i], length, direction);
+
+	/* reserve space for as many blocks of the burst as possible */
+	head = rte_atomic_load_explicit(&r->prod_head, rte_memory_order_relaxed);
+	do {
+		free_space = r->size - (head -
+			rte_atomic_load_explicit(&r->cons_tail,
+						 rte_memory_order_acquire));
+		total = 0;
+		for (n = 0; n < nb_pkts; n++) {
+			if (total + layout[n].block_len > free_space)
+				break;
+			total += layout[n].block_len;
+		}
+		if (n == 0)
+			return 0;
+	} while (!rte_atomic_compare_exchange_weak_explicit(&r->prod_head,
+			&head, head + total,
+			rte_memory_order_relaxed, rte_memory_order_relaxed));
+
+	cycles = rte_get_tsc_cycles();
+	pos = head;
+	for (i = 0; i < n; i++)
+		pos = pcapng_ring_put_pkt(r, pos, &layout[i], pkts[i],
+					  port_id, queue, cycles, direction);
+
+	/* wait for the producers which reserved space before to publish */
+	rte_wait_until_equal_32((uint32_t *)(uintptr_t)&r->prod_tail, head,
+				rte_memory_order_relaxed);
+	rte_atomic_store_explicit(&r->prod_tail, head + total,
+				  rte_memory_order_release);
+
+	return n;
+}
+
+uint16_t
+rte_pcapng_ring_copy(struct rte_pcapng_ring *r,
+		     uint16_t port_id, uint32_t queue,
+		     struct rte_mbuf * const pkts[], uint16_t nb_pkts,
+		     uint32_t length, enum rte_pcapng_direction direction)
+{
+	uint16_t burst, n, copied = 0;
+
+	while (copied < nb_pkts) {
+		burst = RTE_MIN(nb_pkts - copied, PCAPNG_RING_BURST);
+		n = pcapng_ring_copy_burst(r, port_id, queue, &pkts[copied],
+					   burst, length, direction);
+		copied += n;
+		if (n < burst)
+			break;
+	}
+
+	return copied;
+}
+
+/* Field of the packet block at position pos in the ring */
+#define PCAPNG_RING_EPB(r, pos, field) \
+	(*pcapng_ring_u32(r, (pos) + \
+		offsetof(struct pcapng_enhance_packet_block, field)))
+
+/* Write the blocks converted in the ring, and count those completely written */
+static ssize_t
+pcapng_ring_write(rte_pcapng_t *self, struct rte_pcapng_ring *r,
+		  uint32_t *tail, uint32_t end, uint32_t *count)
+{
+	uint32_t head, idx, len = end - *tail;
+	struct iovec iov[2];
+	ssize_t ret;
+
+	if (len == 0)
+		return 0;
+
+	idx = *tail & r->mask;
+	iov[0].iov_base = r->data + idx;
+	iov[0].iov_len = RTE_MIN(len, r->size - idx);
+	iov[1].iov_base = r->data;
+	iov[1].iov_len = len - iov[0].iov_len;
+
+	ret = writev(self->outfd, iov, iov[1].iov_len > 0 ? 2 : 1);
+	if (unlikely(ret < 0)) {
+		rte_errno = errno;
+		return -1;
+	}
+	*tail += ret;
+
+	for (head = r->cons_block; head != *tail; (*count)++) {
+		len = PCAPNG_RING_EPB(r, head, block_length);
+		if (*tail - head < len)
+			break;
+		head += len;
+	}
+	r->cons_block = head;
+
+	return ret;
+}
+
+ssize_t
+rte_pcapng_write_ring(rte_pcapng_t *self, struct rte_pcapng_ring *r,
+		      uint32_t *nb_pkts)
+{
+	uint32_t tail, head, prod, len = 0, port, count = 0;
+	uint64_t cycles, timestamp;
+	ssize_t ret, written = 0;
+
+	if (nb_pkts != NULL)
+		*nb_pkts = 0;
+
+	tail = rte_atomic_load_explicit(&r->cons_tail, rte_memory_order_relaxed);
+	prod = rte_atomic_load_explicit(&r->prod_tail, rte_memory_order_acquire);
+
+	for (;;) {
+		/*
+		 * Convert the blocks published since last call,
+		 * up to the first block of a port not in the file.
+		 * Header fields are 32 bit aligned, so never wrap in the ring.
+		 */
+		for (head = r->cons_head; head != prod; head += len) {
+			len = PCAPNG_RING_EPB(r, head, block_length);
+			port = PCAPNG_RING_EPB(r, head, interface_id);
+			if (unlikely(port >= RTE_MAX_ETHPORTS ||
+				     self->port_index[port] > RTE_MAX_ETHPORTS))
+				break;
+			PCAPNG_RING_EPB(r, head, interface_id) = self->port_index[port];
+
+			cycles = (uint64_t)PCAPNG_RING_EPB(r, head, timestamp_hi) << 32;
+			cycles += PCAPNG_RING_EPB(r, head, timestamp_lo);
+			timestamp = pcapng_timestamp(self, cycles);
+			PCAPNG_RING_EPB(r, head, timestamp_hi) = timestamp >> 32;
+			PCAPNG_RING_EPB(r, head, timestamp_lo) = (uint32_t)timestamp;
+		}
+		r->cons_head = head;
+
+		ret = pcapng_ring_write(self, r, &tail, head, &count);
+		if (unlikely(ret < 0)) {
+			if (written > 0)
+				break;
+			return -1;
+		}
+		written += ret;
+		if (tail != head || head == prod)
+			break;
+
+		/* drop the block, which would refer to an unknown interface */
+		tail += len;
+		r->cons_head = tail;
+		r->cons_block = tail;
+		r->dropped++;
+	}
+
+	if (nb_pkts != NULL)
+		*nb_pkts = count;
+
+	rte_atomic_store_explicit(&r->cons_tail, tail, rte_memory_order_release);
+	return written;
+}
+
+uint64_t
+rte_pcapng_ring_dropped(const struct rte_pcapng_ring *r)
+{
+	return r->dropped;
+}
+
 /* Create new pcapng writer handle */
 rte_pcapng_t *
 rte_pcapng_fdopen(int fd,
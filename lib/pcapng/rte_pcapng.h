@@ -22,6 +22,7 @@
 #include <stdint.h>
 #include <sys/types.h>
 
+#include <rte_compat.h>
 #include <rte_mempool.h>
 
 #ifdef __cplusplus
@@ -192,6 +193,124 @@ rte_pcapng_write_stats(rte_pcapng_t *self, uint16_t port,
 		       uint64_t ifrecv, uint64_t ifdrop,
 		       const char *comment);
 
+/* Shared memory ring of pcapng packet blocks. */
+struct rte_pcapng_ring;
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Create a ring of pcapng packet blocks in shared memory.
+ *
+ * Packets are formatted by rte_pcapng_ring_copy() directly in the ring,
+ * from any number of threads and processes,
+ * and the ring is flushed to a capture file by rte_pcapng_write_ring(),
+ * without any intermediate mbuf copy.
+ *
+ * @param name
+ *   The name of the ring.
+ * @param size
+ *   The size of the ring in bytes, rounded up to a power of 2.
+ * @param socket_id
+ *   The NUMA socket to allocate the ring on, or SOCKET_ID_ANY.
+ * @return
+ *   Pointer to the new ring, or NULL in case of error (and rte_errno is set).
+ */
+__rte_experimental
+struct rte_pcapng_ring *
+rte_pcapng_ring_create(const char *name, uint32_t size, int socket_id);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Free a ring of pcapng packet blocks.
+ *
+ * @param ring
+ *   The ring to free, NULL is allowed.
+ */
+__rte_experimental
+void
+rte_pcapng_ring_free(struct rte_pcapng_ring *ring);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Format packets as pcapng Enhanced Packet Blocks into the ring.
+ *
+ * The packet data is truncated to the snapshot length before being copied.
+ * Space is reserved for several packets at once; if the ring is too full,
+ * only the first packets of the burst which fit are copied.
+ * This function is multi-thread safe.
+ *
+ * @param ring
+ *   The ring of pcapng blocks.
+ * @param port_id
+ *   The Ethernet port on which packets were received
+ *   or are going to be transmitted.
+ * @param queue
+ *   The queue on the Ethernet port.
+ * @param pkts
+ *   The packets to copy, they are not modified.
+ * @param nb_pkts
+ *   The number of packets to copy.
+ * @param length
+ *   The upper limit on bytes to copy per packet,
+ *   UINT32_MAX means all data.
+ * @param direction
+ *   The direction of the packets: receive, transmit or unknown.
+ * @return
+ *   The number of packets copied in the ring.
+ */
+__rte_experimental
+uint16_t
+rte_pcapng_ring_copy(struct rte_pcapng_ring *ring,
+		     uint16_t port_id, uint32_t queue,
+		     struct rte_mbuf * const pkts[], uint16_t nb_pkts,
+		     uint32_t length, enum rte_pcapng_direction direction);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Write the packet blocks available in the ring to the capture file.
+ *
+ * The blocks are written straight from the ring memory.
+ * The blocks of ports which were not added to the file are dropped,
+ * and counted by rte_pcapng_ring_dropped().
+ * Only one thread may write a given ring at a time.
+ *
+ * @param self
+ *  The handle to the packet capture file
+ * @param ring
+ *  The ring of pcapng blocks.
+ * @param nb_pkts
+ *  Optional: set to the number of packets completely written.
+ * @return
+ *  The number of bytes written to file, -1 on failure to write file.
+ */
+__rte_experimental
+ssize_t
+rte_pcapng_write_ring(rte_pcapng_t *self, struct rte_pcapng_ring *ring,
+		      uint32_t *nb_pkts);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the number of packet blocks dropped by rte_pcapng_write_ring()
+ * because their port was not added to the capture file.
+ *
+ * @param ring
+ *  The ring of pcapng blocks.
+ * @return
+ *  The number of dropped blocks.
+ */
+__rte_experimental
+uint64_t
+rte_pcapng_ring_dropped(const struct rte_pcapng_ring *ring);
+
 #ifdef __cplusplus
 }
 #endif
@@ -4,6 +4,7 @@
 
 #include <stdlib.h>
 
+#include <rte_cycles.h>
 #include <rte_mbuf.h>
 #include <rte_ethdev.h>
 #include <rte_lcore.h>
@@ -33,6 +34,7 @@ enum pdump_operation {
 enum pdump_version {
 	V1 = 1,		    /* no filtering or snap */
 	V2 = 2,
+	V3 = 3,		    /* pcapng blocks written in a pcapng ring */
 };
 
 struct pdump_request {
@@ -46,6 +48,10 @@ struct pdump_request {
 
 	const struct rte_bpf_prm *prm;
 	uint32_t snaplen;
+	struct rte_pcapng_ring *pcapng_ring;
+	uint32_t sample_rate;
+	uint64_t pkt_budget;
+	uint64_t byte_budget;
 };
 
 struct pdump_response {
@@ -54,13 +60,27 @@ struct pdump_response {
 	int32_t err_value;
 };
 
+/*
+ * Per queue capture context. Each queue is polled by a single lcore,
+ * so sampling and budget state is updated without atomics.
+ */
 static struct pdump_rxtx_cbs {
 	struct rte_ring *ring;
 	struct rte_mempool *mp;
+	struct rte_pcapng_ring *pcapng_ring;
 	const struct rte_eth_rxtx_callback *cb;
 	const struct rte_bpf *filter;
+	uint64_t (*filter_jit)(void *ctx); /* NULL if filter is interpreted */
 	enum pdump_version ver;
 	uint32_t snaplen;
+
+	uint32_t sample_rate;	/* consider 1 packet out of sample_rate */
+	uint32_t sample_count;
+	uint64_t pkt_budget;	/* packets per second, 0 for no limit */
+	uint64_t byte_budget;	/* bytes per second, 0 for no limit */
+	uint64_t budget_start;	/* TSC at start of current second */
+	uint64_t budget_pkts;	/* packets captured in current second */
+	uint64_t budget_bytes;	/* bytes captured in current second */
 } rx_cbs[RTE_MAX_ETHPORTS][RTE_MAX_QUEUES_PER_PORT],
 tx_cbs[RTE_MAX_ETHPORTS][RTE_MAX_QUEUES_PER_PORT];
 
@@ -77,41 +97,158 @@ static struct {
 	const struct rte_memzone *mz;
 } *pdump_stats;
 
+/* Keep 1 packet out of sample_rate, return the number of packets kept. */
+static uint16_t
+pdump_sample(struct pdump_rxtx_cbs *cbs, struct rte_mbuf **pkts,
+	     uint16_t nb_pkts, struct rte_mbuf **sampled)
+{
+	uint32_t count = cbs->sample_count;
+	uint16_t i, n = 0;
+
+	for (i = 0; i < nb_pkts; i++) {
+		if (++count < cbs->sample_rate)
+			continue;
+		count = 0;
+		sampled[n++] = pkts[i];
+	}
+	cbs->sample_count = count;
+
+	return n;
+}
+
+/* Run the filter, return the number of matching packets. */
+static uint16_t
+pdump_filter(const struct pdump_rxtx_cbs *cbs, struct rte_mbuf **pkts,
+	     uint16_t nb_pkts, struct rte_mbuf **matched)
+{
+	uint64_t rcs[nb_pkts];
+	uint16_t i, n = 0;
+
+	/*
+	 * This uses same BPF return value convention as socket filter
+	 * and pcap_offline_filter.
+	 * if program returns zero
+	 * then packet doesn't match the filter (will be ignored).
+	 */
+	if (cbs->filter_jit != NULL) {
+		for (i = 0; i < nb_pkts; i++)
+			if (cbs->filter_jit(pkts[i]) != 0)
+				matched[n++] = pkts[i];
+		return n;
+	}
+
+	rte_bpf_exec_burst(cbs->filter, (void **)pkts, rcs, nb_pkts);
+	for (i = 0; i < nb_pkts; i++)
+		if (rcs[i] != 0)
+			matched[n++] = pkts[i];
+	return n;
+}
+
+/* Return the number of first packets within the per second budgets. */
+static uint16_t
+pdump_budget(struct pdump_rxtx_cbs *cbs, struct rte_mbuf **pkts,
+	     uint16_t nb_pkts)
+{
+	uint64_t now = rte_get_tsc_cycles();
+	uint64_t bytes;
+	uint32_t len;
+	uint16_t n;
+
+	if (now - cbs->budget_start >= rte_get_tsc_hz()) {
+		cbs->budget_start = now;
+		cbs->budget_pkts = 0;
+		cbs->budget_bytes = 0;
+	}
+
+	if (cbs->pkt_budget != 0)
+		nb_pkts = RTE_MIN(nb_pkts, cbs->pkt_budget - cbs->budget_pkts);
+
+	bytes = cbs->budget_bytes;
+	for (n = 0; n < nb_pkts; n++) {
+		len = RTE_MIN(rte_pktmbuf_pkt_len(pkts[n]), cbs->snaplen);
+		if (cbs->byte_budget != 0 && bytes + len > cbs->byte_budget)
+			break;
+		bytes += len;
+	}
+
+	cbs->budget_pkts += n;
+	cbs->budget_bytes = bytes;
+	return n;
+}
+
 /* Create a clone of mbuf to be placed into ring. */
 static void
 pdump_copy(uint16_t port_id, uint16_t queue,
 	   enum rte_pcapng_direction direction,
 	   struct rte_mbuf **pkts, uint16_t nb_pkts,
-	   const struct pdump_rxtx_cbs *cbs,
+	   struct pdump_rxtx_cbs *cbs,
 	   struct rte_pdump_stats *stats)
 {
 	unsigned int i;
 	int ring_enq;
-	uint16_t d_pkts = 0;
+	uint16_t n, d_pkts = 0;
+	struct rte_mbuf *sel_bufs[nb_pkts];
 	struct rte_mbuf *dup_bufs[nb_pkts];
 	struct rte_ring *ring;
 	struct rte_mempool *mp;
 	struct rte_mbuf *p;
-	uint64_t rcs[nb_pkts];
 
-	if (cbs->filter)
-		rte_bpf_exec_burst(cbs->filter, (void **)pkts, rcs, nb_pkts);
+	/* sampling and budgets are applied before the filter, as it is costly */
+	if (cbs->sample_rate > 1) {
+		n = pdump_sample(cbs, pkts, nb_pkts, sel_bufs);
+		rte_atomic_fetch_add_explicit(&stats->skipped, nb_pkts - n,
+					      rte_memory_order_relaxed);
+		if (n == 0)
+			return;
+		pkts = sel_bufs;
+		nb_pkts = n;
+	}
+
+	if ((cbs->pkt_budget != 0 && cbs->budget_pkts >= cbs->pkt_budget) ||
+	    (cbs->byte_budget != 0 && cbs->budget_bytes >= cbs->byte_budget)) {
+		if (rte_get_tsc_cycles() - cbs->budget_start < rte_get_tsc_hz()) {
+			rte_atomic_fetch_add_explicit(&stats->skipped, nb_pkts,
+						      rte_memory_order_relaxed);
+			return;
+		}
+	}
+
+	if (cbs->filter) {
+		n = pdump_filter(cbs, pkts, nb_pkts, sel_bufs);
+		if (n < nb_pkts)
+			rte_atomic_fetch_add_explicit(&stats->filtered, nb_pkts - n,
+						      rte_memory_order_relaxed);
+		if (n == 0)
+			return;
+		pkts = sel_bufs;
+		nb_pkts = n;
+	}
+
+	if (cbs->pkt_budget != 0 || cbs->byte_budget != 0) {
+		n = pdump_budget(cbs, pkts, nb_pkts);
+		if (n < nb_pkts)
+			rte_atomic_fetch_add_explicit(&stats->skipped, nb_pkts - n,
+						      rte_memory_order_relaxed);
+		if (n == 0)
+			return;
+		nb_pkts = n;
+	}
+
+	/* write pcapng blocks directly into the shared memory ring */
+	if (cbs->ver == V3) {
+		n = rte_pcapng_ring_copy(cbs->pcapng_ring, port_id, queue,
+					 pkts, nb_pkts, cbs->snaplen, direction);
+		rte_atomic_fetch_add_explicit(&stats->accepted, n,
+					      rte_memory_order_relaxed);
+		if (unlikely(n < nb_pkts))
+			rte_atomic_fetch_add_explicit(&stats->ringfull, nb_pkts - n,
+						      rte_memory_order_relaxed);
+		return;
+	}
 
 	ring = cbs->ring;
 	mp = cbs->mp;
 	for (i = 0; i < nb_pkts; i++) {
-		/*
-		 * This uses same BPF return value convention as socket filter
-		 * and pcap_offline_filter.
-		 * if program returns zero
-		 * then packet doesn't match the filter (will be ignored).
-		 */
-		if (cbs->filter && rcs[i] == 0) {
-			rte_atomic_fetch_add_explicit(&stats->filtered,
-					   1, rte_memory_order_relaxed);
-			continue;
-		}
-
 		/*
 		 * If using pcapng then want to wrap packets
 		 * otherwise a simple copy.
@@ -145,7 +282,7 @@ pdump_rx(uint16_t port, uint16_t queue,
 	struct rte_mbuf **pkts, uint16_t nb_pkts,
 	uint16_t max_pkts __rte_unused, void *user_params)
 {
-	const struct pdump_rxtx_cbs *cbs = user_params;
+	struct pdump_rxtx_cbs *cbs = user_params;
 	struct rte_pdump_stats *stats = &pdump_stats->rx[port][queue];
 
 	pdump_copy(port, queue, RTE_PCAPNG_DIRECTION_IN,
@@ -157,7 +294,7 @@ static uint16_t
 pdump_tx(uint16_t port, uint16_t queue,
 		struct rte_mbuf **pkts, uint16_t nb_pkts, void *user_params)
 {
-	const struct pdump_rxtx_cbs *cbs = user_params;
+	struct pdump_rxtx_cbs *cbs = user_params;
 	struct rte_pdump_stats *stats = &pdump_stats->tx[port][queue];
 
 	pdump_copy(port, queue, RTE_PCAPNG_DIRECTION_OUT,
@@ -165,12 +302,37 @@ pdump_tx(uint16_t port, uint16_t queue,
 	return nb_pkts;
 }
 
+static void
+pdump_cbs_init(struct pdump_rxtx_cbs *cbs, const struct pdump_request *p,
+	       const struct rte_bpf *filter)
+{
+	struct rte_bpf_jit jit;
+
+	cbs->ver = p->ver;
+	cbs->ring = p->ring;
+	cbs->mp = p->mp;
+	cbs->pcapng_ring = p->pcapng_ring;
+	cbs->snaplen = p->snaplen;
+	cbs->filter = filter;
+
+	/* prefer the native code generated at load time, if any */
+	cbs->filter_jit = NULL;
+	if (filter != NULL && rte_bpf_get_jit(filter, &jit) == 0)
+		cbs->filter_jit = jit.func;
+
+	cbs->sample_rate = p->sample_rate;
+	cbs->sample_count = 0;
+	cbs->pkt_budget = p->pkt_budget;
+	cbs->byte_budget = p->byte_budget;
+	cbs->budget_start = rte_get_tsc_cycles();
+	cbs->budget_pkts = 0;
+	cbs->budget_bytes = 0;
+}
+
 static int
-pdump_register_rx_callbacks(enum pdump_version ver,
+pdump_register_rx_callbacks(const struct pdump_request *p,
 			    uint16_t end_q, uint16_t port, uint16_t queue,
-			    struct rte_ring *ring, struct rte_mempool *mp,
-			    struct rte_bpf *filter,
-			    uint16_t operation, uint32_t snaplen)
+			    struct rte_bpf *filter, uint16_t operation)
 {
 	uint16_t qid;
 
@@ -185,11 +347,7 @@ pdump_register_rx_callbacks(enum pdump_version ver,
 					port, qid);
 				return -EEXIST;
 			}
-			cbs->ver = ver;
-			cbs->ring = ring;
-			cbs->mp = mp;
-			cbs->snaplen = snaplen;
-			cbs->filter = filter;
+			pdump_cbs_init(cbs, p, filter);
 
 			cbs->cb = rte_eth_add_first_rx_callback(port, qid,
 								pdump_rx, cbs);
@@ -223,11 +381,9 @@ pdump_register_rx_callbacks(enum pdump_version ver,
 }
 
 static int
-pdump_register_tx_callbacks(enum pdump_version ver,
+pdump_register_tx_callbacks(const struct pdump_request *p,
 			    uint16_t end_q, uint16_t port, uint16_t queue,
-			    struct rte_ring *ring, struct rte_mempool *mp,
-			    struct rte_bpf *filter,
-			    uint16_t operation, uint32_t snaplen)
+			    struct rte_bpf *filter, uint16_t operation)
 {
 
 	uint16_t qid;
@@ -243,11 +399,7 @@ pdump_register_tx_callbacks(enum pdump_version ver,
 					port, qid);
 				return -EEXIST;
 			}
-			cbs->ver = ver;
-			cbs->ring = ring;
-			cbs->mp = mp;
-			cbs->snaplen = snaplen;
-			cbs->filter = filter;
+			pdump_cbs_init(cbs, p, filter);
 
 			cbs->cb = rte_eth_add_tx_callback(port, qid, pdump_tx,
 								cbs);
@@ -289,11 +441,9 @@ set_pdump_rxtx_cbs(const struct pdump_request *p)
 	struct rte_bpf *filter = NULL;
 	uint32_t flags;
 	uint16_t operation;
-	struct rte_ring *ring;
-	struct rte_mempool *mp;
 
 	/* Check for possible DPDK version mismatch */
-	if (!(p->ver == V1 || p->ver == V2)) {
+	if (!(p->ver == V1 || p->ver == V2 || p->ver == V3)) {
 		PDUMP_LOG_LINE(ERR,
 			  "incorrect client version %u", p->ver);
 		return -EINVAL;
@@ -318,8 +468,6 @@ set_pdump_rxtx_cbs(const struct pdump_request *p)
 	flags = p->flags;
 	operation = p->op;
 	queue = p->queue;
-	ring = p->ring;
-	mp = p->mp;
 
 	ret = rte_eth_dev_get_port_by_name(p->device, &port);
 	if (ret < 0) {
@@ -364,9 +512,8 @@ set_pdump_rxtx_cbs(const struct pdump_request *p)
 	/* register RX callback */
 	if (flags & RTE_PDUMP_FLAG_RX) {
 		end_q = (queue == RTE_PDUMP_ALL_QUEUES) ? nb_rx_q : queue + 1;
-		ret = pdump_register_rx_callbacks(p->ver, end_q, port, queue,
-						  ring, mp, filter,
-						  operation, p->snaplen);
+		ret = pdump_register_rx_callbacks(p, end_q, port, queue,
+						  filter, operation);
 		if (ret < 0)
 			return ret;
 	}
@@ -374,9 +521,8 @@ set_pdump_rxtx_cbs(const struct pdump_request *p)
 	/* register TX callback */
 	if (flags & RTE_PDUMP_FLAG_TX) {
 		end_q = (queue == RTE_PDUMP_ALL_QUEUES) ? nb_tx_q : queue + 1;
-		ret = pdump_register_tx_callbacks(p->ver, end_q, port, queue,
-						  ring, mp, filter,
-						  operation, p->snaplen);
+		ret = pdump_register_tx_callbacks(p, end_q, port, queue,
+						  filter, operation);
 		if (ret < 0)
 			return ret;
 	}
@@ -521,11 +667,8 @@ pdump_validate_port(uint16_t port, char *name)
 
 static int
 pdump_prepare_client_request(const char *device, uint16_t queue,
-			     uint32_t flags, uint32_t snaplen,
-			     uint16_t operation,
-			     struct rte_ring *ring,
-			     struct rte_mempool *mp,
-			     const struct rte_bpf_prm *prm)
+			     uint32_t flags, uint16_t operation,
+			     const struct rte_pdump_param *param)
 {
 	int ret = -1;
 	struct rte_mp_msg mp_req, *mp_rep;
@@ -542,17 +685,24 @@ pdump_prepare_client_request(const char *device, uint16_t queue,
 
 	memset(req, 0, sizeof(*req));
 
-	req->ver = (flags & RTE_PDUMP_FLAG_PCAPNG) ? V2 : V1;
+	if (param != NULL && param->pcapng_ring != NULL)
+		req->ver = V3;
+	else
+		req->ver = (flags & RTE_PDUMP_FLAG_PCAPNG) ? V2 : V1;
 	req->flags = flags & RTE_PDUMP_FLAG_RXTX;
 	req->op = operation;
 	req->queue = queue;
 	rte_strscpy(req->device, device, sizeof(req->device));
 
 	if ((operation & ENABLE) != 0) {
-		req->ring = ring;
-		req->mp = mp;
-		req->prm = prm;
-		req->snaplen = snaplen;
+		req->ring = param->ring;
+		req->mp = param->mp;
+		req->pcapng_ring = param->pcapng_ring;
+		req->prm = param->prm;
+		req->snaplen = param->snaplen != 0 ? param->snaplen : UINT32_MAX;
+		req->sample_rate = param->sample_rate;
+		req->pkt_budget = param->pkt_budget;
+		req->byte_budget = param->byte_budget;
 	}
 
 	rte_strscpy(mp_req.name, PDUMP_MP, RTE_MP_MAX_NAME_LEN);
@@ -574,6 +724,38 @@ pdump_prepare_client_request(const char *device, uint16_t queue,
 	return ret;
 }
 
+static int
+pdump_validate_param(const struct rte_pdump_param *param)
+{
+	if (param == NULL) {
+		PDUMP_LOG_LINE(ERR, "NULL parameters");
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	if (param->pcapng_ring != NULL)
+		return 0;
+
+	return pdump_validate_ring_mp(param->ring, param->mp);
+}
+
+static int
+pdump_enable_by_deviceid(const char *device_id, uint16_t queue,
+			 uint32_t flags, const struct rte_pdump_param *param)
+{
+	int ret;
+
+	ret = pdump_validate_param(param);
+	if (ret < 0)
+		return ret;
+	ret = pdump_validate_flags(flags);
+	if (ret < 0)
+		return ret;
+
+	return pdump_prepare_client_request(device_id, queue, flags,
+					    ENABLE, param);
+}
+
 /*
  * There are two versions of this function, because although original API
  * left place holder for future filter, it never checked the value.
@@ -581,29 +763,17 @@ pdump_prepare_client_request(const char *device, uint16_t queue,
  * bogus value.
  */
 static int
-pdump_enable(uint16_t port, uint16_t queue,
-	     uint32_t flags, uint32_t snaplen,
-	     struct rte_ring *ring, struct rte_mempool *mp,
-	     const struct rte_bpf_prm *prm)
+pdump_enable(uint16_t port, uint16_t queue, uint32_t flags,
+	     const struct rte_pdump_param *param)
 {
 	int ret;
 	char name[RTE_DEV_NAME_MAX_LEN];
 
 	ret = pdump_validate_port(port, name);
-	if (ret < 0)
-		return ret;
-	ret = pdump_validate_ring_mp(ring, mp);
-	if (ret < 0)
-		return ret;
-	ret = pdump_validate_flags(flags);
 	if (ret < 0)
 		return ret;
 
-	if (snaplen == 0)
-		snaplen = UINT32_MAX;
-
-	return pdump_prepare_client_request(name, queue, flags, snaplen,
-					    ENABLE, ring, mp, prm);
+	return pdump_enable_by_deviceid(name, queue, flags, param);
 }
 
 int
@@ -612,8 +782,12 @@ rte_pdump_enable(uint16_t port, uint16_t queue, uint32_t flags,
 		 struct rte_mempool *mp,
 		 void *filter __rte_unused)
 {
-	return pdump_enable(port, queue, flags, 0,
-			    ring, mp, NULL);
+	struct rte_pdump_param param = {
+		.ring = ring,
+		.mp = mp,
+	};
+
+	return pdump_enable(port, queue, flags, &param);
 }
 
 int
@@ -623,31 +797,45 @@ rte_pdump_enable_bpf(uint16_t port, uint16_t queue,
 		     struct rte_mempool *mp,
 		     const struct rte_bpf_prm *prm)
 {
-	return pdump_enable(port, queue, flags, snaplen,
-			    ring, mp, prm);
+	struct rte_pdump_param param = {
+		.snaplen = snaplen,
+		.ring = ring,
+		.mp = mp,
+		.prm = prm,
+	};
+
+	return pdump_enable(port, queue, flags, &param);
 }
 
-static int
-pdump_enable_by_deviceid(const char *device_id, uint16_t queue,
-			 uint32_t flags, uint32_t snaplen,
-			 struct rte_ring *ring,
-			 struct rte_mempool *mp,
-			 const struct rte_bpf_prm *prm)
+int
+rte_pdump_enable_pcapng_ring(uint16_t port, uint16_t queue,
+			     uint32_t flags, uint32_t snaplen,
+			     struct rte_pcapng_ring *ring,
+			     const struct rte_bpf_prm *prm)
 {
-	int ret;
+	struct rte_pdump_param param = {
+		.snaplen = snaplen,
+		.pcapng_ring = ring,
+		.prm = prm,
+	};
+
+	if (ring == NULL) {
+		PDUMP_LOG_LINE(ERR, "NULL pcapng ring");
+		rte_errno = EINVAL;
+		return -1;
+	}
 
-	ret = pdump_validate_ring_mp(ring, mp);
-	if (ret < 0)
-		return ret;
-	ret = pdump_validate_flags(flags);
-	if (ret < 0)
-		return ret;
+	return pdump_enable(port, queue, flags | RTE_PDUMP_FLAG_PCAPNG, &param);
+}
 
-	if (snaplen == 0)
-		snaplen = UINT32_MAX;
+int
+rte_pdump_enable_ext(uint16_t port, uint16_t queue, uint32_t flags,
+		     const struct rte_pdump_param *param)
+{
+	if (param != NULL && param->pcapng_ring != NULL)
+		flags |= RTE_PDUMP_FLAG_PCAPNG;
 
-	return pdump_prepare_client_request(device_id, queue, flags, snaplen,
-					    ENABLE, ring, mp, prm);
+	return pdump_enable(port, queue, flags, param);
 }
 
 int
@@ -657,8 +845,12 @@ rte_pdump_enable_by_deviceid(char *device_id, uint16_t queue,
 			     struct rte_mempool *mp,
 			     void *filter __rte_unused)
 {
-	return pdump_enable_by_deviceid(device_id, queue, flags, 0,
-					ring, mp, NULL);
+	struct rte_pdump_param param = {
+		.ring = ring,
+		.mp = mp,
+	};
+
+	return pdump_enable_by_deviceid(device_id, queue, flags, &param);
 }
 
 int
@@ -668,8 +860,47 @@ rte_pdump_enable_bpf_by_deviceid(const char *device_id, uint16_t queue,
 				 struct rte_mempool *mp,
 				 const struct rte_bpf_prm *prm)
 {
-	return pdump_enable_by_deviceid(device_id, queue, flags, snaplen,
-					ring, mp, prm);
+	struct rte_pdump_param param = {
+		.snaplen = snaplen,
+		.ring = ring,
+		.mp = mp,
+		.prm = prm,
+	};
+
+	return pdump_enable_by_deviceid(device_id, queue, flags, &param);
+}
+
+int
+rte_pdump_enable_pcapng_ring_by_deviceid(const char *device_id, uint16_t queue,
+					 uint32_t flags, uint32_t snaplen,
+					 struct rte_pcapng_ring *ring,
+					 const struct rte_bpf_prm *prm)
+{
+	struct rte_pdump_param param = {
+		.snaplen = snaplen,
+		.pcapng_ring = ring,
+		.prm = prm,
+	};
+
+	if (ring == NULL) {
+		PDUMP_LOG_LINE(ERR, "NULL pcapng ring");
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	return pdump_enable_by_deviceid(device_id, queue,
+					flags | RTE_PDUMP_FLAG_PCAPNG, &param);
+}
+
+int
+rte_pdump_enable_ext_by_deviceid(const char *device_id, uint16_t queue,
+				 uint32_t flags,
+				 const struct rte_pdump_param *param)
+{
+	if (param != NULL && param->pcapng_ring != NULL)
+		flags |= RTE_PDUMP_FLAG_PCAPNG;
+
+	return pdump_enable_by_deviceid(device_id, queue, flags, param);
 }
 
 int
@@ -685,8 +916,8 @@ rte_pdump_disable(uint16_t port, uint16_t queue, uint32_t flags)
 	if (ret < 0)
 		return ret;
 
-	ret = pdump_prepare_client_request(name, queue, flags, 0,
-					   DISABLE, NULL, NULL, NULL);
+	ret = pdump_prepare_client_request(name, queue, flags,
+					   DISABLE, NULL);
 
 	return ret;
 }
@@ -701,8 +932,8 @@ rte_pdump_disable_by_deviceid(char *device_id, uint16_t queue,
 	if (ret < 0)
 		return ret;
 
-	ret = pdump_prepare_client_request(device_id, queue, flags, 0,
-					   DISABLE, NULL, NULL, NULL);
+	ret = pdump_prepare_client_request(device_id, queue, flags,
+					   DISABLE, NULL);
 
 	return ret;
 }
@@ -15,6 +15,7 @@
 #include <stdint.h>
 
 #include <rte_bpf.h>
+#include <rte_compat.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -22,6 +23,8 @@ extern "C" {
 
 #define RTE_PDUMP_ALL_QUEUES UINT16_MAX
 
+struct rte_pcapng_ring;
+
 enum {
 	RTE_PDUMP_FLAG_RX = 1,  /* receive direction */
 	RTE_PDUMP_FLAG_TX = 2,  /* transmit direction */
@@ -196,6 +199,165 @@ rte_pdump_enable_bpf_by_deviceid(const char *device_id, uint16_t queue,
 				 struct rte_mempool *mp,
 				 const struct rte_bpf_prm *filter);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enables packet capturing on given port and queue into a pcapng ring.
+ *
+ * Instead of copying each captured packet into a new mbuf enqueued in a ring,
+ * packets are written as pcapng blocks directly into a shared memory ring,
+ * to be flushed to a file with rte_pcapng_write_ring().
+ *
+ * @param port_id
+ *  The Ethernet port on which packet capturing should be enabled.
+ * @param queue
+ *  The queue on the Ethernet port which packet capturing
+ *  should be enabled. Pass UINT16_MAX to enable packet capturing on all
+ *  queues of a given port.
+ * @param flags
+ *  Pdump library flags that specify direction,
+ *  the packet format is always pcapng.
+ * @param snaplen
+ *  The upper limit on bytes to copy.
+ *  Passing UINT32_MAX means capture all the possible data.
+ * @param ring
+ *  The pcapng ring, created with rte_pcapng_ring_create(),
+ *  in which captured packets will be written.
+ * @param prm
+ *  Use BPF program to run to filter packets (can be NULL)
+ *
+ * @return
+ *    0 on success, -1 on error, rte_errno is set accordingly.
+ */
+__rte_experimental
+int
+rte_pdump_enable_pcapng_ring(uint16_t port_id, uint16_t queue,
+			     uint32_t flags, uint32_t snaplen,
+			     struct rte_pcapng_ring *ring,
+			     const struct rte_bpf_prm *prm);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enables packet capturing on given device id and queue into a pcapng ring.
+ * device_id can be name or pci address of device.
+ *
+ * @param device_id
+ *  device id on which packet capturing should be enabled.
+ * @param queue
+ *  The queue on the Ethernet port which packet capturing
+ *  should be enabled. Pass UINT16_MAX to enable packet capturing on all
+ *  queues of a given port.
+ * @param flags
+ *  Pdump library flags that specify direction,
+ *  the packet format is always pcapng.
+ * @param snaplen
+ *  The upper limit on bytes to copy.
+ *  Passing UINT32_MAX means capture all the possible data.
+ * @param ring
+ *  The pcapng ring, created with rte_pcapng_ring_create(),
+ *  in which captured packets will be written.
+ * @param prm
+ *  Use BPF program to run to filter packets (can be NULL)
+ *
+ * @return
+ *    0 on success, -1 on error, rte_errno is set accordingly.
+ */
+__rte_experimental
+int
+rte_pdump_enable_pcapng_ring_by_deviceid(const char *device_id, uint16_t queue,
+					 uint32_t flags, uint32_t snaplen,
+					 struct rte_pcapng_ring *ring,
+					 const struct rte_bpf_prm *prm);
+
+/**
+ * Packet capture parameters for rte_pdump_enable_ext().
+ *
+ * Sampling and budgets are applied in the datapath before the BPF
+ * filter, so that the cost of capture on the forwarding lcores
+ * is bounded. They are tracked per queue.
+ */
+struct rte_pdump_param {
+	/** Upper limit on bytes to copy, 0 means capture all the data. */
+	uint32_t snaplen;
+	/** Capture 1 packet out of sample_rate, 0 or 1 disables sampling. */
+	uint32_t sample_rate;
+	/** Maximum packets captured per second and queue, 0 for no limit. */
+	uint64_t pkt_budget;
+	/** Maximum bytes captured per second and queue, 0 for no limit. */
+	uint64_t byte_budget;
+	/** Ring for mbuf copies, with MP/MC set (ignored if pcapng_ring). */
+	struct rte_ring *ring;
+	/** Mempool for mbuf copies, with MP/MC set (ignored if pcapng_ring). */
+	struct rte_mempool *mp;
+	/** Pcapng ring in which packets are written (can be NULL). */
+	struct rte_pcapng_ring *pcapng_ring;
+	/** BPF program to filter packets (can be NULL). */
+	const struct rte_bpf_prm *prm;
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enables packet capturing on given port and queue with extended parameters.
+ *
+ * The BPF filter is compiled to native code when supported by the
+ * architecture, otherwise it is interpreted.
+ * Packets which are not captured because of sampling or budgets
+ * are counted as skipped in the statistics.
+ *
+ * @param port_id
+ *  The Ethernet port on which packet capturing should be enabled.
+ * @param queue
+ *  The queue on the Ethernet port which packet capturing
+ *  should be enabled. Pass UINT16_MAX to enable packet capturing on all
+ *  queues of a given port.
+ * @param flags
+ *  Pdump library flags that specify direction and packet format.
+ *  The packet format is always pcapng if a pcapng ring is given.
+ * @param param
+ *  Capture parameters.
+ *
+ * @return
+ *    0 on success, -1 on error, rte_errno is set accordingly.
+ */
+__rte_experimental
+int
+rte_pdump_enable_ext(uint16_t port_id, uint16_t queue, uint32_t flags,
+		     const struct rte_pdump_param *param);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enables packet capturing on given device id and queue
+ * with extended parameters.
+ * device_id can be name or pci address of device.
+ *
+ * @param device_id
+ *  device id on which packet capturing should be enabled.
+ * @param queue
+ *  The queue on the Ethernet port which packet capturing
+ *  should be enabled. Pass UINT16_MAX to enable packet capturing on all
+ *  queues of a given port.
+ * @param flags
+ *  Pdump library flags that specify direction and packet format.
+ *  The packet format is always pcapng if a pcapng ring is given.
+ * @param param
+ *  Capture parameters.
+ *
+ * @return
+ *    0 on success, -1 on error, rte_errno is set accordingly.
+ */
+__rte_experimental
+int
+rte_pdump_enable_ext_by_deviceid(const char *device_id, uint16_t queue,
+				 uint32_t flags,
+				 const struct rte_pdump_param *param);
+
 
 /**
  * Disables packet capturing on given device_id and queue.
@@ -229,8 +391,9 @@ struct rte_pdump_stats {
 	RTE_ATOMIC(uint64_t) filtered; /**< Number of packets rejected by filter. */
 	RTE_ATOMIC(uint64_t) nombuf;   /**< Number of mbuf allocation failures. */
 	RTE_ATOMIC(uint64_t) ringfull; /**< Number of missed packets due to ring full. */
+	RTE_ATOMIC(uint64_t) skipped;  /**< Number of packets skipped by sampling or budget. */
 
-	uint64_t reserved[4]; /**< Reserved and pad to cache line */
+	uint64_t reserved[3]; /**< Reserved and pad to cache line */
 };
 
 /**
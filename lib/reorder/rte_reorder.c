@@ -13,6 +13,8 @@
 #include <rte_eal_memconfig.h>
 #include <rte_errno.h>
 #include <rte_malloc.h>
+#include <rte_spinlock.h>
+#include <rte_stdatomic.h>
 #include <rte_tailq.h>
 
 #include "rte_reorder.h"
@@ -52,8 +54,20 @@ struct __rte_cache_aligned rte_reorder_buffer {
 	unsigned int memsize; /**< memory area size of reorder buffer */
 	bool is_initialized; /**< flag indicates that buffer was initialized */
 
+	uint32_t flags; /**< RTE_REORDER_F_* flags */
+
 	struct cir_buffer ready_buf; /**< temp buffer for dequeued entries */
 	struct cir_buffer order_buf; /**< buffer used to reorder entries */
+
+	/*
+	 * Concurrent mode only: mbufs are inserted directly in the order
+	 * buffer entries, at the position given by their sequence number,
+	 * and the ready buffer is not used.
+	 */
+	RTE_ATOMIC(struct rte_mbuf *) *slots; /**< order_buf entries */
+	/** Lowest seq. number not drained yet */
+	alignas(RTE_CACHE_LINE_SIZE) RTE_ATOMIC(uint32_t) head_seqn;
+	rte_spinlock_t drain_lock; /**< serializes drains */
 };
 
 static void
@@ -65,9 +79,9 @@ rte_reorder_memory_footprint_get(unsigned int size)
 	return sizeof(struct rte_reorder_buffer) + (2 * size * sizeof(struct rte_mbuf *));
 }
 
-struct rte_reorder_buffer *
-rte_reorder_init(struct rte_reorder_buffer *b, unsigned int bufsize,
-		const char *name, unsigned int size)
+static struct rte_reorder_buffer *
+reorder_init(struct rte_reorder_buffer *b, unsigned int bufsize,
+		const char *name, unsigned int size, uint32_t flags)
 {
 	const unsigned int min_bufsize = rte_reorder_memory_footprint_get(size);
 	static const struct rte_mbuf_dynfield reorder_seqn_dynfield_desc = {
@@ -94,6 +108,11 @@ rte_reorder_init(struct rte_reorder_buffer *b, unsigned int bufsize,
 		rte_errno = EINVAL;
 		return NULL;
 	}
+	if ((flags & ~RTE_REORDER_F_CONCURRENT) != 0) {
+		REORDER_LOG(ERR, "Invalid reorder buffer flags: %#x", flags);
+		rte_errno = EINVAL;
+		return NULL;
+	}
 	if (bufsize < min_bufsize) {
 		REORDER_LOG(ERR, "Invalid reorder buffer memory size: %u, "
 			"minimum required: %u", bufsize, min_bufsize);
@@ -118,10 +137,25 @@ rte_reorder_init(struct rte_reorder_buffer *b, unsigned int bufsize,
 	b->ready_buf.entries = (void *)&b[1];
 	b->order_buf.entries = RTE_PTR_ADD(&b[1],
 			size * sizeof(b->ready_buf.entries[0]));
+	b->flags = flags;
+
+	if (flags & RTE_REORDER_F_CONCURRENT) {
+		/* the first insertion cannot set the window concurrently */
+		b->is_initialized = true;
+		b->slots = (void *)b->order_buf.entries;
+		rte_spinlock_init(&b->drain_lock);
+	}
 
 	return b;
 }
 
+struct rte_reorder_buffer *
+rte_reorder_init(struct rte_reorder_buffer *b, unsigned int bufsize,
+		const char *name, unsigned int size)
+{
+	return reorder_init(b, bufsize, name, size, 0);
+}
+
 /*
  * Insert new entry into global list.
  * Returns pointer to already inserted entry if such exists, or to newly inserted one.
@@ -154,8 +188,9 @@ rte_reorder_entry_insert(struct rte_tailq_entry *new_te)
 	return te;
 }
 
-struct rte_reorder_buffer*
-rte_reorder_create(const char *name, unsigned socket_id, unsigned int size)
+static struct rte_reorder_buffer *
+reorder_create(const char *name, unsigned int socket_id, unsigned int size,
+		uint32_t flags)
 {
 	struct rte_reorder_buffer *b = NULL;
 	struct rte_tailq_entry *te, *te_inserted;
@@ -192,7 +227,7 @@ rte_reorder_create(const char *name, unsigned socket_id, unsigned int size)
 		rte_free(te);
 		return NULL;
 	} else {
-		if (rte_reorder_init(b, bufsize, name, size) == NULL) {
+		if (reorder_init(b, bufsize, name, size, flags) == NULL) {
 			rte_free(b);
 			rte_free(te);
 			return NULL;
@@ -210,6 +245,19 @@ rte_reorder_create(const char *name, unsigned socket_id, unsigned int size)
 	return b;
 }
 
+struct rte_reorder_buffer*
+rte_reorder_create(const char *name, unsigned socket_id, unsigned int size)
+{
+	return reorder_create(name, socket_id, size, 0);
+}
+
+struct rte_reorder_buffer *
+rte_reorder_create_ext(const char *name, unsigned int socket_id,
+		unsigned int size, uint32_t flags)
+{
+	return reorder_create(name, socket_id, size, flags);
+}
+
 void
 rte_reorder_reset(struct rte_reorder_buffer *b)
 {
@@ -218,7 +266,7 @@ rte_reorder_reset(struct rte_reorder_buffer *b)
 	rte_reorder_free_mbufs(b);
 	strlcpy(name, b->name, sizeof(name));
 	/* No error checking as current values should be valid */
-	rte_reorder_init(b, b->memsize, name, b->order_buf.size);
+	reorder_init(b, b->memsize, name, b->order_buf.size, b->flags);
 }
 
 static void
@@ -348,6 +396,96 @@ rte_reorder_fill_overflow(struct rte_reorder_buffer *b, unsigned n)
 	return order_head_adv;
 }
 
+/*
+ * Concurrent mode.
+ * Inserters claim the entry of an mbuf, given by its sequence number,
+ * with a compare and swap, so they never wait for each other.
+ * Drains are serialized by a lock: the drainer takes the entries from
+ * the head of the window, then moves the head forward.
+ * An mbuf too early to fit in the window is not inserted, as it may only
+ * be early because another lcore has not inserted its mbufs yet: missing
+ * entries are only skipped by rte_reorder_drain_up_to_seqn().
+ * An mbuf inserted while its entry was being skipped is returned by the
+ * next drain, as a late mbuf.
+ */
+
+static inline int
+reorder_mt_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf,
+		uint32_t head)
+{
+	struct rte_mbuf *expected = NULL;
+	uint32_t seqn, offset;
+
+	seqn = *rte_reorder_seqn(mbuf);
+	offset = seqn - head;
+
+	if (offset >= b->order_buf.size) {
+		/* can be inserted once the window moves */
+		if (offset < 2 * b->order_buf.size)
+			rte_errno = ENOSPC;
+		else
+			rte_errno = ERANGE;
+		return -1;
+	}
+
+	/* the entry is still used by a late mbuf, or by a duplicate */
+	if (!rte_atomic_compare_exchange_strong_explicit(
+			&b->slots[seqn & b->order_buf.mask], &expected, mbuf,
+			rte_memory_order_release, rte_memory_order_relaxed)) {
+		rte_errno = ENOSPC;
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * Drain a concurrent reorder buffer. If bounded, skip the missing entries
+ * up to seqn (exclusive), and stop there.
+ * Returns 0 if another lcore is draining.
+ */
+static unsigned int
+reorder_mt_drain(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
+		unsigned int max_mbufs, bool bounded, rte_reorder_seqn_t seqn)
+{
+	unsigned int drain_cnt = 0;
+	struct rte_mbuf *m;
+	uint32_t head;
+
+	if (!rte_spinlock_trylock(&b->drain_lock))
+		return 0;
+
+	/* the head is only written by the drainer */
+	head = rte_atomic_load_explicit(&b->head_seqn,
+			rte_memory_order_relaxed);
+
+	while (drain_cnt < max_mbufs &&
+			(!bounded || (int32_t)(seqn - head) > 0)) {
+		m = rte_atomic_load_explicit(&b->slots[head & b->order_buf.mask],
+				rte_memory_order_acquire);
+		if (m != NULL) {
+			rte_atomic_store_explicit(
+				&b->slots[head & b->order_buf.mask], NULL,
+				rte_memory_order_relaxed);
+			mbufs[drain_cnt++] = m;
+			/* a late mbuf does not fill the entry of the head */
+			if (*rte_reorder_seqn(m) == head)
+				head++;
+		} else if (bounded)
+			head++;
+		else
+			break;
+	}
+
+	/* entries are empty before inserters can see the new head */
+	rte_atomic_store_explicit(&b->head_seqn, head,
+			rte_memory_order_release);
+
+	rte_spinlock_unlock(&b->drain_lock);
+
+	return drain_cnt;
+}
+
 int
 rte_reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
 {
@@ -359,6 +497,11 @@ rte_reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
 		return -1;
 	}
 
+	if (b->flags & RTE_REORDER_F_CONCURRENT)
+		return reorder_mt_insert(b, mbuf,
+				rte_atomic_load_explicit(&b->head_seqn,
+					rte_memory_order_acquire));
+
 	order_buf = &b->order_buf;
 	if (!b->is_initialized) {
 		b->min_seqn = *rte_reorder_seqn(mbuf);
@@ -414,6 +557,48 @@ rte_reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
 	return 0;
 }
 
+unsigned int
+rte_reorder_insert_burst(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
+		unsigned int nb_mbufs)
+{
+	unsigned int i;
+	uint32_t head;
+
+	if (b == NULL || mbufs == NULL) {
+		rte_errno = EINVAL;
+		return 0;
+	}
+
+	if (!(b->flags & RTE_REORDER_F_CONCURRENT)) {
+		for (i = 0; i != nb_mbufs; i++) {
+			if (rte_reorder_insert(b, mbufs[i]) != 0)
+				break;
+		}
+		return i;
+	}
+
+	head = rte_atomic_load_explicit(&b->head_seqn,
+			rte_memory_order_acquire);
+	for (i = 0; i != nb_mbufs; i++) {
+		if (mbufs[i] == NULL) {
+			rte_errno = EINVAL;
+			break;
+		}
+		if (reorder_mt_insert(b, mbufs[i], head) == 0)
+			continue;
+		if (rte_errno != ENOSPC)
+			break;
+
+		/* the window may have moved since the start of the burst */
+		head = rte_atomic_load_explicit(&b->head_seqn,
+				rte_memory_order_acquire);
+		if (reorder_mt_insert(b, mbufs[i], head) != 0)
+			break;
+	}
+
+	return i;
+}
+
 unsigned int
 rte_reorder_drain(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
 		unsigned max_mbufs)
@@ -423,6 +608,9 @@ rte_reorder_drain(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
 	struct cir_buffer *order_buf = &b->order_buf,
 			*ready_buf = &b->ready_buf;
 
+	if (b->flags & RTE_REORDER_F_CONCURRENT)
+		return reorder_mt_drain(b, mbufs, max_mbufs, false, 0);
+
 	/* Try to fetch requested number of mbufs from ready buffer */
 	while ((drain_cnt < max_mbufs) && (ready_buf->tail != ready_buf->head)) {
 		mbufs[drain_cnt++] = ready_buf->entries[ready_buf->tail];
@@ -482,6 +670,9 @@ rte_reorder_drain_up_to_seqn(struct rte_reorder_buffer *b, struct rte_mbuf **mbu
 	struct cir_buffer *order_buf = &b->order_buf,
 			*ready_buf = &b->ready_buf;
 
+	if (b->flags & RTE_REORDER_F_CONCURRENT)
+		return reorder_mt_drain(b, mbufs, max_mbufs, true, seqn);
+
 	/* Seqn in Ready buffer */
 	if (seqn < b->min_seqn) {
 		/* All sequence numbers are higher then given */
@@ -550,6 +741,8 @@ rte_reorder_min_seqn_set(struct rte_reorder_buffer *b, rte_reorder_seqn_t min_se
 
 	b->min_seqn = min_seqn;
 	b->is_initialized = true;
+	rte_atomic_store_explicit(&b->head_seqn, min_seqn,
+			rte_memory_order_relaxed);
 
 	return 0;
 }
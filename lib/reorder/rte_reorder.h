@@ -14,6 +14,7 @@
  * sequence number present in mbuf.
  */
 
+#include <rte_bitops.h>
 #include <rte_compat.h>
 #include <rte_mbuf.h>
 #include <rte_mbuf_dyn.h>
@@ -27,6 +28,14 @@ struct rte_reorder_buffer;
 typedef uint32_t rte_reorder_seqn_t;
 extern int rte_reorder_seqn_dynfield_offset;
 
+/**
+ * The reorder buffer can be used concurrently by several lcores:
+ * mbufs can be inserted by several lcores at once without locking,
+ * and drains are serialized, so several lcores can drain.
+ * @see rte_reorder_create_ext()
+ */
+#define RTE_REORDER_F_CONCURRENT RTE_BIT32(0)
+
 /**
  * @warning
  * @b EXPERIMENTAL: this API may change without prior notice
@@ -66,6 +75,44 @@ rte_reorder_seqn(struct rte_mbuf *mbuf)
 struct rte_reorder_buffer *
 rte_reorder_create(const char *name, unsigned socket_id, unsigned int size);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Create a new reorder buffer instance with flags.
+ *
+ * With RTE_REORDER_F_CONCURRENT, rte_reorder_insert() and
+ * rte_reorder_insert_burst() can be called by several lcores at once,
+ * and rte_reorder_drain() and rte_reorder_drain_up_to_seqn() can be
+ * called concurrently with the insertions. A drain returns 0 if another
+ * lcore is already draining the buffer.
+ * The sequence window starts at 0, or at the value set with
+ * rte_reorder_min_seqn_set(), instead of the sequence number of the
+ * first inserted mbuf. An mbuf too early to fit in the window is not
+ * inserted, and can be inserted again once the window has moved.
+ * The window only moves past missing mbufs when draining with
+ * rte_reorder_drain_up_to_seqn(). The other functions are not thread safe.
+ *
+ * @param name
+ *   The name to be given to the reorder buffer instance.
+ * @param socket_id
+ *   The NUMA node on which the memory for the reorder buffer
+ *   instance is to be reserved.
+ * @param size
+ *   Max number of elements that can be stored in the reorder buffer
+ * @param flags
+ *   RTE_REORDER_F_* flags.
+ * @return
+ *   The initialized reorder buffer instance, or NULL on error
+ *   On error case, rte_errno will be set appropriately:
+ *    - ENOMEM - no appropriate memory area found in which to create memzone
+ *    - EINVAL - invalid parameters
+ */
+__rte_experimental
+struct rte_reorder_buffer *
+rte_reorder_create_ext(const char *name, unsigned int socket_id,
+		unsigned int size, uint32_t flags);
+
 /**
  * Initializes given reorder buffer instance
  *
@@ -142,10 +189,37 @@ rte_reorder_free(struct rte_reorder_buffer *b);
  *      early mbuf, but it can be accommodated by performing drain and then insert.
  *    - ERANGE - Too early or late mbuf which is vastly out of range of expected
  *      window should be ignored without any handling.
+ *   With RTE_REORDER_F_CONCURRENT, ENOSPC is returned for any early mbuf
+ *   within twice the buffer size, and if the entry of the mbuf is still
+ *   in use by a late mbuf or by an mbuf with the same sequence number.
  */
 int
 rte_reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Insert a burst of mbufs in reorder buffer in their correct positions.
+ *
+ * The mbufs are inserted in order, up to the first mbuf which cannot be
+ * inserted. The mbufs which are not inserted are left to the caller.
+ *
+ * @param b
+ *   Reorder buffer where the mbufs have to be inserted.
+ * @param mbufs
+ *   Array of mbufs to insert.
+ * @param nb_mbufs
+ *   Number of mbufs in the array.
+ * @return
+ *   Number of mbufs inserted. If lower than nb_mbufs, rte_errno is set
+ *   as by rte_reorder_insert() for the first mbuf not inserted.
+ */
+__rte_experimental
+unsigned int
+rte_reorder_insert_burst(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
+		unsigned int nb_mbufs);
+
 /**
  * Fetch reordered buffers
  *
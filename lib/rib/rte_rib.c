@@ -31,6 +31,13 @@ EAL_REGISTER_TAILQ(rte_rib_tailq)
 #define RIB_MAXDEPTH		32
 /* Maximum length of a RIB name. */
 #define RTE_RIB_NAMESIZE	64
+/* Bounds of the number of address bits indexing the subtree roots table. */
+#define RIB_TBL_MIN_BITS	4
+#define RIB_TBL_MAX_BITS	16
+/* Number of nodes per subtree roots table entry. */
+#define RIB_TBL_NODES_LOG2	3
+/* Batched insertions rewriting more entries rebuild the table at the end. */
+#define RIB_TBL_BULK_LOG2	8
 
 struct rte_rib_node {
 	struct rte_rib_node	*left;
@@ -50,6 +57,13 @@ struct rte_rib {
 	uint32_t		cur_nodes;
 	uint32_t		cur_routes;
 	uint32_t		max_nodes;
+	/*
+	 * Deepest node no longer than tbl_bits covering every
+	 * tbl_bits long prefix, NULL if there is none.
+	 * Lookups start from there instead of the root.
+	 */
+	struct rte_rib_node	**tbl;
+	uint8_t			tbl_bits;
 };
 
 static inline bool
@@ -81,6 +95,76 @@ get_nxt_node(struct rte_rib_node *node, uint32_t ip)
 	return (ip & (1 << (31 - node->depth))) ? node->right : node->left;
 }
 
+/*
+ * Node to start a search for ip from, the searches for prefixes
+ * shorter than tbl_bits must start from the root.
+ */
+static inline struct rte_rib_node *
+get_start_node(const struct rte_rib *rib, uint32_t ip)
+{
+	struct rte_rib_node *ent;
+
+	if (rib->tbl == NULL)
+		return rib->tree;
+	ent = rib->tbl[ip >> (32 - rib->tbl_bits)];
+	return (ent != NULL) ? ent : rib->tree;
+}
+
+static void
+tbl_set_range(struct rte_rib *rib, uint32_t ip, uint8_t depth,
+	struct rte_rib_node *ent)
+{
+	uint32_t i, first, num;
+
+	first = ip >> (32 - rib->tbl_bits);
+	num = 1U << (rib->tbl_bits - depth);
+	for (i = 0; i < num; i++)
+		rib->tbl[first + i] = ent;
+}
+
+/* Point the entries covered by ent and its short enough descendants to them */
+static void
+tbl_fill(struct rte_rib *rib, struct rte_rib_node *ent)
+{
+	tbl_set_range(rib, ent->ip, ent->depth, ent);
+	if (ent->left != NULL && ent->left->depth <= rib->tbl_bits)
+		tbl_fill(rib, ent->left);
+	if (ent->right != NULL && ent->right->depth <= rib->tbl_bits)
+		tbl_fill(rib, ent->right);
+}
+
+/*
+ * Refresh the subtree roots table entries covered by ip/depth
+ * after the nodes inside this prefix were added or freed.
+ */
+static void
+tbl_update(struct rte_rib *rib, uint32_t ip, uint8_t depth)
+{
+	struct rte_rib_node *cur, *top = NULL;
+
+	if (rib->tbl == NULL)
+		return;
+
+	depth = RTE_MIN(depth, rib->tbl_bits);
+	ip &= rte_rib_depth_to_mask(depth);
+
+	cur = rib->tree;
+	while (cur != NULL && cur->depth <= depth &&
+			is_covered(ip, cur->ip, cur->depth)) {
+		if (cur->depth == depth) {
+			tbl_fill(rib, cur);
+			return;
+		}
+		top = cur;
+		cur = get_nxt_node(cur, ip);
+	}
+	tbl_set_range(rib, ip, depth, top);
+	/* the only node inside ip/depth without an ancestor inside it */
+	if (cur != NULL && cur->depth <= rib->tbl_bits &&
+			is_covered(cur->ip, ip, depth))
+		tbl_fill(rib, cur);
+}
+
 static struct rte_rib_node *
 node_alloc(struct rte_rib *rib)
 {
@@ -104,19 +188,23 @@ node_free(struct rte_rib *rib, struct rte_rib_node *ent)
 struct rte_rib_node *
 rte_rib_lookup(struct rte_rib *rib, uint32_t ip)
 {
-	struct rte_rib_node *cur, *prev = NULL;
+	struct rte_rib_node *cur, *start, *prev = NULL;
 
 	if (unlikely(rib == NULL)) {
 		rte_errno = EINVAL;
 		return NULL;
 	}
 
-	cur = rib->tree;
+	start = get_start_node(rib, ip);
+	cur = start;
 	while ((cur != NULL) && is_covered(ip, cur->ip, cur->depth)) {
 		if (is_valid_node(cur))
 			prev = cur;
 		cur = get_nxt_node(cur, ip);
 	}
+	/* the best route may be above the start node */
+	if (prev == NULL && start != rib->tree)
+		prev = rte_rib_lookup_parent(start);
 	return prev;
 }
 
@@ -138,7 +226,7 @@ __rib_lookup_exact(struct rte_rib *rib, uint32_t ip, uint8_t depth)
 {
 	struct rte_rib_node *cur;
 
-	cur = rib->tree;
+	cur = (depth >= rib->tbl_bits) ? get_start_node(rib, ip) : rib->tree;
 	while (cur != NULL) {
 		if ((cur->ip == ip) && (cur->depth == depth) &&
 				is_valid_node(cur))
@@ -180,7 +268,8 @@ rte_rib_get_nxt(struct rte_rib *rib, uint32_t ip,
 	}
 
 	if (last == NULL) {
-		tmp = rib->tree;
+		tmp = (depth >= rib->tbl_bits) ? get_start_node(rib, ip) :
+			rib->tree;
 		while ((tmp) && (tmp->depth < depth))
 			tmp = get_nxt_node(tmp, ip);
 	} else {
@@ -219,16 +308,21 @@ rte_rib_remove(struct rte_rib *rib, uint32_t ip, uint8_t depth)
 
 	--rib->cur_routes;
 	cur->flag &= ~RTE_RIB_VALID_NODE;
+	ip = cur->ip;
+	depth = cur->depth;
 	while (!is_valid_node(cur)) {
 		if ((cur->left != NULL) && (cur->right != NULL))
-			return;
+			break;
 		child = (cur->left == NULL) ? cur->right : cur->left;
 		if (child != NULL)
 			child->parent = cur->parent;
+		/* the outermost freed node */
+		ip = cur->ip;
+		depth = cur->depth;
 		if (cur->parent == NULL) {
 			rib->tree = child;
 			node_free(rib, cur);
-			return;
+			break;
 		}
 		if (cur->parent->left == cur)
 			cur->parent->left = child;
@@ -238,10 +332,18 @@ rte_rib_remove(struct rte_rib *rib, uint32_t ip, uint8_t depth)
 		cur = cur->parent;
 		node_free(rib, prev);
 	}
+	/* longer nodes are not in the subtree roots table */
+	if (depth <= rib->tbl_bits)
+		tbl_update(rib, ip, depth);
 }
 
-struct rte_rib_node *
-rte_rib_insert(struct rte_rib *rib, uint32_t ip, uint8_t depth)
+/*
+ * Insert ip/depth, top is set to the outermost node added to the tree,
+ * or NULL if the tree is unchanged.
+ */
+static struct rte_rib_node *
+__rib_insert(struct rte_rib *rib, uint32_t ip, uint8_t depth,
+	struct rte_rib_node **top)
 {
 	struct rte_rib_node **tmp;
 	struct rte_rib_node *prev = NULL;
@@ -251,11 +353,7 @@ rte_rib_insert(struct rte_rib *rib, uint32_t ip, uint8_t depth)
 	uint32_t common_prefix;
 	uint8_t common_depth;
 
-	if (unlikely(rib == NULL || depth > RIB_MAXDEPTH)) {
-		rte_errno = EINVAL;
-		return NULL;
-	}
-
+	*top = NULL;
 	tmp = &rib->tree;
 	ip &= rte_rib_depth_to_mask(depth);
 	new_node = __rib_lookup_exact(rib, ip, depth);
@@ -276,6 +374,16 @@ rte_rib_insert(struct rte_rib *rib, uint32_t ip, uint8_t depth)
 	new_node->depth = depth;
 	new_node->flag = RTE_RIB_VALID_NODE;
 
+	/* skip the levels above the subtree roots table entry */
+	if (depth > rib->tbl_bits) {
+		prev = get_start_node(rib, ip);
+		if (prev != NULL && prev != rib->tree)
+			tmp = (ip & (1 << (31 - prev->depth))) ?
+				&prev->right : &prev->left;
+		else
+			prev = NULL;
+	}
+
 	/* traverse down the tree to find matching node or closest matching */
 	while (1) {
 		/* insert as the last node in the branch */
@@ -283,6 +391,7 @@ rte_rib_insert(struct rte_rib *rib, uint32_t ip, uint8_t depth)
 			*tmp = new_node;
 			new_node->parent = prev;
 			++rib->cur_routes;
+			*top = new_node;
 			return *tmp;
 		}
 		/*
@@ -343,9 +452,68 @@ rte_rib_insert(struct rte_rib *rib, uint32_t ip, uint8_t depth)
 		*tmp = common_node;
 	}
 	++rib->cur_routes;
+	*top = *tmp;
 	return new_node;
 }
 
+struct rte_rib_node *
+rte_rib_insert(struct rte_rib *rib, uint32_t ip, uint8_t depth)
+{
+	struct rte_rib_node *node, *top;
+
+	if (unlikely(rib == NULL || depth > RIB_MAXDEPTH)) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	node = __rib_insert(rib, ip, depth, &top);
+	/* longer nodes are not in the subtree roots table */
+	if (top != NULL && top->depth <= rib->tbl_bits)
+		tbl_update(rib, top->ip, top->depth);
+	return node;
+}
+
+unsigned int
+rte_rib_insert_bulk(struct rte_rib *rib, const uint32_t *ips,
+	const uint8_t *depths, struct rte_rib_node **nodes, unsigned int n)
+{
+	struct rte_rib_node *node, *top;
+	bool rebuild = false;
+	unsigned int i;
+
+	if (unlikely(rib == NULL || ips == NULL || depths == NULL)) {
+		rte_errno = EINVAL;
+		return 0;
+	}
+
+	/*
+	 * Insertions leave the subtree roots table usable, as long as
+	 * no node is freed, so the updates of the short prefixes,
+	 * covering many entries, are replaced by a single rebuild.
+	 */
+	for (i = 0; i < n; i++) {
+		if (unlikely(depths[i] > RIB_MAXDEPTH)) {
+			rte_errno = EINVAL;
+			break;
+		}
+		node = __rib_insert(rib, ips[i], depths[i], &top);
+		if (node == NULL)
+			break;
+		if (top != NULL && top->depth <= rib->tbl_bits) {
+			if (rib->tbl_bits - top->depth > RIB_TBL_BULK_LOG2)
+				rebuild = true;
+			else
+				tbl_update(rib, top->ip, top->depth);
+		}
+		if (nodes != NULL)
+			nodes[i] = node;
+	}
+	if (rebuild)
+		tbl_update(rib, 0, 0);
+
+	return i;
+}
+
 int
 rte_rib_get_ip(const struct rte_rib_node *node, uint32_t *ip)
 {
@@ -404,6 +572,8 @@ rte_rib_create(const char *name, int socket_id, const struct rte_rib_conf *conf)
 	struct rte_tailq_entry *te;
 	struct rte_rib_list *rib_list;
 	struct rte_mempool *node_pool;
+	struct rte_rib_node **tbl = NULL;
+	int tbl_bits;
 
 	/* Check user arguments. */
 	if (unlikely(name == NULL || conf == NULL || conf->max_nodes <= 0)) {
@@ -411,6 +581,23 @@ rte_rib_create(const char *name, int socket_id, const struct rte_rib_conf *conf)
 		return NULL;
 	}
 
+	/* one subtree roots table entry for a few nodes */
+	tbl_bits = rte_bsf32(rte_align32prevpow2(conf->max_nodes)) -
+		RIB_TBL_NODES_LOG2;
+	tbl_bits = RTE_MIN(tbl_bits, RIB_TBL_MAX_BITS);
+	if (tbl_bits >= RIB_TBL_MIN_BITS) {
+		tbl = rte_zmalloc_socket("RIB_TBL", sizeof(*tbl) << tbl_bits,
+			RTE_CACHE_LINE_SIZE, socket_id);
+		if (tbl == NULL) {
+			RIB_LOG(ERR,
+				"Can not allocate subtree roots table for RIB %s",
+				name);
+			rte_errno = ENOMEM;
+			return NULL;
+		}
+	} else
+		tbl_bits = 0;
+
 	snprintf(mem_name, sizeof(mem_name), "MP_%s", name);
 	node_pool = rte_mempool_create(mem_name, conf->max_nodes,
 		sizeof(struct rte_rib_node) + conf->ext_sz, 0, 0,
@@ -419,6 +606,7 @@ rte_rib_create(const char *name, int socket_id, const struct rte_rib_conf *conf)
 	if (node_pool == NULL) {
 		RIB_LOG(ERR,
 			"Can not allocate mempool for RIB %s", name);
+		rte_free(tbl);
 		return NULL;
 	}
 
@@ -461,6 +649,8 @@ rte_rib_create(const char *name, int socket_id, const struct rte_rib_conf *conf)
 	rib->tree = NULL;
 	rib->max_nodes = conf->max_nodes;
 	rib->node_pool = node_pool;
+	rib->tbl = tbl;
+	rib->tbl_bits = tbl_bits;
 	te->data = (void *)rib;
 	TAILQ_INSERT_TAIL(rib_list, te, next);
 
@@ -473,6 +663,7 @@ rte_rib_create(const char *name, int socket_id, const struct rte_rib_conf *conf)
 exit:
 	rte_mcfg_tailq_write_unlock();
 	rte_mempool_free(node_pool);
+	rte_free(tbl);
 
 	return NULL;
 }
@@ -526,6 +717,11 @@ rte_rib_free(struct rte_rib *rib)
 
 	rte_mcfg_tailq_write_unlock();
 
+	/* no need to maintain the subtree roots table while freeing */
+	rte_free(rib->tbl);
+	rib->tbl = NULL;
+	rib->tbl_bits = 0;
+
 	while ((tmp = rte_rib_get_nxt(rib, 0, 0, tmp,
 			RTE_RIB_GET_NXT_ALL)) != NULL)
 		rte_rib_remove(rib, tmp->ip, tmp->depth);
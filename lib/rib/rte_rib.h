@@ -17,6 +17,7 @@
 #include <stdlib.h>
 #include <stdint.h>
 
+#include <rte_compat.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -161,6 +162,36 @@ rte_rib_remove(struct rte_rib *rib, uint32_t ip, uint8_t depth);
 struct rte_rib_node *
 rte_rib_insert(struct rte_rib *rib, uint32_t ip, uint8_t depth);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Insert a batch of prefixes into the RIB
+ *
+ * Faster than calling rte_rib_insert() for every prefix,
+ * the search structures are updated once for the whole batch.
+ * The prefixes are inserted in order, the batch stops at the first
+ * prefix failing to be inserted.
+ *
+ * @param rib
+ *  RIB object handle
+ * @param ips
+ *  nets to be inserted to the RIB
+ * @param depths
+ *  prefix lengths
+ * @param nodes
+ *  array to save the inserted nodes to, may be NULL
+ * @param n
+ *  number of prefixes
+ * @return
+ *  number of prefixes inserted,
+ *  lower than n on failure with rte_errno indicating reason for failure
+ */
+__rte_experimental
+unsigned int
+rte_rib_insert_bulk(struct rte_rib *rib, const uint32_t *ips,
+	const uint8_t *depths, struct rte_rib_node **nodes, unsigned int n);
+
 /**
  * Get an ip from rte_rib_node
  *
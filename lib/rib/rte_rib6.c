@@ -22,6 +22,13 @@
 #define RTE_RIB_VALID_NODE	1
 /* Maximum length of a RIB6 name. */
 #define RTE_RIB6_NAMESIZE	64
+/* Bounds of the number of address bits indexing the subtree roots table. */
+#define RIB6_TBL_MIN_BITS	4
+#define RIB6_TBL_MAX_BITS	16
+/* Number of nodes per subtree roots table entry. */
+#define RIB6_TBL_NODES_LOG2	3
+/* Batched insertions rewriting more entries rebuild the table at the end. */
+#define RIB6_TBL_BULK_LOG2	8
 
 TAILQ_HEAD(rte_rib6_list, rte_tailq_entry);
 static struct rte_tailq_elem rte_rib6_tailq = {
@@ -47,6 +54,13 @@ struct rte_rib6 {
 	uint32_t		cur_nodes;
 	uint32_t		cur_routes;
 	int			max_nodes;
+	/*
+	 * Deepest node no longer than tbl_bits covering every
+	 * tbl_bits long prefix, NULL if there is none.
+	 * Lookups start from there instead of the root.
+	 */
+	struct rte_rib6_node	**tbl;
+	uint8_t			tbl_bits;
 };
 
 static inline bool
@@ -94,6 +108,85 @@ get_nxt_node(struct rte_rib6_node *node,
 	return (get_dir(ip, node->depth)) ? node->right : node->left;
 }
 
+static inline uint32_t
+get_tbl_idx(const struct rte_rib6 *rib, const struct rte_ipv6_addr *ip)
+{
+	return ((uint32_t)ip->a[0] << 8 | ip->a[1]) >> (16 - rib->tbl_bits);
+}
+
+/*
+ * Node to start a search for ip from, the searches for prefixes
+ * shorter than tbl_bits must start from the root.
+ */
+static inline struct rte_rib6_node *
+get_start_node(const struct rte_rib6 *rib, const struct rte_ipv6_addr *ip)
+{
+	struct rte_rib6_node *ent;
+
+	if (rib->tbl == NULL)
+		return rib->tree;
+	ent = rib->tbl[get_tbl_idx(rib, ip)];
+	return (ent != NULL) ? ent : rib->tree;
+}
+
+static void
+tbl_set_range(struct rte_rib6 *rib, const struct rte_ipv6_addr *ip,
+	uint8_t depth, struct rte_rib6_node *ent)
+{
+	uint32_t i, first, num;
+
+	first = get_tbl_idx(rib, ip);
+	num = 1U << (rib->tbl_bits - depth);
+	for (i = 0; i < num; i++)
+		rib->tbl[first + i] = ent;
+}
+
+/* Point the entries covered by ent and its short enough descendants to them */
+static void
+tbl_fill(struct rte_rib6 *rib, struct rte_rib6_node *ent)
+{
+	tbl_set_range(rib, &ent->ip, ent->depth, ent);
+	if (ent->left != NULL && ent->left->depth <= rib->tbl_bits)
+		tbl_fill(rib, ent->left);
+	if (ent->right != NULL && ent->right->depth <= rib->tbl_bits)
+		tbl_fill(rib, ent->right);
+}
+
+/*
+ * Refresh the subtree roots table entries covered by ip/depth
+ * after the nodes inside this prefix were added or freed.
+ */
+static void
+tbl_update(struct rte_rib6 *rib, const struct rte_ipv6_addr *ip,
+	uint8_t depth)
+{
+	struct rte_rib6_node *cur, *top = NULL;
+	struct rte_ipv6_addr tmp_ip;
+
+	if (rib->tbl == NULL)
+		return;
+
+	depth = RTE_MIN(depth, rib->tbl_bits);
+	tmp_ip = *ip;
+	rte_ipv6_addr_mask(&tmp_ip, depth);
+
+	cur = rib->tree;
+	while (cur != NULL && cur->depth <= depth &&
+			rte_ipv6_addr_eq_prefix(&tmp_ip, &cur->ip, cur->depth)) {
+		if (cur->depth == depth) {
+			tbl_fill(rib, cur);
+			return;
+		}
+		top = cur;
+		cur = get_nxt_node(cur, &tmp_ip);
+	}
+	tbl_set_range(rib, &tmp_ip, depth, top);
+	/* the only node inside ip/depth without an ancestor inside it */
+	if (cur != NULL && cur->depth <= rib->tbl_bits &&
+			rte_ipv6_addr_eq_prefix(&cur->ip, &tmp_ip, depth))
+		tbl_fill(rib, cur);
+}
+
 static struct rte_rib6_node *
 node_alloc(struct rte_rib6 *rib)
 {
@@ -118,20 +211,24 @@ struct rte_rib6_node *
 rte_rib6_lookup(struct rte_rib6 *rib,
 	const struct rte_ipv6_addr *ip)
 {
-	struct rte_rib6_node *cur;
+	struct rte_rib6_node *cur, *start;
 	struct rte_rib6_node *prev = NULL;
 
 	if (unlikely(rib == NULL)) {
 		rte_errno = EINVAL;
 		return NULL;
 	}
-	cur = rib->tree;
+	start = get_start_node(rib, ip);
+	cur = start;
 
 	while ((cur != NULL) && rte_ipv6_addr_eq_prefix(ip, &cur->ip, cur->depth)) {
 		if (is_valid_node(cur))
 			prev = cur;
 		cur = get_nxt_node(cur, ip);
 	}
+	/* the best route may be above the start node */
+	if (prev == NULL && start != rib->tree)
+		prev = rte_rib6_lookup_parent(start);
 	return prev;
 }
 
@@ -161,10 +258,11 @@ rte_rib6_lookup_exact(struct rte_rib6 *rib,
 		rte_errno = EINVAL;
 		return NULL;
 	}
-	cur = rib->tree;
 
 	tmp_ip = *ip;
 	rte_ipv6_addr_mask(&tmp_ip, depth);
+	cur = (depth >= rib->tbl_bits) ? get_start_node(rib, &tmp_ip) :
+		rib->tree;
 
 	while (cur != NULL) {
 		if (rte_ipv6_addr_eq(&cur->ip, &tmp_ip) &&
@@ -204,7 +302,8 @@ rte_rib6_get_nxt(struct rte_rib6 *rib,
 	rte_ipv6_addr_mask(&tmp_ip, depth);
 
 	if (last == NULL) {
-		tmp = rib->tree;
+		tmp = (depth >= rib->tbl_bits) ? get_start_node(rib, &tmp_ip) :
+			rib->tree;
 		while ((tmp) && (tmp->depth < depth))
 			tmp = get_nxt_node(tmp, &tmp_ip);
 	} else {
@@ -237,6 +336,8 @@ rte_rib6_remove(struct rte_rib6 *rib,
 	const struct rte_ipv6_addr *ip, uint8_t depth)
 {
 	struct rte_rib6_node *cur, *prev, *child;
+	struct rte_ipv6_addr upd_ip;
+	uint8_t upd_depth;
 
 	cur = rte_rib6_lookup_exact(rib, ip, depth);
 	if (cur == NULL)
@@ -244,16 +345,21 @@ rte_rib6_remove(struct rte_rib6 *rib,
 
 	--rib->cur_routes;
 	cur->flag &= ~RTE_RIB_VALID_NODE;
+	upd_ip = cur->ip;
+	upd_depth = cur->depth;
 	while (!is_valid_node(cur)) {
 		if ((cur->left != NULL) && (cur->right != NULL))
-			return;
+			break;
 		child = (cur->left == NULL) ? cur->right : cur->left;
 		if (child != NULL)
 			child->parent = cur->parent;
+		/* the outermost freed node */
+		upd_ip = cur->ip;
+		upd_depth = cur->depth;
 		if (cur->parent == NULL) {
 			rib->tree = child;
 			node_free(rib, cur);
-			return;
+			break;
 		}
 		if (cur->parent->left == cur)
 			cur->parent->left = child;
@@ -263,11 +369,19 @@ rte_rib6_remove(struct rte_rib6 *rib,
 		cur = cur->parent;
 		node_free(rib, prev);
 	}
+	/* longer nodes are not in the subtree roots table */
+	if (upd_depth <= rib->tbl_bits)
+		tbl_update(rib, &upd_ip, upd_depth);
 }
 
-struct rte_rib6_node *
-rte_rib6_insert(struct rte_rib6 *rib,
-	const struct rte_ipv6_addr *ip, uint8_t depth)
+/*
+ * Insert ip/depth, top is set to the outermost node added to the tree,
+ * or NULL if the tree is unchanged.
+ */
+static struct rte_rib6_node *
+__rib6_insert(struct rte_rib6 *rib,
+	const struct rte_ipv6_addr *ip, uint8_t depth,
+	struct rte_rib6_node **top)
 {
 	struct rte_rib6_node **tmp;
 	struct rte_rib6_node *prev = NULL;
@@ -278,11 +392,7 @@ rte_rib6_insert(struct rte_rib6 *rib,
 	int i, d;
 	uint8_t common_depth, ip_xor;
 
-	if (unlikely((rib == NULL || ip == NULL || depth > RTE_IPV6_MAX_DEPTH))) {
-		rte_errno = EINVAL;
-		return NULL;
-	}
-
+	*top = NULL;
 	tmp = &rib->tree;
 
 	tmp_ip = *ip;
@@ -306,6 +416,16 @@ rte_rib6_insert(struct rte_rib6 *rib,
 	new_node->depth = depth;
 	new_node->flag = RTE_RIB_VALID_NODE;
 
+	/* skip the levels above the subtree roots table entry */
+	if (depth > rib->tbl_bits) {
+		prev = get_start_node(rib, &tmp_ip);
+		if (prev != NULL && prev != rib->tree)
+			tmp = (get_dir(&tmp_ip, prev->depth)) ?
+				&prev->right : &prev->left;
+		else
+			prev = NULL;
+	}
+
 	/* traverse down the tree to find matching node or closest matching */
 	while (1) {
 		/* insert as the last node in the branch */
@@ -313,6 +433,7 @@ rte_rib6_insert(struct rte_rib6 *rib,
 			*tmp = new_node;
 			new_node->parent = prev;
 			++rib->cur_routes;
+			*top = new_node;
 			return *tmp;
 		}
 		/*
@@ -389,9 +510,70 @@ rte_rib6_insert(struct rte_rib6 *rib,
 		*tmp = common_node;
 	}
 	++rib->cur_routes;
+	*top = *tmp;
 	return new_node;
 }
 
+struct rte_rib6_node *
+rte_rib6_insert(struct rte_rib6 *rib,
+	const struct rte_ipv6_addr *ip, uint8_t depth)
+{
+	struct rte_rib6_node *node, *top;
+
+	if (unlikely((rib == NULL || ip == NULL || depth > RTE_IPV6_MAX_DEPTH))) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	node = __rib6_insert(rib, ip, depth, &top);
+	/* longer nodes are not in the subtree roots table */
+	if (top != NULL && top->depth <= rib->tbl_bits)
+		tbl_update(rib, &top->ip, top->depth);
+	return node;
+}
+
+unsigned int
+rte_rib6_insert_bulk(struct rte_rib6 *rib, const struct rte_ipv6_addr *ips,
+	const uint8_t *depths, struct rte_rib6_node **nodes, unsigned int n)
+{
+	const struct rte_ipv6_addr zero_ip = RTE_IPV6_ADDR_UNSPEC;
+	struct rte_rib6_node *node, *top;
+	bool rebuild = false;
+	unsigned int i;
+
+	if (unlikely(rib == NULL || ips == NULL || depths == NULL)) {
+		rte_errno = EINVAL;
+		return 0;
+	}
+
+	/*
+	 * Insertions leave the subtree roots table usable, as long as
+	 * no node is freed, so the updates of the short prefixes,
+	 * covering many entries, are replaced by a single rebuild.
+	 */
+	for (i = 0; i < n; i++) {
+		if (unlikely(depths[i] > RTE_IPV6_MAX_DEPTH)) {
+			rte_errno = EINVAL;
+			break;
+		}
+		node = __rib6_insert(rib, &ips[i], depths[i], &top);
+		if (node == NULL)
+			break;
+		if (top != NULL && top->depth <= rib->tbl_bits) {
+			if (rib->tbl_bits - top->depth > RIB6_TBL_BULK_LOG2)
+				rebuild = true;
+			else
+				tbl_update(rib, &top->ip, top->depth);
+		}
+		if (nodes != NULL)
+			nodes[i] = node;
+	}
+	if (rebuild)
+		tbl_update(rib, &zero_ip, 0);
+
+	return i;
+}
+
 int
 rte_rib6_get_ip(const struct rte_rib6_node *node,
 		struct rte_ipv6_addr *ip)
@@ -452,6 +634,8 @@ rte_rib6_create(const char *name, int socket_id,
 	struct rte_tailq_entry *te;
 	struct rte_rib6_list *rib6_list;
 	struct rte_mempool *node_pool;
+	struct rte_rib6_node **tbl = NULL;
+	int tbl_bits;
 
 	/* Check user arguments. */
 	if (unlikely(name == NULL || conf == NULL || conf->max_nodes <= 0)) {
@@ -459,6 +643,23 @@ rte_rib6_create(const char *name, int socket_id,
 		return NULL;
 	}
 
+	/* one subtree roots table entry for a few nodes */
+	tbl_bits = rte_bsf32(rte_align32prevpow2(conf->max_nodes)) -
+		RIB6_TBL_NODES_LOG2;
+	tbl_bits = RTE_MIN(tbl_bits, RIB6_TBL_MAX_BITS);
+	if (tbl_bits >= RIB6_TBL_MIN_BITS) {
+		tbl = rte_zmalloc_socket("RIB6_TBL", sizeof(*tbl) << tbl_bits,
+			RTE_CACHE_LINE_SIZE, socket_id);
+		if (tbl == NULL) {
+			RIB_LOG(ERR,
+				"Can not allocate subtree roots table for RIB6 %s",
+				name);
+			rte_errno = ENOMEM;
+			return NULL;
+		}
+	} else
+		tbl_bits = 0;
+
 	snprintf(mem_name, sizeof(mem_name), "MP_%s", name);
 	node_pool = rte_mempool_create(mem_name, conf->max_nodes,
 		sizeof(struct rte_rib6_node) + conf->ext_sz, 0, 0,
@@ -467,6 +668,7 @@ rte_rib6_create(const char *name, int socket_id,
 	if (node_pool == NULL) {
 		RIB_LOG(ERR,
 			"Can not allocate mempool for RIB6 %s", name);
+		rte_free(tbl);
 		return NULL;
 	}
 
@@ -509,6 +711,8 @@ rte_rib6_create(const char *name, int socket_id,
 	rib->tree = NULL;
 	rib->max_nodes = conf->max_nodes;
 	rib->node_pool = node_pool;
+	rib->tbl = tbl;
+	rib->tbl_bits = tbl_bits;
 
 	te->data = (void *)rib;
 	TAILQ_INSERT_TAIL(rib6_list, te, next);
@@ -522,6 +726,7 @@ rte_rib6_create(const char *name, int socket_id,
 exit:
 	rte_mcfg_tailq_write_unlock();
 	rte_mempool_free(node_pool);
+	rte_free(tbl);
 
 	return NULL;
 }
@@ -582,6 +787,11 @@ rte_rib6_free(struct rte_rib6 *rib)
 
 	rte_mcfg_tailq_write_unlock();
 
+	/* no need to maintain the subtree roots table while freeing */
+	rte_free(rib->tbl);
+	rib->tbl = NULL;
+	rib->tbl_bits = 0;
+
 	while ((tmp = rte_rib6_get_nxt(rib, 0, 0, tmp,
 			RTE_RIB6_GET_NXT_ALL)) != NULL)
 		rte_rib6_remove(rib, &tmp->ip, tmp->depth);
@@ -14,6 +14,7 @@
  * Level compressed tree implementation for IPv6 Longest Prefix Match
  */
 
+#include <rte_compat.h>
 #include <rte_memcpy.h>
 #include <rte_common.h>
 #include <rte_ip6.h>
@@ -224,6 +225,36 @@ struct rte_rib6_node *
 rte_rib6_insert(struct rte_rib6 *rib,
 	const struct rte_ipv6_addr *ip, uint8_t depth);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Insert a batch of prefixes into the RIB
+ *
+ * Faster than calling rte_rib6_insert() for every prefix,
+ * the search structures are updated once for the whole batch.
+ * The prefixes are inserted in order, the batch stops at the first
+ * prefix failing to be inserted.
+ *
+ * @param rib
+ *  RIB object handle
+ * @param ips
+ *  nets to be inserted to the RIB
+ * @param depths
+ *  prefix lengths
+ * @param nodes
+ *  array to save the inserted nodes to, may be NULL
+ * @param n
+ *  number of prefixes
+ * @return
+ *  number of prefixes inserted,
+ *  lower than n on failure with rte_errno indicating reason for failure
+ */
+__rte_experimental
+unsigned int
+rte_rib6_insert_bulk(struct rte_rib6 *rib, const struct rte_ipv6_addr *ips,
+	const uint8_t *depths, struct rte_rib6_node **nodes, unsigned int n);
+
 /**
  * Get an ip from rte_rib6_node
  *
@@ -414,6 +414,35 @@ __rte_experimental
 int
 rte_telemetry_register_cmd_arg(const char *cmd, telemetry_arg_cb fn, void *arg, const char *help);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enable caching of the responses of a registered command.
+ *
+ * While a cached response for the same command parameters is younger than
+ * the given age, it is returned to the clients without calling the command
+ * callback again. This is useful for expensive commands polled by several
+ * monitoring clients.
+ *
+ * @param cmd
+ *   The registered command.
+ * @param max_age_ms
+ *   Maximum age of a cached response in milliseconds, 0 to disable caching.
+ *
+ * @return
+ *   0 on success.
+ * @return
+ *   -EINVAL for invalid parameters failure.
+ * @return
+ *   -ENOENT if the command is not registered.
+ * @return
+ *   -ENOMEM for mem allocation failure.
+ */
+__rte_experimental
+int
+rte_telemetry_cmd_cache_set(const char *cmd, unsigned int max_age_ms);
+
 /**
  * Get a pointer to a container with memory allocated. The container is to be
  * used embedded within an existing telemetry dict/array.
@@ -5,7 +5,10 @@
 #include <ctype.h>
 #include <errno.h>
 #include <stdlib.h>
+#include <time.h>
 #ifndef RTE_EXEC_ENV_WINDOWS
+#include <fcntl.h>
+#include <poll.h>
 #include <unistd.h>
 #include <pthread.h>
 #include <sys/socket.h>
@@ -25,14 +28,29 @@
 #include "telemetry_data.h"
 #include "telemetry_internal.h"
 
-#define MAX_CMD_LEN 56
+#define MAX_CMD_LEN 128
+#define MAX_INPUT_LEN 4096
+/* maximum size of a message, longer responses are streamed or truncated */
 #define MAX_OUTPUT_LEN (1024 * 16)
-#define MAX_CONNECTIONS 10
+#define MAX_CONNECTIONS 128
+#define MAX_CACHE_ENTRIES 256
+#define BATCH_CMD "/batch"
+#define STREAM_CMD "/stream"
+
+/* cached response of a command, for a given parameter string */
+struct cmd_cache_entry {
+	char *params;
+	char *json;
+	size_t len;
+	uint64_t timestamp; /* in ns */
+};
 
-#ifndef RTE_EXEC_ENV_WINDOWS
-static void *
-client_handler(void *socket);
-#endif /* !RTE_EXEC_ENV_WINDOWS */
+/* response cache of a command, only used by the telemetry server thread */
+struct cmd_cache {
+	RTE_ATOMIC(uint64_t) max_age; /* in ns, 0 when disabled */
+	unsigned int nb_entries;
+	struct cmd_cache_entry entries[MAX_CACHE_ENTRIES];
+};
 
 struct cmd_callback {
 	char cmd[MAX_CMD_LEN];
@@ -40,6 +58,7 @@ struct cmd_callback {
 	telemetry_arg_cb fn_arg;
 	void *arg;
 	char help[RTE_TEL_MAX_STRING_LEN];
+	struct cmd_cache *cache;
 };
 
 #ifndef RTE_EXEC_ENV_WINDOWS
@@ -66,9 +85,6 @@ static struct cmd_callback *callbacks;
 static int num_callbacks; /* How many commands are registered */
 /* Used when accessing or modifying list of command callbacks */
 static rte_spinlock_t callback_sl = RTE_SPINLOCK_INITIALIZER;
-#ifndef RTE_EXEC_ENV_WINDOWS
-static RTE_ATOMIC(uint16_t) v2_clients;
-#endif /* !RTE_EXEC_ENV_WINDOWS */
 
 static int
 register_cmd(const char *cmd, const char *help,
@@ -108,6 +124,7 @@ register_cmd(const char *cmd, const char *help,
 	callbacks[i].fn_arg = fn_arg;
 	callbacks[i].arg = arg;
 	strlcpy(callbacks[i].help, help, RTE_TEL_MAX_STRING_LEN);
+	callbacks[i].cache = NULL;
 	num_callbacks++;
 	rte_spinlock_unlock(&callback_sl);
 
@@ -126,6 +143,38 @@ rte_telemetry_register_cmd_arg(const char *cmd, telemetry_arg_cb fn, void *arg,
 	return register_cmd(cmd, help, NULL, fn, arg);
 }
 
+int
+rte_telemetry_cmd_cache_set(const char *cmd, unsigned int max_age_ms)
+{
+	int i, ret = -ENOENT;
+
+	if (cmd == NULL)
+		return -EINVAL;
+
+	rte_spinlock_lock(&callback_sl);
+	for (i = 0; i < num_callbacks; i++) {
+		if (strcmp(cmd, callbacks[i].cmd) != 0)
+			continue;
+
+		if (callbacks[i].cache == NULL && max_age_ms != 0) {
+			callbacks[i].cache = calloc(1, sizeof(struct cmd_cache));
+			if (callbacks[i].cache == NULL) {
+				ret = -ENOMEM;
+				break;
+			}
+		}
+		if (callbacks[i].cache != NULL)
+			rte_atomic_store_explicit(&callbacks[i].cache->max_age,
+					(uint64_t)max_age_ms * 1000000,
+					rte_memory_order_relaxed);
+		ret = 0;
+		break;
+	}
+	rte_spinlock_unlock(&callback_sl);
+
+	return ret;
+}
+
 #ifndef RTE_EXEC_ENV_WINDOWS
 
 static int
@@ -177,214 +226,210 @@ command_help(const char *cmd __rte_unused, const char *params,
 	return 0;
 }
 
+/*
+ * Growable output buffer. When limited, elements which do not fit are
+ * dropped along with all the following ones, while keeping room to close
+ * the containers already opened, so that the output is always valid JSON.
+ */
+struct out_buf {
+	char *data;
+	size_t len;
+	size_t size;
+	size_t limit;    /* maximum length, 0 for no limit */
+	size_t reserved; /* room kept to close the open containers */
+	int err;         /* set once an element is dropped */
+};
+
+/* append to the buffer, regardless of its limit */
 static int
-container_to_json(const struct rte_tel_data *d, char *out_buf, size_t buf_len)
+out_put(struct out_buf *o, const char *s, size_t len)
 {
-	size_t used = 0;
-	unsigned int i;
+	size_t size;
+	char *data;
+
+	if (o->len + len + 1 > o->size) {
+		size = RTE_MAX(o->size * 2, o->len + len + 1);
+		data = realloc(o->data, size);
+		if (data == NULL) {
+			o->err = -ENOMEM;
+			return -1;
+		}
+		o->data = data;
+		o->size = size;
+	}
+	memcpy(o->data + o->len, s, len);
+	o->len += len;
+	o->data[o->len] = '\0';
+	return 0;
+}
 
-	if (d->type != TEL_DICT && d->type != TEL_ARRAY_UINT &&
-		d->type != TEL_ARRAY_INT && d->type != TEL_ARRAY_STRING)
-		return snprintf(out_buf, buf_len, "null");
+static int
+out_append(struct out_buf *o, const char *s, size_t len)
+{
+	if (o->err != 0)
+		return -1;
+	if (o->limit != 0 && o->len + len + o->reserved > o->limit) {
+		o->err = -ENOSPC;
+		return -1;
+	}
+	return out_put(o, s, len);
+}
 
-	if (d->type == TEL_DICT)
-		used = rte_tel_json_empty_obj(out_buf, buf_len, 0);
-	else
-		used = rte_tel_json_empty_array(out_buf, buf_len, 0);
-
-	if (d->type == TEL_ARRAY_UINT)
-		for (i = 0; i < d->data_len; i++)
-			used = rte_tel_json_add_array_uint(out_buf,
-				buf_len, used,
-				d->data.array[i].uval);
-	if (d->type == TEL_ARRAY_INT)
-		for (i = 0; i < d->data_len; i++)
-			used = rte_tel_json_add_array_int(out_buf,
-				buf_len, used,
-				d->data.array[i].ival);
-	if (d->type == TEL_ARRAY_STRING)
-		for (i = 0; i < d->data_len; i++)
-			used = rte_tel_json_add_array_string(out_buf,
-				buf_len, used,
-				d->data.array[i].sval);
-	if (d->type == TEL_DICT)
-		for (i = 0; i < d->data_len; i++) {
-			const struct tel_dict_entry *v = &d->data.dict[i];
-			switch (v->type) {
-			case RTE_TEL_STRING_VAL:
-				used = rte_tel_json_add_obj_str(out_buf,
-						buf_len, used,
-						v->name, v->value.sval);
-				break;
-			case RTE_TEL_INT_VAL:
-				used = rte_tel_json_add_obj_int(out_buf,
-						buf_len, used,
-						v->name, v->value.ival);
-				break;
-			case RTE_TEL_UINT_VAL:
-				used = rte_tel_json_add_obj_uint(out_buf,
-						buf_len, used,
-						v->name, v->value.uval);
-				break;
-			case RTE_TEL_CONTAINER:
-			{
-				char *temp = malloc(buf_len);
-				if (temp == NULL)
-					break;
-				*temp = '\0';  /* ensure valid string */
-
-				const struct container *cont =
-						&v->value.container;
-				if (container_to_json(cont->data,
-						temp, buf_len) != 0)
-					used = rte_tel_json_add_obj_json(
-							out_buf,
-							buf_len, used,
-							v->name, temp);
-				if (!cont->keep)
-					rte_tel_data_free(cont->data);
-				free(temp);
-				break;
-			}
-			}
-		}
+/* append a string, escaped as required by JSON */
+static int
+out_append_str(struct out_buf *o, const char *prefix, const char *str,
+		const char *suffix)
+{
+	char buf[2 * (RTE_TEL_MAX_SINGLE_STRING_LEN + RTE_TEL_MAX_STRING_LEN)];
+	int len;
 
-	return used;
+	if (o->err != 0)
+		return -1;
+	len = __json_format_str_to_buf(buf, sizeof(buf), prefix, str, suffix);
+	if (len == 0) {
+		o->err = -E2BIG;
+		return -1;
+	}
+	return out_append(o, buf, len);
 }
 
+/* drop a partially written element */
 static void
-output_json(const char *cmd, const struct rte_tel_data *d, int s)
+out_rollback(struct out_buf *o, size_t len)
 {
-	char out_buf[MAX_OUTPUT_LEN];
+	if (o->data == NULL)
+		return;
+	o->len = len;
+	o->data[len] = '\0';
+}
 
-	char *cb_data_buf;
-	size_t buf_len, prefix_used, used = 0;
-	unsigned int i;
+static void
+out_value(struct out_buf *o, const struct rte_tel_data *d);
 
-	RTE_BUILD_BUG_ON(sizeof(out_buf) < MAX_CMD_LEN +
-			RTE_TEL_MAX_SINGLE_STRING_LEN + 10);
+/* output a container, freeing it if not kept even if the output is full */
+static void
+out_container(struct out_buf *o, const struct container *cont)
+{
+	out_value(o, cont->data);
+	if (!cont->keep)
+		rte_tel_data_free(cont->data);
+}
 
-	prefix_used = snprintf(out_buf, sizeof(out_buf), "{\"%.*s\":",
-			MAX_CMD_LEN, cmd);
-	cb_data_buf = &out_buf[prefix_used];
-	buf_len = sizeof(out_buf) - prefix_used - 1; /* space for '}' */
+static void
+out_dict_entry(struct out_buf *o, const struct tel_dict_entry *v,
+		const char *sep)
+{
+	char buf[RTE_TEL_MAX_STRING_LEN + 32];
+	int len = 0;
 
-	switch (d->type) {
-	case TEL_NULL:
-		used = strlcpy(cb_data_buf, "null", buf_len);
+	switch (v->type) {
+	case RTE_TEL_STRING_VAL:
+		snprintf(buf, sizeof(buf), "%s\"%s\":\"", sep, v->name);
+		out_append_str(o, buf, v->value.sval, "\"");
 		break;
-
-	case TEL_STRING:
-		used = rte_tel_json_str(cb_data_buf, buf_len, 0, d->data.str);
+	case RTE_TEL_INT_VAL:
+		len = snprintf(buf, sizeof(buf), "%s\"%s\":%"PRId64,
+				sep, v->name, v->value.ival);
+		out_append(o, buf, len);
 		break;
-
-	case TEL_DICT:
-		used = rte_tel_json_empty_obj(cb_data_buf, buf_len, 0);
-		for (i = 0; i < d->data_len; i++) {
-			const struct tel_dict_entry *v = &d->data.dict[i];
-			switch (v->type) {
-			case RTE_TEL_STRING_VAL:
-				used = rte_tel_json_add_obj_str(cb_data_buf,
-						buf_len, used,
-						v->name, v->value.sval);
-				break;
-			case RTE_TEL_INT_VAL:
-				used = rte_tel_json_add_obj_int(cb_data_buf,
-						buf_len, used,
-						v->name, v->value.ival);
-				break;
-			case RTE_TEL_UINT_VAL:
-				used = rte_tel_json_add_obj_uint(cb_data_buf,
-						buf_len, used,
-						v->name, v->value.uval);
-				break;
-			case RTE_TEL_CONTAINER:
-			{
-				char *temp = malloc(buf_len);
-				if (temp == NULL)
-					break;
-				*temp = '\0';  /* ensure valid string */
-
-				const struct container *cont =
-						&v->value.container;
-				if (container_to_json(cont->data,
-						temp, buf_len) != 0)
-					used = rte_tel_json_add_obj_json(
-							cb_data_buf,
-							buf_len, used,
-							v->name, temp);
-				if (!cont->keep)
-					rte_tel_data_free(cont->data);
-				free(temp);
-			}
-			}
-		}
+	case RTE_TEL_UINT_VAL:
+		len = snprintf(buf, sizeof(buf), "%s\"%s\":%"PRIu64,
+				sep, v->name, v->value.uval);
+		out_append(o, buf, len);
+		break;
+	case RTE_TEL_CONTAINER:
+		len = snprintf(buf, sizeof(buf), "%s\"%s\":", sep, v->name);
+		out_append(o, buf, len);
+		out_container(o, &v->value.container);
 		break;
+	}
+}
+
+static void
+out_array_entry(struct out_buf *o, enum tel_container_types type,
+		const union tel_value *v, const char *sep)
+{
+	char buf[32];
+	int len;
 
+	switch (type) {
 	case TEL_ARRAY_STRING:
+		out_append_str(o, *sep ? ",\"" : "\"", v->sval, "\"");
+		break;
 	case TEL_ARRAY_INT:
+		len = snprintf(buf, sizeof(buf), "%s%"PRId64, sep, v->ival);
+		out_append(o, buf, len);
+		break;
 	case TEL_ARRAY_UINT:
+		len = snprintf(buf, sizeof(buf), "%s%"PRIu64, sep, v->uval);
+		out_append(o, buf, len);
+		break;
 	case TEL_ARRAY_CONTAINER:
-		used = rte_tel_json_empty_array(cb_data_buf, buf_len, 0);
-		for (i = 0; i < d->data_len; i++)
-			if (d->type == TEL_ARRAY_STRING)
-				used = rte_tel_json_add_array_string(
-						cb_data_buf,
-						buf_len, used,
-						d->data.array[i].sval);
-			else if (d->type == TEL_ARRAY_INT)
-				used = rte_tel_json_add_array_int(cb_data_buf,
-						buf_len, used,
-						d->data.array[i].ival);
-			else if (d->type == TEL_ARRAY_UINT)
-				used = rte_tel_json_add_array_uint(cb_data_buf,
-						buf_len, used,
-						d->data.array[i].uval);
-			else if (d->type == TEL_ARRAY_CONTAINER) {
-				char *temp = malloc(buf_len);
-				if (temp == NULL)
-					break;
-				*temp = '\0';  /* ensure valid string */
-
-				const struct container *rec_data =
-						&d->data.array[i].container;
-				if (container_to_json(rec_data->data,
-						temp, buf_len) != 0)
-					used = rte_tel_json_add_array_json(
-							cb_data_buf,
-							buf_len, used, temp);
-				if (!rec_data->keep)
-					rte_tel_data_free(rec_data->data);
-				free(temp);
-			}
+		out_append(o, sep, strlen(sep));
+		out_container(o, &v->container);
+		break;
+	default:
 		break;
 	}
-	used += prefix_used;
-	used += strlcat(out_buf + used, "}", sizeof(out_buf) - used);
-	if (write(s, out_buf, used) < 0)
-		perror("Error writing to socket");
 }
 
 static void
-perform_command(const struct cmd_callback *cb, const char *cmd, const char *param, int s)
+out_value(struct out_buf *o, const struct rte_tel_data *d)
 {
-	struct rte_tel_data data = {0};
-	int ret;
+	const char *open = d->type == TEL_DICT ? "{" : "[";
+	const char *close = d->type == TEL_DICT ? "}" : "]";
+	unsigned int i;
+	size_t mark;
+	int opened;
 
-	if (cb->fn_arg != NULL)
-		ret = cb->fn_arg(cmd, param, cb->arg, &data);
-	else
-		ret = cb->fn(cmd, param, &data);
-
-	if (ret < 0) {
-		char out_buf[MAX_CMD_LEN + 10];
-		int used = snprintf(out_buf, sizeof(out_buf), "{\"%.*s\":null}",
-				MAX_CMD_LEN, cmd ? cmd : "none");
-		if (write(s, out_buf, used) < 0)
-			perror("Error writing to socket");
+	switch (d->type) {
+	case TEL_NULL:
+		out_append(o, "null", 4);
+		return;
+	case TEL_STRING:
+		out_append_str(o, "\"", d->data.str, "\"");
+		return;
+	default:
+		break;
+	}
+
+	opened = out_append(o, open, 1) == 0;
+	if (opened)
+		o->reserved++;
+	for (i = 0; i < d->data_len; i++) {
+		mark = o->len;
+		if (d->type == TEL_DICT)
+			out_dict_entry(o, &d->data.dict[i], i == 0 ? "" : ",");
+		else
+			out_array_entry(o, d->type, &d->data.array[i],
+					i == 0 ? "" : ",");
+		if (o->err != 0)
+			out_rollback(o, mark);
+	}
+	if (opened) {
+		o->reserved--;
+		out_put(o, close, 1);
+	}
+}
+
+/* output the response of a command: {"<cmd>":<data>} */
+static void
+out_response(struct out_buf *o, const char *cmd, const struct rte_tel_data *d)
+{
+	size_t mark;
+
+	if (out_append_str(o, "{\"", cmd, "\":") < 0) {
+		out_value(o, d); /* only frees the containers */
 		return;
 	}
-	output_json(cmd, &data, s);
+	/* room for "null}" */
+	o->reserved += 5;
+	mark = o->len;
+	out_value(o, d);
+	o->reserved -= 5;
+	if (o->len == mark)
+		out_put(o, "null", 4);
+	out_put(o, "}", 1);
 }
 
 static int
@@ -394,45 +439,363 @@ unknown_command(const char *cmd __rte_unused, const char *params __rte_unused,
 	return d->type = TEL_NULL;
 }
 
-static void *
-client_handler(void *sock_id)
+/* commands handled by the server loop, as they need the client connection */
+static int
+server_command(const char *cmd __rte_unused, const char *params __rte_unused,
+		struct rte_tel_data *d __rte_unused)
+{
+	return -ENOTSUP;
+}
+
+static uint64_t
+get_time_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static struct cmd_cache_entry *
+cache_lookup(struct cmd_cache *cache, const char *params, uint64_t now)
+{
+	uint64_t max_age = rte_atomic_load_explicit(&cache->max_age,
+			rte_memory_order_relaxed);
+	unsigned int i;
+
+	for (i = 0; i < cache->nb_entries; i++)
+		if (strcmp(cache->entries[i].params, params) == 0)
+			return now - cache->entries[i].timestamp < max_age ?
+				&cache->entries[i] : NULL;
+	return NULL;
+}
+
+static void
+cache_store(struct cmd_cache *cache, const char *params, const char *json,
+		size_t len, uint64_t now)
+{
+	struct cmd_cache_entry *e = NULL;
+	char *p, *copy;
+	unsigned int i;
+
+	for (i = 0; i < cache->nb_entries; i++) {
+		if (strcmp(cache->entries[i].params, params) == 0) {
+			e = &cache->entries[i];
+			break;
+		}
+		/* otherwise replace the oldest entry */
+		if (e == NULL || cache->entries[i].timestamp < e->timestamp)
+			e = &cache->entries[i];
+	}
+	if (i == cache->nb_entries && cache->nb_entries < MAX_CACHE_ENTRIES)
+		e = &cache->entries[cache->nb_entries];
+
+	copy = malloc(len);
+	if (copy == NULL)
+		return;
+	memcpy(copy, json, len);
+
+	if (e == &cache->entries[cache->nb_entries]) {
+		p = strdup(params);
+		if (p == NULL) {
+			free(copy);
+			return;
+		}
+		e->params = p;
+		cache->nb_entries++;
+	} else if (strcmp(e->params, params) != 0) {
+		p = strdup(params);
+		if (p == NULL) {
+			free(copy);
+			return;
+		}
+		free(e->params);
+		e->params = p;
+	}
+	free(e->json);
+	e->json = copy;
+	e->len = len;
+	e->timestamp = now;
+}
+
+/*
+ * Append the response of a command to the output buffer, either calling
+ * the command callback, or taking it from the command cache if fresh enough.
+ */
+static void
+command_response(struct out_buf *o, const char *cmd, const char *param)
+{
+	struct cmd_callback cb = {.fn = unknown_command};
+	struct rte_tel_data data = {0};
+	const char *cache_key = param == NULL ? "" : param;
+	struct cmd_cache_entry *e;
+	uint64_t now = 0;
+	size_t mark;
+	int i, ret;
+
+	if (cmd && strlen(cmd) < MAX_CMD_LEN) {
+		rte_spinlock_lock(&callback_sl);
+		for (i = 0; i < num_callbacks; i++)
+			if (strcmp(cmd, callbacks[i].cmd) == 0) {
+				cb = callbacks[i];
+				break;
+			}
+		rte_spinlock_unlock(&callback_sl);
+	}
+
+	if (cb.cache != NULL && rte_atomic_load_explicit(&cb.cache->max_age,
+			rte_memory_order_relaxed) != 0) {
+		now = get_time_ns();
+		e = cache_lookup(cb.cache, cache_key, now);
+		/* a truncated response must be generated again */
+		if (e != NULL && (o->limit == 0 ||
+				o->len + e->len + o->reserved <= o->limit)) {
+			out_append(o, e->json, e->len);
+			return;
+		}
+	}
+
+	if (cb.fn_arg != NULL)
+		ret = cb.fn_arg(cmd, param, cb.arg, &data);
+	else
+		ret = cb.fn(cmd, param, &data);
+	if (ret < 0)
+		data.type = TEL_NULL;
+
+	mark = o->len;
+	out_response(o, cmd ? cmd : "none", &data);
+	if (now != 0 && ret >= 0 && o->err == 0)
+		cache_store(cb.cache, cache_key, o->data + mark, o->len - mark,
+				now);
+}
+
+/*
+ * Run a list of commands separated by ';', each with its parameters,
+ * and return their responses in an array.
+ */
+static void
+batch_response(struct out_buf *o, char *params)
+{
+	char *sp_cmds, *sp_param;
+	char *c, *cmd, *param;
+	size_t mark;
+	int first = 1;
+
+	if (out_append_str(o, "{\"", BATCH_CMD, "\":[") < 0)
+		return;
+	o->reserved += 2;
+
+	for (c = params == NULL ? NULL : strtok_r(params, ";", &sp_cmds);
+			c != NULL && o->err == 0;
+			c = strtok_r(NULL, ";", &sp_cmds)) {
+		cmd = strtok_r(c, ",", &sp_param);
+		param = strtok_r(NULL, "\0", &sp_param);
+
+		mark = o->len;
+		if (!first)
+			out_append(o, ",", 1);
+		command_response(o, cmd, param);
+		if (o->err != 0 && o->len == mark + !first)
+			out_rollback(o, mark);
+		first = 0;
+	}
+
+	o->reserved -= 2;
+	out_put(o, "]}", 2);
+}
+
+/* connection of a v2 telemetry client */
+struct client {
+	int sock;
+	int stream; /* responses may be sent in several messages */
+	char *out;  /* response being sent */
+	size_t out_len;
+	size_t out_sent;
+};
+
+/* enable or disable streaming of the responses to a client */
+static void
+stream_response(struct out_buf *o, struct client *c, const char *param)
+{
+	struct rte_tel_data data = {0};
+
+	if (param != NULL)
+		c->stream = atoi(param) != 0;
+	o->limit = c->stream ? 0 : MAX_OUTPUT_LEN;
+
+	rte_tel_data_start_dict(&data);
+	rte_tel_data_add_dict_int(&data, "stream", c->stream);
+	rte_tel_data_add_dict_int(&data, "max_output_len", MAX_OUTPUT_LEN);
+	out_response(o, STREAM_CMD, &data);
+}
+
+/* send as much as possible of the pending response of a client */
+static int
+client_send(struct client *c)
+{
+	size_t len;
+	ssize_t ret;
+
+	while (c->out_sent < c->out_len) {
+		len = c->out_len - c->out_sent;
+		if (c->stream && len > MAX_OUTPUT_LEN)
+			len = MAX_OUTPUT_LEN;
+
+		ret = send(c->sock, c->out + c->out_sent, len, MSG_NOSIGNAL);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+				return 0;
+			TMTY_LOG_LINE(DEBUG, "Error writing to socket: %s",
+					strerror(errno));
+			return -1;
+		}
+		c->out_sent += ret;
+	}
+
+	free(c->out);
+	c->out = NULL;
+	return 0;
+}
+
+/* read and process a request of a client */
+static int
+client_recv(struct client *c)
+{
+	struct out_buf o = {.limit = c->stream ? 0 : MAX_OUTPUT_LEN};
+	char buffer[MAX_INPUT_LEN];
+	char *cmd, *param, *sp;
+	ssize_t bytes;
+
+	/* receive data is not null terminated */
+	bytes = read(c->sock, buffer, sizeof(buffer) - 1);
+	if (bytes == 0)
+		return -1;
+	if (bytes < 0)
+		return (errno == EAGAIN || errno == EWOULDBLOCK ||
+				errno == EINTR) ? 0 : -1;
+	buffer[bytes] = 0;
+
+	cmd = strtok_r(buffer, ",", &sp);
+	param = strtok_r(NULL, "\0", &sp);
+	if (cmd != NULL && strcmp(cmd, STREAM_CMD) == 0)
+		stream_response(&o, c, param);
+	else if (cmd != NULL && strcmp(cmd, BATCH_CMD) == 0)
+		batch_response(&o, param);
+	else
+		command_response(&o, cmd, param);
+
+	if (o.err == -ENOMEM) {
+		free(o.data);
+		return -1;
+	}
+	/* a streamed response ends with a message shorter than the maximum */
+	if (c->stream && o.len % MAX_OUTPUT_LEN == 0 && out_put(&o, "\n", 1) < 0) {
+		free(o.data);
+		return -1;
+	}
+
+	c->out = o.data;
+	c->out_len = o.len;
+	c->out_sent = 0;
+	return client_send(c);
+}
+
+static int
+client_open(struct client *c, int sock)
 {
-	int s = (int)(uintptr_t)sock_id;
-	char buffer[1024];
 	char info_str[1024];
-	snprintf(info_str, sizeof(info_str),
+	int len;
+
+	if (fcntl(sock, F_SETFL, fcntl(sock, F_GETFL) | O_NONBLOCK) < 0)
+		return -1;
+
+	len = snprintf(info_str, sizeof(info_str),
 			"{\"version\":\"%s\",\"pid\":%d,\"max_output_len\":%d}",
 			telemetry_version, getpid(), MAX_OUTPUT_LEN);
-	if (write(s, info_str, strlen(info_str)) < 0) {
+	c->sock = sock;
+	c->stream = 0;
+	c->out = strdup(info_str);
+	if (c->out == NULL)
+		return -1;
+	c->out_len = len;
+	c->out_sent = 0;
+	if (client_send(c) < 0) {
 		TMTY_LOG_LINE(DEBUG, "Socket write base info to client failed");
-		goto exit;
+		free(c->out);
+		return -1;
 	}
+	return 0;
+}
 
-	/* receive data is not null terminated */
-	int bytes = read(s, buffer, sizeof(buffer) - 1);
-	while (bytes > 0) {
-		buffer[bytes] = 0;
-		const char *cmd = strtok(buffer, ",");
-		const char *param = strtok(NULL, "\0");
-		struct cmd_callback cb = {.fn = unknown_command};
-		int i;
-
-		if (cmd && strlen(cmd) < MAX_CMD_LEN) {
-			rte_spinlock_lock(&callback_sl);
-			for (i = 0; i < num_callbacks; i++)
-				if (strcmp(cmd, callbacks[i].cmd) == 0) {
-					cb = callbacks[i];
-					break;
-				}
-			rte_spinlock_unlock(&callback_sl);
+/*
+ * Serve all v2 clients from a single thread: client sockets are non
+ * blocking, each request is processed as soon as it is received, and its
+ * response is sent as the socket becomes writable.
+ */
+static void *
+telemetry_server(void *arg __rte_unused)
+{
+	struct pollfd fds[MAX_CONNECTIONS + 1];
+	struct client clients[MAX_CONNECTIONS];
+	unsigned int nb_clients = 0, i;
+	int ret, s;
+
+	fds[0].fd = v2_socket.sock;
+	fds[0].events = POLLIN;
+	while (1) {
+		for (i = 0; i < nb_clients; i++) {
+			fds[i + 1].fd = clients[i].sock;
+			/* wait for a response to be sent before the next request */
+			fds[i + 1].events = clients[i].out != NULL ? POLLOUT : POLLIN;
+			fds[i + 1].revents = 0;
+		}
+
+		if (poll(fds, nb_clients + 1, -1) < 0) {
+			if (errno == EINTR)
+				continue;
+			TMTY_LOG_LINE(ERR, "Error with poll, telemetry thread quitting");
+			return NULL;
+		}
+
+		for (i = 0; i < nb_clients; ) {
+			short revents = fds[i + 1].revents;
+
+			ret = 0;
+			if (revents & POLLOUT)
+				ret = client_send(&clients[i]);
+			else if (revents & POLLIN)
+				ret = client_recv(&clients[i]);
+			else if (revents & (POLLERR | POLLHUP | POLLNVAL))
+				ret = -1;
+			if (ret == 0) {
+				i++;
+				continue;
+			}
+
+			close(clients[i].sock);
+			free(clients[i].out);
+			nb_clients--;
+			clients[i] = clients[nb_clients];
+			fds[i + 1] = fds[nb_clients + 1];
 		}
-		perform_command(&cb, cmd, param, s);
 
-		bytes = read(s, buffer, sizeof(buffer) - 1);
+		if (!(fds[0].revents & POLLIN))
+			continue;
+		while ((s = accept(v2_socket.sock, NULL, NULL)) >= 0) {
+			if (nb_clients >= MAX_CONNECTIONS ||
+					client_open(&clients[nb_clients], s) < 0) {
+				close(s);
+				continue;
+			}
+			nb_clients++;
+		}
+		if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+			TMTY_LOG_LINE(ERR, "Error with accept, telemetry thread quitting");
+			return NULL;
+		}
 	}
-exit:
-	close(s);
-	rte_atomic_fetch_sub_explicit(&v2_clients, 1, rte_memory_order_relaxed);
 	return NULL;
 }
 
@@ -603,14 +966,16 @@ telemetry_v2_init(void)
 	short suffix = 0;
 	int rc;
 
-	v2_socket.num_clients = &v2_clients;
 	rte_telemetry_register_cmd("/", list_commands,
 			"Returns list of available commands, Takes no parameters");
 	rte_telemetry_register_cmd("/info", json_info,
 			"Returns DPDK Telemetry information. Takes no parameters");
 	rte_telemetry_register_cmd("/help", command_help,
 			"Returns help text for a command. Parameters: string command");
-	v2_socket.fn = client_handler;
+	rte_telemetry_register_cmd(BATCH_CMD, server_command,
+			"Returns the responses of several commands. Parameters: list of commands and parameters, separated by ';'");
+	rte_telemetry_register_cmd(STREAM_CMD, server_command,
+			"Enables responses larger than max_output_len, split in several messages. Parameters: int 0 or 1");
 	if (strlcpy(spath, get_socket_path(socket_dir, 2), sizeof(spath)) >= sizeof(spath)) {
 		TMTY_LOG_LINE(ERR, "Error with socket binding, path too long");
 		return -1;
@@ -632,7 +997,17 @@ telemetry_v2_init(void)
 		}
 		v2_socket.sock = create_socket(v2_socket.path);
 	}
-	rc = pthread_create(&t_new, NULL, socket_listener, &v2_socket);
+	if (fcntl(v2_socket.sock, F_SETFL,
+			fcntl(v2_socket.sock, F_GETFL) | O_NONBLOCK) < 0) {
+		TMTY_LOG_LINE(ERR, "Error setting socket non-blocking: %s",
+			 strerror(errno));
+		close(v2_socket.sock);
+		v2_socket.sock = -1;
+		unlink(v2_socket.path);
+		v2_socket.path[0] = '\0';
+		return -1;
+	}
+	rc = pthread_create(&t_new, NULL, telemetry_server, NULL);
 	if (rc != 0) {
 		TMTY_LOG_LINE(ERR, "Error with create socket thread: %s",
 			 strerror(rc));
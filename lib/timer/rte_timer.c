@@ -9,8 +9,10 @@
 #include <assert.h>
 
 #include <rte_common.h>
+#include <rte_bitops.h>
 #include <rte_cycles.h>
 #include <rte_eal_memconfig.h>
+#include <rte_malloc.h>
 #include <rte_memory.h>
 #include <rte_lcore.h>
 #include <rte_branch_prediction.h>
@@ -21,6 +23,32 @@
 
 #include "rte_timer.h"
 
+#define TIMER_WHEEL_LEVELS	4
+#define TIMER_WHEEL_BITS	8
+#define TIMER_WHEEL_SLOTS	(1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK	(TIMER_WHEEL_SLOTS - 1)
+/** number of ticks covered by the wheel, farther timers are cascaded again */
+#define TIMER_WHEEL_RANGE	(UINT64_C(1) << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS))
+
+/**
+ * Hierarchical timer wheel (per-lcore).
+ *
+ * Level n has TIMER_WHEEL_SLOTS slots of 2^(n * TIMER_WHEEL_BITS) ticks.
+ * A timer is hashed into a slot of the lowest level covering its distance
+ * to the current tick, and moved down (cascaded) when the current tick
+ * enters the range of that slot. In a slot, timers are linked through
+ * sl_next[0], and sl_next[1] holds the address of the link pointing to
+ * the timer, so that it can be removed in constant time.
+ */
+struct timer_wheel {
+	uint64_t tick;          /**< duration of a tick in timer cycles */
+	uint64_t cur_tick;      /**< next tick to be expired */
+	uint32_t nb_pending;    /**< number of timers linked in the wheel */
+	/** bitmap of the non empty slots of each level */
+	uint64_t occupied[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS / 64];
+	struct rte_timer *slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+};
+
 /**
  * Per-lcore info for timers.
  */
@@ -40,6 +68,9 @@ struct __rte_cache_aligned priv_timer {
 	/** running timer on this lcore now */
 	struct rte_timer *running_tim;
 
+	/** timer wheel of this lcore, NULL when using the skiplist */
+	struct timer_wheel *wheel;
+
 #ifdef RTE_LIBRTE_TIMER_DEBUG
 	/** per-lcore statistics */
 	struct rte_timer_debug_stats stats;
@@ -84,18 +115,75 @@ timer_data_valid(uint32_t id)
 	timer_data = &rte_timer_data_arr[id];				\
 } while (0)
 
+/* allocate and attach one timer wheel per lcore to a timer data instance */
+static int
+timer_data_wheel_init(struct rte_timer_data *data, uint64_t tick)
+{
+	struct timer_wheel *wheels;
+	uint64_t cur_tick;
+	int lcore_id;
+
+	if (tick == 0)
+		tick = RTE_MAX(rte_get_timer_hz() / US_PER_S, UINT64_C(1));
+
+	wheels = rte_zmalloc("rte_timer_wheel",
+			RTE_MAX_LCORE * sizeof(*wheels), RTE_CACHE_LINE_SIZE);
+	if (wheels == NULL)
+		return -ENOMEM;
+
+	cur_tick = rte_get_timer_cycles() / tick;
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		wheels[lcore_id].tick = tick;
+		wheels[lcore_id].cur_tick = cur_tick;
+		data->priv_timer[lcore_id].wheel = &wheels[lcore_id];
+		data->priv_timer[lcore_id].pending_head.expire = 0;
+	}
+
+	return 0;
+}
+
+static void
+timer_data_wheel_free(struct rte_timer_data *data)
+{
+	int lcore_id;
+
+	/* wheels of all lcores are allocated in a single block */
+	rte_free(data->priv_timer[0].wheel);
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+		data->priv_timer[lcore_id].wheel = NULL;
+}
+
 int
 rte_timer_data_alloc(uint32_t *id_ptr)
 {
-	int i;
+	return rte_timer_data_alloc_ext(id_ptr, NULL);
+}
+
+int
+rte_timer_data_alloc_ext(uint32_t *id_ptr,
+			 const struct rte_timer_data_param *param)
+{
+	int i, ret;
 	struct rte_timer_data *data;
 
 	if (!rte_timer_subsystem_initialized)
 		return -ENOMEM;
 
+	if (param != NULL && param->backend != RTE_TIMER_BACKEND_SKIPLIST &&
+	    param->backend != RTE_TIMER_BACKEND_WHEEL)
+		return -EINVAL;
+
 	for (i = 0; i < RTE_MAX_DATA_ELS; i++) {
 		data = &rte_timer_data_arr[i];
 		if (!(data->internal_flags & FL_ALLOCATED)) {
+			if (param != NULL &&
+			    param->backend == RTE_TIMER_BACKEND_WHEEL) {
+				ret = timer_data_wheel_init(data,
+						param->wheel_tick);
+				if (ret < 0)
+					return ret;
+			}
+
 			data->internal_flags |= FL_ALLOCATED;
 
 			if (id_ptr)
@@ -114,6 +202,9 @@ rte_timer_data_dealloc(uint32_t id)
 	struct rte_timer_data *timer_data;
 	TIMER_DATA_VALID_GET_OR_ERR_RET(id, timer_data, -EINVAL);
 
+	if (timer_data->priv_timer[0].wheel != NULL)
+		timer_data_wheel_free(timer_data);
+
 	timer_data->internal_flags &= ~(FL_ALLOCATED);
 
 	return 0;
@@ -194,8 +285,14 @@ rte_timer_subsystem_finalize(void)
 		return;
 	}
 
-	if (--(*rte_timer_mz_refcnt) == 0)
+	if (--(*rte_timer_mz_refcnt) == 0) {
+		int i;
+
+		for (i = 0; i < RTE_MAX_DATA_ELS; i++)
+			if (rte_timer_data_arr[i].priv_timer[0].wheel != NULL)
+				timer_data_wheel_free(&rte_timer_data_arr[i]);
 		rte_memzone_free(rte_timer_data_mz);
+	}
 
 	rte_timer_subsystem_initialized = 0;
 
@@ -382,6 +479,217 @@ timer_get_prev_entries_for_node(struct rte_timer *tim, unsigned tim_lcore,
 	}
 }
 
+static inline struct rte_timer **
+timer_wheel_pprev(const struct rte_timer *tim)
+{
+	return (struct rte_timer **)(void *)tim->sl_next[1];
+}
+
+static inline void
+timer_wheel_set_pprev(struct rte_timer *tim, struct rte_timer **pprev)
+{
+	tim->sl_next[1] = (struct rte_timer *)(void *)pprev;
+}
+
+/* link a timer in the slot matching its expiry tick */
+static void
+timer_wheel_link(struct timer_wheel *wheel, struct rte_timer *tim)
+{
+	uint64_t tick, delta;
+	unsigned int level, idx;
+	struct rte_timer **slot;
+
+	/* round up, so that a timer never expires early */
+	tick = tim->expire / wheel->tick + (tim->expire % wheel->tick != 0);
+	if (tick < wheel->cur_tick)
+		tick = wheel->cur_tick;
+
+	delta = tick - wheel->cur_tick;
+	if (delta >= TIMER_WHEEL_RANGE) {
+		/* out of range, park it in the farthest slot */
+		delta = TIMER_WHEEL_RANGE - 1;
+		tick = wheel->cur_tick + delta;
+	}
+
+	level = delta < TIMER_WHEEL_SLOTS ? 0 :
+		(rte_fls_u64(delta) - 1) / TIMER_WHEEL_BITS;
+	idx = (tick >> (level * TIMER_WHEEL_BITS)) & TIMER_WHEEL_MASK;
+
+	slot = &wheel->slots[level][idx];
+	tim->sl_next[0] = *slot;
+	if (*slot != NULL)
+		timer_wheel_set_pprev(*slot, &tim->sl_next[0]);
+	timer_wheel_set_pprev(tim, slot);
+	*slot = tim;
+	wheel->occupied[level][idx / 64] |= RTE_BIT64(idx % 64);
+}
+
+/* unlink a timer from its slot */
+static void
+timer_wheel_unlink(struct timer_wheel *wheel, struct rte_timer *tim)
+{
+	struct rte_timer **pprev = timer_wheel_pprev(tim);
+	struct rte_timer *next = tim->sl_next[0];
+	uintptr_t ofs;
+	unsigned int pos;
+
+	timer_wheel_set_pprev(tim, NULL);
+	*pprev = next;
+	if (next != NULL) {
+		timer_wheel_set_pprev(next, pprev);
+		return;
+	}
+
+	/* the timer was alone in its slot if pprev points into the wheel */
+	ofs = (uintptr_t)pprev - (uintptr_t)&wheel->slots[0][0];
+	if (ofs < sizeof(wheel->slots)) {
+		pos = ofs / sizeof(wheel->slots[0][0]);
+		wheel->occupied[pos / TIMER_WHEEL_SLOTS][(pos & TIMER_WHEEL_MASK) / 64] &=
+			~RTE_BIT64(pos % 64);
+	}
+}
+
+/*
+ * Add a timer in the wheel of an lcore, in constant time. The expire field
+ * of the dummy head is used as a lower bound of the next expiry, so that
+ * rte_timer_manage() can return without taking the lock.
+ */
+static void
+timer_wheel_add(struct rte_timer *tim, struct priv_timer *priv)
+{
+	struct timer_wheel *wheel = priv->wheel;
+	uint64_t tick_start;
+
+	if (wheel->nb_pending == 0) {
+		/* nothing to cascade, skip the idle period at once */
+		wheel->cur_tick = RTE_MAX(wheel->cur_tick,
+				rte_get_timer_cycles() / wheel->tick);
+		priv->pending_head.expire = UINT64_MAX;
+	}
+
+	timer_wheel_link(wheel, tim);
+	wheel->nb_pending++;
+
+	tick_start = tim->expire - tim->expire % wheel->tick;
+	if (tick_start < priv->pending_head.expire)
+		priv->pending_head.expire = tick_start;
+}
+
+/*
+ * Remove a timer from the wheel of an lcore. Periodic timers are marked
+ * PENDING before being reloaded after expiry, so the timer may not be
+ * linked anymore.
+ */
+static void
+timer_wheel_del(struct rte_timer *tim, struct priv_timer *priv)
+{
+	if (timer_wheel_pprev(tim) == NULL)
+		return;
+
+	timer_wheel_unlink(priv->wheel, tim);
+	priv->wheel->nb_pending--;
+}
+
+/* return the first non empty slot of a level starting from idx */
+static unsigned int
+timer_wheel_next_slot(const struct timer_wheel *wheel, unsigned int level,
+		      unsigned int idx)
+{
+	unsigned int i = idx / 64;
+	uint64_t bits;
+
+	if (idx >= TIMER_WHEEL_SLOTS)
+		return TIMER_WHEEL_SLOTS;
+
+	bits = wheel->occupied[level][i] & (UINT64_MAX << (idx % 64));
+	while (bits == 0) {
+		if (++i == TIMER_WHEEL_SLOTS / 64)
+			return TIMER_WHEEL_SLOTS;
+		bits = wheel->occupied[level][i];
+	}
+
+	return i * 64 + rte_ctz64(bits);
+}
+
+/* move the timers of the slots entered by the current tick one level down */
+static void
+timer_wheel_cascade(struct timer_wheel *wheel)
+{
+	struct rte_timer *tim, *next_tim;
+	unsigned int level, idx;
+
+	for (level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+		idx = (wheel->cur_tick >> (level * TIMER_WHEEL_BITS)) &
+			TIMER_WHEEL_MASK;
+
+		tim = wheel->slots[level][idx];
+		wheel->slots[level][idx] = NULL;
+		wheel->occupied[level][idx / 64] &= ~RTE_BIT64(idx % 64);
+		for (; tim != NULL; tim = next_tim) {
+			next_tim = tim->sl_next[0];
+			timer_wheel_link(wheel, tim);
+		}
+
+		if (idx != 0)
+			break;
+	}
+}
+
+/*
+ * Expire the wheel of an lcore up to cur_time, with its lock held. All the
+ * timers of a slot are processed in a batch: the ones that can be moved to
+ * the RUNNING state are unlinked and returned as a list chained through
+ * sl_next[0]. The others are being reconfigured by another lcore, which
+ * will remove them from the wheel once the lock is released.
+ */
+static struct rte_timer *
+timer_wheel_expire(struct priv_timer *priv, uint64_t cur_time)
+{
+	struct timer_wheel *wheel = priv->wheel;
+	struct rte_timer *run_first_tim = NULL, **pprev = &run_first_tim;
+	struct rte_timer *tim, *next_tim;
+	uint64_t now_tick = cur_time / wheel->tick;
+	uint64_t next_tick;
+	unsigned int idx, next_idx;
+
+	while (wheel->cur_tick <= now_tick) {
+		if (wheel->nb_pending == 0) {
+			wheel->cur_tick = now_tick + 1;
+			break;
+		}
+
+		idx = wheel->cur_tick & TIMER_WHEEL_MASK;
+		if (idx == 0)
+			timer_wheel_cascade(wheel);
+
+		for (tim = wheel->slots[0][idx]; tim != NULL; tim = next_tim) {
+			next_tim = tim->sl_next[0];
+
+			if (timer_set_running_state(tim) < 0)
+				continue;
+
+			timer_wheel_unlink(wheel, tim);
+			wheel->nb_pending--;
+			*pprev = tim;
+			pprev = &tim->sl_next[0];
+		}
+
+		/* jump to the next non empty slot or cascade point */
+		next_idx = timer_wheel_next_slot(wheel, 0, idx + 1);
+		next_tick = wheel->cur_tick - idx + next_idx;
+		wheel->cur_tick = RTE_MIN(next_tick, now_tick + 1);
+	}
+	*pprev = NULL;
+
+	/* update the lower bound of the next expiry */
+	idx = wheel->cur_tick & TIMER_WHEEL_MASK;
+	next_idx = idx == 0 ? 0 : timer_wheel_next_slot(wheel, 0, idx);
+	priv->pending_head.expire =
+		(wheel->cur_tick - idx + next_idx) * wheel->tick;
+
+	return run_first_tim;
+}
+
 /* call with lock held as necessary
  * add in list
  * timer must be in config state
@@ -394,6 +702,11 @@ timer_add(struct rte_timer *tim, unsigned int tim_lcore,
 	unsigned lvl;
 	struct rte_timer *prev[MAX_SKIPLIST_DEPTH+1];
 
+	if (priv_timer[tim_lcore].wheel != NULL) {
+		timer_wheel_add(tim, &priv_timer[tim_lcore]);
+		return;
+	}
+
 	/* find where exactly this element goes in the list of elements
 	 * for each depth. */
 	timer_get_prev_entries(tim->expire, tim_lcore, prev, priv_timer);
@@ -439,6 +752,11 @@ timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
 	if (prev_owner != lcore_id || !local_is_locked)
 		rte_spinlock_lock(&priv_timer[prev_owner].list_lock);
 
+	if (priv_timer[prev_owner].wheel != NULL) {
+		timer_wheel_del(tim, &priv_timer[prev_owner]);
+		goto unlock;
+	}
+
 	/* save the lowest list entry into the expire field of the dummy hdr.
 	 * NOTE: this is not atomic on 32-bit */
 	if (tim == priv_timer[prev_owner].pending_head.sl_next[0])
@@ -459,6 +777,7 @@ timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
 		else
 			break;
 
+unlock:
 	if (prev_owner != lcore_id || !local_is_locked)
 		rte_spinlock_unlock(&priv_timer[prev_owner].list_lock);
 }
@@ -650,59 +969,74 @@ rte_timer_pending(struct rte_timer *tim)
 				rte_memory_order_relaxed) == RTE_TIMER_PENDING;
 }
 
-/* must be called periodically, run all timer that expired */
-static void
-__rte_timer_manage(struct rte_timer_data *timer_data)
+/*
+ * Return true if there is no pending timer on an lcore. May be called
+ * without the lock, in which case the result is only a hint.
+ */
+static inline bool
+timer_list_empty(const struct priv_timer *priv)
 {
-	union rte_timer_status status;
+	if (priv->wheel != NULL)
+		return priv->wheel->nb_pending == 0;
+	return priv->pending_head.sl_next[0] == NULL;
+}
+
+/*
+ * Remove the expired timers from the pending list of an lcore, and return
+ * the ones that could be moved to the RUNNING state, chained through
+ * sl_next[0] in expiry order.
+ */
+static struct rte_timer *
+timer_get_expired(unsigned int tim_lcore, struct priv_timer *priv_timer)
+{
+	struct priv_timer *privp = &priv_timer[tim_lcore];
 	struct rte_timer *tim, *next_tim;
 	struct rte_timer *run_first_tim, **pprev;
-	unsigned lcore_id = rte_lcore_id();
 	struct rte_timer *prev[MAX_SKIPLIST_DEPTH + 1];
 	uint64_t cur_time;
 	int i, ret;
-	struct priv_timer *priv_timer = timer_data->priv_timer;
 
-	/* timer manager only runs on EAL thread with valid lcore_id */
-	assert(lcore_id < RTE_MAX_LCORE);
-
-	__TIMER_STAT_ADD(priv_timer, manage, 1);
 	/* optimize for the case where per-cpu list is empty */
-	if (priv_timer[lcore_id].pending_head.sl_next[0] == NULL)
-		return;
+	if (timer_list_empty(privp))
+		return NULL;
 	cur_time = rte_get_timer_cycles();
 
 #ifdef RTE_ARCH_64
 	/* on 64-bit the value cached in the pending_head.expired will be
 	 * updated atomically, so we can consult that for a quick check here
 	 * outside the lock */
-	if (likely(priv_timer[lcore_id].pending_head.expire > cur_time))
-		return;
+	if (likely(privp->pending_head.expire > cur_time))
+		return NULL;
 #endif
 
 	/* browse ordered list, add expired timers in 'expired' list */
-	rte_spinlock_lock(&priv_timer[lcore_id].list_lock);
+	rte_spinlock_lock(&privp->list_lock);
+
+	if (privp->wheel != NULL) {
+		run_first_tim = timer_wheel_expire(privp, cur_time);
+		rte_spinlock_unlock(&privp->list_lock);
+		return run_first_tim;
+	}
 
 	/* if nothing to do just unlock and return */
-	if (priv_timer[lcore_id].pending_head.sl_next[0] == NULL ||
-	    priv_timer[lcore_id].pending_head.sl_next[0]->expire > cur_time) {
-		rte_spinlock_unlock(&priv_timer[lcore_id].list_lock);
-		return;
+	if (privp->pending_head.sl_next[0] == NULL ||
+	    privp->pending_head.sl_next[0]->expire > cur_time) {
+		rte_spinlock_unlock(&privp->list_lock);
+		return NULL;
 	}
 
 	/* save start of list of expired timers */
-	tim = priv_timer[lcore_id].pending_head.sl_next[0];
+	tim = privp->pending_head.sl_next[0];
 
 	/* break the existing list at current time point */
-	timer_get_prev_entries(cur_time, lcore_id, prev, priv_timer);
-	for (i = priv_timer[lcore_id].curr_skiplist_depth -1; i >= 0; i--) {
-		if (prev[i] == &priv_timer[lcore_id].pending_head)
+	timer_get_prev_entries(cur_time, tim_lcore, prev, priv_timer);
+	for (i = privp->curr_skiplist_depth - 1; i >= 0; i--) {
+		if (prev[i] == &privp->pending_head)
 			continue;
-		priv_timer[lcore_id].pending_head.sl_next[i] =
-		    prev[i]->sl_next[i];
+		privp->pending_head.sl_next[i] = prev[i]->sl_next[i];
 		if (prev[i]->sl_next[i] == NULL)
-			priv_timer[lcore_id].curr_skiplist_depth--;
-		prev[i] ->sl_next[i] = NULL;
+			privp->curr_skiplist_depth--;
+		prev[i]->sl_next[i] = NULL;
 	}
 
 	/* transition run-list from PENDING to RUNNING */
@@ -724,11 +1058,32 @@ __rte_timer_manage(struct rte_timer_data *timer_data)
 	}
 
 	/* update the next to expire timer value */
-	priv_timer[lcore_id].pending_head.expire =
-	    (priv_timer[lcore_id].pending_head.sl_next[0] == NULL) ? 0 :
-		priv_timer[lcore_id].pending_head.sl_next[0]->expire;
+	privp->pending_head.expire =
+	    (privp->pending_head.sl_next[0] == NULL) ? 0 :
+		privp->pending_head.sl_next[0]->expire;
 
-	rte_spinlock_unlock(&priv_timer[lcore_id].list_lock);
+	rte_spinlock_unlock(&privp->list_lock);
+
+	return run_first_tim;
+}
+
+/* must be called periodically, run all timer that expired */
+static void
+__rte_timer_manage(struct rte_timer_data *timer_data)
+{
+	union rte_timer_status status;
+	struct rte_timer *tim, *next_tim;
+	struct rte_timer *run_first_tim;
+	unsigned lcore_id = rte_lcore_id();
+	struct priv_timer *priv_timer = timer_data->priv_timer;
+
+	/* timer manager only runs on EAL thread with valid lcore_id */
+	assert(lcore_id < RTE_MAX_LCORE);
+
+	__TIMER_STAT_ADD(priv_timer, manage, 1);
+	run_first_tim = timer_get_expired(lcore_id, priv_timer);
+	if (run_first_tim == NULL)
+		return;
 
 	/* now scan expired list and call callbacks */
 	for (tim = run_first_tim; tim != NULL; tim = next_tim) {
@@ -797,16 +1152,12 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 {
 	unsigned int default_poll_lcores[] = {rte_lcore_id()};
 	union rte_timer_status status;
-	struct rte_timer *tim, *next_tim, **pprev;
+	struct rte_timer *tim;
 	struct rte_timer *run_first_tims[RTE_MAX_LCORE];
 	unsigned int this_lcore = rte_lcore_id();
-	struct rte_timer *prev[MAX_SKIPLIST_DEPTH + 1];
-	uint64_t cur_time;
-	int i, j, ret;
+	int i;
 	int nb_runlists = 0;
 	struct rte_timer_data *data;
-	struct priv_timer *privp;
-	uint32_t poll_lcore;
 
 	TIMER_DATA_VALID_GET_OR_ERR_RET(timer_data_id, data, -EINVAL);
 
@@ -821,75 +1172,9 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 	}
 
 	for (i = 0; i < nb_poll_lcores; i++) {
-		poll_lcore = poll_lcores[i];
-		privp = &data->priv_timer[poll_lcore];
-
-		/* optimize for the case where per-cpu list is empty */
-		if (privp->pending_head.sl_next[0] == NULL)
-			continue;
-		cur_time = rte_get_timer_cycles();
-
-#ifdef RTE_ARCH_64
-		/* on 64-bit the value cached in the pending_head.expired will
-		 * be updated atomically, so we can consult that for a quick
-		 * check here outside the lock
-		 */
-		if (likely(privp->pending_head.expire > cur_time))
-			continue;
-#endif
-
-		/* browse ordered list, add expired timers in 'expired' list */
-		rte_spinlock_lock(&privp->list_lock);
-
-		/* if nothing to do just unlock and return */
-		if (privp->pending_head.sl_next[0] == NULL ||
-		    privp->pending_head.sl_next[0]->expire > cur_time) {
-			rte_spinlock_unlock(&privp->list_lock);
-			continue;
-		}
-
-		/* save start of list of expired timers */
-		tim = privp->pending_head.sl_next[0];
-
-		/* break the existing list at current time point */
-		timer_get_prev_entries(cur_time, poll_lcore, prev,
-				       data->priv_timer);
-		for (j = privp->curr_skiplist_depth - 1; j >= 0; j--) {
-			if (prev[j] == &privp->pending_head)
-				continue;
-			privp->pending_head.sl_next[j] =
-				prev[j]->sl_next[j];
-			if (prev[j]->sl_next[j] == NULL)
-				privp->curr_skiplist_depth--;
-
-			prev[j]->sl_next[j] = NULL;
-		}
-
-		/* transition run-list from PENDING to RUNNING */
-		run_first_tims[nb_runlists] = tim;
-		pprev = &run_first_tims[nb_runlists];
-		nb_runlists++;
-
-		for ( ; tim != NULL; tim = next_tim) {
-			next_tim = tim->sl_next[0];
-
-			ret = timer_set_running_state(tim);
-			if (likely(ret == 0)) {
-				pprev = &tim->sl_next[0];
-			} else {
-				/* another core is trying to re-config this one,
-				 * remove it from local expired list
-				 */
-				*pprev = next_tim;
-			}
-		}
-
-		/* update the next to expire timer value */
-		privp->pending_head.expire =
-		    (privp->pending_head.sl_next[0] == NULL) ? 0 :
-			privp->pending_head.sl_next[0]->expire;
-
-		rte_spinlock_unlock(&privp->list_lock);
+		tim = timer_get_expired(poll_lcores[i], data->priv_timer);
+		if (tim != NULL)
+			run_first_tims[nb_runlists++] = tim;
 	}
 
 	/* Now process the run lists */
@@ -969,6 +1254,32 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 	return 0;
 }
 
+/* Walk the slots of a timer wheel, stopping timers */
+static void
+timer_wheel_stop_all(struct timer_wheel *wheel,
+		     struct rte_timer_data *timer_data,
+		     rte_timer_stop_all_cb_t f, void *f_arg)
+{
+	struct rte_timer *tim, *next_tim;
+	unsigned int level, idx;
+
+	for (level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+		for (idx = timer_wheel_next_slot(wheel, level, 0);
+		     idx < TIMER_WHEEL_SLOTS;
+		     idx = timer_wheel_next_slot(wheel, level, idx + 1)) {
+			for (tim = wheel->slots[level][idx]; tim != NULL;
+			     tim = next_tim) {
+				next_tim = tim->sl_next[0];
+
+				__rte_timer_stop(tim, timer_data);
+
+				if (f)
+					f(tim, f_arg);
+			}
+		}
+	}
+}
+
 /* Walk pending lists, stopping timers and calling user-specified function */
 int
 rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
@@ -987,6 +1298,12 @@ rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
 		walk_lcore = walk_lcores[i];
 		priv_timer = &timer_data->priv_timer[walk_lcore];
 
+		if (priv_timer->wheel != NULL) {
+			timer_wheel_stop_all(priv_timer->wheel, timer_data,
+					     f, f_arg);
+			continue;
+		}
+
 		for (tim = priv_timer->pending_head.sl_next[0];
 		     tim != NULL;
 		     tim = next_tim) {
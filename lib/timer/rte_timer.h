@@ -38,6 +38,7 @@
 #include <stdint.h>
 
 #include <rte_common.h>
+#include <rte_compat.h>
 #include <rte_spinlock.h>
 
 #ifdef __cplusplus
@@ -144,6 +145,63 @@ struct rte_timer
  */
 int rte_timer_data_alloc(uint32_t *id_ptr);
 
+/**
+ * Backend used by a timer data instance to track pending timers.
+ */
+enum rte_timer_backend {
+	/** Ordered skiplist: O(log n) arm and cancel, exact expiry order. */
+	RTE_TIMER_BACKEND_SKIPLIST = 0,
+	/**
+	 * Hierarchical timer wheel: O(1) arm and cancel, timers are expired
+	 * by slot at the granularity of a wheel tick.
+	 */
+	RTE_TIMER_BACKEND_WHEEL,
+};
+
+/**
+ * Parameters of a timer data instance.
+ */
+struct rte_timer_data_param {
+	enum rte_timer_backend backend; /**< Pending timers backend. */
+	/**
+	 * Duration of a timer wheel tick in timer cycles (see
+	 * rte_get_timer_hz()). Timers never expire early, but may expire up
+	 * to one tick late. 0 selects a tick of one microsecond. Ignored by
+	 * the skiplist backend.
+	 */
+	uint64_t wheel_tick;
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Allocate a timer data instance in shared memory, selecting the backend
+ * used to track its pending timers.
+ *
+ * The timer wheel backend makes rte_timer_alt_reset() and
+ * rte_timer_alt_stop() constant time regardless of the number of pending
+ * timers, which suits applications arming millions of timers (e.g.
+ * per-flow timeouts). Timers expiring within the same wheel tick are run
+ * in no particular order.
+ *
+ * @param id_ptr
+ *   Pointer to variable into which to write the identifier of the allocated
+ *   timer data instance.
+ * @param param
+ *   Parameters of the instance, NULL selects the skiplist backend.
+ *
+ * @return
+ *   - 0: Success
+ *   - -EINVAL: invalid parameters
+ *   - -ENOMEM: timer subsystem not initialized or unable to allocate the
+ *     timer wheel
+ *   - -ENOSPC: maximum number of timer data instances already allocated
+ */
+__rte_experimental
+int rte_timer_data_alloc_ext(uint32_t *id_ptr,
+			     const struct rte_timer_data_param *param);
+
 /**
  * Deallocate a timer data instance.
  *
@@ -21,11 +21,18 @@
 SOCKET_NAME = 'dpdk_telemetry.{}'.format(TELEMETRY_VERSION)
 DEFAULT_PREFIX = 'rte'
 CMDS = []
+STREAM_CMD = '/stream'
 
 
 def read_socket(sock, buf_len, echo=True, pretty=False):
     """ Read data from socket and return it in JSON format """
-    reply = sock.recv(buf_len).decode()
+    reply = msg = sock.recv(buf_len)
+    # with streaming enabled, large replies are split in several messages,
+    # the last one being shorter than the maximum message size
+    while len(msg) == buf_len and STREAM_CMD in CMDS:
+        msg = sock.recv(buf_len)
+        reply += msg
+    reply = reply.decode()
     try:
         ret = json.loads(reply)
     except json.JSONDecodeError:
@@ -138,6 +145,11 @@ def handle_socket(args, path):
     sock.send("/".encode())
     CMDS = read_socket(sock, output_buf_len, False)["/"]
 
+    # get full replies, even when larger than the maximum message size
+    if STREAM_CMD in CMDS:
+        sock.send((STREAM_CMD + ",1").encode())
+        read_socket(sock, output_buf_len, False)
+
     # interactive prompt
     try:
         text = input(prompt).strip()